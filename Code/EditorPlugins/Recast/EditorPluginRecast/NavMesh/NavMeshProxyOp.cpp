@@ -1,6 +1,7 @@
 #include <EditorPluginRecastPCH.h>
 
 #include <EditorPluginRecast/NavMesh/NavMeshProxyOp.h>
+#include <Foundation/IO/MemoryStream.h>
 #include <RecastPlugin/NavMeshBuilder/NavMeshBuilder.h>
 
 // clang-format off
@@ -47,6 +48,7 @@ void ezLongOpProxy_BuildNavMesh::GetReplicationInfo(ezStringBuilder& out_sReplic
   rcCfg.m_fDetailMeshSampleErrorFactor = cfg.GetValue("SampleErrorFactor").Get<float>();
   rcCfg.m_fMaxSimplificationError = cfg.GetValue("MaxSimplification").Get<float>();
   rcCfg.m_fMaxEdgeLength = cfg.GetValue("MaxEdgeLength").Get<float>();
+  rcCfg.m_fTileSize = cfg.GetValue("TileSize").Get<float>();
   rcCfg.Serialize(description);
 }
 
@@ -54,6 +56,18 @@ void ezLongOpProxy_BuildNavMesh::Finalize(ezResult result, const ezDataBuffer& r
 {
   if (result.Succeeded())
   {
-    ezQtEditorApp::GetSingleton()->ReloadEngineResources();
+    bool bTilesReplaced = false;
+
+    if (!resultData.IsEmpty())
+    {
+      ezRawMemoryStreamReader reader(resultData);
+      reader >> bTilesReplaced;
+    }
+
+    // if only some tiles changed, the engine process swaps them into the loaded navmesh by itself
+    if (!bTilesReplaced)
+    {
+      ezQtEditorApp::GetSingleton()->ReloadEngineResources();
+    }
   }
 }
@@ -1,3 +1,10 @@
 #include <EnginePluginRecastPCH.h>
 
-ezPlugin g_Plugin(false);
+#include <EnginePluginRecast/NavMesh/NavMeshWorkerOp.h>
+
+void OnUnloadPlugin(bool bReloading)
+{
+  ezLongOpWorker_BuildNavMesh::ClearCachedBuilders();
+}
+
+ezPlugin g_Plugin(false, nullptr, OnUnloadPlugin);
@@ -3,7 +3,9 @@
 #include <EnginePluginRecast/NavMesh/NavMeshWorkerOp.h>
 
 #include <Core/Assets/AssetFileHeader.h>
+#include <Core/ResourceManager/ResourceManager.h>
 #include <EditorEngineProcessFramework/EngineProcess/EngineProcessDocumentContext.h>
+#include <Foundation/Containers/HashTable.h>
 #include <Foundation/IO/FileSystem/FileWriter.h>
 #include <Foundation/Utilities/Progress.h>
 #include <ToolsFoundation/Document/DocumentManager.h>
@@ -13,6 +15,15 @@ EZ_BEGIN_DYNAMIC_REFLECTED_TYPE(ezLongOpWorker_BuildNavMesh, 1, ezRTTIDefaultAll
 EZ_END_DYNAMIC_REFLECTED_TYPE;
 // clang-format on
 
+// only accessed in InitializeExecution(), which runs on the main thread
+static ezHashTable<ezString, ezSharedPtr<ezLongOpWorker_BuildNavMesh::CachedBuilder>> s_CachedBuilders;
+
+void ezLongOpWorker_BuildNavMesh::ClearCachedBuilders()
+{
+  s_CachedBuilders.Clear();
+  s_CachedBuilders.Compact();
+}
+
 ezResult ezLongOpWorker_BuildNavMesh::InitializeExecution(ezStreamReader& config, const ezUuid& DocumentGuid)
 {
   ezEngineProcessDocumentContext* pDocContext = ezEngineProcessDocumentContext::GetDocumentContext(DocumentGuid);
@@ -23,6 +34,28 @@ ezResult ezLongOpWorker_BuildNavMesh::InitializeExecution(ezStreamReader& config
   config >> m_sOutputPath;
   m_NavMeshConfig.Deserialize(config);
 
+  // forget the builders of documents that have been closed in the meantime
+  for (auto it = s_CachedBuilders.GetIterator(); it.IsValid();)
+  {
+    if (ezEngineProcessDocumentContext::GetDocumentContext(it.Value()->m_DocumentGuid) == nullptr)
+      it = s_CachedBuilders.Remove(it);
+    else
+      ++it;
+  }
+
+  // the output path identifies the navmesh component
+  ezSharedPtr<CachedBuilder>& pCachedBuilder = s_CachedBuilders[m_sOutputPath];
+  if (pCachedBuilder == nullptr)
+  {
+    pCachedBuilder = EZ_DEFAULT_NEW(CachedBuilder);
+    pCachedBuilder->m_DocumentGuid = DocumentGuid;
+  }
+
+  m_pCachedBuilder = pCachedBuilder;
+
+  // the navmesh that is currently in use gets the rebuilt tiles right away, instead of being reloaded completely
+  m_hNavMesh = ezResourceManager::GetExistingResource<ezRecastNavMeshResource>(m_sOutputPath);
+
   pDocContext->GetWorld();
 
   EZ_LOCK(pDocContext->GetWorld()->GetWriteMarker());
@@ -38,7 +71,10 @@ ezResult ezLongOpWorker_BuildNavMesh::Execute(ezProgress& progress, ezStreamWrit
   pgRange.SetStepWeighting(0, 0.95f);
   pgRange.SetStepWeighting(1, 0.05f);
 
-  ezRecastNavMeshBuilder NavMeshBuilder;
+  // another build of the same navmesh may still be running
+  EZ_LOCK(m_pCachedBuilder->m_BuildMutex);
+
+  ezRecastNavMeshBuilder& NavMeshBuilder = m_pCachedBuilder->m_Builder;
   ezRecastNavMeshResourceDescriptor desc;
 
   if (!pgRange.BeginNextStep("Building NavMesh"))
@@ -60,5 +96,15 @@ ezResult ezLongOpWorker_BuildNavMesh::Execute(ezProgress& progress, ezStreamWrit
 
   EZ_SUCCEED_OR_RETURN(desc.Serialize(file));
 
+  // tells the proxy whether the navmesh still needs to be reloaded from file
+  const bool bTilesReplaced = m_hNavMesh.IsValid() && !NavMeshBuilder.HasTileGridChanged();
+  proxydata << bTilesReplaced;
+
+  if (bTilesReplaced && !NavMeshBuilder.GetChangedTiles().IsEmpty())
+  {
+    ezResourceLock<ezRecastNavMeshResource> pNavMesh(m_hNavMesh, ezResourceAcquireMode::PointerOnly);
+    pNavMesh.GetPointerNonConst()->QueueTileReplacement(std::move(desc), NavMeshBuilder.GetChangedTiles());
+  }
+
   return EZ_SUCCESS;
 }
@@ -1,7 +1,11 @@
+#pragma once
+
 #include <EnginePluginRecastPCH.h>
 
 #include <Core/Utils/WorldGeoExtractionUtil.h>
 #include <EditorEngineProcessFramework/LongOps/LongOps.h>
+#include <Foundation/Threading/Mutex.h>
+#include <Foundation/Types/SharedPtr.h>
 #include <RecastPlugin/NavMeshBuilder/NavMeshBuilder.h>
 #include <RecastPlugin/Resources/RecastNavMeshResource.h>
 
@@ -13,7 +17,21 @@ public:
   virtual ezResult InitializeExecution(ezStreamReader& config, const ezUuid& DocumentGuid) override;
   virtual ezResult Execute(ezProgress& progress, ezStreamWriter& proxydata) override;
 
+  /// \brief Releases the builders that are kept for incremental navmesh builds.
+  static void ClearCachedBuilders();
+
   ezString m_sOutputPath;
   ezRecastConfig m_NavMeshConfig;
   ezWorldGeoExtractionUtil::Geometry m_ExtractedWorldGeometry;
+
+  /// \brief Kept alive across builds of the same navmesh, such that only the tiles with modified geometry need to be rebuilt.
+  struct CachedBuilder : public ezRefCounted
+  {
+    ezUuid m_DocumentGuid;
+    ezMutex m_BuildMutex;
+    ezRecastNavMeshBuilder m_Builder;
+  };
+
+  ezSharedPtr<CachedBuilder> m_pCachedBuilder;
+  ezRecastNavMeshResourceHandle m_hNavMesh;
 };
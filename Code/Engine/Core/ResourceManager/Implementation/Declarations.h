@@ -68,6 +68,7 @@ struct ezResourceFlags
     PreventFileReload       = EZ_BIT(7),  ///< Once this flag is set, no reloading from file is done, until the flag is manually removed. Automatically set when a custom loader is used. To restore a file to the disk state, this flag must be removed and then the resource can be reloaded.
     HasLowResData           = EZ_BIT(8),  ///< Whether low resolution data was set on a resource once before
     IsCreatedResource       = EZ_BIT(9),  ///< When this is set, the resource was created and not loaded from file
+    QualityLimitedByBudget  = EZ_BIT(10), ///< Quality levels were discarded to stay within the memory budget of the resource type. No further quality levels are loaded until the type is well below its budget again.
     Default                 = 0,
   };
 
@@ -83,6 +84,7 @@ struct ezResourceFlags
     StorageType PreventFileReload       : 1;
     StorageType HasLowResData           : 1;
     StorageType IsCreatedResource       : 1;
+    StorageType QualityLimitedByBudget  : 1;
   };
 };
 
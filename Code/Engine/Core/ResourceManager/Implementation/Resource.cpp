@@ -140,6 +140,9 @@ void ezResource::CallUnloadData(Unload WhatToUnload)
   m_LoadingState = ld.m_State;
   m_uiQualityLevelsDiscardable = ld.m_uiQualityLevelsDiscardable;
   m_uiQualityLevelsLoadable = ld.m_uiQualityLevelsLoadable;
+
+  // keep the memory usage up to date, the memory budgets rely on it
+  RefreshMemoryUsage();
 }
 
 #if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
@@ -177,6 +180,9 @@ void ezResource::CallUpdateContent(ezStreamReader* Stream)
 
   IncResourceChangeCounter();
 
+  // the memory usage has to be up to date before the new state is visible, whoever waits for the resource to be loaded may look at it
+  RefreshMemoryUsage();
+
   m_uiQualityLevelsDiscardable = ld.m_uiQualityLevelsDiscardable;
   m_uiQualityLevelsLoadable = ld.m_uiQualityLevelsLoadable;
   m_LoadingState = ld.m_State;
@@ -260,23 +266,12 @@ void ezResource::VerifyAfterCreateResource(const ezResourceLoadDesc& ld)
 
   IncResourceChangeCounter();
 
+  RefreshMemoryUsage();
+
   m_LoadingState = ld.m_State;
   m_uiQualityLevelsDiscardable = ld.m_uiQualityLevelsDiscardable;
   m_uiQualityLevelsLoadable = ld.m_uiQualityLevelsLoadable;
 
-  /* Update Memory Usage*/
-  {
-    ezResource::MemoryUsage MemUsage;
-    MemUsage.m_uiMemoryCPU = 0xFFFFFFFF;
-    MemUsage.m_uiMemoryGPU = 0xFFFFFFFF;
-    UpdateMemoryUsage(MemUsage);
-
-    EZ_ASSERT_DEV(MemUsage.m_uiMemoryCPU != 0xFFFFFFFF, "Resource '{0}' did not properly update its CPU memory usage", GetResourceID());
-    EZ_ASSERT_DEV(MemUsage.m_uiMemoryGPU != 0xFFFFFFFF, "Resource '{0}' did not properly update its GPU memory usage", GetResourceID());
-
-    m_MemoryUsage = MemUsage;
-  }
-
   ezResourceEvent e;
   e.m_pResource = this;
   e.m_Type = ezResourceEvent::Type::ResourceContentUpdated;
@@ -285,4 +280,18 @@ void ezResource::VerifyAfterCreateResource(const ezResourceLoadDesc& ld)
   ezLog::Debug("Created {0} - '{1}' ", GetDynamicRTTI()->GetTypeName(), GetResourceDescription());
 }
 
+void ezResource::RefreshMemoryUsage()
+{
+  MemoryUsage MemUsage;
+  MemUsage.m_uiMemoryCPU = 0xFFFFFFFF;
+  MemUsage.m_uiMemoryGPU = 0xFFFFFFFF;
+  UpdateMemoryUsage(MemUsage);
+
+  EZ_ASSERT_DEV(MemUsage.m_uiMemoryCPU != 0xFFFFFFFF, "Resource '{0}' did not properly update its CPU memory usage", GetResourceID());
+  EZ_ASSERT_DEV(MemUsage.m_uiMemoryGPU != 0xFFFFFFFF, "Resource '{0}' did not properly update its GPU memory usage", GetResourceID());
+
+  m_MemoryUsage = MemUsage;
+  ezResourceManager::UpdateBudgetedMemoryUsage(this, MemUsage);
+}
+
 EZ_STATICLINK_FILE(Core, Core_ResourceManager_Implementation_Resource);
@@ -3,12 +3,11 @@
 #include <Core/ResourceManager/Implementation/ResourceManagerState.h>
 #include <Core/ResourceManager/ResourceManager.h>
 #include <Foundation/Profiling/Profiling.h>
+#include <Foundation/Utilities/Stats.h>
 
 ezTypelessResourceHandle ezResourceManager::LoadResourceByType(const ezRTTI* pResourceType, const char* szResourceID)
 {
-  // the mutex here is necessary to prevent a race between resource unloading and storing the pointer in the handle
-  EZ_LOCK(s_ResourceMutex);
-  return ezTypelessResourceHandle(GetResource(pResourceType, szResourceID, true));
+  return GetResourceHandle(pResourceType, szResourceID, true);
 }
 
 void ezResourceManager::InternalPreloadResource(ezResource* pResource, bool bHighestPriority)
@@ -16,12 +15,22 @@ void ezResourceManager::InternalPreloadResource(ezResource* pResource, bool bHig
   if (s_State->s_bShutdown)
     return;
 
+  // early out without locking, if there is nothing to do anyway
+  // the checks are repeated below under the lock, so a stale read here only means that we take the slower path
+  if (pResource->GetLoadingState() == ezResourceState::Loaded &&
+      (pResource->GetNumQualityLevelsLoadable() == 0 || pResource->m_Flags.IsSet(ezResourceFlags::QualityLimitedByBudget)))
+    return;
+
+  if (!bHighestPriority && IsQueuedForLoading(pResource))
+    return;
+
   EZ_PROFILE_SCOPE("InternalPreloadResource");
 
   EZ_LOCK(s_ResourceMutex);
 
-  // if there is nothing else that could be loaded, just return right away
-  if (pResource->GetLoadingState() == ezResourceState::Loaded && pResource->GetNumQualityLevelsLoadable() == 0)
+  // if there is nothing else that could be loaded (or should be, due to the memory budget), just return right away
+  if (pResource->GetLoadingState() == ezResourceState::Loaded &&
+      (pResource->GetNumQualityLevelsLoadable() == 0 || pResource->m_Flags.IsSet(ezResourceFlags::QualityLimitedByBudget)))
   {
     // due to the threading this can happen for all resource types and is valid
     // EZ_ASSERT_DEV(!IsQueuedForLoading(pResource), "Invalid flag on resource type '{0}'",
@@ -127,27 +136,12 @@ void ezResourceManager::RunWorkerTask(ezResource* pResource)
   }
 }
 
-void ezResourceManager::ReverseBubbleSortStep(ezDeque<LoadingInfo>& data)
+ezTime ezResourceManager::ComputeLoadingDueDate(const ezResource* pResource, ezTime tNow)
 {
-  // Yep, it's really bubble sort!
-  // This will move the entry with the smallest value to the front and move all other values closer to their correct position,
-  // which is exactly what we need for the priority queue.
-  // We do this once a frame, which gives us nice iterative sorting, with relatively deterministic performance characteristics.
-
-  EZ_ASSERT_DEBUG(s_ResourceMutex.IsLocked(), "Calling code must acquire s_ResourceMutex");
-
-  const ezUInt32 uiCount = data.GetCount();
-
-  for (ezUInt32 i = uiCount; i > 1; --i)
-  {
-    const ezUInt32 idx2 = i - 1;
-    const ezUInt32 idx1 = i - 2;
-
-    if (data[idx1].m_fPriority > data[idx1].m_fPriority)
-    {
-      ezMath::Swap(data[idx1], data[idx2]);
-    }
-  }
+  // every point of loading priority delays the due date by 100ms
+  // this way resources with a lower priority still get loaded eventually, once they have waited long enough,
+  // instead of being starved by a constant stream of more important resources
+  return tNow + ezTime::Milliseconds(100.0 * pResource->GetLoadingPriority(tNow));
 }
 
 void ezResourceManager::UpdateLoadingDeadlines()
@@ -159,6 +153,9 @@ void ezResourceManager::UpdateLoadingDeadlines()
 
   EZ_PROFILE_SCOPE("UpdateLoadingDeadlines");
 
+  // Re-evaluate a few entries per call, in case their priority has changed or they have been acquired again since they were queued.
+  // A due date is only ever moved forward, so a resource that has been waiting for a long time cannot be pushed back by this.
+
   const ezUInt32 uiCount = s_State->s_LoadingQueue.GetCount();
   s_State->s_uiLastResourcePriorityUpdateIdx = ezMath::Min(s_State->s_uiLastResourcePriorityUpdateIdx, uiCount);
 
@@ -170,26 +167,47 @@ void ezResourceManager::UpdateLoadingDeadlines()
     uiUpdateCount = ezMath::Min(50u, uiCount - s_State->s_uiLastResourcePriorityUpdateIdx);
   }
 
-  if (uiUpdateCount > 0)
+  const ezTime tNow = ezTime::Now();
+
+  for (ezUInt32 i = 0; i < uiUpdateCount; ++i)
   {
-    {
-      EZ_PROFILE_SCOPE("EvalLoadingDeadlines");
+    const ezUInt32 uiIndex = s_State->s_uiLastResourcePriorityUpdateIdx++;
+    auto& element = s_State->s_LoadingQueue[uiIndex];
 
-      const ezTime tNow = ezTime::Now();
+    const ezTime newDueDate = ComputeLoadingDueDate(element.m_pResource, tNow);
 
-      for (ezUInt32 i = 0; i < uiUpdateCount; ++i)
-      {
-        auto& element = s_State->s_LoadingQueue[s_State->s_uiLastResourcePriorityUpdateIdx];
-        element.m_fPriority = element.m_pResource->GetLoadingPriority(tNow);
-        ++s_State->s_uiLastResourcePriorityUpdateIdx;
-      }
+    if (newDueDate < element.m_DueDate)
+    {
+      element.m_DueDate = newDueDate;
+      LoadingQueueSiftUp(uiIndex);
     }
+  }
+}
+
+void ezResourceManager::UpdateLoadingQueueStats()
+{
+  ezUInt32 uiQueueLength = 0;
+  ezUInt32 uiDeadlineMisses = 0;
+  ezTime averageWaitTime;
 
+  {
+    EZ_LOCK(s_ResourceMutex);
+
+    if (s_State->s_uiLoadingQueueNumDequeued > 0)
     {
-      EZ_PROFILE_SCOPE("SortLoadingDeadlines");
-      ReverseBubbleSortStep(s_State->s_LoadingQueue);
+      s_State->s_LoadingQueueAverageWaitTime = s_State->s_LoadingQueueWaitTimeSum / s_State->s_uiLoadingQueueNumDequeued;
+      s_State->s_LoadingQueueWaitTimeSum.SetZero();
+      s_State->s_uiLoadingQueueNumDequeued = 0;
     }
+
+    uiQueueLength = s_State->s_LoadingQueue.GetCount();
+    uiDeadlineMisses = s_State->s_uiLoadingQueueDeadlineMisses;
+    averageWaitTime = s_State->s_LoadingQueueAverageWaitTime;
   }
+
+  ezStats::SetStat("Resource Manager/Loading Queue/Length", uiQueueLength);
+  ezStats::SetStat("Resource Manager/Loading Queue/Average Wait (ms)", averageWaitTime.GetMilliseconds());
+  ezStats::SetStat("Resource Manager/Loading Queue/Deadline Misses", uiDeadlineMisses);
 }
 
 void ezResourceManager::PreloadResource(ezResource* pResource)
@@ -220,16 +238,13 @@ ezResult ezResourceManager::RemoveFromLoadingQueue(ezResource* pResource)
   if (!IsQueuedForLoading(pResource))
     return EZ_SUCCESS;
 
-  LoadingInfo li;
-  li.m_pResource = pResource;
-
-  if (s_State->s_LoadingQueue.RemoveAndSwap(li))
-  {
-    pResource->m_Flags.Remove(ezResourceFlags::IsQueuedForLoading);
-    return EZ_SUCCESS;
-  }
+  // the resource is flagged as queued, but not in the queue anymore, which means a loading task has already picked it up
+  if (pResource->m_uiLoadingQueueIndex == ezInvalidIndex)
+    return EZ_FAILURE;
 
-  return EZ_FAILURE;
+  LoadingQueueRemoveAt(pResource->m_uiLoadingQueueIndex);
+  pResource->m_Flags.Remove(ezResourceFlags::IsQueuedForLoading);
+  return EZ_SUCCESS;
 }
 
 void ezResourceManager::AddToLoadingQueue(ezResource* pResource, bool bHighestPriority)
@@ -241,17 +256,117 @@ void ezResourceManager::AddToLoadingQueue(ezResource* pResource, bool bHighestPr
 
   LoadingInfo li;
   li.m_pResource = pResource;
+  li.m_QueuedTime = ezTime::Now();
 
   if (bHighestPriority)
   {
+    // someone is waiting for this resource, it is put in front of everything else, even resources that are already overdue
     pResource->SetPriority(ezResourcePriority::Critical);
-    li.m_fPriority = 0.0f;
-    s_State->s_LoadingQueue.PushFront(li);
+    li.m_DueDate = ezTime::Zero();
   }
   else
   {
-    li.m_fPriority = pResource->GetLoadingPriority(s_State->s_LastFrameUpdate);
-    s_State->s_LoadingQueue.PushBack(li);
+    li.m_DueDate = ComputeLoadingDueDate(pResource, li.m_QueuedTime);
+  }
+
+  s_State->s_LoadingQueue.PushBack(li);
+  LoadingQueueSiftUp(s_State->s_LoadingQueue.GetCount() - 1);
+}
+
+ezResource* ezResourceManager::PopFromLoadingQueue()
+{
+  EZ_ASSERT_DEV(s_ResourceMutex.IsLocked(), "Resource mutex must be locked");
+
+  if (s_State->s_LoadingQueue.IsEmpty())
+    return nullptr;
+
+  const LoadingInfo li = s_State->s_LoadingQueue[0];
+  LoadingQueueRemoveAt(0);
+
+  // the resource stays flagged as 'queued for loading' until the loading task has finished
+
+  const ezTime tNow = ezTime::Now();
+  s_State->s_LoadingQueueWaitTimeSum += tNow - li.m_QueuedTime;
+  ++s_State->s_uiLoadingQueueNumDequeued;
+
+  // resources that somebody is blocking on have no real due date and are never counted as a miss
+  if (li.m_DueDate.IsPositive() && tNow > li.m_DueDate)
+  {
+    ++s_State->s_uiLoadingQueueDeadlineMisses;
+  }
+
+  return li.m_pResource;
+}
+
+ezUInt32 ezResourceManager::LoadingQueueSiftUp(ezUInt32 uiIndex)
+{
+  auto& queue = s_State->s_LoadingQueue;
+  const LoadingInfo li = queue[uiIndex];
+
+  while (uiIndex > 0)
+  {
+    const ezUInt32 uiParent = (uiIndex - 1) / 2;
+
+    if (!(li < queue[uiParent]))
+      break;
+
+    queue[uiIndex] = queue[uiParent];
+    queue[uiIndex].m_pResource->m_uiLoadingQueueIndex = uiIndex;
+    uiIndex = uiParent;
+  }
+
+  queue[uiIndex] = li;
+  li.m_pResource->m_uiLoadingQueueIndex = uiIndex;
+  return uiIndex;
+}
+
+void ezResourceManager::LoadingQueueSiftDown(ezUInt32 uiIndex)
+{
+  auto& queue = s_State->s_LoadingQueue;
+  const ezUInt32 uiCount = queue.GetCount();
+  const LoadingInfo li = queue[uiIndex];
+
+  while (true)
+  {
+    ezUInt32 uiChild = uiIndex * 2 + 1;
+
+    if (uiChild >= uiCount)
+      break;
+
+    if (uiChild + 1 < uiCount && queue[uiChild + 1] < queue[uiChild])
+      ++uiChild;
+
+    if (!(queue[uiChild] < li))
+      break;
+
+    queue[uiIndex] = queue[uiChild];
+    queue[uiIndex].m_pResource->m_uiLoadingQueueIndex = uiIndex;
+    uiIndex = uiChild;
+  }
+
+  queue[uiIndex] = li;
+  li.m_pResource->m_uiLoadingQueueIndex = uiIndex;
+}
+
+void ezResourceManager::LoadingQueueRemoveAt(ezUInt32 uiIndex)
+{
+  auto& queue = s_State->s_LoadingQueue;
+
+  queue[uiIndex].m_pResource->m_uiLoadingQueueIndex = ezInvalidIndex;
+
+  const ezUInt32 uiLastIndex = queue.GetCount() - 1;
+
+  if (uiIndex != uiLastIndex)
+  {
+    // move the last element into the gap and restore the heap property from there
+    queue[uiIndex] = queue[uiLastIndex];
+    queue.PopBack();
+
+    LoadingQueueSiftDown(LoadingQueueSiftUp(uiIndex));
+  }
+  else
+  {
+    queue.PopBack();
   }
 }
 
@@ -284,10 +399,7 @@ bool ezResourceManager::ReloadResource(ezResource* pResource, bool bForce)
   {
     bAllowPreloading = false;
 
-    LoadingInfo li;
-    li.m_pResource = pResource;
-
-    if (s_State->s_LoadingQueue.IndexOf(li) == ezInvalidIndex)
+    if (pResource->m_uiLoadingQueueIndex == ezInvalidIndex)
     {
       // the resource is marked as 'loading' but it is not in the queue anymore
       // that means some task is already working on loading it
@@ -351,12 +463,19 @@ ezUInt32 ezResourceManager::ReloadResourcesOfType(const ezRTTI* pType, bool bFor
 
   ezUInt32 count = 0;
 
-  LoadedResources& lr = s_State->s_LoadedResources[pType];
-
-  for (auto it = lr.m_Resources.GetIterator(); it.IsValid(); ++it)
+  for (auto& shard : s_State->s_LoadedResourcesShards)
   {
-    if (ReloadResource(it.Value(), bForce))
-      ++count;
+    EZ_LOCK(shard.m_Mutex);
+
+    LoadedResources* pLoadedResources = nullptr;
+    if (!shard.m_LoadedResources.TryGetValue(pType, pLoadedResources))
+      continue;
+
+    for (auto it = pLoadedResources->m_Resources.GetIterator(); it.IsValid(); ++it)
+    {
+      if (ReloadResource(it.Value(), bForce))
+        ++count;
+    }
   }
 
   return count;
@@ -369,12 +488,17 @@ ezUInt32 ezResourceManager::ReloadAllResources(bool bForce)
 
   ezUInt32 count = 0;
 
-  for (auto itType = s_State->s_LoadedResources.GetIterator(); itType.IsValid(); ++itType)
+  for (auto& shard : s_State->s_LoadedResourcesShards)
   {
-    for (auto it = itType.Value().m_Resources.GetIterator(); it.IsValid(); ++it)
+    EZ_LOCK(shard.m_Mutex);
+
+    for (auto itType = shard.m_LoadedResources.GetIterator(); itType.IsValid(); ++itType)
     {
-      if (ReloadResource(it.Value(), bForce))
-        ++count;
+      for (auto it = itType.Value().m_Resources.GetIterator(); it.IsValid(); ++it)
+      {
+        if (ReloadResource(it.Value(), bForce))
+          ++count;
+      }
     }
   }
 
@@ -6,6 +6,7 @@
 #include <Foundation/Configuration/Startup.h>
 #include <Foundation/IO/FileSystem/FileSystem.h>
 #include <Foundation/Profiling/Profiling.h>
+#include <Foundation/Utilities/Stats.h>
 
 /// \todo Do not unload resources while they are acquired
 /// \todo Resource Type Memory Thresholds
@@ -171,33 +172,37 @@ ezUInt32 ezResourceManager::FreeAllUnusedResources()
 
       bUnloadedAny = false;
 
-      for (auto itType = s_State->s_LoadedResources.GetIterator(); itType.IsValid(); ++itType)
+      for (auto& shard : s_State->s_LoadedResourcesShards)
       {
-        const ezRTTI* pRtti = itType.Key();
-        LoadedResources& lr = itType.Value();
+        EZ_LOCK(shard.m_Mutex);
 
-        for (auto it = lr.m_Resources.GetIterator(); it.IsValid(); /* empty */)
+        for (auto itType = shard.m_LoadedResources.GetIterator(); itType.IsValid(); ++itType)
         {
-          ezResource* pReference = it.Value();
+          LoadedResources& lr = itType.Value();
 
-          if (pReference->m_iReferenceCount == 0)
+          for (auto it = lr.m_Resources.GetIterator(); it.IsValid(); /* empty */)
           {
-            bUnloadedAny = true; // make sure to try again, even if DeallocateResource() fails; need to release our lock for that to prevent dead-locks
-
-            if (DeallocateResource(pReference).Succeeded())
-            {
-              ++uiUnloaded;
+            ezResource* pReference = it.Value();
 
-              it = lr.m_Resources.Remove(it);
-              continue;
-            }
-            else
+            if (pReference->m_iReferenceCount == 0)
             {
-              bAnyFailed = true;
+              bUnloadedAny = true; // make sure to try again, even if DeallocateResource() fails; need to release our lock for that to prevent dead-locks
+
+              if (DeallocateResource(pReference).Succeeded())
+              {
+                ++uiUnloaded;
+
+                it = lr.m_Resources.Remove(it);
+                continue;
+              }
+              else
+              {
+                bAnyFailed = true;
+              }
             }
-          }
 
-          ++it;
+            ++it;
+          }
         }
       }
     }
@@ -228,87 +233,102 @@ ezUInt32 ezResourceManager::FreeUnusedResources(ezTime timeout, ezTime lastAcqui
   EZ_LOG_BLOCK("ezResourceManager::FreeUnusedResources");
   EZ_PROFILE_SCOPE("FreeUnusedResources");
 
-  auto itResourceType = s_State->s_LoadedResources.Find(s_State->s_pFreeUnusedLastType);
-  if (!itResourceType.IsValid())
-  {
-    itResourceType = s_State->s_LoadedResources.GetIterator();
-  }
-
-  if (!itResourceType.IsValid())
-    return 0;
-
-  auto itResourceID = itResourceType.Value().m_Resources.Find(s_State->s_FreeUnusedLastResourceID);
-  if (!itResourceID.IsValid())
-  {
-    itResourceID = itResourceType.Value().m_Resources.GetIterator();
-  }
-
   const ezTime tStart = ezTime::Now();
 
   ezUInt32 uiDeallocatedCount = 0;
 
   ezStringBuilder sResourceName, sResourceDesc;
 
-  const ezRTTI* pLastTypeCheck = nullptr;
-
-  // stop once we wasted enough time
-  while (ezTime::Now() - tStart < timeout)
+  // continue in the shard where the previous call stopped
+  for (ezUInt32 uiShard = s_State->s_uiFreeUnusedLastShard; uiShard < ezResourceManagerState::NumLoadedResourcesShards; ++uiShard)
   {
-    if (!itResourceID.IsValid())
-    {
-      // reached the end of this resource type
-      // advance to the next resource type
-      ++itResourceType;
+    auto& shard = s_State->s_LoadedResourcesShards[uiShard];
+    EZ_LOCK(shard.m_Mutex);
 
-      if (!itResourceType.IsValid())
-      {
-        // if we reached the end, reset everything and stop
+    s_State->s_uiFreeUnusedLastShard = uiShard;
 
-        s_State->s_pFreeUnusedLastType = nullptr;
-        s_State->s_FreeUnusedLastResourceID = ezTempHashedString();
-        return uiDeallocatedCount;
-      }
+    auto itResourceType = shard.m_LoadedResources.Find(s_State->s_pFreeUnusedLastType);
+    if (!itResourceType.IsValid())
+    {
+      itResourceType = shard.m_LoadedResources.GetIterator();
+    }
 
+    if (!itResourceType.IsValid())
+      continue;
 
-      // reset resource ID to the beginning of this type and start over
+    auto itResourceID = itResourceType.Value().m_Resources.Find(s_State->s_FreeUnusedLastResourceID);
+    if (!itResourceID.IsValid())
+    {
       itResourceID = itResourceType.Value().m_Resources.GetIterator();
-      continue;
     }
 
-    s_State->s_pFreeUnusedLastType = itResourceType.Key();
-    s_State->s_FreeUnusedLastResourceID = itResourceID.Key();
+    const ezRTTI* pLastTypeCheck = nullptr;
 
-    if (pLastTypeCheck != itResourceType.Key())
+    while (true)
     {
-      pLastTypeCheck = itResourceType.Key();
+      // stop once we wasted enough time
+      if (ezTime::Now() - tStart >= timeout)
+        return uiDeallocatedCount;
 
-      if (GetResourceTypeInfo(pLastTypeCheck).m_bIncrementalUnload == false)
+      if (!itResourceID.IsValid())
       {
-        itResourceID = itResourceType.Value().m_Resources.GetEndIterator();
+        // reached the end of this resource type
+        // advance to the next resource type
+        ++itResourceType;
+
+        if (!itResourceType.IsValid())
+        {
+          // reached the end of this shard, continue with the next one
+          break;
+        }
+
+        // reset resource ID to the beginning of this type and start over
+        itResourceID = itResourceType.Value().m_Resources.GetIterator();
         continue;
       }
-    }
 
-    ezResource* pResource = itResourceID.Value();
+      s_State->s_pFreeUnusedLastType = itResourceType.Key();
+      s_State->s_FreeUnusedLastResourceID = itResourceID.Key();
 
-    if ((pResource->GetReferenceCount() == 0) && (tStart - pResource->GetLastAcquireTime() > lastAcquireThreshold))
-    {
-      sResourceName = pResource->GetResourceID();
-      sResourceDesc = pResource->GetResourceDescription();
+      if (pLastTypeCheck != itResourceType.Key())
+      {
+        pLastTypeCheck = itResourceType.Key();
+
+        if (GetResourceTypeInfo(pLastTypeCheck).m_bIncrementalUnload == false)
+        {
+          itResourceID = itResourceType.Value().m_Resources.GetEndIterator();
+          continue;
+        }
+      }
+
+      ezResource* pResource = itResourceID.Value();
 
-      if (DeallocateResource(pResource).Succeeded())
+      if ((pResource->GetReferenceCount() == 0) && (tStart - pResource->GetLastAcquireTime() > lastAcquireThreshold))
       {
-        ezLog::Debug("Freed '{}' - '{}'", sResourceName, sResourceDesc);
+        sResourceName = pResource->GetResourceID();
+        sResourceDesc = pResource->GetResourceDescription();
 
-        ++uiDeallocatedCount;
-        itResourceID = itResourceType.Value().m_Resources.Remove(itResourceID);
-        continue;
+        if (DeallocateResource(pResource).Succeeded())
+        {
+          ezLog::Debug("Freed '{}' - '{}'", sResourceName, sResourceDesc);
+
+          ++uiDeallocatedCount;
+          itResourceID = itResourceType.Value().m_Resources.Remove(itResourceID);
+          continue;
+        }
       }
+
+      ++itResourceID;
     }
 
-    ++itResourceID;
+    s_State->s_pFreeUnusedLastType = nullptr;
+    s_State->s_FreeUnusedLastResourceID = ezTempHashedString();
   }
 
+  // if we reached the end, reset everything and stop
+  s_State->s_uiFreeUnusedLastShard = 0;
+  s_State->s_pFreeUnusedLastType = nullptr;
+  s_State->s_FreeUnusedLastResourceID = ezTempHashedString();
   return uiDeallocatedCount;
 }
 
@@ -318,6 +338,204 @@ void ezResourceManager::SetAutoFreeUnused(ezTime timeout, ezTime lastAcquireThre
   s_State->m_AutoFreeUnusedThreshold = lastAcquireThreshold;
 }
 
+void ezResourceManager::SetResourceTypeMemoryBudget(const ezRTTI* pResourceType, ezUInt64 uiBudgetCPU, ezUInt64 uiBudgetGPU)
+{
+  EZ_LOCK(s_ResourceMutex);
+
+  ResourceTypeInfo& info = GetResourceTypeInfo(pResourceType);
+  info.m_uiMemoryBudgetCPU = uiBudgetCPU;
+  info.m_uiMemoryBudgetGPU = uiBudgetGPU;
+
+  s_State->m_bAnyMemoryBudget = false;
+  for (auto it = s_State->m_TypeInfo.GetIterator(); it.IsValid(); ++it)
+  {
+    if (it.Value().m_uiMemoryBudgetCPU > 0 || it.Value().m_uiMemoryBudgetGPU > 0)
+    {
+      s_State->m_bAnyMemoryBudget = true;
+      break;
+    }
+  }
+}
+
+void ezResourceManager::GetResourceTypeMemoryUsage(const ezRTTI* pResourceType, ezUInt64& out_uiMemoryCPU, ezUInt64& out_uiMemoryGPU)
+{
+  EZ_LOCK(s_ResourceMutex);
+
+  const ResourceTypeInfo& info = GetResourceTypeInfo(pResourceType);
+  out_uiMemoryCPU = info.m_uiMemoryUsageCPU;
+  out_uiMemoryGPU = info.m_uiMemoryUsageGPU;
+}
+
+void ezResourceManager::UpdateBudgetedMemoryUsage(ezResource* pResource, const ezResource::MemoryUsage& usage)
+{
+  EZ_LOCK(s_ResourceMutex);
+
+  ezResource::MemoryUsage& budgeted = pResource->m_BudgetedMemoryUsage;
+  if (budgeted.m_uiMemoryCPU == usage.m_uiMemoryCPU && budgeted.m_uiMemoryGPU == usage.m_uiMemoryGPU)
+    return;
+
+  ResourceTypeInfo& info = GetResourceTypeInfo(pResource->GetDynamicRTTI());
+  info.m_uiMemoryUsageCPU = info.m_uiMemoryUsageCPU - budgeted.m_uiMemoryCPU + usage.m_uiMemoryCPU;
+  info.m_uiMemoryUsageGPU = info.m_uiMemoryUsageGPU - budgeted.m_uiMemoryGPU + usage.m_uiMemoryGPU;
+  info.m_bMemoryUsageChanged = true;
+
+  budgeted = usage;
+}
+
+void ezResourceManager::WaitForDowngrade(ezResource* pResource)
+{
+  EZ_PROFILE_SCOPE("WaitForDowngrade");
+
+  // FinishDowngrade() modifies the lock count while holding the condition variable's lock, so the signal can't be missed
+  ezConditionVariable& downgradeFinished = s_State->m_DowngradeFinished;
+  EZ_LOCK(downgradeFinished);
+
+  while (pResource->m_iLockCount < 0)
+  {
+    downgradeFinished.UnlockWaitForSignalAndLock();
+  }
+}
+
+void ezResourceManager::FinishDowngrade(ezResource* pResource)
+{
+  ezConditionVariable& downgradeFinished = s_State->m_DowngradeFinished;
+  EZ_LOCK(downgradeFinished);
+
+  // keeps the locks of everyone who acquired the resource during the downgrade
+  pResource->m_iLockCount.Add(-s_iDowngradeLockCount);
+
+  downgradeFinished.SignalAll();
+}
+
+ezUInt32 ezResourceManager::EnforceMemoryBudgets()
+{
+  EZ_LOCK(s_ResourceMutex);
+  EZ_PROFILE_SCOPE("EnforceMemoryBudgets");
+
+  ezUInt32 uiEvictedCount = 0;
+
+  ezDynamicArray<ezResource*> candidates;
+  ezStringBuilder sStatName;
+
+  for (auto itType = s_State->m_TypeInfo.GetIterator(); itType.IsValid(); ++itType)
+  {
+    const ezRTTI* pType = itType.Key();
+    ResourceTypeInfo& info = itType.Value();
+
+    if (info.m_uiMemoryBudgetCPU == 0 && info.m_uiMemoryBudgetGPU == 0)
+      continue;
+
+    // budgets of zero mean unlimited
+    const ezUInt64 uiBudgetCPU = info.m_uiMemoryBudgetCPU > 0 ? info.m_uiMemoryBudgetCPU : ezMath::MaxValue<ezUInt64>();
+    const ezUInt64 uiBudgetGPU = info.m_uiMemoryBudgetGPU > 0 ? info.m_uiMemoryBudgetGPU : ezMath::MaxValue<ezUInt64>();
+
+    // the usage is tracked incrementally, the resources only need to be looked at when the budget is exceeded
+    if (info.m_uiMemoryUsageCPU > uiBudgetCPU || info.m_uiMemoryUsageGPU > uiBudgetGPU)
+    {
+      // holding the resource mutex guarantees that no resource is created or deallocated, so the pointers stay valid
+      candidates.Clear();
+      for (auto& shard : s_State->s_LoadedResourcesShards)
+      {
+        EZ_LOCK(shard.m_Mutex);
+
+        LoadedResources* pResources = nullptr;
+        if (!shard.m_LoadedResources.TryGetValue(pType, pResources))
+          continue;
+
+        for (auto it = pResources->m_Resources.GetIterator(); it.IsValid(); ++it)
+        {
+          candidates.PushBack(it.Value());
+        }
+      }
+
+      // least recently used first, among those the least important ones
+      candidates.Sort([](const ezResource* a, const ezResource* b) {
+        if (a->GetLastAcquireTime() != b->GetLastAcquireTime())
+          return a->GetLastAcquireTime() < b->GetLastAcquireTime();
+
+        return a->GetPriority() > b->GetPriority();
+      });
+
+      // deallocating and downgrading resources updates the usage of the type
+      for (ezResource* pResource : candidates)
+      {
+        if (info.m_uiMemoryUsageCPU <= uiBudgetCPU && info.m_uiMemoryUsageGPU <= uiBudgetGPU)
+          break;
+
+        if (pResource->GetReferenceCount() == 0)
+        {
+          const ezTempHashedString sResourceID(pResource->GetResourceID().GetData());
+          auto& shard = s_State->GetShard(sResourceID);
+          EZ_LOCK(shard.m_Mutex);
+
+          // the reference count may have changed in the mean time, without the shard lock
+          if (pResource->GetReferenceCount() != 0 || DeallocateResource(pResource).Failed())
+            continue;
+
+          shard.m_LoadedResources[pType].m_Resources.Remove(sResourceID);
+        }
+        else
+        {
+          // referenced resources are never unloaded completely, they only drop to a lower quality level
+          if (pResource->GetLoadingState() != ezResourceState::Loaded || pResource->GetNumQualityLevelsDiscardable() == 0 ||
+              IsQueuedForLoading(pResource))
+            continue;
+
+          if (pResource->GetBaseResourceFlags().IsSet(ezResourceFlags::UpdateOnMainThread) && !ezThreadUtils::IsMainThread())
+            continue;
+
+          // Acquiring a resource doesn't take any lock, so checking the lock count alone would race with BeginAcquireResource().
+          // Instead the resource is only downgraded if its lock count can be switched from zero to the downgrade marker, everyone who
+          // acquires its content in the mean time waits until the downgrade is finished.
+          if (!pResource->m_iLockCount.TestAndSet(0, s_iDowngradeLockCount))
+            continue;
+
+          pResource->CallUnloadData(ezResource::Unload::OneQualityLevel);
+          pResource->m_Flags.Add(ezResourceFlags::QualityLimitedByBudget);
+          info.m_bQualityLimitedByBudget = true;
+
+          FinishDowngrade(pResource);
+        }
+
+        ++uiEvictedCount;
+      }
+    }
+    else if (info.m_bQualityLimitedByBudget && info.m_uiMemoryUsageCPU * 4 <= uiBudgetCPU * 3 && info.m_uiMemoryUsageGPU * 4 <= uiBudgetGPU * 3)
+    {
+      // well below the budget again, allow higher quality levels to be streamed in
+      // the margin prevents resources from being downgraded and upgraded again every frame
+      info.m_bQualityLimitedByBudget = false;
+
+      for (auto& shard : s_State->s_LoadedResourcesShards)
+      {
+        EZ_LOCK(shard.m_Mutex);
+
+        LoadedResources* pResources = nullptr;
+        if (!shard.m_LoadedResources.TryGetValue(pType, pResources))
+          continue;
+
+        for (auto it = pResources->m_Resources.GetIterator(); it.IsValid(); ++it)
+        {
+          it.Value()->m_Flags.Remove(ezResourceFlags::QualityLimitedByBudget);
+        }
+      }
+    }
+
+    // formatting the stat names isn't free, so they are only updated when the usage changed
+    if (!info.m_bMemoryUsageChanged)
+      continue;
+
+    info.m_bMemoryUsageChanged = false;
+
+    sStatName.Format("Resource Manager/Memory Budget/{}/CPU (KB)", pType->GetTypeName());
+    ezStats::SetStat(sStatName, info.m_uiMemoryUsageCPU / 1024);
+    sStatName.Format("Resource Manager/Memory Budget/{}/GPU (KB)", pType->GetTypeName());
+    ezStats::SetStat(sStatName, info.m_uiMemoryUsageGPU / 1024);
+  }
+
+  return uiEvictedCount;
+}
+
 void ezResourceManager::AllowResourceTypeAcquireDuringUpdateContent(const ezRTTI* pTypeBeingUpdated, const ezRTTI* pTypeItWantsToAcquire)
 {
   auto& info = s_State->m_TypeInfo[pTypeBeingUpdated];
@@ -407,6 +625,9 @@ ezResult ezResourceManager::DeallocateResource(ezResource* pResource)
   EZ_ASSERT_DEBUG(pResource->GetLoadingState() <= ezResourceState::LoadedResourceMissing,
     "Resource '{0}' should be in an unloaded state now.", pResource->GetResourceID());
 
+  // whatever the resource still uses is gone with it
+  UpdateBudgetedMemoryUsage(pResource, ezResource::MemoryUsage());
+
   // broadcast that we are going to delete the resource
   {
     ezResourceEvent e;
@@ -432,12 +653,17 @@ void ezResourceManager::ResetAllResources()
   EZ_LOCK(s_ResourceMutex);
   EZ_LOG_BLOCK("ezResourceManager::ReloadAllResources");
 
-  for (auto itType = s_State->s_LoadedResources.GetIterator(); itType.IsValid(); ++itType)
+  for (auto& shard : s_State->s_LoadedResourcesShards)
   {
-    for (auto it = itType.Value().m_Resources.GetIterator(); it.IsValid(); ++it)
+    EZ_LOCK(shard.m_Mutex);
+
+    for (auto itType = shard.m_LoadedResources.GetIterator(); itType.IsValid(); ++itType)
     {
-      ezResource* pResource = it.Value();
-      pResource->ResetResource();
+      for (auto it = itType.Value().m_Resources.GetIterator(); it.IsValid(); ++it)
+      {
+        ezResource* pResource = it.Value();
+        pResource->ResetResource();
+      }
     }
   }
 }
@@ -454,15 +680,20 @@ void ezResourceManager::PerFrameUpdate()
 
     s_State->s_bBroadcastExistsEvent = false;
 
-    for (auto itType = s_State->s_LoadedResources.GetIterator(); itType.IsValid(); ++itType)
+    for (auto& shard : s_State->s_LoadedResourcesShards)
     {
-      for (auto it = itType.Value().m_Resources.GetIterator(); it.IsValid(); ++it)
+      EZ_LOCK(shard.m_Mutex);
+
+      for (auto itType = shard.m_LoadedResources.GetIterator(); itType.IsValid(); ++itType)
       {
-        ezResourceEvent e;
-        e.m_Type = ezResourceEvent::Type::ResourceExists;
-        e.m_pResource = it.Value();
+        for (auto it = itType.Value().m_Resources.GetIterator(); it.IsValid(); ++it)
+        {
+          ezResourceEvent e;
+          e.m_Type = ezResourceEvent::Type::ResourceExists;
+          e.m_pResource = it.Value();
 
-        ezResourceManager::BroadcastResourceEvent(e);
+          ezResourceManager::BroadcastResourceEvent(e);
+        }
       }
     }
   }
@@ -472,9 +703,12 @@ void ezResourceManager::PerFrameUpdate()
 
     for (auto it = s_State->s_ResourcesToUnloadOnMainThread.GetIterator(); it.IsValid(); it.Next())
     {
+      auto& shard = s_State->GetShard(it.Key());
+      EZ_LOCK(shard.m_Mutex);
+
       // Identify the container of loaded resource for the type of resource we want to unload.
-      LoadedResources loadedResourcesForType;
-      if (s_State->s_LoadedResources.TryGetValue(it.Value(), loadedResourcesForType) == false)
+      LoadedResources* pLoadedResourcesForType = nullptr;
+      if (shard.m_LoadedResources.TryGetValue(it.Value(), pLoadedResourcesForType) == false)
       {
         continue;
       }
@@ -482,7 +716,7 @@ void ezResourceManager::PerFrameUpdate()
       // See, if the resource we want to unload still exists.
       ezResource* resourceToUnload = nullptr;
 
-      if (loadedResourcesForType.m_Resources.TryGetValue(it.Key(), resourceToUnload) == false)
+      if (pLoadedResourcesForType->m_Resources.TryGetValue(it.Key(), resourceToUnload) == false)
       {
         continue;
       }
@@ -503,6 +737,13 @@ void ezResourceManager::PerFrameUpdate()
   {
     FreeUnusedResources(s_State->m_AutoFreeUnusedTimeout, s_State->m_AutoFreeUnusedThreshold);
   }
+
+  if (s_State->m_bAnyMemoryBudget)
+  {
+    EnforceMemoryBudgets();
+  }
+
+  UpdateLoadingQueueStats();
 }
 
 const ezEvent<const ezResourceEvent&, ezMutex>& ezResourceManager::GetResourceEvents()
@@ -579,6 +820,7 @@ void ezResourceManager::EngineAboutToShutdown()
     for (auto entry : s_State->s_LoadingQueue)
     {
       entry.m_pResource->m_Flags.Remove(ezResourceFlags::IsQueuedForLoading);
+      entry.m_pResource->m_uiLoadingQueueIndex = ezInvalidIndex;
     }
 
     s_State->s_LoadingQueue.Clear();
@@ -587,15 +829,20 @@ void ezResourceManager::EngineAboutToShutdown()
     // some resources may still be flagged as 'loading', but can never get loaded.
     // That can deadlock the 'FreeAllUnused' function, because it won't delete 'loading' resources.
     // Therefore we need to make sure no resource has the IsQueuedForLoading flag set anymore.
-    for (auto itTypes : s_State->s_LoadedResources)
+    for (auto& shard : s_State->s_LoadedResourcesShards)
     {
-      for (auto itRes : itTypes.Value().m_Resources)
-      {
-        ezResource* pRes = itRes.Value();
+      EZ_LOCK(shard.m_Mutex);
 
-        if (pRes->GetBaseResourceFlags().IsSet(ezResourceFlags::IsQueuedForLoading))
+      for (auto itTypes : shard.m_LoadedResources)
+      {
+        for (auto itRes : itTypes.Value().m_Resources)
         {
-          pRes->m_Flags.Remove(ezResourceFlags::IsQueuedForLoading);
+          ezResource* pRes = itRes.Value();
+
+          if (pRes->GetBaseResourceFlags().IsSet(ezResourceFlags::IsQueuedForLoading))
+          {
+            pRes->m_Flags.Remove(ezResourceFlags::IsQueuedForLoading);
+          }
         }
       }
     }
@@ -654,26 +901,29 @@ void ezResourceManager::OnCoreShutdown()
 
   EZ_LOG_BLOCK("Referenced Resources");
 
-  for (auto itType = s_State->s_LoadedResources.GetIterator(); itType.IsValid(); ++itType)
+  for (auto& shard : s_State->s_LoadedResourcesShards)
   {
-    const ezRTTI* pRtti = itType.Key();
-    LoadedResources& lr = itType.Value();
-
-    if (!lr.m_Resources.IsEmpty())
+    for (auto itType = shard.m_LoadedResources.GetIterator(); itType.IsValid(); ++itType)
     {
-      EZ_LOG_BLOCK("Type", pRtti->GetTypeName());
-
-      ezLog::Error("{0} resource of type '{1}' are still referenced.", lr.m_Resources.GetCount(), pRtti->GetTypeName());
+      const ezRTTI* pRtti = itType.Key();
+      LoadedResources& lr = itType.Value();
 
-      for (auto it = lr.m_Resources.GetIterator(); it.IsValid(); ++it)
+      if (!lr.m_Resources.IsEmpty())
       {
-        ezResource* pReference = it.Value();
+        EZ_LOG_BLOCK("Type", pRtti->GetTypeName());
+
+        ezLog::Error("{0} resource of type '{1}' are still referenced.", lr.m_Resources.GetCount(), pRtti->GetTypeName());
 
-        ezLog::Info("RC = {0}, ID = '{1}'", pReference->GetReferenceCount(), pReference->GetResourceID());
+        for (auto it = lr.m_Resources.GetIterator(); it.IsValid(); ++it)
+        {
+          ezResource* pReference = it.Value();
+
+          ezLog::Info("RC = {0}, ID = '{1}'", pReference->GetReferenceCount(), pReference->GetResourceID());
 
 #if EZ_ENABLED(EZ_RESOURCEHANDLE_STACK_TRACES)
-        pReference->PrintHandleStackTraces();
+          pReference->PrintHandleStackTraces();
 #endif
+        }
       }
     }
   }
@@ -683,12 +933,10 @@ void ezResourceManager::OnCoreShutdown()
   s_State.Clear();
 }
 
-ezResource* ezResourceManager::GetResource(const ezRTTI* pRtti, const char* szResourceID, bool bIsReloadable)
+ezTypelessResourceHandle ezResourceManager::GetResourceHandle(const ezRTTI* pRtti, const char* szResourceID, bool bIsReloadable)
 {
   if (ezStringUtils::IsNullOrEmpty(szResourceID))
-    return nullptr;
-
-  EZ_ASSERT_DEV(s_ResourceMutex.IsLocked(), "Calling code must lock the mutex until the resource pointer is stored in a handle");
+    return ezTypelessResourceHandle();
 
   // redirect requested type to override type, if available
   pRtti = FindResourceTypeOverride(pRtti, szResourceID);
@@ -697,20 +945,45 @@ ezResource* ezResourceManager::GetResource(const ezRTTI* pRtti, const char* szRe
   EZ_ASSERT_DEBUG(pRtti->GetAllocator() != nullptr && pRtti->GetAllocator()->CanAllocate(),
     "There is no RTTI allocator available for the given resource type '{0}'", EZ_STRINGIZE(ResourceType));
 
-  ezResource* pResource = nullptr;
   ezTempHashedString sHashedResourceID(szResourceID);
 
-  ezHashedString* redirection;
-  if (s_State->s_NamedResources.TryGetValue(sHashedResourceID, redirection))
+  // named resources are stored in the shard of the lookup name, the redirection target may be stored in a different one
+  ezHashedString sRedirection;
+  {
+    auto& shard = s_State->GetShard(sHashedResourceID);
+    EZ_LOCK(shard.m_Mutex);
+
+    if (shard.m_NamedResources.TryGetValue(sHashedResourceID, sRedirection))
+    {
+      sHashedResourceID = sRedirection;
+      szResourceID = sRedirection.GetData();
+    }
+  }
+
+  auto& shard = s_State->GetShard(sHashedResourceID);
+
+  // the handle has to be created while the shard is locked, to prevent a race between resource unloading and storing the pointer in the
+  // handle
   {
-    sHashedResourceID = *redirection;
-    szResourceID = redirection->GetData();
+    EZ_LOCK(shard.m_Mutex);
+
+    LoadedResources* pLoadedResources = nullptr;
+    ezResource* pResource = nullptr;
+    if (shard.m_LoadedResources.TryGetValue(pRtti, pLoadedResources) && pLoadedResources->m_Resources.TryGetValue(sHashedResourceID, pResource))
+      return ezTypelessResourceHandle(pResource);
   }
 
-  LoadedResources& lr = s_State->s_LoadedResources[pRtti];
+  // the resource does not exist yet
+  // creating it broadcasts events, which lock s_ResourceMutex, so the locks have to be taken in the same order as everywhere else
+  EZ_LOCK(s_ResourceMutex);
+  EZ_LOCK(shard.m_Mutex);
+
+  LoadedResources& lr = shard.m_LoadedResources[pRtti];
 
+  // another thread might have created it in the mean time
+  ezResource* pResource = nullptr;
   if (lr.m_Resources.TryGetValue(sHashedResourceID, pResource))
-    return pResource;
+    return ezTypelessResourceHandle(pResource);
 
   ezResource* pNewResource = pRtti->GetAllocator()->Allocate<ezResource>();
   pNewResource->m_Priority = s_State->s_ResourceTypePriorities.GetValueOrDefault(pRtti, ezResourcePriority::Medium);
@@ -719,29 +992,50 @@ ezResource* ezResourceManager::GetResource(const ezRTTI* pRtti, const char* szRe
 
   lr.m_Resources.Insert(sHashedResourceID, pNewResource);
 
-  return pNewResource;
+  return ezTypelessResourceHandle(pNewResource);
 }
 
 void ezResourceManager::RegisterResourceOverrideType(
   const ezRTTI* pDerivedTypeToUse, ezDelegate<bool(const ezStringBuilder&)> OverrideDecider)
 {
+  EZ_LOCK(s_State->s_DerivedTypeInfosMutex);
+
+  // lookups may still use the current snapshot, so it is copied and replaced
+  ezSharedPtr<ezResourceManagerState::DerivedTypeInfos> pInfos = EZ_DEFAULT_NEW(ezResourceManagerState::DerivedTypeInfos);
+  if (s_State->s_pDerivedTypeInfos != nullptr)
+  {
+    pInfos->m_Infos = s_State->s_pDerivedTypeInfos->m_Infos;
+  }
+
   const ezRTTI* pParentType = pDerivedTypeToUse->GetParentType();
   while (pParentType != nullptr && pParentType != ezGetStaticRTTI<ezResource>())
   {
-    auto& info = s_State->s_DerivedTypeInfos[pParentType].ExpandAndGetRef();
+    auto& info = pInfos->m_Infos[pParentType].ExpandAndGetRef();
     info.m_pDerivedType = pDerivedTypeToUse;
     info.m_Decider = OverrideDecider;
 
+    s_State->s_iNumDerivedTypeInfos.Increment();
+
     pParentType = pParentType->GetParentType();
   }
+
+  s_State->s_pDerivedTypeInfos = pInfos;
 }
 
 void ezResourceManager::UnregisterResourceOverrideType(const ezRTTI* pDerivedTypeToUse)
 {
+  EZ_LOCK(s_State->s_DerivedTypeInfosMutex);
+
+  if (s_State->s_pDerivedTypeInfos == nullptr)
+    return;
+
+  ezSharedPtr<ezResourceManagerState::DerivedTypeInfos> pInfos = EZ_DEFAULT_NEW(ezResourceManagerState::DerivedTypeInfos);
+  pInfos->m_Infos = s_State->s_pDerivedTypeInfos->m_Infos;
+
   const ezRTTI* pParentType = pDerivedTypeToUse->GetParentType();
   while (pParentType != nullptr && pParentType != ezGetStaticRTTI<ezResource>())
   {
-    auto it = s_State->s_DerivedTypeInfos.Find(pParentType);
+    auto it = pInfos->m_Infos.Find(pParentType);
     pParentType = pParentType->GetParentType();
 
     if (!it.IsValid())
@@ -752,14 +1046,32 @@ void ezResourceManager::UnregisterResourceOverrideType(const ezRTTI* pDerivedTyp
     for (ezUInt32 i = infos.GetCount(); i > 0; --i)
     {
       if (infos[i - 1].m_pDerivedType == pDerivedTypeToUse)
+      {
         infos.RemoveAtAndSwap(i - 1);
+        s_State->s_iNumDerivedTypeInfos.Decrement();
+      }
     }
   }
+
+  s_State->s_pDerivedTypeInfos = pInfos;
 }
 
 const ezRTTI* ezResourceManager::FindResourceTypeOverride(const ezRTTI* pRtti, const char* szResourceID)
 {
-  auto it = s_State->s_DerivedTypeInfos.Find(pRtti);
+  if (s_State->s_iNumDerivedTypeInfos == 0)
+    return pRtti;
+
+  ezSharedPtr<ezResourceManagerState::DerivedTypeInfos> pInfos;
+  {
+    EZ_LOCK(s_State->s_DerivedTypeInfosMutex);
+    pInfos = s_State->s_pDerivedTypeInfos;
+  }
+
+  if (pInfos == nullptr)
+    return pRtti;
+
+  // the deciders are called without holding the lock, they may take a while or load resources themselves
+  auto it = pInfos->m_Infos.Find(pRtti);
 
   if (!it.IsValid())
     return pRtti;
@@ -769,17 +1081,23 @@ const ezRTTI* ezResourceManager::FindResourceTypeOverride(const ezRTTI* pRtti, c
 
   while (it.IsValid())
   {
+    const ezRTTI* pOverride = nullptr;
+
     for (const auto& info : it.Value())
     {
       if (info.m_Decider(sRedirectedPath))
       {
-        pRtti = info.m_pDerivedType;
-        it = s_State->s_DerivedTypeInfos.Find(pRtti);
-        continue;
+        pOverride = info.m_pDerivedType;
+        break;
       }
     }
 
-    break;
+    if (pOverride == nullptr)
+      break;
+
+    // the override may be overridden itself
+    pRtti = pOverride;
+    it = pInfos->m_Infos.Find(pRtti);
   }
 
   return pRtti;
@@ -798,11 +1116,13 @@ ezTypelessResourceHandle ezResourceManager::GetExistingResourceByType(const ezRT
 
   const ezTempHashedString sResourceHash(szResourceID);
 
-  EZ_LOCK(s_ResourceMutex);
-
   const ezRTTI* pRtti = FindResourceTypeOverride(pResourceType, szResourceID);
 
-  if (s_State->s_LoadedResources[pRtti].m_Resources.TryGetValue(sResourceHash, pResource))
+  auto& shard = s_State->GetShard(sResourceHash);
+  EZ_LOCK(shard.m_Mutex);
+
+  LoadedResources* pLoadedResources = nullptr;
+  if (shard.m_LoadedResources.TryGetValue(pRtti, pLoadedResources) && pLoadedResources->m_Resources.TryGetValue(sResourceHash, pResource))
     return ezTypelessResourceHandle(pResource);
 
   return ezTypelessResourceHandle();
@@ -824,22 +1144,25 @@ void ezResourceManager::ForceLoadResourceNow(const ezTypelessResourceHandle& hRe
 
 void ezResourceManager::RegisterNamedResource(const char* szLookupName, const char* szRedirectionResource)
 {
-  EZ_LOCK(s_ResourceMutex);
-
   ezTempHashedString lookup(szLookupName);
 
   ezHashedString redirection;
   redirection.Assign(szRedirectionResource);
 
-  s_State->s_NamedResources[lookup] = redirection;
+  auto& shard = s_State->GetShard(lookup);
+  EZ_LOCK(shard.m_Mutex);
+
+  shard.m_NamedResources[lookup] = redirection;
 }
 
 void ezResourceManager::UnregisterNamedResource(const char* szLookupName)
 {
-  EZ_LOCK(s_ResourceMutex);
-
   ezTempHashedString hash(szLookupName);
-  s_State->s_NamedResources.Remove(hash);
+
+  auto& shard = s_State->GetShard(hash);
+  EZ_LOCK(shard.m_Mutex);
+
+  shard.m_NamedResources.Remove(hash);
 }
 
 void ezResourceManager::SetResourceLowResData(const ezTypelessResourceHandle& hResource, ezStreamReader* pStream)
@@ -868,21 +1191,6 @@ void ezResourceManager::SetResourceLowResData(const ezTypelessResourceHandle& hR
   pResource->CallUpdateContent(pStream);
 
   EZ_ASSERT_DEV(pResource->GetLoadingState() != ezResourceState::Unloaded, "The resource should have changed its loading state.");
-
-  // Update Memory Usage
-  {
-    ezResource::MemoryUsage MemUsage;
-    MemUsage.m_uiMemoryCPU = 0xFFFFFFFF;
-    MemUsage.m_uiMemoryGPU = 0xFFFFFFFF;
-    pResource->UpdateMemoryUsage(MemUsage);
-
-    EZ_ASSERT_DEV(
-      MemUsage.m_uiMemoryCPU != 0xFFFFFFFF, "Resource '{0}' did not properly update its CPU memory usage", pResource->GetResourceID());
-    EZ_ASSERT_DEV(
-      MemUsage.m_uiMemoryGPU != 0xFFFFFFFF, "Resource '{0}' did not properly update its GPU memory usage", pResource->GetResourceID());
-
-    pResource->m_MemoryUsage = MemUsage;
-  }
 }
 
 ezResourceTypeLoader* ezResourceManager::GetDefaultResourceLoader()
@@ -924,9 +1232,29 @@ ezTime ezResourceManager::GetLastFrameUpdate()
   return s_State->s_LastFrameUpdate;
 }
 
-ezHashTable<const ezRTTI*, ezResourceManager::LoadedResources>& ezResourceManager::GetLoadedResources()
+void ezResourceManager::CollectAllResourcesOfType(const ezRTTI* pBaseType, ezDynamicArray<ezResource*>& out_Resources)
 {
-  return s_State->s_LoadedResources;
+  EZ_ASSERT_DEBUG(s_ResourceMutex.IsLocked(), "Calling code must acquire s_ResourceMutex to prevent the resources from being deallocated");
+
+  for (auto& shard : s_State->s_LoadedResourcesShards)
+  {
+    EZ_LOCK(shard.m_Mutex);
+
+    for (auto itType = shard.m_LoadedResources.GetIterator(); itType.IsValid(); itType.Next())
+    {
+      if (itType.Key()->IsDerivedFrom(pBaseType))
+      {
+        const LoadedResources& lr = itType.Value();
+
+        out_Resources.Reserve(out_Resources.GetCount() + lr.m_Resources.GetCount());
+
+        for (auto itResource : lr.m_Resources)
+        {
+          out_Resources.PushBack(itResource.Value());
+        }
+      }
+    }
+  }
 }
 
 ezDynamicArray<ezResource*>& ezResourceManager::GetLoadedResourceOfTypeTempContainer()
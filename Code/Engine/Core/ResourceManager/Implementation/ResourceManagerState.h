@@ -4,6 +4,9 @@
 EZ_CORE_INTERNAL_HEADER
 
 #include <Core/ResourceManager/ResourceManager.h>
+#include <Foundation/Threading/ConditionVariable.h>
+#include <Foundation/Types/RefCounted.h>
+#include <Foundation/Types/SharedPtr.h>
 
 class ezResourceManagerState
 {
@@ -51,9 +54,38 @@ private:
   ezUInt32 s_uiForceNoFallbackAcquisition = 0;
 
   // resources in this queue are waiting for a task to load them
-  ezDeque<ezResourceManager::LoadingInfo> s_LoadingQueue;
+  // this is a binary min-heap sorted by due date, see ezResourceManager::AddToLoadingQueue()
+  ezDynamicArray<ezResourceManager::LoadingInfo> s_LoadingQueue;
 
-  ezHashTable<const ezRTTI*, ezResourceManager::LoadedResources> s_LoadedResources;
+  // loading queue statistics, published through ezStats once per frame
+  ezUInt32 s_uiLoadingQueueNumDequeued = 0;
+  ezUInt32 s_uiLoadingQueueDeadlineMisses = 0;
+  ezTime s_LoadingQueueWaitTimeSum;
+  ezTime s_LoadingQueueAverageWaitTime;
+
+  /// \name Loaded Resources
+  ///@{
+
+  /// All existing resources (and named resource redirections) are distributed over several shards by the hash of their resource ID.
+  /// Each shard has its own mutex, so looking up existing resources on different threads rarely contends on the same lock.
+  ///
+  /// Creating and deallocating resources additionally requires s_ResourceMutex, which always has to be locked before a shard mutex.
+  struct LoadedResourcesShard
+  {
+    ezMutex m_Mutex;
+    ezHashTable<const ezRTTI*, ezResourceManager::LoadedResources> m_LoadedResources;
+    ezHashTable<ezTempHashedString, ezHashedString> m_NamedResources;
+  };
+
+  static constexpr ezUInt32 NumLoadedResourcesShards = 16;
+  LoadedResourcesShard s_LoadedResourcesShards[NumLoadedResourcesShards];
+
+  EZ_ALWAYS_INLINE LoadedResourcesShard& GetShard(const ezTempHashedString& sResourceID)
+  {
+    return s_LoadedResourcesShards[sResourceID.GetHash() & (NumLoadedResourcesShards - 1)];
+  }
+
+  ///@}
 
   bool s_bAllowLaunchDataLoadTask = true;
   bool s_bShutdown = false;
@@ -67,6 +99,7 @@ private:
   ezDynamicArray<ezResource*> s_LoadedResourceOfTypeTempContainer;
   ezHashTable<ezTempHashedString, const ezRTTI*> s_ResourcesToUnloadOnMainThread;
 
+  ezUInt32 s_uiFreeUnusedLastShard = 0;
   const ezRTTI* s_pFreeUnusedLastType = nullptr;
   ezTempHashedString s_FreeUnusedLastResourceID;
 
@@ -80,12 +113,17 @@ private:
 
   // Override / derived resources
 
-  ezMap<const ezRTTI*, ezHybridArray<ezResourceManager::DerivedTypeInfo, 4>> s_DerivedTypeInfos;
-
+  /// Resource handles are looked up without holding s_ResourceMutex, so the override types are published as an immutable snapshot.
+  /// Registration replaces the snapshot, lookups only lock to take a reference to it and run the deciders without any lock.
+  struct DerivedTypeInfos : public ezRefCounted
+  {
+    ezMap<const ezRTTI*, ezHybridArray<ezResourceManager::DerivedTypeInfo, 4>> m_Infos;
+  };
 
-  // Named resources
+  ezMutex s_DerivedTypeInfosMutex;
+  ezSharedPtr<DerivedTypeInfos> s_pDerivedTypeInfos;
+  ezAtomicInteger32 s_iNumDerivedTypeInfos; ///< Lookups skip the lock entirely while no override is registered.
 
-  ezHashTable<ezTempHashedString, ezHashedString> s_NamedResources;
 
   // Asset system interaction
 
@@ -100,6 +138,10 @@ private:
   // Resource Unloading
   ezTime m_AutoFreeUnusedTimeout = ezTime::Zero();
   ezTime m_AutoFreeUnusedThreshold = ezTime::Zero();
+  bool m_bAnyMemoryBudget = false;
+
+  /// Signaled whenever EnforceMemoryBudgets() finished downgrading a resource, acquires that had to wait for it block on this.
+  ezConditionVariable m_DowngradeFinished;
 
   ezMap<const ezRTTI*, ezResourceManager::ResourceTypeInfo> m_TypeInfo;
 };
@@ -2,30 +2,19 @@
 
 #include <Foundation/Logging/Log.h>
 
-template <typename ResourceType>
-ResourceType* ezResourceManager::GetResource(const char* szResourceID, bool bIsReloadable)
-{
-  return static_cast<ResourceType*>(GetResource(ezGetStaticRTTI<ResourceType>(), szResourceID, bIsReloadable));
-}
-
 template <typename ResourceType>
 ezTypedResourceHandle<ResourceType> ezResourceManager::LoadResource(const char* szResourceID)
 {
-  // the mutex here is necessary to prevent a race between resource unloading and storing the pointer in the handle
-  EZ_LOCK(s_ResourceMutex);
-  return ezTypedResourceHandle<ResourceType>(GetResource<ResourceType>(szResourceID, true));
+  ezTypedResourceHandle<ResourceType> hResource;
+  hResource.m_Typeless = GetResourceHandle(ezGetStaticRTTI<ResourceType>(), szResourceID, true);
+  return hResource;
 }
 
 template <typename ResourceType>
 ezTypedResourceHandle<ResourceType> ezResourceManager::LoadResource(
   const char* szResourceID, ezTypedResourceHandle<ResourceType> hLoadingFallback)
 {
-  ezTypedResourceHandle<ResourceType> hResource;
-  {
-    // the mutex here is necessary to prevent a race between resource unloading and storing the pointer in the handle
-    EZ_LOCK(s_ResourceMutex);
-    hResource = ezTypedResourceHandle<ResourceType>(GetResource<ResourceType>(szResourceID, true));
-  }
+  ezTypedResourceHandle<ResourceType> hResource = LoadResource<ResourceType>(szResourceID);
 
   ResourceType* pResource = ezResourceManager::BeginAcquireResource(hResource, ezResourceAcquireMode::PointerOnly, ezTypedResourceHandle<ResourceType>());
 
@@ -42,18 +31,9 @@ ezTypedResourceHandle<ResourceType> ezResourceManager::LoadResource(
 template <typename ResourceType>
 ezTypedResourceHandle<ResourceType> ezResourceManager::GetExistingResource(const char* szResourceID)
 {
-  ezResource* pResource = nullptr;
-
-  const ezTempHashedString sResourceHash(szResourceID);
-
-  EZ_LOCK(s_ResourceMutex);
-
-  const ezRTTI* pRtti = FindResourceTypeOverride(ezGetStaticRTTI<ResourceType>(), szResourceID);
-
-  if (GetLoadedResources()[pRtti].m_Resources.TryGetValue(sResourceHash, pResource))
-    return ezTypedResourceHandle<ResourceType>((ResourceType*)pResource);
-
-  return ezTypedResourceHandle<ResourceType>();
+  ezTypedResourceHandle<ResourceType> hResource;
+  hResource.m_Typeless = GetExistingResourceByType(ezGetStaticRTTI<ResourceType>(), szResourceID);
+  return hResource;
 }
 
 template <typename ResourceType, typename DescriptorType>
@@ -66,7 +46,8 @@ ezTypedResourceHandle<ResourceType> ezResourceManager::CreateResource(
 
   EZ_LOCK(s_ResourceMutex);
 
-  ezTypedResourceHandle<ResourceType> hResource(GetResource<ResourceType>(szResourceID, false));
+  ezTypedResourceHandle<ResourceType> hResource;
+  hResource.m_Typeless = GetResourceHandle(ezGetStaticRTTI<ResourceType>(), szResourceID, false);
 
   ResourceType* pResource = BeginAcquireResource(hResource, ezResourceAcquireMode::PointerOnly);
   pResource->SetResourceDescription(szResourceDescription);
@@ -123,13 +104,31 @@ ResourceType* ezResourceManager::BeginAcquireResource(const ezTypedResourceHandl
     if (out_AcquireResult)
       *out_AcquireResult = ezResourceAcquireResult::Final;
 
+    // the content is not accessed, so there is no need to wait for a concurrent downgrade
     pResource->m_iLockCount.Increment();
     return pResource;
   }
 
   // only set the last accessed time stamp, if it is actually needed, pointer-only access might not mean that the resource is used
   // productively
-  pResource->m_LastAcquire = GetLastFrameUpdate();
+  // the time stamp only changes once per frame, skipping redundant writes prevents threads that acquire the same resource from
+  // constantly invalidating each other's cache line
+  const ezTime tLastFrameUpdate = GetLastFrameUpdate();
+  if (pResource->m_LastAcquire != tLastFrameUpdate)
+    pResource->m_LastAcquire = tLastFrameUpdate;
+
+  // fast path: the resource is fully loaded (or the next quality level is already queued or limited by the memory budget), so nothing
+  // needs to be locked or scheduled
+  // accessing the flags without a lock is fine here, for the same reasons as explained below
+  if (pResource->GetLoadingState() == ezResourceState::Loaded &&
+      (pResource->GetNumQualityLevelsLoadable() == 0 || pResource->m_Flags.IsAnySet(ezResourceFlags::IsQueuedForLoading | ezResourceFlags::QualityLimitedByBudget)))
+  {
+    if (out_AcquireResult)
+      *out_AcquireResult = ezResourceAcquireResult::Final;
+
+    IncrementLockCount(pResource);
+    return pResource;
+  }
 
   if (pResource->GetLoadingState() != ezResourceState::LoadedResourceMissing)
   {
@@ -200,10 +199,18 @@ ResourceType* ezResourceManager::BeginAcquireResource(const ezTypedResourceHandl
   if (out_AcquireResult)
     *out_AcquireResult = ezResourceAcquireResult::Final;
 
-  pResource->m_iLockCount.Increment();
+  IncrementLockCount(pResource);
   return pResource;
 }
 
+EZ_ALWAYS_INLINE void ezResourceManager::IncrementLockCount(ezResource* pResource)
+{
+  if (pResource->m_iLockCount.Increment() < 0)
+  {
+    WaitForDowngrade(pResource);
+  }
+}
+
 template <typename ResourceType>
 void ezResourceManager::EndAcquireResource(ResourceType* pResource)
 {
@@ -228,23 +235,7 @@ ezLockedObject<ezMutex, ezDynamicArray<ezResource*>> ezResourceManager::GetAllRe
   ezLockedObject<ezMutex, ezDynamicArray<ezResource*>> loadedResourcesLock(s_ResourceMutex, &container);
 
   container.Clear();
-
-  for (auto itType = GetLoadedResources().GetIterator(); itType.IsValid(); itType.Next())
-  {
-    const ezRTTI* pDerivedType = itType.Key();
-
-    if (pDerivedType->IsDerivedFrom(pBaseType))
-    {
-      const LoadedResources& lr = GetLoadedResources()[pDerivedType];
-
-      container.Reserve(container.GetCount() + lr.m_Resources.GetCount());
-
-      for (auto itResource : lr.m_Resources)
-      {
-        container.PushBack(itResource.Value());
-      }
-    }
-  }
+  CollectAllResourcesOfType(pBaseType, container);
 
   return loadedResourcesLock;
 }
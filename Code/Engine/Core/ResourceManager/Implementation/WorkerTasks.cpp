@@ -27,9 +27,7 @@ void ezResourceManagerWorkerDataLoad::Execute()
 
     ezResourceManager::UpdateLoadingDeadlines();
 
-    auto it = ezResourceManager::s_State->s_LoadingQueue.PeekFront();
-    pResourceToLoad = it.m_pResource;
-    ezResourceManager::s_State->s_LoadingQueue.PopFront();
+    pResourceToLoad = ezResourceManager::PopFromLoadingQueue();
 
     if (pResourceToLoad->m_Flags.IsSet(ezResourceFlags::HasCustomDataLoader))
     {
@@ -128,19 +126,6 @@ void ezResourceManagerWorkerUpdateContent::Execute()
 
   EZ_ASSERT_DEV(m_pResourceToLoad->GetLoadingState() != ezResourceState::Unloaded, "The resource should have changed its loading state.");
 
-  // Update Memory Usage
-  {
-    ezResource::MemoryUsage MemUsage;
-    MemUsage.m_uiMemoryCPU = 0xFFFFFFFF;
-    MemUsage.m_uiMemoryGPU = 0xFFFFFFFF;
-    m_pResourceToLoad->UpdateMemoryUsage(MemUsage);
-
-    EZ_ASSERT_DEV(MemUsage.m_uiMemoryCPU != 0xFFFFFFFF, "Resource '{0}' did not properly update its CPU memory usage", m_pResourceToLoad->GetResourceID());
-    EZ_ASSERT_DEV(MemUsage.m_uiMemoryGPU != 0xFFFFFFFF, "Resource '{0}' did not properly update its GPU memory usage", m_pResourceToLoad->GetResourceID());
-
-    m_pResourceToLoad->m_MemoryUsage = MemUsage;
-  }
-
   m_pLoader->CloseDataStream(m_pResourceToLoad, m_LoaderData);
 
   {
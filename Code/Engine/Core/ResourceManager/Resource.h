@@ -216,6 +216,9 @@ private:
   /// \brief Called by ezResourceMananger::CreateResource
   void VerifyAfterCreateResource(const ezResourceLoadDesc& ld);
 
+  /// \brief Queries UpdateMemoryUsage() and passes the result on to the memory budget of the resource type.
+  void RefreshMemoryUsage();
+
   ezUInt32 m_uiUniqueIDHash = 0;
   ezUInt32 m_uiResourceChangeCounter = 0;
   ezAtomicInteger32 m_iReferenceCount = 0;
@@ -223,12 +226,16 @@ private:
   ezString m_UniqueID;
   ezString m_sResourceDescription;
   MemoryUsage m_MemoryUsage;
+  MemoryUsage m_BudgetedMemoryUsage; ///< The part of m_MemoryUsage that is included in the usage of the resource type, only accessed by ezResourceManager.
   ezBitflags<ezResourceFlags> m_Flags;
 
   ezTime m_LastAcquire;
   ezResourcePriority m_Priority = ezResourcePriority::Medium;
   ezTimestamp m_LoadedFileModificationTime;
 
+  /// Index into the resource manager's loading queue. Invalid when the resource is not in the queue (anymore).
+  ezUInt32 m_uiLoadingQueueIndex = ezInvalidIndex;
+
 private:
 #if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
   static const ezResource* GetCurrentlyUpdatingContent();
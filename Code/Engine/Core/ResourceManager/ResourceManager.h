@@ -170,7 +170,7 @@ public:
 
   /// \brief Retrieves an array of pointers to resources of the indicated type which
   /// are loaded at the moment. Destroy the returned object as soon as possible as it
-  /// holds the entire resource manager locked.
+  /// holds the resource manager mutex locked, which prevents any resource from being created or deallocated.
   template <typename ResourceType>
   static ezLockedObject<ezMutex, ezDynamicArray<ezResource*>> GetAllResourcesOfType();
 
@@ -192,6 +192,30 @@ public:
   template <typename ResourceType>
   static void SetIncrementalUnloadForResourceType(bool bActive);
 
+  /// \brief Sets how much CPU and GPU memory all resources of the given type may use together. Zero means unlimited.
+  ///
+  /// The budget only applies to resources of exactly this type, not to derived types.
+  /// Once a budget is set, EnforceMemoryBudgets() is called every frame by PerFrameUpdate().
+  template <typename ResourceType>
+  static void SetResourceTypeMemoryBudget(ezUInt64 uiBudgetCPU, ezUInt64 uiBudgetGPU)
+  {
+    SetResourceTypeMemoryBudget(ezGetStaticRTTI<ResourceType>(), uiBudgetCPU, uiBudgetGPU);
+  }
+
+  /// \sa SetResourceTypeMemoryBudget()
+  static void SetResourceTypeMemoryBudget(const ezRTTI* pResourceType, ezUInt64 uiBudgetCPU, ezUInt64 uiBudgetGPU);
+
+  /// \brief Returns the summed up memory usage of all resources of exactly the given type.
+  static void GetResourceTypeMemoryUsage(const ezRTTI* pResourceType, ezUInt64& out_uiMemoryCPU, ezUInt64& out_uiMemoryGPU);
+
+  /// \brief Brings all resource types that have a memory budget back below it. Returns the number of deallocated or downgraded resources.
+  ///
+  /// The least recently acquired resources are handled first, and among those the ones with the lowest priority.
+  /// Resources that are not referenced anymore are deallocated. Referenced resources that have discardable quality levels
+  /// are downgraded by one quality level and won't stream in higher quality levels again, until the type is well below its budget.
+  /// Resources that are currently acquired or in the loading queue are skipped.
+  static ezUInt32 EnforceMemoryBudgets();
+
   template<typename TypeBeingUpdated, typename TypeItWantsToAcquire>
   static void AllowResourceTypeAcquireDuringUpdateContent()
   {
@@ -212,6 +236,9 @@ private:
 public:
   /// \brief Returns the resource manager mutex. Allows to lock the manager on a thread when multiple operations need to be done in
   /// sequence.
+  ///
+  /// While this mutex is held, no resource can be created or deallocated. Looking up already existing resources (e.g. through
+  /// LoadResource()) only locks a small internal mutex, though, so this does not serialize all resource manager access.
   static ezMutex& GetMutex() { return s_ResourceMutex; }
 
   /// \brief Must be called once per frame for some bookkeeping.
@@ -422,37 +449,75 @@ private:
 
   struct LoadingInfo
   {
-    float m_fPriority = 0;
+    ezTime m_DueDate;    ///< The time by which the resource should be loaded. The loading queue always returns the earliest due date first.
+    ezTime m_QueuedTime; ///< When the resource was put into the queue, used for the wait time statistics.
     ezResource* m_pResource = nullptr;
 
-    EZ_ALWAYS_INLINE bool operator==(const LoadingInfo& rhs) const { return m_pResource == rhs.m_pResource; }
-    EZ_ALWAYS_INLINE bool operator<(const LoadingInfo& rhs) const { return m_fPriority < rhs.m_fPriority; }
+    EZ_ALWAYS_INLINE bool operator<(const LoadingInfo& rhs) const
+    {
+      if (m_DueDate != rhs.m_DueDate)
+        return m_DueDate < rhs.m_DueDate;
+
+      return m_QueuedTime < rhs.m_QueuedTime;
+    }
   };
   static void EnsureResourceLoadingState(ezResource* pResource, const ezResourceState RequestedState);
   static void PreloadResource(ezResource* pResource);
   static void InternalPreloadResource(ezResource* pResource, bool bHighestPriority);
 
-  template <typename ResourceType>
-  static ResourceType* GetResource(const char* szResourceID, bool bIsReloadable);
-  static ezResource* GetResource(const ezRTTI* pRtti, const char* szResourceID, bool bIsReloadable);
+  /// \brief Returns a handle to the existing resource with the given ID or creates a new resource.
+  ///
+  /// The handle is created while the internal lock is held, which prevents a race between resource unloading and storing the pointer in
+  /// the handle.
+  static ezTypelessResourceHandle GetResourceHandle(const ezRTTI* pRtti, const char* szResourceID, bool bIsReloadable);
   static void RunWorkerTask(ezResource* pResource);
   static void UpdateLoadingDeadlines();
-  static void ReverseBubbleSortStep(ezDeque<LoadingInfo>& data);
+  static ezTime ComputeLoadingDueDate(const ezResource* pResource, ezTime tNow);
+  static void UpdateLoadingQueueStats();
   static bool ReloadResource(ezResource* pResource, bool bForce);
 
   static void SetupWorkerTasks();
   static ezTime GetLastFrameUpdate();
-  static ezHashTable<const ezRTTI*, LoadedResources>& GetLoadedResources();
+
+  /// \brief While EnforceMemoryBudgets() downgrades a resource, its lock count is offset by this value, which makes it negative.
+  ///
+  /// BeginAcquireResource() does not take any lock, so this is how it detects a concurrent downgrade. Acquires that access the content wait
+  /// for the downgrade to finish, pointer-only acquires don't.
+  static constexpr ezInt32 s_iDowngradeLockCount = -0x40000000;
+
+  /// \brief Increments the lock count of the resource and waits until it is not being downgraded anymore.
+  static void IncrementLockCount(ezResource* pResource);
+  static void WaitForDowngrade(ezResource* pResource);
+  static void FinishDowngrade(ezResource* pResource);
+
+  /// \brief Applies the difference to the previously budgeted memory usage of the resource to the usage of its type.
+  static void UpdateBudgetedMemoryUsage(ezResource* pResource, const ezResource::MemoryUsage& usage);
+  static void CollectAllResourcesOfType(const ezRTTI* pBaseType, ezDynamicArray<ezResource*>& out_Resources);
   static ezDynamicArray<ezResource*>& GetLoadedResourceOfTypeTempContainer();
 
   EZ_ALWAYS_INLINE static bool IsQueuedForLoading(ezResource* pResource) { return pResource->m_Flags.IsSet(ezResourceFlags::IsQueuedForLoading); }
   [[nodiscard]] static ezResult RemoveFromLoadingQueue(ezResource* pResource);
   static void AddToLoadingQueue(ezResource* pResource, bool bHighPriority);
+  static ezResource* PopFromLoadingQueue();
+
+  // The loading queue is a binary min-heap, every queued resource knows its index in the heap, which allows to update or remove entries in O(log n).
+  static ezUInt32 LoadingQueueSiftUp(ezUInt32 uiIndex);
+  static void LoadingQueueSiftDown(ezUInt32 uiIndex);
+  static void LoadingQueueRemoveAt(ezUInt32 uiIndex);
 
   struct ResourceTypeInfo
   {
     bool m_bIncrementalUnload = true;
     bool m_bAllowNestedAcquireCached = false;
+    bool m_bQualityLimitedByBudget = false;
+
+    ezUInt64 m_uiMemoryBudgetCPU = 0;
+    ezUInt64 m_uiMemoryBudgetGPU = 0;
+
+    // the summed up memory usage of all resources of this type, kept up to date by UpdateBudgetedMemoryUsage()
+    ezUInt64 m_uiMemoryUsageCPU = 0;
+    ezUInt64 m_uiMemoryUsageGPU = 0;
+    bool m_bMemoryUsageChanged = true; ///< The stats are only updated when this is set.
 
     ezHybridArray<const ezRTTI*, 8> m_NestedTypes;
   };
@@ -152,9 +152,10 @@ template <typename T, ezBlockStorageType::Enum StorageType>
 EZ_FORCE_INLINE void ezComponentManager<T, StorageType>::RegisterUpdateFunction(UpdateFunctionDesc& desc)
 {
   // round up to multiple of data block capacity so tasks only have to deal with complete data blocks
-  if (desc.m_uiGranularity != 0)
+  // with automatic granularity this is the minimum batch size, the world will only choose multiples of it
+  if (desc.m_uiGranularity != 0 || desc.m_bAutoGranularity)
     desc.m_uiGranularity =
-        ezMath::RoundUp((ezInt32)desc.m_uiGranularity, ezDataBlock<ComponentType, ezInternal::DEFAULT_BLOCK_SIZE>::CAPACITY);
+        ezMath::RoundUp(ezMath::Max((ezInt32)desc.m_uiGranularity, 1), ezDataBlock<ComponentType, ezInternal::DEFAULT_BLOCK_SIZE>::CAPACITY);
 
   ezComponentManagerBase::RegisterUpdateFunction(desc);
 }
@@ -214,5 +214,59 @@ void ezSpatialSystem::FindVisibleObjects(const ezFrustum& frustum, ezUInt32 uiCa
 }
 
 
+void ezSpatialSystem::FindVisibleObjects(ezArrayPtr<const ezFrustum> frustums, ezUInt32 uiCategoryBitmask,
+  ezArrayPtr<ezDynamicArray<const ezGameObject*>*> out_ObjectsPerFrustum, QueryStats* pStats /*= nullptr*/) const
+{
+  EZ_ASSERT_DEV(frustums.GetCount() == out_ObjectsPerFrustum.GetCount(), "Number of frustums ({0}) and output arrays ({1}) must match",
+    frustums.GetCount(), out_ObjectsPerFrustum.GetCount());
+
+#if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
+  ezStopwatch timer;
+
+  if (pStats != nullptr)
+  {
+    pStats->m_uiTotalNumObjects = m_DataTable.GetCount();
+    pStats->m_uiNumObjectsTested += m_DataAlwaysVisible.GetCount() * frustums.GetCount();
+    pStats->m_uiNumObjectsPassed += m_DataAlwaysVisible.GetCount() * frustums.GetCount();
+  }
+#endif
+
+  for (ezUInt32 uiFirstFrustum = 0; uiFirstFrustum < frustums.GetCount(); uiFirstFrustum += MAX_FRUSTUMS_PER_BATCH)
+  {
+    const ezUInt32 uiNumFrustums = ezMath::Min<ezUInt32>(frustums.GetCount() - uiFirstFrustum, MAX_FRUSTUMS_PER_BATCH);
+
+    FindVisibleObjectsBatchedInternal(
+      frustums.GetSubArray(uiFirstFrustum, uiNumFrustums), uiCategoryBitmask, out_ObjectsPerFrustum.GetSubArray(uiFirstFrustum, uiNumFrustums), pStats);
+  }
+
+  for (auto pData : m_DataAlwaysVisible)
+  {
+    if ((pData->m_uiCategoryBitmask & uiCategoryBitmask) != 0)
+    {
+      for (auto pObjects : out_ObjectsPerFrustum)
+      {
+        pObjects->PushBack(pData->m_pObject);
+      }
+    }
+  }
+
+#if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
+  if (pStats != nullptr)
+  {
+    pStats->m_TimeTaken = timer.GetRunningTotal();
+  }
+#endif
+}
+
+void ezSpatialSystem::FindVisibleObjectsBatchedInternal(ezArrayPtr<const ezFrustum> frustums, ezUInt32 uiCategoryBitmask,
+  ezArrayPtr<ezDynamicArray<const ezGameObject*>*> out_ObjectsPerFrustum, QueryStats* pStats) const
+{
+  for (ezUInt32 i = 0; i < frustums.GetCount(); ++i)
+  {
+    FindVisibleObjectsInternal(frustums[i], uiCategoryBitmask, *out_ObjectsPerFrustum[i], pStats);
+  }
+}
+
+
 
 EZ_STATICLINK_FILE(Core, Core_World_Implementation_SpatialSystem);
@@ -0,0 +1,742 @@
+#include <CorePCH.h>
+
+#include <Core/World/Implementation/SpatialSystemHelper.h>
+#include <Core/World/SpatialSystem_LooseOctree.h>
+#include <Foundation/SimdMath/SimdConversion.h>
+
+namespace
+{
+  enum
+  {
+    MAX_OCTREE_DEPTH = 20,
+    ROOT_NODE_INDEX = 0
+  };
+
+  // during traversal at most 7 siblings per level are waiting on the stack, so this never needs to allocate
+  typedef ezHybridArray<ezUInt32, 8 * MAX_OCTREE_DEPTH> OctreeNodeStack;
+
+  struct BatchedTraversalEntry
+  {
+    EZ_DECLARE_POD_TYPE();
+
+    ezUInt32 m_uiNodeIndex;
+    ezUInt32 m_uiIntersectingFrustums; ///< Bitmask of the frustums that partially overlap the parent node.
+    ezUInt32 m_uiContainingFrustums;   ///< Bitmask of the frustums that contain the parent node completely.
+  };
+
+  typedef ezHybridArray<BatchedTraversalEntry, 8 * MAX_OCTREE_DEPTH> BatchedTraversalStack;
+
+  EZ_ALWAYS_INLINE ezSimdBBox ComputeLooseNodeBox(const ezSimdVec4f& centerAndHalfSize)
+  {
+    // the loose bounds of a node are twice as large as its cell
+    const ezSimdVec4f looseHalfSize = centerAndHalfSize.Get<ezSwizzle::WWWW>() * 2.0f;
+    return ezSimdBBox(centerAndHalfSize - looseHalfSize, centerAndHalfSize + looseHalfSize);
+  }
+} // namespace
+
+//////////////////////////////////////////////////////////////////////////
+
+struct ezSpatialSystem_LooseOctree::SpatialUserData
+{
+  ezUInt32 m_uiNodeIndex = ezInvalidIndex;
+  ezUInt32 m_uiDataIndex = ezInvalidIndex;
+};
+
+//////////////////////////////////////////////////////////////////////////
+
+struct ezSpatialSystem_LooseOctree::Node
+{
+  Node(ezAllocatorBase* pAllocator, ezAllocatorBase* pAlignedAllocator)
+    : m_BoundingSpheres(pAlignedAllocator)
+    , m_DataPointers(pAllocator)
+    , m_CategoryBitmasks(pAllocator)
+  {
+    ResetChildren();
+  }
+
+  EZ_ALWAYS_INLINE void ResetChildren()
+  {
+    for (ezUInt32 i = 0; i < 8; ++i)
+    {
+      m_Children[i] = ezInvalidIndex;
+    }
+  }
+
+  EZ_ALWAYS_INLINE ezSimdBBox GetLooseBox() const { return ComputeLooseNodeBox(m_CenterAndHalfSize); }
+
+  EZ_ALWAYS_INLINE ezSimdVec4f GetLooseCenterAndHalfSize() const
+  {
+    ezSimdVec4f res = m_CenterAndHalfSize;
+    res.SetW(m_CenterAndHalfSize.w() * ezSimdFloat(2.0f));
+    return res;
+  }
+
+  /// \brief Adds all objects of the given categories without any further tests.
+  EZ_FORCE_INLINE void AddAllObjects(ezUInt32 uiCategoryBitmask, ezDynamicArray<const ezGameObject*>& out_Objects, ezSpatialSystem::QueryStats& localStats) const
+  {
+    for (ezUInt32 i = 0; i < m_DataPointers.GetCount(); ++i)
+    {
+      if ((m_CategoryBitmasks[i] & uiCategoryBitmask) != 0)
+      {
+        out_Objects.PushBack(m_DataPointers[i]->m_pObject);
+
+#if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
+        localStats.m_uiNumObjectsPassed++;
+#endif
+      }
+    }
+  }
+
+  /// \brief Tests the objects of the given categories against the frustum, two at a time.
+  EZ_FORCE_INLINE void FindVisibleObjects(ezUInt32 uiCategoryBitmask, const ezInternal::SpatialSystemPlaneData& planeData,
+    ezDynamicArray<const ezGameObject*>& out_Objects, ezSpatialSystem::QueryStats& localStats) const
+  {
+    const ezUInt32 uiNumObjects = m_BoundingSpheres.GetCount();
+    const ezSimdBSphere* pSpheres = m_BoundingSpheres.GetData();
+    const ezUInt32* pCategories = m_CategoryBitmasks.GetData();
+
+    ezUInt32 i = 0;
+    for (; i + 2 <= uiNumObjects; i += 2)
+    {
+      ezUInt32 uiCategoryMask = (pCategories[i + 0] & uiCategoryBitmask) != 0 ? 1 : 0;
+      uiCategoryMask |= (pCategories[i + 1] & uiCategoryBitmask) != 0 ? 2 : 0;
+
+      if (uiCategoryMask == 0)
+        continue;
+
+#if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
+      localStats.m_uiNumObjectsTested += ezMath::CountBits(uiCategoryMask);
+#endif
+
+      ezUInt32 uiVisibleMask = ezInternal::SphereFrustumIntersect(pSpheres[i + 0], pSpheres[i + 1], planeData) & uiCategoryMask;
+
+      while (uiVisibleMask > 0)
+      {
+        const ezUInt32 uiBit = ezMath::FirstBitLow(uiVisibleMask);
+        uiVisibleMask &= uiVisibleMask - 1;
+
+        out_Objects.PushBack(m_DataPointers[i + uiBit]->m_pObject);
+
+#if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
+        localStats.m_uiNumObjectsPassed++;
+#endif
+      }
+    }
+
+    if (i < uiNumObjects && (pCategories[i] & uiCategoryBitmask) != 0)
+    {
+#if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
+      localStats.m_uiNumObjectsTested++;
+#endif
+
+      if (ezInternal::SphereFrustumIntersect(pSpheres[i], planeData))
+      {
+        out_Objects.PushBack(m_DataPointers[i]->m_pObject);
+
+#if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
+        localStats.m_uiNumObjectsPassed++;
+#endif
+      }
+    }
+  }
+
+  ezSimdVec4f m_CenterAndHalfSize; ///< Center and half edge length of the cell, the loose bounds are twice as large.
+
+  ezUInt32 m_uiParent = ezInvalidIndex;
+  ezUInt32 m_uiDepth = 0;
+  ezUInt32 m_Children[8];
+
+  ezUInt32 m_uiNumObjectsInSubtree = 0;
+
+  // All categories of the objects in this node and its descendants. Extended when objects are added and recomputed when objects are
+  // removed or change their category.
+  ezUInt32 m_uiCategoryBitmask = 0;
+
+  ezDynamicArray<ezSimdBSphere> m_BoundingSpheres;
+  ezDynamicArray<ezSpatialData*> m_DataPointers;
+  ezDynamicArray<ezUInt32> m_CategoryBitmasks;
+};
+
+//////////////////////////////////////////////////////////////////////////
+
+EZ_BEGIN_DYNAMIC_REFLECTED_TYPE(ezSpatialSystem_LooseOctree, 1, ezRTTINoAllocator)
+EZ_END_DYNAMIC_REFLECTED_TYPE;
+
+ezSpatialSystem_LooseOctree::ezSpatialSystem_LooseOctree(float fWorldSize /*= 65536.0f*/, float fMinNodeSize /*= 16.0f*/)
+  : m_AlignedAllocator("Spatial System Aligned", ezFoundation::GetAlignedAllocator())
+  , m_fRootHalfSize(fWorldSize * 0.5f)
+  , m_Nodes(&m_AlignedAllocator)
+  , m_FreeNodes(&m_Allocator)
+{
+  EZ_CHECK_AT_COMPILETIME(sizeof(ezSpatialSystem_LooseOctree::SpatialUserData) <= sizeof(ezSpatialData::m_uiUserData));
+  EZ_ASSERT_DEV(fWorldSize > 0.0f && fMinNodeSize > 0.0f, "Invalid octree dimensions");
+
+  for (float fNodeSize = fWorldSize * 0.5f; fNodeSize >= fMinNodeSize && m_uiMaxDepth < MAX_OCTREE_DEPTH; fNodeSize *= 0.5f)
+  {
+    ++m_uiMaxDepth;
+  }
+
+  ezSimdVec4f rootCenterAndHalfSize = ezSimdVec4f::ZeroVector();
+  rootCenterAndHalfSize.SetW(m_fRootHalfSize);
+
+  AllocateNode(ezInvalidIndex, rootCenterAndHalfSize);
+}
+
+ezSpatialSystem_LooseOctree::~ezSpatialSystem_LooseOctree() = default;
+
+ezResult ezSpatialSystem_LooseOctree::GetNodeBoxForSpatialData(const ezSpatialDataHandle& hData, ezBoundingBox& out_BoundingBox) const
+{
+  ezSpatialData* pData;
+  if (!m_DataTable.TryGetValue(hData.GetInternalID(), pData))
+    return EZ_FAILURE;
+
+  auto pUserData = reinterpret_cast<const SpatialUserData*>(&pData->m_uiUserData[0]);
+  if (pUserData->m_uiNodeIndex == ezInvalidIndex)
+    return EZ_FAILURE;
+
+  const ezSimdBBox box = m_Nodes[pUserData->m_uiNodeIndex].GetLooseBox();
+  out_BoundingBox.SetElements(ezSimdConversion::ToVec3(box.m_Min), ezSimdConversion::ToVec3(box.m_Max));
+  return EZ_SUCCESS;
+}
+
+void ezSpatialSystem_LooseOctree::GetAllNodeBoxes(ezHybridArray<ezBoundingBox, 16>& out_BoundingBoxes, ezSpatialData::Category filterCategory) const
+{
+  for (const Node& node : m_Nodes)
+  {
+    if (node.m_DataPointers.IsEmpty())
+      continue;
+
+    bool bHasCategory = (filterCategory == ezInvalidSpatialDataCategory);
+    for (ezUInt32 i = 0; !bHasCategory && i < node.m_CategoryBitmasks.GetCount(); ++i)
+    {
+      bHasCategory = (node.m_CategoryBitmasks[i] & filterCategory.GetBitmask()) != 0;
+    }
+
+    if (bHasCategory)
+    {
+      const ezSimdBBox box = node.GetLooseBox();
+      out_BoundingBoxes.ExpandAndGetRef().SetElements(ezSimdConversion::ToVec3(box.m_Min), ezSimdConversion::ToVec3(box.m_Max));
+    }
+  }
+}
+
+ezUInt32 ezSpatialSystem_LooseOctree::GetNodeCount() const
+{
+  return m_Nodes.GetCount() - m_FreeNodes.GetCount();
+}
+
+template <typename Functor>
+ezVisitorExecution::Enum ezSpatialSystem_LooseOctree::ForEachNode(ezUInt32 uiStartNode, ezUInt32 uiCategoryBitmask, Functor func) const
+{
+  OctreeNodeStack nodeStack;
+  nodeStack.PushBack(uiStartNode);
+
+  while (!nodeStack.IsEmpty())
+  {
+    const ezUInt32 uiNodeIndex = nodeStack.PeekBack();
+    nodeStack.PopBack();
+
+    const Node& node = m_Nodes[uiNodeIndex];
+    if ((node.m_uiCategoryBitmask & uiCategoryBitmask) == 0)
+      continue;
+
+    const ezVisitorExecution::Enum execution = func(uiNodeIndex, node);
+    if (execution == ezVisitorExecution::Stop)
+      return ezVisitorExecution::Stop;
+
+    if (execution == ezVisitorExecution::Skip)
+      continue;
+
+    for (ezUInt32 uiChildIndex : node.m_Children)
+    {
+      if (uiChildIndex != ezInvalidIndex)
+      {
+        nodeStack.PushBack(uiChildIndex);
+      }
+    }
+  }
+
+  return ezVisitorExecution::Continue;
+}
+
+
+void ezSpatialSystem_LooseOctree::FindObjectsInSphereInternal(const ezBoundingSphere& sphere, ezUInt32 uiCategoryBitmask, QueryCallback callback,
+  QueryStats* pStats) const
+{
+  const ezSimdBSphere simdSphere(ezSimdConversion::ToVec3(sphere.m_vCenter), sphere.m_fRadius);
+
+  ForEachNode(ROOT_NODE_INDEX, uiCategoryBitmask, [&](ezUInt32 uiNodeIndex, const Node& node) {
+    // objects outside of the octree's bounds are stored in the root, so it can't be culled
+    if (uiNodeIndex != ROOT_NODE_INDEX && !node.GetLooseBox().Overlaps(simdSphere))
+      return ezVisitorExecution::Skip;
+
+#if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
+    if (pStats != nullptr)
+    {
+      pStats->m_uiNumNodesVisited++;
+    }
+#endif
+
+    for (ezUInt32 i = 0; i < node.m_BoundingSpheres.GetCount(); ++i)
+    {
+      if ((node.m_CategoryBitmasks[i] & uiCategoryBitmask) == 0)
+        continue;
+
+#if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
+      if (pStats != nullptr)
+      {
+        pStats->m_uiNumObjectsTested++;
+      }
+#endif
+
+      if (!simdSphere.Overlaps(node.m_BoundingSpheres[i]))
+        continue;
+
+      if (callback(node.m_DataPointers[i]->m_pObject) == ezVisitorExecution::Stop)
+        return ezVisitorExecution::Stop;
+
+#if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
+      if (pStats != nullptr)
+      {
+        pStats->m_uiNumObjectsPassed++;
+      }
+#endif
+    }
+
+    return ezVisitorExecution::Continue;
+  });
+}
+
+void ezSpatialSystem_LooseOctree::FindObjectsInBoxInternal(const ezBoundingBox& box, ezUInt32 uiCategoryBitmask, QueryCallback callback, QueryStats* pStats) const
+{
+  const ezSimdBBox simdBox(ezSimdConversion::ToVec3(box.m_vMin), ezSimdConversion::ToVec3(box.m_vMax));
+
+  ForEachNode(ROOT_NODE_INDEX, uiCategoryBitmask, [&](ezUInt32 uiNodeIndex, const Node& node) {
+    if (uiNodeIndex != ROOT_NODE_INDEX && !node.GetLooseBox().Overlaps(simdBox))
+      return ezVisitorExecution::Skip;
+
+#if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
+    if (pStats != nullptr)
+    {
+      pStats->m_uiNumNodesVisited++;
+    }
+#endif
+
+    for (ezUInt32 i = 0; i < node.m_BoundingSpheres.GetCount(); ++i)
+    {
+      if ((node.m_CategoryBitmasks[i] & uiCategoryBitmask) == 0)
+        continue;
+
+#if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
+      if (pStats != nullptr)
+      {
+        pStats->m_uiNumObjectsTested++;
+      }
+#endif
+
+      if (!simdBox.Overlaps(node.m_BoundingSpheres[i]))
+        continue;
+
+      const ezSpatialData* pData = node.m_DataPointers[i];
+      if (!simdBox.Overlaps(pData->m_Bounds.GetBox()))
+        continue;
+
+      if (callback(pData->m_pObject) == ezVisitorExecution::Stop)
+        return ezVisitorExecution::Stop;
+
+#if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
+      if (pStats != nullptr)
+      {
+        pStats->m_uiNumObjectsPassed++;
+      }
+#endif
+    }
+
+    return ezVisitorExecution::Continue;
+  });
+}
+
+void ezSpatialSystem_LooseOctree::FindVisibleObjectsInternal(const ezFrustum& frustum, ezUInt32 uiCategoryBitmask, ezDynamicArray<const ezGameObject*>& out_Objects,
+  QueryStats* pStats) const
+{
+  ezInternal::SpatialSystemPlaneData planeData;
+  planeData.SetFromFrustum(frustum);
+
+  QueryStats localStats;
+
+  ForEachNode(ROOT_NODE_INDEX, uiCategoryBitmask, [&](ezUInt32 uiNodeIndex, const Node& node) {
+    ezInternal::CubeFrustumResult::Enum result = ezInternal::CubeFrustumResult::Intersecting;
+    if (uiNodeIndex != ROOT_NODE_INDEX)
+    {
+      result = ezInternal::CubeFrustumClassify(node.GetLooseCenterAndHalfSize(), planeData);
+    }
+
+    if (result == ezInternal::CubeFrustumResult::Outside)
+      return ezVisitorExecution::Skip;
+
+    if (result == ezInternal::CubeFrustumResult::Inside)
+    {
+      // the whole subtree is visible, only the categories need to be checked
+      ForEachNode(uiNodeIndex, uiCategoryBitmask, [&](ezUInt32, const Node& innerNode) {
+#if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
+        localStats.m_uiNumNodesVisited++;
+#endif
+
+        innerNode.AddAllObjects(uiCategoryBitmask, out_Objects, localStats);
+        return ezVisitorExecution::Continue;
+      });
+
+      return ezVisitorExecution::Skip;
+    }
+
+#if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
+    localStats.m_uiNumNodesVisited++;
+#endif
+
+    node.FindVisibleObjects(uiCategoryBitmask, planeData, out_Objects, localStats);
+    return ezVisitorExecution::Continue;
+  });
+
+#if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
+  if (pStats != nullptr)
+  {
+    pStats->m_uiNumNodesVisited += localStats.m_uiNumNodesVisited;
+    pStats->m_uiNumObjectsTested += localStats.m_uiNumObjectsTested;
+    pStats->m_uiNumObjectsPassed += localStats.m_uiNumObjectsPassed;
+  }
+#endif
+}
+
+void ezSpatialSystem_LooseOctree::FindVisibleObjectsBatchedInternal(ezArrayPtr<const ezFrustum> frustums, ezUInt32 uiCategoryBitmask,
+  ezArrayPtr<ezDynamicArray<const ezGameObject*>*> out_ObjectsPerFrustum, QueryStats* pStats) const
+{
+  const ezUInt32 uiNumFrustums = frustums.GetCount();
+  const ezUInt32 uiAllFrustums = (uiNumFrustums == 32) ? 0xFFFFFFFFu : ((1u << uiNumFrustums) - 1);
+
+  ezHybridArray<ezInternal::SpatialSystemPlaneData, 8> planeData;
+  planeData.SetCount(uiNumFrustums);
+
+  for (ezUInt32 i = 0; i < uiNumFrustums; ++i)
+  {
+    planeData[i].SetFromFrustum(frustums[i]);
+  }
+
+  QueryStats localStats;
+
+  // Every frustum is only tested against a node as long as it partially overlaps the node's parent.
+  // Frustums that contain a node completely contain its whole subtree, too.
+  BatchedTraversalStack stack;
+  stack.PushBack({ROOT_NODE_INDEX, uiAllFrustums, 0});
+
+  while (!stack.IsEmpty())
+  {
+    const BatchedTraversalEntry entry = stack.PeekBack();
+    stack.PopBack();
+
+    const Node& node = m_Nodes[entry.m_uiNodeIndex];
+    if ((node.m_uiCategoryBitmask & uiCategoryBitmask) == 0)
+      continue;
+
+    ezUInt32 uiIntersectingFrustums = entry.m_uiIntersectingFrustums;
+    ezUInt32 uiContainingFrustums = entry.m_uiContainingFrustums;
+
+    // objects outside of the octree's bounds are stored in the root, so it can't be culled
+    if (entry.m_uiNodeIndex != ROOT_NODE_INDEX)
+    {
+      const ezSimdVec4f looseCenterAndHalfSize = node.GetLooseCenterAndHalfSize();
+
+      ezUInt32 uiFrustumsToTest = uiIntersectingFrustums;
+      while (uiFrustumsToTest > 0)
+      {
+        const ezUInt32 f = ezMath::FirstBitLow(uiFrustumsToTest);
+        uiFrustumsToTest &= uiFrustumsToTest - 1;
+
+        const ezInternal::CubeFrustumResult::Enum result = ezInternal::CubeFrustumClassify(looseCenterAndHalfSize, planeData[f]);
+        if (result == ezInternal::CubeFrustumResult::Outside)
+        {
+          uiIntersectingFrustums &= ~(1u << f);
+        }
+        else if (result == ezInternal::CubeFrustumResult::Inside)
+        {
+          uiIntersectingFrustums &= ~(1u << f);
+          uiContainingFrustums |= (1u << f);
+        }
+      }
+    }
+
+    if ((uiIntersectingFrustums | uiContainingFrustums) == 0)
+      continue;
+
+#if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
+    localStats.m_uiNumNodesVisited++;
+#endif
+
+    // process all frustums while the node's data is hot in the cache
+    for (ezUInt32 uiMask = uiContainingFrustums; uiMask > 0; uiMask &= uiMask - 1)
+    {
+      const ezUInt32 f = ezMath::FirstBitLow(uiMask);
+      node.AddAllObjects(uiCategoryBitmask, *out_ObjectsPerFrustum[f], localStats);
+    }
+
+    for (ezUInt32 uiMask = uiIntersectingFrustums; uiMask > 0; uiMask &= uiMask - 1)
+    {
+      const ezUInt32 f = ezMath::FirstBitLow(uiMask);
+      node.FindVisibleObjects(uiCategoryBitmask, planeData[f], *out_ObjectsPerFrustum[f], localStats);
+    }
+
+    for (ezUInt32 uiChildIndex : node.m_Children)
+    {
+      if (uiChildIndex != ezInvalidIndex)
+      {
+        stack.PushBack({uiChildIndex, uiIntersectingFrustums, uiContainingFrustums});
+      }
+    }
+  }
+
+#if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
+  if (pStats != nullptr)
+  {
+    pStats->m_uiNumNodesVisited += localStats.m_uiNumNodesVisited;
+    pStats->m_uiNumObjectsTested += localStats.m_uiNumObjectsTested;
+    pStats->m_uiNumObjectsPassed += localStats.m_uiNumObjectsPassed;
+  }
+#endif
+}
+
+void ezSpatialSystem_LooseOctree::SpatialDataAdded(ezSpatialData* pData)
+{
+  const ezUInt32 uiNodeIndex = FindNodeForBounds(pData->m_Bounds, true);
+  AddDataToNode(uiNodeIndex, pData);
+}
+
+void ezSpatialSystem_LooseOctree::SpatialDataRemoved(ezSpatialData* pData)
+{
+  RemoveDataFromNode(pData);
+}
+
+void ezSpatialSystem_LooseOctree::SpatialDataChanged(ezSpatialData* pData, const ezSimdBBoxSphere& oldBounds, ezUInt32 uiOldCategoryBitmask)
+{
+  auto pUserData = reinterpret_cast<SpatialUserData*>(&pData->m_uiUserData[0]);
+
+  if (pData->m_uiCategoryBitmask == 0)
+  {
+    RemoveDataFromNode(pData);
+    return;
+  }
+
+  if (pUserData->m_uiNodeIndex != ezInvalidIndex)
+  {
+    // don't create any nodes yet, removing the data from its old node may delete nodes on the path to the new one
+    const ezUInt32 uiNewNodeIndex = FindNodeForBounds(pData->m_Bounds, false);
+
+    if (uiNewNodeIndex == pUserData->m_uiNodeIndex)
+    {
+      Node& node = m_Nodes[uiNewNodeIndex];
+      node.m_BoundingSpheres[pUserData->m_uiDataIndex] = pData->m_Bounds.GetSphere();
+      node.m_CategoryBitmasks[pUserData->m_uiDataIndex] = pData->m_uiCategoryBitmask;
+
+      if (pData->m_uiCategoryBitmask != uiOldCategoryBitmask)
+      {
+        UpdateCategoryBitmasks(uiNewNodeIndex);
+      }
+
+      return;
+    }
+
+    RemoveDataFromNode(pData);
+  }
+
+  SpatialDataAdded(pData);
+}
+
+void ezSpatialSystem_LooseOctree::FixSpatialDataPointer(ezSpatialData* pOldPtr, ezSpatialData* pNewPtr)
+{
+  // always visible data is never added to the tree and its user data is not initialized
+  if (pNewPtr->m_Flags.IsSet(ezSpatialData::Flags::AlwaysVisible))
+    return;
+
+  auto pUserData = reinterpret_cast<SpatialUserData*>(&pNewPtr->m_uiUserData[0]);
+  if (pUserData->m_uiNodeIndex != ezInvalidIndex)
+  {
+    m_Nodes[pUserData->m_uiNodeIndex].m_DataPointers[pUserData->m_uiDataIndex] = pNewPtr;
+  }
+}
+
+ezUInt32 ezSpatialSystem_LooseOctree::FindNodeForBounds(const ezSimdBBoxSphere& bounds, bool bCreateNodes)
+{
+  const ezSimdVec4f center = bounds.m_CenterAndRadius;
+
+  // queries test the bounding sphere first, so it has to fit into the node's loose bounds just as the box
+  const ezSimdFloat fMaxHalfExtent = bounds.m_BoxHalfExtents.HorizontalMax<3>().Max(bounds.m_CenterAndRadius.w());
+
+  // objects that are too large or outside of the octree are stored in the root node
+  if (fMaxHalfExtent > m_fRootHalfSize || !(center.Abs() <= ezSimdVec4f(m_fRootHalfSize)).AllSet<3>())
+    return ROOT_NODE_INDEX;
+
+  ezUInt32 uiNodeIndex = ROOT_NODE_INDEX;
+
+  while (true)
+  {
+    const Node& node = m_Nodes[uiNodeIndex];
+    const ezSimdFloat fChildHalfSize = node.m_CenterAndHalfSize.w() * ezSimdFloat(0.5f);
+
+    // since the loose bounds of a node are twice its cell size, an object fits into the child if its half extents are not larger than
+    // the child's half cell size
+    if (node.m_uiDepth >= m_uiMaxDepth || fMaxHalfExtent > fChildHalfSize)
+      return uiNodeIndex;
+
+    const ezSimdVec4b positive = center >= node.m_CenterAndHalfSize;
+    const ezUInt32 uiChild = (positive.x() ? 1 : 0) | (positive.y() ? 2 : 0) | (positive.z() ? 4 : 0);
+
+    ezUInt32 uiChildIndex = node.m_Children[uiChild];
+    if (uiChildIndex == ezInvalidIndex)
+    {
+      if (!bCreateNodes)
+        return ezInvalidIndex;
+
+      const ezSimdVec4f childHalfSize(fChildHalfSize);
+      ezSimdVec4f childCenterAndHalfSize = node.m_CenterAndHalfSize + ezSimdVec4f::Select(positive, childHalfSize, -childHalfSize);
+      childCenterAndHalfSize.SetW(fChildHalfSize);
+
+      // this invalidates the node reference
+      uiChildIndex = AllocateNode(uiNodeIndex, childCenterAndHalfSize);
+      m_Nodes[uiNodeIndex].m_Children[uiChild] = uiChildIndex;
+    }
+
+    uiNodeIndex = uiChildIndex;
+  }
+}
+
+ezUInt32 ezSpatialSystem_LooseOctree::AllocateNode(ezUInt32 uiParent, const ezSimdVec4f& centerAndHalfSize)
+{
+  ezUInt32 uiNodeIndex;
+  if (!m_FreeNodes.IsEmpty())
+  {
+    uiNodeIndex = m_FreeNodes.PeekBack();
+    m_FreeNodes.PopBack();
+  }
+  else
+  {
+    uiNodeIndex = m_Nodes.GetCount();
+    m_Nodes.PushBack(Node(&m_Allocator, &m_AlignedAllocator));
+  }
+
+  Node& node = m_Nodes[uiNodeIndex];
+  node.m_CenterAndHalfSize = centerAndHalfSize;
+  node.m_uiParent = uiParent;
+  node.m_uiDepth = (uiParent != ezInvalidIndex) ? m_Nodes[uiParent].m_uiDepth + 1 : 0;
+
+  return uiNodeIndex;
+}
+
+void ezSpatialSystem_LooseOctree::AddDataToNode(ezUInt32 uiNodeIndex, ezSpatialData* pData)
+{
+  Node& node = m_Nodes[uiNodeIndex];
+
+  auto pUserData = reinterpret_cast<SpatialUserData*>(&pData->m_uiUserData[0]);
+  pUserData->m_uiNodeIndex = uiNodeIndex;
+  pUserData->m_uiDataIndex = node.m_DataPointers.GetCount();
+
+  node.m_BoundingSpheres.PushBack(pData->m_Bounds.GetSphere());
+  node.m_DataPointers.PushBack(pData);
+  node.m_CategoryBitmasks.PushBack(pData->m_uiCategoryBitmask);
+
+  for (; uiNodeIndex != ezInvalidIndex; uiNodeIndex = m_Nodes[uiNodeIndex].m_uiParent)
+  {
+    Node& parent = m_Nodes[uiNodeIndex];
+    parent.m_uiNumObjectsInSubtree++;
+    parent.m_uiCategoryBitmask |= pData->m_uiCategoryBitmask;
+  }
+}
+
+void ezSpatialSystem_LooseOctree::RemoveDataFromNode(ezSpatialData* pData)
+{
+  auto pUserData = reinterpret_cast<SpatialUserData*>(&pData->m_uiUserData[0]);
+  if (pUserData->m_uiNodeIndex == ezInvalidIndex)
+    return;
+
+  const ezUInt32 uiNodeIndex = pUserData->m_uiNodeIndex;
+  const ezUInt32 uiDataIndex = pUserData->m_uiDataIndex;
+
+  {
+    Node& node = m_Nodes[uiNodeIndex];
+    EZ_ASSERT_DEBUG(node.m_DataPointers[uiDataIndex] == pData, "Implementation error");
+
+    if (uiDataIndex != node.m_DataPointers.GetCount() - 1)
+    {
+      auto pMovedUserData = reinterpret_cast<SpatialUserData*>(&node.m_DataPointers.PeekBack()->m_uiUserData[0]);
+      pMovedUserData->m_uiDataIndex = uiDataIndex;
+    }
+
+    node.m_BoundingSpheres.RemoveAtAndSwap(uiDataIndex);
+    node.m_DataPointers.RemoveAtAndSwap(uiDataIndex);
+    node.m_CategoryBitmasks.RemoveAtAndSwap(uiDataIndex);
+  }
+
+  pUserData->m_uiNodeIndex = ezInvalidIndex;
+  pUserData->m_uiDataIndex = ezInvalidIndex;
+
+  for (ezUInt32 i = uiNodeIndex; i != ezInvalidIndex; i = m_Nodes[i].m_uiParent)
+  {
+    m_Nodes[i].m_uiNumObjectsInSubtree--;
+  }
+
+  // Delete nodes that became empty. Their children have already been deleted before, since they can't contain any objects either.
+  ezUInt32 i = uiNodeIndex;
+  while (i != ROOT_NODE_INDEX && m_Nodes[i].m_uiNumObjectsInSubtree == 0)
+  {
+    Node& node = m_Nodes[i];
+    Node& parent = m_Nodes[node.m_uiParent];
+
+    for (ezUInt32 c = 0; c < 8; ++c)
+    {
+      if (parent.m_Children[c] == i)
+      {
+        parent.m_Children[c] = ezInvalidIndex;
+        break;
+      }
+    }
+
+    const ezUInt32 uiParent = node.m_uiParent;
+
+    node.m_uiParent = ezInvalidIndex;
+    node.m_uiCategoryBitmask = 0;
+    node.ResetChildren();
+    m_FreeNodes.PushBack(i);
+
+    i = uiParent;
+  }
+
+  UpdateCategoryBitmasks(i);
+}
+
+void ezSpatialSystem_LooseOctree::UpdateCategoryBitmasks(ezUInt32 uiNodeIndex)
+{
+  for (ezUInt32 i = uiNodeIndex; i != ezInvalidIndex; i = m_Nodes[i].m_uiParent)
+  {
+    Node& node = m_Nodes[i];
+
+    ezUInt32 uiCategoryBitmask = 0;
+    for (ezUInt32 uiDataCategoryBitmask : node.m_CategoryBitmasks)
+    {
+      uiCategoryBitmask |= uiDataCategoryBitmask;
+    }
+
+    for (ezUInt32 c = 0; c < 8; ++c)
+    {
+      if (node.m_Children[c] != ezInvalidIndex)
+      {
+        uiCategoryBitmask |= m_Nodes[node.m_Children[c]].m_uiCategoryBitmask;
+      }
+    }
+
+    // the parents only depend on the bitmask of this node, so they can't change either
+    if (node.m_uiCategoryBitmask == uiCategoryBitmask)
+      break;
+
+    node.m_uiCategoryBitmask = uiCategoryBitmask;
+  }
+}
+
+
+EZ_STATICLINK_FILE(Core, Core_World_Implementation_SpatialSystem_LooseOctree);
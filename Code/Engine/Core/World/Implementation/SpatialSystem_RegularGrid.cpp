@@ -1,5 +1,6 @@
 #include <CorePCH.h>
 
+#include <Core/World/Implementation/SpatialSystemHelper.h>
 #include <Core/World/SpatialSystem_RegularGrid.h>
 #include <Foundation/Containers/HashSet.h>
 #include <Foundation/SimdMath/SimdConversion.h>
@@ -39,86 +40,6 @@ namespace
 
     return ezSimdBBox(bmin, bmax);
   }
-
-  struct PlaneData
-  {
-    ezSimdVec4f m_x0x1x2x3;
-    ezSimdVec4f m_y0y1y2y3;
-    ezSimdVec4f m_z0z1z2z3;
-    ezSimdVec4f m_w0w1w2w3;
-
-    ezSimdVec4f m_x4x5x4x5;
-    ezSimdVec4f m_y4y5y4y5;
-    ezSimdVec4f m_z4z5z4z5;
-    ezSimdVec4f m_w4w5w4w5;
-  };
-
-  EZ_FORCE_INLINE bool SphereFrustumIntersect(const ezSimdBSphere& sphere, const PlaneData& planeData)
-  {
-    ezSimdVec4f pos_xxxx(sphere.m_CenterAndRadius.x());
-    ezSimdVec4f pos_yyyy(sphere.m_CenterAndRadius.y());
-    ezSimdVec4f pos_zzzz(sphere.m_CenterAndRadius.z());
-    ezSimdVec4f pos_rrrr(sphere.m_CenterAndRadius.w());
-
-    ezSimdVec4f dot_0123;
-    dot_0123 = ezSimdVec4f::MulAdd(pos_xxxx, planeData.m_x0x1x2x3, planeData.m_w0w1w2w3);
-    dot_0123 = ezSimdVec4f::MulAdd(pos_yyyy, planeData.m_y0y1y2y3, dot_0123);
-    dot_0123 = ezSimdVec4f::MulAdd(pos_zzzz, planeData.m_z0z1z2z3, dot_0123);
-
-    ezSimdVec4f dot_4545;
-    dot_4545 = ezSimdVec4f::MulAdd(pos_xxxx, planeData.m_x4x5x4x5, planeData.m_w4w5w4w5);
-    dot_4545 = ezSimdVec4f::MulAdd(pos_yyyy, planeData.m_y4y5y4y5, dot_4545);
-    dot_4545 = ezSimdVec4f::MulAdd(pos_zzzz, planeData.m_z4z5z4z5, dot_4545);
-
-    ezSimdVec4b cmp_0123 = dot_0123 > pos_rrrr;
-    ezSimdVec4b cmp_4545 = dot_4545 > pos_rrrr;
-    return (cmp_0123 || cmp_4545).NoneSet<4>();
-  }
-
-  EZ_FORCE_INLINE ezUInt32 SphereFrustumIntersect(const ezSimdBSphere& sphereA, const ezSimdBSphere& sphereB, const PlaneData& planeData)
-  {
-    ezSimdVec4f posA_xxxx(sphereA.m_CenterAndRadius.x());
-    ezSimdVec4f posA_yyyy(sphereA.m_CenterAndRadius.y());
-    ezSimdVec4f posA_zzzz(sphereA.m_CenterAndRadius.z());
-    ezSimdVec4f posA_rrrr(sphereA.m_CenterAndRadius.w());
-
-    ezSimdVec4f dotA_0123;
-    dotA_0123 = ezSimdVec4f::MulAdd(posA_xxxx, planeData.m_x0x1x2x3, planeData.m_w0w1w2w3);
-    dotA_0123 = ezSimdVec4f::MulAdd(posA_yyyy, planeData.m_y0y1y2y3, dotA_0123);
-    dotA_0123 = ezSimdVec4f::MulAdd(posA_zzzz, planeData.m_z0z1z2z3, dotA_0123);
-
-    ezSimdVec4f posB_xxxx(sphereB.m_CenterAndRadius.x());
-    ezSimdVec4f posB_yyyy(sphereB.m_CenterAndRadius.y());
-    ezSimdVec4f posB_zzzz(sphereB.m_CenterAndRadius.z());
-    ezSimdVec4f posB_rrrr(sphereB.m_CenterAndRadius.w());
-
-    ezSimdVec4f dotB_0123;
-    dotB_0123 = ezSimdVec4f::MulAdd(posB_xxxx, planeData.m_x0x1x2x3, planeData.m_w0w1w2w3);
-    dotB_0123 = ezSimdVec4f::MulAdd(posB_yyyy, planeData.m_y0y1y2y3, dotB_0123);
-    dotB_0123 = ezSimdVec4f::MulAdd(posB_zzzz, planeData.m_z0z1z2z3, dotB_0123);
-
-    ezSimdVec4f posAB_xxxx = posA_xxxx.GetCombined<ezSwizzle::XXXX>(posB_xxxx);
-    ezSimdVec4f posAB_yyyy = posA_yyyy.GetCombined<ezSwizzle::XXXX>(posB_yyyy);
-    ezSimdVec4f posAB_zzzz = posA_zzzz.GetCombined<ezSwizzle::XXXX>(posB_zzzz);
-    ezSimdVec4f posAB_rrrr = posA_rrrr.GetCombined<ezSwizzle::XXXX>(posB_rrrr);
-
-    ezSimdVec4f dot_A45B45;
-    dot_A45B45 = ezSimdVec4f::MulAdd(posAB_xxxx, planeData.m_x4x5x4x5, planeData.m_w4w5w4w5);
-    dot_A45B45 = ezSimdVec4f::MulAdd(posAB_yyyy, planeData.m_y4y5y4y5, dot_A45B45);
-    dot_A45B45 = ezSimdVec4f::MulAdd(posAB_zzzz, planeData.m_z4z5z4z5, dot_A45B45);
-
-    ezSimdVec4b cmp_A0123 = dotA_0123 > posA_rrrr;
-    ezSimdVec4b cmp_B0123 = dotB_0123 > posB_rrrr;
-    ezSimdVec4b cmp_A45B45 = dot_A45B45 > posAB_rrrr;
-
-    ezSimdVec4b cmp_A45 = cmp_A45B45.Get<ezSwizzle::XYXY>();
-    ezSimdVec4b cmp_B45 = cmp_A45B45.Get<ezSwizzle::ZWZW>();
-
-    ezUInt32 result = (cmp_A0123 || cmp_A45).NoneSet<4>() ? 1 : 0;
-    result |= (cmp_B0123 || cmp_B45).NoneSet<4>() ? 2 : 0;
-
-    return result;
-  }
 } // namespace
 
 //////////////////////////////////////////////////////////////////////////
@@ -267,6 +188,73 @@ struct ezSpatialSystem_RegularGrid::Cell
     }
   }
 
+  EZ_FORCE_INLINE void FindVisibleObjects(ezUInt32 uiFilteredCategoryBitmask, const ezInternal::SpatialSystemPlaneData& planeData,
+    ezDynamicArray<const ezGameObject*>& out_Objects, ezSpatialSystem::QueryStats& localStats) const
+  {
+    while (uiFilteredCategoryBitmask > 0)
+    {
+      ezUInt32 category = ezMath::FirstBitLow(uiFilteredCategoryBitmask);
+      uiFilteredCategoryBitmask &= uiFilteredCategoryBitmask - 1;
+
+      auto& boundingSpheres = m_BoundingSpheres[category];
+      auto& dataPointers = m_DataPointers[category];
+
+      const ezUInt32 numSpheres = boundingSpheres.GetCount();
+
+#if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
+      localStats.m_uiNumObjectsTested += numSpheres;
+#endif
+      ezUInt32 currentIndex = 0;
+
+      while (currentIndex < numSpheres)
+      {
+        if (numSpheres - currentIndex >= 32)
+        {
+          ezUInt32 mask = 0;
+
+          for (ezUInt32 i = 0; i < 32; i += 2)
+          {
+            auto& objectSphereA = boundingSpheres[currentIndex + i + 0];
+            auto& objectSphereB = boundingSpheres[currentIndex + i + 1];
+
+            mask |= ezInternal::SphereFrustumIntersect(objectSphereA, objectSphereB, planeData) << i;
+          }
+
+          while (mask > 0)
+          {
+            ezUInt32 i = ezMath::FirstBitLow(mask);
+            mask &= mask - 1;
+
+            ezSpatialData* pData = dataPointers[currentIndex + i];
+            out_Objects.PushBack(pData->m_pObject);
+
+#if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
+            localStats.m_uiNumObjectsPassed++;
+#endif
+          }
+
+          currentIndex += 32;
+        }
+        else
+        {
+          ezUInt32 i = currentIndex;
+          ++currentIndex;
+
+          auto& objectSphere = boundingSpheres[i];
+          if (!ezInternal::SphereFrustumIntersect(objectSphere, planeData))
+            continue;
+
+          ezSpatialData* pData = dataPointers[i];
+          out_Objects.PushBack(pData->m_pObject);
+
+#if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
+          localStats.m_uiNumObjectsPassed++;
+#endif
+        }
+      }
+    }
+  }
+
   EZ_ALWAYS_INLINE ezBoundingBox GetBoundingBox() const
   {
     return ezSimdConversion::ToBBoxSphere(m_Bounds).GetBox();
@@ -356,6 +344,13 @@ void ezSpatialSystem_RegularGrid::FindObjectsInSphereInternal(const ezBoundingSp
   simdBox.SetCenterAndHalfExtents(simdSphere.m_CenterAndRadius, simdSphere.m_CenterAndRadius.Get<ezSwizzle::WWWW>());
 
   ForEachCellInBox(simdBox, uiCategoryBitmask, [&](const ezSimdVec4i& cellIndex, ezUInt64 cellKey, const Cell& cell, ezUInt32 uiFilteredCategoryBitmask) {
+#if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
+    if (pStats != nullptr)
+    {
+      pStats->m_uiNumNodesVisited++;
+    }
+#endif
+
     ezSimdBBox cellBox = cell.m_Bounds.GetBox();
     if (!cellBox.Overlaps(simdSphere))
       return;
@@ -406,6 +401,13 @@ void ezSpatialSystem_RegularGrid::FindObjectsInBoxInternal(const ezBoundingBox&
   ezSimdBBox simdBox(ezSimdConversion::ToVec3(box.m_vMin), ezSimdConversion::ToVec3(box.m_vMax));
 
   ForEachCellInBox(simdBox, uiCategoryBitmask, [&](const ezSimdVec4i& cellIndex, ezUInt64 cellKey, const Cell& cell, ezUInt32 uiFilteredCategoryBitmask) {
+#if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
+    if (pStats != nullptr)
+    {
+      pStats->m_uiNumNodesVisited++;
+    }
+#endif
+
     ezUInt32 mask = uiFilteredCategoryBitmask;
     while (mask > 0)
     {
@@ -464,112 +466,119 @@ void ezSpatialSystem_RegularGrid::FindVisibleObjectsInternal(const ezFrustum& fr
   ezSimdBBox simdBox;
   simdBox.SetFromPoints(simdCornerPoints, 8);
 
-  PlaneData planeData;
-  {
-    // Compiler is too stupid to properly unroll a constant loop so we do it by hand
-    ezSimdVec4f plane0 = ezSimdConversion::ToVec4(*reinterpret_cast<const ezVec4*>(&(frustum.GetPlane(0).m_vNormal.x)));
-    ezSimdVec4f plane1 = ezSimdConversion::ToVec4(*reinterpret_cast<const ezVec4*>(&(frustum.GetPlane(1).m_vNormal.x)));
-    ezSimdVec4f plane2 = ezSimdConversion::ToVec4(*reinterpret_cast<const ezVec4*>(&(frustum.GetPlane(2).m_vNormal.x)));
-    ezSimdVec4f plane3 = ezSimdConversion::ToVec4(*reinterpret_cast<const ezVec4*>(&(frustum.GetPlane(3).m_vNormal.x)));
-    ezSimdVec4f plane4 = ezSimdConversion::ToVec4(*reinterpret_cast<const ezVec4*>(&(frustum.GetPlane(4).m_vNormal.x)));
-    ezSimdVec4f plane5 = ezSimdConversion::ToVec4(*reinterpret_cast<const ezVec4*>(&(frustum.GetPlane(5).m_vNormal.x)));
-
-    ezSimdMat4f helperMat;
-    helperMat.SetRows(plane0, plane1, plane2, plane3);
-
-    planeData.m_x0x1x2x3 = helperMat.m_col0;
-    planeData.m_y0y1y2y3 = helperMat.m_col1;
-    planeData.m_z0z1z2z3 = helperMat.m_col2;
-    planeData.m_w0w1w2w3 = helperMat.m_col3;
-
-    helperMat.SetRows(plane4, plane5, plane4, plane5);
-
-    planeData.m_x4x5x4x5 = helperMat.m_col0;
-    planeData.m_y4y5y4y5 = helperMat.m_col1;
-    planeData.m_z4z5z4z5 = helperMat.m_col2;
-    planeData.m_w4w5w4w5 = helperMat.m_col3;
-  }
+  ezInternal::SpatialSystemPlaneData planeData;
+  planeData.SetFromFrustum(frustum);
 
+  QueryStats localStats;
+
+  ForEachCellInBox(simdBox, uiCategoryBitmask, [&](const ezSimdVec4i& cellIndex, ezUInt64 cellKey, const Cell& cell, ezUInt32 uiFilteredCategoryBitmask) {
 #if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
-  ezUInt32 uiNumObjectsTested = 0;
-  ezUInt32 uiNumObjectsPassed = 0;
+    localStats.m_uiNumNodesVisited++;
 #endif
 
-  ForEachCellInBox(simdBox, uiCategoryBitmask, [&](const ezSimdVec4i& cellIndex, ezUInt64 cellKey, const Cell& cell, ezUInt32 uiFilteredCategoryBitmask) {
     ezSimdBSphere cellSphere = cell.m_Bounds.GetSphere();
-    if (!SphereFrustumIntersect(cellSphere, planeData))
+    if (!ezInternal::SphereFrustumIntersect(cellSphere, planeData))
       return;
 
-    ezUInt32 filteredMask = uiFilteredCategoryBitmask;
-    while (filteredMask > 0)
-    {
-      ezUInt32 category = ezMath::FirstBitLow(filteredMask);
-      filteredMask &= filteredMask - 1;
-
-      auto& boundingSpheres = cell.m_BoundingSpheres[category];
-      auto& dataPointers = cell.m_DataPointers[category];
-
-      const ezUInt32 numSpheres = boundingSpheres.GetCount();
+    cell.FindVisibleObjects(uiFilteredCategoryBitmask, planeData, out_Objects, localStats);
+  });
 
 #if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
-      uiNumObjectsTested += numSpheres;
+  if (pStats != nullptr)
+  {
+    pStats->m_uiNumNodesVisited += localStats.m_uiNumNodesVisited;
+    pStats->m_uiNumObjectsTested += localStats.m_uiNumObjectsTested;
+    pStats->m_uiNumObjectsPassed += localStats.m_uiNumObjectsPassed;
+  }
 #endif
-      ezUInt32 currentIndex = 0;
+}
 
-      while (currentIndex < numSpheres)
-      {
-        if (numSpheres - currentIndex >= 32)
-        {
-          ezUInt32 mask = 0;
+void ezSpatialSystem_RegularGrid::FindVisibleObjectsBatchedInternal(ezArrayPtr<const ezFrustum> frustums, ezUInt32 uiCategoryBitmask,
+  ezArrayPtr<ezDynamicArray<const ezGameObject*>*> out_ObjectsPerFrustum, QueryStats* pStats) const
+{
+  const ezUInt32 uiNumFrustums = frustums.GetCount();
 
-          for (ezUInt32 i = 0; i < 32; i += 2)
-          {
-            auto& objectSphereA = boundingSpheres[currentIndex + i + 0];
-            auto& objectSphereB = boundingSpheres[currentIndex + i + 1];
+  ezHybridArray<ezInternal::SpatialSystemPlaneData, 8> planeData;
+  ezHybridArray<ezSimdBBox, 8> frustumBoxes;
+  planeData.SetCount(uiNumFrustums);
+  frustumBoxes.SetCount(uiNumFrustums);
 
-            mask |= SphereFrustumIntersect(objectSphereA, objectSphereB, planeData) << i;
-          }
+  ezSimdBBox unionBox;
+  unionBox.SetInvalid();
 
-          while (mask > 0)
-          {
-            ezUInt32 i = ezMath::FirstBitLow(mask);
-            mask &= mask - 1;
+  for (ezUInt32 i = 0; i < uiNumFrustums; ++i)
+  {
+    ezVec3 cornerPoints[8];
+    frustums[i].ComputeCornerPoints(cornerPoints);
 
-            ezSpatialData* pData = dataPointers[currentIndex + i];
-            out_Objects.PushBack(pData->m_pObject);
+    ezSimdVec4f simdCornerPoints[8];
+    for (ezUInt32 j = 0; j < 8; ++j)
+    {
+      simdCornerPoints[j] = ezSimdConversion::ToVec3(cornerPoints[j]);
+    }
+
+    frustumBoxes[i].SetFromPoints(simdCornerPoints, 8);
+    unionBox.ExpandToInclude(frustumBoxes[i]);
+
+    planeData[i].SetFromFrustum(frustums[i]);
+  }
 
+  QueryStats localStats;
+
+  auto processCell = [&](const Cell& cell, ezUInt32 uiFilteredCategoryBitmask) {
 #if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
-            uiNumObjectsPassed++;
+    localStats.m_uiNumNodesVisited++;
 #endif
-          }
 
-          currentIndex += 32;
-        }
-        else
-        {
-          ezUInt32 i = currentIndex;
-          ++currentIndex;
+    const ezSimdBBox cellBox = cell.m_Bounds.GetBox();
+    const ezSimdBSphere cellSphere = cell.m_Bounds.GetSphere();
 
-          auto& objectSphere = boundingSpheres[i];
-          if (!SphereFrustumIntersect(objectSphere, planeData))
-            continue;
+    // test the cell against all frustums first, while its data is hot in the cache the objects are tested for every visible frustum
+    for (ezUInt32 i = 0; i < uiNumFrustums; ++i)
+    {
+      if (cellBox.Overlaps(frustumBoxes[i]) && ezInternal::SphereFrustumIntersect(cellSphere, planeData[i]))
+      {
+        cell.FindVisibleObjects(uiFilteredCategoryBitmask, planeData[i], *out_ObjectsPerFrustum[i], localStats);
+      }
+    }
+  };
 
-          ezSpatialData* pData = dataPointers[i];
-          out_Objects.PushBack(pData->m_pObject);
+  // Frustums of different lights can be far apart, so their union box may cover a huge number of empty cells.
+  // In that case it is cheaper to iterate over all existing cells directly.
+  const ezSimdVec4f numCellsPerAxis = (unionBox.GetExtents() + m_fOverlapSize * 2.0f) * m_fInvCellSize + ezSimdVec4f(1.0f);
+  const float fNumCellsInBox = numCellsPerAxis.x() * numCellsPerAxis.y() * numCellsPerAxis.z();
 
-#if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
-          uiNumObjectsPassed++;
-#endif
-        }
+  if (fNumCellsInBox <= (float)m_Cells.GetCount())
+  {
+    ForEachCellInBox(unionBox, uiCategoryBitmask, [&](const ezSimdVec4i& cellIndex, ezUInt64 cellKey, const Cell& cell, ezUInt32 uiFilteredCategoryBitmask) {
+      processCell(cell, uiFilteredCategoryBitmask);
+    });
+  }
+  else
+  {
+    for (auto it = m_Cells.GetIterator(); it.IsValid(); ++it)
+    {
+      const Cell& cell = *it.Value();
+      const ezUInt32 uiFilteredCategoryBitmask = cell.m_uiCategoryBitmask & uiCategoryBitmask;
+      if (uiFilteredCategoryBitmask != 0 && cell.m_Bounds.GetBox().Overlaps(unionBox))
+      {
+        processCell(cell, uiFilteredCategoryBitmask);
       }
     }
-  });
+
+    const ezUInt32 uiFilteredCategoryBitmask = m_pOverflowCell->m_uiCategoryBitmask & uiCategoryBitmask;
+    if (uiFilteredCategoryBitmask != 0)
+    {
+      processCell(*m_pOverflowCell, uiFilteredCategoryBitmask);
+    }
+  }
 
 #if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
   if (pStats != nullptr)
   {
-    pStats->m_uiNumObjectsTested = uiNumObjectsTested;
-    pStats->m_uiNumObjectsPassed = uiNumObjectsPassed;
+    pStats->m_uiNumNodesVisited += localStats.m_uiNumNodesVisited;
+    pStats->m_uiNumObjectsTested += localStats.m_uiNumObjectsTested;
+    pStats->m_uiNumObjectsPassed += localStats.m_uiNumObjectsPassed;
   }
 #endif
 }
@@ -877,7 +877,7 @@ void ezWorld::RegisterUpdateFunction(const ezComponentManagerBase::UpdateFunctio
 {
   CheckForWriteAccess();
 
-  EZ_ASSERT_DEV(desc.m_Phase == ezComponentManagerBase::UpdateFunctionDesc::Phase::Async || desc.m_uiGranularity == 0, "Granularity must be 0 for synchronous update functions");
+  EZ_ASSERT_DEV(desc.m_Phase == ezComponentManagerBase::UpdateFunctionDesc::Phase::Async || (desc.m_uiGranularity == 0 && !desc.m_bAutoGranularity), "Granularity must be 0 for synchronous update functions");
   EZ_ASSERT_DEV(desc.m_Phase != ezComponentManagerBase::UpdateFunctionDesc::Phase::Async || desc.m_DependsOn.GetCount() == 0, "Asynchronous update functions must not have dependencies");
   EZ_ASSERT_DEV(desc.m_Function.IsComparable(), "Delegates with captures are not allowed as ezWorld update functions.");
 
@@ -955,6 +955,8 @@ void ezWorld::UpdateAsynchronous()
   ezDynamicArrayBase<ezInternal::WorldData::RegisteredUpdateFunction>& updateFunctions =
     m_Data.m_UpdateFunctions[ezComponentManagerBase::UpdateFunctionDesc::Phase::Async];
 
+  const ezUInt32 uiNumWorkers = ezMath::Max(1u, ezTaskSystem::GetWorkerThreadCount(ezWorkerThreadType::ShortTasks));
+
   ezUInt32 uiCurrentTaskIndex = 0;
 
   for (auto& updateFunction : updateFunctions)
@@ -966,7 +968,10 @@ void ezWorld::UpdateAsynchronous()
 
     const ezUInt32 uiTotalCount = pManager->GetComponentCount();
     ezUInt32 uiStartIndex = 0;
-    ezUInt32 uiGranularity = (updateFunction.m_uiGranularity != 0) ? updateFunction.m_uiGranularity : uiTotalCount;
+    ezUInt32 uiGranularity = updateFunction.ComputeGranularity(uiTotalCount, uiNumWorkers);
+
+    updateFunction.m_uiLastComponentCount = uiTotalCount;
+    updateFunction.m_uiLastGranularity = uiGranularity;
 
     while (uiStartIndex < uiTotalCount)
     {
@@ -983,6 +988,7 @@ void ezWorld::UpdateAsynchronous()
 
       pTask->ConfigureTask(updateFunction.m_sFunctionName, ezTaskNesting::Maybe);
       pTask->m_Function = updateFunction.m_Function;
+      pTask->m_pUpdateFunction = &updateFunction;
       pTask->m_uiStartIndex = uiStartIndex;
       pTask->m_uiCount = (uiStartIndex + uiGranularity < uiTotalCount) ? uiGranularity : ezInvalidIndex;
       ezTaskSystem::AddTaskToGroup(taskGroupId, pTask);
@@ -994,6 +1000,35 @@ void ezWorld::UpdateAsynchronous()
 
   ezTaskSystem::StartTaskGroup(taskGroupId);
   ezTaskSystem::WaitForGroup(taskGroupId);
+
+  // the statistics are only meant for tuning the automatic granularity, formatting them every frame would be too expensive
+  const ezTime now = ezTime::Now();
+  const bool bPublishStats = now - m_Data.m_LastAsyncUpdateStatsTime >= ezTime::Milliseconds(500);
+  if (bPublishStats)
+  {
+    m_Data.m_LastAsyncUpdateStatsTime = now;
+  }
+
+  ezStringBuilder sStatName;
+  ezStringBuilder sStatValue;
+
+  for (auto& updateFunction : updateFunctions)
+  {
+    if (updateFunction.m_bOnlyUpdateWhenSimulating && !m_Data.m_bSimulateWorld)
+      continue;
+
+    updateFunction.UpdateMeasurements();
+
+    if (!bPublishStats || !updateFunction.m_bAutoGranularity)
+      continue;
+
+    const ezUInt32 uiComponentCount = updateFunction.m_uiLastComponentCount;
+    const ezUInt32 uiNumBatches = (uiComponentCount > 0) ? (uiComponentCount + updateFunction.m_uiLastGranularity - 1) / updateFunction.m_uiLastGranularity : 0;
+
+    sStatName.Format("World Update/{0}/Async/{1}", m_Data.m_sName, updateFunction.m_sFunctionName);
+    sStatValue.Format("{0} ms, {1} components in {2} batches", ezArgF(updateFunction.m_LastFrameTime.GetMilliseconds(), 3), uiComponentCount, uiNumBatches);
+    ezStats::SetStat(sStatName, sStatValue.GetData());
+  }
 }
 
 bool ezWorld::ProcessInitializationBatch(ezInternal::WorldData::InitBatch& batch, ezTime endTime)
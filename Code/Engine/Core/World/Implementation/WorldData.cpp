@@ -25,13 +25,70 @@ namespace ezInternal
 
   ////////////////////////////////////////////////////////////////////////////////////////////////////
 
+  // an automatically sized batch should take at least this long, such that the task overhead is negligible
+  static constexpr ezTime s_MinAutoBatchDuration = ezTime::Microseconds(100);
+
+  // not more batches per worker thread than this are created, to not flood the task system
+  static constexpr ezUInt32 s_uiMaxAutoBatchesPerWorker = 4;
+
+  ezUInt32 WorldData::RegisteredUpdateFunction::ComputeGranularity(ezUInt32 uiTotalCount, ezUInt32 uiNumWorkers) const
+  {
+    if (!m_bAutoGranularity)
+    {
+      return (m_uiGranularity != 0) ? m_uiGranularity : uiTotalCount;
+    }
+
+    // without any measurements yet, give every worker one batch
+    ezUInt32 uiNumBatches = uiNumWorkers;
+
+    if (m_AvgTimePerComponent.IsPositive())
+    {
+      // create enough batches to keep all workers busy, even if some batches take longer than others,
+      // but none that are so small that the task overhead dominates
+      const double fTotalTime = m_AvgTimePerComponent.GetSeconds() * uiTotalCount;
+      const double fNumBatches = ezMath::Ceil(fTotalTime / s_MinAutoBatchDuration.GetSeconds());
+      uiNumBatches = static_cast<ezUInt32>(ezMath::Clamp(fNumBatches, 1.0, static_cast<double>(uiNumWorkers * s_uiMaxAutoBatchesPerWorker)));
+    }
+
+    const ezUInt16 uiMinGranularity = ezMath::Max<ezUInt16>(m_uiGranularity, 1);
+    const ezUInt32 uiGranularity = (uiTotalCount + uiNumBatches - 1) / uiNumBatches;
+
+    return ezMath::RoundUp(ezMath::Max<ezUInt32>(uiGranularity, uiMinGranularity), uiMinGranularity);
+  }
+
+  void WorldData::RegisteredUpdateFunction::UpdateMeasurements()
+  {
+    m_LastFrameTime = ezTime::Nanoseconds(static_cast<double>(m_iMeasuredTimeNS.Set(0)));
+
+    if (m_uiLastComponentCount == 0)
+      return;
+
+    const ezTime timePerComponent = m_LastFrameTime / static_cast<double>(m_uiLastComponentCount);
+
+    // smooth the measurements, such that single spikes do not change the batch sizes too much
+    if (m_AvgTimePerComponent.IsPositive())
+    {
+      m_AvgTimePerComponent = ezMath::Lerp(m_AvgTimePerComponent, timePerComponent, 0.2);
+    }
+    else
+    {
+      m_AvgTimePerComponent = timePerComponent;
+    }
+  }
+
+  ////////////////////////////////////////////////////////////////////////////////////////////////////
+
   void WorldData::UpdateTask::Execute()
   {
     ezWorldModule::UpdateContext context;
     context.m_uiFirstComponentIndex = m_uiStartIndex;
     context.m_uiComponentCount = m_uiCount;
 
+    const ezTime startTime = ezTime::Now();
+
     m_Function(context);
+
+    m_pUpdateFunction->m_iMeasuredTimeNS.Add(static_cast<ezInt64>((ezTime::Now() - startTime).GetNanoseconds()));
   }
 
   ////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -280,80 +337,57 @@ namespace ezInternal
     return ezVisitorExecution::Continue;
   }
 
-  void WorldData::UpdateGlobalTransforms(float fInvDeltaSeconds)
-  {
-    struct UserData
-    {
-      ezSimdFloat m_fInvDt;
-      ezSpatialSystem* m_pSpatialSystem;
-    };
-
-    UserData userData;
-    userData.m_fInvDt = fInvDeltaSeconds;
-    userData.m_pSpatialSystem = m_pSpatialSystem.Borrow();
+  // the minimum number of transforms that a task of the multi-threaded transform update processes
+  static constexpr ezUInt32 s_uiMinTransformsPerTask = 512;
 
-    struct RootLevel
+  // static
+  template <bool bWithParent>
+  void WorldData::UpdateGlobalTransformsOfHierarchyLevel(Hierarchy::DataBlockArray& blocks, const ezSimdFloat& fInvDeltaSeconds, ezSpatialSystem* pSpatialSystem)
+  {
+    // Updating the spatial data requires a write lock, so in that case everything is done on this thread.
+    if (pSpatialSystem != nullptr)
     {
-      EZ_ALWAYS_INLINE static ezVisitorExecution::Enum Visit(ezGameObject::TransformationData* pData, void* pUserData)
+      for (Hierarchy::DataBlock& block : blocks)
       {
-        WorldData::UpdateGlobalTransform(pData, static_cast<UserData*>(pUserData)->m_fInvDt);
-        return ezVisitorExecution::Continue;
+        UpdateGlobalTransformsOfDataBlock<bWithParent>(block, fInvDeltaSeconds, pSpatialSystem);
       }
-    };
 
-    struct WithParent
-    {
-      EZ_ALWAYS_INLINE static ezVisitorExecution::Enum Visit(ezGameObject::TransformationData* pData, void* pUserData)
-      {
-        WorldData::UpdateGlobalTransformWithParent(pData, static_cast<UserData*>(pUserData)->m_fInvDt);
-        return ezVisitorExecution::Continue;
-      }
-    };
+      return;
+    }
 
-    struct RootLevelWithSpatialData
-    {
-      EZ_ALWAYS_INLINE static ezVisitorExecution::Enum Visit(ezGameObject::TransformationData* pData, void* pUserData)
-      {
-        WorldData::UpdateGlobalTransformAndSpatialData(pData, static_cast<UserData*>(pUserData)->m_fInvDt,
-          *static_cast<UserData*>(pUserData)->m_pSpatialSystem);
-        return ezVisitorExecution::Continue;
-      }
-    };
+    // A data block only holds a few entries, so every task processes multiple blocks. The bin size is kept small enough
+    // that all workers get a share of the work even for hierarchy levels with only a few thousand objects.
+    ezParallelForParams parallelForParams;
+    parallelForParams.uiBinSize = ezMath::Max<ezUInt32>(s_uiMinTransformsPerTask / Hierarchy::DataBlock::CAPACITY, 1);
+    parallelForParams.uiMaxTasksPerThread = 4;
 
-    struct WithParentWithSpatialData
-    {
-      EZ_ALWAYS_INLINE static ezVisitorExecution::Enum Visit(ezGameObject::TransformationData* pData, void* pUserData)
-      {
-        WorldData::UpdateGlobalTransformWithParentAndSpatialData(pData, static_cast<UserData*>(pUserData)->m_fInvDt,
-          *static_cast<UserData*>(pUserData)->m_pSpatialSystem);
-        return ezVisitorExecution::Continue;
-      }
-    };
+    ezTaskSystem::ParallelFor(blocks.GetArrayPtr(),
+      [&fInvDeltaSeconds](ezArrayPtr<Hierarchy::DataBlock> blocksSlice) {
+        for (Hierarchy::DataBlock& block : blocksSlice)
+        {
+          UpdateGlobalTransformsOfDataBlock<bWithParent>(block, fInvDeltaSeconds, nullptr);
+        }
+      },
+      "World Transform Update Task", parallelForParams);
+  }
+
+  void WorldData::UpdateGlobalTransforms(float fInvDeltaSeconds)
+  {
+    const ezSimdFloat fInvDt = fInvDeltaSeconds;
+    ezSpatialSystem* pSpatialSystem = m_pSpatialSystem.Borrow();
 
     Hierarchy& hierarchy = m_Hierarchies[HierarchyType::Dynamic];
     if (!hierarchy.m_Data.IsEmpty())
     {
       auto dataPtr = hierarchy.m_Data.GetData();
 
-      // If we have no spatial system, we perform multi-threaded update as we do not
-      // have to acquire a write lock in the process.
-      if (m_pSpatialSystem == nullptr)
-      {
-        TraverseHierarchyLevelMultiThreaded<RootLevel>(*dataPtr[0], &userData);
+      // Every level only depends on the previous one, so the entries of one level can be updated in parallel,
+      // as long as no spatial system needs to be updated.
+      UpdateGlobalTransformsOfHierarchyLevel<false>(*dataPtr[0], fInvDt, pSpatialSystem);
 
-        for (ezUInt32 i = 1; i < hierarchy.m_Data.GetCount(); ++i)
-        {
-          TraverseHierarchyLevelMultiThreaded<WithParent>(*dataPtr[i], &userData);
-        }
-      }
-      else
+      for (ezUInt32 i = 1; i < hierarchy.m_Data.GetCount(); ++i)
       {
-        TraverseHierarchyLevel<RootLevelWithSpatialData>(*dataPtr[0], &userData);
-
-        for (ezUInt32 i = 1; i < hierarchy.m_Data.GetCount(); ++i)
-        {
-          TraverseHierarchyLevel<WithParentWithSpatialData>(*dataPtr[i], &userData);
-        }
+        UpdateGlobalTransformsOfHierarchyLevel<true>(*dataPtr[i], fInvDt, pSpatialSystem);
       }
     }
   }
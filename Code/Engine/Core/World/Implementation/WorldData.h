@@ -11,6 +11,8 @@
 #include <Core/World/WorldDesc.h>
 #include <Foundation/Types/SharedPtr.h>
 
+class ezWorldDataTest;
+
 namespace ezInternal
 {
   class EZ_CORE_DLL WorldData
@@ -18,6 +20,7 @@ namespace ezInternal
   private:
     friend class ::ezWorld;
     friend class ::ezComponentManagerBase;
+    friend class ::ezWorldDataTest;
 
     WorldData(ezWorldDesc& desc);
     ~WorldData();
@@ -122,19 +125,20 @@ namespace ezInternal
 
     template <typename VISITOR>
     static ezVisitorExecution::Enum TraverseHierarchyLevel(Hierarchy::DataBlockArray& blocks, void* pUserData = nullptr);
-    template <typename VISITOR>
-    static ezVisitorExecution::Enum TraverseHierarchyLevelMultiThreaded(Hierarchy::DataBlockArray& blocks, void* pUserData = nullptr);
 
     typedef ezDelegate<ezVisitorExecution::Enum(ezGameObject*)> VisitorFunc;
     void TraverseBreadthFirst(VisitorFunc& func);
     void TraverseDepthFirst(VisitorFunc& func);
     static ezVisitorExecution::Enum TraverseObjectDepthFirst(ezGameObject* pObject, VisitorFunc& func);
 
-    static void UpdateGlobalTransform(ezGameObject::TransformationData* pData, const ezSimdFloat& fInvDeltaSeconds);
-    static void UpdateGlobalTransformWithParent(ezGameObject::TransformationData* pData, const ezSimdFloat& fInvDeltaSeconds);
+    /// \brief Updates global transform, velocity and global bounds of all entries in the data block.
+    ///
+    /// If \a pSpatialSystem is not null, the spatial data is updated as well, which is not thread-safe.
+    template <bool bWithParent>
+    static void UpdateGlobalTransformsOfDataBlock(Hierarchy::DataBlock& block, const ezSimdFloat& fInvDeltaSeconds, ezSpatialSystem* pSpatialSystem);
 
-    static void UpdateGlobalTransformAndSpatialData(ezGameObject::TransformationData* pData, const ezSimdFloat& fInvDeltaSeconds, ezSpatialSystem& spatialSystem);
-    static void UpdateGlobalTransformWithParentAndSpatialData(ezGameObject::TransformationData* pData, const ezSimdFloat& fInvDeltaSeconds, ezSpatialSystem& spatialSystem);
+    template <bool bWithParent>
+    static void UpdateGlobalTransformsOfHierarchyLevel(Hierarchy::DataBlockArray& blocks, const ezSimdFloat& fInvDeltaSeconds, ezSpatialSystem* pSpatialSystem);
 
     void UpdateGlobalTransforms(float fInvDeltaSeconds);
 
@@ -175,9 +179,23 @@ namespace ezInternal
       float m_fPriority;
       ezUInt16 m_uiGranularity;
       bool m_bOnlyUpdateWhenSimulating;
+      bool m_bAutoGranularity;
+
+      // measurements of asynchronous update functions, used for automatic granularity and the statistics
+      ezAtomicInteger64 m_iMeasuredTimeNS; // accumulated by all update tasks during the current frame
+      ezTime m_LastFrameTime;
+      ezTime m_AvgTimePerComponent;        // smoothed over multiple frames
+      ezUInt32 m_uiLastComponentCount = 0;
+      ezUInt32 m_uiLastGranularity = 0;
 
       void FillFromDesc(const ezWorldModule::UpdateFunctionDesc& desc);
       bool operator<(const RegisteredUpdateFunction& other) const;
+
+      /// \brief Returns the number of components that each update task should process in the asynchronous phase.
+      ezUInt32 ComputeGranularity(ezUInt32 uiTotalCount, ezUInt32 uiNumWorkers) const;
+
+      /// \brief Takes the time measured by the update tasks of this frame into account.
+      void UpdateMeasurements();
     };
 
     struct UpdateTask final : public ezTask
@@ -185,12 +203,14 @@ namespace ezInternal
       virtual void Execute() override;
 
       ezWorldModule::UpdateFunction m_Function;
+      RegisteredUpdateFunction* m_pUpdateFunction;
       ezUInt32 m_uiStartIndex;
       ezUInt32 m_uiCount;
     };
 
     ezDynamicArray<RegisteredUpdateFunction, ezLocalAllocatorWrapper> m_UpdateFunctions[ezWorldModule::UpdateFunctionDesc::Phase::COUNT];
     ezDynamicArray<ezWorldModule::UpdateFunctionDesc, ezLocalAllocatorWrapper> m_UpdateFunctionsToRegister;
+    ezTime m_LastAsyncUpdateStatsTime;
 
     ezDynamicArray<UpdateTask*, ezLocalAllocatorWrapper> m_UpdateTasks;
 
@@ -30,63 +30,34 @@ namespace ezInternal
   }
 
   // static
-  template <typename VISITOR>
-  EZ_FORCE_INLINE ezVisitorExecution::Enum WorldData::TraverseHierarchyLevelMultiThreaded(Hierarchy::DataBlockArray& blocks, void* pUserData /* = nullptr*/)
+  template <bool bWithParent>
+  EZ_FORCE_INLINE void WorldData::UpdateGlobalTransformsOfDataBlock(Hierarchy::DataBlock& block, const ezSimdFloat& fInvDeltaSeconds, ezSpatialSystem* pSpatialSystem)
   {
-    ezParallelForParams parallelForParams;
-    parallelForParams.uiBinSize = 100;
-    parallelForParams.uiMaxTasksPerThread = 2;
-
-    ezTaskSystem::ParallelFor(blocks.GetArrayPtr(),
-      [pUserData](ezArrayPtr<WorldData::Hierarchy::DataBlock> blocksSlice) {
-        for (WorldData::Hierarchy::DataBlock& block : blocksSlice)
-        {
-          ezGameObject::TransformationData* pCurrentData = block.m_pData;
-          ezGameObject::TransformationData* pEndData = block.m_pData + block.m_uiCount;
-
-          while (pCurrentData < pEndData)
-          {
-            VISITOR::Visit(pCurrentData, pUserData);
-            ++pCurrentData;
-          }
-        }
-      },
-      "World DataBlock Traversal Task", parallelForParams);
-
-    return ezVisitorExecution::Continue;
-  }
+    ezGameObject::TransformationData* pCurrentData = block.m_pData;
+    ezGameObject::TransformationData* pEndData = block.m_pData + block.m_uiCount;
 
-  // static
-  EZ_FORCE_INLINE void WorldData::UpdateGlobalTransform(ezGameObject::TransformationData* pData, const ezSimdFloat& fInvDeltaSeconds)
-  {
-    pData->UpdateGlobalTransform();
-    pData->UpdateVelocity(fInvDeltaSeconds);
-    pData->UpdateGlobalBounds();
-  }
-
-  // static
-  EZ_FORCE_INLINE void WorldData::UpdateGlobalTransformWithParent(ezGameObject::TransformationData* pData, const ezSimdFloat& fInvDeltaSeconds)
-  {
-    pData->UpdateGlobalTransformWithParent();
-    pData->UpdateVelocity(fInvDeltaSeconds);
-    pData->UpdateGlobalBounds();
-  }
+    for (; pCurrentData < pEndData; ++pCurrentData)
+    {
+      if constexpr (bWithParent)
+      {
+        pCurrentData->UpdateGlobalTransformWithParent();
+      }
+      else
+      {
+        pCurrentData->UpdateGlobalTransform();
+      }
 
-  // static
-  EZ_FORCE_INLINE void WorldData::UpdateGlobalTransformAndSpatialData(ezGameObject::TransformationData* pData, const ezSimdFloat& fInvDeltaSeconds,
-    ezSpatialSystem& spatialSystem)
-  {
-    pData->UpdateGlobalTransform();
-    pData->UpdateVelocity(fInvDeltaSeconds);
-    pData->UpdateGlobalBoundsAndSpatialData(spatialSystem);
-  }
+      pCurrentData->UpdateVelocity(fInvDeltaSeconds);
 
-  // static
-  EZ_FORCE_INLINE void WorldData::UpdateGlobalTransformWithParentAndSpatialData(ezGameObject::TransformationData* pData, const ezSimdFloat& fInvDeltaSeconds, ezSpatialSystem& spatialSystem)
-  {
-    pData->UpdateGlobalTransformWithParent();
-    pData->UpdateVelocity(fInvDeltaSeconds);
-    pData->UpdateGlobalBoundsAndSpatialData(spatialSystem);
+      if (pSpatialSystem != nullptr)
+      {
+        pCurrentData->UpdateGlobalBoundsAndSpatialData(*pSpatialSystem);
+      }
+      else
+      {
+        pCurrentData->UpdateGlobalBounds();
+      }
+    }
   }
 
   ///////////////////////////////////////////////////////////////////////////////////////////////////
@@ -200,6 +171,7 @@ namespace ezInternal
     m_fPriority = desc.m_fPriority;
     m_uiGranularity = desc.m_uiGranularity;
     m_bOnlyUpdateWhenSimulating = desc.m_bOnlyUpdateWhenSimulating;
+    m_bAutoGranularity = desc.m_bAutoGranularity;
   }
 
   EZ_FORCE_INLINE bool WorldData::RegisteredUpdateFunction::operator<(const RegisteredUpdateFunction& other) const
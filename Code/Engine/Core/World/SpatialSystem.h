@@ -34,6 +34,7 @@ public:
   struct QueryStats
   {
     ezUInt32 m_uiTotalNumObjects;  ///< The total number of spatial objects in this system.
+    ezUInt32 m_uiNumNodesVisited;  ///< Number of nodes of the spatial data structure (e.g. grid cells or tree nodes) that were visited.
     ezUInt32 m_uiNumObjectsTested; ///< Number of objects tested for the query condition.
     ezUInt32 m_uiNumObjectsPassed; ///< Number of objects that passed the query condition.
     ezTime m_TimeTaken;            ///< Time taken to execute the query
@@ -41,6 +42,7 @@ public:
     EZ_ALWAYS_INLINE QueryStats()
     {
       m_uiTotalNumObjects = 0;
+      m_uiNumNodesVisited = 0;
       m_uiNumObjectsTested = 0;
       m_uiNumObjectsPassed = 0;
     }
@@ -58,6 +60,14 @@ public:
 
   void FindVisibleObjects(const ezFrustum& frustum, ezUInt32 uiCategoryBitmask, ezDynamicArray<const ezGameObject*>& out_Objects, QueryStats* pStats = nullptr) const;
 
+  /// \brief Finds the visible objects for several frustums at once, e.g. for all shadow cascades of a light.
+  ///
+  /// The spatial data structure is only traversed once and every node is tested against all frustums, which is considerably cheaper than
+  /// calling FindVisibleObjects() for each frustum separately. The objects that are visible in frustums[i] are appended to
+  /// *out_ObjectsPerFrustum[i]. The stats are accumulated over all frustums.
+  void FindVisibleObjects(ezArrayPtr<const ezFrustum> frustums, ezUInt32 uiCategoryBitmask, ezArrayPtr<ezDynamicArray<const ezGameObject*>*> out_ObjectsPerFrustum,
+    QueryStats* pStats = nullptr) const;
+
   ///@}
 
 protected:
@@ -65,6 +75,17 @@ protected:
   virtual void FindObjectsInBoxInternal(const ezBoundingBox& box, ezUInt32 uiCategoryBitmask, QueryCallback callback, QueryStats* pStats) const = 0;
   virtual void FindVisibleObjectsInternal(const ezFrustum& frustum, ezUInt32 uiCategoryBitmask, ezDynamicArray<const ezGameObject*>& out_Objects, QueryStats* pStats) const = 0;
 
+  /// \brief The batched visibility query passes at most this many frustums to FindVisibleObjectsBatchedInternal() at once,
+  /// so implementations can track the frustums that a node intersects in a 32 bit mask.
+  enum
+  {
+    MAX_FRUSTUMS_PER_BATCH = 32
+  };
+
+  /// \brief The default implementation calls FindVisibleObjectsInternal() for every frustum. Override this to traverse the data structure only once.
+  virtual void FindVisibleObjectsBatchedInternal(ezArrayPtr<const ezFrustum> frustums, ezUInt32 uiCategoryBitmask,
+    ezArrayPtr<ezDynamicArray<const ezGameObject*>*> out_ObjectsPerFrustum, QueryStats* pStats) const;
+
   virtual void SpatialDataAdded(ezSpatialData* pData) = 0;
   virtual void SpatialDataRemoved(ezSpatialData* pData) = 0;
   virtual void SpatialDataChanged(ezSpatialData* pData, const ezSimdBBoxSphere& oldBounds, ezUInt32 uiOldCategoryBitmask) = 0;
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <Core/World/SpatialSystem.h>
+
+/// \brief A spatial system that sorts all objects into a loose octree.
+///
+/// The bounds of every node are twice as large as the cell that the node represents. This way an object is always stored in exactly one node,
+/// which is found through the object's center and size, without having to be split or duplicated. Small objects end up deep down in the tree
+/// while large objects are stored close to the root. In contrast to ezSpatialSystem_RegularGrid there is no overflow cell that has to be
+/// tested linearly, which makes the octree the better choice for large worlds that mix tiny props with huge objects like terrain chunks.
+///
+/// Queries traverse the tree and skip all subtrees whose bounds do not overlap the query volume or that contain no object of the requested
+/// categories. During visibility queries, all objects of nodes that lie completely inside the frustum are accepted without any further tests.
+/// Batched visibility queries track per node which of the frustums still need to be tested, so the tree is only traversed once.
+///
+/// To use it, pass an instance through ezWorldDesc::m_pSpatialSystem.
+class EZ_CORE_DLL ezSpatialSystem_LooseOctree : public ezSpatialSystem
+{
+  EZ_ADD_DYNAMIC_REFLECTION(ezSpatialSystem_LooseOctree, ezSpatialSystem);
+
+public:
+  /// \brief The octree covers a cube with an edge length of \a fWorldSize around the origin.
+  ///
+  /// Objects outside of this cube are stored in the root node. Nodes are not subdivided any further once their edge length falls below
+  /// \a fMinNodeSize.
+  ezSpatialSystem_LooseOctree(float fWorldSize = 65536.0f, float fMinNodeSize = 16.0f);
+  ~ezSpatialSystem_LooseOctree();
+
+  /// \brief Returns the (loose) bounding box of the node that stores the given spatial data. Useful for debug visualizations.
+  ezResult GetNodeBoxForSpatialData(const ezSpatialDataHandle& hData, ezBoundingBox& out_BoundingBox) const;
+
+  /// \brief Returns the (loose) bounding boxes of all nodes that directly contain objects.
+  void GetAllNodeBoxes(ezHybridArray<ezBoundingBox, 16>& out_BoundingBoxes, ezSpatialData::Category filterCategory = ezInvalidSpatialDataCategory) const;
+
+  /// \brief Returns the number of nodes that are currently allocated.
+  ezUInt32 GetNodeCount() const;
+
+private:
+  // ezSpatialSystem implementation
+  virtual void FindObjectsInSphereInternal(const ezBoundingSphere& sphere, ezUInt32 uiCategoryBitmask, QueryCallback callback, QueryStats* pStats = nullptr) const override;
+  virtual void FindObjectsInBoxInternal(const ezBoundingBox& box, ezUInt32 uiCategoryBitmask, QueryCallback callback, QueryStats* pStats = nullptr) const override;
+
+  virtual void FindVisibleObjectsInternal(const ezFrustum& frustum, ezUInt32 uiCategoryBitmask, ezDynamicArray<const ezGameObject*>& out_Objects,
+    QueryStats* pStats = nullptr) const override;
+  virtual void FindVisibleObjectsBatchedInternal(ezArrayPtr<const ezFrustum> frustums, ezUInt32 uiCategoryBitmask,
+    ezArrayPtr<ezDynamicArray<const ezGameObject*>*> out_ObjectsPerFrustum, QueryStats* pStats) const override;
+
+  virtual void SpatialDataAdded(ezSpatialData* pData) override;
+  virtual void SpatialDataRemoved(ezSpatialData* pData) override;
+  virtual void SpatialDataChanged(ezSpatialData* pData, const ezSimdBBoxSphere& oldBounds, ezUInt32 uiOldCategoryBitmask) override;
+  virtual void FixSpatialDataPointer(ezSpatialData* pOldPtr, ezSpatialData* pNewPtr) override;
+
+  struct SpatialUserData;
+  struct Node;
+
+  ezUInt32 FindNodeForBounds(const ezSimdBBoxSphere& bounds, bool bCreateNodes);
+  ezUInt32 AllocateNode(ezUInt32 uiParent, const ezSimdVec4f& centerAndHalfSize);
+  void AddDataToNode(ezUInt32 uiNode, ezSpatialData* pData);
+  void RemoveDataFromNode(ezSpatialData* pData);
+  void UpdateCategoryBitmasks(ezUInt32 uiNodeIndex);
+
+  /// \brief Calls \a func for the given node and all its descendants that contain objects of the given categories, until it returns Skip or Stop.
+  template <typename Functor>
+  ezVisitorExecution::Enum ForEachNode(ezUInt32 uiStartNode, ezUInt32 uiCategoryBitmask, Functor func) const;
+
+  ezProxyAllocator m_AlignedAllocator;
+
+  ezSimdFloat m_fRootHalfSize;
+  ezUInt32 m_uiMaxDepth = 0;
+
+  ezDynamicArray<Node> m_Nodes;
+  ezDynamicArray<ezUInt32> m_FreeNodes;
+};
@@ -73,6 +73,8 @@ protected:
     bool m_bOnlyUpdateWhenSimulating = false;     ///< The update function is only called when the world simulation is enabled.
     ezUInt16 m_uiGranularity = 0;                 ///< The granularity in which batch updates should happen during the asynchronous phase. Has to be 0 for
                                                   ///< synchronous functions.
+    bool m_bAutoGranularity = false;              ///< The world measures the cost of the function and chooses the batch size for the asynchronous phase
+                                                  ///< automatically. m_uiGranularity is then the minimum batch size. Only allowed for asynchronous functions.
     float m_fPriority = 0.0f;                     ///< Higher priority (higher number) means that this function is called earlier than a function with lower priority.
   };
 
@@ -67,6 +67,7 @@
 // Allocators
 #define EZ_USE_ALLOCATION_TRACKING EZ_OFF
 #define EZ_USE_ALLOCATION_STACK_TRACING EZ_OFF
+#define EZ_USE_ALLOCATION_SAMPLING EZ_OFF
 #define EZ_USE_GUARDED_ALLOCATIONS EZ_OFF
 
 // Other Features
@@ -23,7 +23,9 @@ protected:
   virtual ezResult UpdateStreamBindings() override;
 
   virtual void InitializeElements(ezUInt64 uiStartIndex, ezUInt64 uiNumElements) override;
+  virtual bool SupportsRangeProcessing() const override { return true; }
   virtual void Process(ezUInt64 uiNumElements) override {}
+  virtual void ProcessRange(ezUInt64 uiStartIndex, ezUInt64 uiNumElements) override {}
 
   ezHashedString m_StreamName;
 
@@ -6,6 +6,14 @@
 #include <Foundation/DataProcessing/Stream/ProcessingStreamProcessor.h>
 #include <Foundation/Logging/Log.h>
 #include <Foundation/Memory/MemoryUtils.h>
+#include <Foundation/Threading/Lock.h>
+
+namespace
+{
+  // the removals of the range that is currently processed on this thread, see ezProcessingStreamGroup::ProcessRange()
+  thread_local const ezProcessingStreamGroup* tl_pRangeGroup = nullptr;
+  thread_local ezHybridArray<ezUInt64, 64>* tl_pRangeRemoveIndices = nullptr;
+} // namespace
 
 ezProcessingStreamGroup::ezProcessingStreamGroup()
 {
@@ -50,12 +58,16 @@ void ezProcessingStreamGroup::AddProcessor(ezProcessingStreamProcessor* pProcess
   pProcessor->m_pStreamGroup = this;
 
   m_bStreamAssignmentDirty = true;
+
+  UpdateSupportsRangeProcessing();
 }
 
 void ezProcessingStreamGroup::RemoveProcessor(ezProcessingStreamProcessor* pProcessor)
 {
   m_Processors.RemoveAndCopy(pProcessor);
   pProcessor->GetDynamicRTTI()->GetAllocator()->Deallocate(pProcessor);
+
+  UpdateSupportsRangeProcessing();
 }
 
 void ezProcessingStreamGroup::ClearProcessors()
@@ -68,6 +80,8 @@ void ezProcessingStreamGroup::ClearProcessors()
   }
 
   m_Processors.Clear();
+
+  UpdateSupportsRangeProcessing();
 }
 
 ezProcessingStream* ezProcessingStreamGroup::AddStream(const char* szName, ezProcessingStream::DataType Type)
@@ -139,28 +153,90 @@ void ezProcessingStreamGroup::SetSize(ezUInt64 uiNumElements)
 /// \brief Removes an element (e.g. due to the death of a particle etc.), this will be enqueued (and thus is safe to be called from within data processors).
 void ezProcessingStreamGroup::RemoveElement(ezUInt64 uiElementIndex)
 {
-  if (m_PendingRemoveIndices.Contains(uiElementIndex))
-    return;
-
   EZ_ASSERT_DEBUG(uiElementIndex < m_uiNumActiveElements, "Element which should be removed is outside of active element range!");
 
+  // duplicates are filtered out in RunPendingDeletions()
+  if (tl_pRangeGroup == this)
+  {
+    tl_pRangeRemoveIndices->PushBack(uiElementIndex);
+    return;
+  }
+
+  EZ_LOCK(m_PendingMutex);
   m_PendingRemoveIndices.PushBack(uiElementIndex);
 }
 
 /// \brief Spawns a number of new elements, they will be added as newly initialized stream elements. Safe to call from data processors since the spawning will be queued.
 void ezProcessingStreamGroup::InitializeElements(ezUInt64 uiNumElements)
 {
+  EZ_LOCK(m_PendingMutex);
   m_uiPendingNumberOfElementsToSpawn += uiNumElements;
 }
 
 void ezProcessingStreamGroup::Process()
+{
+  BeginRangeProcessing();
+
+  if (m_bSupportsRangeProcessing)
+  {
+    // Small enough that the data of all streams for one chunk stays in the L1 cache while all processors run over it
+    const ezUInt64 uiChunkSize = 256;
+
+    for (ezUInt64 uiStartIndex = 0; uiStartIndex < m_uiNumActiveElements; uiStartIndex += uiChunkSize)
+    {
+      ProcessRange(uiStartIndex, ezMath::Min(uiChunkSize, m_uiNumActiveElements - uiStartIndex));
+    }
+  }
+  else
+  {
+    // TODO: Identify which processors work on which streams and find independent groups and use separate tasks for them?
+    for (ezProcessingStreamProcessor* pStreamProcessor : m_Processors)
+    {
+      pStreamProcessor->Process(m_uiNumActiveElements);
+    }
+  }
+
+  EndRangeProcessing();
+}
+
+void ezProcessingStreamGroup::BeginRangeProcessing()
 {
   EnsureStreamAssignmentValid();
+}
+
+void ezProcessingStreamGroup::ProcessRange(ezUInt64 uiStartIndex, ezUInt64 uiNumElements)
+{
+  EZ_ASSERT_DEBUG(m_bSupportsRangeProcessing, "Not all stream processors support range processing");
+  EZ_ASSERT_DEBUG(uiStartIndex + uiNumElements <= m_uiNumActiveElements, "Range is outside of the active elements");
+
+  // collect the removals of this range locally, so that dying elements don't contend for the mutex one by one
+  ezHybridArray<ezUInt64, 64> removeIndices;
+
+  const ezProcessingStreamGroup* pPrevRangeGroup = tl_pRangeGroup;
+  ezHybridArray<ezUInt64, 64>* pPrevRangeRemoveIndices = tl_pRangeRemoveIndices;
+  tl_pRangeGroup = this;
+  tl_pRangeRemoveIndices = &removeIndices;
 
-  // TODO: Identify which processors work on which streams and find independent groups and use separate tasks for them?
   for (ezProcessingStreamProcessor* pStreamProcessor : m_Processors)
   {
-    pStreamProcessor->Process(m_uiNumActiveElements);
+    pStreamProcessor->ProcessRange(uiStartIndex, uiNumElements);
+  }
+
+  tl_pRangeGroup = pPrevRangeGroup;
+  tl_pRangeRemoveIndices = pPrevRangeRemoveIndices;
+
+  if (!removeIndices.IsEmpty())
+  {
+    EZ_LOCK(m_PendingMutex);
+    m_PendingRemoveIndices.PushBackRange(removeIndices);
+  }
+}
+
+void ezProcessingStreamGroup::EndRangeProcessing()
+{
+  for (ezProcessingStreamProcessor* pStreamProcessor : m_Processors)
+  {
+    pStreamProcessor->FinishProcessing();
   }
 
   // Run any pending deletions which happened due to stream processor execution
@@ -171,22 +247,29 @@ void ezProcessingStreamGroup::Process()
   RunPendingSpawns();
 }
 
-
 void ezProcessingStreamGroup::RunPendingDeletions()
 {
+  if (m_PendingRemoveIndices.IsEmpty())
+    return;
+
   ezStreamGroupElementRemovedEvent e;
   e.m_pStreamGroup = this;
 
-  // Remove elements
-  while (!m_PendingRemoveIndices.IsEmpty())
+  // Remove the elements with the highest index first. That way the last active element, which is swapped into the place of the removed one,
+  // can never be pending for removal itself anymore, and duplicate removals end up next to each other.
+  m_PendingRemoveIndices.Sort([](ezUInt64 a, ezUInt64 b) { return a > b; });
+
+  for (ezUInt32 i = 0; i < m_PendingRemoveIndices.GetCount(); ++i)
   {
     if (m_uiNumActiveElements == 0)
       break;
 
-    const ezUInt64 uiLastActiveElementIndex = m_uiNumActiveElements - 1;
+    const ezUInt64 uiElementToRemove = m_PendingRemoveIndices[i];
 
-    const ezUInt64 uiElementToRemove = m_PendingRemoveIndices.PeekBack();
-    m_PendingRemoveIndices.PopBack();
+    if (i > 0 && uiElementToRemove == m_PendingRemoveIndices[i - 1])
+      continue;
+
+    const ezUInt64 uiLastActiveElementIndex = m_uiNumActiveElements - 1;
 
     EZ_ASSERT_DEBUG(uiElementToRemove < m_uiNumActiveElements, "Invalid index to remove");
 
@@ -202,20 +285,6 @@ void ezProcessingStreamGroup::RunPendingDeletions()
       continue;
     }
 
-    // Since we swap with the last element we need to make sure that any pending removals of the (current) last element are updated
-    // and point to the place where we moved the data to.
-    for (ezUInt32 i = 0; i < m_PendingRemoveIndices.GetCount(); ++i)
-    {
-      // Is the pending remove in the array actually the last element we use to swap with? It's simply a matter of updating it to point to the new index.
-      if (m_PendingRemoveIndices[i] == uiLastActiveElementIndex)
-      {
-        m_PendingRemoveIndices[i] = uiElementToRemove;
-
-        // We can break since the RemoveElement() operation takes care that each index can be in the array only once
-        break;
-      }
-    }
-
     // Move the data
     for (ezProcessingStream* pStream : m_DataStreams)
     {
@@ -293,5 +362,15 @@ void ezProcessingStreamGroup::SortProcessorsByPriority()
   m_Processors.Sort(cmp);
 }
 
+void ezProcessingStreamGroup::UpdateSupportsRangeProcessing()
+{
+  m_bSupportsRangeProcessing = true;
+
+  for (const ezProcessingStreamProcessor* pProcessor : m_Processors)
+  {
+    m_bSupportsRangeProcessing &= pProcessor->SupportsRangeProcessing();
+  }
+}
+
 EZ_STATICLINK_FILE(Foundation, Foundation_DataProcessing_Stream_Implementation_ProcessingStreamGroup);
 
@@ -19,6 +19,11 @@ ezProcessingStreamProcessor::~ezProcessingStreamProcessor()
   m_pStreamGroup = nullptr;
 }
 
+void ezProcessingStreamProcessor::ProcessRange(ezUInt64 uiStartIndex, ezUInt64 uiNumElements)
+{
+  EZ_REPORT_FAILURE("'{0}' does not implement range processing", GetDynamicRTTI()->GetTypeName());
+}
+
 
 
 EZ_STATICLINK_FILE(Foundation, Foundation_DataProcessing_Stream_Implementation_ProcessingStreamProcessor);
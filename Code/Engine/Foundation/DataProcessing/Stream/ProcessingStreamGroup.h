@@ -5,6 +5,7 @@
 #include <Foundation/Communication/Event.h>
 #include <Foundation/Containers/HybridArray.h>
 #include <Foundation/DataProcessing/Stream/ProcessingStream.h>
+#include <Foundation/Threading/Mutex.h>
 
 class ezProcessingStreamProcessor;
 class ezProcessingStreamGroup;
@@ -56,14 +57,37 @@ public:
   void SetSize(ezUInt64 uiNumElements);
 
   /// \brief Removes an element (e.g. due to the death of a particle etc.), this will be enqueued (and thus is safe to be called from within data processors).
+  ///
+  /// This is thread-safe, so processors may call it from ProcessRange() as well. Removals from within ProcessRange() are collected
+  /// per range and merged into the pending removals once the range is done.
   void RemoveElement(ezUInt64 uiElementIndex);
 
   /// \brief Spawns a number of new elements, they will be added as newly initialized stream elements. Safe to call from data processors since the spawning will be queued.
   void InitializeElements(ezUInt64 uiNumElements);
 
   /// \brief Runs the stream processors which have been added to the stream group.
+  ///
+  /// If all processors support range processing, the elements are processed in chunks, with all processors running over one chunk
+  /// before moving on to the next, such that the data of a chunk stays in the cache.
   void Process();
 
+  /// \brief Returns true if all processors support range processing. In this case the work of Process() can be split up through
+  /// BeginRangeProcessing(), ProcessRange() and EndRangeProcessing().
+  bool SupportsRangeProcessing() const { return m_bSupportsRangeProcessing; }
+
+  /// \brief Prepares the streams and processors for ProcessRange(). Has to be called from a single thread.
+  void BeginRangeProcessing();
+
+  /// \brief Runs all processors on the elements in the given range, one after another.
+  ///
+  /// Disjoint ranges may be processed on multiple threads at the same time. Only valid between BeginRangeProcessing() and EndRangeProcessing(),
+  /// and only if SupportsRangeProcessing() returns true. All ranges together have to cover exactly the active elements.
+  void ProcessRange(ezUInt64 uiStartIndex, ezUInt64 uiNumElements);
+
+  /// \brief Calls FinishProcessing() on all processors, removes the elements that have been removed during processing and spawns new elements.
+  /// Has to be called once all ranges are processed.
+  void EndRangeProcessing();
+
   /// \brief Returns the number of elements the streams store.
   inline ezUInt64 GetNumElements() const
   {
@@ -95,10 +119,13 @@ private:
 
   void SortProcessorsByPriority();
 
+  void UpdateSupportsRangeProcessing();
+
   ezHybridArray<ezProcessingStreamProcessor*, 8> m_Processors;
 
   ezHybridArray<ezProcessingStream*, 8> m_DataStreams;
 
+  ezMutex m_PendingMutex; // protects the pending removals and spawns
   ezHybridArray<ezUInt64, 64> m_PendingRemoveIndices;
 
   ezUInt64 m_uiPendingNumberOfElementsToSpawn;
@@ -110,5 +137,7 @@ private:
   ezUInt64 m_uiHighestNumActiveElements;
 
   bool m_bStreamAssignmentDirty;
+
+  bool m_bSupportsRangeProcessing = true;
 };
 
@@ -32,8 +32,24 @@ protected:
   virtual void InitializeElements(ezUInt64 uiStartIndex, ezUInt64 uiNumElements) = 0;
 
   /// \brief The actual method which processes the data, will be called with the number of elements to process.
+  /// Processors that support range processing typically forward this to ProcessRange() for the whole range.
   virtual void Process(ezUInt64 uiNumElements) = 0;
 
+  /// \brief Return true, if this processor implements ProcessRange().
+  ///
+  /// Processors that support range processing may get their elements in multiple chunks, possibly from several threads at the same time.
+  /// They may therefore only touch the elements inside the given range and must not modify any other state during processing.
+  /// Removing elements through the stream group is allowed. The return value must not change once the processor has been added to a group.
+  virtual bool SupportsRangeProcessing() const { return false; }
+
+  /// \brief Processes the elements in the range [uiStartIndex; uiStartIndex + uiNumElements). Only called when SupportsRangeProcessing() returns true.
+  virtual void ProcessRange(ezUInt64 uiStartIndex, ezUInt64 uiNumElements);
+
+  /// \brief Called once per Process() or EndRangeProcessing() after all elements have been processed and before removed elements are deleted.
+  ///
+  /// This is always called from a single thread, even if there were no elements to process, so results gathered from multiple ranges can be published here.
+  virtual void FinishProcessing() {}
+
   /// \brief Back pointer to the stream group - will be set to the owner stream group when adding the stream processor to the group.
   /// Can be used to get stream pointers in UpdateStreamBindings();
   ezProcessingStreamGroup* m_pStreamGroup;
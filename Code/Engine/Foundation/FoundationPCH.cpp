@@ -148,12 +148,14 @@ EZ_STATICLINK_LIBRARY(Foundation)
   EZ_STATICLINK_REFERENCE(Foundation_Threading_Implementation_OSThread);
   EZ_STATICLINK_REFERENCE(Foundation_Threading_Implementation_ParallelFor);
   EZ_STATICLINK_REFERENCE(Foundation_Threading_Implementation_Task);
+  EZ_STATICLINK_REFERENCE(Foundation_Threading_Implementation_TaskGraph);
   EZ_STATICLINK_REFERENCE(Foundation_Threading_Implementation_TaskGroup);
   EZ_STATICLINK_REFERENCE(Foundation_Threading_Implementation_TaskSystem);
   EZ_STATICLINK_REFERENCE(Foundation_Threading_Implementation_TaskSystemGroups);
   EZ_STATICLINK_REFERENCE(Foundation_Threading_Implementation_TaskSystemTasks);
   EZ_STATICLINK_REFERENCE(Foundation_Threading_Implementation_TaskSystemThreads);
   EZ_STATICLINK_REFERENCE(Foundation_Threading_Implementation_TaskSystemUtils);
+  EZ_STATICLINK_REFERENCE(Foundation_Threading_Implementation_TaskWorkStealingQueue);
   EZ_STATICLINK_REFERENCE(Foundation_Threading_Implementation_TaskWorkerThread);
   EZ_STATICLINK_REFERENCE(Foundation_Threading_Implementation_Thread);
   EZ_STATICLINK_REFERENCE(Foundation_Threading_Implementation_ThreadSignal);
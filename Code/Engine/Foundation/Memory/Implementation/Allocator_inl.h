@@ -85,6 +85,10 @@ void* ezInternal::ezAllocatorImpl<A, TrackingFlags>::Allocate(size_t uiSize, siz
 
     ezMemoryTracker::AddAllocation(this->m_Id, flags, ptr, uiSize, uiAlign, ezTime::Now() - fAllocationTime);
   }
+  else if ((TrackingFlags & ezMemoryTrackingFlags::EnableAllocationSampling) != 0)
+  {
+    ezMemoryTracker::SampleAllocation(this->m_Id, ptr, uiSize);
+  }
 
   return ptr;
 }
@@ -96,6 +100,10 @@ void ezInternal::ezAllocatorImpl<A, TrackingFlags>::Deallocate(void* ptr)
   {
     ezMemoryTracker::RemoveAllocation(this->m_Id, ptr);
   }
+  else if ((TrackingFlags & ezMemoryTrackingFlags::EnableAllocationSampling) != 0)
+  {
+    ezMemoryTracker::SampleDeallocation(this->m_Id, ptr);
+  }
 
   m_allocator.Deallocate(ptr);
 }
@@ -153,6 +161,10 @@ void* ezInternal::ezAllocatorMixinReallocate<A, TrackingFlags, true>::Reallocate
   {
     ezMemoryTracker::RemoveAllocation(this->m_Id, ptr);
   }
+  else if ((TrackingFlags & ezMemoryTrackingFlags::EnableAllocationSampling) != 0)
+  {
+    ezMemoryTracker::SampleDeallocation(this->m_Id, ptr);
+  }
 
   ezTime fAllocationTime = ezTime::Now();
 
@@ -165,6 +177,10 @@ void* ezInternal::ezAllocatorMixinReallocate<A, TrackingFlags, true>::Reallocate
 
     ezMemoryTracker::AddAllocation(this->m_Id, flags, pNewMem, uiNewSize, uiAlign, ezTime::Now() - fAllocationTime);
   }
+  else if ((TrackingFlags & ezMemoryTrackingFlags::EnableAllocationSampling) != 0)
+  {
+    ezMemoryTracker::SampleAllocation(this->m_Id, pNewMem, uiNewSize);
+  }
   return pNewMem;
 }
 
@@ -51,7 +51,10 @@ ezLargeBlockAllocator<BlockSize>::ezLargeBlockAllocator(const char* szName, ezAl
 {
   EZ_CHECK_AT_COMPILETIME_MSG(BlockSize >= 4096, "Block size must be 4096 or bigger");
 
-  m_Id = ezMemoryTracker::RegisterAllocator(szName, flags, ezPageAllocator::GetId());
+  // blocks are few and large, so they are always tracked individually instead of sampled
+  m_TrackingFlags.Remove(ezMemoryTrackingFlags::EnableAllocationSampling);
+
+  m_Id = ezMemoryTracker::RegisterAllocator(szName, m_TrackingFlags, ezPageAllocator::GetId());
   m_ThreadID = ezThreadUtils::GetCurrentThreadID();
 
   const ezUInt32 uiPageSize = ezSystemInformation::Get().GetMemoryPageSize();
@@ -1,12 +1,16 @@
 #include <FoundationPCH.h>
 
+#include <Foundation/Algorithm/HashingUtils.h>
 #include <Foundation/Containers/HashTable.h>
 #include <Foundation/Containers/IdTable.h>
+#include <Foundation/IO/OSFile.h>
 #include <Foundation/Logging/Log.h>
 #include <Foundation/Memory/Allocator.h>
 #include <Foundation/Memory/Policies/HeapAllocation.h>
 #include <Foundation/Strings/String.h>
+#include <Foundation/Strings/StringBuilder.h>
 #include <Foundation/System/StackTracer.h>
+#include <Foundation/Threading/AtomicUtils.h>
 #include <Foundation/Threading/Lock.h>
 #include <Foundation/Threading/Mutex.h>
 
@@ -39,6 +43,63 @@ namespace
     ezAllocatorBase::Stats m_Stats;
 
     ezHashTable<const void*, ezMemoryTracker::AllocationInfo, ezHashHelper<const void*>, TrackerDataAllocatorWrapper> m_Allocations;
+
+    // estimated from the live samples, if the allocator only samples its allocations
+    ezUInt64 m_uiSampledLiveSize = 0;
+  };
+
+  constexpr ezUInt32 s_uiMaxSampledAllocators = 1024;
+  constexpr ezUInt32 s_uiNumLiveSampleBuckets = 4096;
+  constexpr ezUInt32 s_uiMaxSampleStackFrames = 24;
+  constexpr ezUInt32 s_uiSkippedSampleStackFrames = 2; // RecordSample() and SampleAllocation()
+  constexpr ezUInt32 s_uiSampleBufferSize = 128;
+  constexpr ezInt64 s_iCounterFlushInterval = 64;
+  constexpr ezInt64 s_iDisabledSamplingRecheckBytes = 64 * 1024 * 1024;
+
+  struct SampleEvent
+  {
+    EZ_DECLARE_POD_TYPE();
+
+    ezUInt64 m_uiSequence;
+    const void* m_pPtr;
+    ezAllocatorId m_AllocatorId;
+    ezUInt32 m_uiStackTraceLength;
+    ezUInt64 m_uiSize; ///< zero for deallocations
+    ezUInt64 m_uiWeight;
+    void* m_StackTrace[s_uiMaxSampleStackFrames];
+  };
+
+  /// Every thread that samples allocations writes into its own buffer, which is merged into the tracker data when it is full or the
+  /// data is queried. The mutex is only contended while merging.
+  struct SampleBuffer
+  {
+    ezMutex m_Mutex;
+    bool m_bInUse = false;
+    ezUInt32 m_uiNumEvents = 0;
+    SampleEvent m_Events[s_uiSampleBufferSize];
+  };
+
+  struct LiveSample
+  {
+    EZ_DECLARE_POD_TYPE();
+
+    ezAllocatorId m_AllocatorId;
+    ezUInt64 m_uiWeight;
+    ezUInt64 m_uiSiteHash;
+  };
+
+  struct AllocationSite
+  {
+    EZ_DECLARE_POD_TYPE();
+
+    ezAllocatorId m_AllocatorId;
+    ezUInt32 m_uiStackTraceLength = 0;
+    void* m_StackTrace[s_uiMaxSampleStackFrames];
+
+    ezUInt64 m_uiLiveSize = 0;
+    ezUInt64 m_uiNumLiveSamples = 0;
+    ezUInt64 m_uiTotalSize = 0;
+    ezUInt64 m_uiNumTotalSamples = 0;
   };
 
   struct TrackerData
@@ -52,6 +113,11 @@ namespace
     AllocatorTable m_AllocatorData;
 
     ezAllocatorId m_StaticAllocatorId;
+
+    ezDynamicArray<SampleBuffer*, TrackerDataAllocatorWrapper> m_SampleBuffers;
+    ezDynamicArray<SampleEvent, TrackerDataAllocatorWrapper> m_MergedEvents;
+    ezHashTable<const void*, LiveSample, ezHashHelper<const void*>, TrackerDataAllocatorWrapper> m_LiveSamples;
+    ezHashTable<ezUInt64, AllocationSite, ezHashHelper<ezUInt64>, TrackerDataAllocatorWrapper> m_AllocationSites;
   };
 
   static TrackerData* s_pTrackerData;
@@ -84,6 +150,432 @@ namespace
     s_bIsInitializing = false;
   }
 
+  // The sampling data below is only POD, so that it is usable before any static constructors ran.
+
+  /// Updated without the tracker mutex on every allocation of an allocator that samples its allocations.
+  struct SampledAllocatorCounters
+  {
+    volatile ezUInt32 m_uiAllocatorId; // to detect counts for allocators that were deregistered and replaced in the meantime
+    volatile ezInt64 m_iNumAllocations;
+    volatile ezInt64 m_iNumDeallocations;
+    volatile ezInt64 m_iPerFrameAllocationSize;
+  };
+
+  static SampledAllocatorCounters s_SampledAllocatorCounters[s_uiMaxSampledAllocators];
+
+  // number of live samples per pointer hash bucket, deallocations only need to be recorded when their bucket has live samples
+  static volatile ezInt32 s_LiveSampleBuckets[s_uiNumLiveSampleBuckets];
+
+  // orders the events of all threads, e.g. to know whether a sampled pointer was freed before or after it got allocated again
+  static volatile ezInt64 s_iSampleSequence;
+
+  static volatile ezUInt32 s_uiSamplingInterval = 512 * 1024;
+
+  struct ThreadSamplingState
+  {
+    ezInt64 m_iBytesUntilSample;
+    ezUInt64 m_uiRandomState; // zero until the first interval was drawn
+    SampleBuffer* m_pBuffer;
+    bool m_bThreadExited;
+
+    // counts of the last used allocator, added to the shared counters in batches
+    ezUInt32 m_uiCountedAllocatorId;
+    ezInt64 m_iNumAllocations;
+    ezInt64 m_iNumDeallocations;
+    ezInt64 m_iAllocationSize;
+    ezInt64 m_iNumCounted;
+  };
+
+  // trivially destructible, such that it stays usable by allocations in other thread_local destructors
+  static thread_local ThreadSamplingState tl_SamplingState;
+
+  // set while the current thread merges samples, allocations in that time must not write into the sample buffers
+  static thread_local bool tl_bInsideSampleMerge = false;
+
+  /// Accessing it once registers the destructor, which releases the sample buffer when the thread exits.
+  struct ThreadSamplingCleanup
+  {
+    EZ_ALWAYS_INLINE void Activate() { m_bActive = true; }
+    ~ThreadSamplingCleanup();
+
+    bool m_bActive = false;
+  };
+
+  static thread_local ThreadSamplingCleanup tl_SamplingCleanup;
+
+  EZ_ALWAYS_INLINE volatile ezInt32& GetLiveSampleBucket(const void* ptr)
+  {
+    const size_t uiHash = reinterpret_cast<size_t>(ptr) >> 4;
+    return s_LiveSampleBuckets[(uiHash ^ (uiHash >> 12)) & (s_uiNumLiveSampleBuckets - 1)];
+  }
+
+  static void FlushSampledCounts(ThreadSamplingState& state)
+  {
+    if (state.m_iNumCounted == 0)
+      return;
+
+    const ezAllocatorId allocatorId(state.m_uiCountedAllocatorId);
+    if (allocatorId.m_InstanceIndex < s_uiMaxSampledAllocators)
+    {
+      SampledAllocatorCounters& counters = s_SampledAllocatorCounters[allocatorId.m_InstanceIndex];
+
+      if (counters.m_uiAllocatorId == state.m_uiCountedAllocatorId)
+      {
+        ezAtomicUtils::Add(counters.m_iNumAllocations, state.m_iNumAllocations);
+        ezAtomicUtils::Add(counters.m_iNumDeallocations, state.m_iNumDeallocations);
+        ezAtomicUtils::Add(counters.m_iPerFrameAllocationSize, state.m_iAllocationSize);
+      }
+    }
+
+    state.m_iNumAllocations = 0;
+    state.m_iNumDeallocations = 0;
+    state.m_iAllocationSize = 0;
+    state.m_iNumCounted = 0;
+  }
+
+  EZ_ALWAYS_INLINE void CountSampledAllocation(ThreadSamplingState& state, ezAllocatorId allocatorId, ezInt64 iNumAllocations, ezInt64 iNumDeallocations, ezInt64 iSize)
+  {
+    if (state.m_uiCountedAllocatorId != allocatorId.m_Data)
+    {
+      FlushSampledCounts(state);
+      state.m_uiCountedAllocatorId = allocatorId.m_Data;
+    }
+
+    state.m_iNumAllocations += iNumAllocations;
+    state.m_iNumDeallocations += iNumDeallocations;
+    state.m_iAllocationSize += iSize;
+
+    if (++state.m_iNumCounted >= s_iCounterFlushInterval || state.m_bThreadExited)
+    {
+      FlushSampledCounts(state);
+    }
+  }
+
+  static ezInt64 DrawBytesUntilSample(ThreadSamplingState& state, ezUInt32 uiInterval)
+  {
+    if (uiInterval == 0)
+      return s_iDisabledSamplingRecheckBytes;
+
+    if (state.m_uiRandomState == 0)
+    {
+      state.m_uiRandomState = (reinterpret_cast<ezUInt64>(&state) ^ static_cast<ezUInt64>(ezTime::Now().GetNanoseconds())) | 1;
+    }
+
+    // xorshift64
+    ezUInt64 x = state.m_uiRandomState;
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    state.m_uiRandomState = x;
+
+    // exponentially distributed, such that the samples form a poisson process over the allocated bytes
+    const float fRandom = static_cast<float>((x >> 40) + 1) / static_cast<float>(1 << 24);
+    return static_cast<ezInt64>(-ezMath::Ln(fRandom) * uiInterval) + 1;
+  }
+
+  static SampleBuffer* AcquireSampleBuffer()
+  {
+    EZ_LOCK(*s_pTrackerData);
+
+    for (SampleBuffer* pBuffer : s_pTrackerData->m_SampleBuffers)
+    {
+      if (!pBuffer->m_bInUse)
+      {
+        pBuffer->m_bInUse = true;
+        return pBuffer;
+      }
+    }
+
+    SampleBuffer* pBuffer = EZ_NEW(s_pTrackerDataAllocator, SampleBuffer);
+    pBuffer->m_bInUse = true;
+    s_pTrackerData->m_SampleBuffers.PushBack(pBuffer);
+    return pBuffer;
+  }
+
+  static void ReleaseSampleBuffer(ThreadSamplingState& state)
+  {
+    // the buffer is not emptied, its events are merged with the next buffer merge
+    EZ_LOCK(state.m_pBuffer->m_Mutex);
+    state.m_pBuffer->m_bInUse = false;
+    state.m_pBuffer = nullptr;
+  }
+
+  ThreadSamplingCleanup::~ThreadSamplingCleanup()
+  {
+    ThreadSamplingState& state = tl_SamplingState;
+
+    FlushSampledCounts(state);
+
+    if (state.m_pBuffer != nullptr)
+    {
+      ReleaseSampleBuffer(state);
+    }
+
+    state.m_bThreadExited = true;
+  }
+
+  static void MergeSamples();
+
+  /// Returns the next free event in the thread's buffer with the buffer locked, or nullptr if the event has to be dropped.
+  static SampleEvent* BeginSampleEvent(ThreadSamplingState& state)
+  {
+    if (tl_bInsideSampleMerge || s_pTrackerData == nullptr)
+      return nullptr;
+
+    if (state.m_pBuffer == nullptr)
+    {
+      if (!state.m_bThreadExited)
+      {
+        tl_SamplingCleanup.Activate();
+      }
+
+      state.m_pBuffer = AcquireSampleBuffer();
+    }
+
+    state.m_pBuffer->m_Mutex.Lock();
+
+    if (state.m_pBuffer->m_uiNumEvents == s_uiSampleBufferSize)
+    {
+      state.m_pBuffer->m_Mutex.Unlock();
+
+      {
+        EZ_LOCK(*s_pTrackerData);
+        MergeSamples();
+      }
+
+      state.m_pBuffer->m_Mutex.Lock();
+
+      // the merge only keeps events that got their sequence number after it started, so this buffer should be empty now,
+      // but never write past its end
+      if (state.m_pBuffer->m_uiNumEvents == s_uiSampleBufferSize)
+      {
+        state.m_pBuffer->m_Mutex.Unlock();
+        return nullptr;
+      }
+    }
+
+    SampleEvent* pEvent = &state.m_pBuffer->m_Events[state.m_pBuffer->m_uiNumEvents];
+    pEvent->m_uiSequence = static_cast<ezUInt64>(ezAtomicUtils::Increment(s_iSampleSequence));
+    return pEvent;
+  }
+
+  static void EndSampleEvent(ThreadSamplingState& state)
+  {
+    state.m_pBuffer->m_uiNumEvents++;
+    state.m_pBuffer->m_Mutex.Unlock();
+
+    // a thread that already exited has no cleanup anymore that would release the buffer
+    if (state.m_bThreadExited)
+    {
+      ReleaseSampleBuffer(state);
+    }
+  }
+
+  static void RecordSample(ThreadSamplingState& state, ezAllocatorId allocatorId, const void* ptr, size_t uiSize)
+  {
+    const bool bFirstInterval = state.m_uiRandomState == 0;
+    const ezUInt32 uiInterval = s_uiSamplingInterval;
+
+    state.m_iBytesUntilSample = DrawBytesUntilSample(state, uiInterval);
+
+    if (bFirstInterval || uiInterval == 0)
+      return;
+
+    SampleEvent* pEvent = BeginSampleEvent(state);
+    if (pEvent == nullptr)
+      return;
+
+    // an allocation is sampled with a probability of 1 - e^(-size / interval), weighting it with the inverse makes the estimate unbiased
+    const float fRatio = static_cast<float>(uiSize) / uiInterval;
+    const float fProbability = fRatio < 0.001f ? fRatio : 1.0f - ezMath::Exp(-fRatio);
+
+    pEvent->m_pPtr = ptr;
+    pEvent->m_AllocatorId = allocatorId;
+    pEvent->m_uiSize = uiSize;
+    pEvent->m_uiWeight = ezMath::Max<ezUInt64>(static_cast<ezUInt64>(uiSize / fProbability), uiSize);
+
+    void* pBuffer[s_uiMaxSampleStackFrames + s_uiSkippedSampleStackFrames];
+    ezArrayPtr<void*> stackTrace(pBuffer);
+    const ezUInt32 uiNumFrames = ezStackTracer::GetStackTrace(stackTrace);
+    const ezUInt32 uiSkippedFrames = ezMath::Min(uiNumFrames, s_uiSkippedSampleStackFrames);
+
+    pEvent->m_uiStackTraceLength = uiNumFrames - uiSkippedFrames;
+    ezMemoryUtils::Copy(pEvent->m_StackTrace, pBuffer + uiSkippedFrames, pEvent->m_uiStackTraceLength);
+
+    // before the allocation is returned, so its deallocation can't miss that it was sampled
+    ezAtomicUtils::Increment(GetLiveSampleBucket(ptr));
+
+    EndSampleEvent(state);
+  }
+
+  static void RemoveLiveSample(const void* ptr, const LiveSample& sample)
+  {
+    AllocationSite* pSite = nullptr;
+    if (s_pTrackerData->m_AllocationSites.TryGetValue(sample.m_uiSiteHash, pSite))
+    {
+      pSite->m_uiLiveSize -= sample.m_uiWeight;
+      pSite->m_uiNumLiveSamples--;
+    }
+
+    AllocatorData* pData = nullptr;
+    if (s_pTrackerData->m_AllocatorData.TryGetValue(sample.m_AllocatorId, pData))
+    {
+      pData->m_uiSampledLiveSize -= sample.m_uiWeight;
+    }
+
+    ezAtomicUtils::Decrement(GetLiveSampleBucket(ptr));
+    s_pTrackerData->m_LiveSamples.Remove(ptr);
+  }
+
+  static void AddLiveSample(const SampleEvent& e)
+  {
+    AllocatorData* pData = nullptr;
+    if (!s_pTrackerData->m_AllocatorData.TryGetValue(e.m_AllocatorId, pData))
+    {
+      // the allocator was deregistered in the meantime
+      ezAtomicUtils::Decrement(GetLiveSampleBucket(e.m_pPtr));
+      return;
+    }
+
+    // the deallocation of a previous sample at this address was missed
+    LiveSample* pPrevious = nullptr;
+    if (s_pTrackerData->m_LiveSamples.TryGetValue(e.m_pPtr, pPrevious))
+    {
+      RemoveLiveSample(e.m_pPtr, *pPrevious);
+    }
+
+    const ezUInt64 uiSiteHash = ezHashingUtils::xxHash64(e.m_StackTrace, sizeof(void*) * e.m_uiStackTraceLength, e.m_AllocatorId.m_Data);
+
+    AllocationSite& site = s_pTrackerData->m_AllocationSites[uiSiteHash];
+    if (site.m_uiNumTotalSamples == 0)
+    {
+      site.m_AllocatorId = e.m_AllocatorId;
+      site.m_uiStackTraceLength = e.m_uiStackTraceLength;
+      ezMemoryUtils::Copy(site.m_StackTrace, e.m_StackTrace, e.m_uiStackTraceLength);
+    }
+
+    site.m_uiLiveSize += e.m_uiWeight;
+    site.m_uiNumLiveSamples++;
+    site.m_uiTotalSize += e.m_uiWeight;
+    site.m_uiNumTotalSamples++;
+
+    pData->m_uiSampledLiveSize += e.m_uiWeight;
+
+    LiveSample& sample = s_pTrackerData->m_LiveSamples[e.m_pPtr];
+    sample.m_AllocatorId = e.m_AllocatorId;
+    sample.m_uiWeight = e.m_uiWeight;
+    sample.m_uiSiteHash = uiSiteHash;
+  }
+
+  static void MergeSamples()
+  {
+    tl_bInsideSampleMerge = true;
+
+    auto& events = s_pTrackerData->m_MergedEvents;
+    events.Clear();
+
+    // Events that get their sequence number after this point are kept for the next merge. Otherwise such an event in a buffer
+    // that was already collected would be processed after a later event of a buffer that is collected afterwards.
+    // All events up to this sequence number are complete once their buffer is locked, they are written under its mutex.
+    const ezUInt64 uiLastSequence = static_cast<ezUInt64>(ezAtomicUtils::Read(s_iSampleSequence));
+
+    for (SampleBuffer* pBuffer : s_pTrackerData->m_SampleBuffers)
+    {
+      EZ_LOCK(pBuffer->m_Mutex);
+
+      ezUInt32 uiNumKept = 0;
+      for (ezUInt32 i = 0; i < pBuffer->m_uiNumEvents; ++i)
+      {
+        const SampleEvent& e = pBuffer->m_Events[i];
+
+        if (e.m_uiSequence <= uiLastSequence)
+        {
+          events.PushBack(e);
+        }
+        else
+        {
+          pBuffer->m_Events[uiNumKept++] = e;
+        }
+      }
+
+      pBuffer->m_uiNumEvents = uiNumKept;
+    }
+
+    events.Sort([](const SampleEvent& a, const SampleEvent& b) { return a.m_uiSequence < b.m_uiSequence; });
+
+    for (const SampleEvent& e : events)
+    {
+      if (e.m_uiSize != 0)
+      {
+        AddLiveSample(e);
+        continue;
+      }
+
+      // the bucket of a deallocation might only have had live samples of other pointers
+      LiveSample* pSample = nullptr;
+      if (s_pTrackerData->m_LiveSamples.TryGetValue(e.m_pPtr, pSample) && pSample->m_AllocatorId == e.m_AllocatorId)
+      {
+        RemoveLiveSample(e.m_pPtr, *pSample);
+      }
+    }
+
+    tl_bInsideSampleMerge = false;
+  }
+
+  static void RemoveAllSamples(ezAllocatorId allocatorId)
+  {
+    for (auto it = s_pTrackerData->m_LiveSamples.GetIterator(); it.IsValid();)
+    {
+      if (it.Value().m_AllocatorId == allocatorId)
+      {
+        LiveSample sample = it.Value();
+        const void* ptr = it.Key();
+        ++it;
+        RemoveLiveSample(ptr, sample);
+      }
+      else
+      {
+        ++it;
+      }
+    }
+  }
+
+  EZ_ALWAYS_INLINE bool IsSampling(ezBitflags<ezMemoryTrackingFlags> flags)
+  {
+    return flags.IsSet(ezMemoryTrackingFlags::EnableAllocationSampling) && !flags.IsSet(ezMemoryTrackingFlags::EnableAllocationTracking);
+  }
+
+  static void UpdateSampledStats(ezAllocatorId allocatorId, AllocatorData& data)
+  {
+    if (!IsSampling(data.m_Flags) || allocatorId.m_InstanceIndex >= s_uiMaxSampledAllocators)
+      return;
+
+    const SampledAllocatorCounters& counters = s_SampledAllocatorCounters[allocatorId.m_InstanceIndex];
+    data.m_Stats.m_uiNumAllocations = ezAtomicUtils::Read(counters.m_iNumAllocations);
+    data.m_Stats.m_uiNumDeallocations = ezAtomicUtils::Read(counters.m_iNumDeallocations);
+    data.m_Stats.m_uiPerFrameAllocationSize = ezAtomicUtils::Read(counters.m_iPerFrameAllocationSize);
+    data.m_Stats.m_uiAllocationSize = data.m_uiSampledLiveSize;
+  }
+
+  static ezStringBuilder* s_pResolvedStackTrace = nullptr;
+
+  static void AppendResolvedStackFrame(const char* szText)
+  {
+    ezStringBuilder sFrame(szText, s_pTrackerDataAllocator);
+    sFrame.Trim(" \r\n");
+
+    // absolute addresses differ between runs, only keep the module relative part
+    if (sFrame.EndsWith("]"))
+    {
+      if (const char* szAddress = sFrame.FindLastSubString(" ["))
+      {
+        sFrame.Shrink(0, ezStringUtils::GetCharacterCount(szAddress));
+      }
+    }
+
+    s_pResolvedStackTrace->Append("  ", sFrame, "\n");
+  }
+
   static void DumpLeak(const ezMemoryTracker::AllocationInfo& info, const char* szAllocatorName)
   {
     char szBuffer[512];
@@ -161,6 +653,20 @@ ezAllocatorId ezMemoryTracker::RegisterAllocator(const char* szName, ezBitflags<
     s_pTrackerData->m_StaticAllocatorId = id;
   }
 
+  if (IsSampling(flags))
+  {
+    EZ_ASSERT_DEV(id.m_InstanceIndex < s_uiMaxSampledAllocators, "Too many allocators sample their allocations, increase s_uiMaxSampledAllocators");
+
+    if (id.m_InstanceIndex < s_uiMaxSampledAllocators)
+    {
+      SampledAllocatorCounters& counters = s_SampledAllocatorCounters[id.m_InstanceIndex];
+      ezAtomicUtils::Set(counters.m_iNumAllocations, 0);
+      ezAtomicUtils::Set(counters.m_iNumDeallocations, 0);
+      ezAtomicUtils::Set(counters.m_iPerFrameAllocationSize, 0);
+      counters.m_uiAllocatorId = id.m_Data;
+    }
+  }
+
   return id;
 }
 
@@ -182,6 +688,25 @@ void ezMemoryTracker::DeregisterAllocator(ezAllocatorId allocatorId)
     EZ_REPORT_FAILURE("Allocator '{0}' leaked {1} allocation(s)", data.m_sName.GetData(), uiLiveAllocations);
   }
 
+  if (IsSampling(data.m_Flags))
+  {
+    MergeSamples();
+    RemoveAllSamples(allocatorId);
+
+    for (auto it = s_pTrackerData->m_AllocationSites.GetIterator(); it.IsValid();)
+    {
+      if (it.Value().m_AllocatorId == allocatorId)
+        it = s_pTrackerData->m_AllocationSites.Remove(it);
+      else
+        ++it;
+    }
+
+    if (allocatorId.m_InstanceIndex < s_uiMaxSampledAllocators)
+    {
+      s_SampledAllocatorCounters[allocatorId.m_InstanceIndex].m_uiAllocatorId = ezAllocatorId().m_Data;
+    }
+  }
+
   s_pTrackerData->m_AllocatorData.Remove(allocatorId);
 }
 
@@ -246,11 +771,63 @@ void ezMemoryTracker::RemoveAllocation(ezAllocatorId allocatorId, const void* pt
   EZ_DELETE_ARRAY(s_pTrackerDataAllocator, stackTrace);
 }
 
+// static
+void ezMemoryTracker::SampleAllocation(ezAllocatorId allocatorId, const void* ptr, size_t uiSize)
+{
+  ThreadSamplingState& state = tl_SamplingState;
+
+  CountSampledAllocation(state, allocatorId, 1, 0, uiSize);
+
+  state.m_iBytesUntilSample -= uiSize;
+  if (state.m_iBytesUntilSample > 0)
+    return;
+
+  RecordSample(state, allocatorId, ptr, uiSize);
+}
+
+// static
+void ezMemoryTracker::SampleDeallocation(ezAllocatorId allocatorId, const void* ptr)
+{
+  ThreadSamplingState& state = tl_SamplingState;
+
+  CountSampledAllocation(state, allocatorId, 0, 1, 0);
+
+  if (ezAtomicUtils::Read(GetLiveSampleBucket(ptr)) == 0)
+    return;
+
+  SampleEvent* pEvent = BeginSampleEvent(state);
+  if (pEvent == nullptr)
+    return;
+
+  pEvent->m_pPtr = ptr;
+  pEvent->m_AllocatorId = allocatorId;
+  pEvent->m_uiSize = 0;
+  pEvent->m_uiWeight = 0;
+  pEvent->m_uiStackTraceLength = 0;
+
+  EndSampleEvent(state);
+}
+
 // static
 void ezMemoryTracker::RemoveAllAllocations(ezAllocatorId allocatorId)
 {
   EZ_LOCK(*s_pTrackerData);
   AllocatorData& data = s_pTrackerData->m_AllocatorData[allocatorId];
+
+  if (IsSampling(data.m_Flags))
+  {
+    MergeSamples();
+    RemoveAllSamples(allocatorId);
+
+    if (allocatorId.m_InstanceIndex < s_uiMaxSampledAllocators)
+    {
+      SampledAllocatorCounters& counters = s_SampledAllocatorCounters[allocatorId.m_InstanceIndex];
+      ezAtomicUtils::Set(counters.m_iNumDeallocations, ezAtomicUtils::Read(counters.m_iNumAllocations));
+    }
+
+    return;
+  }
+
   for (auto it = data.m_Allocations.GetIterator(); it.IsValid(); ++it)
   {
     auto& info = it.Value();
@@ -280,6 +857,11 @@ void ezMemoryTracker::ResetPerFrameAllocatorStats()
     AllocatorData& data = it.Value();
     data.m_Stats.m_uiPerFrameAllocationSize = 0;
     data.m_Stats.m_PerFrameAllocationTime.SetZero();
+
+    if (IsSampling(data.m_Flags) && it.Id().m_InstanceIndex < s_uiMaxSampledAllocators)
+    {
+      ezAtomicUtils::Set(s_SampledAllocatorCounters[it.Id().m_InstanceIndex].m_iPerFrameAllocationSize, 0);
+    }
   }
 }
 
@@ -296,7 +878,18 @@ const ezAllocatorBase::Stats& ezMemoryTracker::GetAllocatorStats(ezAllocatorId a
 {
   EZ_LOCK(*s_pTrackerData);
 
-  return s_pTrackerData->m_AllocatorData[allocatorId].m_Stats;
+  AllocatorData& data = s_pTrackerData->m_AllocatorData[allocatorId];
+
+  if (IsSampling(data.m_Flags))
+  {
+    // at least the calling thread's counts are up to date
+    FlushSampledCounts(tl_SamplingState);
+
+    MergeSamples();
+    UpdateSampledStats(allocatorId, data);
+  }
+
+  return data.m_Stats;
 }
 
 // static
@@ -423,9 +1016,115 @@ void ezMemoryTracker::DumpMemoryLeaks()
   }
 }
 
+// static
+void ezMemoryTracker::SetSamplingInterval(ezUInt32 uiBytes)
+{
+  s_uiSamplingInterval = uiBytes;
+
+  // other threads pick up the new interval once their current one ran out
+  ThreadSamplingState& state = tl_SamplingState;
+  if (state.m_uiRandomState != 0)
+  {
+    state.m_iBytesUntilSample = DrawBytesUntilSample(state, uiBytes);
+  }
+}
+
+// static
+ezUInt32 ezMemoryTracker::GetSamplingInterval()
+{
+  return s_uiSamplingInterval;
+}
+
+// static
+ezResult ezMemoryTracker::DumpAllocationSites(const char* szFile)
+{
+  if (s_pTrackerData == nullptr)
+    return EZ_FAILURE;
+
+  ezStringBuilder sOutput(s_pTrackerDataAllocator);
+
+  {
+    EZ_LOCK(*s_pTrackerData);
+
+    MergeSamples();
+
+    // resolving the stack traces may allocate memory as well
+    tl_bInsideSampleMerge = true;
+
+    struct SiteText
+    {
+      SiteText()
+        : m_sStackTrace(s_pTrackerDataAllocator)
+      {
+      }
+
+      const AllocatorData* m_pAllocator = nullptr;
+      const AllocationSite* m_pSite = nullptr;
+      ezStringBuilder m_sStackTrace;
+    };
+
+    ezDynamicArray<SiteText, TrackerDataAllocatorWrapper> sites;
+    sites.Reserve(s_pTrackerData->m_AllocationSites.GetCount());
+
+    for (auto it = s_pTrackerData->m_AllocationSites.GetIterator(); it.IsValid(); ++it)
+    {
+      const AllocationSite& site = it.Value();
+
+      AllocatorData* pData = nullptr;
+      if (!s_pTrackerData->m_AllocatorData.TryGetValue(site.m_AllocatorId, pData))
+        continue;
+
+      SiteText& text = sites.ExpandAndGetRef();
+      text.m_pAllocator = pData;
+      text.m_pSite = &site;
+
+      s_pResolvedStackTrace = &text.m_sStackTrace;
+      ezStackTracer::ResolveStackTrace(ezArrayPtr<void*>(const_cast<void**>(site.m_StackTrace), site.m_uiStackTraceLength), &AppendResolvedStackFrame);
+      s_pResolvedStackTrace = nullptr;
+    }
+
+    // pointers and the order in the hash table differ between runs, the resolved stack traces don't
+    sites.Sort([](const SiteText& a, const SiteText& b) {
+      const ezInt32 iNameCmp = a.m_pAllocator->m_sName.Compare(b.m_pAllocator->m_sName);
+      return iNameCmp != 0 ? iNameCmp < 0 : a.m_sStackTrace.Compare(b.m_sStackTrace) < 0;
+    });
+
+    sOutput.AppendFormat("# Sampled allocation sites, sampling interval {0} bytes, sizes are estimates\n\n", s_uiSamplingInterval);
+
+    for (const SiteText& text : sites)
+    {
+      const AllocationSite& site = *text.m_pSite;
+
+      sOutput.AppendFormat("'{0}': {1} live bytes in {2} samples, {3} total bytes in {4} samples\n", text.m_pAllocator->m_sName.GetData(),
+        site.m_uiLiveSize, site.m_uiNumLiveSamples, site.m_uiTotalSize, site.m_uiNumTotalSamples);
+      sOutput.Append(text.m_sStackTrace, "\n");
+    }
+
+    tl_bInsideSampleMerge = false;
+  }
+
+  ezOSFile file;
+  if (file.Open(szFile, ezFileOpenMode::Write).Failed())
+    return EZ_FAILURE;
+
+  return file.Write(sOutput.GetData(), sOutput.GetElementCount());
+}
+
 // static
 ezMemoryTracker::Iterator ezMemoryTracker::GetIterator()
 {
+  {
+    EZ_LOCK(*s_pTrackerData);
+
+    FlushSampledCounts(tl_SamplingState);
+    MergeSamples();
+
+    for (auto it = s_pTrackerData->m_AllocatorData.GetIterator(); it.IsValid(); ++it)
+    {
+      UpdateSampledStats(it.Id(), it.Value());
+    }
+  }
+
   auto pInnerIt = EZ_NEW(s_pTrackerDataAllocator, TrackerData::AllocatorTable::Iterator, s_pTrackerData->m_AllocatorData.GetIterator());
   return Iterator(pInnerIt);
 }
@@ -4,13 +4,21 @@
 #include <Foundation/Memory/PageAllocator.h>
 #include <Foundation/System/SystemInformation.h>
 
+static ezBitflags<ezMemoryTrackingFlags> GetPageTrackingFlags()
+{
+  // pages are few and large, so they are always tracked individually instead of sampled
+  ezBitflags<ezMemoryTrackingFlags> flags = ezMemoryTrackingFlags::Default;
+  flags.Remove(ezMemoryTrackingFlags::EnableAllocationSampling);
+  return flags;
+}
+
 static ezAllocatorId GetPageAllocatorId()
 {
   static ezAllocatorId id;
 
   if (id.IsInvalidated())
   {
-    id = ezMemoryTracker::RegisterAllocator("Page", ezMemoryTrackingFlags::Default, ezAllocatorId());
+    id = ezMemoryTracker::RegisterAllocator("Page", GetPageTrackingFlags(), ezAllocatorId());
   }
 
   return id;
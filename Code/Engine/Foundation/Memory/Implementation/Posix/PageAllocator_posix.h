@@ -14,7 +14,7 @@ void* ezPageAllocator::AllocatePage(size_t uiSize)
 
   EZ_CHECK_ALIGNMENT(ptr, uiAlign);
 
-  ezMemoryTracker::AddAllocation(GetPageAllocatorId(), ezMemoryTrackingFlags::Default, ptr, uiSize, uiAlign, ezTime::Now() - fAllocationTime);
+  ezMemoryTracker::AddAllocation(GetPageAllocatorId(), GetPageTrackingFlags(), ptr, uiSize, uiAlign, ezTime::Now() - fAllocationTime);
 
   return ptr;
 }
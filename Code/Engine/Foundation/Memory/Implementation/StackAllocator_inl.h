@@ -73,6 +73,10 @@ void ezStackAllocator<TrackingFlags>::Reset()
   {
     ezMemoryTracker::RemoveAllAllocations(this->m_Id);
   }
+  else if ((TrackingFlags & ezMemoryTrackingFlags::EnableAllocationSampling) != 0)
+  {
+    ezMemoryTracker::RemoveAllAllocations(this->m_Id);
+  }
   else if ((TrackingFlags & ezMemoryTrackingFlags::RegisterAllocator) != 0)
   {
     ezAllocatorBase::Stats stats;
@@ -14,8 +14,9 @@ struct ezMemoryTrackingFlags
     RegisterAllocator = EZ_BIT(0), ///< Register the allocator with the memory tracker. If EnableAllocationTracking is not set as well it is up to the allocator implementation whether it collects usable stats or not.
     EnableAllocationTracking = EZ_BIT(1), ///< Enable tracking of individual allocations
     EnableStackTrace = EZ_BIT(2), ///< Enable stack traces for each allocation
+    EnableAllocationSampling = EZ_BIT(3), ///< Only track a random sample of the allocations, see ezMemoryTracker::SetSamplingInterval(). Ignored if EnableAllocationTracking is set as well.
 
-    All = RegisterAllocator | EnableAllocationTracking | EnableStackTrace,
+    All = RegisterAllocator | EnableAllocationTracking | EnableStackTrace | EnableAllocationSampling,
 
     Default = 0
 #if EZ_ENABLED(EZ_USE_ALLOCATION_TRACKING)
@@ -23,6 +24,9 @@ struct ezMemoryTrackingFlags
 #endif
 #if EZ_ENABLED(EZ_USE_ALLOCATION_STACK_TRACING)
               | EnableStackTrace
+#endif
+#if EZ_ENABLED(EZ_USE_ALLOCATION_SAMPLING)
+              | RegisterAllocator | EnableAllocationSampling
 #endif
   };
 
@@ -31,6 +35,7 @@ struct ezMemoryTrackingFlags
     StorageType RegisterAllocator : 1;
     StorageType EnableAllocationTracking : 1;
     StorageType EnableStackTrace : 1;
+    StorageType EnableAllocationSampling : 1;
   };
 };
 
@@ -39,6 +44,12 @@ struct ezMemoryTrackingFlags
 #define EZ_STATIC_ALLOCATOR_NAME "Statics"
 
 /// \brief Memory tracker which keeps track of all allocations and constructions
+///
+/// Allocators with ezMemoryTrackingFlags::EnableAllocationTracking record every single allocation, which is precise but expensive.
+/// Allocators with ezMemoryTrackingFlags::EnableAllocationSampling only count their allocations and record roughly one allocation
+/// per sampling interval bytes, where larger allocations are more likely to get sampled. The samples are weighted with the amount of
+/// memory they stand for, which gives an unbiased estimate of the live memory per allocator and per allocation site.
+/// The samples are collected in per-thread buffers and only merged when the data is queried or a buffer is full.
 class EZ_FOUNDATION_DLL ezMemoryTracker
 {
 public:
@@ -106,6 +117,13 @@ public:
   static void AddAllocation(ezAllocatorId allocatorId, ezBitflags<ezMemoryTrackingFlags> flags, const void* ptr, size_t uiSize, size_t uiAlign,
     ezTime allocationTime);
   static void RemoveAllocation(ezAllocatorId allocatorId, const void* ptr);
+
+  /// \brief Counts the allocation and records it if it gets sampled. Used by allocators with ezMemoryTrackingFlags::EnableAllocationSampling.
+  static void SampleAllocation(ezAllocatorId allocatorId, const void* ptr, size_t uiSize);
+
+  /// \brief Counts the deallocation and removes the allocation from the samples, if it was sampled.
+  static void SampleDeallocation(ezAllocatorId allocatorId, const void* ptr);
+
   static void RemoveAllAllocations(ezAllocatorId allocatorId);
   static void SetAllocatorStats(ezAllocatorId allocatorId, const ezAllocatorBase::Stats& stats);
 
@@ -118,6 +136,17 @@ public:
 
   static void DumpMemoryLeaks();
 
+  /// \brief Sets after how many allocated bytes on average an allocation gets sampled. Zero disables sampling, allocations are still counted.
+  ///
+  /// Other threads than the calling one use the new interval after their current one ran out.
+  static void SetSamplingInterval(ezUInt32 uiBytes);
+  static ezUInt32 GetSamplingInterval();
+
+  /// \brief Writes the estimated live and total memory of all sampled allocation sites to a text file.
+  ///
+  /// The sites are sorted by allocator name and call stack, such that the files of two runs can be compared with a diff tool.
+  static ezResult DumpAllocationSites(const char* szFile);
+
   static Iterator GetIterator();
 };
 
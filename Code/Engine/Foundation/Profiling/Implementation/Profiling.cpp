@@ -3,11 +3,15 @@
 #include <Foundation/Communication/DataTransfer.h>
 #include <Foundation/Configuration/CVar.h>
 #include <Foundation/Configuration/Startup.h>
-#include <Foundation/Containers/IdTable.h>
-#include <Foundation/Containers/StaticRingBuffer.h>
+#include <Foundation/Containers/HashSet.h>
+#include <Foundation/Containers/HashTable.h>
 #include <Foundation/IO/JSONWriter.h>
+#include <Foundation/IO/OSFile.h>
 #include <Foundation/Memory/CommonAllocators.h>
 #include <Foundation/Profiling/Profiling.h>
+#include <Foundation/Threading/AtomicUtils.h>
+#include <Foundation/Threading/Thread.h>
+#include <Foundation/Threading/ThreadSignal.h>
 #include <Foundation/Threading/ThreadUtils.h>
 
 #if EZ_ENABLED(EZ_USE_PROFILING)
@@ -42,6 +46,7 @@ EZ_BEGIN_SUBSYSTEM_DECLARATION(Foundation, ProfilingSystem)
   ON_CORESYSTEMS_SHUTDOWN
   {
     s_ProfileCaptureDataTransfer.DisableDataTransfer();
+    ezProfilingSystem::StopRecording();
     ezProfilingSystem::Reset();
   }
 
@@ -61,7 +66,75 @@ namespace
     BUFFER_SIZE_FRAMES = 120 * 60,
   };
 
-  typedef ezStaticRingBuffer<ezProfilingSystem::GPUScope, BUFFER_SIZE_OTHER_THREAD / sizeof(ezProfilingSystem::GPUScope)> GPUScopesBuffer;
+  enum
+  {
+    RECORDING_FLUSH_INTERVAL_MS = 100, ///< At this interval the recording thread writes the new scopes to disk, the thread buffers hold a lot more than that
+  };
+
+  /// \brief A ring buffer that only one thread adds to, while other threads read from it without a lock.
+  ///
+  /// Elements are addressed by the number of elements that were added before them. Readers compare that number before and after
+  /// copying elements, to detect the ones that the writing thread has overwritten in the meantime.
+  template <typename T, ezUInt32 Capacity>
+  struct SingleWriterRingBuffer
+  {
+    void Add(const T& element)
+    {
+      // only this thread ever modifies m_iNumAdded
+      const ezInt64 iIndex = m_iNumAdded;
+      m_Data[iIndex % Capacity] = element;
+      ezAtomicUtils::Set(m_iNumAdded, iIndex + 1);
+    }
+
+    ezUInt64 GetNumAdded() const { return static_cast<ezUInt64>(ezAtomicUtils::Read(m_iNumAdded)); }
+
+    /// \brief Discards all elements that were added so far.
+    void Clear() { ezAtomicUtils::Set(m_iFirstValid, ezAtomicUtils::Read(m_iNumAdded)); }
+
+    /// \brief Appends all elements from index uiFirst on that are still available to out_Elements.
+    ///
+    /// Returns the index of the next element, to continue reading from. The number of elements that were discarded or overwritten
+    /// before they could be read is added to inout_uiNumLost.
+    ezUInt64 Read(ezUInt64 uiFirst, ezDynamicArray<T>& out_Elements, ezUInt64& inout_uiNumLost) const
+    {
+      const ezUInt64 uiEnd = GetNumAdded();
+      const ezUInt64 uiFirstValid = static_cast<ezUInt64>(ezAtomicUtils::Read(m_iFirstValid));
+
+      ezUInt64 uiStart = ezMath::Max(uiFirst, uiFirstValid);
+      if (uiEnd > Capacity)
+      {
+        uiStart = ezMath::Max(uiStart, uiEnd - Capacity);
+      }
+
+      if (uiStart >= uiEnd)
+        return uiEnd;
+
+      const ezUInt32 uiFirstOut = out_Elements.GetCount();
+      out_Elements.Reserve(uiFirstOut + static_cast<ezUInt32>(uiEnd - uiStart));
+      for (ezUInt64 i = uiStart; i < uiEnd; ++i)
+      {
+        out_Elements.PushBack(m_Data[i % Capacity]);
+      }
+
+      // the writer may have overwritten the oldest elements while they were copied, including the one it is writing right now
+      const ezUInt64 uiWriteLimit = GetNumAdded() + 1;
+      if (uiWriteLimit > uiStart + Capacity)
+      {
+        const ezUInt64 uiNumOverwritten = ezMath::Min(uiWriteLimit - Capacity - uiStart, uiEnd - uiStart);
+        out_Elements.RemoveAtAndCopy(uiFirstOut, static_cast<ezUInt32>(uiNumOverwritten));
+        uiStart += uiNumOverwritten;
+      }
+
+      inout_uiNumLost += uiStart - ezMath::Max(uiFirst, uiFirstValid);
+      return uiEnd;
+    }
+
+    T m_Data[Capacity];
+    volatile ezInt64 m_iNumAdded = 0;
+    volatile ezInt64 m_iFirstValid = 0;
+  };
+
+  typedef SingleWriterRingBuffer<ezProfilingSystem::GPUScope, BUFFER_SIZE_OTHER_THREAD / sizeof(ezProfilingSystem::GPUScope)> GPUScopesBuffer;
 
   static ezUInt64 s_MainThreadId = 0;
 
@@ -69,17 +142,31 @@ namespace
   {
     virtual ~CpuScopesBufferBase() = default;
 
+    virtual ezUInt64 GetNumAdded() const = 0;
+    virtual void Clear() = 0;
+    virtual ezUInt64 Read(ezUInt64 uiFirst, ezDynamicArray<ezProfilingSystem::CPUScope>& out_Scopes, ezUInt64& inout_uiNumLost) const = 0;
+
     ezUInt64 m_uiThreadId = 0;
     bool IsMainThread() const
     {
       return m_uiThreadId == s_MainThreadId;
     }
+
+    // the index of the first scope that the current recording has not written yet, only accessed with s_AllCpuScopesMutex locked
+    ezUInt64 m_uiNextScopeToRecord = 0;
   };
 
   template <ezUInt32 SizeInBytes>
   struct CpuScopesBuffer : public CpuScopesBufferBase
   {
-    ezStaticRingBuffer<ezProfilingSystem::CPUScope, SizeInBytes / sizeof(ezProfilingSystem::CPUScope)> m_Data;
+    virtual ezUInt64 GetNumAdded() const override { return m_Data.GetNumAdded(); }
+    virtual void Clear() override { m_Data.Clear(); }
+    virtual ezUInt64 Read(ezUInt64 uiFirst, ezDynamicArray<ezProfilingSystem::CPUScope>& out_Scopes, ezUInt64& inout_uiNumLost) const override
+    {
+      return m_Data.Read(uiFirst, out_Scopes, inout_uiNumLost);
+    }
+
+    SingleWriterRingBuffer<ezProfilingSystem::CPUScope, SizeInBytes / sizeof(ezProfilingSystem::CPUScope)> m_Data;
   };
 
   CpuScopesBuffer<BUFFER_SIZE_MAIN_THREAD>* CastToMainThreadEventBuffer(CpuScopesBufferBase* pEventBuffer)
@@ -96,8 +183,8 @@ namespace
 
   ezCVarFloat CVarDiscardThresholdMs("g_ProfilingDiscardThresholdMs", 0.1f, ezCVarFlags::Default, "Discard profiling scopes if their duration is shorter than the specified threshold.");
 
-  ezStaticRingBuffer<ezTime, BUFFER_SIZE_FRAMES> s_FrameStartTimes;
-  ezUInt64 s_uiFrameCount = 0;
+  // the number of added frames is the frame count
+  SingleWriterRingBuffer<ezTime, BUFFER_SIZE_FRAMES> s_FrameStartTimes;
 
   static ezHybridArray<ezProfilingSystem::ThreadInfo, 16> s_ThreadInfos;
   static ezHybridArray<ezUInt64, 16> s_DeadThreadIDs;
@@ -124,6 +211,409 @@ namespace
       ezProfilingSystem::Clear();
     }
   }
+
+  ezOsProcessID GetCurrentProcessID()
+  {
+#  if EZ_ENABLED(EZ_SUPPORTS_PROCESSES)
+    return ezProcess::GetCurrentProcessID();
+#  else
+    return 0;
+#  endif
+  }
+
+  void WriteThreadMetadata(ezStandardJSONWriter& writer, ezUInt32 uiProcessID, ezUInt64 uiThreadID, const char* szName)
+  {
+    writer.BeginObject();
+    writer.AddVariableString("name", "thread_name");
+    writer.AddVariableString("cat", "__metadata");
+    writer.AddVariableUInt32("pid", uiProcessID);
+    writer.AddVariableUInt64("tid", uiThreadID);
+    writer.AddVariableString("ph", "M");
+
+    writer.BeginObject("args");
+    writer.AddVariableString("name", szName);
+    writer.EndObject();
+
+    writer.EndObject();
+  }
+
+  void WriteThreadSortIndex(ezStandardJSONWriter& writer, ezUInt32 uiProcessID, ezUInt64 uiThreadID, ezInt32 iSortIndex)
+  {
+    writer.BeginObject();
+    writer.AddVariableString("name", "thread_sort_index");
+    writer.AddVariableString("cat", "__metadata");
+    writer.AddVariableUInt32("pid", uiProcessID);
+    writer.AddVariableUInt64("tid", uiThreadID);
+    writer.AddVariableString("ph", "M");
+
+    writer.BeginObject("args");
+    writer.AddVariableInt32("sort_index", iSortIndex);
+    writer.EndObject();
+
+    writer.EndObject();
+  }
+
+  //////////////////////////////////////////////////////////////////////////
+  // Binary capture format
+  //
+  // A header (magic, version, process ID) followed by chunks. Every chunk starts with its type (1 byte) and payload size (4 bytes),
+  // such that readers can skip unknown chunks. Inside the payloads all integers are variable length encoded (7 bits per byte),
+  // signed ones with zigzag encoding, and all times are in nanoseconds.
+  //
+  // Strings are only stored once, in a strings chunk that precedes the first chunk referencing them, and afterwards referenced
+  // by their index. CPU scopes are stored in one chunk per thread, with their begin times encoded as the delta to the previous scope.
+
+  static constexpr char s_BinaryCaptureMagic[8] = {'E', 'Z', 'P', 'R', 'O', 'F', 'I', 'L'};
+  static constexpr ezUInt32 s_uiBinaryCaptureVersion = 1;
+
+  struct BinaryChunkType
+  {
+    enum Enum : ezUInt8
+    {
+      Strings = 1,    ///< count, then per string: length, characters
+      ThreadInfo = 2, ///< thread ID, name string index
+      CPUScopes = 3,  ///< thread ID, count, then per scope: name string index, function string index + 1 (or 0), begin time delta, duration
+      Frames = 4,     ///< number of the first frame, count, then per frame: start time delta
+      GPUScopes = 5,  ///< count, then per scope: name string index, begin time delta, duration
+    };
+  };
+
+  void AppendVarUInt(ezDynamicArray<ezUInt8>& inout_Data, ezUInt64 uiValue)
+  {
+    while (uiValue >= 0x80)
+    {
+      inout_Data.PushBack(static_cast<ezUInt8>(uiValue | 0x80));
+      uiValue >>= 7;
+    }
+
+    inout_Data.PushBack(static_cast<ezUInt8>(uiValue));
+  }
+
+  void AppendVarInt(ezDynamicArray<ezUInt8>& inout_Data, ezInt64 iValue)
+  {
+    AppendVarUInt(inout_Data, (static_cast<ezUInt64>(iValue) << 1) ^ static_cast<ezUInt64>(iValue >> 63));
+  }
+
+  ezInt64 ToNanoseconds(ezTime t)
+  {
+    return static_cast<ezInt64>(t.GetNanoseconds());
+  }
+
+  class BinaryCaptureWriter
+  {
+  public:
+    void WriteHeader(ezOsProcessID processID)
+    {
+      m_Header.PushBackRange(ezArrayPtr<const ezUInt8>(reinterpret_cast<const ezUInt8*>(s_BinaryCaptureMagic), EZ_ARRAY_SIZE(s_BinaryCaptureMagic)));
+      AppendFixed(m_Header, s_uiBinaryCaptureVersion);
+      AppendFixed(m_Header, static_cast<ezUInt64>(processID));
+    }
+
+    void AddThreadInfo(ezUInt64 uiThreadId, const char* szName)
+    {
+      m_Payload.Clear();
+      AppendVarUInt(m_Payload, uiThreadId);
+      AppendVarUInt(m_Payload, GetStringIndex(szName));
+      AppendChunk(BinaryChunkType::ThreadInfo);
+    }
+
+    void AddCPUScopes(ezUInt64 uiThreadId, ezArrayPtr<const ezProfilingSystem::CPUScope> scopes)
+    {
+      m_Payload.Clear();
+      AppendVarUInt(m_Payload, uiThreadId);
+      AppendVarUInt(m_Payload, scopes.GetCount());
+
+      ezInt64 iPrevBegin = 0;
+      for (const ezProfilingSystem::CPUScope& scope : scopes)
+      {
+        const ezInt64 iBegin = ToNanoseconds(scope.m_BeginTime);
+
+        AppendVarUInt(m_Payload, GetStringIndex(scope.m_szName));
+        AppendVarUInt(m_Payload, scope.m_szFunctionName != nullptr ? GetStringIndex(scope.m_szFunctionName) + 1 : 0);
+        AppendVarInt(m_Payload, iBegin - iPrevBegin);
+        AppendVarUInt(m_Payload, static_cast<ezUInt64>(ezMath::Max<ezInt64>(ToNanoseconds(scope.m_EndTime) - iBegin, 0)));
+
+        iPrevBegin = iBegin;
+      }
+
+      AppendChunk(BinaryChunkType::CPUScopes);
+    }
+
+    void AddFrames(ezUInt64 uiFirstFrame, ezArrayPtr<const ezTime> frameStartTimes)
+    {
+      m_Payload.Clear();
+      AppendVarUInt(m_Payload, uiFirstFrame);
+      AppendVarUInt(m_Payload, frameStartTimes.GetCount());
+
+      ezInt64 iPrevStart = 0;
+      for (ezTime startTime : frameStartTimes)
+      {
+        const ezInt64 iStart = ToNanoseconds(startTime);
+        AppendVarInt(m_Payload, iStart - iPrevStart);
+        iPrevStart = iStart;
+      }
+
+      AppendChunk(BinaryChunkType::Frames);
+    }
+
+    void AddGPUScopes(ezArrayPtr<const ezProfilingSystem::GPUScope> scopes)
+    {
+      m_Payload.Clear();
+      AppendVarUInt(m_Payload, scopes.GetCount());
+
+      ezInt64 iPrevBegin = 0;
+      for (const ezProfilingSystem::GPUScope& scope : scopes)
+      {
+        const ezInt64 iBegin = ToNanoseconds(scope.m_BeginTime);
+
+        AppendVarUInt(m_Payload, GetStringIndex(scope.m_szName));
+        AppendVarInt(m_Payload, iBegin - iPrevBegin);
+        AppendVarUInt(m_Payload, static_cast<ezUInt64>(ezMath::Max<ezInt64>(ToNanoseconds(scope.m_EndTime) - iBegin, 0)));
+
+        iPrevBegin = iBegin;
+      }
+
+      AppendChunk(BinaryChunkType::GPUScopes);
+    }
+
+    /// \brief Moves everything that was added since the last call into out_Data, the strings chunk first since the other chunks reference it.
+    void TakePendingData(ezDynamicArray<ezUInt8>& out_Data)
+    {
+      out_Data = m_Header;
+      m_Header.Clear();
+
+      if (m_uiNumNewStrings > 0)
+      {
+        m_Payload.Clear();
+        AppendVarUInt(m_Payload, m_uiNumNewStrings);
+        m_Payload.PushBackRange(m_NewStrings);
+
+        out_Data.PushBack(BinaryChunkType::Strings);
+        AppendFixed(out_Data, m_Payload.GetCount());
+        out_Data.PushBackRange(m_Payload);
+
+        m_NewStrings.Clear();
+        m_uiNumNewStrings = 0;
+      }
+
+      out_Data.PushBackRange(m_Chunks);
+      m_Chunks.Clear();
+    }
+
+  private:
+    template <typename T>
+    static void AppendFixed(ezDynamicArray<ezUInt8>& inout_Data, T value)
+    {
+      inout_Data.PushBackRange(ezArrayPtr<const ezUInt8>(reinterpret_cast<const ezUInt8*>(&value), sizeof(T)));
+    }
+
+    void AppendChunk(BinaryChunkType::Enum type)
+    {
+      m_Chunks.PushBack(type);
+      AppendFixed(m_Chunks, m_Payload.GetCount());
+      m_Chunks.PushBackRange(m_Payload);
+    }
+
+    ezUInt32 GetStringIndex(const char* szString)
+    {
+      ezUInt32 uiIndex = 0;
+      if (m_StringIndices.TryGetValue(szString, uiIndex))
+        return uiIndex;
+
+      uiIndex = m_StringIndices.GetCount();
+      m_StringIndices.Insert(szString, uiIndex);
+
+      const ezUInt32 uiLength = ezStringUtils::GetStringElementCount(szString);
+      AppendVarUInt(m_NewStrings, uiLength);
+      m_NewStrings.PushBackRange(ezArrayPtr<const ezUInt8>(reinterpret_cast<const ezUInt8*>(szString), uiLength));
+      ++m_uiNumNewStrings;
+
+      return uiIndex;
+    }
+
+    ezHashTable<ezString, ezUInt32> m_StringIndices;
+    ezDynamicArray<ezUInt8> m_NewStrings;
+    ezUInt32 m_uiNumNewStrings = 0;
+
+    ezDynamicArray<ezUInt8> m_Header;
+    ezDynamicArray<ezUInt8> m_Payload;
+    ezDynamicArray<ezUInt8> m_Chunks;
+  };
+
+  struct BinaryChunkReader
+  {
+    ezUInt64 ReadVarUInt()
+    {
+      ezUInt64 uiValue = 0;
+      for (ezUInt32 uiShift = 0; uiShift < 64 && m_pCur < m_pEnd; uiShift += 7)
+      {
+        const ezUInt8 uiByte = *m_pCur++;
+        uiValue |= static_cast<ezUInt64>(uiByte & 0x7F) << uiShift;
+
+        if ((uiByte & 0x80) == 0)
+          return uiValue;
+      }
+
+      m_bError = true;
+      return 0;
+    }
+
+    ezInt64 ReadVarInt()
+    {
+      const ezUInt64 uiValue = ReadVarUInt();
+      return static_cast<ezInt64>(uiValue >> 1) ^ -static_cast<ezInt64>(uiValue & 1);
+    }
+
+    void ReadString(ezStringBuilder& out_sString)
+    {
+      const ezUInt64 uiLength = ReadVarUInt();
+      if (uiLength > static_cast<ezUInt64>(m_pEnd - m_pCur))
+      {
+        m_bError = true;
+        return;
+      }
+
+      out_sString.SetSubString_ElementCount(reinterpret_cast<const char*>(m_pCur), static_cast<ezUInt32>(uiLength));
+      m_pCur += uiLength;
+    }
+
+    const char* ReadStringIndex(const ezDynamicArray<ezString>& strings)
+    {
+      const ezUInt64 uiIndex = ReadVarUInt();
+      if (uiIndex >= strings.GetCount())
+      {
+        m_bError = true;
+        return "";
+      }
+
+      return strings[static_cast<ezUInt32>(uiIndex)];
+    }
+
+    const ezUInt8* m_pCur = nullptr;
+    const ezUInt8* m_pEnd = nullptr;
+    bool m_bError = false;
+  };
+
+  /// \brief Streams all new profiling data to a file, see ezProfilingSystem::StartRecording().
+  class RecordingThread : public ezThread
+  {
+  public:
+    RecordingThread()
+      : ezThread("Profiling Recording")
+    {
+    }
+
+    void Begin()
+    {
+      m_Writer.WriteHeader(GetCurrentProcessID());
+
+      // only data from now on is recorded
+      {
+        EZ_LOCK(s_AllCpuScopesMutex);
+        for (CpuScopesBufferBase* pEventBuffer : s_AllCpuScopes)
+        {
+          pEventBuffer->m_uiNextScopeToRecord = pEventBuffer->GetNumAdded();
+        }
+      }
+
+      m_uiNextFrame = s_FrameStartTimes.GetNumAdded();
+      m_uiNextGPUScope = s_GPUScopes != nullptr ? s_GPUScopes->GetNumAdded() : 0;
+    }
+
+    void Flush()
+    {
+      {
+        EZ_LOCK(s_ThreadInfosMutex);
+        for (const ezProfilingSystem::ThreadInfo& info : s_ThreadInfos)
+        {
+          if (!m_RecordedThreads.Contains(info.m_uiThreadId))
+          {
+            m_RecordedThreads.Insert(info.m_uiThreadId);
+            m_Writer.AddThreadInfo(info.m_uiThreadId, info.m_sName);
+          }
+        }
+      }
+
+      {
+        // the scopes are encoded while the lock is held, since their function names become invalid when a plugin is unloaded
+        EZ_LOCK(s_AllCpuScopesMutex);
+        for (CpuScopesBufferBase* pEventBuffer : s_AllCpuScopes)
+        {
+          m_Scopes.Clear();
+          pEventBuffer->m_uiNextScopeToRecord = pEventBuffer->Read(pEventBuffer->m_uiNextScopeToRecord, m_Scopes, m_uiNumLostScopes);
+
+          if (!m_Scopes.IsEmpty())
+          {
+            m_Writer.AddCPUScopes(pEventBuffer->m_uiThreadId, m_Scopes);
+          }
+        }
+      }
+
+      {
+        m_Frames.Clear();
+        m_uiNextFrame = s_FrameStartTimes.Read(m_uiNextFrame, m_Frames, m_uiNumLostFrames);
+
+        if (!m_Frames.IsEmpty())
+        {
+          m_Writer.AddFrames(m_uiNextFrame - m_Frames.GetCount() + 1, m_Frames);
+        }
+      }
+
+      if (s_GPUScopes != nullptr)
+      {
+        m_GPUScopes.Clear();
+        m_uiNextGPUScope = s_GPUScopes->Read(m_uiNextGPUScope, m_GPUScopes, m_uiNumLostGPUScopes);
+
+        if (!m_GPUScopes.IsEmpty())
+        {
+          m_Writer.AddGPUScopes(m_GPUScopes);
+        }
+      }
+
+      m_Writer.TakePendingData(m_Data);
+
+      if (!m_Data.IsEmpty() && !m_bWriteFailed && m_File.Write(m_Data.GetData(), m_Data.GetCount()).Failed())
+      {
+        ezLog::Error("Failed to write to the profiling recording '{0}'.", m_File.GetOpenFileName());
+        m_bWriteFailed = true;
+      }
+    }
+
+    ezOSFile m_File;
+    ezThreadSignal m_WakeUp;
+    volatile bool m_bStop = false;
+    ezUInt64 m_uiNumLostScopes = 0;
+    ezUInt64 m_uiNumLostFrames = 0;
+    ezUInt64 m_uiNumLostGPUScopes = 0;
+
+  private:
+    virtual ezUInt32 Run() override
+    {
+      while (true)
+      {
+        m_WakeUp.WaitForSignal(ezTime::Milliseconds(RECORDING_FLUSH_INTERVAL_MS));
+
+        Flush();
+
+        if (m_bStop)
+          return 0;
+      }
+    }
+
+    BinaryCaptureWriter m_Writer;
+    ezHashSet<ezUInt64> m_RecordedThreads;
+    ezUInt64 m_uiNextFrame = 0;
+    ezUInt64 m_uiNextGPUScope = 0;
+    bool m_bWriteFailed = false;
+
+    ezDynamicArray<ezProfilingSystem::CPUScope> m_Scopes;
+    ezDynamicArray<ezTime> m_Frames;
+    ezDynamicArray<ezProfilingSystem::GPUScope> m_GPUScopes;
+    ezDynamicArray<ezUInt8> m_Data;
+  };
+
+  static RecordingThread* s_pRecordingThread = nullptr;
+  static ezMutex s_RecordingMutex;
 } // namespace
 
 ezResult ezProfilingSystem::ProfilingData::Write(ezStreamWriter& outputStream) const
@@ -138,31 +628,8 @@ ezResult ezProfilingSystem::ProfilingData::Write(ezStreamWriter& outputStream) c
 
     // Frames thread metadata
     {
-      writer.BeginObject();
-      writer.AddVariableString("name", "thread_name");
-      writer.AddVariableString("cat", "__metadata");
-      writer.AddVariableUInt32("pid", m_uiProcessID);
-      writer.AddVariableUInt64("tid", m_uiFramesThreadID);
-      writer.AddVariableString("ph", "M");
-
-      writer.BeginObject("args");
-      writer.AddVariableString("name", "Frames");
-      writer.EndObject();
-
-      writer.EndObject();
-
-      writer.BeginObject();
-      writer.AddVariableString("name", "thread_sort_index");
-      writer.AddVariableString("cat", "__metadata");
-      writer.AddVariableUInt32("pid", m_uiProcessID);
-      writer.AddVariableUInt64("tid", m_uiFramesThreadID);
-      writer.AddVariableString("ph", "M");
-
-      writer.BeginObject("args");
-      writer.AddVariableInt32("sort_index", -1);
-      writer.EndObject();
-
-      writer.EndObject();
+      WriteThreadMetadata(writer, m_uiProcessID, m_uiFramesThreadID, "Frames");
+      WriteThreadSortIndex(writer, m_uiProcessID, m_uiFramesThreadID, -1);
 
       if (writer.HadWriteError())
       {
@@ -172,31 +639,9 @@ ezResult ezProfilingSystem::ProfilingData::Write(ezStreamWriter& outputStream) c
 
     // GPU thread metadata
     {
-      writer.BeginObject();
-      writer.AddVariableString("name", "thread_name");
-      writer.AddVariableString("cat", "__metadata");
-      writer.AddVariableUInt32("pid", m_uiProcessID);
-      writer.AddVariableUInt64("tid", m_uiGPUThreadID);
-      writer.AddVariableString("ph", "M");
+      WriteThreadMetadata(writer, m_uiProcessID, m_uiGPUThreadID, "GPU");
+      WriteThreadSortIndex(writer, m_uiProcessID, m_uiGPUThreadID, -2);
 
-      writer.BeginObject("args");
-      writer.AddVariableString("name", "GPU");
-      writer.EndObject();
-
-      writer.EndObject();
-
-      writer.BeginObject();
-      writer.AddVariableString("name", "thread_sort_index");
-      writer.AddVariableString("cat", "__metadata");
-      writer.AddVariableUInt32("pid", m_uiProcessID);
-      writer.AddVariableUInt64("tid", m_uiGPUThreadID);
-      writer.AddVariableString("ph", "M");
-
-      writer.BeginObject("args");
-      writer.AddVariableInt32("sort_index", -2);
-      writer.EndObject();
-
-      writer.EndObject();
       if (writer.HadWriteError())
       {
         return EZ_FAILURE;
@@ -207,18 +652,7 @@ ezResult ezProfilingSystem::ProfilingData::Write(ezStreamWriter& outputStream) c
     {
       for (const ThreadInfo& info : m_ThreadInfos)
       {
-        writer.BeginObject();
-        writer.AddVariableString("name", "thread_name");
-        writer.AddVariableString("cat", "__metadata");
-        writer.AddVariableUInt32("pid", m_uiProcessID);
-        writer.AddVariableUInt64("tid", info.m_uiThreadId + 2);
-        writer.AddVariableString("ph", "M");
-
-        writer.BeginObject("args");
-        writer.AddVariableString("name", info.m_sName);
-        writer.EndObject();
-
-        writer.EndObject();
+        WriteThreadMetadata(writer, m_uiProcessID, info.m_uiThreadId + 2, info.m_sName);
 
         if (writer.HadWriteError())
         {
@@ -349,6 +783,40 @@ ezResult ezProfilingSystem::ProfilingData::Write(ezStreamWriter& outputStream) c
   return writer.HadWriteError() ? EZ_FAILURE : EZ_SUCCESS;
 }
 
+ezResult ezProfilingSystem::ProfilingData::WriteBinary(ezStreamWriter& outputStream) const
+{
+  BinaryCaptureWriter writer;
+  writer.WriteHeader(m_uiProcessID);
+
+  for (const ThreadInfo& info : m_ThreadInfos)
+  {
+    writer.AddThreadInfo(info.m_uiThreadId, info.m_sName);
+  }
+
+  for (const auto& eventBuffer : m_AllEventBuffers)
+  {
+    if (!eventBuffer.m_Data.IsEmpty())
+    {
+      writer.AddCPUScopes(eventBuffer.m_uiThreadId, eventBuffer.m_Data);
+    }
+  }
+
+  if (!m_FrameStartTimes.IsEmpty())
+  {
+    writer.AddFrames(m_uiFrameCount - m_FrameStartTimes.GetCount() + 1, m_FrameStartTimes);
+  }
+
+  if (!m_GPUScopes.IsEmpty())
+  {
+    writer.AddGPUScopes(m_GPUScopes);
+  }
+
+  ezDynamicArray<ezUInt8> data;
+  writer.TakePendingData(data);
+
+  return outputStream.WriteBytes(data.GetData(), data.GetCount());
+}
+
 // static
 void ezProfilingSystem::Clear()
 {
@@ -356,14 +824,7 @@ void ezProfilingSystem::Clear()
     EZ_LOCK(s_AllCpuScopesMutex);
     for (auto pEventBuffer : s_AllCpuScopes)
     {
-      if (pEventBuffer->IsMainThread())
-      {
-        CastToMainThreadEventBuffer(pEventBuffer)->m_Data.Clear();
-      }
-      else
-      {
-        CastToOtherThreadEventBuffer(pEventBuffer)->m_Data.Clear();
-      }
+      pEventBuffer->Clear();
     }
   }
 
@@ -382,69 +843,36 @@ ezProfilingSystem::ProfilingData ezProfilingSystem::Capture()
 
   profilingData.m_uiFramesThreadID = 1;
   profilingData.m_uiGPUThreadID = 0;
-#  if EZ_ENABLED(EZ_SUPPORTS_PROCESSES)
-  profilingData.m_uiProcessID = ezProcess::GetCurrentProcessID();
-#  else
-  profilingData.m_uiProcessID = 0;
-#  endif
+  profilingData.m_uiProcessID = GetCurrentProcessID();
 
   {
     EZ_LOCK(s_ThreadInfosMutex);
     profilingData.m_ThreadInfos = s_ThreadInfos;
   }
 
+  // the buffers are read without blocking the threads that add scopes to them, so only count how many scopes are lost but don't report it
+  ezUInt64 uiNumLost = 0;
+
   {
     EZ_LOCK(s_AllCpuScopesMutex);
 
     profilingData.m_AllEventBuffers.Reserve(s_AllCpuScopes.GetCount());
     for (ezUInt32 i = 0; i < s_AllCpuScopes.GetCount(); ++i)
     {
-      auto& sourceEventBuffer = s_AllCpuScopes[i];
-      CPUScopesBufferFlat targetEventBuffer;
-
-      targetEventBuffer.m_uiThreadId = sourceEventBuffer->m_uiThreadId;
+      const CpuScopesBufferBase* pSourceEventBuffer = s_AllCpuScopes[i];
 
-      ezUInt32 uiSourceCount = sourceEventBuffer->IsMainThread() ? CastToMainThreadEventBuffer(sourceEventBuffer)->m_Data.GetCount() : CastToOtherThreadEventBuffer(sourceEventBuffer)->m_Data.GetCount();
-      targetEventBuffer.m_Data.Reserve(uiSourceCount);
-      for (ezUInt32 j = 0; j < uiSourceCount; ++j)
-      {
-        const CPUScope& sourceEvent = sourceEventBuffer->IsMainThread() ? CastToMainThreadEventBuffer(sourceEventBuffer)->m_Data[j] : CastToOtherThreadEventBuffer(sourceEventBuffer)->m_Data[j];
+      CPUScopesBufferFlat& targetEventBuffer = profilingData.m_AllEventBuffers.ExpandAndGetRef();
+      targetEventBuffer.m_uiThreadId = pSourceEventBuffer->m_uiThreadId;
 
-        CPUScope copiedEvent;
-        copiedEvent.m_szFunctionName = sourceEvent.m_szFunctionName;
-        copiedEvent.m_BeginTime = sourceEvent.m_BeginTime;
-        copiedEvent.m_EndTime = sourceEvent.m_EndTime;
-        ezStringUtils::Copy(copiedEvent.m_szName, CPUScope::NAME_SIZE, sourceEvent.m_szName);
-
-        targetEventBuffer.m_Data.PushBack(std::move(copiedEvent));
-      }
-
-      profilingData.m_AllEventBuffers.PushBack(std::move(targetEventBuffer));
+      pSourceEventBuffer->Read(0, targetEventBuffer.m_Data, uiNumLost);
     }
   }
 
-  profilingData.m_uiFrameCount = s_uiFrameCount;
-
-  profilingData.m_FrameStartTimes.Reserve(profilingData.m_FrameStartTimes.GetCount());
-  for (ezUInt32 i = 0; i < s_FrameStartTimes.GetCount(); ++i)
-  {
-    profilingData.m_FrameStartTimes.PushBack(s_FrameStartTimes[i]);
-  }
+  profilingData.m_uiFrameCount = s_FrameStartTimes.Read(0, profilingData.m_FrameStartTimes, uiNumLost);
 
   if (s_GPUScopes != nullptr)
   {
-    profilingData.m_GPUScopes.Reserve(s_GPUScopes->GetCount());
-    for (ezUInt32 i = 0; i < s_GPUScopes->GetCount(); ++i)
-    {
-      const GPUScope& sourceGpuDat = (*s_GPUScopes)[i];
-
-      GPUScope copiedGpuData;
-      copiedGpuData.m_BeginTime = sourceGpuDat.m_BeginTime;
-      copiedGpuData.m_EndTime = sourceGpuDat.m_EndTime;
-      ezStringUtils::Copy(copiedGpuData.m_szName, GPUScope::NAME_SIZE, sourceGpuDat.m_szName);
-
-      profilingData.m_GPUScopes.PushBack(std::move(copiedGpuData));
-    }
+    s_GPUScopes->Read(0, profilingData.m_GPUScopes, uiNumLost);
   }
 
   return profilingData;
@@ -459,14 +887,7 @@ void ezProfilingSystem::SetDiscardThreshold(ezTime threshold)
 // static
 void ezProfilingSystem::StartNewFrame()
 {
-  ++s_uiFrameCount;
-
-  if (!s_FrameStartTimes.CanAppend())
-  {
-    s_FrameStartTimes.PopFront();
-  }
-
-  s_FrameStartTimes.PushBack(ezTime::Now());
+  s_FrameStartTimes.Add(ezTime::Now());
 }
 
 // static
@@ -506,24 +927,274 @@ void ezProfilingSystem::AddCPUScope(const char* szName, const char* szFunctionNa
 
   if (ezThreadUtils::IsMainThread())
   {
-    auto pMainThreadBuffer = CastToMainThreadEventBuffer(pScopes);
-    if (!pMainThreadBuffer->m_Data.CanAppend())
+    CastToMainThreadEventBuffer(pScopes)->m_Data.Add(scope);
+  }
+  else
+  {
+    CastToOtherThreadEventBuffer(pScopes)->m_Data.Add(scope);
+  }
+}
+
+// static
+ezResult ezProfilingSystem::StartRecording(const char* szFile)
+{
+  EZ_LOCK(s_RecordingMutex);
+
+  if (s_pRecordingThread != nullptr)
+  {
+    ezLog::Error("Can't record profiling data to '{0}', a recording to '{1}' is already in progress.", szFile, s_pRecordingThread->m_File.GetOpenFileName());
+    return EZ_FAILURE;
+  }
+
+  RecordingThread* pRecordingThread = EZ_DEFAULT_NEW(RecordingThread);
+
+  if (pRecordingThread->m_File.Open(szFile, ezFileOpenMode::Write).Failed())
+  {
+    ezLog::Error("Failed to open '{0}' for recording profiling data.", szFile);
+    EZ_DEFAULT_DELETE(pRecordingThread);
+    return EZ_FAILURE;
+  }
+
+  pRecordingThread->Begin();
+  pRecordingThread->Start();
+
+  s_pRecordingThread = pRecordingThread;
+  return EZ_SUCCESS;
+}
+
+// static
+void ezProfilingSystem::StopRecording()
+{
+  EZ_LOCK(s_RecordingMutex);
+
+  if (s_pRecordingThread == nullptr)
+    return;
+
+  s_pRecordingThread->m_bStop = true;
+  s_pRecordingThread->m_WakeUp.RaiseSignal();
+  s_pRecordingThread->Join();
+
+  if (s_pRecordingThread->m_uiNumLostScopes > 0 || s_pRecordingThread->m_uiNumLostFrames > 0 || s_pRecordingThread->m_uiNumLostGPUScopes > 0)
+  {
+    ezLog::Warning("The profiling recording '{0}' is missing {1} CPU scopes, {2} frames and {3} GPU scopes, they were overwritten before "
+                   "they could be written to disk.",
+      s_pRecordingThread->m_File.GetOpenFileName(), s_pRecordingThread->m_uiNumLostScopes, s_pRecordingThread->m_uiNumLostFrames,
+      s_pRecordingThread->m_uiNumLostGPUScopes);
+  }
+
+  s_pRecordingThread->m_File.Close();
+
+  EZ_DEFAULT_DELETE(s_pRecordingThread);
+}
+
+// static
+bool ezProfilingSystem::IsRecording()
+{
+  EZ_LOCK(s_RecordingMutex);
+  return s_pRecordingThread != nullptr;
+}
+
+// static
+ezResult ezProfilingSystem::ConvertBinaryCaptureToJSON(ezStreamReader& inputStream, ezStreamWriter& outputStream)
+{
+  char magic[EZ_ARRAY_SIZE(s_BinaryCaptureMagic)];
+  ezUInt32 uiVersion = 0;
+  ezUInt64 uiProcessID = 0;
+
+  if (inputStream.ReadBytes(magic, sizeof(magic)) != sizeof(magic) || ezMemoryUtils::Compare(magic, s_BinaryCaptureMagic, sizeof(magic)) != 0)
+  {
+    ezLog::Error("The stream does not contain a binary profiling capture.");
+    return EZ_FAILURE;
+  }
+
+  inputStream >> uiVersion;
+  inputStream >> uiProcessID;
+
+  if (uiVersion != s_uiBinaryCaptureVersion)
+  {
+    ezLog::Error("Unsupported binary profiling capture version {0}.", uiVersion);
+    return EZ_FAILURE;
+  }
+
+  // same layout as ProfilingData::Write()
+  const ezUInt32 uiPID = static_cast<ezUInt32>(uiProcessID);
+  const ezUInt64 uiFramesThreadID = 1;
+  const ezUInt64 uiGPUThreadID = 0;
+
+  ezStandardJSONWriter writer;
+  writer.SetWhitespaceMode(ezJSONWriter::WhitespaceMode::None);
+  writer.SetOutputStream(&outputStream);
+
+  writer.BeginObject();
+  writer.BeginArray("traceEvents");
+
+  WriteThreadMetadata(writer, uiPID, uiFramesThreadID, "Frames");
+  WriteThreadSortIndex(writer, uiPID, uiFramesThreadID, -1);
+  WriteThreadMetadata(writer, uiPID, uiGPUThreadID, "GPU");
+  WriteThreadSortIndex(writer, uiPID, uiGPUThreadID, -2);
+
+  // Complete events ("X") are written instead of begin/end pairs, the viewer derives their nesting from the times alone,
+  // so a parent scope that ends up in a later chunk than its children doesn't need any sorting.
+  auto WriteCompleteEvent = [&](const char* szName, const char* szFunctionName, ezUInt64 uiThreadID, ezInt64 iBegin, ezInt64 iEnd) {
+    // round both ends the same way, such that nested scopes stay within their parents
+    const ezInt64 iBeginMicroseconds = iBegin / 1000;
+
+    writer.BeginObject();
+    writer.AddVariableString("name", szName);
+    writer.AddVariableUInt32("pid", uiPID);
+    writer.AddVariableUInt64("tid", uiThreadID);
+    writer.AddVariableUInt64("ts", static_cast<ezUInt64>(iBeginMicroseconds));
+    writer.AddVariableUInt64("dur", static_cast<ezUInt64>(iEnd / 1000 - iBeginMicroseconds));
+    writer.AddVariableString("ph", "X");
+
+    if (szFunctionName != nullptr)
     {
-      pMainThreadBuffer->m_Data.PopFront();
+      writer.BeginObject("args");
+      writer.AddVariableString("function", szFunctionName);
+      writer.EndObject();
     }
 
-    pMainThreadBuffer->m_Data.PushBack(scope);
-  }
-  else
+    writer.EndObject();
+  };
+
+  ezDynamicArray<ezString> strings;
+  ezDynamicArray<ezUInt8> payload;
+  ezStringBuilder sTemp;
+
+  // a frame ends when the next one starts
+  ezUInt64 uiPrevFrame = 0;
+  ezInt64 iPrevFrameStart = 0;
+
+  while (true)
   {
-    auto pOtherThreadBuffer = CastToOtherThreadEventBuffer(pScopes);
-    if (!pOtherThreadBuffer->m_Data.CanAppend())
+    ezUInt8 uiType = 0;
+    ezUInt32 uiPayloadSize = 0;
+
+    if (inputStream.ReadBytes(&uiType, sizeof(uiType)) != sizeof(uiType))
+      break;
+
+    // a recording that was not stopped properly may end with an incomplete chunk
+    if (inputStream.ReadBytes(&uiPayloadSize, sizeof(uiPayloadSize)) != sizeof(uiPayloadSize))
+      break;
+
+    payload.SetCountUninitialized(uiPayloadSize);
+    if (inputStream.ReadBytes(payload.GetData(), uiPayloadSize) != uiPayloadSize)
+      break;
+
+    BinaryChunkReader chunk;
+    chunk.m_pCur = payload.GetData();
+    chunk.m_pEnd = payload.GetData() + payload.GetCount();
+
+    switch (uiType)
     {
-      pOtherThreadBuffer->m_Data.PopFront();
+      case BinaryChunkType::Strings:
+      {
+        const ezUInt64 uiCount = chunk.ReadVarUInt();
+        for (ezUInt64 i = 0; i < uiCount && !chunk.m_bError; ++i)
+        {
+          chunk.ReadString(sTemp);
+          strings.PushBack(sTemp);
+        }
+      }
+      break;
+
+      case BinaryChunkType::ThreadInfo:
+      {
+        const ezUInt64 uiThreadID = chunk.ReadVarUInt();
+        const char* szName = chunk.ReadStringIndex(strings);
+
+        if (!chunk.m_bError)
+        {
+          WriteThreadMetadata(writer, uiPID, uiThreadID + 2, szName);
+        }
+      }
+      break;
+
+      case BinaryChunkType::CPUScopes:
+      {
+        const ezUInt64 uiThreadID = chunk.ReadVarUInt() + 2;
+        const ezUInt64 uiCount = chunk.ReadVarUInt();
+
+        ezInt64 iBegin = 0;
+        for (ezUInt64 i = 0; i < uiCount && !chunk.m_bError; ++i)
+        {
+          const char* szName = chunk.ReadStringIndex(strings);
+          const ezUInt64 uiFunction = chunk.ReadVarUInt();
+          const char* szFunctionName = uiFunction > 0 && uiFunction <= strings.GetCount() ? strings[static_cast<ezUInt32>(uiFunction - 1)].GetData() : nullptr;
+          iBegin += chunk.ReadVarInt();
+          const ezInt64 iEnd = iBegin + static_cast<ezInt64>(chunk.ReadVarUInt());
+
+          if (!chunk.m_bError)
+          {
+            WriteCompleteEvent(szName, szFunctionName, uiThreadID, iBegin, iEnd);
+          }
+        }
+      }
+      break;
+
+      case BinaryChunkType::Frames:
+      {
+        const ezUInt64 uiFirstFrame = chunk.ReadVarUInt();
+        const ezUInt64 uiCount = chunk.ReadVarUInt();
+
+        ezInt64 iStart = 0;
+        for (ezUInt64 i = 0; i < uiCount && !chunk.m_bError; ++i)
+        {
+          iStart += chunk.ReadVarInt();
+          const ezUInt64 uiFrame = uiFirstFrame + i;
+
+          if (!chunk.m_bError && uiPrevFrame != 0 && uiPrevFrame + 1 == uiFrame)
+          {
+            sTemp.Format("Frame {}", uiFrame);
+            WriteCompleteEvent(sTemp.GetData(), nullptr, uiFramesThreadID, iPrevFrameStart, iStart);
+          }
+
+          uiPrevFrame = uiFrame;
+          iPrevFrameStart = iStart;
+        }
+      }
+      break;
+
+      case BinaryChunkType::GPUScopes:
+      {
+        const ezUInt64 uiCount = chunk.ReadVarUInt();
+
+        ezInt64 iBegin = 0;
+        for (ezUInt64 i = 0; i < uiCount && !chunk.m_bError; ++i)
+        {
+          const char* szName = chunk.ReadStringIndex(strings);
+          iBegin += chunk.ReadVarInt();
+          const ezInt64 iEnd = iBegin + static_cast<ezInt64>(chunk.ReadVarUInt());
+
+          if (!chunk.m_bError)
+          {
+            WriteCompleteEvent(szName, nullptr, uiGPUThreadID, iBegin, iEnd);
+          }
+        }
+      }
+      break;
+
+      default:
+        // unknown chunks are skipped, newer versions may add more
+        break;
+    }
+
+    if (chunk.m_bError)
+    {
+      ezLog::Error("The binary profiling capture contains a corrupted chunk of type {0}.", uiType);
+      return EZ_FAILURE;
     }
 
-    pOtherThreadBuffer->m_Data.PushBack(scope);
+    if (writer.HadWriteError())
+    {
+      return EZ_FAILURE;
+    }
   }
+
+  writer.EndArray();
+  writer.EndObject();
+
+  return writer.HadWriteError() ? EZ_FAILURE : EZ_SUCCESS;
 }
 
 // static
@@ -568,6 +1239,8 @@ void ezProfilingSystem::Reset()
   }
   s_DeadThreadIDs.Clear();
 
+  EZ_DEFAULT_DELETE(s_GPUScopes);
+
   ezPlugin::s_PluginEvents.RemoveEventHandler(s_PluginEventSubscription);
 }
 
@@ -604,17 +1277,12 @@ void ezProfilingSystem::AddGPUScope(const char* szName, ezTime beginTime, ezTime
   if (endTime - beginTime < ezTime::Milliseconds(CVarDiscardThresholdMs))
     return;
 
-  if (!s_GPUScopes->CanAppend())
-  {
-    s_GPUScopes->PopFront();
-  }
-
   GPUScope scope;
   scope.m_BeginTime = beginTime;
   scope.m_EndTime = endTime;
   ezStringUtils::Copy(scope.m_szName, EZ_ARRAY_SIZE(scope.m_szName), szName);
 
-  s_GPUScopes->PushBack(scope);
+  s_GPUScopes->Add(scope);
 }
 
 //////////////////////////////////////////////////////////////////////////
@@ -674,6 +1342,11 @@ ezResult ezProfilingSystem::ProfilingData::Write(ezStreamWriter& outputStream) c
   return EZ_FAILURE;
 }
 
+ezResult ezProfilingSystem::ProfilingData::WriteBinary(ezStreamWriter& outputStream) const
+{
+  return EZ_FAILURE;
+}
+
 void ezProfilingSystem::Clear() {}
 
 ezProfilingSystem::ProfilingData ezProfilingSystem::Capture()
@@ -687,6 +1360,23 @@ void ezProfilingSystem::StartNewFrame() {}
 
 void ezProfilingSystem::AddCPUScope(const char* szName, const char* szFunctionName, ezTime beginTime, ezTime endTime) {}
 
+ezResult ezProfilingSystem::StartRecording(const char* szFile)
+{
+  return EZ_FAILURE;
+}
+
+void ezProfilingSystem::StopRecording() {}
+
+bool ezProfilingSystem::IsRecording()
+{
+  return false;
+}
+
+ezResult ezProfilingSystem::ConvertBinaryCaptureToJSON(ezStreamReader& inputStream, ezStreamWriter& outputStream)
+{
+  return EZ_FAILURE;
+}
+
 void ezProfilingSystem::Initialize() {}
 
 void ezProfilingSystem::Reset() {}
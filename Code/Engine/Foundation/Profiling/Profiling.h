@@ -6,6 +6,7 @@
 #include <Foundation/System/Process.h>
 #include <Foundation/Time/Time.h>
 
+class ezStreamReader;
 class ezStreamWriter;
 class ezThread;
 
@@ -110,6 +111,11 @@ public:
 
     /// \brief Writes profiling data as JSON to the output stream.
     ezResult Write(ezStreamWriter& outputStream) const;
+
+    /// \brief Writes profiling data in the compact binary format that StartRecording() uses.
+    ///
+    /// Use ConvertBinaryCaptureToJSON() to turn it into the same JSON that Write() produces.
+    ezResult WriteBinary(ezStreamWriter& outputStream) const;
   };
 
 public:
@@ -126,6 +132,25 @@ public:
   /// \brief Adds a new scoped event for the calling thread in the profiling system
   static void AddCPUScope(const char* szName, const char* szFunctionName, ezTime beginTime, ezTime endTime);
 
+  /// \brief Continuously writes all new profiling data to the given file, until StopRecording() is called.
+  ///
+  /// A background thread periodically collects the new scopes from the per-thread buffers and appends them to the file
+  /// in a compact binary format, so profiling can stay enabled for arbitrarily long sessions without a capture growing in memory.
+  /// If that thread cannot keep up, the oldest scopes in a thread buffer are overwritten and are missing in the recording.
+  /// Fails if a recording is already in progress or if the file cannot be opened.
+  static ezResult StartRecording(const char* szFile);
+
+  /// \brief Writes out all remaining data and closes the file of the current recording.
+  static void StopRecording();
+
+  /// \brief Returns whether StartRecording() was called without a matching StopRecording().
+  static bool IsRecording();
+
+  /// \brief Converts a binary capture, see StartRecording() and ProfilingData::WriteBinary(), to the Chrome trace JSON format.
+  ///
+  /// A truncated recording, e.g. because the process crashed, is converted up to the last complete chunk.
+  static ezResult ConvertBinaryCaptureToJSON(ezStreamReader& inputStream, ezStreamWriter& outputStream);
+
 private:
   EZ_MAKE_SUBSYSTEM_STARTUP_FRIEND(Foundation, ProfilingSystem);
   friend ezUInt32 RunThread(ezThread* pThread);
@@ -37,6 +37,25 @@ EZ_ALWAYS_INLINE void ezSimdVec4i::SetZero()
   m_v.SetZero();
 }
 
+template <int N>
+EZ_ALWAYS_INLINE void ezSimdVec4i::Load(const ezInt32* pInts)
+{
+  m_v.SetZero();
+  for (int i = 0; i < N; ++i)
+  {
+    (&m_v.x)[i] = pInts[i];
+  }
+}
+
+template <int N>
+EZ_ALWAYS_INLINE void ezSimdVec4i::Store(ezInt32* pInts) const
+{
+  for (int i = 0; i < N; ++i)
+  {
+    pInts[i] = (&m_v.x)[i];
+  }
+}
+
 EZ_ALWAYS_INLINE ezSimdVec4f ezSimdVec4i::ToFloat() const
 {
   ezSimdVec4f result;
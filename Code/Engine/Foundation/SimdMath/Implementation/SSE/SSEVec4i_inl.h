@@ -43,6 +43,55 @@ EZ_ALWAYS_INLINE void ezSimdVec4i::SetZero()
   m_v = _mm_setzero_si128();
 }
 
+template <>
+EZ_ALWAYS_INLINE void ezSimdVec4i::Load<1>(const ezInt32* pInts)
+{
+  m_v = _mm_cvtsi32_si128(*pInts);
+}
+
+template <>
+EZ_ALWAYS_INLINE void ezSimdVec4i::Load<2>(const ezInt32* pInts)
+{
+  m_v = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(pInts));
+}
+
+template <>
+EZ_ALWAYS_INLINE void ezSimdVec4i::Load<3>(const ezInt32* pInts)
+{
+  m_v = _mm_unpacklo_epi64(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(pInts)), _mm_cvtsi32_si128(pInts[2]));
+}
+
+template <>
+EZ_ALWAYS_INLINE void ezSimdVec4i::Load<4>(const ezInt32* pInts)
+{
+  m_v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pInts));
+}
+
+template <>
+EZ_ALWAYS_INLINE void ezSimdVec4i::Store<1>(ezInt32* pInts) const
+{
+  *pInts = _mm_cvtsi128_si32(m_v);
+}
+
+template <>
+EZ_ALWAYS_INLINE void ezSimdVec4i::Store<2>(ezInt32* pInts) const
+{
+  _mm_storel_epi64(reinterpret_cast<__m128i*>(pInts), m_v);
+}
+
+template <>
+EZ_ALWAYS_INLINE void ezSimdVec4i::Store<3>(ezInt32* pInts) const
+{
+  _mm_storel_epi64(reinterpret_cast<__m128i*>(pInts), m_v);
+  pInts[2] = _mm_cvtsi128_si32(_mm_srli_si128(m_v, 8));
+}
+
+template <>
+EZ_ALWAYS_INLINE void ezSimdVec4i::Store<4>(ezInt32* pInts) const
+{
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(pInts), m_v);
+}
+
 EZ_ALWAYS_INLINE ezSimdVec4f ezSimdVec4i::ToFloat() const
 {
   return _mm_cvtepi32_ps(m_v);
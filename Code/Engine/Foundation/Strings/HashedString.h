@@ -24,17 +24,22 @@ class ezTempHashedString;
 class EZ_FOUNDATION_DLL ezHashedString
 {
 public:
+  /// \brief The central storage of one string. Entries never move in memory, so ezHashedString can just point to them.
   struct HashedData
   {
+    HashedData(ezAllocatorBase* pAllocator)
+      : m_sString(pAllocator)
+    {
+    }
+
+    ezUInt32 m_uiHash = 0;
 #if EZ_ENABLED(EZ_HASHED_STRING_REF_COUNTING)
     ezAtomicInteger32 m_iRefCount;
 #endif
     ezString m_sString;
   };
 
-  // Do NOT use a hash-table! The map does not relocate memory when it resizes, which is a vital aspect for the hashed strings to work.
-  typedef ezMap<ezUInt32, HashedData, ezCompareHelper<ezUInt32>, ezStaticAllocatorWrapper> StringStorage;
-  typedef StringStorage::Iterator HashedType;
+  typedef HashedData* HashedType;
 
 #if EZ_ENABLED(EZ_HASHED_STRING_REF_COUNTING)
   /// \brief This will remove all hashed strings from the central storage, that are not referenced anymore.
@@ -1,18 +1,162 @@
 #include <FoundationPCH.h>
 
 #include <Foundation/Strings/HashedString.h>
+#include <Foundation/Threading/AtomicUtils.h>
 #include <Foundation/Threading/Lock.h>
 #include <Foundation/Threading/Mutex.h>
 
-struct HashedStringData
+// The string table is split into shards, each with its own open addressing hash table and its own lock for inserting strings.
+// Looking up a string that was interned already does not take any lock:
+// - slots are only written while holding the lock, with a memory barrier, and once a slot holds an entry, it never changes to a
+//   different one (only to the tombstone, when unused strings get cleared)
+// - when a table is full, a larger copy is published and the old table is never freed, so lookups can still safely use it
+// A lookup that doesn't find the string, e.g. because the table got replaced concurrently, falls back to the locked path.
+//
+// The entries are allocated in blocks per shard. Strings that fit into the inline storage of ezString are stored inside the entry,
+// only longer ones need a separate allocation, since GetString() hands out the ezString itself.
+
+namespace
 {
-  ezMutex m_Mutex;
-  ezHashedString::StringStorage m_Storage;
-  ezHashedString::HashedType m_Empty;
-};
+  constexpr ezUInt32 s_uiNumShards = 32; // has to be a power of two
+  constexpr ezUInt32 s_uiShardShift = 27;
+  constexpr ezUInt32 s_uiMinTableSize = 64;
+  constexpr ezUInt32 s_uiEntriesPerBlock = 128;
+
+#if EZ_ENABLED(EZ_HASHED_STRING_REF_COUNTING)
+  // cleared entries get a negative ref count, such that lookups that still see them can't acquire them anymore
+  constexpr ezInt32 s_iClearedRefCount = -0x40000000;
+#endif
+
+  struct StringTable
+  {
+    ezUInt32 m_uiSize; // power of two
+    ezHashedString::HashedData* volatile m_Slots[1];
+  };
+
+  struct StringTableShard
+  {
+    ezMutex m_Mutex;
+    StringTable* volatile m_pTable = nullptr;
+    ezUInt32 m_uiNumUsedSlots = 0; // including tombstones
+
+    // entries are allocated in blocks and never move or get freed
+    ezHashedString::HashedData* m_pBlock = nullptr;
+    ezUInt32 m_uiNumUsedInBlock = s_uiEntriesPerBlock;
+
+#if EZ_ENABLED(EZ_HASHED_STRING_REF_COUNTING)
+    ezDynamicArray<ezHashedString::HashedData*, ezStaticAllocatorWrapper> m_FreeEntries;
+#endif
+  };
+
+  struct HashedStringData
+  {
+    HashedStringData()
+      : m_Tombstone(ezStaticAllocatorWrapper::GetAllocator())
+    {
+    }
+
+    StringTableShard m_Shards[s_uiNumShards];
+    ezHashedString::HashedData m_Tombstone;
+    ezHashedString::HashedType m_Empty;
+  };
+} // namespace
 
 static HashedStringData* s_pHSData;
 
+static StringTable* AllocateStringTable(ezUInt32 uiSize)
+{
+  const size_t uiBytes = sizeof(StringTable) + sizeof(ezHashedString::HashedData*) * (uiSize - 1);
+
+  StringTable* pTable = static_cast<StringTable*>(ezStaticAllocatorWrapper::GetAllocator()->Allocate(uiBytes, EZ_ALIGNMENT_OF(StringTable)));
+  ezMemoryUtils::ZeroFill(static_cast<ezUInt8*>(static_cast<void*>(pTable)), uiBytes);
+  pTable->m_uiSize = uiSize;
+
+  return pTable;
+}
+
+static ezHashedString::HashedData* FindHashedString(const StringTable* pTable, ezUInt32 uiHash)
+{
+  // the table is never full, so there is always an empty slot that ends the search
+  const ezUInt32 uiMask = pTable->m_uiSize - 1;
+
+  for (ezUInt32 uiSlot = uiHash & uiMask;; uiSlot = (uiSlot + 1) & uiMask)
+  {
+    ezHashedString::HashedData* pData = pTable->m_Slots[uiSlot];
+
+    if (pData == nullptr)
+      return nullptr;
+
+    if (pData != &s_pHSData->m_Tombstone && pData->m_uiHash == uiHash)
+      return pData;
+  }
+}
+
+template <typename T>
+static void PublishPointer(T* volatile& dest, T* pValue)
+{
+  // the barrier makes sure the pointed to data is fully written before other threads can see it
+  ezAtomicUtils::TestAndSet(const_cast<void**>(reinterpret_cast<void* volatile*>(&dest)), dest, pValue);
+}
+
+static void InsertIntoStringTable(StringTable* pTable, ezHashedString::HashedData* pData)
+{
+  const ezUInt32 uiMask = pTable->m_uiSize - 1;
+
+  for (ezUInt32 uiSlot = pData->m_uiHash & uiMask;; uiSlot = (uiSlot + 1) & uiMask)
+  {
+    ezHashedString::HashedData* pOther = pTable->m_Slots[uiSlot];
+
+    if (pOther == nullptr || pOther == &s_pHSData->m_Tombstone)
+    {
+      PublishPointer(pTable->m_Slots[uiSlot], pData);
+      return;
+    }
+  }
+}
+
+static ezHashedString::HashedData* AllocateHashedData(StringTableShard& shard)
+{
+#if EZ_ENABLED(EZ_HASHED_STRING_REF_COUNTING)
+  if (!shard.m_FreeEntries.IsEmpty())
+  {
+    ezHashedString::HashedData* pData = shard.m_FreeEntries.PeekBack();
+    shard.m_FreeEntries.PopBack();
+    return pData;
+  }
+#endif
+
+  if (shard.m_uiNumUsedInBlock == s_uiEntriesPerBlock)
+  {
+    shard.m_pBlock = static_cast<ezHashedString::HashedData*>(ezStaticAllocatorWrapper::GetAllocator()->Allocate(
+      sizeof(ezHashedString::HashedData) * s_uiEntriesPerBlock, EZ_ALIGNMENT_OF(ezHashedString::HashedData)));
+    shard.m_uiNumUsedInBlock = 0;
+  }
+
+  ezHashedString::HashedData* pData = &shard.m_pBlock[shard.m_uiNumUsedInBlock++];
+  new (pData) ezHashedString::HashedData(ezStaticAllocatorWrapper::GetAllocator());
+  return pData;
+}
+
+#if EZ_ENABLED(EZ_HASHED_STRING_REF_COUNTING)
+static bool TryAcquireHashedString(ezHashedString::HashedData* pData, ezUInt32 uiHash)
+{
+  // the entry might get cleared and reused for another string concurrently
+  for (ezInt32 iRefCount = pData->m_iRefCount; iRefCount >= 0; iRefCount = pData->m_iRefCount)
+  {
+    if (pData->m_iRefCount.TestAndSet(iRefCount, iRefCount + 1))
+    {
+      if (pData->m_uiHash == uiHash)
+        return true;
+
+      pData->m_iRefCount.Decrement();
+      return false;
+    }
+  }
+
+  return false;
+}
+#endif
+
 EZ_MSVC_ANALYSIS_WARNING_PUSH
 EZ_MSVC_ANALYSIS_WARNING_DISABLE(6011) // Disable warning for null pointer dereference as InitHashedString() will ensure that s_pHSData is set
 
@@ -22,29 +166,68 @@ ezHashedString::HashedType ezHashedString::AddHashedString(const char* szString,
   if (s_pHSData == nullptr)
     InitHashedString();
 
-  EZ_LOCK(s_pHSData->m_Mutex);
-
-  // try to find the existing string
-  bool bExisted = false;
-  auto ret = s_pHSData->m_Storage.FindOrAdd(uiHash, &bExisted);
+  StringTableShard& shard = s_pHSData->m_Shards[(uiHash >> s_uiShardShift) & (s_uiNumShards - 1)];
 
-  // if it already exists, just increase the refcount
-  if (bExisted)
+  // fast path without a lock, most strings are interned already
+  if (HashedData* pData = FindHashedString(shard.m_pTable, uiHash))
   {
 #if EZ_ENABLED(EZ_HASHED_STRING_REF_COUNTING)
-    ret.Value().m_iRefCount.Increment();
+    if (TryAcquireHashedString(pData, uiHash))
+      return pData;
+#else
+    return pData;
 #endif
   }
-  else
+
+  EZ_LOCK(shard.m_Mutex);
+
+  StringTable* pTable = shard.m_pTable;
+
+  // try to find the existing string, while holding the lock it can't be cleared
+  if (HashedData* pData = FindHashedString(pTable, uiHash))
   {
-    ezHashedString::HashedData& d = ret.Value();
 #if EZ_ENABLED(EZ_HASHED_STRING_REF_COUNTING)
-    d.m_iRefCount = 1;
+    pData->m_iRefCount.Increment();
 #endif
-    d.m_sString = szString;
+    return pData;
   }
 
-  return ret;
+  // keep the table at most half full, tombstones are dropped when copying it
+  if ((shard.m_uiNumUsedSlots + 1) * 2 > pTable->m_uiSize)
+  {
+    ezUInt32 uiNumEntries = 0;
+    for (ezUInt32 i = 0; i < pTable->m_uiSize; ++i)
+    {
+      if (pTable->m_Slots[i] != nullptr && pTable->m_Slots[i] != &s_pHSData->m_Tombstone)
+        ++uiNumEntries;
+    }
+
+    StringTable* pNewTable = AllocateStringTable(ezMath::Max(s_uiMinTableSize, ezMath::PowerOfTwo_Ceil((uiNumEntries + 1) * 4)));
+
+    for (ezUInt32 i = 0; i < pTable->m_uiSize; ++i)
+    {
+      if (pTable->m_Slots[i] != nullptr && pTable->m_Slots[i] != &s_pHSData->m_Tombstone)
+        InsertIntoStringTable(pNewTable, pTable->m_Slots[i]);
+    }
+
+    // the old table is intentionally leaked, lookups on other threads may still use it
+    PublishPointer(shard.m_pTable, pNewTable);
+    pTable = pNewTable;
+    shard.m_uiNumUsedSlots = uiNumEntries;
+  }
+
+  HashedData* pData = AllocateHashedData(shard);
+  pData->m_uiHash = uiHash;
+  pData->m_sString = szString;
+#if EZ_ENABLED(EZ_HASHED_STRING_REF_COUNTING)
+  // set last, lookups can only acquire the entry once it is complete
+  pData->m_iRefCount = 1;
+#endif
+
+  InsertIntoStringTable(pTable, pData);
+  ++shard.m_uiNumUsedSlots;
+
+  return pData;
 }
 
 EZ_MSVC_ANALYSIS_WARNING_POP
@@ -58,31 +241,50 @@ void ezHashedString::InitHashedString()
   EZ_ALIGN_VARIABLE(static ezUInt8 HashedStringDataBuffer[sizeof(HashedStringData)], EZ_ALIGNMENT_OF(HashedStringData));
   s_pHSData = new (HashedStringDataBuffer) HashedStringData();
 
+  for (StringTableShard& shard : s_pHSData->m_Shards)
+  {
+    shard.m_pTable = AllocateStringTable(s_uiMinTableSize);
+  }
+
   // makes sure the empty string exists for the default constructor to use
   s_pHSData->m_Empty = AddHashedString("", ezHashingUtils::MurmurHash32String(""));
 
 #if EZ_ENABLED(EZ_HASHED_STRING_REF_COUNTING)
   // this one should never get deleted, so make sure its refcount is 2
-  s_pHSData->m_Empty.Value().m_iRefCount.Increment();
+  s_pHSData->m_Empty->m_iRefCount.Increment();
 #endif
 }
 
 #if EZ_ENABLED(EZ_HASHED_STRING_REF_COUNTING)
 ezUInt32 ezHashedString::ClearUnusedStrings()
 {
-  EZ_LOCK(s_pHSData->m_Mutex);
-
   ezUInt32 uiDeleted = 0;
 
-  for (auto it = s_pHSData->m_Storage.GetIterator(); it.IsValid();)
+  for (StringTableShard& shard : s_pHSData->m_Shards)
   {
-    if (it.Value().m_iRefCount == 0)
+    EZ_LOCK(shard.m_Mutex);
+
+    StringTable* pTable = shard.m_pTable;
+
+    for (ezUInt32 i = 0; i < pTable->m_uiSize; ++i)
     {
-      it = s_pHSData->m_Storage.Remove(it);
+      HashedData* pData = pTable->m_Slots[i];
+
+      if (pData == nullptr || pData == &s_pHSData->m_Tombstone)
+        continue;
+
+      // fails if another thread acquired the string in the meantime
+      if (!pData->m_iRefCount.TestAndSet(0, s_iClearedRefCount))
+        continue;
+
+      PublishPointer(pTable->m_Slots[i], &s_pHSData->m_Tombstone);
+
+      // the entry memory stays valid for lookups that still see it, it gets reused for the next new string
+      pData->m_sString.Clear();
+      shard.m_FreeEntries.PushBack(pData);
+
       ++uiDeleted;
     }
-    else
-      ++it;
   }
 
   return uiDeleted;
@@ -103,7 +305,7 @@ ezHashedString::ezHashedString()
 
   m_Data = s_pHSData->m_Empty;
 #if EZ_ENABLED(EZ_HASHED_STRING_REF_COUNTING)
-  m_Data.Value().m_iRefCount.Increment();
+  m_Data->m_iRefCount.Increment();
 #endif
 }
 
@@ -122,9 +324,9 @@ void ezHashedString::Clear()
     HashedType tmp = m_Data;
 
     m_Data = s_pHSData->m_Empty;
-    m_Data.Value().m_iRefCount.Increment();
+    m_Data->m_iRefCount.Increment();
 
-    tmp.Value().m_iRefCount.Decrement();
+    tmp->m_iRefCount.Decrement();
   }
 #else
   m_Data = s_pHSData->m_Empty;
@@ -78,6 +78,8 @@ private:
   // The task system and its worker threads implement most of the functionality of the task handling.
   // Therefore they are allowed to modify all this internal state.
   friend class ezTaskSystem;
+  friend class ezTaskWorkStealingQueue;
+  friend class ezTaskGraph;
 
   void Reset();
 
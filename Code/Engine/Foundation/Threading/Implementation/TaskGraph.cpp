@@ -0,0 +1,222 @@
+#include <FoundationPCH.h>
+
+#include <Foundation/Logging/Log.h>
+#include <Foundation/Threading/TaskGraph.h>
+
+ezTaskGraph::ezTaskGraph() = default;
+
+ezTaskGraph::~ezTaskGraph()
+{
+  EZ_ASSERT_DEV(!IsRunning(), "A task graph must not be destroyed while it is being executed.");
+}
+
+ezUInt32 ezTaskGraph::AddNode(ezTask* pTask)
+{
+  EZ_ASSERT_DEV(pTask != nullptr, "Cannot add nullptr tasks.");
+  EZ_ASSERT_DEV(!IsRunning(), "A task graph cannot be modified while it is being executed.");
+
+  m_bFinalized = false;
+
+  m_Nodes.ExpandAndGetRef().m_pTask = pTask;
+  return m_Nodes.GetCount() - 1;
+}
+
+void ezTaskGraph::AddDependency(ezUInt32 uiNode, ezUInt32 uiDependsOnNode)
+{
+  EZ_ASSERT_DEV(uiNode < m_Nodes.GetCount() && uiDependsOnNode < m_Nodes.GetCount(), "Invalid node index in task graph dependency.");
+  EZ_ASSERT_DEV(uiNode != uiDependsOnNode, "A task graph node cannot depend on itself.");
+  EZ_ASSERT_DEV(!IsRunning(), "A task graph cannot be modified while it is being executed.");
+
+  m_bFinalized = false;
+
+  auto& dep = m_Dependencies.ExpandAndGetRef();
+  dep.m_uiNode = uiNode;
+  dep.m_uiDependsOnNode = uiDependsOnNode;
+}
+
+ezResult ezTaskGraph::Finalize()
+{
+  EZ_ASSERT_DEV(!IsRunning(), "A task graph cannot be modified while it is being executed.");
+
+  const ezUInt32 uiNumNodes = m_Nodes.GetCount();
+
+  // sorting by the node that is depended on groups all successors of a node, which allows to store them in one array
+  m_Dependencies.Sort();
+
+  // the same dependency may have been added multiple times, but must only be counted once
+  {
+    ezUInt32 uiNumUnique = 0;
+    for (ezUInt32 i = 0; i < m_Dependencies.GetCount(); ++i)
+    {
+      if (uiNumUnique == 0 || !(m_Dependencies[i] == m_Dependencies[uiNumUnique - 1]))
+      {
+        m_Dependencies[uiNumUnique++] = m_Dependencies[i];
+      }
+    }
+
+    m_Dependencies.SetCountUninitialized(uiNumUnique);
+  }
+
+  for (Node& node : m_Nodes)
+  {
+    node.m_uiNumDependencies = 0;
+    node.m_uiFirstSuccessor = 0;
+    node.m_uiNumSuccessors = 0;
+  }
+
+  m_Successors.SetCountUninitialized(m_Dependencies.GetCount());
+
+  for (ezUInt32 i = 0; i < m_Dependencies.GetCount(); ++i)
+  {
+    const Dependency& dep = m_Dependencies[i];
+
+    Node& pred = m_Nodes[dep.m_uiDependsOnNode];
+    if (pred.m_uiNumSuccessors == 0)
+    {
+      pred.m_uiFirstSuccessor = i;
+    }
+
+    ++pred.m_uiNumSuccessors;
+    ++m_Nodes[dep.m_uiNode].m_uiNumDependencies;
+    m_Successors[i] = dep.m_uiNode;
+  }
+
+  // Kahn's algorithm: the root nodes come first, every other node follows once all its dependencies have been visited
+  m_RootNodes.Clear();
+  m_TopologicalOrder.Clear();
+  m_TopologicalOrder.Reserve(uiNumNodes);
+
+  ezDynamicArray<ezUInt32> remainingDependencies;
+  remainingDependencies.SetCountUninitialized(uiNumNodes);
+
+  for (ezUInt32 i = 0; i < uiNumNodes; ++i)
+  {
+    remainingDependencies[i] = m_Nodes[i].m_uiNumDependencies;
+
+    if (m_Nodes[i].m_uiNumDependencies == 0)
+    {
+      m_RootNodes.PushBack(i);
+      m_TopologicalOrder.PushBack(i);
+    }
+  }
+
+  for (ezUInt32 i = 0; i < m_TopologicalOrder.GetCount(); ++i)
+  {
+    const Node& node = m_Nodes[m_TopologicalOrder[i]];
+
+    for (ezUInt32 s = 0; s < node.m_uiNumSuccessors; ++s)
+    {
+      const ezUInt32 uiSuccessor = m_Successors[node.m_uiFirstSuccessor + s];
+
+      if (--remainingDependencies[uiSuccessor] == 0)
+      {
+        m_TopologicalOrder.PushBack(uiSuccessor);
+      }
+    }
+  }
+
+  if (m_TopologicalOrder.GetCount() != uiNumNodes)
+  {
+    for (ezUInt32 i = 0; i < uiNumNodes; ++i)
+    {
+      if (remainingDependencies[i] != 0)
+      {
+        ezLog::Error("Task graph node {0} ('{1}') is part of a dependency cycle.", i, m_Nodes[i].m_pTask->m_sTaskName);
+      }
+    }
+
+    m_TopologicalOrder.Clear();
+    m_RootNodes.Clear();
+    return EZ_FAILURE;
+  }
+
+  m_RemainingDependencies.SetCount(uiNumNodes);
+  m_RemainingInvocations.SetCount(uiNumNodes);
+
+  m_bFinalized = true;
+  return EZ_SUCCESS;
+}
+
+void ezTaskGraph::Clear()
+{
+  EZ_ASSERT_DEV(!IsRunning(), "A task graph cannot be modified while it is being executed.");
+
+  m_Nodes.Clear();
+  m_Dependencies.Clear();
+  m_Successors.Clear();
+  m_TopologicalOrder.Clear();
+  m_RootNodes.Clear();
+  m_RemainingDependencies.Clear();
+  m_RemainingInvocations.Clear();
+  m_bFinalized = false;
+}
+
+ezArrayPtr<const ezUInt32> ezTaskGraph::GetTopologicalOrder() const
+{
+  EZ_ASSERT_DEV(m_bFinalized, "The task graph has not been finalized.");
+  return m_TopologicalOrder;
+}
+
+bool ezTaskGraph::IsRunning() const
+{
+  return !ezTaskSystem::IsTaskGroupFinished(m_ActiveGroup);
+}
+
+void ezTaskGraph::PrepareExecution(ezTaskGroup* pGroup, ezDynamicArray<ezTaskSystem::TaskData>& out_Tasks)
+{
+  for (ezUInt32 i = 0; i < m_Nodes.GetCount(); ++i)
+  {
+    m_RemainingDependencies[i] = m_Nodes[i].m_uiNumDependencies;
+  }
+
+  for (ezUInt32 uiNode : m_RootNodes)
+  {
+    AppendNodeTasks(pGroup, uiNode, out_Tasks);
+  }
+}
+
+void ezTaskGraph::AppendNodeTasks(ezTaskGroup* pGroup, ezUInt32 uiNode, ezDynamicArray<ezTaskSystem::TaskData>& out_Tasks)
+{
+  const ezUInt32 uiInvocations = ezMath::Max(1u, m_Nodes[uiNode].m_pTask->GetMultiplicity());
+
+  // must be set before any of the invocations is queued, as they may finish right away
+  m_RemainingInvocations[uiNode] = uiInvocations;
+
+  for (ezUInt32 mult = 0; mult < uiInvocations; ++mult)
+  {
+    ezTaskSystem::TaskData& td = out_Tasks.ExpandAndGetRef();
+    td.m_pBelongsToGroup = pGroup;
+    td.m_pTask = m_Nodes[uiNode].m_pTask;
+    td.m_uiInvocation = mult;
+    td.m_uiGraphNode = uiNode;
+  }
+}
+
+void ezTaskGraph::NodeInvocationHasFinished(ezTaskGroup* pGroup, ezUInt32 uiNode)
+{
+  if (m_RemainingInvocations[uiNode].Decrement() != 0)
+    return;
+
+  const Node& node = m_Nodes[uiNode];
+
+  ezHybridArray<ezTaskSystem::TaskData, 16> readyTasks;
+
+  for (ezUInt32 s = 0; s < node.m_uiNumSuccessors; ++s)
+  {
+    const ezUInt32 uiSuccessor = m_Successors[node.m_uiFirstSuccessor + s];
+
+    if (m_RemainingDependencies[uiSuccessor].Decrement() == 0)
+    {
+      AppendNodeTasks(pGroup, uiSuccessor, readyTasks);
+    }
+  }
+
+  if (!readyTasks.IsEmpty())
+  {
+    // when called on a worker, the successors go into its local queue and are the next thing it pops, while they are still hot in
+    // its cache, idle workers can steal the remaining ones without taking the global task system lock
+    ezTaskSystem::QueueTasks(pGroup, readyTasks, false);
+  }
+}
+
+EZ_STATICLINK_FILE(Foundation, Foundation_Threading_Implementation_TaskGraph);
@@ -25,6 +25,7 @@ void ezTaskGroup::Reuse(ezTaskPriority::Enum priority, ezOnTaskGroupFinishedCall
   m_bStartedByUser = false;
   m_uiGroupCounter += 2; // even if it wraps around, it will never be zero, thus zero stays an invalid group counter
   m_Tasks.Clear();
+  m_pTaskGraph = nullptr;
   m_DependsOnGroups.Clear();
   m_OthersDependingOnMe.Clear();
   m_Priority = priority;
@@ -31,6 +31,7 @@ private:
   ezUInt16 m_uiTaskGroupIndex = 0xFFFF; // only there as a debugging aid
   ezUInt32 m_uiGroupCounter = 1;
   ezHybridArray<ezTask*, 16> m_Tasks;
+  ezTaskGraph* m_pTaskGraph = nullptr; // if set, the tasks are scheduled in the order given by the dependencies of this graph
   ezHybridArray<ezTaskGroupID, 4> m_DependsOnGroups;
   ezHybridArray<ezTaskGroupID, 8> m_OthersDependingOnMe;
   ezAtomicInteger32 m_iNumActiveDependencies;
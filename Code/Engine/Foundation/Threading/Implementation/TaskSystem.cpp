@@ -53,4 +53,14 @@ void ezTaskSystem::SetTargetFrameTime(ezTime targetFrameTime)
   s_State->m_TargetFrameTime = targetFrameTime;
 }
 
+void ezTaskSystem::SetWorkStealingEnabled(bool bEnabled)
+{
+  s_State->m_bWorkStealingEnabled = bEnabled;
+}
+
+bool ezTaskSystem::IsWorkStealingEnabled()
+{
+  return s_State->m_bWorkStealingEnabled;
+}
+
 EZ_STATICLINK_FILE(Foundation, Foundation_Threading_Implementation_TaskSystem);
@@ -8,6 +8,7 @@
 
 class ezTask;
 class ezTaskGroup;
+class ezTaskGraph;
 class ezTaskWorkerThread;
 class ezTaskSystemState;
 class ezTaskSystemThreadState;
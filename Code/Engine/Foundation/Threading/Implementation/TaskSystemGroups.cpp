@@ -6,6 +6,7 @@
 #include <Foundation/Threading/Implementation/TaskSystemState.h>
 #include <Foundation/Threading/Implementation/TaskWorkerThread.h>
 #include <Foundation/Threading/Lock.h>
+#include <Foundation/Threading/TaskGraph.h>
 #include <Foundation/Threading/TaskSystem.h>
 
 
@@ -45,6 +46,7 @@ void ezTaskSystem::AddTaskToGroup(ezTaskGroupID groupID, ezTask* pTask)
   EZ_ASSERT_DEBUG(!pTask->m_sTaskName.IsEmpty(), "Every task should have a name");
 
   ezTaskGroup::DebugCheckTaskGroup(groupID, s_TaskSystemMutex);
+  EZ_ASSERT_DEV(groupID.m_pTaskGroup->m_pTaskGraph == nullptr, "Tasks cannot be added to the group of a task graph. Add them to the graph instead.");
 
   pTask->Reset();
   pTask->m_BelongsToGroup = groupID;
@@ -127,6 +129,35 @@ void ezTaskSystem::StartTaskGroupBatch(ezArrayPtr<const ezTaskGroupID> batch)
   }
 }
 
+ezTaskGroupID ezTaskSystem::CreateTaskGraphGroup(ezTaskGraph* pGraph, ezTaskPriority::Enum Priority, ezOnTaskGroupFinishedCallback callback)
+{
+  EZ_ASSERT_DEV(pGraph->IsFinalized(), "The task graph has to be finalized before it can be executed.");
+  EZ_ASSERT_DEV(!pGraph->IsRunning(), "The task graph is still being executed. It has to finish before it can be started again.");
+
+  ezTaskGroupID Group = CreateTaskGroup(Priority, callback);
+
+  for (const ezTaskGraph::Node& node : pGraph->m_Nodes)
+  {
+    AddTaskToGroup(Group, node.m_pTask);
+
+    // the task can only be removed from the group's queue by CancelTask(), as long as it is not flagged as scheduled
+    // graph tasks are queued by the graph, though, so treat them as scheduled right away
+    node.m_pTask->m_bTaskIsScheduled = true;
+  }
+
+  Group.m_pTaskGroup->m_pTaskGraph = pGraph;
+  pGraph->m_ActiveGroup = Group;
+
+  return Group;
+}
+
+ezTaskGroupID ezTaskSystem::StartTaskGraph(ezTaskGraph* pGraph, ezTaskPriority::Enum Priority, ezOnTaskGroupFinishedCallback callback)
+{
+  ezTaskGroupID Group = CreateTaskGraphGroup(pGraph, Priority, callback);
+  StartTaskGroup(Group);
+  return Group;
+}
+
 bool ezTaskSystem::IsTaskGroupFinished(ezTaskGroupID Group)
 {
   // if the counters differ, the task group has been reused since the GroupID was created, so that group has finished
@@ -144,88 +175,157 @@ void ezTaskSystem::ScheduleGroupTasks(ezTaskGroup* pGroup, bool bHighPriority)
     return;
   }
 
-  ezInt32 iRemainingTasks = 0;
+  // tasks that are spawned from within a worker thread go into its local queue, so there is no need to lock anything for queuing them
+  const bool bUseLocalQueue = GetLocalQueueOwner(pGroup->m_Priority) != nullptr;
+
+  ezHybridArray<TaskData, 16> tasks;
 
-  // add all the tasks to the task list, so that they will be processed
   {
     EZ_LOCK(s_TaskSystemMutex);
 
-
     // store how many tasks from this groups still need to be processed
+    // this has to be done before the first task is queued, as other threads may start working on them right away
+    // the lock is also needed to synchronize with CancelTask(), which checks m_bTaskIsScheduled
+    ezInt32 iRemainingTasks = 0;
 
     for (auto pTask : pGroup->m_Tasks)
     {
       iRemainingTasks += ezMath::Max(1u, pTask->m_uiMultiplicity);
       pTask->m_iRemainingRuns = ezMath::Max(1u, pTask->m_uiMultiplicity);
+      pTask->m_bTaskIsScheduled = true;
     }
 
     pGroup->m_iNumRemainingTasks = iRemainingTasks;
 
-
-    for (ezUInt32 task = 0; task < pGroup->m_Tasks.GetCount(); ++task)
+    if (pGroup->m_pTaskGraph != nullptr)
     {
-      auto& pTask = pGroup->m_Tasks[task];
-
-      for (ezUInt32 mult = 0; mult < ezMath::Max(1u, pTask->m_uiMultiplicity); ++mult)
+      // only the nodes without dependencies can run right away, the others get queued once their dependencies are finished
+      pGroup->m_pTaskGraph->PrepareExecution(pGroup, tasks);
+    }
+    else
+    {
+      for (auto pTask : pGroup->m_Tasks)
       {
-        TaskData td;
-        td.m_pBelongsToGroup = pGroup;
-        td.m_pTask = pTask;
-        td.m_pTask->m_bTaskIsScheduled = true;
-        td.m_uiInvocation = mult;
-
-        if (bHighPriority)
-          s_State->m_Tasks[pGroup->m_Priority].PushFront(td);
-        else
-          s_State->m_Tasks[pGroup->m_Priority].PushBack(td);
+        for (ezUInt32 mult = 0; mult < ezMath::Max(1u, pTask->m_uiMultiplicity); ++mult)
+        {
+          TaskData& td = tasks.ExpandAndGetRef();
+          td.m_pBelongsToGroup = pGroup;
+          td.m_pTask = pTask;
+          td.m_uiInvocation = mult;
+        }
       }
     }
 
-    // send the proper thread signal, to make sure one of the correct worker threads is awake
-    switch (pGroup->m_Priority)
+    if (!bUseLocalQueue)
     {
-      case ezTaskPriority::EarlyThisFrame:
-      case ezTaskPriority::ThisFrame:
-      case ezTaskPriority::LateThisFrame:
-      case ezTaskPriority::EarlyNextFrame:
-      case ezTaskPriority::NextFrame:
-      case ezTaskPriority::LateNextFrame:
-      case ezTaskPriority::In2Frames:
-      case ezTaskPriority::In3Frames:
-      case ezTaskPriority::In4Frames:
-      case ezTaskPriority::In5Frames:
-      case ezTaskPriority::In6Frames:
-      case ezTaskPriority::In7Frames:
-      case ezTaskPriority::In8Frames:
-      case ezTaskPriority::In9Frames:
-      {
-        WakeUpThreads(ezWorkerThreadType::ShortTasks, iRemainingTasks);
-        break;
-      }
+      // the tasks go into the shared lists, which is cheaper to do while the mutex is locked anyway
+      QueueTasks(pGroup, tasks, bHighPriority);
+      return;
+    }
+  }
 
-      case ezTaskPriority::LongRunning:
-      case ezTaskPriority::LongRunningHighPriority:
-      {
-        WakeUpThreads(ezWorkerThreadType::LongTasks, iRemainingTasks);
-        break;
-      }
+  QueueTasks(pGroup, tasks, bHighPriority);
+}
 
-      case ezTaskPriority::FileAccess:
-      case ezTaskPriority::FileAccessHighPriority:
-      {
-        WakeUpThreads(ezWorkerThreadType::FileAccess, iRemainingTasks);
-        break;
-      }
+void ezTaskSystem::QueueTasks(ezTaskGroup* pGroup, ezArrayPtr<const TaskData> tasks, bool bHighPriority)
+{
+  const ezTaskPriority::Enum priority = pGroup->m_Priority;
 
-      case ezTaskPriority::SomeFrameMainThread:
-      case ezTaskPriority::ThisFrameMainThread:
-      case ezTaskPriority::ENUM_COUNT:
-        // nothing to do for these enum values
-        break;
+  ezUInt32 uiNumLocalTasks = 0;
+
+  // high priority tasks have to be executed before everything that is already queued,
+  // the local queues can't do that, since thieves always take their oldest entry
+  ezTaskWorkerThread* pLocalQueueOwner = bHighPriority ? nullptr : GetLocalQueueOwner(priority);
+
+  if (pLocalQueueOwner != nullptr)
+  {
+    ezTaskWorkStealingQueue& localQueue = pLocalQueueOwner->GetLocalQueue(priority);
+
+    while (uiNumLocalTasks < tasks.GetCount() && localQueue.Push(tasks[uiNumLocalTasks]))
+    {
+      ++uiNumLocalTasks;
+    }
+  }
+
+  // whatever doesn't fit into the local queue goes into the shared list
+  if (uiNumLocalTasks < tasks.GetCount())
+  {
+    EZ_LOCK(s_TaskSystemMutex);
+
+    for (ezUInt32 i = uiNumLocalTasks; i < tasks.GetCount(); ++i)
+    {
+      if (bHighPriority)
+        s_State->m_Tasks[priority].PushFront(tasks[i]);
+      else
+        s_State->m_Tasks[priority].PushBack(tasks[i]);
+    }
+
+    s_State->m_iNumQueuedTasks[priority].Add(tasks.GetCount() - uiNumLocalTasks);
+  }
+
+  ezUInt32 uiThreadsToWakeUp = tasks.GetCount();
+
+  // when tasks were put into the local queue, this thread will take on one of them itself, the others are left for idle threads to steal
+  if (uiNumLocalTasks > 0)
+  {
+    --uiThreadsToWakeUp;
+  }
+
+  if (uiThreadsToWakeUp == 0)
+    return;
+
+  // send the proper thread signal, to make sure one of the correct worker threads is awake
+  switch (priority)
+  {
+    case ezTaskPriority::EarlyThisFrame:
+    case ezTaskPriority::ThisFrame:
+    case ezTaskPriority::LateThisFrame:
+    case ezTaskPriority::EarlyNextFrame:
+    case ezTaskPriority::NextFrame:
+    case ezTaskPriority::LateNextFrame:
+    case ezTaskPriority::In2Frames:
+    case ezTaskPriority::In3Frames:
+    case ezTaskPriority::In4Frames:
+    case ezTaskPriority::In5Frames:
+    case ezTaskPriority::In6Frames:
+    case ezTaskPriority::In7Frames:
+    case ezTaskPriority::In8Frames:
+    case ezTaskPriority::In9Frames:
+    {
+      WakeUpThreads(ezWorkerThreadType::ShortTasks, uiThreadsToWakeUp);
+      break;
+    }
+
+    case ezTaskPriority::LongRunning:
+    case ezTaskPriority::LongRunningHighPriority:
+    {
+      WakeUpThreads(ezWorkerThreadType::LongTasks, uiThreadsToWakeUp);
+      break;
     }
+
+    case ezTaskPriority::FileAccess:
+    case ezTaskPriority::FileAccessHighPriority:
+    {
+      WakeUpThreads(ezWorkerThreadType::FileAccess, uiThreadsToWakeUp);
+      break;
+    }
+
+    case ezTaskPriority::SomeFrameMainThread:
+    case ezTaskPriority::ThisFrameMainThread:
+    case ezTaskPriority::ENUM_COUNT:
+      // nothing to do for these enum values
+      break;
   }
 }
 
+ezTaskWorkerThread* ezTaskSystem::GetLocalQueueOwner(ezTaskPriority::Enum Priority)
+{
+  if (!s_State->m_bWorkStealingEnabled || Priority > ezTaskPriority::LateThisFrame)
+    return nullptr;
+
+  return tl_TaskWorkerInfo.m_pLocalQueueOwner;
+}
+
 void ezTaskSystem::DependencyHasFinished(ezTaskGroup* pGroup)
 {
   // remove one dependency from the group
@@ -243,6 +343,31 @@ ezResult ezTaskSystem::CancelGroup(ezTaskGroupID Group, ezOnTaskRunning::Enum On
 
   EZ_PROFILE_SCOPE("CancelGroup");
 
+  if (Group.m_pTaskGroup->m_pTaskGraph != nullptr)
+  {
+    // the tasks of a task graph only get queued once their dependencies are finished, so most of them cannot be removed from anywhere
+    // instead all of them are flagged as canceled, which makes them skip their work once the graph gets to them
+    {
+      EZ_LOCK(s_TaskSystemMutex);
+
+      if (ezTaskSystem::IsTaskGroupFinished(Group))
+        return EZ_SUCCESS;
+
+      for (ezTask* pTask : Group.m_pTaskGroup->m_Tasks)
+      {
+        pTask->m_bCancelExecution = true;
+      }
+    }
+
+    // the mutex must not be held while waiting, as the worker threads may need it to queue the remaining nodes
+    if (OnTaskRunning == ezOnTaskRunning::WaitTillFinished)
+    {
+      WaitForGroup(Group);
+    }
+
+    return EZ_FAILURE;
+  }
+
   EZ_LOCK(s_TaskSystemMutex);
 
   ezResult res = EZ_SUCCESS;
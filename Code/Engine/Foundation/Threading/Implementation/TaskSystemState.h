@@ -31,4 +31,11 @@ private:
 
   // The lists of all scheduled tasks, for each priority.
   ezList<ezTaskSystem::TaskData> m_Tasks[ezTaskPriority::ENUM_COUNT];
+
+  // The number of entries in m_Tasks, for each priority. Only modified while holding the task system mutex,
+  // but read without it, to skip locking when there is nothing to take from a list.
+  ezAtomicInteger32 m_iNumQueuedTasks[ezTaskPriority::ENUM_COUNT];
+
+  // Whether worker threads put the tasks that they spawn into their local work-stealing queues.
+  bool m_bWorkStealingEnabled = true;
 };
@@ -5,6 +5,7 @@
 #include <Foundation/Threading/Implementation/TaskSystemState.h>
 #include <Foundation/Threading/Implementation/TaskWorkerThread.h>
 #include <Foundation/Threading/Lock.h>
+#include <Foundation/Threading/TaskGraph.h>
 #include <Foundation/Threading/TaskSystem.h>
 
 ezTaskGroupID ezTaskSystem::StartSingleTask(ezTask* pTask, ezTaskPriority::Enum Priority, ezTaskGroupID Dependency, ezOnTaskGroupFinishedCallback callback)
@@ -26,7 +27,7 @@ ezTaskGroupID ezTaskSystem::StartSingleTask(ezTask* pTask, ezTaskPriority::Enum
 
 
 
-void ezTaskSystem::TaskHasFinished(ezTask* pTask, ezTaskGroup* pGroup)
+void ezTaskSystem::TaskHasFinished(ezTask* pTask, ezTaskGroup* pGroup, ezUInt32 uiGraphNode)
 {
   // this might deallocate the task, make sure not to reference it later anymore
   if (pTask && pTask->m_OnTaskFinished.IsValid() && pTask->m_iRemainingRuns == 0)
@@ -34,6 +35,12 @@ void ezTaskSystem::TaskHasFinished(ezTask* pTask, ezTaskGroup* pGroup)
     pTask->m_OnTaskFinished(pTask);
   }
 
+  if (uiGraphNode != ezInvalidIndex)
+  {
+    // queue the dependent nodes before this task is counted as finished, otherwise the group could finish prematurely
+    pGroup->m_pTaskGraph->NodeInvocationHasFinished(pGroup, uiGraphNode);
+  }
+
   if (pGroup->m_iNumRemainingTasks.Decrement() == 0)
   {
     // If this was the last task that had to be finished from this group, make sure all dependent groups are started
@@ -80,29 +87,120 @@ ezTaskSystem::TaskData ezTaskSystem::GetNextTask(ezTaskPriority::Enum FirstPrior
 
   EZ_ASSERT_DEV(FirstPriority >= ezTaskPriority::EarlyThisFrame && LastPriority < ezTaskPriority::ENUM_COUNT, "Priority Range is invalid: {0} to {1}", FirstPriority, LastPriority);
 
-  EZ_LOCK(s_TaskSystemMutex);
+  while (true)
+  {
+    TaskData td;
+    if (FindNextTask(FirstPriority, LastPriority, bOnlyTasksThatNeverWait, WaitingForGroup, td))
+      return td;
+
+    if (pWorkerState == nullptr)
+      return TaskData();
+
+    EZ_VERIFY(pWorkerState->Set((int)ezTaskWorkerState::Idle) == (int)ezTaskWorkerState::Active, "Corrupt Worker State");
+
+    // tasks are queued without holding the task system mutex, so a task may have been added after the search above,
+    // but before this thread switched to idle, in which case the thread that queued it did not try to wake us up
+    if (!HasQueuedTasks(FirstPriority, LastPriority))
+      return TaskData();
+
+    if (pWorkerState->CompareAndSwap((int)ezTaskWorkerState::Idle, (int)ezTaskWorkerState::Active) != (int)ezTaskWorkerState::Idle)
+    {
+      // someone else has woken this thread up in the mean time and raised its wake-up signal, so it won't actually go to sleep
+      return TaskData();
+    }
+  }
+}
+
+bool ezTaskSystem::FindNextTask(ezTaskPriority::Enum FirstPriority, ezTaskPriority::Enum LastPriority, bool bOnlyTasksThatNeverWait, const ezTaskGroupID& WaitingForGroup, TaskData& out_Task)
+{
+  ezTaskWorkerThread* pLocalQueueOwner = tl_TaskWorkerInfo.m_pLocalQueueOwner;
 
   // go through all the task lists that this thread is willing to work on
   for (ezUInt32 prio = FirstPriority; prio <= (ezUInt32)LastPriority; ++prio)
   {
-    for (auto it = s_State->m_Tasks[prio].GetIterator(); it.IsValid(); ++it)
+    const bool bStealablePriority = prio <= ezTaskPriority::LateThisFrame;
+
+    // the tasks that this thread spawned itself are the cheapest to get and the most likely to be in the cache
+    if (bStealablePriority && pLocalQueueOwner != nullptr)
+    {
+      ezTaskWorkStealingQueue& localQueue = pLocalQueueOwner->GetLocalQueue((ezTaskPriority::Enum)prio);
+
+      if (localQueue.Pop(out_Task))
+      {
+        if (ezTaskWorkStealingQueue::IsTaskAllowed(out_Task, bOnlyTasksThatNeverWait, WaitingForGroup.m_pTaskGroup))
+          return true;
+
+        // we just took this entry out, so there is always room to put it back
+        EZ_VERIFY(localQueue.Push(out_Task), "Local task queue overflow");
+      }
+    }
+
+    // only lock the mutex, if there is something to find
+    if (s_State->m_iNumQueuedTasks[prio] > 0)
     {
-      if (!bOnlyTasksThatNeverWait || (it->m_pTask->m_NestingMode == ezTaskNesting::Never) || it->m_pBelongsToGroup == WaitingForGroup.m_pTaskGroup)
+      EZ_LOCK(s_TaskSystemMutex);
+
+      for (auto it = s_State->m_Tasks[prio].GetIterator(); it.IsValid(); ++it)
       {
-        TaskData td = *it;
+        if (!bOnlyTasksThatNeverWait || (it->m_pTask->m_NestingMode == ezTaskNesting::Never) || it->m_pBelongsToGroup == WaitingForGroup.m_pTaskGroup)
+        {
+          out_Task = *it;
 
-        s_State->m_Tasks[prio].Remove(it);
-        return td;
+          s_State->m_Tasks[prio].Remove(it);
+          s_State->m_iNumQueuedTasks[prio].Decrement();
+          return true;
+        }
       }
     }
+
+    if (bStealablePriority && StealTask((ezTaskPriority::Enum)prio, bOnlyTasksThatNeverWait, WaitingForGroup, out_Task))
+      return true;
   }
 
-  if (pWorkerState)
+  return false;
+}
+
+bool ezTaskSystem::StealTask(ezTaskPriority::Enum Priority, bool bOnlyTasksThatNeverWait, const ezTaskGroupID& WaitingForGroup, TaskData& out_Task)
+{
+  const ezUInt32 uiNumWorkers = s_ThreadState->m_iAllocatedWorkers[ezWorkerThreadType::ShortTasks];
+
+  if (uiNumWorkers == 0)
+    return false;
+
+  // start with the next worker after this one, so that not all threads pick the same victim
+  const ezUInt32 uiFirstVictim = static_cast<ezUInt32>(tl_TaskWorkerInfo.m_iWorkerIndex + 1) % uiNumWorkers;
+
+  for (ezUInt32 i = 0; i < uiNumWorkers; ++i)
   {
-    EZ_VERIFY(pWorkerState->Set((int)ezTaskWorkerState::Idle) == (int)ezTaskWorkerState::Active, "Corrupt Worker State");
+    ezTaskWorkerThread* pVictim = s_ThreadState->m_Workers[ezWorkerThreadType::ShortTasks][(uiFirstVictim + i) % uiNumWorkers];
+
+    if (pVictim->GetLocalQueue(Priority).Steal(out_Task, bOnlyTasksThatNeverWait, WaitingForGroup.m_pTaskGroup))
+      return true;
+  }
+
+  return false;
+}
+
+bool ezTaskSystem::HasQueuedTasks(ezTaskPriority::Enum FirstPriority, ezTaskPriority::Enum LastPriority)
+{
+  const ezUInt32 uiNumWorkers = s_ThreadState->m_iAllocatedWorkers[ezWorkerThreadType::ShortTasks];
+
+  for (ezUInt32 prio = FirstPriority; prio <= (ezUInt32)LastPriority; ++prio)
+  {
+    if (s_State->m_iNumQueuedTasks[prio] > 0)
+      return true;
+
+    if (prio <= ezTaskPriority::LateThisFrame)
+    {
+      for (ezUInt32 i = 0; i < uiNumWorkers; ++i)
+      {
+        if (!s_ThreadState->m_Workers[ezWorkerThreadType::ShortTasks][i]->GetLocalQueue((ezTaskPriority::Enum)prio).IsEmpty())
+          return true;
+      }
+    }
   }
 
-  return TaskData();
+  return false;
 }
 
 bool ezTaskSystem::ExecuteTask(ezTaskPriority::Enum FirstPriority, ezTaskPriority::Enum LastPriority, bool bOnlyTasksThatNeverWait, const ezTaskGroupID& WaitingForGroup, ezAtomicInteger32* pWorkerState)
@@ -126,7 +224,7 @@ bool ezTaskSystem::ExecuteTask(ezTaskPriority::Enum FirstPriority, ezTaskPriorit
   tl_TaskWorkerInfo.m_szTaskName = nullptr;
 
   // notify the group, that a task is finished, which might trigger other tasks to be executed
-  TaskHasFinished(td.m_pTask, td.m_pBelongsToGroup);
+  TaskHasFinished(td.m_pTask, td.m_pBelongsToGroup, td.m_uiGraphNode);
 
   return true;
 }
@@ -168,13 +266,15 @@ ezResult ezTaskSystem::CancelTask(ezTask* pTask, ezOnTaskRunning::Enum OnTaskRun
         {
           if (it->m_pTask == pTask)
           {
+            const ezTaskSystem::TaskData td = *it;
             s_State->m_Tasks[i].Remove(it);
+            s_State->m_iNumQueuedTasks[i].Decrement();
 
             // we set the task to finished, even though it was not executed
             pTask->m_iRemainingRuns = 0;
 
             // tell the system that one task of that group is 'finished', to ensure its dependencies will get scheduled
-            TaskHasFinished(it->m_pTask, it->m_pBelongsToGroup);
+            TaskHasFinished(td.m_pTask, td.m_pBelongsToGroup, td.m_uiGraphNode);
             return EZ_SUCCESS;
           }
 
@@ -209,56 +309,43 @@ bool ezTaskSystem::HelpExecutingTasks(const ezTaskGroupID& WaitingForGroup)
 
 void ezTaskSystem::ReprioritizeFrameTasks()
 {
-  // There should usually be no 'this frame tasks' left at this time
-  // however, while we waited to enter the lock, such tasks might have appeared
-  // In this case we move them into the highest-priority 'this frame' queue, to ensure they will be executed asap
-  for (ezUInt32 i = (ezUInt32)ezTaskPriority::ThisFrame; i <= (ezUInt32)ezTaskPriority::LateThisFrame; ++i)
-  {
-    auto it = s_State->m_Tasks[i].GetIterator();
+  auto MoveQueuedTasks = [](ezTaskSystemState& state, ezUInt32 uiFromPriority, ezUInt32 uiToPriority) {
+    auto it = state.m_Tasks[uiFromPriority].GetIterator();
 
-    // move all 'this frame' tasks into the 'early this frame' queue
     while (it.IsValid())
     {
-      s_State->m_Tasks[ezTaskPriority::EarlyThisFrame].PushBack(*it);
+      state.m_Tasks[uiToPriority].PushBack(*it);
 
       ++it;
     }
 
     // remove the tasks from their current queue
-    s_State->m_Tasks[i].Clear();
+    state.m_Tasks[uiFromPriority].Clear();
+
+    state.m_iNumQueuedTasks[uiToPriority].Add(state.m_iNumQueuedTasks[uiFromPriority].Set(0));
+  };
+
+  // There should usually be no 'this frame tasks' left at this time
+  // however, while we waited to enter the lock, such tasks might have appeared
+  // In this case we move them into the highest-priority 'this frame' queue, to ensure they will be executed asap
+  // Tasks in the local queues of the worker threads are left alone, they are executed in LIFO order anyway
+  for (ezUInt32 i = (ezUInt32)ezTaskPriority::ThisFrame; i <= (ezUInt32)ezTaskPriority::LateThisFrame; ++i)
+  {
+    // move all 'this frame' tasks into the 'early this frame' queue
+    MoveQueuedTasks(*s_State, i, ezTaskPriority::EarlyThisFrame);
   }
 
   for (ezUInt32 i = (ezUInt32)ezTaskPriority::EarlyNextFrame; i <= (ezUInt32)ezTaskPriority::LateNextFrame; ++i)
   {
-    auto it = s_State->m_Tasks[i].GetIterator();
-
     // move all 'next frame' tasks into the 'this frame' queues
-    while (it.IsValid())
-    {
-      s_State->m_Tasks[i - 3].PushBack(*it);
-
-      ++it;
-    }
-
-    // remove the tasks from their current queue
-    s_State->m_Tasks[i].Clear();
+    MoveQueuedTasks(*s_State, i, i - 3);
   }
 
   for (ezUInt32 i = (ezUInt32)ezTaskPriority::In2Frames; i <= (ezUInt32)ezTaskPriority::In9Frames; ++i)
   {
-    auto it = s_State->m_Tasks[i].GetIterator();
-
     // move all 'in N frames' tasks into the 'in N-1 frames' queues
     // moves 'In2Frames' into 'LateNextFrame'
-    while (it.IsValid())
-    {
-      s_State->m_Tasks[i - 1].PushBack(*it);
-
-      ++it;
-    }
-
-    // remove the tasks from their current queue
-    s_State->m_Tasks[i].Clear();
+    MoveQueuedTasks(*s_State, i, i - 1);
   }
 }
 
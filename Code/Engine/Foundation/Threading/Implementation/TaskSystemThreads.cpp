@@ -2,8 +2,10 @@
 
 #include <Foundation/Logging/Log.h>
 #include <Foundation/System/SystemInformation.h>
+#include <Foundation/Threading/Implementation/TaskGroup.h>
 #include <Foundation/Threading/Implementation/TaskSystemState.h>
 #include <Foundation/Threading/Implementation/TaskWorkerThread.h>
+#include <Foundation/Threading/Lock.h>
 #include <Foundation/Threading/TaskSystem.h>
 
 ezUInt32 ezTaskSystem::GetWorkerThreadCount(ezWorkerThreadType::Enum type)
@@ -86,6 +88,8 @@ void ezTaskSystem::StopWorkerThreads()
     ezThreadUtils::YieldTimeSlice();
   }
 
+  ezDynamicArray<TaskData> remainingLocalTasks;
+
   for (ezUInt32 type = 0; type < ezWorkerThreadType::ENUM_COUNT; ++type)
   {
     const ezUInt32 uiNumWorkers = s_ThreadState->m_iAllocatedWorkers[type];
@@ -93,6 +97,7 @@ void ezTaskSystem::StopWorkerThreads()
     for (ezUInt32 i = 0; i < uiNumWorkers; ++i)
     {
       s_ThreadState->m_Workers[type][i]->Join();
+      s_ThreadState->m_Workers[type][i]->TakeRemainingLocalTasks(remainingLocalTasks);
       EZ_DEFAULT_DELETE(s_ThreadState->m_Workers[type][i]);
     }
 
@@ -100,6 +105,19 @@ void ezTaskSystem::StopWorkerThreads()
     s_ThreadState->m_uiMaxWorkersToUse[type] = 0;
     s_ThreadState->m_Workers[type].Clear();
   }
+
+  // tasks that were still waiting in the local queues of the stopped threads must not get lost,
+  // otherwise their groups would never finish
+  if (!remainingLocalTasks.IsEmpty())
+  {
+    EZ_LOCK(s_TaskSystemMutex);
+
+    for (const TaskData& td : remainingLocalTasks)
+    {
+      s_State->m_Tasks[td.m_pBelongsToGroup->m_Priority].PushBack(td);
+      s_State->m_iNumQueuedTasks[td.m_pBelongsToGroup->m_Priority].Increment();
+    }
+  }
 }
 
 void ezTaskSystem::AllocateThreads(ezWorkerThreadType::Enum type, ezUInt32 uiAddThreads)
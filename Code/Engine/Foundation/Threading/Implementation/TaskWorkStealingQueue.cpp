@@ -0,0 +1,94 @@
+#include <FoundationPCH.h>
+
+#include <Foundation/Threading/Implementation/TaskWorkStealingQueue.h>
+#include <Foundation/Threading/Implementation/Task.h>
+
+ezTaskWorkStealingQueue::ezTaskWorkStealingQueue() = default;
+ezTaskWorkStealingQueue::~ezTaskWorkStealingQueue() = default;
+
+bool ezTaskWorkStealingQueue::Push(const ezTaskSystem::TaskData& td)
+{
+  const ezInt64 b = m_iBottom;
+  const ezInt64 t = m_iTop;
+
+  if (b - t >= (ezInt64)Capacity)
+    return false;
+
+  Entry& entry = m_Entries[b & Mask];
+  entry.m_Task = td;
+  entry.m_bNeverWaits = td.m_pTask->m_NestingMode == ezTaskNesting::Never;
+
+  // publishes the new entry to thieves, the atomic operation acts as a full memory barrier
+  m_iBottom.Set(b + 1);
+  return true;
+}
+
+bool ezTaskWorkStealingQueue::Pop(ezTaskSystem::TaskData& out_td)
+{
+  // reserve the bottom entry first, then check whether a thief got to it already
+  // Decrement() is a full memory barrier, so the read of m_iTop cannot be moved before it
+  const ezInt64 b = m_iBottom.Decrement();
+  const ezInt64 t = m_iTop;
+
+  if (t > b)
+  {
+    // the queue was empty, restore the previous state
+    m_iBottom.Set(b + 1);
+    return false;
+  }
+
+  out_td = m_Entries[b & Mask].m_Task;
+
+  if (t != b)
+  {
+    // there are more entries left, no thief can reach this one
+    return true;
+  }
+
+  // this was the last entry, compete with the thieves for it
+  const bool bWon = m_iTop.TestAndSet(t, t + 1);
+  m_iBottom.Set(b + 1);
+  return bWon;
+}
+
+bool ezTaskWorkStealingQueue::Steal(ezTaskSystem::TaskData& out_td, bool bOnlyTasksThatNeverWait, const ezTaskGroup* pWaitingForGroup)
+{
+  const ezInt64 t = m_iTop;
+  const ezInt64 b = m_iBottom;
+
+  if (t >= b)
+    return false;
+
+  // the entry may get overwritten by the owner as soon as another thread has taken it,
+  // but then the compare-and-swap below fails and the copy is discarded
+  // until then the copy may be torn, so the filter only compares its values and never dereferences the task
+  const Entry entry = m_Entries[t & Mask];
+
+  if (bOnlyTasksThatNeverWait && !entry.m_bNeverWaits && entry.m_Task.m_pBelongsToGroup != pWaitingForGroup)
+    return false;
+
+  if (!m_iTop.TestAndSet(t, t + 1))
+    return false;
+
+  out_td = entry.m_Task;
+  return true;
+}
+
+bool ezTaskWorkStealingQueue::IsEmpty() const
+{
+  return m_iBottom <= m_iTop;
+}
+
+ezUInt32 ezTaskWorkStealingQueue::GetCount() const
+{
+  const ezInt64 t = m_iTop;
+  const ezInt64 b = m_iBottom;
+  return b > t ? static_cast<ezUInt32>(b - t) : 0u;
+}
+
+bool ezTaskWorkStealingQueue::IsTaskAllowed(const ezTaskSystem::TaskData& td, bool bOnlyTasksThatNeverWait, const ezTaskGroup* pWaitingForGroup)
+{
+  return !bOnlyTasksThatNeverWait || (td.m_pTask->m_NestingMode == ezTaskNesting::Never) || td.m_pBelongsToGroup == pWaitingForGroup;
+}
+
+EZ_STATICLINK_FILE(Foundation, Foundation_Threading_Implementation_TaskWorkStealingQueue);
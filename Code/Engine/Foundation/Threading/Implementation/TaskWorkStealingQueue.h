@@ -0,0 +1,66 @@
+#pragma once
+
+#include <Foundation/Threading/AtomicInteger.h>
+#include <Foundation/Threading/TaskSystem.h>
+
+/// \internal A bounded, lock-free work-stealing deque (Chase-Lev) of scheduled task invocations.
+///
+/// Every short-task worker thread owns a few of these (one per 'this frame' priority).
+/// Only the owning thread may call Push() and Pop(), which operate on the 'bottom' end in LIFO order,
+/// so that the most recently spawned (and thus most likely cache-hot) work is executed first.
+/// Any thread may call Steal(), which takes the oldest entry from the 'top' end.
+///
+/// The queue never grows. When it is full, Push() fails and the caller is expected to fall back
+/// to the shared, mutex protected task lists of the ezTaskSystem.
+class ezTaskWorkStealingQueue
+{
+  EZ_DISALLOW_COPY_AND_ASSIGN(ezTaskWorkStealingQueue);
+
+public:
+  /// \brief The maximum number of entries in the queue. Must be a power of two.
+  static constexpr ezUInt32 Capacity = 256;
+
+  ezTaskWorkStealingQueue();
+  ~ezTaskWorkStealingQueue();
+
+  /// \brief Adds a task at the bottom of the queue. Returns false, if the queue is full. May only be called by the owning thread.
+  bool Push(const ezTaskSystem::TaskData& td);
+
+  /// \brief Removes the most recently pushed task. Returns false, if the queue is empty. May only be called by the owning thread.
+  bool Pop(ezTaskSystem::TaskData& out_td);
+
+  /// \brief Removes the oldest task from the queue, if it passes the given filter. May be called from any thread.
+  ///
+  /// Returns false if the queue is empty, if the oldest task does not pass the filter or if another thread got to it first.
+  /// The filter only uses data stored in the queue itself, the task is not accessed before it was successfully taken.
+  bool Steal(ezTaskSystem::TaskData& out_td, bool bOnlyTasksThatNeverWait, const ezTaskGroup* pWaitingForGroup);
+
+  /// \brief Returns whether the queue currently holds no tasks. This is only a snapshot, if other threads work on the queue concurrently.
+  bool IsEmpty() const;
+
+  /// \brief Returns the number of tasks in the queue. This is only a snapshot, if other threads work on the queue concurrently.
+  ezUInt32 GetCount() const;
+
+  /// \brief Returns whether the given task may be executed by a thread that is currently waiting for \a pWaitingForGroup.
+  static bool IsTaskAllowed(const ezTaskSystem::TaskData& td, bool bOnlyTasksThatNeverWait, const ezTaskGroup* pWaitingForGroup);
+
+private:
+  static constexpr ezUInt32 Mask = Capacity - 1;
+  static_assert((Capacity & Mask) == 0, "Capacity must be a power of two");
+
+  // the index of the oldest entry, only ever incremented (by thieves and by the owner when taking the last entry)
+  ezAtomicInteger64 m_iTop;
+
+  // the index one past the newest entry, only modified by the owner
+  ezAtomicInteger64 m_iBottom;
+
+  struct Entry
+  {
+    ezTaskSystem::TaskData m_Task;
+
+    // copy of the task's nesting mode, such that thieves can filter without accessing a task that might not be in the queue anymore
+    bool m_bNeverWaits = false;
+  };
+
+  Entry m_Entries[Capacity];
+};
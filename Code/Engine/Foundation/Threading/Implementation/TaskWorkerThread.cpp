@@ -14,7 +14,7 @@ static const char* GenerateThreadName(ezWorkerThreadType::Enum ThreadType, ezUIn
 }
 
 ezTaskWorkerThread::ezTaskWorkerThread(ezWorkerThreadType::Enum ThreadType, ezUInt32 uiThreadNumber)
-  : ezThread(GenerateThreadName(ThreadType, uiThreadNumber), 32 * 1024) /* 32 KB of stack size */
+  : ezThread(GenerateThreadName(ThreadType, uiThreadNumber), 128 * 1024) /* 128 KB of stack size, on POSIX this is a hard limit and resource loading tasks compile shaders */
 {
   m_WorkerType = ThreadType;
   m_uiWorkerThreadNumber = uiThreadNumber & 0xFFFF;
@@ -50,6 +50,12 @@ ezUInt32 ezTaskWorkerThread::Run()
 
   const bool bIsReserve = m_uiWorkerThreadNumber >= ezTaskSystem::s_ThreadState->m_uiMaxWorkersToUse[m_WorkerType];
 
+  // reserve threads only execute a single task before they go back to sleep, so they must not keep spawned tasks to themselves
+  if (m_WorkerType == ezWorkerThreadType::ShortTasks && !bIsReserve)
+  {
+    tl_TaskWorkerInfo.m_pLocalQueueOwner = this;
+  }
+
   ezTaskPriority::Enum FirstPriority;
   ezTaskPriority::Enum LastPriority;
   ezTaskSystem::DetermineTasksToExecuteOnThread(FirstPriority, LastPriority);
@@ -145,5 +151,19 @@ double ezTaskWorkerThread::GetThreadUtilization(ezUInt32* pNumTasksExecuted /*=
   return m_fLastThreadUtilization;
 }
 
+void ezTaskWorkerThread::TakeRemainingLocalTasks(ezDynamicArray<ezTaskSystem::TaskData>& out_Tasks)
+{
+  EZ_ASSERT_DEV(GetThreadStatus() == ezThread::Finished, "The local queues may only be emptied by another thread, once the worker has stopped.");
+
+  for (ezTaskWorkStealingQueue& queue : m_LocalQueues)
+  {
+    ezTaskSystem::TaskData td;
+    while (queue.Steal(td, false, nullptr))
+    {
+      out_Tasks.PushBack(td);
+    }
+  }
+}
+
 
 EZ_STATICLINK_FILE(Foundation, Foundation_Threading_Implementation_TaskWorkerThread);
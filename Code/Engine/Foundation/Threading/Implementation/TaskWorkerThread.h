@@ -1,6 +1,7 @@
 #pragma once
 
 #include <Foundation/Threading/Implementation/TaskSystemDeclarations.h>
+#include <Foundation/Threading/Implementation/TaskWorkStealingQueue.h>
 
 #include <Foundation/Threading/Thread.h>
 #include <Foundation/Threading/ThreadSignal.h>
@@ -77,6 +78,22 @@ private:
   ezAtomicInteger32 m_WorkerState; // ezTaskWorkerState
 
   ///@}
+
+  /// \name Work Stealing
+  ///@{
+
+public:
+  /// \brief Returns the thread's local queue for the given 'this frame' priority. Other threads may only steal from it.
+  ezTaskWorkStealingQueue& GetLocalQueue(ezTaskPriority::Enum priority) { return m_LocalQueues[priority - ezTaskPriority::EarlyThisFrame]; }
+
+  /// \brief Moves all tasks that are still in the local queues into \a out_Tasks. May only be called once the thread has stopped.
+  void TakeRemainingLocalTasks(ezDynamicArray<ezTaskSystem::TaskData>& out_Tasks);
+
+private:
+  // Tasks of priority 'EarlyThisFrame' to 'LateThisFrame' that were spawned by this thread. Idle threads steal from these.
+  ezTaskWorkStealingQueue m_LocalQueues[ezTaskPriority::LateThisFrame - ezTaskPriority::EarlyThisFrame + 1];
+
+  ///@}
 };
 
 /// \internal Thread local state used by the task system (and for better debugging)
@@ -87,6 +104,7 @@ struct ezTaskWorkerInfo
   bool m_bAllowNestedTasks = true;
   const char* m_szTaskName = nullptr;
   ezAtomicInteger32* m_pWorkerState = nullptr;
+  ezTaskWorkerThread* m_pLocalQueueOwner = nullptr; ///< Set for worker threads that push the tasks they spawn into their local work-stealing queues.
 };
 
 extern thread_local ezTaskWorkerInfo tl_TaskWorkerInfo;
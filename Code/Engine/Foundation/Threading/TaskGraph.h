@@ -0,0 +1,116 @@
+#pragma once
+
+#include <Foundation/Containers/DynamicArray.h>
+#include <Foundation/Threading/AtomicInteger.h>
+#include <Foundation/Threading/TaskSystem.h>
+
+/// \brief Describes a set of tasks with fine-grained dependencies between individual tasks.
+///
+/// Task groups only allow to express that all tasks of one group have to finish before any task of another group may start.
+/// When a system consists of many small steps with only a few real dependencies, this introduces unnecessary sync points.
+/// An ezTaskGraph instead allows each task (node) to depend on any number of other tasks of the same graph.
+/// A node is queued for execution as soon as all of its dependencies have finished, without waiting for anything else.
+///
+/// The graph is set up once, using AddNode() and AddDependency(), and then validated with Finalize(), which detects cycles and
+/// precomputes a topological order. Afterwards it can be executed as often as desired (e.g. once per frame), through
+/// ezTaskSystem::StartTaskGraph() or ezTaskSystem::CreateTaskGraphGroup(). Each execution is represented by a regular task group,
+/// so it can be waited on, canceled and used as a dependency for other task groups, just like any other group.
+///
+/// Tasks with a multiplicity are supported, all invocations of such a node have to finish before its dependent nodes get queued.
+///
+/// \note A graph can only be executed once at a time and its structure may not be modified while it is executed.
+/// Every task may only be added to a single node.
+class EZ_FOUNDATION_DLL ezTaskGraph
+{
+  EZ_DISALLOW_COPY_AND_ASSIGN(ezTaskGraph);
+
+public:
+  ezTaskGraph();
+  ~ezTaskGraph();
+
+  /// \brief Adds a node that executes the given task and returns the index of that node.
+  ///
+  /// The graph does not take ownership of the task, it has to stay alive as long as the graph may get executed.
+  ezUInt32 AddNode(ezTask* pTask); // [tested]
+
+  /// \brief Adds a dependency such that the task of \a uiNode will only be executed after the task of \a uiDependsOnNode has finished.
+  void AddDependency(ezUInt32 uiNode, ezUInt32 uiDependsOnNode); // [tested]
+
+  /// \brief Validates the graph and prepares it for execution. Must be called after all nodes and dependencies were added.
+  ///
+  /// Returns EZ_FAILURE, if the dependencies contain a cycle, in which case the graph cannot be executed.
+  ezResult Finalize(); // [tested]
+
+  /// \brief Returns whether Finalize() was called successfully since the last modification.
+  bool IsFinalized() const { return m_bFinalized; } // [tested]
+
+  /// \brief Removes all nodes and dependencies.
+  void Clear(); // [tested]
+
+  /// \brief Returns the number of nodes in the graph.
+  ezUInt32 GetNodeCount() const { return m_Nodes.GetCount(); } // [tested]
+
+  /// \brief Returns the task that is executed by the given node.
+  ezTask* GetNodeTask(ezUInt32 uiNode) const { return m_Nodes[uiNode].m_pTask; }
+
+  /// \brief Returns all node indices in an order in which every node comes after all of its dependencies. Only valid after Finalize().
+  ezArrayPtr<const ezUInt32> GetTopologicalOrder() const; // [tested]
+
+  /// \brief Returns whether the graph is currently being executed by the task system.
+  bool IsRunning() const; // [tested]
+
+private:
+  friend class ezTaskSystem;
+
+  struct Node
+  {
+    ezTask* m_pTask = nullptr;
+    ezUInt32 m_uiNumDependencies = 0;
+    ezUInt32 m_uiFirstSuccessor = 0;
+    ezUInt32 m_uiNumSuccessors = 0;
+  };
+
+  struct Dependency
+  {
+    EZ_DECLARE_POD_TYPE();
+
+    ezUInt32 m_uiNode;
+    ezUInt32 m_uiDependsOnNode;
+
+    bool operator<(const Dependency& rhs) const
+    {
+      if (m_uiDependsOnNode != rhs.m_uiDependsOnNode)
+        return m_uiDependsOnNode < rhs.m_uiDependsOnNode;
+
+      return m_uiNode < rhs.m_uiNode;
+    }
+
+    bool operator==(const Dependency& rhs) const { return m_uiNode == rhs.m_uiNode && m_uiDependsOnNode == rhs.m_uiDependsOnNode; }
+  };
+
+  /// \brief Resets the runtime state and appends all invocations of the root nodes to \a out_Tasks. Called when the group gets scheduled.
+  void PrepareExecution(ezTaskGroup* pGroup, ezDynamicArray<ezTaskSystem::TaskData>& out_Tasks);
+
+  /// \brief Appends all invocations of the given node to \a out_Tasks.
+  void AppendNodeTasks(ezTaskGroup* pGroup, ezUInt32 uiNode, ezDynamicArray<ezTaskSystem::TaskData>& out_Tasks);
+
+  /// \brief Called by the task system whenever one invocation of a node has finished (or was canceled).
+  ///
+  /// Once all invocations of the node are done, all dependent nodes that have no other unfinished dependencies are queued.
+  void NodeInvocationHasFinished(ezTaskGroup* pGroup, ezUInt32 uiNode);
+
+  ezDynamicArray<Node> m_Nodes;
+  ezDynamicArray<Dependency> m_Dependencies;
+
+  // computed by Finalize()
+  ezDynamicArray<ezUInt32> m_Successors;
+  ezDynamicArray<ezUInt32> m_TopologicalOrder;
+  ezDynamicArray<ezUInt32> m_RootNodes;
+
+  // the runtime state during execution
+  ezDynamicArray<ezAtomicInteger32> m_RemainingDependencies;
+  ezDynamicArray<ezAtomicInteger32> m_RemainingInvocations;
+  ezTaskGroupID m_ActiveGroup;
+
+  bool m_bFinalized = false;
+};
@@ -71,6 +71,9 @@ public:
   /// Therefore when bWaitForIt is true, this function might block for a very long time.
   /// It is advised to implement tasks that need to be canceled regularly (e.g. path searches for units that might die)
   /// in a way that allows for quick canceling.
+  ///
+  /// \note Tasks that were scheduled into the local work-stealing queue of a worker thread (see SetWorkStealingEnabled())
+  /// cannot be removed from there anymore and are treated as if they were already running.
   static ezResult CancelTask(ezTask* pTask, ezOnTaskRunning::Enum OnTaskRunning = ezOnTaskRunning::WaitTillFinished); // [tested]
 
   struct TaskData
@@ -78,17 +81,31 @@ public:
     ezTask* m_pTask = nullptr;
     ezTaskGroup* m_pBelongsToGroup = nullptr;
     ezUInt32 m_uiInvocation = 0;
+    ezUInt32 m_uiGraphNode = ezInvalidIndex; ///< The index of the ezTaskGraph node that this task belongs to, if any.
   };
 
 private:
   /// \brief Searches for a task of priority between \a FirstPriority and \a LastPriority (inclusive).
+  ///
+  /// If nothing is found and \a pWorkerState is given, the worker is switched to the idle state.
   static TaskData GetNextTask(ezTaskPriority::Enum FirstPriority, ezTaskPriority::Enum LastPriority, bool bOnlyTasksThatNeverWait, const ezTaskGroupID& WaitingForGroup, ezAtomicInteger32* pWorkerState);
 
+  /// \brief Takes a task from the calling thread's local queue, the shared task lists or the local queue of another worker thread.
+  static bool FindNextTask(ezTaskPriority::Enum FirstPriority, ezTaskPriority::Enum LastPriority, bool bOnlyTasksThatNeverWait, const ezTaskGroupID& WaitingForGroup, TaskData& out_Task);
+
+  /// \brief Tries to take a task of the given 'this frame' priority out of the local queue of any worker thread.
+  static bool StealTask(ezTaskPriority::Enum Priority, bool bOnlyTasksThatNeverWait, const ezTaskGroupID& WaitingForGroup, TaskData& out_Task);
+
+  /// \brief Returns whether any task of priority between \a FirstPriority and \a LastPriority (inclusive) is waiting for execution.
+  static bool HasQueuedTasks(ezTaskPriority::Enum FirstPriority, ezTaskPriority::Enum LastPriority);
+
   /// \brief Executes some task of priority between \a FirstPriority and \a LastPriority (inclusive). Returns true, if any such task was available.
   static bool ExecuteTask(ezTaskPriority::Enum FirstPriority, ezTaskPriority::Enum LastPriority, bool bOnlyTasksThatNeverWait, const ezTaskGroupID& WaitingForGroup, ezAtomicInteger32* pWorkerState);
 
   /// \brief Called whenever a task has been finished/canceled. Makes sure that groups are marked as finished when all tasks are done.
-  static void TaskHasFinished(ezTask* pTask, ezTaskGroup* pGroup);
+  ///
+  /// For tasks that are part of an ezTaskGraph, \a uiGraphNode is the index of their node, such that dependent nodes can get queued.
+  static void TaskHasFinished(ezTask* pTask, ezTaskGroup* pGroup, ezUInt32 uiGraphNode = ezInvalidIndex);
 
   /// \brief Moves all 'next frame' tasks into the 'this frame' queues.
   static void ReprioritizeFrameTasks();
@@ -134,6 +151,16 @@ public:
   /// \brief Same as StartTaskGroup() but batches multiple actions
   static void StartTaskGroupBatch(ezArrayPtr<const ezTaskGroupID> batch);
 
+  /// \brief Creates a task group that executes all tasks of the given ezTaskGraph, respecting the dependencies between them.
+  ///
+  /// The graph must have been finalized and must not be executed already. The returned group has not been started yet,
+  /// so dependencies on other groups can be added, before it is started with StartTaskGroup().
+  /// No further tasks can be added to the group. Once all tasks of the graph are finished, the group is finished.
+  static ezTaskGroupID CreateTaskGraphGroup(ezTaskGraph* pGraph, ezTaskPriority::Enum Priority, ezOnTaskGroupFinishedCallback callback = ezOnTaskGroupFinishedCallback()); // [tested]
+
+  /// \brief A helper function that creates a task group for the given ezTaskGraph and starts it right away. \see CreateTaskGraphGroup()
+  static ezTaskGroupID StartTaskGraph(ezTaskGraph* pGraph, ezTaskPriority::Enum Priority, ezOnTaskGroupFinishedCallback callback = ezOnTaskGroupFinishedCallback()); // [tested]
+
   /// \brief Returns whether the given \a Group id refers to a task group that has been finished already.
   ///
   /// There is no time frame in which group IDs are valid. You may call this function at any time, even 10 minutes later,
@@ -146,6 +173,9 @@ public:
   /// EZ_FAILURE is returned, if at least one task was being processed by another thread and could not be removed without waiting.
   /// If bWaitForIt is false, the function cancels all tasks, but returns without blocking, even if not all tasks have been finished.
   /// If bWaitForIt is true, the function returns only after it is guaranteed that all tasks are properly terminated.
+  ///
+  /// \note The tasks of an ezTaskGraph group are not removed, but flagged as canceled, so that they skip their work once they get executed.
+  /// For such a group EZ_FAILURE is returned, unless it was already finished.
   static ezResult CancelGroup(ezTaskGroupID Group, ezOnTaskRunning::Enum OnTaskRunning = ezOnTaskRunning::WaitTillFinished); // [tested]
 
   /// \brief Blocks until all tasks in the given group have finished.
@@ -171,6 +201,13 @@ private:
   /// \brief Is called whenever a dependency of pGroup has finished. Once all dependencies are finished, the group's tasks will get scheduled.
   static void DependencyHasFinished(ezTaskGroup* pGroup);
 
+  /// \brief Inserts the given task invocations of \a pGroup into the local queue of the calling worker thread or the shared task lists
+  /// and wakes up enough threads to process them.
+  static void QueueTasks(ezTaskGroup* pGroup, ezArrayPtr<const TaskData> tasks, bool bHighPriority);
+
+  /// \brief Returns the worker thread into whose local queue tasks of the given priority should be put, or nullptr if they go into the shared lists.
+  static ezTaskWorkerThread* GetLocalQueueOwner(ezTaskPriority::Enum Priority);
+
   ///@}
 
   /// \name Thread Management
@@ -211,6 +248,7 @@ public:
 
 private:
   friend class ezTaskWorkerThread;
+  friend class ezTaskGraph;
 
   /// \brief Allocates \a uiAddThreads additional threads of \a type
   static void AllocateThreads(ezWorkerThreadType::Enum type, ezUInt32 uiAddThreads);
@@ -286,6 +324,21 @@ public:
   /// \see FinishFrameTasks() for more details.
   static void SetTargetFrameTime(ezTime targetFrameTime = ezTime::Seconds(1.0 / 40.0) /* 40 FPS -> 25 ms */);
 
+  /// \brief Enables or disables work stealing (enabled by default).
+  ///
+  /// With work stealing, tasks of priority 'EarlyThisFrame' to 'LateThisFrame' that are started from within a short task worker thread,
+  /// are put into a lock-free queue that is local to that worker thread, instead of the shared task lists.
+  /// The worker executes them in LIFO order, other idle threads steal the oldest ones. This avoids contention on the task system mutex
+  /// when many tasks spawn further tasks, e.g. through ParallelFor().
+  /// Tasks started from all other threads, as well as high priority tasks (e.g. ones whose dependencies just finished),
+  /// always go into the shared task lists.
+  ///
+  /// Disabling work stealing only affects tasks that are started afterwards, tasks that are already in a local queue still get executed.
+  static void SetWorkStealingEnabled(bool bEnabled);
+
+  /// \brief Returns whether work stealing is enabled. \see SetWorkStealingEnabled()
+  static bool IsWorkStealingEnabled();
+
 private:
   EZ_MAKE_SUBSYSTEM_STARTUP_FRIEND(Foundation, TaskSystem);
 
@@ -42,6 +42,14 @@
 #  define EZ_USE_ALLOCATION_STACK_TRACING EZ_OFF
 #endif
 
+#ifdef BUILDSYSTEM_USE_ALLOCATION_SAMPLING
+#  undef EZ_USE_ALLOCATION_SAMPLING
+#  define EZ_USE_ALLOCATION_SAMPLING EZ_ON
+#else
+#  undef EZ_USE_ALLOCATION_SAMPLING
+#  define EZ_USE_ALLOCATION_SAMPLING EZ_OFF
+#endif
+
 
 
 #if !defined(BUILDSYSTEM_IGNORE_USERCONFIG_HEADER)
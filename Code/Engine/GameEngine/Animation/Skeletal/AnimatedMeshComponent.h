@@ -9,7 +9,23 @@ struct ezSkeletonResourceDescriptor;
 typedef ezTypedResourceHandle<class ezAnimationClipResource> ezAnimationClipResourceHandle;
 typedef ezTypedResourceHandle<class ezSkeletonResource> ezSkeletonResourceHandle;
 
-typedef ezComponentManagerSimple<class ezAnimatedMeshComponent, ezComponentUpdateType::WhenSimulating> ezAnimatedMeshComponentManager;
+/// \brief Updates all animated meshes of a world in two steps.
+///
+/// First the poses of all components are sampled and converted to object and skinning space. This doesn't touch anything but the
+/// components themselves, so it runs in the asynchronous update phase, distributed over the task system.
+/// Everything that interacts with the rest of the world, i.e. sending ezMsgAnimationPoseUpdated, applying root motion and debug drawing,
+/// happens afterwards on the main thread.
+class EZ_GAMEENGINE_DLL ezAnimatedMeshComponentManager : public ezComponentManager<class ezAnimatedMeshComponent, ezBlockStorageType::FreeList>
+{
+public:
+  ezAnimatedMeshComponentManager(ezWorld* pWorld);
+
+  virtual void Initialize() override;
+
+private:
+  void UpdatePoses(const ezWorldModule::UpdateContext& context);
+  void FinalizePoses(const ezWorldModule::UpdateContext& context);
+};
 
 class EZ_GAMEENGINE_DLL ezAnimatedMeshComponent : public ezSkinnedMeshComponent
 {
@@ -48,14 +64,24 @@ public:
 
 
 protected:
-  void Update();
+  friend class ezAnimatedMeshComponentManager;
+
+  /// \brief Computes the new pose. Called in parallel for many components, so this must only modify the component itself.
+  void UpdatePose();
+
+  /// \brief Publishes the pose computed by UpdatePose() to the rest of the world and the renderer.
+  void FinalizePose();
+
   void CreatePhysicsShapes(const ezSkeletonResourceDescriptor& skeleton, const ezAnimationPose& pose);
 
   void* m_pRagdoll = nullptr;
 
   bool m_bApplyRootMotion = false;
   bool m_bVisualizeSkeleton = false;
+  bool m_bPoseUpdated = false;
   ezAnimationPose m_AnimationPose;
+  ezDynamicArray<ezMat4, ezAlignedAllocatorWrapper> m_SkinningSpacePose;
+  ezTransform m_RootMotion;
   ezSkeletonResourceHandle m_hSkeleton;
   ezAnimationClipSampler m_AnimationClipSampler;
 };
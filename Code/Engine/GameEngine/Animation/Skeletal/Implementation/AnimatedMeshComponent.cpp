@@ -153,30 +153,52 @@ void ezAnimatedMeshComponent::SetAnimationSpeed(float speed)
   m_AnimationClipSampler.SetPlaybackSpeed(speed);
 }
 
-void ezAnimatedMeshComponent::Update()
+void ezAnimatedMeshComponent::UpdatePose()
 {
+  m_bPoseUpdated = false;
+
   if (!m_AnimationClipSampler.GetAnimationClip().IsValid() || !m_hSkeleton.IsValid())
     return;
 
   ezResourceLock<ezSkeletonResource> pSkeleton(m_hSkeleton, ezResourceAcquireMode::AllowLoadingFallback);
   const ezSkeleton& skeleton = pSkeleton->GetDescriptor().m_Skeleton;
 
-  ezTransform rootMotion;
-  rootMotion.SetIdentity();
+  // the skeleton may have been reloaded with a different joint count
+  if (m_AnimationPose.GetTransformCount() != skeleton.GetJointCount())
+    return;
+
+  m_RootMotion.SetIdentity();
 
   m_AnimationPose.SetToBindPoseInLocalSpace(skeleton);
   m_AnimationClipSampler.Step(GetWorld()->GetClock().GetTimeDiff());
-  m_AnimationClipSampler.Execute(skeleton, m_AnimationPose, &rootMotion);
+  m_AnimationClipSampler.Execute(skeleton, m_AnimationPose, &m_RootMotion);
 
   m_AnimationPose.ConvertFromLocalSpaceToObjectSpace(skeleton);
 
+  // keep the pose in object space for ezMsgAnimationPoseUpdated
+  m_SkinningSpacePose.SetCountUninitialized(m_AnimationPose.GetTransformCount());
+  m_AnimationPose.ComputeSkinningTransforms(skeleton, m_SkinningSpacePose);
+
+  m_bPoseUpdated = true;
+}
+
+void ezAnimatedMeshComponent::FinalizePose()
+{
+  if (!m_bPoseUpdated)
+    return;
+
+  ezResourceLock<ezSkeletonResource> pSkeleton(m_hSkeleton, ezResourceAcquireMode::AllowLoadingFallback);
+  const ezSkeleton& skeleton = pSkeleton->GetDescriptor().m_Skeleton;
+
+  if (m_AnimationPose.GetTransformCount() != skeleton.GetJointCount())
+    return;
+
   if (m_bVisualizeSkeleton)
   {
     m_AnimationPose.VisualizePose(GetWorld(), skeleton, GetOwner()->GetGlobalTransform());
   }
 
   // inform child nodes/components that a new skinning pose is available
-  // do this before the pose is transformed into skinning space
   {
     ezMsgAnimationPoseUpdated msg;
     msg.m_pSkeleton = &skeleton;
@@ -185,10 +207,9 @@ void ezAnimatedMeshComponent::Update()
     GetOwner()->SendMessageRecursive(msg);
   }
 
-  m_AnimationPose.ConvertFromObjectSpaceToSkinningSpace(skeleton);
-
-  ezArrayPtr<ezMat4> pRenderMatrices = EZ_NEW_ARRAY(ezFrameAllocator::GetCurrentAllocator(), ezMat4, m_AnimationPose.GetTransformCount());
-  ezMemoryUtils::Copy(pRenderMatrices.GetPtr(), m_AnimationPose.GetAllTransforms().GetPtr(), m_AnimationPose.GetTransformCount());
+  // the frame allocator is not thread-safe, so the render matrices can only be allocated here
+  ezArrayPtr<ezMat4> pRenderMatrices = EZ_NEW_ARRAY(ezFrameAllocator::GetCurrentAllocator(), ezMat4, m_SkinningSpacePose.GetCount());
+  ezMemoryUtils::Copy(pRenderMatrices.GetPtr(), m_SkinningSpacePose.GetData(), m_SkinningSpacePose.GetCount());
 
   m_SkinningMatrices = pRenderMatrices;
 
@@ -197,8 +218,8 @@ void ezAnimatedMeshComponent::Update()
     auto* pOwner = GetOwner();
 
     const ezQuat qOldRot = pOwner->GetLocalRotation();
-    const ezVec3 vNewPos = qOldRot * (rootMotion.m_vPosition * pOwner->GetGlobalScaling().x) + pOwner->GetLocalPosition();
-    const ezQuat qNewRot = rootMotion.m_qRotation * qOldRot;
+    const ezVec3 vNewPos = qOldRot * (m_RootMotion.m_vPosition * pOwner->GetGlobalScaling().x) + pOwner->GetLocalPosition();
+    const ezQuat qNewRot = m_RootMotion.m_qRotation * qOldRot;
 
     pOwner->SetLocalPosition(vNewPos);
     pOwner->SetLocalRotation(qNewRot);
@@ -217,6 +238,55 @@ void ezAnimatedMeshComponent::CreatePhysicsShapes(const ezSkeletonResourceDescri
 
 //////////////////////////////////////////////////////////////////////////
 
+ezAnimatedMeshComponentManager::ezAnimatedMeshComponentManager(ezWorld* pWorld)
+  : ezComponentManager<ezAnimatedMeshComponent, ezBlockStorageType::FreeList>(pWorld)
+{
+}
+
+void ezAnimatedMeshComponentManager::Initialize()
+{
+  {
+    auto desc = EZ_CREATE_MODULE_UPDATE_FUNCTION_DESC(ezAnimatedMeshComponentManager::UpdatePoses, this);
+    desc.m_bOnlyUpdateWhenSimulating = true;
+    desc.m_Phase = ezWorldModule::UpdateFunctionDesc::Phase::Async;
+    desc.m_bAutoGranularity = true;
+
+    RegisterUpdateFunction(desc);
+  }
+
+  {
+    auto desc = EZ_CREATE_MODULE_UPDATE_FUNCTION_DESC(ezAnimatedMeshComponentManager::FinalizePoses, this);
+    desc.m_bOnlyUpdateWhenSimulating = true;
+    desc.m_Phase = ezWorldModule::UpdateFunctionDesc::Phase::PostAsync;
+
+    RegisterUpdateFunction(desc);
+  }
+}
+
+void ezAnimatedMeshComponentManager::UpdatePoses(const ezWorldModule::UpdateContext& context)
+{
+  for (auto it = this->m_ComponentStorage.GetIterator(context.m_uiFirstComponentIndex, context.m_uiComponentCount); it.IsValid(); ++it)
+  {
+    if (it->IsActiveAndInitialized())
+    {
+      it->UpdatePose();
+    }
+  }
+}
+
+void ezAnimatedMeshComponentManager::FinalizePoses(const ezWorldModule::UpdateContext& context)
+{
+  for (auto it = this->m_ComponentStorage.GetIterator(context.m_uiFirstComponentIndex, context.m_uiComponentCount); it.IsValid(); ++it)
+  {
+    if (it->IsActiveAndInitialized())
+    {
+      it->FinalizePose();
+    }
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////
+
 #include <Foundation/Serialization/GraphPatch.h>
 
 class ezAnimatedMeshComponentPatch_4_5 : public ezGraphPatch
@@ -1,9 +1,11 @@
 #include <GameEnginePCH.h>
 
 #include <Core/Input/InputManager.h>
+#include <Foundation/Algorithm/HashingUtils.h>
 #include <Core/WorldSerializer/WorldReader.h>
 #include <Core/WorldSerializer/WorldWriter.h>
 #include <GameEngine/Animation/Skeletal/MotionMatchingComponent.h>
+#include <GameEngine/Animation/Skeletal/MotionMatchingDatabase.h>
 #include <RendererCore/AnimationSystem/AnimationClipResource.h>
 #include <RendererCore/AnimationSystem/SkeletonResource.h>
 #include <RendererCore/Debug/DebugRenderer.h>
@@ -97,12 +99,9 @@ void ezMotionMatchingComponent::OnSimulationStarted()
   m_Keyframe1.m_uiAnimClip = 0;
   m_Keyframe1.m_uiKeyframe = 1;
 
-  for (ezUInt32 anim = 0; anim < m_Animations.GetCount(); ++anim)
+  if (m_hSkeleton.IsValid())
   {
-    ezResourceLock<ezAnimationClipResource> pClip(m_Animations[anim], ezResourceAcquireMode::BlockTillLoaded);
-    ezResourceLock<ezSkeletonResource> pSkeleton(m_hSkeleton, ezResourceAcquireMode::AllowLoadingFallback);
-
-    PrecomputeMotion(m_MotionData, "Bip01_L_Foot", "Bip01_R_Foot", pClip->GetDescriptor(), anim, pSkeleton->GetDescriptor().m_Skeleton);
+    m_pDatabase = static_cast<ezMotionMatchingComponentManager*>(GetOwningManager())->GetOrCreateDatabase(m_Animations, m_hSkeleton);
   }
 
   m_vLeftFootPos.SetZero();
@@ -178,12 +177,16 @@ ezQuat ezMotionMatchingComponent::GetInputRotation() const
 
 void ezMotionMatchingComponent::Update()
 {
-  if (!m_hSkeleton.IsValid() || m_Animations.IsEmpty())
+  if (!m_hSkeleton.IsValid() || m_Animations.IsEmpty() || m_pDatabase == nullptr)
     return;
 
   ezResourceLock<ezSkeletonResource> pSkeleton(m_hSkeleton, ezResourceAcquireMode::AllowLoadingFallback);
   const ezSkeleton& skeleton = pSkeleton->GetDescriptor().m_Skeleton;
 
+  // the skeleton was changed after the database was built
+  if (skeleton.GetJointCount() != m_AnimationPose.GetTransformCount() || m_pDatabase->GetJointMapping(0).GetCount() != skeleton.GetJointCount())
+    return;
+
   // ezTransform rootMotion;
   // rootMotion.SetIdentity();
 
@@ -218,22 +221,19 @@ void ezMotionMatchingComponent::Update()
     const auto& animDesc0 = pAnimClip0->GetDescriptor();
     const auto& animDesc1 = pAnimClip1->GetDescriptor();
 
-    const auto& animatedJoints0 = animDesc0.GetAllJointIndices();
+    const ezArrayPtr<const ezUInt16> jointMapping0 = m_pDatabase->GetJointMapping(m_Keyframe0.m_uiAnimClip);
+    const ezArrayPtr<const ezUInt16> jointMapping1 = m_pDatabase->GetJointMapping(m_Keyframe1.m_uiAnimClip);
 
-    for (ezUInt32 b = 0; b < animatedJoints0.GetCount(); ++b)
+    for (ezUInt16 uiSkeletonJointIdx = 0; uiSkeletonJointIdx < jointMapping0.GetCount(); ++uiSkeletonJointIdx)
     {
-      const ezHashedString sJointName = animatedJoints0.GetKey(b);
-      const ezUInt32 uiAnimJointIdx0 = animatedJoints0.GetValue(b);
-      const ezUInt32 uiAnimJointIdx1 = animDesc1.FindJointIndexByName(sJointName);
+      const ezUInt16 uiAnimJointIdx0 = jointMapping0[uiSkeletonJointIdx];
+      const ezUInt16 uiAnimJointIdx1 = jointMapping1[uiSkeletonJointIdx];
 
-      const ezUInt16 uiSkeletonJointIdx = skeleton.FindJointByName(sJointName);
-      if (uiSkeletonJointIdx != ezInvalidJointIndex)
+      if (uiAnimJointIdx0 != ezInvalidJointIndex)
       {
-        ezArrayPtr<const ezTransform> pTransforms0 = animDesc0.GetJointKeyframes(uiAnimJointIdx0);
-        ezArrayPtr<const ezTransform> pTransforms1 = animDesc1.GetJointKeyframes(uiAnimJointIdx1);
-
-        const ezTransform jointTransform1 = pTransforms0[m_Keyframe0.m_uiKeyframe];
-        const ezTransform jointTransform2 = pTransforms1[m_Keyframe1.m_uiKeyframe];
+        const ezTransform jointTransform1 = animDesc0.GetJointTransform(uiAnimJointIdx0, m_Keyframe0.m_uiKeyframe);
+        const ezTransform jointTransform2 =
+          uiAnimJointIdx1 != ezInvalidJointIndex ? animDesc1.GetJointTransform(uiAnimJointIdx1, m_Keyframe1.m_uiKeyframe) : jointTransform1;
 
         ezTransform res;
         res.m_vPosition = ezMath::Lerp(jointTransform1.m_vPosition, jointTransform2.m_vPosition, m_fKeyframeLerp);
@@ -253,9 +253,9 @@ void ezMotionMatchingComponent::Update()
       vRootMotion1.SetZero();
 
       if (animDesc0.HasRootMotion())
-        vRootMotion0 = animDesc0.GetJointKeyframes(animDesc0.GetRootMotionJoint())[m_Keyframe0.m_uiKeyframe].m_vPosition;
+        vRootMotion0 = animDesc0.GetJointTransform(animDesc0.GetRootMotionJoint(), m_Keyframe0.m_uiKeyframe).m_vPosition;
       if (animDesc1.HasRootMotion())
-        vRootMotion1 = animDesc1.GetJointKeyframes(animDesc1.GetRootMotionJoint())[m_Keyframe1.m_uiKeyframe].m_vPosition;
+        vRootMotion1 = animDesc1.GetJointTransform(animDesc1.GetRootMotionJoint(), m_Keyframe1.m_uiKeyframe).m_vPosition;
 
       const ezVec3 vRootMotion =
         ezMath::Lerp(vRootMotion0, vRootMotion1, m_fKeyframeLerp) * fKeyframeFraction * pOwner->GetGlobalScaling().x;
@@ -273,8 +273,8 @@ void ezMotionMatchingComponent::Update()
 
   m_AnimationPose.ConvertFromLocalSpaceToObjectSpace(skeleton);
 
-  const ezUInt16 uiLeftFootJoint = skeleton.FindJointByName("Bip01_L_Foot");
-  const ezUInt16 uiRightFootJoint = skeleton.FindJointByName("Bip01_R_Foot");
+  const ezUInt16 uiLeftFootJoint = m_pDatabase->GetLeftFootJoint();
+  const ezUInt16 uiRightFootJoint = m_pDatabase->GetRightFootJoint();
   if (uiLeftFootJoint != ezInvalidJointIndex && uiRightFootJoint != ezInvalidJointIndex)
   {
     ezTransform tLeft, tRight;
@@ -295,10 +295,8 @@ void ezMotionMatchingComponent::Update()
     m_vRightFootPos = tRight.m_vPosition;
   }
 
-  m_AnimationPose.ConvertFromObjectSpaceToSkinningSpace(skeleton);
-
   ezArrayPtr<ezMat4> pRenderMatrices = EZ_NEW_ARRAY(ezFrameAllocator::GetCurrentAllocator(), ezMat4, m_AnimationPose.GetTransformCount());
-  ezMemoryUtils::Copy(pRenderMatrices.GetPtr(), m_AnimationPose.GetAllTransforms().GetPtr(), m_AnimationPose.GetTransformCount());
+  m_AnimationPose.ComputeSkinningTransforms(skeleton, pRenderMatrices);
 
   m_SkinningMatrices = pRenderMatrices;
 }
@@ -359,32 +357,30 @@ void ezMotionMatchingComponent::Animations_Remove(ezUInt32 uiIndex)
   m_Animations.RemoveAtAndCopy(uiIndex);
 }
 
-ezMotionMatchingComponent::TargetKeyframe ezMotionMatchingComponent::FindNextKeyframe(const TargetKeyframe& current,
+ezMotionMatchingDatabase::Keyframe ezMotionMatchingComponent::FindNextKeyframe(const ezMotionMatchingDatabase::Keyframe& current,
   const ezVec3& vTargetDir) const
 {
-  TargetKeyframe kf;
+  ezMotionMatchingDatabase::Keyframe kf;
   kf.m_uiAnimClip = current.m_uiAnimClip;
   kf.m_uiKeyframe = current.m_uiKeyframe + 1;
 
   {
-    // ezResourceLock<ezAnimationClipResource> pAnimClipCur(m_Animations[current.m_uiAnimClip], ezResourceAcquireMode::NoFallback);
-    // const auto& animClip = pAnimClipCur->GetDescriptor();
-
-    // const ezUInt32 uiLeftFootJoint = animClip.FindJointIndexByName("Bip01_L_Foot");
-    // const ezUInt32 uiRightFootJoint = animClip.FindJointIndexByName("Bip01_R_Foot");
+    ezMotionMatchingDatabase::Query query;
+    query.m_Current = current;
+    query.m_vLeftFootPosition = m_vLeftFootPos;
+    query.m_vRightFootPosition = m_vRightFootPos;
+    query.m_vTargetVelocity = vTargetDir;
 
-    const ezVec3 vLeftFootPos = m_vLeftFootPos;   // animClip.GetJointKeyframes(uiLeftFootJoint)[current.m_uiKeyframe].m_vPosition;
-    const ezVec3 vRightFootPos = m_vRightFootPos; // animClip.GetJointKeyframes(uiRightFootJoint)[current.m_uiKeyframe].m_vPosition;
+    const ezUInt32 uiBestMM = m_pDatabase->FindBestKeyframe(query);
 
-    const ezUInt32 uiBestMM = FindBestKeyframe(current, vLeftFootPos, vRightFootPos, vTargetDir);
-
-    TargetKeyframe nkf;
-    nkf.m_uiAnimClip = m_MotionData[uiBestMM].m_uiAnimClipIndex;
-    nkf.m_uiKeyframe = m_MotionData[uiBestMM].m_uiKeyframeIndex;
-
-    if ((nkf.m_uiAnimClip != kf.m_uiAnimClip) || (nkf.m_uiKeyframe != kf.m_uiKeyframe && nkf.m_uiKeyframe != current.m_uiKeyframe))
+    if (uiBestMM != ezInvalidIndex)
     {
-      kf = nkf;
+      const ezMotionMatchingDatabase::Keyframe& nkf = m_pDatabase->GetKeyframe(uiBestMM);
+
+      if ((nkf.m_uiAnimClip != kf.m_uiAnimClip) || (nkf.m_uiKeyframe != kf.m_uiKeyframe && nkf.m_uiKeyframe != current.m_uiKeyframe))
+      {
+        kf = nkf;
+      }
     }
   }
 
@@ -399,123 +395,87 @@ ezMotionMatchingComponent::TargetKeyframe ezMotionMatchingComponent::FindNextKey
   return kf;
 }
 
-void ezMotionMatchingComponent::PrecomputeMotion(ezDynamicArray<MotionData>& motionData, ezTempHashedString jointName1,
-  ezTempHashedString jointName2, const ezAnimationClipResourceDescriptor& animClip,
-  ezUInt16 uiAnimClipIndex, const ezSkeleton& skeleton)
-{
-  const ezUInt16 uiRootJoint = animClip.HasRootMotion() ? animClip.GetRootMotionJoint() : 0xFFFFFFFFu;
-  // const ezUInt16 uiJoint1IndexInAnim = animClip.FindJointIndexByName(jointName1);
-  // const ezUInt16 uiJoint2IndexInAnim = animClip.FindJointIndexByName(jointName2);
+//////////////////////////////////////////////////////////////////////////
 
-  const ezUInt16 uiJoint1IndexInSkeleton = skeleton.FindJointByName(jointName1);
-  const ezUInt16 uiJoint2IndexInSkeleton = skeleton.FindJointByName(jointName2);
-  if (uiJoint1IndexInSkeleton == ezInvalidJointIndex || uiJoint2IndexInSkeleton == ezInvalidJointIndex)
-    return;
-
-  const auto& jointNamesToIndices = animClip.GetAllJointIndices();
-
-  const ezUInt32 uiFirstMotionDataIdx = motionData.GetCount();
-  motionData.Reserve(uiFirstMotionDataIdx + animClip.GetNumFrames());
-
-  const float fRootMotionToVelocity = animClip.GetFramesPerSecond();
-
-  ezAnimationPose pose;
-  pose.Configure(skeleton);
-
-  for (ezUInt16 uiFrameIdx = 0; uiFrameIdx < animClip.GetNumFrames(); ++uiFrameIdx)
-  {
-    pose.SetToBindPoseInLocalSpace(skeleton);
+ezMotionMatchingComponentManager::ezMotionMatchingComponentManager(ezWorld* pWorld)
+  : ezComponentManager<ezMotionMatchingComponent, ezBlockStorageType::FreeList>(pWorld)
+{
+}
 
-    for (ezUInt32 b = 0; b < jointNamesToIndices.GetCount(); ++b)
-    {
-      const ezUInt16 uiJointIndexInPose = skeleton.FindJointByName(jointNamesToIndices.GetKey(b));
-      if (uiJointIndexInPose != ezInvalidJointIndex)
-      {
-        const ezTransform jointTransform = animClip.GetJointKeyframes(jointNamesToIndices.GetValue(b))[uiFrameIdx];
+void ezMotionMatchingComponentManager::Initialize()
+{
+  auto desc = EZ_CREATE_MODULE_UPDATE_FUNCTION_DESC(ezMotionMatchingComponentManager::Update, this);
+  desc.m_bOnlyUpdateWhenSimulating = true;
 
-        pose.SetTransform(uiJointIndexInPose, jointTransform.GetAsMat4());
-      }
-    }
+  RegisterUpdateFunction(desc);
+}
 
-    pose.ConvertFromLocalSpaceToObjectSpace(skeleton);
-
-    MotionData& md = motionData.ExpandAndGetRef();
-    md.m_vLeftFootPosition = pose.GetTransform(uiJoint1IndexInSkeleton).GetTranslationVector();
-    md.m_vRightFootPosition = pose.GetTransform(uiJoint2IndexInSkeleton).GetTranslationVector();
-    md.m_uiAnimClipIndex = uiAnimClipIndex;
-    md.m_uiKeyframeIndex = uiFrameIdx;
-    md.m_vLeftFootVelocity.SetZero();
-    md.m_vRightFootVelocity.SetZero();
-    md.m_vRootVelocity = animClip.HasRootMotion() ? fRootMotionToVelocity * animClip.GetJointKeyframes(uiRootJoint)[uiFrameIdx].m_vPosition
-                                                  : ezVec3::ZeroVector();
-  }
+void ezMotionMatchingComponentManager::Deinitialize()
+{
+  m_Databases.Clear();
+}
 
-  // now compute the velocity
+void ezMotionMatchingComponentManager::Update(const ezWorldModule::UpdateContext& context)
+{
+  for (auto it = this->m_ComponentStorage.GetIterator(context.m_uiFirstComponentIndex, context.m_uiComponentCount); it.IsValid(); ++it)
   {
-    const float fScaleToVelPerSec = animClip.GetFramesPerSecond();
-
-    ezUInt32 uiPrevMdIdx = motionData.GetCount() - 1;
-
-    for (ezUInt32 uiMotionDataIdx = uiFirstMotionDataIdx; uiMotionDataIdx < motionData.GetCount(); ++uiMotionDataIdx)
+    if (it->IsActiveAndInitialized())
     {
-      {
-        ezVec3 vel = motionData[uiMotionDataIdx].m_vLeftFootPosition - motionData[uiPrevMdIdx].m_vLeftFootPosition;
-        motionData[uiMotionDataIdx].m_vLeftFootVelocity = vel * fScaleToVelPerSec;
-      }
-      {
-        ezVec3 vel = motionData[uiMotionDataIdx].m_vRightFootPosition - motionData[uiPrevMdIdx].m_vRightFootPosition;
-        motionData[uiMotionDataIdx].m_vRightFootVelocity = vel * fScaleToVelPerSec;
-      }
-
-      uiPrevMdIdx = uiMotionDataIdx;
+      it->Update();
     }
   }
 }
 
-ezUInt32 ezMotionMatchingComponent::FindBestKeyframe(const TargetKeyframe& current, ezVec3 vLeftFootPosition, ezVec3 vRightFootPosition,
-  ezVec3 vTargetDir) const
+ezSharedPtr<ezMotionMatchingDatabase> ezMotionMatchingComponentManager::GetOrCreateDatabase(
+  ezArrayPtr<const ezAnimationClipResourceHandle> animClips, const ezSkeletonResourceHandle& hSkeleton)
 {
-  float fClosest = 1000000000.0f;
-  ezUInt32 uiClosest = 0xFFFFFFFFu;
+  // the database only depends on the exact state of the skeleton and all clips
+  ezHybridArray<ezUInt32, 32> key;
 
-  const float fDirWeight = 3.0f;
+  {
+    ezResourceLock<ezSkeletonResource> pSkeleton(hSkeleton, ezResourceAcquireMode::BlockTillLoaded);
+    key.PushBack(pSkeleton->GetResourceIDHash());
+    key.PushBack(pSkeleton->GetDescriptor().m_Skeleton.GetJointSetupID());
+  }
 
-  for (ezUInt32 i = 0; i < m_MotionData.GetCount(); ++i)
+  for (const ezAnimationClipResourceHandle& hAnimClip : animClips)
   {
-    const auto& md = m_MotionData[i];
+    ezResourceLock<ezAnimationClipResource> pAnimClip(hAnimClip, ezResourceAcquireMode::BlockTillLoaded);
+    key.PushBack(pAnimClip->GetResourceIDHash());
+    key.PushBack(pAnimClip->GetCurrentResourceChangeCounter());
+  }
 
-    float penaltyMul = 1.1f;
-    float penaltyAdd = 100;
+  const ezUInt64 uiKey = ezHashingUtils::xxHash64(key.GetData(), key.GetCount() * sizeof(ezUInt32));
 
-    if (md.m_uiAnimClipIndex == current.m_uiAnimClip)
-    {
-      // do NOT allow to transition backwards to a keyframe within a certain range
-      if (md.m_uiKeyframeIndex < current.m_uiKeyframe && md.m_uiKeyframeIndex + 10 > current.m_uiKeyframe)
-        continue;
+  ezSharedPtr<ezMotionMatchingDatabase> pDatabase;
+  if (m_Databases.TryGetValue(uiKey, pDatabase))
+    return pDatabase;
 
-      penaltyMul = 1.0f;
+  // drop the databases that no component uses anymore, e.g. because the clips were modified
+  for (auto it = m_Databases.GetIterator(); it.IsValid();)
+  {
+    if (it.Value()->GetRefCount() == 1)
+      it = m_Databases.Remove(it);
+    else
+      ++it;
+  }
 
-      if (md.m_uiKeyframeIndex == current.m_uiKeyframe)
-      {
-        penaltyAdd = 0;
-        penaltyMul = 0.9f;
-      }
-    }
+  pDatabase = EZ_DEFAULT_NEW(ezMotionMatchingDatabase);
 
-    const float dirDist = ezMath::Pow((md.m_vRootVelocity - vTargetDir).GetLength(), fDirWeight);
-    const float leftFootDist = (md.m_vLeftFootPosition - vLeftFootPosition).GetLengthSquared();
-    const float rightFootDist = (md.m_vRightFootPosition - vRightFootPosition).GetLengthSquared();
+  ezResourceLock<ezSkeletonResource> pSkeleton(hSkeleton, ezResourceAcquireMode::BlockTillLoaded);
+  const ezSkeleton& skeleton = pSkeleton->GetDescriptor().m_Skeleton;
 
-    const float fScore = dirDist + (leftFootDist + rightFootDist) * penaltyMul + penaltyAdd;
+  pDatabase->Initialize(skeleton, ezTempHashedString("Bip01_L_Foot"), ezTempHashedString("Bip01_R_Foot"));
 
-    if (fScore < fClosest)
-    {
-      fClosest = fScore;
-      uiClosest = i;
-    }
+  for (const ezAnimationClipResourceHandle& hAnimClip : animClips)
+  {
+    ezResourceLock<ezAnimationClipResource> pAnimClip(hAnimClip, ezResourceAcquireMode::BlockTillLoaded);
+    pDatabase->AddAnimationClip(skeleton, pAnimClip->GetDescriptor());
   }
 
-  return uiClosest;
+  m_Databases.Insert(uiKey, pDatabase);
+
+  return pDatabase;
 }
 
 
@@ -0,0 +1,208 @@
+#include <GameEnginePCH.h>
+
+#include <GameEngine/Animation/Skeletal/MotionMatchingDatabase.h>
+#include <RendererCore/AnimationSystem/AnimationClipResource.h>
+#include <RendererCore/AnimationSystem/AnimationPose.h>
+#include <RendererCore/AnimationSystem/JointMapping.h>
+#include <RendererCore/AnimationSystem/Skeleton.h>
+
+void ezMotionMatchingDatabase::Initialize(const ezSkeleton& skeleton, const ezTempHashedString& sLeftFootJoint,
+  const ezTempHashedString& sRightFootJoint)
+{
+  m_Keyframes.Clear();
+  m_Features.Clear();
+  m_FeatureBlocks.Clear();
+  m_JointMappings.Clear();
+
+  m_uiNumSkeletonJoints = skeleton.GetJointCount();
+  m_uiLeftFootJoint = skeleton.FindJointByName(sLeftFootJoint);
+  m_uiRightFootJoint = skeleton.FindJointByName(sRightFootJoint);
+}
+
+void ezMotionMatchingDatabase::AddAnimationClip(const ezSkeleton& skeleton, const ezAnimationClipResourceDescriptor& animClip)
+{
+  EZ_ASSERT_DEV(skeleton.GetJointCount() == m_uiNumSkeletonJoints, "The database was initialized with a different skeleton");
+
+  const ezUInt16 uiAnimClipIndex = static_cast<ezUInt16>(m_JointMappings.GetCount() / ezMath::Max<ezUInt32>(m_uiNumSkeletonJoints, 1));
+
+  // resolve the joint names once
+  ezJointMapping jointMapping;
+  jointMapping.CreateMapping(skeleton, animClip);
+
+  {
+    const ezUInt32 uiFirstEntry = m_JointMappings.GetCount();
+    m_JointMappings.SetCount(uiFirstEntry + m_uiNumSkeletonJoints, ezInvalidJointIndex);
+
+    for (const ezJointMapping::Mapping& m : jointMapping.GetAllMappings())
+    {
+      m_JointMappings[uiFirstEntry + m.m_uiJointInSkeleton] = m.m_uiJointInAnimation;
+    }
+  }
+
+  // without the feet there is nothing to match, the clip can still be played back though
+  if (m_uiLeftFootJoint == ezInvalidJointIndex || m_uiRightFootJoint == ezInvalidJointIndex)
+    return;
+
+  const ezUInt16 uiRootJoint = animClip.HasRootMotion() ? animClip.GetRootMotionJoint() : ezInvalidJointIndex;
+  const float fRootMotionToVelocity = animClip.GetFramesPerSecond();
+
+  ezAnimationPose pose;
+  pose.Configure(skeleton);
+
+  m_Keyframes.Reserve(m_Keyframes.GetCount() + animClip.GetNumFrames());
+  m_Features.Reserve(m_Features.GetCount() + animClip.GetNumFrames());
+
+  for (ezUInt16 uiFrameIdx = 0; uiFrameIdx < animClip.GetNumFrames(); ++uiFrameIdx)
+  {
+    pose.SetToBindPoseInLocalSpace(skeleton);
+
+    for (const ezJointMapping::Mapping& m : jointMapping.GetAllMappings())
+    {
+      pose.SetTransform(m.m_uiJointInSkeleton, animClip.GetJointTransform(m.m_uiJointInAnimation, uiFrameIdx).GetAsMat4());
+    }
+
+    pose.ConvertFromLocalSpaceToObjectSpace(skeleton);
+
+    Keyframe& kf = m_Keyframes.ExpandAndGetRef();
+    kf.m_uiAnimClip = uiAnimClipIndex;
+    kf.m_uiKeyframe = uiFrameIdx;
+
+    Features& f = m_Features.ExpandAndGetRef();
+    f.m_vLeftFootPosition = pose.GetTransform(m_uiLeftFootJoint).GetTranslationVector();
+    f.m_vRightFootPosition = pose.GetTransform(m_uiRightFootJoint).GetTranslationVector();
+    f.m_vRootVelocity = uiRootJoint != ezInvalidJointIndex ? fRootMotionToVelocity * animClip.GetJointTransform(uiRootJoint, uiFrameIdx).m_vPosition
+                                                           : ezVec3::ZeroVector();
+  }
+
+  UpdateFeatureBlocks();
+}
+
+ezArrayPtr<const ezUInt16> ezMotionMatchingDatabase::GetJointMapping(ezUInt32 uiAnimClip) const
+{
+  return m_JointMappings.GetArrayPtr().GetSubArray(uiAnimClip * m_uiNumSkeletonJoints, m_uiNumSkeletonJoints);
+}
+
+void ezMotionMatchingDatabase::UpdateFeatureBlocks()
+{
+  const ezUInt32 uiNumKeyframes = m_Features.GetCount();
+
+  m_FeatureBlocks.SetCount((uiNumKeyframes + 3) / 4);
+
+  for (ezUInt32 uiBlock = 0; uiBlock < m_FeatureBlocks.GetCount(); ++uiBlock)
+  {
+    Features features[4] = {};
+    ezInt32 animClips[4] = {};
+    ezInt32 keyframes[4] = {};
+
+    // the padding at the end is excluded by FindBestKeyframe()
+    for (ezUInt32 i = 0; i < 4 && uiBlock * 4 + i < uiNumKeyframes; ++i)
+    {
+      features[i] = m_Features[uiBlock * 4 + i];
+      animClips[i] = m_Keyframes[uiBlock * 4 + i].m_uiAnimClip;
+      keyframes[i] = m_Keyframes[uiBlock * 4 + i].m_uiKeyframe;
+    }
+
+    FeatureBlock& block = m_FeatureBlocks[uiBlock];
+
+    for (ezUInt32 c = 0; c < 3; ++c)
+    {
+      block.m_LeftFoot[c] = ezSimdVec4f(features[0].m_vLeftFootPosition.GetData()[c], features[1].m_vLeftFootPosition.GetData()[c],
+        features[2].m_vLeftFootPosition.GetData()[c], features[3].m_vLeftFootPosition.GetData()[c]);
+      block.m_RightFoot[c] = ezSimdVec4f(features[0].m_vRightFootPosition.GetData()[c], features[1].m_vRightFootPosition.GetData()[c],
+        features[2].m_vRightFootPosition.GetData()[c], features[3].m_vRightFootPosition.GetData()[c]);
+      block.m_RootVelocity[c] = ezSimdVec4f(features[0].m_vRootVelocity.GetData()[c], features[1].m_vRootVelocity.GetData()[c],
+        features[2].m_vRootVelocity.GetData()[c], features[3].m_vRootVelocity.GetData()[c]);
+    }
+
+    block.m_AnimClip = ezSimdVec4i(animClips[0], animClips[1], animClips[2], animClips[3]);
+    block.m_Keyframe = ezSimdVec4i(keyframes[0], keyframes[1], keyframes[2], keyframes[3]);
+  }
+}
+
+ezUInt32 ezMotionMatchingDatabase::FindBestKeyframe(const Query& query) const
+{
+  const ezSimdVec4f vLeftFoot[3] = {
+    ezSimdVec4f(query.m_vLeftFootPosition.x), ezSimdVec4f(query.m_vLeftFootPosition.y), ezSimdVec4f(query.m_vLeftFootPosition.z)};
+  const ezSimdVec4f vRightFoot[3] = {
+    ezSimdVec4f(query.m_vRightFootPosition.x), ezSimdVec4f(query.m_vRightFootPosition.y), ezSimdVec4f(query.m_vRightFootPosition.z)};
+  const ezSimdVec4f vTargetVelocity[3] = {
+    ezSimdVec4f(query.m_vTargetVelocity.x), ezSimdVec4f(query.m_vTargetVelocity.y), ezSimdVec4f(query.m_vTargetVelocity.z)};
+
+  const ezSimdVec4i iCurrentClip(query.m_Current.m_uiAnimClip);
+  const ezSimdVec4i iCurrentKeyframe(query.m_Current.m_uiKeyframe);
+  const ezSimdVec4i iMinBackwardsKeyframe(query.m_Current.m_uiKeyframe - 10);
+  const ezSimdVec4i iNumKeyframes(m_Keyframes.GetCount());
+
+  const ezSimdVec4f vInfinity(ezMath::Infinity<float>());
+
+  ezSimdVec4f vBestScore = vInfinity;
+  ezSimdVec4f vBestIndex(-1.0f);
+  ezSimdVec4f vIndex(0.0f, 1.0f, 2.0f, 3.0f);
+  ezSimdVec4i iIndex(0, 1, 2, 3);
+
+  for (const FeatureBlock& block : m_FeatureBlocks)
+  {
+    ezSimdVec4f vDirDistSqr = ezSimdVec4f::ZeroVector();
+    ezSimdVec4f vFootDist = ezSimdVec4f::ZeroVector();
+
+    for (ezUInt32 c = 0; c < 3; ++c)
+    {
+      const ezSimdVec4f vDir = block.m_RootVelocity[c] - vTargetVelocity[c];
+      const ezSimdVec4f vLeft = block.m_LeftFoot[c] - vLeftFoot[c];
+      const ezSimdVec4f vRight = block.m_RightFoot[c] - vRightFoot[c];
+
+      vDirDistSqr = ezSimdVec4f::MulAdd(vDir, vDir, vDirDistSqr);
+      vFootDist = ezSimdVec4f::MulAdd(vLeft, vLeft, vFootDist);
+      vFootDist = ezSimdVec4f::MulAdd(vRight, vRight, vFootDist);
+    }
+
+    // the velocity difference is weighted with the power of three
+    const ezSimdVec4f vDirDist = vDirDistSqr.CompMul(vDirDistSqr.GetSqrt());
+
+    const ezSimdVec4b bSameClip = block.m_AnimClip == iCurrentClip;
+    const ezSimdVec4b bSameKeyframe = bSameClip && (block.m_Keyframe == iCurrentKeyframe);
+
+    // do NOT allow to transition backwards to a keyframe within a certain range
+    const ezSimdVec4b bBackwards = bSameClip && (block.m_Keyframe < iCurrentKeyframe) && (block.m_Keyframe > iMinBackwardsKeyframe);
+
+    // keyframes of other clips are penalized
+    const ezSimdVec4f vPenaltyMul = ezSimdVec4f::Select(bSameClip, ezSimdVec4f::Select(bSameKeyframe, ezSimdVec4f(0.9f), ezSimdVec4f(1.0f)), ezSimdVec4f(1.1f));
+    const ezSimdVec4f vPenaltyAdd = ezSimdVec4f::Select(bSameKeyframe, ezSimdVec4f::ZeroVector(), ezSimdVec4f(100.0f));
+
+    ezSimdVec4f vScore = ezSimdVec4f::MulAdd(vFootDist, vPenaltyMul, vDirDist + vPenaltyAdd);
+    vScore = ezSimdVec4f::Select(!bBackwards && (iIndex < iNumKeyframes), vScore, vInfinity);
+
+    const ezSimdVec4b bBetter = vScore < vBestScore;
+    vBestScore = ezSimdVec4f::Select(bBetter, vScore, vBestScore);
+    vBestIndex = ezSimdVec4f::Select(bBetter, vIndex, vBestIndex);
+
+    vIndex += ezSimdVec4f(4.0f);
+    iIndex += ezSimdVec4i(4);
+  }
+
+  float fBestScore[4];
+  float fBestIndex[4];
+  vBestScore.Store<4>(fBestScore);
+  vBestIndex.Store<4>(fBestIndex);
+
+  // every lane has the first best keyframe of its subset, of equal scores prefer the lowest index like a linear search would
+  ezUInt32 uiBest = ezInvalidIndex;
+  float fBest = ezMath::Infinity<float>();
+
+  for (ezUInt32 i = 0; i < 4; ++i)
+  {
+    const ezUInt32 uiIndex = static_cast<ezUInt32>(fBestIndex[i]);
+
+    if (fBestScore[i] < fBest || (fBestScore[i] == fBest && fBestScore[i] != ezMath::Infinity<float>() && uiIndex < uiBest))
+    {
+      fBest = fBestScore[i];
+      uiBest = uiIndex;
+    }
+  }
+
+  return uiBest;
+}
+
+
+
+EZ_STATICLINK_FILE(GameEngine, GameEngine_Animation_Skeletal_Implementation_MotionMatchingDatabase);
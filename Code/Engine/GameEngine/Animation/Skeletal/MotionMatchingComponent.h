@@ -1,5 +1,7 @@
 #pragma once
 
+#include <Foundation/Types/SharedPtr.h>
+#include <GameEngine/Animation/Skeletal/MotionMatchingDatabase.h>
 #include <GameEngine/GameEngineDLL.h>
 #include <RendererCore/AnimationSystem/AnimationGraph/AnimationClipSampler.h>
 #include <RendererCore/AnimationSystem/AnimationPose.h>
@@ -8,7 +10,25 @@
 typedef ezTypedResourceHandle<class ezAnimationClipResource> ezAnimationClipResourceHandle;
 typedef ezTypedResourceHandle<class ezSkeletonResource> ezSkeletonResourceHandle;
 
-typedef ezComponentManagerSimple<class ezMotionMatchingComponent, ezComponentUpdateType::WhenSimulating> ezMotionMatchingComponentManager;
+/// \brief Updates all motion matching components and owns the feature databases they search through.
+class EZ_GAMEENGINE_DLL ezMotionMatchingComponentManager : public ezComponentManager<class ezMotionMatchingComponent, ezBlockStorageType::FreeList>
+{
+public:
+  ezMotionMatchingComponentManager(ezWorld* pWorld);
+
+  virtual void Initialize() override;
+  virtual void Deinitialize() override;
+
+  /// \brief Returns the feature database for the given clips and skeleton. Blocks until all of them are loaded.
+  ///
+  /// Components that use the same clips with the same skeleton share one database, so it is only computed once.
+  ezSharedPtr<ezMotionMatchingDatabase> GetOrCreateDatabase(ezArrayPtr<const ezAnimationClipResourceHandle> animClips, const ezSkeletonResourceHandle& hSkeleton);
+
+private:
+  void Update(const ezWorldModule::UpdateContext& context);
+
+  ezHashTable<ezUInt64, ezSharedPtr<ezMotionMatchingDatabase>> m_Databases;
+};
 
 class EZ_GAMEENGINE_DLL ezMotionMatchingComponent : public ezSkinnedMeshComponent
 {
@@ -36,6 +56,8 @@ public:
   ezAnimationClipResourceHandle GetAnimation(ezUInt32 uiIndex) const;
 
 protected:
+  friend class ezMotionMatchingComponentManager;
+
   void Update();
 
   ezUInt32 Animations_GetCount() const;                          // [ property ]
@@ -56,33 +78,11 @@ protected:
   ezVec3 m_vLeftFootPos;
   ezVec3 m_vRightFootPos;
 
-  struct MotionData
-  {
-    ezUInt16 m_uiAnimClipIndex;
-    ezUInt16 m_uiKeyframeIndex;
-    ezVec3 m_vLeftFootPosition;
-    ezVec3 m_vLeftFootVelocity;
-    ezVec3 m_vRightFootPosition;
-    ezVec3 m_vRightFootVelocity;
-    ezVec3 m_vRootVelocity;
-  };
-
-  struct TargetKeyframe
-  {
-    ezUInt16 m_uiAnimClip;
-    ezUInt16 m_uiKeyframe;
-  };
-
-  TargetKeyframe m_Keyframe0;
-  TargetKeyframe m_Keyframe1;
+  ezMotionMatchingDatabase::Keyframe m_Keyframe0;
+  ezMotionMatchingDatabase::Keyframe m_Keyframe1;
   float m_fKeyframeLerp = 0.0f;
 
-  TargetKeyframe FindNextKeyframe(const TargetKeyframe& current, const ezVec3& vTargetDir) const;
-
-  ezDynamicArray<MotionData> m_MotionData;
-
-  static void PrecomputeMotion(ezDynamicArray<MotionData>& motionData, ezTempHashedString jointName1, ezTempHashedString jointName2,
-    const ezAnimationClipResourceDescriptor& animClip, ezUInt16 uiAnimClipIndex, const ezSkeleton& skeleton);
+  ezMotionMatchingDatabase::Keyframe FindNextKeyframe(const ezMotionMatchingDatabase::Keyframe& current, const ezVec3& vTargetDir) const;
 
-  ezUInt32 FindBestKeyframe(const TargetKeyframe& current, ezVec3 vLeftFootPosition, ezVec3 vRightFootPosition, ezVec3 vTargetDir) const;
+  ezSharedPtr<ezMotionMatchingDatabase> m_pDatabase;
 };
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <Foundation/Containers/DynamicArray.h>
+#include <Foundation/SimdMath/SimdVec4f.h>
+#include <Foundation/SimdMath/SimdVec4i.h>
+#include <Foundation/Strings/HashedString.h>
+#include <Foundation/Types/RefCounted.h>
+#include <GameEngine/GameEngineDLL.h>
+#include <RendererCore/AnimationSystem/Declarations.h>
+
+/// \brief The precomputed features of all keyframes of a set of animation clips, which motion matching searches through.
+///
+/// For every keyframe this stores the object space positions of both feet and the root motion velocity.
+/// The features are stored in blocks of four keyframes (structure of arrays), such that a search compares four keyframes at once.
+/// Additionally the mapping from skeleton joints to clip joints is computed once per clip.
+///
+/// The database only depends on the clips and the skeleton, so all motion matching components with the same setup share one,
+/// see ezMotionMatchingComponentManager::GetOrCreateDatabase().
+class EZ_GAMEENGINE_DLL ezMotionMatchingDatabase : public ezRefCounted
+{
+public:
+  struct Keyframe
+  {
+    EZ_DECLARE_POD_TYPE();
+
+    ezUInt16 m_uiAnimClip;
+    ezUInt16 m_uiKeyframe;
+  };
+
+  struct Query
+  {
+    Keyframe m_Current;
+    ezVec3 m_vLeftFootPosition;
+    ezVec3 m_vRightFootPosition;
+    ezVec3 m_vTargetVelocity;
+  };
+
+  /// \brief Clears the database and looks up the joints whose positions are matched.
+  void Initialize(const ezSkeleton& skeleton, const ezTempHashedString& sLeftFootJoint, const ezTempHashedString& sRightFootJoint);
+
+  /// \brief Adds all keyframes of a clip. Clips are identified by the order in which they were added.
+  void AddAnimationClip(const ezSkeleton& skeleton, const ezAnimationClipResourceDescriptor& animClip);
+
+  ezUInt32 GetNumKeyframes() const { return m_Keyframes.GetCount(); }
+  const Keyframe& GetKeyframe(ezUInt32 uiIndex) const { return m_Keyframes[uiIndex]; }
+
+  /// \brief Returns the index of the clip joint for every skeleton joint, or ezInvalidJointIndex if the clip doesn't animate that joint.
+  ezArrayPtr<const ezUInt16> GetJointMapping(ezUInt32 uiAnimClip) const;
+
+  ezUInt16 GetLeftFootJoint() const { return m_uiLeftFootJoint; }
+  ezUInt16 GetRightFootJoint() const { return m_uiRightFootJoint; }
+
+  /// \brief Returns the index of the keyframe that fits the query best, or ezInvalidIndex if the database is empty.
+  ///
+  /// Keyframes of the current clip are preferred, and jumping back a few keyframes within the current clip is not allowed.
+  ezUInt32 FindBestKeyframe(const Query& query) const;
+
+private:
+  struct FeatureBlock
+  {
+    ezSimdVec4f m_LeftFoot[3];
+    ezSimdVec4f m_RightFoot[3];
+    ezSimdVec4f m_RootVelocity[3];
+    ezSimdVec4i m_AnimClip;
+    ezSimdVec4i m_Keyframe;
+  };
+
+  struct Features
+  {
+    ezVec3 m_vLeftFootPosition;
+    ezVec3 m_vRightFootPosition;
+    ezVec3 m_vRootVelocity;
+  };
+
+  void UpdateFeatureBlocks();
+
+  ezUInt16 m_uiLeftFootJoint = ezInvalidJointIndex;
+  ezUInt16 m_uiRightFootJoint = ezInvalidJointIndex;
+  ezUInt16 m_uiNumSkeletonJoints = 0;
+
+  ezDynamicArray<Keyframe> m_Keyframes;
+  ezDynamicArray<Features> m_Features;
+  ezDynamicArray<FeatureBlock, ezAlignedAllocatorWrapper> m_FeatureBlocks;
+
+  // skeleton joint count entries per clip
+  ezDynamicArray<ezUInt16> m_JointMappings;
+};
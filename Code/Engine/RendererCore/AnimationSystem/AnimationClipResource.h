@@ -2,11 +2,22 @@
 
 #include <Core/ResourceManager/Resource.h>
 #include <Foundation/Containers/ArrayMap.h>
+#include <Foundation/Math/Angle.h>
 #include <Foundation/Strings/HashedString.h>
 #include <RendererCore/RendererCoreDLL.h>
 
 class ezAnimationPose;
+class ezJointMapping;
 class ezSkeleton;
+class ezSimdTransform;
+
+/// \brief The maximum errors that ezAnimationClipResourceDescriptor::Compress() may introduce when it removes keyframes.
+struct ezAnimationClipCompressionSettings
+{
+  float m_fPositionTolerance = 0.0005f;
+  ezAngle m_RotationTolerance = ezAngle::Degree(0.1f);
+  float m_fScaleTolerance = 0.0005f;
+};
 
 struct EZ_RENDERERCORE_DLL ezAnimationClipResourceDescriptor
 {
@@ -25,9 +36,29 @@ public:
   /// \brief returns ezInvalidJointIndex if no joint with the given name is known
   ezUInt16 FindJointIndexByName(const ezTempHashedString& sJointName) const;
 
+  /// \brief Gives access to the uncompressed keyframes of a joint.
+  ///
+  /// These are only available until the clip is compressed, i.e. while an asset is being processed.
+  /// Use GetJointTransform() to read keyframes of a loaded clip.
   ezArrayPtr<const ezTransform> GetJointKeyframes(ezUInt16 uiJoint) const;
   ezArrayPtr<ezTransform> GetJointKeyframes(ezUInt16 uiJoint);
 
+  /// \brief Returns the transform of a joint at the given keyframe, for compressed and uncompressed clips.
+  ezTransform GetJointTransform(ezUInt16 uiJoint, ezUInt16 uiKeyframe) const;
+
+  /// \brief Replaces the keyframes by a compressed representation and frees the uncompressed data.
+  ///
+  /// Per joint, the position, rotation and scale tracks are compressed separately. A track that doesn't change is stored
+  /// as a single value. Of an animated track only those keyframes are kept that are needed to reconstruct all others
+  /// by linear interpolation within the tolerances given in \a settings.
+  /// Rotations are quantized to 48 bit (smallest three), positions and scales to 16 bit per component within the range of their track.
+  /// Tracks for which the quantization error alone would exceed the tolerance, e.g. positions that cover a large distance, are stored unquantized.
+  ///
+  /// Save() always writes the compressed format, so clips that are loaded from disk are always compressed.
+  void Compress(const ezAnimationClipCompressionSettings& settings = ezAnimationClipCompressionSettings());
+
+  bool IsCompressed() const { return m_bCompressed; }
+
   void Save(ezStreamWriter& stream) const;
   void Load(ezStreamReader& stream);
 
@@ -42,7 +73,32 @@ public:
   void SetPoseToKeyframe(ezAnimationPose& pose, const ezSkeleton& skeleton, ezUInt16 uiKeyframe) const;
   void SetPoseToBlendedKeyframe(ezAnimationPose& pose, const ezSkeleton& skeleton, ezUInt16 uiKeyframe0, float fBlendToKeyframe1) const;
 
+  /// \brief Same as above, but uses a joint mapping that was created for this clip, instead of looking up every joint by name.
+  ///
+  /// Prefer this for anything that updates every frame.
+  void SetPoseToBlendedKeyframe(ezAnimationPose& pose, const ezJointMapping& mapping, ezUInt16 uiKeyframe0, float fBlendToKeyframe1) const;
+
 private:
+  struct CompressedTrack
+  {
+    ezUInt32 m_uiFirstKey = 0;   ///< Index into m_KeyframeIndices.
+    ezUInt32 m_uiNumKeys = 0;    ///< A single key means the track is constant.
+    ezUInt32 m_uiFirstValue = 0; ///< Index into m_QuantizedValues (three values per key) or m_UnquantizedValues (one value per key).
+    bool m_bQuantized = true;    ///< False if the quantization error alone would exceed the tolerance of the track.
+    ezVec3 m_vRangeMin = ezVec3::ZeroVector();    ///< Positions and scales are quantized to [min; min + extent]
+    ezVec3 m_vRangeExtent = ezVec3::ZeroVector(); ///< Not used for rotations
+  };
+
+  struct CompressedJoint
+  {
+    CompressedTrack m_Position;
+    CompressedTrack m_Rotation;
+    CompressedTrack m_Scale;
+  };
+
+  ezSimdTransform SampleCompressedJoint(ezUInt32 uiJoint, float fFrame) const;
+  ezMat4 SampleJoint(ezUInt32 uiJoint, ezUInt16 uiKeyframe0, float fBlendToKeyframe1) const;
+
   ezUInt16 m_uiNumJoints = 0;
   ezUInt16 m_uiNumFrames = 0;
   ezUInt8 m_uiFramesPerSecond = 0;
@@ -51,6 +107,12 @@ private:
 
   ezDynamicArray<ezTransform> m_JointTransforms;
   ezArrayMap<ezHashedString, ezUInt16> m_JointNameToIndex;
+
+  bool m_bCompressed = false;
+  ezDynamicArray<CompressedJoint> m_CompressedJoints;
+  ezDynamicArray<ezUInt16> m_KeyframeIndices;
+  ezDynamicArray<ezUInt16> m_QuantizedValues;
+  ezDynamicArray<ezVec4> m_UnquantizedValues;
 };
 
 typedef ezTypedResourceHandle<class ezAnimationClipResource> ezAnimationClipResourceHandle;
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <RendererCore/AnimationSystem/AnimationGraph/AnimationGraphNode.h>
+#include <RendererCore/AnimationSystem/JointMapping.h>
 
 struct ezAnimationClipResourceDescriptor;
 class ezStreamWriter;
@@ -54,5 +55,11 @@ private:
   ezTime m_ClipDuration;
   float m_fPlaybackSpeed = 1.0f;
   bool m_bLoop = false;
+
+  // looking up the joints by name is expensive, so the mapping is only recomputed when the clip or the skeleton changes
+  ezJointMapping m_JointMapping;
+  ezUInt32 m_uiMappedSkeletonID = 0;
+  ezUInt32 m_uiMappedClipChangeCounter = 0;
+  ezUInt32 m_uiMappedClipIDHash = 0;
 };
 
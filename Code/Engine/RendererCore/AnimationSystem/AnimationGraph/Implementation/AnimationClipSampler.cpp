@@ -58,7 +58,17 @@ bool ezAnimationClipSampler::Execute(const ezSkeleton& skeleton, ezAnimationPose
     }
   }
 
-  animDesc.SetPoseToBlendedKeyframe(currentPose, skeleton, uiFirstFrame, (float)fAnimLerp);
+  if (m_uiMappedSkeletonID != skeleton.GetJointSetupID() || m_uiMappedClipIDHash != pAnimClip->GetResourceIDHash() ||
+      m_uiMappedClipChangeCounter != pAnimClip->GetCurrentResourceChangeCounter())
+  {
+    m_JointMapping.CreateMapping(skeleton, animDesc);
+
+    m_uiMappedSkeletonID = skeleton.GetJointSetupID();
+    m_uiMappedClipIDHash = pAnimClip->GetResourceIDHash();
+    m_uiMappedClipChangeCounter = pAnimClip->GetCurrentResourceChangeCounter();
+  }
+
+  animDesc.SetPoseToBlendedKeyframe(currentPose, m_JointMapping, uiFirstFrame, (float)fAnimLerp);
 
   return true;
 }
@@ -174,14 +184,12 @@ ezTransform ezAnimationClipSampler::ComputeRootMotion(const ezAnimationClipResou
   double fAnimLerpLast = 0;
   const ezUInt32 uiLastFrame = animDesc.GetFrameAt(tNow, fAnimLerpLast);
 
-  ezArrayPtr<const ezTransform> pKeyframes = animDesc.GetJointKeyframes(uiRootMotionJoint);
-
   ezTransform res;
   res.SetIdentity();
 
   if (uiFirstFrame == uiLastFrame)
   {
-    const ezTransform rm = pKeyframes[uiFirstFrame];
+    const ezTransform rm = animDesc.GetJointTransform(uiRootMotionJoint, uiFirstFrame);
 
     const float fFraction = (float)(fAnimLerpLast - fAnimLerpFirst);
 
@@ -191,7 +199,7 @@ ezTransform ezAnimationClipSampler::ComputeRootMotion(const ezAnimationClipResou
   else
   {
     {
-      const ezTransform rm = pKeyframes[uiFirstFrame];
+      const ezTransform rm = animDesc.GetJointTransform(uiRootMotionJoint, uiFirstFrame);
 
       const float fFraction = (float)(1.0 - fAnimLerpFirst);
 
@@ -201,7 +209,7 @@ ezTransform ezAnimationClipSampler::ComputeRootMotion(const ezAnimationClipResou
 
     for (ezUInt32 i = uiFirstFrame + 1; i < uiLastFrame; ++i)
     {
-      const ezTransform rm = pKeyframes[i];
+      const ezTransform rm = animDesc.GetJointTransform(uiRootMotionJoint, i);
 
       res.m_vPosition += rm.m_vPosition;
       // rotation
@@ -209,7 +217,7 @@ ezTransform ezAnimationClipSampler::ComputeRootMotion(const ezAnimationClipResou
 
 
     {
-      const ezTransform rm = pKeyframes[uiLastFrame];
+      const ezTransform rm = animDesc.GetJointTransform(uiRootMotionJoint, uiLastFrame);
 
       const float fFraction = (float)fAnimLerpLast;
 
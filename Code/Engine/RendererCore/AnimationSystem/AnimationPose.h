@@ -36,6 +36,12 @@ public:
   /// This is typically the very last operation done on a pose before it is sent to the GPU for skinning.
   void ConvertFromObjectSpaceToSkinningSpace(const ezSkeleton& skeleton);
 
+  /// \brief Computes the skinning space transforms of this object space pose into \a out_Transforms, which must have one entry per joint.
+  ///
+  /// Same as ConvertFromObjectSpaceToSkinningSpace(), but leaves this pose in object space. That way the result can be written directly
+  /// into the buffer that is used for rendering, while the object space pose stays available, e.g. for ezMsgAnimationPoseUpdated.
+  void ComputeSkinningTransforms(const ezSkeleton& skeleton, ezArrayPtr<ezMat4> out_Transforms) const;
+
   const ezMat4& GetTransform(ezUInt16 uiJointIndex) const { return m_Transforms[uiJointIndex]; }
 
   ezArrayPtr<const ezMat4> GetAllTransforms() const { return m_Transforms.GetArrayPtr(); }
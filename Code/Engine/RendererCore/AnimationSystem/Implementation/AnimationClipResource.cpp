@@ -1,9 +1,13 @@
 #include <RendererCorePCH.h>
 
 #include <Core/Assets/AssetFileHeader.h>
+#include <Foundation/SimdMath/SimdConversion.h>
+#include <Foundation/SimdMath/SimdTransform.h>
+#include <Foundation/SimdMath/SimdVec4i.h>
 #include <RendererCore/AnimationSystem/AnimationClipResource.h>
 #include <RendererCore/AnimationSystem/Skeleton.h>
 #include <RendererCore/AnimationSystem/AnimationPose.h>
+#include <RendererCore/AnimationSystem/JointMapping.h>
 
 // clang-format off
 EZ_BEGIN_DYNAMIC_REFLECTED_TYPE(ezAnimationClipResource, 1, ezRTTIDefaultAllocator<ezAnimationClipResource>)
@@ -21,6 +25,11 @@ EZ_RESOURCE_IMPLEMENT_CREATEABLE(ezAnimationClipResource, ezAnimationClipResourc
 {
   m_Descriptor = descriptor;
 
+  if (!m_Descriptor.IsCompressed() && m_Descriptor.GetNumFrames() >= 2)
+  {
+    m_Descriptor.Compress();
+  }
+
   ezResourceLoadDesc res;
   res.m_uiQualityLevelsDiscardable = 0;
   res.m_uiQualityLevelsLoadable = 0;
@@ -137,24 +146,57 @@ ezUInt16 ezAnimationClipResourceDescriptor::FindJointIndexByName(const ezTempHas
 
 ezArrayPtr<const ezTransform> ezAnimationClipResourceDescriptor::GetJointKeyframes(ezUInt16 uiJoint) const
 {
+  EZ_ASSERT_DEV(!m_bCompressed, "The keyframes of a compressed animation clip can't be accessed directly, use GetJointTransform() instead");
+
   return ezArrayPtr<const ezTransform>(&m_JointTransforms[uiJoint * m_uiNumFrames], m_uiNumFrames);
 }
 
 ezArrayPtr<ezTransform> ezAnimationClipResourceDescriptor::GetJointKeyframes(ezUInt16 uiJoint)
 {
+  EZ_ASSERT_DEV(!m_bCompressed, "The keyframes of a compressed animation clip can't be modified");
+
   return ezArrayPtr<ezTransform>(&m_JointTransforms[uiJoint * m_uiNumFrames], m_uiNumFrames);
 }
 
 void ezAnimationClipResourceDescriptor::Save(ezStreamWriter& stream) const
 {
-  const ezUInt8 uiVersion = 2;
+  if (!m_bCompressed)
+  {
+    ezAnimationClipResourceDescriptor compressed = *this;
+    compressed.Compress();
+    compressed.Save(stream);
+    return;
+  }
+
+  const ezUInt8 uiVersion = 3;
   stream << uiVersion;
 
   stream << m_uiNumJoints;
   stream << m_uiNumFrames;
   stream << m_uiFramesPerSecond;
 
-  stream.WriteArray(m_JointTransforms);
+  // version 3: compressed tracks instead of all transforms
+  {
+    const ezUInt32 uiNumCompressedJoints = m_CompressedJoints.GetCount();
+    stream << uiNumCompressedJoints;
+
+    for (const CompressedJoint& joint : m_CompressedJoints)
+    {
+      for (const CompressedTrack* pTrack : {&joint.m_Position, &joint.m_Rotation, &joint.m_Scale})
+      {
+        stream << pTrack->m_uiFirstKey;
+        stream << pTrack->m_uiNumKeys;
+        stream << pTrack->m_uiFirstValue;
+        stream << pTrack->m_bQuantized;
+        stream << pTrack->m_vRangeMin;
+        stream << pTrack->m_vRangeExtent;
+      }
+    }
+
+    stream.WriteArray(m_KeyframeIndices);
+    stream.WriteArray(m_QuantizedValues);
+    stream.WriteArray(m_UnquantizedValues);
+  }
 
   // version 2
   {
@@ -178,7 +220,42 @@ void ezAnimationClipResourceDescriptor::Load(ezStreamReader& stream)
   stream >> m_uiNumFrames;
   stream >> m_uiFramesPerSecond;
 
-  stream.ReadArray(m_JointTransforms);
+  m_bCompressed = false;
+  m_JointTransforms.Clear();
+  m_CompressedJoints.Clear();
+  m_KeyframeIndices.Clear();
+  m_QuantizedValues.Clear();
+  m_UnquantizedValues.Clear();
+
+  if (uiVersion >= 3)
+  {
+    ezUInt32 uiNumCompressedJoints = 0;
+    stream >> uiNumCompressedJoints;
+
+    m_CompressedJoints.SetCount(uiNumCompressedJoints);
+    for (CompressedJoint& joint : m_CompressedJoints)
+    {
+      for (CompressedTrack* pTrack : {&joint.m_Position, &joint.m_Rotation, &joint.m_Scale})
+      {
+        stream >> pTrack->m_uiFirstKey;
+        stream >> pTrack->m_uiNumKeys;
+        stream >> pTrack->m_uiFirstValue;
+        stream >> pTrack->m_bQuantized;
+        stream >> pTrack->m_vRangeMin;
+        stream >> pTrack->m_vRangeExtent;
+      }
+    }
+
+    stream.ReadArray(m_KeyframeIndices);
+    stream.ReadArray(m_QuantizedValues);
+    stream.ReadArray(m_UnquantizedValues);
+
+    m_bCompressed = true;
+  }
+  else
+  {
+    stream.ReadArray(m_JointTransforms);
+  }
 
   m_Duration = ezTime::Seconds((double)(m_uiNumFrames-1) / (double)m_uiFramesPerSecond);
 
@@ -203,12 +280,19 @@ void ezAnimationClipResourceDescriptor::Load(ezStreamReader& stream)
     // should do nothing
     m_JointNameToIndex.Sort();
   }
+
+  // old files only store the raw transforms, compress them right away to have the same memory footprint
+  if (!m_bCompressed && m_uiNumFrames >= 2)
+  {
+    Compress();
+  }
 }
 
 
 ezUInt64 ezAnimationClipResourceDescriptor::GetHeapMemoryUsage() const
 {
-  return m_JointTransforms.GetHeapMemoryUsage();
+  return m_JointTransforms.GetHeapMemoryUsage() + m_JointNameToIndex.GetHeapMemoryUsage() + m_CompressedJoints.GetHeapMemoryUsage() +
+         m_KeyframeIndices.GetHeapMemoryUsage() + m_QuantizedValues.GetHeapMemoryUsage() + m_UnquantizedValues.GetHeapMemoryUsage();
 }
 
 bool ezAnimationClipResourceDescriptor::HasRootMotion() const
@@ -242,9 +326,16 @@ void ezAnimationClipResourceDescriptor::SetPoseToKeyframe(ezAnimationPose& pose,
     const ezUInt16 uiSkeletonJointIdx = skeleton.FindJointByName(sJointName);
     if (uiSkeletonJointIdx != ezInvalidJointIndex)
     {
-      ezArrayPtr<const ezTransform> pTransforms = GetJointKeyframes(uiAnimJointIdx);
-
-      pose.SetTransform(uiSkeletonJointIdx, pTransforms[uiKeyframe].GetAsMat4());
+      if (m_bCompressed)
+      {
+        pose.SetTransform(uiSkeletonJointIdx, ezSimdConversion::ToMat4(SampleCompressedJoint(uiAnimJointIdx, uiKeyframe).GetAsMat4()));
+      }
+      else
+      {
+        ezArrayPtr<const ezTransform> pTransforms = GetJointKeyframes(uiAnimJointIdx);
+
+        pose.SetTransform(uiSkeletonJointIdx, pTransforms[uiKeyframe].GetAsMat4());
+      }
     }
   }
 }
@@ -261,18 +352,518 @@ void ezAnimationClipResourceDescriptor::SetPoseToBlendedKeyframe(ezAnimationPose
     const ezUInt16 uiSkeletonJointIdx = skeleton.FindJointByName(sJointName);
     if (uiSkeletonJointIdx != ezInvalidJointIndex)
     {
-      ezArrayPtr<const ezTransform> pTransforms = GetJointKeyframes(uiAnimJointIdx);
-      const ezTransform jointTransform1 = pTransforms[uiKeyframe0];
-      const ezTransform jointTransform2 = pTransforms[uiKeyframe0 + 1];
+      pose.SetTransform(uiSkeletonJointIdx, SampleJoint(uiAnimJointIdx, uiKeyframe0, fBlendToKeyframe1));
+    }
+  }
+}
+
+void ezAnimationClipResourceDescriptor::SetPoseToBlendedKeyframe(ezAnimationPose& pose, const ezJointMapping& mapping, ezUInt16 uiKeyframe0,
+                                                                 float fBlendToKeyframe1) const
+{
+  for (const ezJointMapping::Mapping& m : mapping.GetAllMappings())
+  {
+    pose.SetTransform(m.m_uiJointInSkeleton, SampleJoint(m.m_uiJointInAnimation, uiKeyframe0, fBlendToKeyframe1));
+  }
+}
+
+ezMat4 ezAnimationClipResourceDescriptor::SampleJoint(ezUInt32 uiJoint, ezUInt16 uiKeyframe0, float fBlendToKeyframe1) const
+{
+  if (m_bCompressed)
+  {
+    // decompress and interpolate in one go
+    return ezSimdConversion::ToMat4(SampleCompressedJoint(uiJoint, uiKeyframe0 + fBlendToKeyframe1).GetAsMat4());
+  }
+
+  ezArrayPtr<const ezTransform> pTransforms = GetJointKeyframes(uiJoint);
+  const ezTransform jointTransform1 = pTransforms[uiKeyframe0];
+  const ezTransform jointTransform2 = pTransforms[uiKeyframe0 + 1];
+
+  ezTransform res;
+  res.m_vPosition = ezMath::Lerp(jointTransform1.m_vPosition, jointTransform2.m_vPosition, fBlendToKeyframe1);
+  res.m_qRotation.SetSlerp(jointTransform1.m_qRotation, jointTransform2.m_qRotation, fBlendToKeyframe1);
+  res.m_vScale = ezMath::Lerp(jointTransform1.m_vScale, jointTransform2.m_vScale, fBlendToKeyframe1);
+
+  return res.GetAsMat4();
+}
+
+ezTransform ezAnimationClipResourceDescriptor::GetJointTransform(ezUInt16 uiJoint, ezUInt16 uiKeyframe) const
+{
+  if (m_bCompressed)
+  {
+    return ezSimdConversion::ToTransform(SampleCompressedJoint(uiJoint, uiKeyframe));
+  }
+
+  return m_JointTransforms[uiJoint * m_uiNumFrames + uiKeyframe];
+}
+
+namespace
+{
+  // keyframes are never further apart than this, which bounds the cost of the key reduction for long clips
+  constexpr ezUInt32 s_uiMaxKeyframeDistance = 256;
+
+  // the three smallest components of a unit quaternion are always within [-1/sqrt(2); 1/sqrt(2)]
+  constexpr float s_fSmallestThreeRange = 0.70710678f;
+
+  ezUInt16 QuantizeUnorm(float f, ezUInt32 uiMaxValue)
+  {
+    return static_cast<ezUInt16>(ezMath::Clamp(f, 0.0f, 1.0f) * uiMaxValue + 0.5f);
+  }
+
+  void QuantizeVec3(const ezVec3& v, const ezVec3& vRangeMin, const ezVec3& vRangeExtent, ezUInt16* pOut)
+  {
+    for (ezUInt32 c = 0; c < 3; ++c)
+    {
+      const float fExtent = vRangeExtent.GetData()[c];
+      pOut[c] = fExtent > 0.0f ? QuantizeUnorm((v.GetData()[c] - vRangeMin.GetData()[c]) / fExtent, 0xFFFF) : 0;
+    }
+  }
 
-      ezTransform res;
-      res.m_vPosition = ezMath::Lerp(jointTransform1.m_vPosition, jointTransform2.m_vPosition, fBlendToKeyframe1);
-      res.m_qRotation.SetSlerp(jointTransform1.m_qRotation, jointTransform2.m_qRotation, fBlendToKeyframe1);
-      res.m_vScale = ezMath::Lerp(jointTransform1.m_vScale, jointTransform2.m_vScale, fBlendToKeyframe1);
+  ezSimdVec4f DequantizeVec3(const ezUInt16* pIn, const ezSimdVec4f& vRangeMin, const ezSimdVec4f& vScale)
+  {
+    return ezSimdVec4f::MulAdd(ezSimdVec4i(pIn[0], pIn[1], pIn[2], 0).ToFloat(), vScale, vRangeMin);
+  }
+
+  /// The largest component is dropped, its index is stored in the top bits of the first two values.
+  void QuantizeQuat(const ezQuat& q, ezUInt16* pOut)
+  {
+    const float c[4] = {q.v.x, q.v.y, q.v.z, q.w};
+
+    ezUInt32 uiLargest = 0;
+    for (ezUInt32 i = 1; i < 4; ++i)
+    {
+      if (ezMath::Abs(c[i]) > ezMath::Abs(c[uiLargest]))
+        uiLargest = i;
+    }
+
+    // q and -q are the same rotation, so the dropped component can always be made positive
+    const float fSign = c[uiLargest] < 0.0f ? -1.0f : 1.0f;
 
-      pose.SetTransform(uiSkeletonJointIdx, res.GetAsMat4());
+    ezUInt16 values[3];
+    for (ezUInt32 i = 0, o = 0; i < 4; ++i)
+    {
+      if (i != uiLargest)
+      {
+        values[o++] = QuantizeUnorm(c[i] * fSign * (0.5f / s_fSmallestThreeRange) + 0.5f, 0x7FFF);
+      }
     }
+
+    pOut[0] = values[0] | static_cast<ezUInt16>((uiLargest & 1) << 15);
+    pOut[1] = values[1] | static_cast<ezUInt16>((uiLargest >> 1) << 15);
+    pOut[2] = values[2];
   }
+
+  float QuatDot(const ezQuat& q0, const ezQuat& q1)
+  {
+    return q0.v.Dot(q1.v) + q0.w * q1.w;
+  }
+
+  ezSimdQuat DequantizeQuat(const ezUInt16* pIn)
+  {
+    const ezUInt32 uiLargest = (pIn[0] >> 15) | ((pIn[1] >> 15) << 1);
+
+    const ezSimdVec4f vScale(2.0f * s_fSmallestThreeRange / 0x7FFF);
+    const ezSimdVec4f vOffset(-s_fSmallestThreeRange, -s_fSmallestThreeRange, -s_fSmallestThreeRange, 0.0f);
+    const ezSimdVec4f vSmallest = ezSimdVec4f::MulAdd(ezSimdVec4i(pIn[0] & 0x7FFF, pIn[1] & 0x7FFF, pIn[2], 0).ToFloat(), vScale, vOffset);
+    const float fLargest = ezMath::Sqrt(ezMath::Max(0.0f, 1.0f - (float)vSmallest.Dot<3>(vSmallest)));
+
+    float smallest[4];
+    vSmallest.Store<4>(smallest);
+
+    float c[4];
+    for (ezUInt32 i = 0, o = 0; i < 4; ++i)
+    {
+      c[i] = (i == uiLargest) ? fLargest : smallest[o++];
+    }
+
+    ezSimdQuat res(ezSimdVec4f(c[0], c[1], c[2], c[3]));
+    res.Normalize();
+    return res;
+  }
+
+  /// Normalized lerp, which is accurate enough for the small angles between neighboring keyframes.
+  ezSimdQuat InterpolateQuat(const ezSimdQuat& q0, const ezSimdQuat& q1, float fLerp)
+  {
+    ezSimdVec4f v1 = q1.m_v;
+    if (q0.m_v.Dot<4>(v1) < 0.0f)
+    {
+      v1 = -v1;
+    }
+
+    ezSimdQuat res(ezSimdVec4f::Lerp(q0.m_v, v1, ezSimdVec4f(fLerp)));
+    res.Normalize();
+    return res;
+  }
+
+  /// Returns the index of the key before fFrame, relative to the track, and the interpolation factor to the next key.
+  ezUInt32 FindKey(ezArrayPtr<const ezUInt16> keys, float fFrame, float& out_fLerp)
+  {
+    out_fLerp = 0.0f;
+
+    if (keys.GetCount() == 1)
+      return 0;
+
+    ezUInt32 uiLow = 0;
+    ezUInt32 uiHigh = keys.GetCount() - 1;
+
+    // find the last key that is not after fFrame, but never return the last key, to always have a successor
+    while (uiHigh - uiLow > 1)
+    {
+      const ezUInt32 uiMid = (uiLow + uiHigh) / 2;
+
+      if (keys[uiMid] <= fFrame)
+        uiLow = uiMid;
+      else
+        uiHigh = uiMid;
+    }
+
+    const float fFrame0 = keys[uiLow];
+    const float fFrame1 = keys[uiLow + 1];
+    out_fLerp = ezMath::Clamp((fFrame - fFrame0) / (fFrame1 - fFrame0), 0.0f, 1.0f);
+
+    return uiLow;
+  }
+
+  /// Greedily extends every segment as long as all frames within it can be reconstructed by interpolating its end points.
+  /// IsWithinTolerance(uiFirst, uiLast) has to check all frames in between.
+  template <typename FUNC>
+  void ReduceKeys(ezUInt32 uiNumFrames, ezDynamicArray<ezUInt16>& out_Keys, FUNC IsWithinTolerance)
+  {
+    ezUInt32 uiStart = 0;
+    out_Keys.PushBack(0);
+
+    while (uiStart + 1 < uiNumFrames)
+    {
+      ezUInt32 uiEnd = uiStart + 1;
+
+      while (uiEnd + 1 < uiNumFrames && uiEnd + 1 - uiStart <= s_uiMaxKeyframeDistance && IsWithinTolerance(uiStart, uiEnd + 1))
+      {
+        ++uiEnd;
+      }
+
+      out_Keys.PushBack(static_cast<ezUInt16>(uiEnd));
+      uiStart = uiEnd;
+    }
+  }
+} // namespace
+
+void ezAnimationClipResourceDescriptor::Compress(const ezAnimationClipCompressionSettings& settings)
+{
+  if (m_bCompressed)
+    return;
+
+  m_CompressedJoints.Clear();
+  m_KeyframeIndices.Clear();
+  m_QuantizedValues.Clear();
+  m_UnquantizedValues.Clear();
+
+  // includes the root motion track
+  const ezUInt32 uiNumFrames = m_uiNumFrames;
+  const ezUInt32 uiNumTracks = uiNumFrames > 0 ? m_JointTransforms.GetCount() / uiNumFrames : 0;
+
+  m_CompressedJoints.SetCount(uiNumTracks);
+
+  ezDynamicArray<ezVec3> values;
+  ezDynamicArray<ezSimdVec4f, ezAlignedAllocatorWrapper> dequantized;
+  ezDynamicArray<ezQuat> rotations;
+  ezDynamicArray<ezSimdQuat, ezAlignedAllocatorWrapper> dequantizedRotations;
+  ezDynamicArray<ezUInt16> quantized;
+  ezDynamicArray<ezVec4> unquantized;
+  ezDynamicArray<ezUInt16> keys;
+
+  auto StoreKeys = [&](CompressedTrack& track) {
+    track.m_uiFirstKey = m_KeyframeIndices.GetCount();
+    track.m_uiNumKeys = keys.GetCount();
+    track.m_uiFirstValue = track.m_bQuantized ? m_QuantizedValues.GetCount() : m_UnquantizedValues.GetCount();
+
+    for (ezUInt16 uiKey : keys)
+    {
+      m_KeyframeIndices.PushBack(uiKey);
+
+      if (track.m_bQuantized)
+      {
+        m_QuantizedValues.PushBack(quantized[uiKey * 3 + 0]);
+        m_QuantizedValues.PushBack(quantized[uiKey * 3 + 1]);
+        m_QuantizedValues.PushBack(quantized[uiKey * 3 + 2]);
+      }
+      else
+      {
+        m_UnquantizedValues.PushBack(unquantized[uiKey]);
+      }
+    }
+  };
+
+  auto CompressVec3Track = [&](CompressedTrack& track, float fTolerance) {
+    ezBoundingBox range;
+    range.SetFromPoints(values.GetData(), values.GetCount());
+
+    keys.Clear();
+
+    // the center of the range is never further away from any value than half the diagonal
+    if ((range.m_vMax - range.m_vMin).GetLength() * 0.5f <= fTolerance)
+    {
+      // constant track, the only value is stored in the range
+      track.m_bQuantized = true;
+      track.m_vRangeMin = range.GetCenter();
+      track.m_vRangeExtent.SetZero();
+
+      quantized.SetCount(3);
+      quantized[0] = quantized[1] = quantized[2] = 0;
+      keys.PushBack(0);
+      StoreKeys(track);
+      return;
+    }
+
+    track.m_vRangeMin = range.m_vMin;
+    track.m_vRangeExtent = range.m_vMax - range.m_vMin;
+
+    const ezSimdVec4f vRangeMin = ezSimdConversion::ToVec3(track.m_vRangeMin);
+    const ezSimdVec4f vScale = ezSimdConversion::ToVec3(track.m_vRangeExtent / 65535.0f);
+    const ezSimdFloat fToleranceSqr = fTolerance * fTolerance;
+
+    quantized.SetCount(uiNumFrames * 3);
+    dequantized.SetCount(uiNumFrames);
+    track.m_bQuantized = true;
+    for (ezUInt32 f = 0; f < uiNumFrames; ++f)
+    {
+      QuantizeVec3(values[f], track.m_vRangeMin, track.m_vRangeExtent, &quantized[f * 3]);
+      dequantized[f] = DequantizeVec3(&quantized[f * 3], vRangeMin, vScale);
+
+      track.m_bQuantized = track.m_bQuantized && (dequantized[f] - ezSimdConversion::ToVec3(values[f])).GetLengthSquared<3>() <= fToleranceSqr;
+    }
+
+    // for tracks with a large range the quantization steps alone can be larger than the tolerance
+    if (!track.m_bQuantized)
+    {
+      unquantized.SetCountUninitialized(uiNumFrames);
+      for (ezUInt32 f = 0; f < uiNumFrames; ++f)
+      {
+        unquantized[f] = values[f].GetAsVec4(0.0f);
+        dequantized[f] = ezSimdConversion::ToVec3(values[f]);
+      }
+    }
+
+    // the error is measured against the values that are actually reconstructed, so it includes the quantization error
+    ReduceKeys(uiNumFrames, keys, [&](ezUInt32 uiFirst, ezUInt32 uiLast) {
+      const ezSimdVec4f v0 = dequantized[uiFirst];
+      const ezSimdVec4f v1 = dequantized[uiLast];
+      const float fInvLength = 1.0f / (uiLast - uiFirst);
+
+      for (ezUInt32 f = uiFirst + 1; f < uiLast; ++f)
+      {
+        const ezSimdVec4f vInterpolated = ezSimdVec4f::Lerp(v0, v1, ezSimdVec4f((f - uiFirst) * fInvLength));
+        const ezSimdVec4f vDiff = vInterpolated - ezSimdConversion::ToVec3(values[f]);
+
+        if (vDiff.GetLengthSquared<3>() > fToleranceSqr)
+          return false;
+      }
+
+      return true;
+    });
+
+    StoreKeys(track);
+  };
+
+  auto CompressRotationTrack = [&](CompressedTrack& track, ezAngle tolerance) {
+    // make the track continuous, such that interpolating between neighboring keys always takes the short way
+    for (ezUInt32 f = 1; f < uiNumFrames; ++f)
+    {
+      if (QuatDot(rotations[f], rotations[f - 1]) < 0.0f)
+      {
+        rotations[f].v = -rotations[f].v;
+        rotations[f].w = -rotations[f].w;
+      }
+    }
+
+    // two rotations differ by less than the tolerance angle, if the absolute dot product is above the cosine of half the angle
+    const float fMinDot = ezMath::Cos(tolerance * 0.5f);
+
+    auto IsWithinTolerance = [&](const ezSimdQuat& q, ezUInt32 f) -> bool {
+      return ezMath::Abs((float)q.m_v.Dot<4>(ezSimdConversion::ToQuat(rotations[f]).m_v)) >= fMinDot;
+    };
+
+    quantized.SetCount(uiNumFrames * 3);
+    dequantizedRotations.SetCount(uiNumFrames);
+    track.m_bQuantized = true;
+    for (ezUInt32 f = 0; f < uiNumFrames; ++f)
+    {
+      QuantizeQuat(rotations[f], &quantized[f * 3]);
+      dequantizedRotations[f] = DequantizeQuat(&quantized[f * 3]);
+
+      track.m_bQuantized = track.m_bQuantized && IsWithinTolerance(dequantizedRotations[f], f);
+    }
+
+    // only happens with a tolerance that is smaller than the precision of the smallest three encoding
+    if (!track.m_bQuantized)
+    {
+      unquantized.SetCountUninitialized(uiNumFrames);
+      for (ezUInt32 f = 0; f < uiNumFrames; ++f)
+      {
+        unquantized[f].Set(rotations[f].v.x, rotations[f].v.y, rotations[f].v.z, rotations[f].w);
+        dequantizedRotations[f] = ezSimdConversion::ToQuat(rotations[f]);
+      }
+    }
+
+    keys.Clear();
+
+    // a constant track stores the average rotation, which is closer to all frames than any single one of them
+    {
+      ezQuat qAverage(0, 0, 0, 0);
+      for (ezUInt32 f = 0; f < uiNumFrames; ++f)
+      {
+        qAverage.v += rotations[f].v;
+        qAverage.w += rotations[f].w;
+      }
+
+      // the frames of a constant track are all close to each other, so their sum can't cancel out
+      bool bConstant = QuatDot(qAverage, qAverage) > 0.5f;
+
+      if (bConstant)
+        qAverage.Normalize();
+
+      ezUInt16 quantizedAverage[3];
+      QuantizeQuat(qAverage, quantizedAverage);
+      const ezSimdQuat qStored = track.m_bQuantized ? DequantizeQuat(quantizedAverage) : ezSimdConversion::ToQuat(qAverage);
+
+      for (ezUInt32 f = 0; f < uiNumFrames && bConstant; ++f)
+      {
+        bConstant = IsWithinTolerance(qStored, f);
+      }
+
+      if (bConstant)
+      {
+        quantized[0] = quantizedAverage[0];
+        quantized[1] = quantizedAverage[1];
+        quantized[2] = quantizedAverage[2];
+
+        if (!track.m_bQuantized)
+        {
+          unquantized[0].Set(qAverage.v.x, qAverage.v.y, qAverage.v.z, qAverage.w);
+        }
+
+        keys.PushBack(0);
+        StoreKeys(track);
+        return;
+      }
+    }
+
+    ReduceKeys(uiNumFrames, keys, [&](ezUInt32 uiFirst, ezUInt32 uiLast) {
+      const float fInvLength = 1.0f / (uiLast - uiFirst);
+
+      for (ezUInt32 f = uiFirst + 1; f < uiLast; ++f)
+      {
+        const ezSimdQuat qInterpolated =
+          InterpolateQuat(dequantizedRotations[uiFirst], dequantizedRotations[uiLast], (f - uiFirst) * fInvLength);
+
+        if (!IsWithinTolerance(qInterpolated, f))
+          return false;
+      }
+
+      return true;
+    });
+
+    StoreKeys(track);
+  };
+
+  values.SetCountUninitialized(uiNumFrames);
+  rotations.SetCountUninitialized(uiNumFrames);
+
+  for (ezUInt32 uiTrack = 0; uiTrack < uiNumTracks; ++uiTrack)
+  {
+    const ezTransform* pTransforms = &m_JointTransforms[uiTrack * uiNumFrames];
+    CompressedJoint& joint = m_CompressedJoints[uiTrack];
+
+    for (ezUInt32 f = 0; f < uiNumFrames; ++f)
+      values[f] = pTransforms[f].m_vPosition;
+
+    CompressVec3Track(joint.m_Position, settings.m_fPositionTolerance);
+
+    for (ezUInt32 f = 0; f < uiNumFrames; ++f)
+      rotations[f] = pTransforms[f].m_qRotation;
+
+    CompressRotationTrack(joint.m_Rotation, settings.m_RotationTolerance);
+
+    for (ezUInt32 f = 0; f < uiNumFrames; ++f)
+      values[f] = pTransforms[f].m_vScale;
+
+    CompressVec3Track(joint.m_Scale, settings.m_fScaleTolerance);
+  }
+
+  m_KeyframeIndices.Compact();
+  m_QuantizedValues.Compact();
+  m_UnquantizedValues.Compact();
+
+  m_JointTransforms.Clear();
+  m_JointTransforms.Compact();
+
+  m_bCompressed = true;
+}
+
+ezSimdTransform ezAnimationClipResourceDescriptor::SampleCompressedJoint(ezUInt32 uiJoint, float fFrame) const
+{
+  const CompressedJoint& joint = m_CompressedJoints[uiJoint];
+
+  auto SampleVec3 = [&](const CompressedTrack& track) -> ezSimdVec4f {
+    float fLerp;
+    const ezUInt32 uiKey = FindKey(m_KeyframeIndices.GetArrayPtr().GetSubArray(track.m_uiFirstKey, track.m_uiNumKeys), fFrame, fLerp);
+
+    ezSimdVec4f v0, v1;
+
+    if (track.m_bQuantized)
+    {
+      const ezSimdVec4f vRangeMin = ezSimdConversion::ToVec3(track.m_vRangeMin);
+      const ezSimdVec4f vScale = ezSimdConversion::ToVec3(track.m_vRangeExtent / 65535.0f);
+      const ezUInt16* pValues = &m_QuantizedValues[track.m_uiFirstValue];
+
+      v0 = DequantizeVec3(pValues + uiKey * 3, vRangeMin, vScale);
+      if (track.m_uiNumKeys == 1)
+        return v0;
+
+      v1 = DequantizeVec3(pValues + uiKey * 3 + 3, vRangeMin, vScale);
+    }
+    else
+    {
+      const ezVec4* pValues = &m_UnquantizedValues[track.m_uiFirstValue];
+
+      v0 = ezSimdConversion::ToVec4(pValues[uiKey]);
+      if (track.m_uiNumKeys == 1)
+        return v0;
+
+      v1 = ezSimdConversion::ToVec4(pValues[uiKey + 1]);
+    }
+
+    return ezSimdVec4f::Lerp(v0, v1, ezSimdVec4f(fLerp));
+  };
+
+  ezSimdQuat qRotation;
+  {
+    const CompressedTrack& track = joint.m_Rotation;
+
+    float fLerp;
+    const ezUInt32 uiKey = FindKey(m_KeyframeIndices.GetArrayPtr().GetSubArray(track.m_uiFirstKey, track.m_uiNumKeys), fFrame, fLerp);
+
+    if (track.m_bQuantized)
+    {
+      const ezUInt16* pValues = &m_QuantizedValues[track.m_uiFirstValue];
+
+      qRotation = DequantizeQuat(pValues + uiKey * 3);
+      if (track.m_uiNumKeys > 1)
+      {
+        qRotation = InterpolateQuat(qRotation, DequantizeQuat(pValues + uiKey * 3 + 3), fLerp);
+      }
+    }
+    else
+    {
+      const ezVec4* pValues = &m_UnquantizedValues[track.m_uiFirstValue];
+
+      qRotation = ezSimdQuat(ezSimdConversion::ToVec4(pValues[uiKey]));
+      if (track.m_uiNumKeys > 1)
+      {
+        qRotation = InterpolateQuat(qRotation, ezSimdQuat(ezSimdConversion::ToVec4(pValues[uiKey + 1])), fLerp);
+      }
+    }
+  }
+
+  return ezSimdTransform(SampleVec3(joint.m_Position), qRotation, SampleVec3(joint.m_Scale));
 }
 
 ezTime ezAnimationClipResourceDescriptor::GetDuration() const
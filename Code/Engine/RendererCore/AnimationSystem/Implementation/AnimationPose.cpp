@@ -51,15 +51,22 @@ void ezAnimationPose::ConvertFromLocalSpaceToObjectSpace(const ezSkeleton& skele
   // Since the joints are sorted (at least no child joint comes before it's parent joint)
   // we can simply grab the already stored parent transform from the pose to get the multiplied
   // transforms up to the child joint we currently work on.
+  const ezUInt16* pParentIndices = skeleton.GetParentIndices().GetPtr();
+  ezMat4* pTransforms = m_Transforms.GetData();
+
   for (ezUInt32 i = 0; i < numTransforms; ++i)
   {
-    const ezSkeletonJoint& joint = skeleton.GetJointByIndex(i);
+    const ezUInt16 uiParentIndex = pParentIndices[i];
 
     // If it is a root joint the transform is already final.
-    if (!joint.IsRootJoint())
+    if (uiParentIndex != ezInvalidJointIndex)
     {
       // else grab transform of parent joint and use it to make the final transform for this joint
-      m_Transforms[i] = m_Transforms[joint.GetParentIndex()] * m_Transforms[i];
+      ezSimdMat4f parent, local;
+      parent.SetFromArray(pTransforms[uiParentIndex].m_fElementsCM, ezMatrixLayout::ColumnMajor);
+      local.SetFromArray(pTransforms[i].m_fElementsCM, ezMatrixLayout::ColumnMajor);
+
+      (parent * local).GetAsArray(pTransforms[i].m_fElementsCM, ezMatrixLayout::ColumnMajor);
     }
   }
 }
@@ -70,12 +77,24 @@ void ezAnimationPose::ConvertFromObjectSpaceToSkinningSpace(const ezSkeleton& sk
 
   // STEP 2: multiply each joint's individual inverse-global-pose matrix into the result
 
+  ComputeSkinningTransforms(skeleton, m_Transforms);
+}
+
+void ezAnimationPose::ComputeSkinningTransforms(const ezSkeleton& skeleton, ezArrayPtr<ezMat4> out_Transforms) const
+{
   const ezUInt32 numTransforms = GetTransformCount();
 
+  EZ_ASSERT_DEV(skeleton.GetJointCount() == numTransforms, "Pose and skeleton have different joint count!");
+  EZ_ASSERT_DEV(out_Transforms.GetCount() == numTransforms, "Invalid number of output transforms");
+
+  const ezSimdMat4f* pInverseBindPose = skeleton.GetInverseBindPoseMatrices().GetPtr();
+
   for (ezUInt32 i = 0; i < numTransforms; ++i)
   {
-    const ezSkeletonJoint& joint = skeleton.GetJointByIndex(i);
-    m_Transforms[i] = m_Transforms[i] * joint.GetInverseBindPoseGlobalTransform().GetAsMat4();
+    ezSimdMat4f objectSpace;
+    objectSpace.SetFromArray(m_Transforms[i].m_fElementsCM, ezMatrixLayout::ColumnMajor);
+
+    (objectSpace * pInverseBindPose[i]).GetAsArray(out_Transforms[i].m_fElementsCM, ezMatrixLayout::ColumnMajor);
   }
 }
 
@@ -11,6 +11,8 @@ ezArrayPtr<const ezJointMapping::Mapping> ezJointMapping::GetAllMappings() const
 
 void ezJointMapping::CreateMapping(const ezSkeleton& skeleton, const ezAnimationClipResourceDescriptor& animClip)
 {
+  m_Mappings.Clear();
+
   const ezArrayMap<ezHashedString, ezUInt16>& nameToIndex = animClip.GetAllJointIndices();
 
   for (ezUInt32 i = 0; i < nameToIndex.GetCount(); ++i)
@@ -28,6 +30,8 @@ void ezJointMapping::CreateMapping(const ezSkeleton& skeleton, const ezAnimation
 void ezJointMapping::CreatePartialMapping(const ezSkeleton& skeleton, const ezAnimationClipResourceDescriptor& animClip,
                                           const ezTempHashedString& rootJoint)
 {
+  m_Mappings.Clear();
+
   const ezUInt16 uiRootJointInSkeleton = skeleton.FindJointByName(rootJoint);
   if (uiRootJointInSkeleton == ezInvalidJointIndex)
     return;
@@ -1,5 +1,7 @@
 #include <RendererCorePCH.h>
 
+#include <Foundation/SimdMath/SimdConversion.h>
+#include <Foundation/Threading/AtomicInteger.h>
 #include <RendererCore/AnimationSystem/Skeleton.h>
 
 ezSkeleton::ezSkeleton() = default;
@@ -108,6 +110,25 @@ void ezSkeleton::Load(ezStreamReader& stream)
       stream >> joint.m_InverseBindPoseGlobal;
     }
   }
+
+  UpdateJointArrays();
+}
+
+void ezSkeleton::UpdateJointArrays()
+{
+  static ezAtomicInteger32 s_iNextJointSetupID;
+  m_uiJointSetupID = static_cast<ezUInt32>(s_iNextJointSetupID.Increment());
+
+  const ezUInt32 uiNumJoints = m_Joints.GetCount();
+
+  m_ParentIndices.SetCountUninitialized(uiNumJoints);
+  m_InverseBindPoseMatrices.SetCountUninitialized(uiNumJoints);
+
+  for (ezUInt32 i = 0; i < uiNumJoints; ++i)
+  {
+    m_ParentIndices[i] = m_Joints[i].m_uiParentIndex;
+    m_InverseBindPoseMatrices[i] = ezSimdConversion::ToMat4(m_Joints[i].m_InverseBindPoseGlobal.GetAsMat4());
+  }
 }
 
 bool ezSkeleton::IsJointDescendantOf(ezUInt16 uiJoint, ezUInt16 uiExpectedParent) const
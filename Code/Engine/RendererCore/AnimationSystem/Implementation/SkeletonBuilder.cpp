@@ -42,6 +42,8 @@ void ezSkeletonBuilder::BuildSkeleton(ezSkeleton& skeleton) const
     skeleton.m_Joints[i].m_BindPoseLocal = m_Joints[i].m_BindPoseLocal;
     skeleton.m_Joints[i].m_InverseBindPoseGlobal = m_Joints[i].m_InverseBindPoseGlobal;
   }
+
+  skeleton.UpdateJointArrays();
 }
 
 bool ezSkeletonBuilder::HasJoints() const
@@ -6,7 +6,7 @@
 
 class ezSkeleton;
 
-class ezJointMapping
+class EZ_RENDERERCORE_DLL ezJointMapping
 {
 public:
   struct Mapping
@@ -19,6 +19,7 @@ public:
 
   ezArrayPtr<const Mapping> GetAllMappings() const;
 
+  /// \brief Maps every joint of the animation clip to the skeleton joint with the same name. Joints that the skeleton doesn't have are skipped.
   void CreateMapping(const ezSkeleton& skeleton, const ezAnimationClipResourceDescriptor& animClip);
   void CreatePartialMapping(const ezSkeleton& skeleton, const ezAnimationClipResourceDescriptor& animClip, const ezTempHashedString& rootJoint);
 
@@ -4,6 +4,7 @@
 
 #include <Foundation/Math/Mat3.h>
 #include <Foundation/Reflection/Reflection.h>
+#include <Foundation/SimdMath/SimdMat4f.h>
 #include <Foundation/Strings/HashedString.h>
 #include <Foundation/Types/UniquePtr.h>
 #include <RendererCore/AnimationSystem/Declarations.h>
@@ -66,12 +67,31 @@ public:
 
   bool IsJointDescendantOf(ezUInt16 uiJoint, ezUInt16 uiExpectedParent) const;
 
+  /// \brief Returns the parent index of every joint (see ezSkeletonJoint::GetParentIndex()) as one contiguous array.
+  ezArrayPtr<const ezUInt16> GetParentIndices() const { return m_ParentIndices; }
+
+  /// \brief Returns the inverse global bind pose of every joint as a matrix, ready to be used for computing skinning transforms.
+  ezArrayPtr<const ezSimdMat4f> GetInverseBindPoseMatrices() const { return m_InverseBindPoseMatrices; }
+
+  /// \brief Returns a value that changes whenever the joints of this skeleton change, e.g. when it gets reloaded.
+  ///
+  /// Allows to detect when data that was derived from the skeleton, like an ezJointMapping, needs to be recomputed.
+  ezUInt32 GetJointSetupID() const { return m_uiJointSetupID; }
+
   /// \brief Applies a global transform to the skeleton (used by the importer to correct scale and up-axis)
   // void ApplyGlobalTransform(const ezMat3& transform);
 
 protected:
   friend ezSkeletonBuilder;
 
+  /// \brief Fills the per joint arrays that are used by ezAnimationPose from m_Joints.
+  void UpdateJointArrays();
+
   ezDynamicArray<ezSkeletonJoint> m_Joints;
+
+  // the data that is needed for every pose update, stored as separate arrays for cache efficient batch processing
+  ezDynamicArray<ezUInt16> m_ParentIndices;
+  ezDynamicArray<ezSimdMat4f, ezAlignedAllocatorWrapper> m_InverseBindPoseMatrices;
+  ezUInt32 m_uiJointSetupID = 0;
 };
 
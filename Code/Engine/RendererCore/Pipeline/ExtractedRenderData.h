@@ -81,10 +81,28 @@ private:
 
   const ezRenderData* GetFrameData(const ezRTTI* pRtti) const;
 
+  struct SortEntry
+  {
+    EZ_DECLARE_POD_TYPE();
+
+    ezUInt64 m_uiSortingKey;
+    const ezRenderData* m_pRenderData;
+    ezUInt32 m_uiBatchId;
+    ezUInt32 m_uiTypeIndex;
+  };
+
   struct DataPerCategory
   {
+    void SortAndBatch();
+
     ezDynamicArray< ezRenderDataBatch > m_Batches;
     ezDynamicArray< ezRenderDataBatch::SortableRenderData > m_SortableRenderData;
+
+    // scratch memory for sorting and batching, kept across frames to avoid re-allocations
+    ezDynamicArray<SortEntry> m_SortEntries;
+    ezDynamicArray<SortEntry> m_SortEntriesTemp;
+    ezDynamicArray<ezUInt32> m_BatchIds;
+    ezDynamicArray<ezUInt32> m_TypeIndices;
   };
 
   ezCamera m_Camera;
@@ -1,6 +1,8 @@
 #include <RendererCorePCH.h>
 
 #include <Foundation/Profiling/Profiling.h>
+#include <Foundation/SimdMath/SimdVec4i.h>
+#include <Foundation/Threading/TaskSystem.h>
 #include <RendererCore/Pipeline/ExtractedRenderData.h>
 
 ezExtractedRenderData::ezExtractedRenderData() {}
@@ -19,55 +21,234 @@ void ezExtractedRenderData::AddFrameData(const ezRenderData* pFrameData)
   m_FrameData.PushBack(pFrameData);
 }
 
-void ezExtractedRenderData::SortAndBatch()
+namespace
 {
-  EZ_PROFILE_SCOPE("SortAndBatch");
+  // Categories with fewer entries use a comparison sort, for them the radix sort's histograms are not worth it.
+  constexpr ezUInt32 s_uiMinRadixSortCount = 256;
+
+  // Categories are only sorted in parallel tasks if there is enough data in total.
+  constexpr ezUInt32 s_uiMinParallelSortCount = 4096;
+
+  // The radix sort key is 96 bits wide: the batch id in the lowest 32 bits and the sorting key above it.
+  // Each pass of the LSD radix sort processes 8 bits, starting with the least significant byte.
+  constexpr ezUInt32 s_uiNumRadixPasses = 12;
+
+  template <typename Entry>
+  EZ_ALWAYS_INLINE ezUInt32 GetRadixDigit(const Entry& entry, ezUInt32 uiPass)
+  {
+    if (uiPass < 4)
+      return (entry.m_uiBatchId >> (uiPass * 8)) & 0xFF;
+
+    return static_cast<ezUInt32>(entry.m_uiSortingKey >> ((uiPass - 4) * 8)) & 0xFF;
+  }
 
-  struct RenderDataComparer
+  template <typename Entry>
+  void RadixSort(ezDynamicArray<Entry>& entries, ezDynamicArray<Entry>& temp)
   {
-    EZ_FORCE_INLINE bool Less(const ezRenderDataBatch::SortableRenderData& a, const ezRenderDataBatch::SortableRenderData& b) const
+    const ezUInt32 uiCount = entries.GetCount();
+    temp.SetCountUninitialized(uiCount);
+
+    // build the histograms of all passes in one go
+    ezUInt32 histograms[s_uiNumRadixPasses][256];
+    ezMemoryUtils::ZeroFill(&histograms[0][0], s_uiNumRadixPasses * 256);
+
+    for (const Entry& entry : entries)
     {
-      if (a.m_uiSortingKey == b.m_uiSortingKey)
+      for (ezUInt32 uiPass = 0; uiPass < s_uiNumRadixPasses; ++uiPass)
       {
-        return a.m_pRenderData->m_uiBatchId < b.m_pRenderData->m_uiBatchId;
+        ++histograms[uiPass][GetRadixDigit(entry, uiPass)];
       }
+    }
+
+    Entry* pSrc = entries.GetData();
+    Entry* pDst = temp.GetData();
+
+    for (ezUInt32 uiPass = 0; uiPass < s_uiNumRadixPasses; ++uiPass)
+    {
+      ezUInt32* pHistogram = histograms[uiPass];
+
+      // all entries have the same digit, e.g. the unused upper bits of the batch id, so this pass would not change anything
+      if (pHistogram[GetRadixDigit(pSrc[0], uiPass)] == uiCount)
+        continue;
 
-      return a.m_uiSortingKey < b.m_uiSortingKey;
+      // turn the histogram into start offsets
+      ezUInt32 uiOffset = 0;
+      for (ezUInt32 uiDigit = 0; uiDigit < 256; ++uiDigit)
+      {
+        const ezUInt32 uiDigitCount = pHistogram[uiDigit];
+        pHistogram[uiDigit] = uiOffset;
+        uiOffset += uiDigitCount;
+      }
+
+      for (ezUInt32 i = 0; i < uiCount; ++i)
+      {
+        pDst[pHistogram[GetRadixDigit(pSrc[i], uiPass)]++] = pSrc[i];
+      }
+
+      ezMath::Swap(pSrc, pDst);
     }
-  };
 
+    if (pSrc != entries.GetData())
+    {
+      entries.Swap(temp);
+    }
+  }
+} // namespace
+
+void ezExtractedRenderData::SortAndBatch()
+{
+  EZ_PROFILE_SCOPE("SortAndBatch");
+
+  ezUInt32 uiTotalCount = 0;
   for (auto& dataPerCategory : m_DataPerCategory)
   {
-    if (dataPerCategory.m_SortableRenderData.IsEmpty())
-      continue;
+    uiTotalCount += dataPerCategory.m_SortableRenderData.GetCount();
+  }
+
+  if (uiTotalCount >= s_uiMinParallelSortCount && m_DataPerCategory.GetCount() > 1)
+  {
+    ezParallelForParams params;
+    params.uiBinSize = 1;
+    params.uiMaxTasksPerThread = 1;
+
+    ezTaskSystem::ParallelForIndexed(0, m_DataPerCategory.GetCount(),
+        [this](ezUInt32 uiStartIndex, ezUInt32 uiEndIndex) {
+          for (ezUInt32 i = uiStartIndex; i < uiEndIndex; ++i)
+          {
+            m_DataPerCategory[i].SortAndBatch();
+          }
+        },
+        "SortAndBatch", params);
+  }
+  else
+  {
+    for (auto& dataPerCategory : m_DataPerCategory)
+    {
+      dataPerCategory.SortAndBatch();
+    }
+  }
+}
 
-    auto& data = dataPerCategory.m_SortableRenderData;
+void ezExtractedRenderData::DataPerCategory::SortAndBatch()
+{
+  auto& data = m_SortableRenderData;
+  const ezUInt32 uiCount = data.GetCount();
 
-    // Sort
-    data.Sort(RenderDataComparer());
+  if (uiCount == 0)
+    return;
 
-    // Find batches
-    ezUInt32 uiCurrentBatchId = data[0].m_pRenderData->m_uiBatchId;
-    ezUInt32 uiCurrentBatchStartIndex = 0;
-    const ezRTTI* pCurrentBatchType = data[0].m_pRenderData->GetDynamicRTTI();
+  // Gather everything that sorting and batching needs into one array, such that neither has to touch the render data again.
+  // Types are identified by a per category index which is cheaper to compare than the rtti.
+  m_SortEntries.SetCountUninitialized(uiCount);
+  {
+    ezHybridArray<const ezRTTI*, 16> types;
+    const ezRTTI* pLastType = nullptr;
+    ezUInt32 uiLastTypeIndex = 0;
 
-    for (ezUInt32 i = 1; i < data.GetCount(); ++i)
+    for (ezUInt32 i = 0; i < uiCount; ++i)
     {
-      auto pRenderData = data[i].m_pRenderData;
+      const ezRenderData* pRenderData = data[i].m_pRenderData;
+      const ezRTTI* pType = pRenderData->GetDynamicRTTI();
 
-      if (pRenderData->m_uiBatchId != uiCurrentBatchId || pRenderData->GetDynamicRTTI() != pCurrentBatchType)
+      if (pType != pLastType)
       {
-        dataPerCategory.m_Batches.ExpandAndGetRef().m_Data = ezMakeArrayPtr(&data[uiCurrentBatchStartIndex], i - uiCurrentBatchStartIndex);
+        uiLastTypeIndex = types.IndexOf(pType);
+        if (uiLastTypeIndex == ezInvalidIndex)
+        {
+          uiLastTypeIndex = types.GetCount();
+          types.PushBack(pType);
+        }
 
-        uiCurrentBatchId = pRenderData->m_uiBatchId;
-        uiCurrentBatchStartIndex = i;
-        pCurrentBatchType = pRenderData->GetDynamicRTTI();
+        pLastType = pType;
       }
+
+      SortEntry& entry = m_SortEntries[i];
+      entry.m_uiSortingKey = data[i].m_uiSortingKey;
+      entry.m_pRenderData = pRenderData;
+      entry.m_uiBatchId = pRenderData->m_uiBatchId;
+      entry.m_uiTypeIndex = uiLastTypeIndex;
     }
+  }
+
+  // Sort
+  if (uiCount < s_uiMinRadixSortCount)
+  {
+    struct SortEntryComparer
+    {
+      EZ_FORCE_INLINE bool Less(const SortEntry& a, const SortEntry& b) const
+      {
+        if (a.m_uiSortingKey == b.m_uiSortingKey)
+        {
+          return a.m_uiBatchId < b.m_uiBatchId;
+        }
 
-    dataPerCategory.m_Batches.ExpandAndGetRef().m_Data =
-        ezMakeArrayPtr(&data[uiCurrentBatchStartIndex], data.GetCount() - uiCurrentBatchStartIndex);
+        return a.m_uiSortingKey < b.m_uiSortingKey;
+      }
+    };
+
+    m_SortEntries.Sort(SortEntryComparer());
+  }
+  else
+  {
+    RadixSort(m_SortEntries, m_SortEntriesTemp);
+  }
+
+  m_BatchIds.SetCountUninitialized(uiCount);
+  m_TypeIndices.SetCountUninitialized(uiCount);
+
+  for (ezUInt32 i = 0; i < uiCount; ++i)
+  {
+    const SortEntry& entry = m_SortEntries[i];
+    data[i].m_pRenderData = entry.m_pRenderData;
+    data[i].m_uiSortingKey = entry.m_uiSortingKey;
+    m_BatchIds[i] = entry.m_uiBatchId;
+    m_TypeIndices[i] = entry.m_uiTypeIndex;
   }
+
+  // Find batches
+  ezUInt32 uiCurrentBatchStartIndex = 0;
+
+  auto IsBatchStart = [&](ezUInt32 i) { return m_BatchIds[i] != m_BatchIds[i - 1] || m_TypeIndices[i] != m_TypeIndices[i - 1]; };
+
+  auto AddBatch = [&](ezUInt32 uiEndIndex) {
+    m_Batches.ExpandAndGetRef().m_Data = ezMakeArrayPtr(&data[uiCurrentBatchStartIndex], uiEndIndex - uiCurrentBatchStartIndex);
+    uiCurrentBatchStartIndex = uiEndIndex;
+  };
+
+  // Compare four neighbors at once, batches are usually much larger than that so most iterations find no batch start.
+  const ezInt32* pBatchIds = reinterpret_cast<const ezInt32*>(m_BatchIds.GetData());
+  const ezInt32* pTypeIndices = reinterpret_cast<const ezInt32*>(m_TypeIndices.GetData());
+
+  ezUInt32 i = 1;
+  for (; i + 4 <= uiCount; i += 4)
+  {
+    ezSimdVec4i prevBatchIds, batchIds, prevTypeIndices, typeIndices;
+    prevBatchIds.Load<4>(pBatchIds + i - 1);
+    batchIds.Load<4>(pBatchIds + i);
+    prevTypeIndices.Load<4>(pTypeIndices + i - 1);
+    typeIndices.Load<4>(pTypeIndices + i);
+
+    if (((prevBatchIds != batchIds) || (prevTypeIndices != typeIndices)).NoneSet())
+      continue;
+
+    for (ezUInt32 j = i; j < i + 4; ++j)
+    {
+      if (IsBatchStart(j))
+      {
+        AddBatch(j);
+      }
+    }
+  }
+
+  for (; i < uiCount; ++i)
+  {
+    if (IsBatchStart(i))
+    {
+      AddBatch(i);
+    }
+  }
+
+  AddBatch(uiCount);
 }
 
 void ezExtractedRenderData::Clear()
@@ -76,6 +257,10 @@ void ezExtractedRenderData::Clear()
   {
     dataPerCategory.m_Batches.Clear();
     dataPerCategory.m_SortableRenderData.Clear();
+    dataPerCategory.m_SortEntries.Clear();
+    dataPerCategory.m_SortEntriesTemp.Clear();
+    dataPerCategory.m_BatchIds.Clear();
+    dataPerCategory.m_TypeIndices.Clear();
   }
 
   m_FrameData.Clear();
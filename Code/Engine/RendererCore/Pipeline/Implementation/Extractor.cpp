@@ -5,6 +5,7 @@
 #include <RendererCore/Debug/DebugRenderer.h>
 #include <RendererCore/RenderWorld/RenderWorld.h>
 #include <Core/World/World.h>
+#include <Core/World/SpatialSystem_LooseOctree.h>
 #include <Core/World/SpatialSystem_RegularGrid.h>
 #include <Foundation/Configuration/CVar.h>
 #include <RendererCore/Pipeline/ExtractedRenderData.h>
@@ -28,17 +29,21 @@ namespace
     if (CVarVisSpatialData && CVarVisObjectName.GetValue().IsEmpty() && !CVarVisObjectSelection)
     {
       const ezSpatialSystem& spatialSystem = *view.GetWorld()->GetSpatialSystem();
+      ezSpatialData::Category filterCategory = ezSpatialData::FindCategory(CVarVisSpatialCategory.GetValue());
+
+      ezHybridArray<ezBoundingBox, 16> boxes;
       if (auto pSpatialSystemGrid = ezDynamicCast<const ezSpatialSystem_RegularGrid*>(&spatialSystem))
       {
-        ezSpatialData::Category filterCategory = ezSpatialData::FindCategory(CVarVisSpatialCategory.GetValue());
-
-        ezHybridArray<ezBoundingBox, 16> boxes;
         pSpatialSystemGrid->GetAllCellBoxes(boxes, filterCategory);
+      }
+      else if (auto pSpatialSystemOctree = ezDynamicCast<const ezSpatialSystem_LooseOctree*>(&spatialSystem))
+      {
+        pSpatialSystemOctree->GetAllNodeBoxes(boxes, filterCategory);
+      }
 
-        for (auto& box : boxes)
-        {
-          ezDebugRenderer::DrawLineBox(view.GetHandle(), box, ezColor::Cyan);
-        }
+      for (auto& box : boxes)
+      {
+        ezDebugRenderer::DrawLineBox(view.GetHandle(), box, ezColor::Cyan);
       }
     }
   }
@@ -70,13 +75,21 @@ namespace
     if (CVarVisSpatialData && CVarVisSpatialCategory.GetValue().IsEmpty())
     {
       const ezSpatialSystem& spatialSystem = *view.GetWorld()->GetSpatialSystem();
+      ezBoundingBox box;
+      ezResult res = EZ_FAILURE;
+
       if (auto pSpatialSystemGrid = ezDynamicCast<const ezSpatialSystem_RegularGrid*>(&spatialSystem))
       {
-        ezBoundingBox box;
-        if (pSpatialSystemGrid->GetCellBoxForSpatialData(pObject->GetSpatialData(), box).Succeeded())
-        {
-          ezDebugRenderer::DrawLineBox(view.GetHandle(), box, ezColor::Cyan);
-        }
+        res = pSpatialSystemGrid->GetCellBoxForSpatialData(pObject->GetSpatialData(), box);
+      }
+      else if (auto pSpatialSystemOctree = ezDynamicCast<const ezSpatialSystem_LooseOctree*>(&spatialSystem))
+      {
+        res = pSpatialSystemOctree->GetNodeBoxForSpatialData(pObject->GetSpatialData(), box);
+      }
+
+      if (res.Succeeded())
+      {
+        ezDebugRenderer::DrawLineBox(view.GetHandle(), box, ezColor::Cyan);
       }
     }
   }
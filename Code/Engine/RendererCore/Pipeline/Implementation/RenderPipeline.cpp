@@ -20,6 +20,14 @@ ezCVarBool ezRenderPipeline::s_DebugCulling("r_DebugCulling", false, ezCVarFlags
 ezCVarBool CVarCullingStats("r_CullingStats", false, ezCVarFlags::Default, "Display some stats of the visibility culling");
 #endif
 
+namespace
+{
+  EZ_ALWAYS_INLINE ezUInt32 GetVisibilityCategoryBitmask()
+  {
+    return ezDefaultSpatialDataCategories::RenderStatic.GetBitmask() | ezDefaultSpatialDataCategories::RenderDynamic.GetBitmask();
+  }
+} // namespace
+
 ezRenderPipeline::ezRenderPipeline()
   : m_PipelineState(PipelineState::Uninitialized)
 {
@@ -27,6 +35,7 @@ ezRenderPipeline::ezRenderPipeline()
   m_CurrentRenderThread = (ezThreadID)0;
   m_uiLastExtractionFrame = -1;
   m_uiLastRenderFrame = -1;
+  m_uiPrecomputedVisibilityFrame = -1;
 
 #if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
   m_AverageCullingTime = ezTime::Seconds(0.1f);
@@ -927,6 +936,10 @@ void ezRenderPipeline::FindVisibleObjects(const ezView& view)
 {
   EZ_PROFILE_SCOPE("Visibility Culling");
 
+  // the visible objects have already been determined together with other views, see ezRenderWorld::AddViewsToRender
+  if (m_uiPrecomputedVisibilityFrame == ezRenderWorld::GetFrameCounter())
+    return;
+
   m_visibleObjects.Clear();
 
   ezFrustum frustum;
@@ -934,13 +947,14 @@ void ezRenderPipeline::FindVisibleObjects(const ezView& view)
 
   EZ_LOCK(view.GetWorld()->GetReadMarker());
 
+  const ezUInt32 uiCategoryBitmask = GetVisibilityCategoryBitmask();
+
 #if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
   const bool bIsMainView =
     (view.GetCameraUsageHint() == ezCameraUsageHint::MainView || view.GetCameraUsageHint() == ezCameraUsageHint::EditorView);
   const bool bRecordStats = CVarCullingStats && bIsMainView;
   ezSpatialSystem::QueryStats stats;
 
-  ezUInt32 uiCategoryBitmask = ezDefaultSpatialDataCategories::RenderStatic.GetBitmask() | ezDefaultSpatialDataCategories::RenderDynamic.GetBitmask();
   view.GetWorld()->GetSpatialSystem()->FindVisibleObjects(frustum, uiCategoryBitmask, m_visibleObjects, bRecordStats ? &stats : nullptr);
 
   ezViewHandle hView = view.GetHandle();
@@ -959,23 +973,45 @@ void ezRenderPipeline::FindVisibleObjects(const ezView& view)
     sb.Format("Total Num Objects: {0}", stats.m_uiTotalNumObjects);
     ezDebugRenderer::Draw2DText(hView, sb, ezVec2I32(10, 220), ezColor::LimeGreen);
 
-    sb.Format("Num Objects Tested: {0}", stats.m_uiNumObjectsTested);
+    sb.Format("Num Nodes Visited: {0}", stats.m_uiNumNodesVisited);
     ezDebugRenderer::Draw2DText(hView, sb, ezVec2I32(10, 240), ezColor::LimeGreen);
 
-    sb.Format("Num Objects Passed: {0}", stats.m_uiNumObjectsPassed);
+    sb.Format("Num Objects Tested: {0}", stats.m_uiNumObjectsTested);
     ezDebugRenderer::Draw2DText(hView, sb, ezVec2I32(10, 260), ezColor::LimeGreen);
 
+    sb.Format("Num Objects Passed: {0}", stats.m_uiNumObjectsPassed);
+    ezDebugRenderer::Draw2DText(hView, sb, ezVec2I32(10, 280), ezColor::LimeGreen);
+
     // Exponential moving average for better readability.
     m_AverageCullingTime = ezMath::Lerp(m_AverageCullingTime, stats.m_TimeTaken, 0.05f);
 
     sb.Format("Time Taken: {0}ms", m_AverageCullingTime.GetMilliseconds());
-    ezDebugRenderer::Draw2DText(hView, sb, ezVec2I32(10, 280), ezColor::LimeGreen);
+    ezDebugRenderer::Draw2DText(hView, sb, ezVec2I32(10, 300), ezColor::LimeGreen);
   }
 #else
-  view.GetWorld()->GetSpatialSystem().FindVisibleObjects(frustum, m_visibleObjects, nullptr);
+  view.GetWorld()->GetSpatialSystem()->FindVisibleObjects(frustum, uiCategoryBitmask, m_visibleObjects, nullptr);
 #endif
 }
 
+// static
+void ezRenderPipeline::FindVisibleObjectsBatched(const ezWorld* pWorld, ezArrayPtr<const ezFrustum> frustums, ezArrayPtr<ezRenderPipeline*> pipelines)
+{
+  EZ_PROFILE_SCOPE("Batched Visibility Culling");
+
+  ezHybridArray<ezDynamicArray<const ezGameObject*>*, 8> visibleObjects;
+  for (ezRenderPipeline* pPipeline : pipelines)
+  {
+    pPipeline->m_visibleObjects.Clear();
+    pPipeline->m_uiPrecomputedVisibilityFrame = ezRenderWorld::GetFrameCounter();
+
+    visibleObjects.PushBack(&pPipeline->m_visibleObjects);
+  }
+
+  EZ_LOCK(pWorld->GetReadMarker());
+
+  pWorld->GetSpatialSystem()->FindVisibleObjects(frustums, GetVisibilityCategoryBitmask(), visibleObjects);
+}
+
 void ezRenderPipeline::Render(ezRenderContext* pRenderContext)
 {
   EZ_PROFILE_AND_MARKER(pRenderContext->GetGALContext(), m_sName.GetData());
@@ -9,6 +9,8 @@
 
 class ezProfilingId;
 class ezView;
+class ezWorld;
+class ezFrustum;
 class ezRenderPipelinePass;
 class ezFrameDataProviderBase;
 
@@ -80,6 +82,9 @@ private:
   void ExtractData(const ezView& view);
   void FindVisibleObjects(const ezView& view);
 
+  /// \brief Determines the visible objects of several pipelines with a single batched query. pipelines[i] renders frustums[i].
+  static void FindVisibleObjectsBatched(const ezWorld* pWorld, ezArrayPtr<const ezFrustum> frustums, ezArrayPtr<ezRenderPipeline*> pipelines);
+
   void Render(ezRenderContext* pRenderer);
 
 private: // Member data
@@ -97,6 +102,7 @@ private: // Member data
 
   ezHashedString m_sName;
   ezUInt64 m_uiLastExtractionFrame;
+  ezUInt64 m_uiPrecomputedVisibilityFrame;
   ezUInt64 m_uiLastRenderFrame;
 
   // Render pass graph data
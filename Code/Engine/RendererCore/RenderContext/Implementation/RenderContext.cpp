@@ -25,6 +25,29 @@ ezMap<ezUInt32, ezDynamicArray<ezConstantBufferStorageBase*>> ezRenderContext::s
 
 ezGALSamplerStateHandle ezRenderContext::s_hDefaultSamplerStates[4];
 
+namespace
+{
+  EZ_ALWAYS_INLINE ezUInt64 HashPermutationVariable(ezUInt32 uiNameHash, ezUInt32 uiValueHash)
+  {
+    const ezUInt32 hashes[2] = {uiNameHash, uiValueHash};
+    return ezHashingUtils::xxHash64(hashes, sizeof(hashes));
+  }
+
+  constexpr ezRenderContextFlags::Enum s_BindingTypeToFlag[] = {
+    ezRenderContextFlags::TextureBindingChanged, // Texture2D
+    ezRenderContextFlags::TextureBindingChanged, // Texture3D
+    ezRenderContextFlags::TextureBindingChanged, // TextureCube
+    ezRenderContextFlags::UAVBindingChanged,
+    ezRenderContextFlags::SamplerBindingChanged,
+    ezRenderContextFlags::BufferBindingChanged,
+    ezRenderContextFlags::ConstantBufferBindingChanged,
+  };
+
+  const ezBitflags<ezRenderContextFlags> s_AllBindingFlags = ezRenderContextFlags::TextureBindingChanged | ezRenderContextFlags::UAVBindingChanged |
+                                                              ezRenderContextFlags::SamplerBindingChanged | ezRenderContextFlags::BufferBindingChanged |
+                                                              ezRenderContextFlags::ConstantBufferBindingChanged;
+} // namespace
+
 // clang-format off
 EZ_BEGIN_SUBSYSTEM_DECLARATION(RendererCore, RendererContext)
 
@@ -63,6 +86,10 @@ ezRenderContext::Statistics::Statistics()
 void ezRenderContext::Statistics::Reset()
 {
   m_uiFailedDrawcalls = 0;
+  m_uiRedundantBindings = 0;
+  m_uiAppliedBindings = 0;
+  m_uiSkippedBindings = 0;
+  m_uiCachedPermutationLookups = 0;
 }
 
 //////////////////////////////////////////////////////////////////////////
@@ -100,6 +127,8 @@ ezRenderContext::ezRenderContext()
   m_uiMeshBufferPrimitiveCount = 0;
   m_DefaultTextureFilter = ezTextureFilterSetting::FixedAnisotropic4x;
   m_bAllowAsyncShaderLoading = false;
+  m_uiPermutationVariablesHash = 0;
+  m_uiLastImplicitUnbindCounter = 0;
 
   m_hGlobalConstantBufferStorage = CreateConstantBufferStorage<ezGlobalConstants>();
 
@@ -128,7 +157,7 @@ void ezRenderContext::SetGALContext(ezGALContext* pContext)
 ezRenderContext::Statistics ezRenderContext::GetAndResetStatistics()
 {
   ezRenderContext::Statistics ret = m_Statistics;
-  ret.Reset();
+  m_Statistics.Reset();
 
   return ret;
 }
@@ -137,20 +166,39 @@ void ezRenderContext::SetShaderPermutationVariable(const char* szName, const ezT
 {
   ezTempHashedString sHashedName(szName);
 
-  ezHashedString sName;
-  ezHashedString sValue;
-  if (ezShaderManager::IsPermutationValueAllowed(szName, sHashedName, sTempValue, sName, sValue))
+  const ezUInt64 uiKey = (ezUInt64)sHashedName.GetHash() << 32 | sTempValue.GetHash();
+
+  PermutationVariable* pVariable = nullptr;
+  if (!m_PermutationVariableCache.TryGetValue(uiKey, pVariable))
   {
-    SetShaderPermutationVariableInternal(sName, sValue);
+    ezHashedString sName;
+    ezHashedString sValue;
+    if (!ezShaderManager::IsPermutationValueAllowed(szName, sHashedName, sTempValue, sName, sValue))
+      return;
+
+    pVariable = &m_PermutationVariableCache[uiKey];
+    pVariable->m_sName = sName;
+    pVariable->m_sValue = sValue;
   }
+
+  SetShaderPermutationVariableInternal(pVariable->m_sName, pVariable->m_sValue);
 }
 
 void ezRenderContext::SetShaderPermutationVariable(const ezHashedString& sName, const ezHashedString& sValue)
 {
-  if (ezShaderManager::IsPermutationValueAllowed(sName, sValue))
+  const ezUInt64 uiKey = (ezUInt64)sName.GetHash() << 32 | sValue.GetHash();
+
+  if (!m_PermutationVariableCache.Contains(uiKey))
   {
-    SetShaderPermutationVariableInternal(sName, sValue);
+    if (!ezShaderManager::IsPermutationValueAllowed(sName, sValue))
+      return;
+
+    PermutationVariable& variable = m_PermutationVariableCache[uiKey];
+    variable.m_sName = sName;
+    variable.m_sValue = sValue;
   }
+
+  SetShaderPermutationVariableInternal(sName, sValue);
 }
 
 
@@ -212,7 +260,10 @@ void ezRenderContext::BindTexture2D(const ezTempHashedString& sSlotName, ezGALRe
   if (m_BoundTextures2D.TryGetValue(sSlotName.GetHash(), pOldResourceView))
   {
     if (*pOldResourceView == hResourceView)
+    {
+      m_Statistics.m_uiRedundantBindings++;
       return;
+    }
 
     *pOldResourceView = hResourceView;
   }
@@ -221,7 +272,7 @@ void ezRenderContext::BindTexture2D(const ezTempHashedString& sSlotName, ezGALRe
     m_BoundTextures2D.Insert(sSlotName.GetHash(), hResourceView);
   }
 
-  m_StateFlags.Add(ezRenderContextFlags::TextureBindingChanged);
+  OnBindingChanged(sSlotName.GetHash(), ezRenderContextFlags::TextureBindingChanged);
 }
 
 void ezRenderContext::BindTexture3D(const ezTempHashedString& sSlotName, ezGALResourceViewHandle hResourceView)
@@ -230,7 +281,10 @@ void ezRenderContext::BindTexture3D(const ezTempHashedString& sSlotName, ezGALRe
   if (m_BoundTextures3D.TryGetValue(sSlotName.GetHash(), pOldResourceView))
   {
     if (*pOldResourceView == hResourceView)
+    {
+      m_Statistics.m_uiRedundantBindings++;
       return;
+    }
 
     *pOldResourceView = hResourceView;
   }
@@ -239,7 +293,7 @@ void ezRenderContext::BindTexture3D(const ezTempHashedString& sSlotName, ezGALRe
     m_BoundTextures3D.Insert(sSlotName.GetHash(), hResourceView);
   }
 
-  m_StateFlags.Add(ezRenderContextFlags::TextureBindingChanged);
+  OnBindingChanged(sSlotName.GetHash(), ezRenderContextFlags::TextureBindingChanged);
 }
 
 void ezRenderContext::BindTextureCube(const ezTempHashedString& sSlotName, ezGALResourceViewHandle hResourceView)
@@ -248,7 +302,10 @@ void ezRenderContext::BindTextureCube(const ezTempHashedString& sSlotName, ezGAL
   if (m_BoundTexturesCube.TryGetValue(sSlotName.GetHash(), pOldResourceView))
   {
     if (*pOldResourceView == hResourceView)
+    {
+      m_Statistics.m_uiRedundantBindings++;
       return;
+    }
 
     *pOldResourceView = hResourceView;
   }
@@ -257,7 +314,7 @@ void ezRenderContext::BindTextureCube(const ezTempHashedString& sSlotName, ezGAL
     m_BoundTexturesCube.Insert(sSlotName.GetHash(), hResourceView);
   }
 
-  m_StateFlags.Add(ezRenderContextFlags::TextureBindingChanged);
+  OnBindingChanged(sSlotName.GetHash(), ezRenderContextFlags::TextureBindingChanged);
 }
 
 void ezRenderContext::BindUAV(const ezTempHashedString& sSlotName, ezGALUnorderedAccessViewHandle hUnorderedAccessView)
@@ -266,7 +323,10 @@ void ezRenderContext::BindUAV(const ezTempHashedString& sSlotName, ezGALUnordere
   if (m_BoundUAVs.TryGetValue(sSlotName.GetHash(), pOldResourceView))
   {
     if (*pOldResourceView == hUnorderedAccessView)
+    {
+      m_Statistics.m_uiRedundantBindings++;
       return;
+    }
 
     *pOldResourceView = hUnorderedAccessView;
   }
@@ -275,7 +335,7 @@ void ezRenderContext::BindUAV(const ezTempHashedString& sSlotName, ezGALUnordere
     m_BoundUAVs.Insert(sSlotName.GetHash(), hUnorderedAccessView);
   }
 
-  m_StateFlags.Add(ezRenderContextFlags::UAVBindingChanged);
+  OnBindingChanged(sSlotName.GetHash(), ezRenderContextFlags::UAVBindingChanged);
 }
 
 
@@ -290,7 +350,10 @@ void ezRenderContext::BindSamplerState(const ezTempHashedString& sSlotName, ezGA
   if (m_BoundSamplers.TryGetValue(sSlotName.GetHash(), pOldSamplerState))
   {
     if (*pOldSamplerState == hSamplerSate)
+    {
+      m_Statistics.m_uiRedundantBindings++;
       return;
+    }
 
     *pOldSamplerState = hSamplerSate;
   }
@@ -299,7 +362,7 @@ void ezRenderContext::BindSamplerState(const ezTempHashedString& sSlotName, ezGA
     m_BoundSamplers.Insert(sSlotName.GetHash(), hSamplerSate);
   }
 
-  m_StateFlags.Add(ezRenderContextFlags::SamplerBindingChanged);
+  OnBindingChanged(sSlotName.GetHash(), ezRenderContextFlags::SamplerBindingChanged);
 }
 
 void ezRenderContext::BindBuffer(const ezTempHashedString& sSlotName, ezGALResourceViewHandle hResourceView)
@@ -308,7 +371,10 @@ void ezRenderContext::BindBuffer(const ezTempHashedString& sSlotName, ezGALResou
   if (m_BoundBuffer.TryGetValue(sSlotName.GetHash(), pOldResourceView))
   {
     if (*pOldResourceView == hResourceView)
+    {
+      m_Statistics.m_uiRedundantBindings++;
       return;
+    }
 
     *pOldResourceView = hResourceView;
   }
@@ -317,7 +383,7 @@ void ezRenderContext::BindBuffer(const ezTempHashedString& sSlotName, ezGALResou
     m_BoundBuffer.Insert(sSlotName.GetHash(), hResourceView);
   }
 
-  m_StateFlags.Add(ezRenderContextFlags::BufferBindingChanged);
+  OnBindingChanged(sSlotName.GetHash(), ezRenderContextFlags::BufferBindingChanged);
 }
 
 void ezRenderContext::BindConstantBuffer(const ezTempHashedString& sSlotName, ezGALBufferHandle hConstantBuffer)
@@ -326,7 +392,10 @@ void ezRenderContext::BindConstantBuffer(const ezTempHashedString& sSlotName, ez
   if (m_BoundConstantBuffers.TryGetValue(sSlotName.GetHash(), pBoundConstantBuffer))
   {
     if (pBoundConstantBuffer->m_hConstantBuffer == hConstantBuffer)
+    {
+      m_Statistics.m_uiRedundantBindings++;
       return;
+    }
 
     pBoundConstantBuffer->m_hConstantBuffer = hConstantBuffer;
     pBoundConstantBuffer->m_hConstantBufferStorage.Invalidate();
@@ -336,7 +405,7 @@ void ezRenderContext::BindConstantBuffer(const ezTempHashedString& sSlotName, ez
     m_BoundConstantBuffers.Insert(sSlotName.GetHash(), BoundConstantBuffer(hConstantBuffer));
   }
 
-  m_StateFlags.Add(ezRenderContextFlags::ConstantBufferBindingChanged);
+  OnBindingChanged(sSlotName.GetHash(), ezRenderContextFlags::ConstantBufferBindingChanged);
 }
 
 void ezRenderContext::BindConstantBuffer(const ezTempHashedString& sSlotName, ezConstantBufferStorageHandle hConstantBufferStorage)
@@ -345,7 +414,10 @@ void ezRenderContext::BindConstantBuffer(const ezTempHashedString& sSlotName, ez
   if (m_BoundConstantBuffers.TryGetValue(sSlotName.GetHash(), pBoundConstantBuffer))
   {
     if (pBoundConstantBuffer->m_hConstantBufferStorage == hConstantBufferStorage)
+    {
+      m_Statistics.m_uiRedundantBindings++;
       return;
+    }
 
     pBoundConstantBuffer->m_hConstantBuffer.Invalidate();
     pBoundConstantBuffer->m_hConstantBufferStorage = hConstantBufferStorage;
@@ -355,7 +427,7 @@ void ezRenderContext::BindConstantBuffer(const ezTempHashedString& sSlotName, ez
     m_BoundConstantBuffers.Insert(sSlotName.GetHash(), BoundConstantBuffer(hConstantBufferStorage));
   }
 
-  m_StateFlags.Add(ezRenderContextFlags::ConstantBufferBindingChanged);
+  OnBindingChanged(sSlotName.GetHash(), ezRenderContextFlags::ConstantBufferBindingChanged);
 }
 
 void ezRenderContext::BindShader(const ezShaderResourceHandle& hShader, ezBitflags<ezShaderBindFlags> flags)
@@ -403,7 +475,7 @@ void ezRenderContext::BindMeshBuffer(ezGALBufferHandle hVertexBuffer, ezGALBuffe
   {
     m_Topology = topology;
 
-    ezTempHashedString sTopologies[ezGALPrimitiveTopology::ENUM_COUNT] = {
+    static const ezTempHashedString sTopologies[ezGALPrimitiveTopology::ENUM_COUNT] = {
       ezTempHashedString("TOPOLOGY_POINTS"), ezTempHashedString("TOPOLOGY_LINES"), ezTempHashedString("TOPOLOGY_TRIANGLES")};
 
     SetShaderPermutationVariable("TOPOLOGY", sTopologies[m_Topology]);
@@ -510,88 +582,37 @@ ezResult ezRenderContext::ApplyContextStates(bool bForce)
 
   if (m_hActiveShaderPermutation.IsValid())
   {
-    if ((bForce || m_StateFlags.IsAnySet(ezRenderContextFlags::TextureBindingChanged | ezRenderContextFlags::UAVBindingChanged |
-                                         ezRenderContextFlags::SamplerBindingChanged | ezRenderContextFlags::BufferBindingChanged |
-                                         ezRenderContextFlags::ConstantBufferBindingChanged)))
-    {
-      if (pShaderPermutation == nullptr)
-        pShaderPermutation = ezResourceManager::BeginAcquireResource(m_hActiveShaderPermutation, ezResourceAcquireMode::BlockTillLoaded);
-    }
-
-
-    if (bForce || m_StateFlags.IsSet(ezRenderContextFlags::UAVBindingChanged))
-    {
-      // RWTextures/UAV are usually only suppoprted in compute and pixel shader.
-      if (auto pBin = pShaderPermutation->GetShaderStageBinary(ezGALShaderStage::ComputeShader))
-      {
-        ApplyUAVBindings(pBin);
-      }
-      if (auto pBin = pShaderPermutation->GetShaderStageBinary(ezGALShaderStage::PixelShader))
-      {
-        ApplyUAVBindings(pBin);
-      }
-
-      m_StateFlags.Remove(ezRenderContextFlags::UAVBindingChanged);
-    }
-
-    if (bForce || m_StateFlags.IsSet(ezRenderContextFlags::TextureBindingChanged))
-    {
-      for (ezUInt32 stage = 0; stage < ezGALShaderStage::ENUM_COUNT; ++stage)
-      {
-        if (auto pBin = pShaderPermutation->GetShaderStageBinary((ezGALShaderStage::Enum)stage))
-        {
-          ApplyTextureBindings((ezGALShaderStage::Enum)stage, pBin);
-        }
-      }
-
-      m_StateFlags.Remove(ezRenderContextFlags::TextureBindingChanged);
-    }
-
-    if (bForce || m_StateFlags.IsSet(ezRenderContextFlags::SamplerBindingChanged))
-    {
-      for (ezUInt32 stage = 0; stage < ezGALShaderStage::ENUM_COUNT; ++stage)
-      {
-        if (auto pBin = pShaderPermutation->GetShaderStageBinary((ezGALShaderStage::Enum)stage))
-        {
-          ApplySamplerBindings((ezGALShaderStage::Enum)stage, pBin);
-        }
-      }
-
-      m_StateFlags.Remove(ezRenderContextFlags::SamplerBindingChanged);
-    }
-
-    if (bForce || m_StateFlags.IsSet(ezRenderContextFlags::BufferBindingChanged))
+    if (bForce || m_pGALContext->GetImplicitUnbindCounter() != m_uiLastImplicitUnbindCounter)
     {
-      for (ezUInt32 stage = 0; stage < ezGALShaderStage::ENUM_COUNT; ++stage)
-      {
-        if (auto pBin = pShaderPermutation->GetShaderStageBinary((ezGALShaderStage::Enum)stage))
-        {
-          ApplyBufferBindings((ezGALShaderStage::Enum)stage, pBin);
-        }
-      }
-
-      m_StateFlags.Remove(ezRenderContextFlags::BufferBindingChanged);
+      // the GAL context has unbound some views on its own, so we can't rely on the previously applied bindings anymore
+      m_uiLastImplicitUnbindCounter = m_pGALContext->GetImplicitUnbindCounter();
+      m_StateFlags.Add(s_AllBindingFlags);
+      m_bAllBindingsChanged = true;
     }
 
     if (pMaterial != nullptr)
     {
+      if (pShaderPermutation == nullptr)
+        pShaderPermutation = ezResourceManager::BeginAcquireResource(m_hActiveShaderPermutation, ezResourceAcquireMode::BlockTillLoaded);
+
       pMaterial->UpdateConstantBuffer(pShaderPermutation);
       BindConstantBuffer("ezMaterialConstants", pMaterial->m_hConstantBufferStorage);
     }
 
     UploadConstants();
 
-    if (bForce || m_StateFlags.IsSet(ezRenderContextFlags::ConstantBufferBindingChanged))
+    const ezBitflags<ezRenderContextFlags> bindingFlags = m_StateFlags & s_AllBindingFlags;
+    if (bindingFlags.IsAnyFlagSet())
     {
-      for (ezUInt32 stage = 0; stage < ezGALShaderStage::ENUM_COUNT; ++stage)
-      {
-        if (auto pBin = pShaderPermutation->GetShaderStageBinary((ezGALShaderStage::Enum)stage))
-        {
-          ApplyConstantBufferBindings(pBin);
-        }
-      }
+      if (pShaderPermutation == nullptr)
+        pShaderPermutation = ezResourceManager::BeginAcquireResource(m_hActiveShaderPermutation, ezResourceAcquireMode::BlockTillLoaded);
+
+      UpdateShaderBindings(pShaderPermutation);
+      ApplyBindings(bindingFlags);
 
-      m_StateFlags.Remove(ezRenderContextFlags::ConstantBufferBindingChanged);
+      m_StateFlags.Remove(s_AllBindingFlags);
+      m_ChangedBindings.Clear();
+      m_bAllBindingsChanged = false;
     }
   }
 
@@ -659,6 +680,16 @@ void ezRenderContext::ResetContextState()
 
   m_BoundUAVs.Clear();
   m_BoundConstantBuffers.Clear();
+
+  m_ChangedBindings.Clear();
+  m_bAllBindingsChanged = true;
+
+  m_ShaderBindings.Clear();
+  m_uiShaderBindingsResourceIDHash = 0;
+  m_uiShaderBindingsChangeCounter = ezInvalidIndex;
+
+  // The cache holds handles which would keep unused shaders alive, so it only lives for one frame.
+  m_PermutationCache.Clear();
 }
 
 ezGlobalConstants& ezRenderContext::WriteGlobalConstants()
@@ -939,6 +970,13 @@ void ezRenderContext::SetShaderPermutationVariableInternal(const ezHashedString&
 
   if (pOldValue == nullptr || *pOldValue != sValue)
   {
+    if (pOldValue != nullptr)
+    {
+      m_uiPermutationVariablesHash ^= HashPermutationVariable(sName.GetHash(), pOldValue->GetHash());
+    }
+
+    m_uiPermutationVariablesHash ^= HashPermutationVariable(sName.GetHash(), sValue.GetHash());
+
     m_PermutationVariables.Insert(sName, sValue);
     m_StateFlags.Add(ezRenderContextFlags::ShaderStateChanged);
   }
@@ -965,12 +1003,18 @@ ezShaderPermutationResource* ezRenderContext::ApplyShaderState()
   if (!m_hActiveShader.IsValid())
     return nullptr;
 
-  m_hActiveShaderPermutation =
-    ezShaderManager::PreloadSinglePermutation(m_hActiveShader, m_PermutationVariables, m_bAllowAsyncShaderLoading);
+  const ezShaderPermutationResourceHandle hPreviousShaderPermutation = m_hActiveShaderPermutation;
+  m_hActiveShaderPermutation = FindOrPreloadPermutation();
 
   if (!m_hActiveShaderPermutation.IsValid())
     return nullptr;
 
+  // If only permutation variables changed that the shader doesn't use, we end up with the same permutation and all slots stay the same.
+  if (m_hActiveShaderPermutation != hPreviousShaderPermutation)
+  {
+    m_bAllBindingsChanged = true;
+  }
+
   ezShaderPermutationResource* pShaderPermutation = ezResourceManager::BeginAcquireResource(
     m_hActiveShaderPermutation, m_bAllowAsyncShaderLoading ? ezResourceAcquireMode::AllowLoadingFallback : ezResourceAcquireMode::BlockTillLoaded);
 
@@ -1040,10 +1084,9 @@ ezMaterialResource* ezRenderContext::ApplyMaterialState()
 
   // The material needs its constant buffer updated.
   // Thus we keep it acquired until we have the correct shader permutation for the constant buffer layout.
+  // The binding itself doesn't change, the new content is uploaded in UploadConstants.
   if (pMaterial->AreConstantsModified())
   {
-    m_StateFlags.Add(ezRenderContextFlags::ConstantBufferBindingChanged);
-
     return pMaterial;
   }
 
@@ -1051,120 +1094,232 @@ ezMaterialResource* ezRenderContext::ApplyMaterialState()
   return nullptr;
 }
 
-void ezRenderContext::ApplyConstantBufferBindings(const ezShaderStageBinary* pBinary)
+ezShaderPermutationResourceHandle ezRenderContext::FindOrPreloadPermutation()
 {
-  for (const auto& binding : pBinary->m_ShaderResourceBindings)
+  const ezUInt32 uiShaderHash = m_hActiveShader.GetResourceIDHash();
+  const ezUInt64 uiKey = ezHashingUtils::xxHash64(&uiShaderHash, sizeof(uiShaderHash), m_uiPermutationVariablesHash);
+
+  ezUInt32 uiShaderChangeCounter = 0;
+  bool bShaderLoaded = false;
   {
-    if (binding.m_Type != ezShaderResourceBinding::ConstantBuffer)
-      continue;
+    ezResourceLock<ezShaderResource> pShader(m_hActiveShader, ezResourceAcquireMode::PointerOnly);
+    uiShaderChangeCounter = pShader->GetCurrentResourceChangeCounter();
+    bShaderLoaded = pShader->GetLoadingState() == ezResourceState::Loaded;
+  }
 
-    const ezUInt32 uiResourceHash = binding.m_sName.GetHash();
+  // Only fully loaded shaders are cached, otherwise the permutation might still change once the shader is loaded.
+  if (!bShaderLoaded)
+  {
+    return ezShaderManager::PreloadSinglePermutation(m_hActiveShader, m_PermutationVariables, m_bAllowAsyncShaderLoading);
+  }
 
-    BoundConstantBuffer boundConstantBuffer;
-    if (!m_BoundConstantBuffers.TryGetValue(uiResourceHash, boundConstantBuffer))
-    {
-      ezLog::Error("No resource is bound for constant buffer slot '{0}'", binding.m_sName);
-      m_pGALContext->SetConstantBuffer(binding.m_iSlot, ezGALBufferHandle());
+  CachedPermutation* pCachedPermutation = nullptr;
+  if (m_PermutationCache.TryGetValue(uiKey, pCachedPermutation) && pCachedPermutation->m_hShader == m_hActiveShader &&
+      pCachedPermutation->m_uiShaderChangeCounter == uiShaderChangeCounter)
+  {
+    m_Statistics.m_uiCachedPermutationLookups++;
+    return pCachedPermutation->m_hShaderPermutation;
+  }
+
+  ezShaderPermutationResourceHandle hShaderPermutation =
+    ezShaderManager::PreloadSinglePermutation(m_hActiveShader, m_PermutationVariables, m_bAllowAsyncShaderLoading);
+
+  if (hShaderPermutation.IsValid())
+  {
+    CachedPermutation& cachedPermutation = m_PermutationCache[uiKey];
+    cachedPermutation.m_hShader = m_hActiveShader;
+    cachedPermutation.m_uiShaderChangeCounter = uiShaderChangeCounter;
+    cachedPermutation.m_hShaderPermutation = hShaderPermutation;
+  }
+
+  return hShaderPermutation;
+}
+
+void ezRenderContext::OnBindingChanged(ezUInt32 uiNameHash, ezRenderContextFlags::Enum flag)
+{
+  m_StateFlags.Add(flag);
+
+  if (m_bAllBindingsChanged || m_ChangedBindings.Contains(uiNameHash))
+    return;
+
+  // Searching the list gets more expensive than just applying everything at some point.
+  if (m_ChangedBindings.GetCount() == m_ChangedBindings.GetCapacity())
+  {
+    m_ChangedBindings.Clear();
+    m_bAllBindingsChanged = true;
+    return;
+  }
+
+  m_ChangedBindings.PushBack(uiNameHash);
+}
+
+void ezRenderContext::UpdateShaderBindings(const ezShaderPermutationResource* pShaderPermutation)
+{
+  // The acquired resource might be a loading fallback or might have been reloaded, so identify it by its ID and change counter.
+  if (m_uiShaderBindingsResourceIDHash == pShaderPermutation->GetResourceIDHash() &&
+      m_uiShaderBindingsChangeCounter == pShaderPermutation->GetCurrentResourceChangeCounter())
+  {
+    return;
+  }
+
+  m_uiShaderBindingsResourceIDHash = pShaderPermutation->GetResourceIDHash();
+  m_uiShaderBindingsChangeCounter = pShaderPermutation->GetCurrentResourceChangeCounter();
+  m_bAllBindingsChanged = true;
+
+  m_ShaderBindings.Clear();
+
+  for (ezUInt32 stage = 0; stage < ezGALShaderStage::ENUM_COUNT; ++stage)
+  {
+    const ezShaderStageBinary* pBinary = pShaderPermutation->GetShaderStageBinary((ezGALShaderStage::Enum)stage);
+    if (pBinary == nullptr)
       continue;
-    }
 
-    if (!boundConstantBuffer.m_hConstantBuffer.IsInvalidated())
-    {
-      m_pGALContext->SetConstantBuffer(binding.m_iSlot, boundConstantBuffer.m_hConstantBuffer);
-    }
-    else
+    for (const auto& binding : pBinary->m_ShaderResourceBindings)
     {
-      ezConstantBufferStorageBase* pConstantBufferStorage = nullptr;
-      if (TryGetConstantBufferStorage(boundConstantBuffer.m_hConstantBufferStorage, pConstantBufferStorage))
+      BindingType::Enum type;
+
+      // we currently only support 2D, 3D and cube textures
+      if (binding.m_Type >= ezShaderResourceBinding::Texture2D && binding.m_Type <= ezShaderResourceBinding::Texture2DMSArray)
+      {
+        type = BindingType::Texture2D;
+      }
+      else if (binding.m_Type == ezShaderResourceBinding::Texture3D)
+      {
+        type = BindingType::Texture3D;
+      }
+      else if (binding.m_Type >= ezShaderResourceBinding::TextureCube && binding.m_Type <= ezShaderResourceBinding::TextureCubeArray)
+      {
+        type = BindingType::TextureCube;
+      }
+      else if (binding.m_Type >= ezShaderResourceBinding::RWTexture1D && binding.m_Type <= ezShaderResourceBinding::RWStructuredBufferWithCounter)
+      {
+        // RWTextures/UAV are usually only suppoprted in compute and pixel shader.
+        if (stage != ezGALShaderStage::ComputeShader && stage != ezGALShaderStage::PixelShader)
+          continue;
+
+        type = BindingType::UAV;
+      }
+      else if (binding.m_Type == ezShaderResourceBinding::Sampler)
+      {
+        type = BindingType::Sampler;
+      }
+      else if (binding.m_Type == ezShaderResourceBinding::GenericBuffer)
       {
-        m_pGALContext->SetConstantBuffer(binding.m_iSlot, pConstantBufferStorage->GetGALBufferHandle());
+        type = BindingType::Buffer;
+      }
+      else if (binding.m_Type == ezShaderResourceBinding::ConstantBuffer)
+      {
+        type = BindingType::ConstantBuffer;
       }
       else
       {
-        ezLog::Error("Invalid constant buffer storage is bound for slot '{0}'", binding.m_sName);
-        m_pGALContext->SetConstantBuffer(binding.m_iSlot, ezGALBufferHandle());
+        continue;
       }
+
+      auto& shaderBinding = m_ShaderBindings.ExpandAndGetRef();
+      shaderBinding.m_sName = binding.m_sName;
+      shaderBinding.m_uiNameHash = binding.m_sName.GetHash();
+      shaderBinding.m_iSlot = static_cast<ezInt16>(binding.m_iSlot);
+      shaderBinding.m_uiStage = static_cast<ezUInt8>(stage);
+      shaderBinding.m_Type = type;
     }
   }
 }
 
-void ezRenderContext::ApplyTextureBindings(ezGALShaderStage::Enum stage, const ezShaderStageBinary* pBinary)
+void ezRenderContext::ApplyBindings(ezBitflags<ezRenderContextFlags> flags)
 {
-  for (const auto& binding : pBinary->m_ShaderResourceBindings)
+  for (const ShaderBinding& binding : m_ShaderBindings)
   {
-    // we currently only support 2D and cube textures
-
-    const ezUInt32 uiResourceHash = binding.m_sName.GetHash();
-    ezGALResourceViewHandle hResourceView;
+    if (!flags.IsSet(s_BindingTypeToFlag[binding.m_Type]))
+      continue;
 
-    if (binding.m_Type >= ezShaderResourceBinding::Texture2D && binding.m_Type <= ezShaderResourceBinding::Texture2DMSArray)
+    if (!m_bAllBindingsChanged && !m_ChangedBindings.Contains(binding.m_uiNameHash))
     {
-      m_BoundTextures2D.TryGetValue(uiResourceHash, hResourceView);
-      m_pGALContext->SetResourceView(stage, binding.m_iSlot, hResourceView);
+      m_Statistics.m_uiSkippedBindings++;
+      continue;
     }
 
-    if (binding.m_Type == ezShaderResourceBinding::Texture3D)
-    {
-      m_BoundTextures3D.TryGetValue(uiResourceHash, hResourceView);
-      m_pGALContext->SetResourceView(stage, binding.m_iSlot, hResourceView);
-    }
+    m_Statistics.m_uiAppliedBindings++;
 
-    if (binding.m_Type >= ezShaderResourceBinding::TextureCube && binding.m_Type <= ezShaderResourceBinding::TextureCubeArray)
-    {
-      m_BoundTexturesCube.TryGetValue(uiResourceHash, hResourceView);
-      m_pGALContext->SetResourceView(stage, binding.m_iSlot, hResourceView);
-    }
-  }
-}
+    const ezGALShaderStage::Enum stage = (ezGALShaderStage::Enum)binding.m_uiStage;
 
-void ezRenderContext::ApplyUAVBindings(const ezShaderStageBinary* pBinary)
-{
-  for (const auto& binding : pBinary->m_ShaderResourceBindings)
-  {
-    if (binding.m_Type < ezShaderResourceBinding::RWTexture1D || binding.m_Type > ezShaderResourceBinding::RWStructuredBufferWithCounter)
-      continue;
+    switch (binding.m_Type)
+    {
+      case BindingType::Texture2D:
+      case BindingType::Texture3D:
+      case BindingType::TextureCube:
+      {
+        const ezHashTable<ezUInt32, ezGALResourceViewHandle>& boundTextures = binding.m_Type == BindingType::Texture2D
+                                                                                ? m_BoundTextures2D
+                                                                                : (binding.m_Type == BindingType::Texture3D ? m_BoundTextures3D : m_BoundTexturesCube);
 
-    const ezUInt32 uiResourceHash = binding.m_sName.GetHash();
+        ezGALResourceViewHandle hResourceView;
+        boundTextures.TryGetValue(binding.m_uiNameHash, hResourceView);
+        m_pGALContext->SetResourceView(stage, binding.m_iSlot, hResourceView);
+      }
+      break;
 
-    ezGALUnorderedAccessViewHandle hResourceView;
-    m_BoundUAVs.TryGetValue(uiResourceHash, hResourceView);
+      case BindingType::UAV:
+      {
+        ezGALUnorderedAccessViewHandle hResourceView;
+        m_BoundUAVs.TryGetValue(binding.m_uiNameHash, hResourceView);
+        m_pGALContext->SetUnorderedAccessView(binding.m_iSlot, hResourceView);
+      }
+      break;
 
-    m_pGALContext->SetUnorderedAccessView(binding.m_iSlot, hResourceView);
-  }
-}
+      case BindingType::Sampler:
+      {
+        ezGALSamplerStateHandle hSamplerState;
+        if (!m_BoundSamplers.TryGetValue(binding.m_uiNameHash, hSamplerState))
+        {
+          hSamplerState = GetDefaultSamplerState(ezDefaultSamplerFlags::LinearFiltering); // Bind a default state to avoid DX11 errors.
+        }
 
-void ezRenderContext::ApplySamplerBindings(ezGALShaderStage::Enum stage, const ezShaderStageBinary* pBinary)
-{
-  for (const auto& binding : pBinary->m_ShaderResourceBindings)
-  {
-    if (binding.m_Type != ezShaderResourceBinding::Sampler)
-      continue;
+        m_pGALContext->SetSamplerState(stage, binding.m_iSlot, hSamplerState);
+      }
+      break;
 
-    const ezUInt32 uiResourceHash = binding.m_sName.GetHash();
+      case BindingType::Buffer:
+      {
+        ezGALResourceViewHandle hResourceView;
+        m_BoundBuffer.TryGetValue(binding.m_uiNameHash, hResourceView);
+        m_pGALContext->SetResourceView(stage, binding.m_iSlot, hResourceView);
+      }
+      break;
 
-    ezGALSamplerStateHandle hSamplerState;
-    if (!m_BoundSamplers.TryGetValue(uiResourceHash, hSamplerState))
-    {
-      hSamplerState = GetDefaultSamplerState(ezDefaultSamplerFlags::LinearFiltering); // Bind a default state to avoid DX11 errors.
+      case BindingType::ConstantBuffer:
+        ApplyConstantBufferBinding(binding);
+        break;
     }
-
-    m_pGALContext->SetSamplerState(stage, binding.m_iSlot, hSamplerState);
   }
 }
 
-void ezRenderContext::ApplyBufferBindings(ezGALShaderStage::Enum stage, const ezShaderStageBinary* pBinary)
+void ezRenderContext::ApplyConstantBufferBinding(const ShaderBinding& binding)
 {
-  for (const auto& binding : pBinary->m_ShaderResourceBindings)
+  BoundConstantBuffer boundConstantBuffer;
+  if (!m_BoundConstantBuffers.TryGetValue(binding.m_uiNameHash, boundConstantBuffer))
   {
-    if (binding.m_Type != ezShaderResourceBinding::GenericBuffer)
-      continue;
-
-    const ezUInt32 uiResourceHash = binding.m_sName.GetHash();
-
-    ezGALResourceViewHandle hResourceView;
-    m_BoundBuffer.TryGetValue(uiResourceHash, hResourceView);
+    ezLog::Error("No resource is bound for constant buffer slot '{0}'", binding.m_sName);
+    m_pGALContext->SetConstantBuffer(binding.m_iSlot, ezGALBufferHandle());
+    return;
+  }
 
-    m_pGALContext->SetResourceView(stage, binding.m_iSlot, hResourceView);
+  if (!boundConstantBuffer.m_hConstantBuffer.IsInvalidated())
+  {
+    m_pGALContext->SetConstantBuffer(binding.m_iSlot, boundConstantBuffer.m_hConstantBuffer);
+  }
+  else
+  {
+    ezConstantBufferStorageBase* pConstantBufferStorage = nullptr;
+    if (TryGetConstantBufferStorage(boundConstantBuffer.m_hConstantBufferStorage, pConstantBufferStorage))
+    {
+      m_pGALContext->SetConstantBuffer(binding.m_iSlot, pConstantBufferStorage->GetGALBufferHandle());
+    }
+    else
+    {
+      ezLog::Error("Invalid constant buffer storage is bound for slot '{0}'", binding.m_sName);
+      m_pGALContext->SetConstantBuffer(binding.m_iSlot, ezGALBufferHandle());
+    }
   }
 }
 
@@ -48,6 +48,10 @@ public:
     void Reset();
 
     ezUInt32 m_uiFailedDrawcalls;
+    ezUInt32 m_uiRedundantBindings;         ///< Bind calls that were ignored because the same value was bound already.
+    ezUInt32 m_uiAppliedBindings;           ///< Shader resource bindings that were passed on to the GAL context.
+    ezUInt32 m_uiSkippedBindings;           ///< Shader resource bindings that were not re-applied because neither the shader nor the bound value changed.
+    ezUInt32 m_uiCachedPermutationLookups;  ///< Shader permutations that were taken from the per context cache instead of asking the ezShaderManager.
   };
 
   Statistics GetAndResetStatistics();
@@ -189,6 +193,27 @@ private:
   ezGALShaderHandle m_hActiveGALShader;
 
   ezHashTable<ezHashedString, ezHashedString> m_PermutationVariables;
+  ezUInt64 m_uiPermutationVariablesHash; ///< Order independent hash of m_PermutationVariables, updated whenever a variable changes.
+
+  struct PermutationVariable
+  {
+    ezHashedString m_sName;
+    ezHashedString m_sValue;
+  };
+
+  /// Name and value hash -> validated name and value. Avoids querying the shader manager and creating hashed strings every time.
+  ezHashTable<ezUInt64, PermutationVariable> m_PermutationVariableCache;
+
+  struct CachedPermutation
+  {
+    ezShaderResourceHandle m_hShader;
+    ezUInt32 m_uiShaderChangeCounter;
+    ezShaderPermutationResourceHandle m_hShaderPermutation;
+  };
+
+  /// Shader and permutation variables hash -> shader permutation.
+  ezHashTable<ezUInt64, CachedPermutation> m_PermutationCache;
+
   ezMaterialResourceHandle m_hNewMaterial;
   ezMaterialResourceHandle m_hMaterial;
 
@@ -227,6 +252,40 @@ private:
 
   ezHashTable<ezUInt32, BoundConstantBuffer> m_BoundConstantBuffers;
 
+  struct BindingType
+  {
+    enum Enum : ezUInt8
+    {
+      Texture2D,
+      Texture3D,
+      TextureCube,
+      UAV,
+      Sampler,
+      Buffer,
+      ConstantBuffer
+    };
+  };
+
+  /// \brief A shader resource binding of the active shader permutation, flattened over all stages.
+  struct ShaderBinding
+  {
+    ezHashedString m_sName;
+    ezUInt32 m_uiNameHash;
+    ezInt16 m_iSlot;
+    ezUInt8 m_uiStage;
+    BindingType::Enum m_Type;
+  };
+
+  ezDynamicArray<ShaderBinding> m_ShaderBindings;
+  ezUInt32 m_uiShaderBindingsResourceIDHash;
+  ezUInt32 m_uiShaderBindingsChangeCounter;
+
+  /// Name hashes of all slots whose bound value changed since the bindings were last applied.
+  /// If all slots have to be applied, e.g. because the shader changed, m_bAllBindingsChanged is set instead.
+  ezHybridArray<ezUInt32, 16> m_ChangedBindings;
+  bool m_bAllBindingsChanged;
+  ezUInt32 m_uiLastImplicitUnbindCounter;
+
   ezConstantBufferStorageHandle m_hGlobalConstantBufferStorage;
 
   struct ShaderVertexDecl
@@ -269,10 +328,10 @@ private: // Per Renderer States
   void BindShaderInternal(const ezShaderResourceHandle& hShader, ezBitflags<ezShaderBindFlags> flags);
   ezShaderPermutationResource* ApplyShaderState();
   ezMaterialResource* ApplyMaterialState();
-  void ApplyConstantBufferBindings(const ezShaderStageBinary* pBinary);
-  void ApplyTextureBindings(ezGALShaderStage::Enum stage, const ezShaderStageBinary* pBinary);
-  void ApplyUAVBindings(const ezShaderStageBinary* pBinary);
-  void ApplySamplerBindings(ezGALShaderStage::Enum stage, const ezShaderStageBinary* pBinary);
-  void ApplyBufferBindings(ezGALShaderStage::Enum stage, const ezShaderStageBinary* pBinary);
+  ezShaderPermutationResourceHandle FindOrPreloadPermutation();
+  void OnBindingChanged(ezUInt32 uiNameHash, ezRenderContextFlags::Enum flag);
+  void UpdateShaderBindings(const ezShaderPermutationResource* pShaderPermutation);
+  void ApplyBindings(ezBitflags<ezRenderContextFlags> flags);
+  void ApplyConstantBufferBinding(const ShaderBinding& binding);
 };
 
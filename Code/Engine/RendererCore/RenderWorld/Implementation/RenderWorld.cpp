@@ -2,6 +2,7 @@
 
 #include <Foundation/Configuration/CVar.h>
 #include <Foundation/Configuration/Startup.h>
+#include <Foundation/Math/Frustum.h>
 #include <Foundation/Memory/CommonAllocators.h>
 #include <RendererCore/Pipeline/RenderPipeline.h>
 #include <RendererCore/Pipeline/View.h>
@@ -382,6 +383,51 @@ void ezRenderWorld::AddViewToRender(const ezViewHandle& hView)
   }
 }
 
+void ezRenderWorld::AddViewsToRender(ezArrayPtr<const ezViewHandle> views)
+{
+  ezHybridArray<ezFrustum, 8> frustums;
+  ezHybridArray<ezRenderPipeline*, 8> pipelines;
+  const ezWorld* pWorld = nullptr;
+
+  {
+    EZ_LOCK(s_ViewsToRenderMutex);
+    EZ_ASSERT_DEV(s_bInExtract, "Render views need to be collected during extraction");
+
+    for (const ezViewHandle& hView : views)
+    {
+      ezView* pView = nullptr;
+      if (!TryGetView(hView, pView) || !pView->IsValid())
+        continue;
+
+      // views that are already being extracted must not be touched anymore
+      if (s_ViewsToRender.Contains(pView))
+        continue;
+
+      if (pWorld == nullptr)
+      {
+        pWorld = pView->GetWorld();
+      }
+      else if (pWorld != pView->GetWorld())
+      {
+        continue;
+      }
+
+      pView->ComputeCullingFrustum(frustums.ExpandAndGetRef());
+      pipelines.PushBack(pView->m_pRenderPipeline.Borrow());
+    }
+  }
+
+  if (pipelines.GetCount() > 1)
+  {
+    ezRenderPipeline::FindVisibleObjectsBatched(pWorld, frustums, pipelines);
+  }
+
+  for (const ezViewHandle& hView : views)
+  {
+    AddViewToRender(hView);
+  }
+}
+
 void ezRenderWorld::ExtractMainViews()
 {
   EZ_ASSERT_DEV(!s_bInExtract, "ExtractMainViews must not be called from multiple threads.");
@@ -61,6 +61,12 @@ public:
 
   static void AddViewToRender(const ezViewHandle& hView);
 
+  /// \brief Adds several views that look into the same world at once, e.g. all shadow views of a light.
+  ///
+  /// The visible objects of all views that are not yet extracted in this frame are determined with a single batched query on the spatial
+  /// system, instead of one query per view.
+  static void AddViewsToRender(ezArrayPtr<const ezViewHandle> views);
+
   static void ExtractMainViews();
 
   static void Render(ezRenderContext* pRenderContext);
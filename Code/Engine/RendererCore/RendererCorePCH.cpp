@@ -90,6 +90,7 @@ EZ_STATICLINK_LIBRARY(RendererCore)
   EZ_STATICLINK_REFERENCE(RendererCore_RenderWorld_Implementation_RenderWorld);
   EZ_STATICLINK_REFERENCE(RendererCore_ShaderCompiler_Implementation_PermutationGenerator);
   EZ_STATICLINK_REFERENCE(RendererCore_ShaderCompiler_Implementation_ShaderCompiler);
+  EZ_STATICLINK_REFERENCE(RendererCore_ShaderCompiler_Implementation_ShaderCompilerNull);
   EZ_STATICLINK_REFERENCE(RendererCore_ShaderCompiler_Implementation_ShaderManager);
   EZ_STATICLINK_REFERENCE(RendererCore_ShaderCompiler_Implementation_ShaderParser);
   EZ_STATICLINK_REFERENCE(RendererCore_Shader_Implementation_ConstantBufferStorage);
@@ -0,0 +1,496 @@
+#include <RendererCorePCH.h>
+
+#include <Foundation/CodeUtils/TokenParseUtils.h>
+#include <Foundation/CodeUtils/Tokenizer.h>
+#include <Foundation/Utilities/ConversionUtils.h>
+#include <RendererCore/ShaderCompiler/ShaderCompilerNull.h>
+
+EZ_BEGIN_DYNAMIC_REFLECTED_TYPE(ezShaderCompilerNull, 1, ezRTTIDefaultAllocator<ezShaderCompilerNull>)
+EZ_END_DYNAMIC_REFLECTED_TYPE;
+
+using namespace ezTokenParseUtils;
+
+namespace
+{
+  struct NamedResourceType
+  {
+    const char* m_szName;
+    ezShaderResourceBinding::ResourceType m_Type;
+  };
+
+  static const NamedResourceType s_ResourceTypes[] = {
+    {"Texture1D", ezShaderResourceBinding::Texture1D},
+    {"Texture1DArray", ezShaderResourceBinding::Texture1DArray},
+    {"Texture2D", ezShaderResourceBinding::Texture2D},
+    {"Texture2DArray", ezShaderResourceBinding::Texture2DArray},
+    {"Texture2DMS", ezShaderResourceBinding::Texture2DMS},
+    {"Texture2DMSArray", ezShaderResourceBinding::Texture2DMSArray},
+    {"Texture3D", ezShaderResourceBinding::Texture3D},
+    {"TextureCube", ezShaderResourceBinding::TextureCube},
+    {"TextureCubeArray", ezShaderResourceBinding::TextureCubeArray},
+    {"Buffer", ezShaderResourceBinding::GenericBuffer},
+    {"StructuredBuffer", ezShaderResourceBinding::GenericBuffer},
+    {"ByteAddressBuffer", ezShaderResourceBinding::GenericBuffer},
+    {"RWTexture1D", ezShaderResourceBinding::RWTexture1D},
+    {"RWTexture1DArray", ezShaderResourceBinding::RWTexture1DArray},
+    {"RWTexture2D", ezShaderResourceBinding::RWTexture2D},
+    {"RWTexture2DArray", ezShaderResourceBinding::RWTexture2DArray},
+    {"RWBuffer", ezShaderResourceBinding::RWBuffer},
+    {"RWStructuredBuffer", ezShaderResourceBinding::RWStructuredBuffer},
+    {"RWByteAddressBuffer", ezShaderResourceBinding::RWRawBuffer},
+    {"AppendStructuredBuffer", ezShaderResourceBinding::RWAppendBuffer},
+    {"ConsumeStructuredBuffer", ezShaderResourceBinding::RWConsumeBuffer},
+    {"SamplerState", ezShaderResourceBinding::Sampler},
+    {"SamplerComparisonState", ezShaderResourceBinding::Sampler},
+  };
+
+  struct NamedConstantType
+  {
+    const char* m_szName;
+    ezShaderConstantBufferLayout::Constant::Type::Enum m_Type;
+    ezUInt32 m_uiSize;
+    bool m_bStartsNewRegister;
+  };
+
+  // matrices are column major, every column starts a new register and the last one is not padded
+  static const NamedConstantType s_ConstantTypes[] = {
+    {"float", ezShaderConstantBufferLayout::Constant::Type::Float1, 4, false},
+    {"float1", ezShaderConstantBufferLayout::Constant::Type::Float1, 4, false},
+    {"float2", ezShaderConstantBufferLayout::Constant::Type::Float2, 8, false},
+    {"float3", ezShaderConstantBufferLayout::Constant::Type::Float3, 12, false},
+    {"float4", ezShaderConstantBufferLayout::Constant::Type::Float4, 16, false},
+    {"int", ezShaderConstantBufferLayout::Constant::Type::Int1, 4, false},
+    {"int1", ezShaderConstantBufferLayout::Constant::Type::Int1, 4, false},
+    {"int2", ezShaderConstantBufferLayout::Constant::Type::Int2, 8, false},
+    {"int3", ezShaderConstantBufferLayout::Constant::Type::Int3, 12, false},
+    {"int4", ezShaderConstantBufferLayout::Constant::Type::Int4, 16, false},
+    {"uint", ezShaderConstantBufferLayout::Constant::Type::UInt1, 4, false},
+    {"uint1", ezShaderConstantBufferLayout::Constant::Type::UInt1, 4, false},
+    {"uint2", ezShaderConstantBufferLayout::Constant::Type::UInt2, 8, false},
+    {"uint3", ezShaderConstantBufferLayout::Constant::Type::UInt3, 12, false},
+    {"uint4", ezShaderConstantBufferLayout::Constant::Type::UInt4, 16, false},
+    {"bool", ezShaderConstantBufferLayout::Constant::Type::Bool, 4, false},
+    {"float3x3", ezShaderConstantBufferLayout::Constant::Type::Mat3x3, 16 * 2 + 12, true},
+    {"float4x4", ezShaderConstantBufferLayout::Constant::Type::Mat4x4, 16 * 4, true},
+  };
+
+  static const char* s_MemberModifiers[] = {"column_major", "row_major", "precise", "nointerpolation", "linear", "centroid", "noperspective", "sample"};
+
+  enum RegisterClass
+  {
+    ConstantBufferRegister,
+    ShaderResourceRegister,
+    SamplerRegister,
+    UnorderedAccessRegister,
+  };
+
+  static const char s_RegisterPrefix[] = {'b', 't', 's', 'u'};
+
+  RegisterClass GetRegisterClass(ezShaderResourceBinding::ResourceType type)
+  {
+    if (type == ezShaderResourceBinding::ConstantBuffer)
+      return ConstantBufferRegister;
+
+    if (type == ezShaderResourceBinding::Sampler)
+      return SamplerRegister;
+
+    if (type >= ezShaderResourceBinding::RWTexture1D && type <= ezShaderResourceBinding::RWStructuredBufferWithCounter)
+      return UnorderedAccessRegister;
+
+    return ShaderResourceRegister;
+  }
+
+  const NamedConstantType* FindConstantType(const ezStringView& sType)
+  {
+    for (const NamedConstantType& type : s_ConstantTypes)
+    {
+      if (sType == type.m_szName)
+        return &type;
+    }
+
+    return nullptr;
+  }
+
+  const NamedResourceType* FindResourceType(const ezStringView& sType)
+  {
+    for (const NamedResourceType& type : s_ResourceTypes)
+    {
+      if (sType == type.m_szName)
+        return &type;
+    }
+
+    return nullptr;
+  }
+
+  /// \brief Skips everything up to and including the brace that closes the block in which uiCurToken is located.
+  void SkipBlock(const TokenStream& Tokens, ezUInt32& uiCurToken)
+  {
+    ezInt32 iDepth = 1;
+
+    while (uiCurToken < Tokens.GetCount() && iDepth > 0)
+    {
+      if (Tokens[uiCurToken]->m_DataView == "{")
+        ++iDepth;
+      else if (Tokens[uiCurToken]->m_DataView == "}")
+        --iDepth;
+
+      ++uiCurToken;
+    }
+  }
+
+  /// \brief Skips everything up to and including the next semicolon.
+  ezResult SkipStatement(const TokenStream& Tokens, ezUInt32& uiCurToken)
+  {
+    while (!Accept(Tokens, uiCurToken, ";"))
+    {
+      if (uiCurToken >= Tokens.GetCount())
+        return EZ_FAILURE;
+
+      ++uiCurToken;
+    }
+
+    return EZ_SUCCESS;
+  }
+
+  ezResult ParseArraySize(const TokenStream& Tokens, ezUInt32& uiCurToken, ezUInt32& out_uiArraySize)
+  {
+    out_uiArraySize = 0;
+
+    if (!Accept(Tokens, uiCurToken, "["))
+      return EZ_SUCCESS;
+
+    ezUInt32 uiSizeToken = 0;
+    if (!Accept(Tokens, uiCurToken, ezTokenType::Integer, &uiSizeToken) || !Accept(Tokens, uiCurToken, "]"))
+      return EZ_FAILURE;
+
+    ezString sSize = Tokens[uiSizeToken]->m_DataView;
+    return ezConversionUtils::StringToUInt(sSize, out_uiArraySize);
+  }
+
+  /// \brief Parses an optional ': register(xN)' and returns the slot, or -1 if no register was given.
+  ezResult ParseRegister(const TokenStream& Tokens, ezUInt32& uiCurToken, RegisterClass registerClass, ezInt32& out_iSlot)
+  {
+    out_iSlot = -1;
+
+    if (!Accept(Tokens, uiCurToken, ":"))
+      return EZ_SUCCESS;
+
+    ezUInt32 uiRegisterToken = 0;
+    if (!Accept(Tokens, uiCurToken, "register") || !Accept(Tokens, uiCurToken, "(") ||
+        !Accept(Tokens, uiCurToken, ezTokenType::Identifier, &uiRegisterToken))
+      return EZ_FAILURE;
+
+    ezStringBuilder sRegister = Tokens[uiRegisterToken]->m_DataView;
+    if (ezStringUtils::ToLowerChar(sRegister.GetData()[0]) != (ezUInt32)s_RegisterPrefix[registerClass])
+      return EZ_FAILURE;
+
+    sRegister.Shrink(1, 0);
+    if (ezConversionUtils::StringToInt(sRegister, out_iSlot).Failed())
+      return EZ_FAILURE;
+
+    // register spaces are ignored
+    while (!Accept(Tokens, uiCurToken, ")"))
+    {
+      if (uiCurToken >= Tokens.GetCount())
+        return EZ_FAILURE;
+
+      ++uiCurToken;
+    }
+
+    return EZ_SUCCESS;
+  }
+
+  /// \brief Parses the members of a struct or cbuffer, up to and including the closing brace, and computes their packed offsets.
+  ///
+  /// Structs are only used for their size, their members are not reflected, same as with the D3D reflection.
+  ezResult ParseMembers(const TokenStream& Tokens, ezUInt32& uiCurToken, const ezHashTable<ezStringView, ezUInt32>& StructSizes,
+    bool bLogErrors, ezHybridArray<ezShaderConstantBufferLayout::Constant, 16>& out_Constants, ezUInt32& out_uiSize)
+  {
+    ezUInt32 uiOffset = 0;
+
+    while (!Accept(Tokens, uiCurToken, "}"))
+    {
+      for (const char* szModifier : s_MemberModifiers)
+      {
+        Accept(Tokens, uiCurToken, szModifier);
+      }
+
+      ezUInt32 uiTypeToken = 0;
+      ezUInt32 uiNameToken = 0;
+      if (!Accept(Tokens, uiCurToken, ezTokenType::Identifier, &uiTypeToken) || !Accept(Tokens, uiCurToken, ezTokenType::Identifier, &uiNameToken))
+      {
+        if (bLogErrors)
+          ezLog::Error("Invalid member declaration in line {0}", uiCurToken < Tokens.GetCount() ? Tokens[uiCurToken]->m_uiLine : 0);
+
+        return EZ_FAILURE;
+      }
+
+      const ezStringView sType = Tokens[uiTypeToken]->m_DataView;
+      const ezStringView sName = Tokens[uiNameToken]->m_DataView;
+
+      ezUInt32 uiArraySize = 0;
+      if (ParseArraySize(Tokens, uiCurToken, uiArraySize).Failed() || SkipStatement(Tokens, uiCurToken).Failed())
+      {
+        if (bLogErrors)
+          ezLog::Error("Variable '{0}': Invalid declaration", sName);
+
+        return EZ_FAILURE;
+      }
+
+      ezStringBuilder sNameString = sName;
+
+      ezShaderConstantBufferLayout::Constant constant;
+      constant.m_sName.Assign(sNameString.GetData());
+      constant.m_uiArrayElements = static_cast<ezUInt8>(ezMath::Max(uiArraySize, 1u));
+
+      ezUInt32 uiSize = 0;
+      bool bStartsNewRegister = true;
+
+      if (const NamedConstantType* pType = FindConstantType(sType))
+      {
+        constant.m_Type = pType->m_Type;
+        uiSize = pType->m_uiSize;
+        bStartsNewRegister = pType->m_bStartsNewRegister;
+      }
+      else if (!StructSizes.TryGetValue(sType, uiSize))
+      {
+        if (bLogErrors)
+          ezLog::Error("Variable '{0}': Variable type '{1}' is unknown / not supported", sName, sType);
+
+        return EZ_FAILURE;
+      }
+
+      // a value must not straddle a 16 byte register, arrays, matrices and structs always start a new one
+      if (bStartsNewRegister || uiArraySize > 0 || (uiOffset % 16) + uiSize > 16)
+      {
+        uiOffset = ezMemoryUtils::AlignSize(uiOffset, 16u);
+      }
+
+      constant.m_uiOffset = static_cast<ezUInt16>(uiOffset);
+      uiOffset += ezMemoryUtils::AlignSize(uiSize, 16u) * (constant.m_uiArrayElements - 1) + uiSize;
+
+      if (constant.m_Type != ezShaderConstantBufferLayout::Constant::Type::Default)
+      {
+        out_Constants.PushBack(constant);
+      }
+    }
+
+    out_uiSize = ezMemoryUtils::AlignSize(uiOffset, 16u);
+    return EZ_SUCCESS;
+  }
+
+  struct Declaration
+  {
+    ezShaderResourceBinding m_Binding;
+    RegisterClass m_RegisterClass;
+  };
+
+  bool IsSlotUsed(const ezDynamicArray<Declaration>& Declarations, RegisterClass registerClass, ezInt32 iSlot)
+  {
+    for (const Declaration& decl : Declarations)
+    {
+      if (decl.m_RegisterClass == registerClass && decl.m_Binding.m_iSlot == iSlot)
+        return true;
+    }
+
+    return false;
+  }
+} // namespace
+
+ezResult ezShaderCompilerNull::ReflectShaderStage(ezShaderProgramData& inout_Data, ezGALShaderStage::Enum Stage)
+{
+  ezShaderStageBinary& stageBinary = inout_Data.m_StageBinary[Stage];
+  const char* szSource = inout_Data.m_szShaderSource[Stage];
+
+  ezTokenizer tokenizer;
+  tokenizer.Tokenize(ezArrayPtr<const ezUInt8>((const ezUInt8*)szSource, ezStringUtils::GetStringElementCount(szSource)), ezLog::GetThreadLocalLogSystem());
+
+  // drop whitespace, comments and the remaining preprocessor output like #line, which may appear in the middle of a declaration
+  TokenStream Tokens;
+  bool bLineStart = true;
+  bool bSkipLine = false;
+  for (const ezToken& token : tokenizer.GetTokens())
+  {
+    if (token.m_iType == ezTokenType::Newline)
+    {
+      bLineStart = true;
+      bSkipLine = false;
+      continue;
+    }
+
+    if (token.m_iType == ezTokenType::Whitespace || token.m_iType == ezTokenType::LineComment || token.m_iType == ezTokenType::BlockComment ||
+        token.m_iType == ezTokenType::EndOfFile)
+      continue;
+
+    if (bLineStart && token.m_DataView == "#")
+      bSkipLine = true;
+
+    bLineStart = false;
+
+    if (!bSkipLine)
+      Tokens.PushBack(&token);
+  }
+
+  ezHashTable<ezStringView, ezUInt32> structSizes;
+  ezDynamicArray<Declaration> declarations;
+
+  ezInt32 iParenthesisDepth = 0;
+  ezUInt32 uiCurToken = 0;
+
+  while (uiCurToken < Tokens.GetCount())
+  {
+    const ezToken* pToken = Tokens[uiCurToken];
+    ++uiCurToken;
+
+    // only global declarations are of interest, function bodies and parameter lists are skipped
+    if (pToken->m_DataView == "{")
+    {
+      SkipBlock(Tokens, uiCurToken);
+      continue;
+    }
+
+    if (pToken->m_DataView == "(")
+      ++iParenthesisDepth;
+    else if (pToken->m_DataView == ")" && iParenthesisDepth > 0)
+      --iParenthesisDepth;
+
+    if (iParenthesisDepth > 0 || pToken->m_iType != ezTokenType::Identifier)
+      continue;
+
+    if (pToken->m_DataView == "struct")
+    {
+      ezUInt32 uiNameToken = 0;
+      if (!Accept(Tokens, uiCurToken, ezTokenType::Identifier, &uiNameToken) || !Accept(Tokens, uiCurToken, "{"))
+        continue;
+
+      // structs that can't be parsed are only an error once they are used in a constant buffer
+      const ezUInt32 uiBodyToken = uiCurToken;
+
+      ezHybridArray<ezShaderConstantBufferLayout::Constant, 16> members;
+      ezUInt32 uiSize = 0;
+      if (ParseMembers(Tokens, uiCurToken, structSizes, false, members, uiSize).Succeeded())
+      {
+        structSizes.Insert(Tokens[uiNameToken]->m_DataView, uiSize);
+      }
+      else
+      {
+        uiCurToken = uiBodyToken;
+        SkipBlock(Tokens, uiCurToken);
+      }
+
+      continue;
+    }
+
+    if (pToken->m_DataView == "cbuffer")
+    {
+      Declaration& decl = declarations.ExpandAndGetRef();
+      decl.m_RegisterClass = ConstantBufferRegister;
+      decl.m_Binding.m_Type = ezShaderResourceBinding::ConstantBuffer;
+
+      ezUInt32 uiNameToken = 0;
+      if (!Accept(Tokens, uiCurToken, ezTokenType::Identifier, &uiNameToken) ||
+          ParseRegister(Tokens, uiCurToken, ConstantBufferRegister, decl.m_Binding.m_iSlot).Failed() || !Accept(Tokens, uiCurToken, "{"))
+      {
+        ezLog::Error("Invalid constant buffer declaration in line {0}", pToken->m_uiLine);
+        return EZ_FAILURE;
+      }
+
+      ezStringBuilder sName = Tokens[uiNameToken]->m_DataView;
+      decl.m_Binding.m_sName.Assign(sName.GetData());
+
+      EZ_LOG_BLOCK("Constant Buffer Layout", decl.m_Binding.m_sName.GetData());
+
+      ezShaderConstantBufferLayout* pLayout = stageBinary.CreateConstantBufferLayout();
+      decl.m_Binding.m_pLayout = pLayout;
+
+      if (ParseMembers(Tokens, uiCurToken, structSizes, true, pLayout->m_Constants, pLayout->m_uiTotalSize).Failed())
+        return EZ_FAILURE;
+
+      continue;
+    }
+
+    if (const NamedResourceType* pType = FindResourceType(pToken->m_DataView))
+    {
+      // template arguments, e.g. Texture2D<float4> or StructuredBuffer<Data>
+      if (Accept(Tokens, uiCurToken, "<"))
+      {
+        while (!Accept(Tokens, uiCurToken, ">") && uiCurToken < Tokens.GetCount())
+          ++uiCurToken;
+      }
+
+      Declaration decl;
+      decl.m_RegisterClass = GetRegisterClass(pType->m_Type);
+      decl.m_Binding.m_Type = pType->m_Type;
+
+      ezUInt32 uiNameToken = 0;
+      ezUInt32 uiArraySize = 0;
+      if (!Accept(Tokens, uiCurToken, ezTokenType::Identifier, &uiNameToken) || ParseArraySize(Tokens, uiCurToken, uiArraySize).Failed() ||
+          ParseRegister(Tokens, uiCurToken, decl.m_RegisterClass, decl.m_Binding.m_iSlot).Failed() || !Accept(Tokens, uiCurToken, ";"))
+        continue;
+
+      ezStringBuilder sName = Tokens[uiNameToken]->m_DataView;
+      if (decl.m_Binding.m_Type == ezShaderResourceBinding::Sampler && sName.EndsWith("_AutoSampler"))
+      {
+        sName.Shrink(0, ezStringUtils::GetStringElementCount("_AutoSampler"));
+      }
+
+      decl.m_Binding.m_sName.Assign(sName.GetData());
+      declarations.PushBack(decl);
+    }
+  }
+
+  // the compiler assigns the lowest free slot of the register class to all declarations without an explicit register
+  for (Declaration& decl : declarations)
+  {
+    if (decl.m_Binding.m_iSlot >= 0)
+      continue;
+
+    ezInt32 iSlot = 0;
+    while (IsSlotUsed(declarations, decl.m_RegisterClass, iSlot))
+      ++iSlot;
+
+    decl.m_Binding.m_iSlot = iSlot;
+  }
+
+  for (const Declaration& decl : declarations)
+  {
+    stageBinary.AddShaderResourceBinding(decl.m_Binding);
+  }
+
+  return EZ_SUCCESS;
+}
+
+ezResult ezShaderCompilerNull::Compile(ezShaderProgramData& inout_Data, ezLogInterface* pLog)
+{
+  for (ezUInt32 stage = 0; stage < ezGALShaderStage::ENUM_COUNT; ++stage)
+  {
+    // shader already compiled
+    if (!inout_Data.m_StageBinary[stage].GetByteCode().IsEmpty())
+    {
+      ezLog::Debug("Shader for stage '{0}' is already compiled.", ezGALShaderStage::Names[stage]);
+      continue;
+    }
+
+    const char* szShaderSource = inout_Data.m_szShaderSource[stage];
+    const ezUInt32 uiLength = ezStringUtils::GetStringElementCount(szShaderSource);
+
+    if (uiLength > 0 && ezStringUtils::FindSubString(szShaderSource, "main") != nullptr)
+    {
+      EZ_LOG_BLOCK("Shader Reflection", inout_Data.m_szSourceFile);
+
+      // the null device does not execute anything, the source is only stored to give each permutation distinct byte code
+      ezDynamicArray<ezUInt8>& byteCode = inout_Data.m_StageBinary[stage].GetByteCode();
+      byteCode.SetCountUninitialized(uiLength);
+      ezMemoryUtils::Copy(byteCode.GetData(), reinterpret_cast<const ezUInt8*>(szShaderSource), uiLength);
+
+      if (ReflectShaderStage(inout_Data, (ezGALShaderStage::Enum)stage).Failed())
+        return EZ_FAILURE;
+    }
+  }
+
+  return EZ_SUCCESS;
+}
+
+
+
+EZ_STATICLINK_FILE(RendererCore, RendererCore_ShaderCompiler_Implementation_ShaderCompilerNull);
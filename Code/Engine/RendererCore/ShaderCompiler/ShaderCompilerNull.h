@@ -0,0 +1,22 @@
+#pragma once
+
+#include <RendererCore/ShaderCompiler/ShaderCompiler.h>
+
+/// \brief Shader 'compiler' for the null renderer, selected through the platform name "NULL_HLSL".
+///
+/// The preprocessed HLSL source is stored as the byte code, no native compiler is needed. Resource bindings and constant buffer
+/// layouts are reflected from the global declarations in the source, using the HLSL packing rules. Slots that are not given
+/// explicitly are assigned in declaration order. Unlike the D3D reflection, all declared resources are reported, not only the ones
+/// that are used by the entry point.
+class EZ_RENDERERCORE_DLL ezShaderCompilerNull : public ezShaderProgramCompiler
+{
+  EZ_ADD_DYNAMIC_REFLECTION(ezShaderCompilerNull, ezShaderProgramCompiler);
+
+public:
+  virtual void GetSupportedPlatforms(ezHybridArray<ezString, 4>& Platforms) override { Platforms.PushBack("NULL_HLSL"); }
+
+  virtual ezResult Compile(ezShaderProgramData& inout_Data, ezLogInterface* pLog) override;
+
+private:
+  ezResult ReflectShaderStage(ezShaderProgramData& inout_Data, ezGALShaderStage::Enum Stage);
+};
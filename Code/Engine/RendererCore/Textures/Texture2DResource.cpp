@@ -144,12 +144,14 @@ ezResourceLoadDesc ezTexture2DResource::UpdateContent(ezStreamReader* Stream)
   ezImage* pImage = nullptr;
   bool bIsFallback = false;
   ezTexFormat texFormat;
+  ezUInt32 uiNumMipLevelsTotal = 0;
 
   // load image data
   {
     Stream->ReadBytes(&pImage, sizeof(ezImage*));
     *Stream >> bIsFallback;
     texFormat.ReadHeader(*Stream);
+    *Stream >> uiNumMipLevelsTotal;
 
     td.m_SamplerDesc.m_AddressU = texFormat.m_AddressModeU;
     td.m_SamplerDesc.m_AddressV = texFormat.m_AddressModeV;
@@ -161,8 +163,10 @@ ezResourceLoadDesc ezTexture2DResource::UpdateContent(ezStreamReader* Stream)
 
   {
 
-    const ezUInt32 uiNumMipmapsLowRes =
-      ezTextureUtils::s_bForceFullQualityAlways ? pImage->GetNumMipLevels() : ezMath::Min(pImage->GetNumMipLevels(), 6U);
+    // the loader may only have read the smallest mip levels
+    const ezUInt32 uiNumMipmapsLowRes = ezTextureUtils::s_bForceFullQualityAlways
+                                          ? pImage->GetNumMipLevels()
+                                          : ezMath::Min(pImage->GetNumMipLevels(), ezTextureUtils::s_uiNumMipLevelsLowRes);
     ezUInt32 uiUploadNumMipLevels = 0;
     bool bCouldLoadMore = false;
 
@@ -190,12 +194,36 @@ ezResourceLoadDesc ezTexture2DResource::UpdateContent(ezStreamReader* Stream)
     {
       if (m_uiLoadedTextures == 0)
       {
-        bCouldLoadMore = uiNumMipmapsLowRes < pImage->GetNumMipLevels();
+        bCouldLoadMore = uiNumMipmapsLowRes < uiNumMipLevelsTotal;
         uiUploadNumMipLevels = uiNumMipmapsLowRes;
       }
       else if (m_uiLoadedTextures == 1)
       {
-        uiUploadNumMipLevels = pImage->GetNumMipLevels();
+        if (pImage->GetNumMipLevels() < uiNumMipLevelsTotal)
+        {
+          // the loader only read the smallest mip levels, because the texture had no data yet,
+          // but in the meantime low-res data was set from elsewhere (e.g. embedded in a material)
+          bCouldLoadMore = true;
+
+          if (pImage->GetWidth() > m_uiWidth || pImage->GetHeight() > m_uiHeight)
+          {
+            // the streamed mip levels have a higher resolution, replace the current low-res data with them
+            ezGALDevice::GetDefaultDevice()->DestroyTexture(m_hGALTexture[0]);
+            m_hGALTexture[0].Invalidate();
+            m_uiMemoryGPU[0] = 0;
+            m_uiLoadedTextures = 0;
+
+            uiUploadNumMipLevels = uiNumMipmapsLowRes;
+          }
+          else
+          {
+            ezLog::Debug("Ignoring texture data, only the low-res mip levels were read.");
+          }
+        }
+        else
+        {
+          uiUploadNumMipLevels = pImage->GetNumMipLevels();
+        }
       }
       else
       {
@@ -119,7 +119,16 @@ ezResourceLoadData ezTextureResourceLoader::OpenDataStream(const ezResource* pRe
     if (sAbsolutePath.HasExtension("ezTexture2D") || sAbsolutePath.HasExtension("ezTexture3D") || sAbsolutePath.HasExtension("ezTextureCube") ||
         sAbsolutePath.HasExtension("ezRenderTarget") || sAbsolutePath.HasExtension("ezLUT"))
     {
-      if (LoadTexFile(File, *pData).Failed())
+      ezUInt32 uiMaxMipLevels = ezInvalidIndex;
+
+      // as long as a 2D texture has no data at all, it only uploads its low resolution mip levels,
+      // the rest is read once the resource manager requests the next quality level
+      if (pResource->IsInstanceOf<ezTexture2DResource>() && pResource->GetNumQualityLevelsDiscardable() == 0 && !ezTextureUtils::s_bForceFullQualityAlways)
+      {
+        uiMaxMipLevels = ezTextureUtils::s_uiNumMipLevelsLowRes;
+      }
+
+      if (LoadTexFile(File, *pData, uiMaxMipLevels).Failed())
         return res;
     }
     else
@@ -190,7 +199,7 @@ bool ezTextureResourceLoader::IsResourceOutdated(const ezResource* pResource) co
   return true;
 }
 
-ezResult ezTextureResourceLoader::LoadTexFile(ezStreamReader& stream, LoadedData& data)
+ezResult ezTextureResourceLoader::LoadTexFile(ezStreamReader& stream, LoadedData& data, ezUInt32 uiMaxMipLevels /*= ezInvalidIndex*/)
 {
   // read the hash, ignore it
   ezAssetFileHeader AssetHash;
@@ -198,7 +207,11 @@ ezResult ezTextureResourceLoader::LoadTexFile(ezStreamReader& stream, LoadedData
 
   data.m_TexFormat.ReadHeader(stream);
 
-  if (data.m_TexFormat.m_iRenderTargetResolutionX == 0)
+  if (data.m_TexFormat.m_bStreamableMipLevels)
+  {
+    return ezTexFormat::ReadStreamableImage(stream, data.m_Image, uiMaxMipLevels, &data.m_uiNumMipLevelsTotal);
+  }
+  else if (data.m_TexFormat.m_iRenderTargetResolutionX == 0)
   {
     ezDdsFileFormat fmt;
     return fmt.ReadImage(stream, data.m_Image, ezLog::GetThreadLocalLogSystem(), "dds");
@@ -216,6 +229,10 @@ void ezTextureResourceLoader::WriteTextureLoadStream(ezStreamWriter& w, const Lo
 
   w << data.m_bIsFallback;
   data.m_TexFormat.WriteRenderTargetHeader(w);
+
+  // images that were read completely don't set the mip level count
+  const ezUInt32 uiNumMipLevelsTotal = ezMath::Max(data.m_uiNumMipLevelsTotal, data.m_Image.GetNumMipLevels());
+  w << uiNumMipLevelsTotal;
 }
 
 EZ_STATICLINK_FILE(RendererCore, RendererCore_Textures_TextureLoader);
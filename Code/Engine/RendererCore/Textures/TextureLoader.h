@@ -22,13 +22,17 @@ public:
 
     bool m_bIsFallback = false;
     ezTexFormat m_TexFormat;
+
+    /// The number of mip levels of the texture, m_Image may only contain the smallest ones.
+    ezUInt32 m_uiNumMipLevelsTotal = 0;
   };
 
   virtual ezResourceLoadData OpenDataStream(const ezResource* pResource) override;
   virtual void CloseDataStream(const ezResource* pResource, const ezResourceLoadData& LoaderData) override;
   virtual bool IsResourceOutdated(const ezResource* pResource) const override;
 
-  static ezResult LoadTexFile(ezStreamReader& stream, LoadedData& data);
+  /// \brief Reads an ezTexFormat file. If the file stores its mip levels in the streamable layout, only the \a uiMaxMipLevels smallest ones are read.
+  static ezResult LoadTexFile(ezStreamReader& stream, LoadedData& data, ezUInt32 uiMaxMipLevels = ezInvalidIndex);
   static void WriteTextureLoadStream(ezStreamWriter& stream, const LoadedData& data);
 };
 
@@ -13,5 +13,8 @@ struct EZ_RENDERERCORE_DLL ezTextureUtils
 
   /// \brief If enabled, textures are always loaded to full quality immediately. Mostly necessary for image comparison unit tests.
   static bool s_bForceFullQualityAlways;
+
+  /// \brief How many of the smallest mip levels are loaded first, before a texture is loaded in full quality.
+  static constexpr ezUInt32 s_uiNumMipLevelsLowRes = 6;
 };
 
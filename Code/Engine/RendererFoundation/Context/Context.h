@@ -146,6 +146,10 @@ public:
 
   ezGALDevice* GetDevice() const;
 
+  /// \brief Incremented whenever the context unbinds resource views or unordered access views on its own, e.g. because their resource
+  /// got bound as a render target. Code that caches bindings on top of the context uses this to detect when it has to re-apply them.
+  ezUInt32 GetImplicitUnbindCounter() const;
+
 protected:
 
   friend class ezGALDevice;
@@ -311,6 +315,8 @@ private:
   ezUInt32 m_uiStateChanges;
 
   ezUInt32 m_uiRedundantStateChanges;
+
+  ezUInt32 m_uiImplicitUnbindCounter;
 };
 
 #include <RendererFoundation/Context/Implementation/Context_inl.h>
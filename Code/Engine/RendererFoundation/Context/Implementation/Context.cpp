@@ -15,6 +15,7 @@ ezGALContext::ezGALContext(ezGALDevice* pDevice)
   , m_uiDispatchCalls(0)
   , m_uiStateChanges(0)
   , m_uiRedundantStateChanges(0)
+  , m_uiImplicitUnbindCounter(0)
 {
   EZ_ASSERT_DEV(pDevice != nullptr, "The context needs a valid device pointer!");
 
@@ -841,6 +842,7 @@ void ezGALContext::ClearStatisticsCounters()
 void ezGALContext::InvalidateState()
 {
   m_State.Invalidate();
+  ++m_uiImplicitUnbindCounter;
 }
 
 bool ezGALContext::UnsetResourceViews(const ezGALResourceBase* pResource)
@@ -865,6 +867,9 @@ bool ezGALContext::UnsetResourceViews(const ezGALResourceBase* pResource)
     }
   }
 
+  if (bResult)
+    ++m_uiImplicitUnbindCounter;
+
   return bResult;
 }
 
@@ -887,6 +892,9 @@ bool ezGALContext::UnsetUnorderedAccessViews(const ezGALResourceBase* pResource)
     }
   }
 
+  if (bResult)
+    ++m_uiImplicitUnbindCounter;
+
   return bResult;
 }
 
@@ -4,6 +4,11 @@ EZ_ALWAYS_INLINE ezGALDevice* ezGALContext::GetDevice() const
   return m_pDevice;
 }
 
+EZ_ALWAYS_INLINE ezUInt32 ezGALContext::GetImplicitUnbindCounter() const
+{
+  return m_uiImplicitUnbindCounter;
+}
+
 EZ_ALWAYS_INLINE void ezGALContext::CountDrawCall()
 {
   m_uiDrawCalls++;
@@ -0,0 +1,245 @@
+#pragma once
+
+#include <Foundation/Containers/DynamicArray.h>
+#include <Foundation/Types/Enum.h>
+#include <RendererFoundation/Context/Context.h>
+#include <RendererNull/RendererNullDLL.h>
+
+/// \brief The commands that are recorded by ezGALContextNull.
+struct ezGALNullCommandType
+{
+  typedef ezUInt8 StorageType;
+
+  enum Enum
+  {
+    Clear,
+    ClearUnorderedAccessView,
+
+    Draw,
+    DrawIndexed,
+    DrawIndexedInstanced,
+    DrawIndexedInstancedIndirect,
+    DrawInstanced,
+    DrawInstancedIndirect,
+    DrawAuto,
+    Dispatch,
+    DispatchIndirect,
+    BeginStreamOut,
+    EndStreamOut,
+
+    SetShader,
+    SetIndexBuffer,
+    SetVertexBuffer,
+    SetVertexDeclaration,
+    SetPrimitiveTopology,
+    SetConstantBuffer,
+    SetSamplerState,
+    SetResourceView,
+    SetRenderTargetSetup,
+    SetUnorderedAccessView,
+    SetBlendState,
+    SetDepthStencilState,
+    SetRasterizerState,
+    SetViewport,
+    SetScissorRect,
+    SetStreamOutBuffer,
+
+    CopyBuffer,
+    CopyBufferRegion,
+    UpdateBuffer,
+    CopyTexture,
+    CopyTextureRegion,
+    UpdateTexture,
+    ResolveTexture,
+    ReadbackTexture,
+    GenerateMipMaps,
+
+    ENUM_COUNT,
+
+    FirstDrawCommand = Draw,
+    LastDrawCommand = DrawAuto,
+    FirstStateCommand = SetShader,
+    LastStateCommand = SetStreamOutBuffer,
+
+    Default = Draw
+  };
+};
+
+/// \brief A single recorded command.
+///
+/// Only the GAL object that is set or used by the command is stored, plus up to three integer arguments,
+/// e.g. the slot of a binding or the counts of a draw call.
+struct ezGALNullCommand
+{
+  EZ_DECLARE_POD_TYPE();
+
+  const void* m_pObject;
+  ezUInt32 m_uiArgs[3];
+  ezEnum<ezGALNullCommandType> m_Type;
+};
+
+/// \brief Counts the commands that were executed on a null context.
+struct EZ_RENDERERNULL_DLL ezGALNullStatistics
+{
+  ezUInt32 GetNumDrawCalls() const;
+  ezUInt32 GetNumDispatchCalls() const;
+  ezUInt32 GetNumStateChanges() const;
+
+  ezUInt32 m_uiNumCommands[ezGALNullCommandType::ENUM_COUNT] = {};
+  ezUInt64 m_uiUploadedBufferBytes = 0;
+};
+
+/// \brief The null implementation of the graphics context.
+///
+/// It does not render anything, but records all commands that reach the platform layer into a compact command list and
+/// counts them, such that the CPU side of rendering can be tested and profiled without a GPU.
+/// Redundant state changes are already filtered out by ezGALContext, so only actual state changes are recorded.
+class EZ_RENDERERNULL_DLL ezGALContextNull : public ezGALContext
+{
+public:
+  /// \brief Returns all commands that were recorded since the last reset.
+  EZ_ALWAYS_INLINE ezArrayPtr<const ezGALNullCommand> GetCommands() const { return m_Commands; }
+
+  /// \brief Returns the statistics since the last reset.
+  EZ_ALWAYS_INLINE const ezGALNullStatistics& GetStatistics() const { return m_Statistics; }
+
+  /// \brief Clears the recorded commands and the statistics. The null device does this at the start of every frame.
+  void Reset();
+
+  /// \brief Disables recording of commands, e.g. for long running benchmarks which are only interested in the statistics. Enabled by default.
+  void SetRecordCommands(bool bRecord) { m_bRecordCommands = bRecord; }
+
+protected:
+  friend class ezGALDeviceNull;
+  friend class ezMemoryUtils;
+
+  ezGALContextNull(ezGALDevice* pDevice);
+
+  ~ezGALContextNull();
+
+  // Draw functions
+
+  virtual void ClearPlatform(const ezColor& ClearColor, ezUInt32 uiRenderTargetClearMask, bool bClearDepth, bool bClearStencil, float fDepthClear, ezUInt8 uiStencilClear) override;
+
+  virtual void ClearUnorderedAccessViewPlatform(const ezGALUnorderedAccessView* pUnorderedAccessView, ezVec4 clearValues) override;
+
+  virtual void ClearUnorderedAccessViewPlatform(const ezGALUnorderedAccessView* pUnorderedAccessView, ezVec4U32 clearValues) override;
+
+  virtual void DrawPlatform(ezUInt32 uiVertexCount, ezUInt32 uiStartVertex) override;
+
+  virtual void DrawIndexedPlatform(ezUInt32 uiIndexCount, ezUInt32 uiStartIndex) override;
+
+  virtual void DrawIndexedInstancedPlatform(ezUInt32 uiIndexCountPerInstance, ezUInt32 uiInstanceCount, ezUInt32 uiStartIndex) override;
+
+  virtual void DrawIndexedInstancedIndirectPlatform(const ezGALBuffer* pIndirectArgumentBuffer, ezUInt32 uiArgumentOffsetInBytes) override;
+
+  virtual void DrawInstancedPlatform(ezUInt32 uiVertexCountPerInstance, ezUInt32 uiInstanceCount, ezUInt32 uiStartVertex) override;
+
+  virtual void DrawInstancedIndirectPlatform(const ezGALBuffer* pIndirectArgumentBuffer, ezUInt32 uiArgumentOffsetInBytes) override;
+
+  virtual void DrawAutoPlatform() override;
+
+  virtual void BeginStreamOutPlatform() override;
+
+  virtual void EndStreamOutPlatform() override;
+
+  // Dispatch
+
+  virtual void DispatchPlatform(ezUInt32 uiThreadGroupCountX, ezUInt32 uiThreadGroupCountY, ezUInt32 uiThreadGroupCountZ) override;
+
+  virtual void DispatchIndirectPlatform(const ezGALBuffer* pIndirectArgumentBuffer, ezUInt32 uiArgumentOffsetInBytes) override;
+
+
+  // State setting functions
+
+  virtual void SetShaderPlatform(const ezGALShader* pShader) override;
+
+  virtual void SetIndexBufferPlatform(const ezGALBuffer* pIndexBuffer) override;
+
+  virtual void SetVertexBufferPlatform(ezUInt32 uiSlot, const ezGALBuffer* pVertexBuffer) override;
+
+  virtual void SetVertexDeclarationPlatform(const ezGALVertexDeclaration* pVertexDeclaration) override;
+
+  virtual void SetPrimitiveTopologyPlatform(ezGALPrimitiveTopology::Enum Topology) override;
+
+  virtual void SetConstantBufferPlatform(ezUInt32 uiSlot, const ezGALBuffer* pBuffer) override;
+
+  virtual void SetSamplerStatePlatform(ezGALShaderStage::Enum Stage, ezUInt32 uiSlot, const ezGALSamplerState* pSamplerState) override;
+
+  virtual void SetResourceViewPlatform(ezGALShaderStage::Enum Stage, ezUInt32 uiSlot, const ezGALResourceView* pResourceView) override;
+
+  virtual void SetRenderTargetSetupPlatform(ezArrayPtr<const ezGALRenderTargetView*> pRenderTargetViews, const ezGALRenderTargetView* pDepthStencilView) override;
+
+  virtual void SetUnorderedAccessViewPlatform(ezUInt32 uiSlot, const ezGALUnorderedAccessView* pUnorderedAccessView) override;
+
+  virtual void SetBlendStatePlatform(const ezGALBlendState* pBlendState, const ezColor& BlendFactor, ezUInt32 uiSampleMask) override;
+
+  virtual void SetDepthStencilStatePlatform(const ezGALDepthStencilState* pDepthStencilState, ezUInt8 uiStencilRefValue) override;
+
+  virtual void SetRasterizerStatePlatform(const ezGALRasterizerState* pRasterizerState) override;
+
+  virtual void SetViewportPlatform(const ezRectFloat& rect, float fMinDepth, float fMaxDepth) override;
+
+  virtual void SetScissorRectPlatform(const ezRectU32& rect) override;
+
+  virtual void SetStreamOutBufferPlatform(ezUInt32 uiSlot, const ezGALBuffer* pBuffer, ezUInt32 uiOffset) override;
+
+  // Fence & Query functions
+
+  virtual void InsertFencePlatform(const ezGALFence* pFence) override;
+
+  virtual bool IsFenceReachedPlatform(const ezGALFence* pFence) override;
+
+  virtual void WaitForFencePlatform(const ezGALFence* pFence) override;
+
+  virtual void BeginQueryPlatform(const ezGALQuery* pQuery) override;
+
+  virtual void EndQueryPlatform(const ezGALQuery* pQuery) override;
+
+  virtual ezResult GetQueryResultPlatform(const ezGALQuery* pQuery, ezUInt64& uiQueryResult) override;
+
+  // Timestamp functions
+
+  virtual void InsertTimestampPlatform(ezGALTimestampHandle hTimestamp) override;
+
+  // Resource update functions
+
+  virtual void CopyBufferPlatform(const ezGALBuffer* pDestination, const ezGALBuffer* pSource) override;
+
+  virtual void CopyBufferRegionPlatform(const ezGALBuffer* pDestination, ezUInt32 uiDestOffset, const ezGALBuffer* pSource, ezUInt32 uiSourceOffset, ezUInt32 uiByteCount) override;
+
+  virtual void UpdateBufferPlatform(const ezGALBuffer* pDestination, ezUInt32 uiDestOffset, ezArrayPtr<const ezUInt8> pSourceData, ezGALUpdateMode::Enum updateMode) override;
+
+  virtual void CopyTexturePlatform(const ezGALTexture* pDestination, const ezGALTexture* pSource) override;
+
+  virtual void CopyTextureRegionPlatform(const ezGALTexture* pDestination, const ezGALTextureSubresource& DestinationSubResource, const ezVec3U32& DestinationPoint, const ezGALTexture* pSource, const ezGALTextureSubresource& SourceSubResource, const ezBoundingBoxu32& Box) override;
+
+  virtual void UpdateTexturePlatform(const ezGALTexture* pDestination, const ezGALTextureSubresource& DestinationSubResource, const ezBoundingBoxu32& DestinationBox, const ezGALSystemMemoryDescription& pSourceData) override;
+
+  virtual void ResolveTexturePlatform(const ezGALTexture* pDestination, const ezGALTextureSubresource& DestinationSubResource, const ezGALTexture* pSource, const ezGALTextureSubresource& SourceSubResource) override;
+
+  virtual void ReadbackTexturePlatform(const ezGALTexture* pTexture) override;
+
+  virtual void CopyTextureReadbackResultPlatform(const ezGALTexture* pTexture, const ezArrayPtr<ezGALSystemMemoryDescription>* pData) override;
+
+  virtual void GenerateMipMapsPlatform(const ezGALResourceView* pResourceView) override;
+
+  // Misc
+
+  virtual void FlushPlatform() override;
+
+  // Debug helper functions
+
+  virtual void PushMarkerPlatform(const char* Marker) override;
+
+  virtual void PopMarkerPlatform() override;
+
+  virtual void InsertEventMarkerPlatform(const char* Marker) override;
+
+private:
+  void Record(ezGALNullCommandType::Enum type, const void* pObject, ezUInt32 uiArg0 = 0, ezUInt32 uiArg1 = 0, ezUInt32 uiArg2 = 0);
+
+  ezDynamicArray<ezGALNullCommand> m_Commands;
+  ezGALNullStatistics m_Statistics;
+  bool m_bRecordCommands = true;
+};
@@ -0,0 +1,383 @@
+#include <RendererNullPCH.h>
+
+#include <RendererNull/Context/ContextNull.h>
+#include <RendererNull/Device/DeviceNull.h>
+#include <RendererNull/Resources/ResourcesNull.h>
+
+ezUInt32 ezGALNullStatistics::GetNumDrawCalls() const
+{
+  ezUInt32 uiCount = 0;
+  for (ezUInt32 i = ezGALNullCommandType::FirstDrawCommand; i <= ezGALNullCommandType::LastDrawCommand; ++i)
+  {
+    uiCount += m_uiNumCommands[i];
+  }
+
+  return uiCount;
+}
+
+ezUInt32 ezGALNullStatistics::GetNumDispatchCalls() const
+{
+  return m_uiNumCommands[ezGALNullCommandType::Dispatch] + m_uiNumCommands[ezGALNullCommandType::DispatchIndirect];
+}
+
+ezUInt32 ezGALNullStatistics::GetNumStateChanges() const
+{
+  ezUInt32 uiCount = 0;
+  for (ezUInt32 i = ezGALNullCommandType::FirstStateCommand; i <= ezGALNullCommandType::LastStateCommand; ++i)
+  {
+    uiCount += m_uiNumCommands[i];
+  }
+
+  return uiCount;
+}
+
+ezGALContextNull::ezGALContextNull(ezGALDevice* pDevice)
+  : ezGALContext(pDevice)
+{
+}
+
+ezGALContextNull::~ezGALContextNull() = default;
+
+void ezGALContextNull::Reset()
+{
+  m_Commands.Clear();
+  m_Statistics = ezGALNullStatistics();
+}
+
+void ezGALContextNull::Record(ezGALNullCommandType::Enum type, const void* pObject, ezUInt32 uiArg0, ezUInt32 uiArg1, ezUInt32 uiArg2)
+{
+  ++m_Statistics.m_uiNumCommands[type];
+
+  if (!m_bRecordCommands)
+    return;
+
+  ezGALNullCommand& command = m_Commands.ExpandAndGetRef();
+  command.m_pObject = pObject;
+  command.m_uiArgs[0] = uiArg0;
+  command.m_uiArgs[1] = uiArg1;
+  command.m_uiArgs[2] = uiArg2;
+  command.m_Type = type;
+}
+
+// Draw functions
+
+void ezGALContextNull::ClearPlatform(const ezColor& ClearColor, ezUInt32 uiRenderTargetClearMask, bool bClearDepth, bool bClearStencil, float fDepthClear, ezUInt8 uiStencilClear)
+{
+  Record(ezGALNullCommandType::Clear, nullptr, uiRenderTargetClearMask, bClearDepth ? 1 : 0, bClearStencil ? 1 : 0);
+}
+
+void ezGALContextNull::ClearUnorderedAccessViewPlatform(const ezGALUnorderedAccessView* pUnorderedAccessView, ezVec4 clearValues)
+{
+  Record(ezGALNullCommandType::ClearUnorderedAccessView, pUnorderedAccessView);
+}
+
+void ezGALContextNull::ClearUnorderedAccessViewPlatform(const ezGALUnorderedAccessView* pUnorderedAccessView, ezVec4U32 clearValues)
+{
+  Record(ezGALNullCommandType::ClearUnorderedAccessView, pUnorderedAccessView);
+}
+
+void ezGALContextNull::DrawPlatform(ezUInt32 uiVertexCount, ezUInt32 uiStartVertex)
+{
+  Record(ezGALNullCommandType::Draw, nullptr, uiVertexCount, uiStartVertex);
+}
+
+void ezGALContextNull::DrawIndexedPlatform(ezUInt32 uiIndexCount, ezUInt32 uiStartIndex)
+{
+  Record(ezGALNullCommandType::DrawIndexed, nullptr, uiIndexCount, uiStartIndex);
+}
+
+void ezGALContextNull::DrawIndexedInstancedPlatform(ezUInt32 uiIndexCountPerInstance, ezUInt32 uiInstanceCount, ezUInt32 uiStartIndex)
+{
+  Record(ezGALNullCommandType::DrawIndexedInstanced, nullptr, uiIndexCountPerInstance, uiInstanceCount, uiStartIndex);
+}
+
+void ezGALContextNull::DrawIndexedInstancedIndirectPlatform(const ezGALBuffer* pIndirectArgumentBuffer, ezUInt32 uiArgumentOffsetInBytes)
+{
+  Record(ezGALNullCommandType::DrawIndexedInstancedIndirect, pIndirectArgumentBuffer, uiArgumentOffsetInBytes);
+}
+
+void ezGALContextNull::DrawInstancedPlatform(ezUInt32 uiVertexCountPerInstance, ezUInt32 uiInstanceCount, ezUInt32 uiStartVertex)
+{
+  Record(ezGALNullCommandType::DrawInstanced, nullptr, uiVertexCountPerInstance, uiInstanceCount, uiStartVertex);
+}
+
+void ezGALContextNull::DrawInstancedIndirectPlatform(const ezGALBuffer* pIndirectArgumentBuffer, ezUInt32 uiArgumentOffsetInBytes)
+{
+  Record(ezGALNullCommandType::DrawInstancedIndirect, pIndirectArgumentBuffer, uiArgumentOffsetInBytes);
+}
+
+void ezGALContextNull::DrawAutoPlatform()
+{
+  Record(ezGALNullCommandType::DrawAuto, nullptr);
+}
+
+void ezGALContextNull::BeginStreamOutPlatform()
+{
+  Record(ezGALNullCommandType::BeginStreamOut, nullptr);
+}
+
+void ezGALContextNull::EndStreamOutPlatform()
+{
+  Record(ezGALNullCommandType::EndStreamOut, nullptr);
+}
+
+// Dispatch
+
+void ezGALContextNull::DispatchPlatform(ezUInt32 uiThreadGroupCountX, ezUInt32 uiThreadGroupCountY, ezUInt32 uiThreadGroupCountZ)
+{
+  Record(ezGALNullCommandType::Dispatch, nullptr, uiThreadGroupCountX, uiThreadGroupCountY, uiThreadGroupCountZ);
+}
+
+void ezGALContextNull::DispatchIndirectPlatform(const ezGALBuffer* pIndirectArgumentBuffer, ezUInt32 uiArgumentOffsetInBytes)
+{
+  Record(ezGALNullCommandType::DispatchIndirect, pIndirectArgumentBuffer, uiArgumentOffsetInBytes);
+}
+
+
+// State setting functions
+
+void ezGALContextNull::SetShaderPlatform(const ezGALShader* pShader)
+{
+  Record(ezGALNullCommandType::SetShader, pShader);
+}
+
+void ezGALContextNull::SetIndexBufferPlatform(const ezGALBuffer* pIndexBuffer)
+{
+  Record(ezGALNullCommandType::SetIndexBuffer, pIndexBuffer);
+}
+
+void ezGALContextNull::SetVertexBufferPlatform(ezUInt32 uiSlot, const ezGALBuffer* pVertexBuffer)
+{
+  Record(ezGALNullCommandType::SetVertexBuffer, pVertexBuffer, uiSlot);
+}
+
+void ezGALContextNull::SetVertexDeclarationPlatform(const ezGALVertexDeclaration* pVertexDeclaration)
+{
+  Record(ezGALNullCommandType::SetVertexDeclaration, pVertexDeclaration);
+}
+
+void ezGALContextNull::SetPrimitiveTopologyPlatform(ezGALPrimitiveTopology::Enum Topology)
+{
+  Record(ezGALNullCommandType::SetPrimitiveTopology, nullptr, Topology);
+}
+
+void ezGALContextNull::SetConstantBufferPlatform(ezUInt32 uiSlot, const ezGALBuffer* pBuffer)
+{
+  Record(ezGALNullCommandType::SetConstantBuffer, pBuffer, uiSlot);
+}
+
+void ezGALContextNull::SetSamplerStatePlatform(ezGALShaderStage::Enum Stage, ezUInt32 uiSlot, const ezGALSamplerState* pSamplerState)
+{
+  Record(ezGALNullCommandType::SetSamplerState, pSamplerState, uiSlot, Stage);
+}
+
+void ezGALContextNull::SetResourceViewPlatform(ezGALShaderStage::Enum Stage, ezUInt32 uiSlot, const ezGALResourceView* pResourceView)
+{
+  Record(ezGALNullCommandType::SetResourceView, pResourceView, uiSlot, Stage);
+}
+
+void ezGALContextNull::SetRenderTargetSetupPlatform(ezArrayPtr<const ezGALRenderTargetView*> pRenderTargetViews, const ezGALRenderTargetView* pDepthStencilView)
+{
+  Record(ezGALNullCommandType::SetRenderTargetSetup, pDepthStencilView, pRenderTargetViews.GetCount());
+}
+
+void ezGALContextNull::SetUnorderedAccessViewPlatform(ezUInt32 uiSlot, const ezGALUnorderedAccessView* pUnorderedAccessView)
+{
+  Record(ezGALNullCommandType::SetUnorderedAccessView, pUnorderedAccessView, uiSlot);
+}
+
+void ezGALContextNull::SetBlendStatePlatform(const ezGALBlendState* pBlendState, const ezColor& BlendFactor, ezUInt32 uiSampleMask)
+{
+  Record(ezGALNullCommandType::SetBlendState, pBlendState, uiSampleMask);
+}
+
+void ezGALContextNull::SetDepthStencilStatePlatform(const ezGALDepthStencilState* pDepthStencilState, ezUInt8 uiStencilRefValue)
+{
+  Record(ezGALNullCommandType::SetDepthStencilState, pDepthStencilState, uiStencilRefValue);
+}
+
+void ezGALContextNull::SetRasterizerStatePlatform(const ezGALRasterizerState* pRasterizerState)
+{
+  Record(ezGALNullCommandType::SetRasterizerState, pRasterizerState);
+}
+
+void ezGALContextNull::SetViewportPlatform(const ezRectFloat& rect, float fMinDepth, float fMaxDepth)
+{
+  Record(ezGALNullCommandType::SetViewport, nullptr, static_cast<ezUInt32>(rect.width), static_cast<ezUInt32>(rect.height));
+}
+
+void ezGALContextNull::SetScissorRectPlatform(const ezRectU32& rect)
+{
+  Record(ezGALNullCommandType::SetScissorRect, nullptr, rect.width, rect.height);
+}
+
+void ezGALContextNull::SetStreamOutBufferPlatform(ezUInt32 uiSlot, const ezGALBuffer* pBuffer, ezUInt32 uiOffset)
+{
+  Record(ezGALNullCommandType::SetStreamOutBuffer, pBuffer, uiSlot, uiOffset);
+}
+
+// Fence & Query functions
+
+void ezGALContextNull::InsertFencePlatform(const ezGALFence* pFence)
+{
+}
+
+bool ezGALContextNull::IsFenceReachedPlatform(const ezGALFence* pFence)
+{
+  // all commands are executed immediately
+  return true;
+}
+
+void ezGALContextNull::WaitForFencePlatform(const ezGALFence* pFence)
+{
+}
+
+void ezGALContextNull::BeginQueryPlatform(const ezGALQuery* pQuery)
+{
+}
+
+void ezGALContextNull::EndQueryPlatform(const ezGALQuery* pQuery)
+{
+}
+
+ezResult ezGALContextNull::GetQueryResultPlatform(const ezGALQuery* pQuery, ezUInt64& uiQueryResult)
+{
+  uiQueryResult = 0;
+  return EZ_SUCCESS;
+}
+
+// Timestamp functions
+
+void ezGALContextNull::InsertTimestampPlatform(ezGALTimestampHandle hTimestamp)
+{
+  ezGALDeviceNull* pNullDevice = static_cast<ezGALDeviceNull*>(GetDevice());
+
+  if (hTimestamp.m_uiIndex < pNullDevice->m_Timestamps.GetCount())
+  {
+    pNullDevice->m_Timestamps[static_cast<ezUInt32>(hTimestamp.m_uiIndex)] = ezTime::Now();
+  }
+}
+
+// Resource update functions
+
+void ezGALContextNull::CopyBufferPlatform(const ezGALBuffer* pDestination, const ezGALBuffer* pSource)
+{
+  ezGALBufferNull* pDestBuffer = static_cast<ezGALBufferNull*>(const_cast<ezGALBuffer*>(pDestination));
+  const ezGALBufferNull* pSourceBuffer = static_cast<const ezGALBufferNull*>(pSource);
+
+  const ezUInt32 uiByteCount = ezMath::Min(pDestBuffer->m_Data.GetCount(), pSourceBuffer->m_Data.GetCount());
+  ezMemoryUtils::Copy(pDestBuffer->m_Data.GetData(), pSourceBuffer->m_Data.GetData(), uiByteCount);
+
+  Record(ezGALNullCommandType::CopyBuffer, pDestination, uiByteCount);
+}
+
+void ezGALContextNull::CopyBufferRegionPlatform(const ezGALBuffer* pDestination, ezUInt32 uiDestOffset, const ezGALBuffer* pSource, ezUInt32 uiSourceOffset, ezUInt32 uiByteCount)
+{
+  ezGALBufferNull* pDestBuffer = static_cast<ezGALBufferNull*>(const_cast<ezGALBuffer*>(pDestination));
+  const ezGALBufferNull* pSourceBuffer = static_cast<const ezGALBufferNull*>(pSource);
+
+  EZ_ASSERT_DEV(uiDestOffset + uiByteCount <= pDestBuffer->m_Data.GetCount(), "Copy region is out of bounds of the destination buffer");
+  EZ_ASSERT_DEV(uiSourceOffset + uiByteCount <= pSourceBuffer->m_Data.GetCount(), "Copy region is out of bounds of the source buffer");
+
+  ezMemoryUtils::CopyOverlapped(pDestBuffer->m_Data.GetData() + uiDestOffset, pSourceBuffer->m_Data.GetData() + uiSourceOffset, uiByteCount);
+
+  Record(ezGALNullCommandType::CopyBufferRegion, pDestination, uiByteCount, uiDestOffset);
+}
+
+void ezGALContextNull::UpdateBufferPlatform(const ezGALBuffer* pDestination, ezUInt32 uiDestOffset, ezArrayPtr<const ezUInt8> pSourceData, ezGALUpdateMode::Enum updateMode)
+{
+  ezGALBufferNull* pDestBuffer = static_cast<ezGALBufferNull*>(const_cast<ezGALBuffer*>(pDestination));
+
+  EZ_ASSERT_DEV(uiDestOffset + pSourceData.GetCount() <= pDestBuffer->m_Data.GetCount(), "Buffer update is out of bounds");
+
+  ezMemoryUtils::Copy(pDestBuffer->m_Data.GetData() + uiDestOffset, pSourceData.GetPtr(), pSourceData.GetCount());
+
+  m_Statistics.m_uiUploadedBufferBytes += pSourceData.GetCount();
+  Record(ezGALNullCommandType::UpdateBuffer, pDestination, pSourceData.GetCount(), uiDestOffset, updateMode);
+}
+
+void ezGALContextNull::CopyTexturePlatform(const ezGALTexture* pDestination, const ezGALTexture* pSource)
+{
+  Record(ezGALNullCommandType::CopyTexture, pDestination);
+}
+
+void ezGALContextNull::CopyTextureRegionPlatform(const ezGALTexture* pDestination, const ezGALTextureSubresource& DestinationSubResource, const ezVec3U32& DestinationPoint, const ezGALTexture* pSource, const ezGALTextureSubresource& SourceSubResource, const ezBoundingBoxu32& Box)
+{
+  Record(ezGALNullCommandType::CopyTextureRegion, pDestination, DestinationSubResource.m_uiMipLevel, DestinationSubResource.m_uiArraySlice);
+}
+
+void ezGALContextNull::UpdateTexturePlatform(const ezGALTexture* pDestination, const ezGALTextureSubresource& DestinationSubResource, const ezBoundingBoxu32& DestinationBox, const ezGALSystemMemoryDescription& pSourceData)
+{
+  Record(ezGALNullCommandType::UpdateTexture, pDestination, DestinationSubResource.m_uiMipLevel, DestinationSubResource.m_uiArraySlice);
+}
+
+void ezGALContextNull::ResolveTexturePlatform(const ezGALTexture* pDestination, const ezGALTextureSubresource& DestinationSubResource, const ezGALTexture* pSource, const ezGALTextureSubresource& SourceSubResource)
+{
+  Record(ezGALNullCommandType::ResolveTexture, pDestination, DestinationSubResource.m_uiMipLevel, DestinationSubResource.m_uiArraySlice);
+}
+
+void ezGALContextNull::ReadbackTexturePlatform(const ezGALTexture* pTexture)
+{
+  Record(ezGALNullCommandType::ReadbackTexture, pTexture);
+}
+
+void ezGALContextNull::CopyTextureReadbackResultPlatform(const ezGALTexture* pTexture, const ezArrayPtr<ezGALSystemMemoryDescription>* pData)
+{
+  // textures have no content, so the read back data is all zero
+  const ezGALTextureCreationDescription& desc = pTexture->GetDescription();
+  const ezUInt32 uiBitsPerElement = ezGALResourceFormat::GetBitsPerElement(desc.m_Format);
+  const ezUInt32 uiMipLevelCount = ezMath::Max(desc.m_uiMipLevelCount, 1u);
+
+  for (ezUInt32 i = 0; i < pData->GetCount(); ++i)
+  {
+    const ezGALSystemMemoryDescription& memDesc = (*pData)[i];
+    if (memDesc.m_pData == nullptr)
+      continue;
+
+    const ezUInt32 uiMipLevel = i % uiMipLevelCount;
+    const ezUInt32 uiWidth = ezMath::Max(desc.m_uiWidth >> uiMipLevel, 1u);
+    const ezUInt32 uiHeight = ezMath::Max(desc.m_uiHeight >> uiMipLevel, 1u);
+    const ezUInt32 uiDepth = ezMath::Max(desc.m_uiDepth >> uiMipLevel, 1u);
+
+    const ezUInt32 uiRowSize = uiBitsPerElement * uiWidth / 8;
+    const ezUInt32 uiRowPitch = memDesc.m_uiRowPitch != 0 ? memDesc.m_uiRowPitch : uiRowSize;
+    const ezUInt32 uiSlicePitch = memDesc.m_uiSlicePitch != 0 ? memDesc.m_uiSlicePitch : uiRowPitch * uiHeight;
+
+    for (ezUInt32 z = 0; z < uiDepth; ++z)
+    {
+      for (ezUInt32 y = 0; y < uiHeight; ++y)
+      {
+        ezMemoryUtils::ZeroFill(static_cast<ezUInt8*>(ezMemoryUtils::AddByteOffset(memDesc.m_pData, z * uiSlicePitch + y * uiRowPitch)), uiRowSize);
+      }
+    }
+  }
+}
+
+void ezGALContextNull::GenerateMipMapsPlatform(const ezGALResourceView* pResourceView)
+{
+  Record(ezGALNullCommandType::GenerateMipMaps, pResourceView);
+}
+
+// Misc
+
+void ezGALContextNull::FlushPlatform()
+{
+}
+
+// Debug helper functions
+
+void ezGALContextNull::PushMarkerPlatform(const char* Marker)
+{
+}
+
+void ezGALContextNull::PopMarkerPlatform()
+{
+}
+
+void ezGALContextNull::InsertEventMarkerPlatform(const char* Marker)
+{
+}
+
+
+
+EZ_STATICLINK_FILE(RendererNull, RendererNull_Context_Implementation_ContextNull);
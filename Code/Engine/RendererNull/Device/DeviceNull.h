@@ -0,0 +1,128 @@
+#pragma once
+
+#include <Foundation/Math/Size.h>
+#include <Foundation/Time/Time.h>
+#include <RendererFoundation/Device/Device.h>
+#include <RendererNull/RendererNullDLL.h>
+
+class ezGALContextNull;
+
+/// \brief A graphics device that does not need a GPU.
+///
+/// All resources are created in system memory and the primary context records its commands instead of executing them,
+/// see ezGALContextNull. This allows to run the render pipeline, e.g. for CPU-side render loop benchmarks, on machines without a GPU.
+class EZ_RENDERERNULL_DLL ezGALDeviceNull : public ezGALDevice
+{
+public:
+  /// \brief Since there are no windows to query, all swap chains use \a backBufferSize as their resolution.
+  ezGALDeviceNull(const ezGALDeviceCreationDescription& Description, ezSizeU32 backBufferSize = ezSizeU32(1280, 720));
+
+  virtual ~ezGALDeviceNull();
+
+  EZ_ALWAYS_INLINE ezSizeU32 GetBackBufferSize() const { return m_BackBufferSize; }
+
+  ezGALContextNull* GetNullContext() const;
+
+  // These functions need to be implemented by a render API abstraction
+protected:
+  // Init & shutdown functions
+
+  virtual ezResult InitPlatform() override;
+
+  virtual ezResult ShutdownPlatform() override;
+
+
+  // State creation functions
+
+  virtual ezGALBlendState* CreateBlendStatePlatform(const ezGALBlendStateCreationDescription& Description) override;
+
+  virtual void DestroyBlendStatePlatform(ezGALBlendState* pBlendState) override;
+
+  virtual ezGALDepthStencilState* CreateDepthStencilStatePlatform(const ezGALDepthStencilStateCreationDescription& Description) override;
+
+  virtual void DestroyDepthStencilStatePlatform(ezGALDepthStencilState* pDepthStencilState) override;
+
+  virtual ezGALRasterizerState* CreateRasterizerStatePlatform(const ezGALRasterizerStateCreationDescription& Description) override;
+
+  virtual void DestroyRasterizerStatePlatform(ezGALRasterizerState* pRasterizerState) override;
+
+  virtual ezGALSamplerState* CreateSamplerStatePlatform(const ezGALSamplerStateCreationDescription& Description) override;
+
+  virtual void DestroySamplerStatePlatform(ezGALSamplerState* pSamplerState) override;
+
+
+  // Resource creation functions
+
+  virtual ezGALShader* CreateShaderPlatform(const ezGALShaderCreationDescription& Description) override;
+
+  virtual void DestroyShaderPlatform(ezGALShader* pShader) override;
+
+  virtual ezGALBuffer* CreateBufferPlatform(const ezGALBufferCreationDescription& Description, ezArrayPtr<const ezUInt8> pInitialData) override;
+
+  virtual void DestroyBufferPlatform(ezGALBuffer* pBuffer) override;
+
+  virtual ezGALTexture* CreateTexturePlatform(const ezGALTextureCreationDescription& Description, ezArrayPtr<ezGALSystemMemoryDescription> pInitialData) override;
+
+  virtual void DestroyTexturePlatform(ezGALTexture* pTexture) override;
+
+  virtual ezGALResourceView* CreateResourceViewPlatform(ezGALResourceBase* pResource, const ezGALResourceViewCreationDescription& Description) override;
+
+  virtual void DestroyResourceViewPlatform(ezGALResourceView* pResourceView) override;
+
+  virtual ezGALRenderTargetView* CreateRenderTargetViewPlatform(ezGALTexture* pTexture, const ezGALRenderTargetViewCreationDescription& Description) override;
+
+  virtual void DestroyRenderTargetViewPlatform(ezGALRenderTargetView* pRenderTargetView) override;
+
+  virtual ezGALUnorderedAccessView* CreateUnorderedAccessViewPlatform(ezGALResourceBase* pResource, const ezGALUnorderedAccessViewCreationDescription& Description) override;
+
+  virtual void DestroyUnorderedAccessViewPlatform(ezGALUnorderedAccessView* pUnorderedAccessView) override;
+
+  // Other rendering creation functions
+
+  virtual ezGALSwapChain* CreateSwapChainPlatform(const ezGALSwapChainCreationDescription& Description) override;
+
+  virtual void DestroySwapChainPlatform(ezGALSwapChain* pSwapChain) override;
+
+  virtual ezGALFence* CreateFencePlatform() override;
+
+  virtual void DestroyFencePlatform(ezGALFence* pFence) override;
+
+  virtual ezGALQuery* CreateQueryPlatform(const ezGALQueryCreationDescription& Description) override;
+
+  virtual void DestroyQueryPlatform(ezGALQuery* pQuery) override;
+
+  virtual ezGALVertexDeclaration* CreateVertexDeclarationPlatform(const ezGALVertexDeclarationCreationDescription& Description) override;
+
+  virtual void DestroyVertexDeclarationPlatform(ezGALVertexDeclaration* pVertexDeclaration) override;
+
+  // Timestamp functions
+
+  virtual ezGALTimestampHandle GetTimestampPlatform() override;
+
+  virtual ezResult GetTimestampResultPlatform(ezGALTimestampHandle hTimestamp, ezTime& result) override;
+
+  // Swap chain functions
+
+  virtual void PresentPlatform(ezGALSwapChain* pSwapChain, bool bVSync) override;
+
+  // Misc functions
+
+  virtual void BeginFramePlatform() override;
+
+  virtual void EndFramePlatform() override;
+
+  virtual void SetPrimarySwapChainPlatform(ezGALSwapChain* pSwapChain) override;
+
+  virtual void FillCapabilitiesPlatform() override;
+
+private:
+  friend class ezGALContextNull;
+
+  ezSizeU32 m_BackBufferSize;
+
+  ezUInt64 m_uiFrameCounter = 0;
+
+  // timestamps are taken on the CPU when they are inserted into the context
+  ezDynamicArray<ezTime> m_Timestamps;
+  ezUInt32 m_uiNextTimestamp = 0;
+};
@@ -0,0 +1,337 @@
+#include <RendererNullPCH.h>
+
+#include <RendererNull/Context/ContextNull.h>
+#include <RendererNull/Device/DeviceNull.h>
+#include <RendererNull/Resources/ResourcesNull.h>
+
+ezGALDeviceNull::ezGALDeviceNull(const ezGALDeviceCreationDescription& Description, ezSizeU32 backBufferSize)
+  : ezGALDevice(Description)
+  , m_BackBufferSize(backBufferSize)
+  , m_Timestamps(&m_Allocator)
+{
+}
+
+ezGALDeviceNull::~ezGALDeviceNull() = default;
+
+ezGALContextNull* ezGALDeviceNull::GetNullContext() const
+{
+  return static_cast<ezGALContextNull*>(GetPrimaryContext());
+}
+
+// Init & shutdown functions
+
+ezResult ezGALDeviceNull::InitPlatform()
+{
+  EZ_LOG_BLOCK("ezGALDeviceNull::InitPlatform");
+
+  m_pPrimaryContext = EZ_NEW(&m_Allocator, ezGALContextNull, this);
+
+  m_Timestamps.SetCount(1024);
+
+  ezLog::Success("Initialized null device.");
+  return EZ_SUCCESS;
+}
+
+ezResult ezGALDeviceNull::ShutdownPlatform()
+{
+  m_Timestamps.Clear();
+
+  EZ_DELETE(&m_Allocator, m_pPrimaryContext);
+
+  return EZ_SUCCESS;
+}
+
+
+// State creation functions
+
+ezGALBlendState* ezGALDeviceNull::CreateBlendStatePlatform(const ezGALBlendStateCreationDescription& Description)
+{
+  ezGALBlendStateNull* pState = EZ_NEW(&m_Allocator, ezGALBlendStateNull, Description);
+  EZ_VERIFY(pState->InitPlatform(this).Succeeded(), "Null objects can't fail to initialize");
+  return pState;
+}
+
+void ezGALDeviceNull::DestroyBlendStatePlatform(ezGALBlendState* pBlendState)
+{
+  ezGALBlendStateNull* pState = static_cast<ezGALBlendStateNull*>(pBlendState);
+  pState->DeInitPlatform(this);
+  EZ_DELETE(&m_Allocator, pState);
+}
+
+ezGALDepthStencilState* ezGALDeviceNull::CreateDepthStencilStatePlatform(const ezGALDepthStencilStateCreationDescription& Description)
+{
+  ezGALDepthStencilStateNull* pState = EZ_NEW(&m_Allocator, ezGALDepthStencilStateNull, Description);
+  EZ_VERIFY(pState->InitPlatform(this).Succeeded(), "Null objects can't fail to initialize");
+  return pState;
+}
+
+void ezGALDeviceNull::DestroyDepthStencilStatePlatform(ezGALDepthStencilState* pDepthStencilState)
+{
+  ezGALDepthStencilStateNull* pState = static_cast<ezGALDepthStencilStateNull*>(pDepthStencilState);
+  pState->DeInitPlatform(this);
+  EZ_DELETE(&m_Allocator, pState);
+}
+
+ezGALRasterizerState* ezGALDeviceNull::CreateRasterizerStatePlatform(const ezGALRasterizerStateCreationDescription& Description)
+{
+  ezGALRasterizerStateNull* pState = EZ_NEW(&m_Allocator, ezGALRasterizerStateNull, Description);
+  EZ_VERIFY(pState->InitPlatform(this).Succeeded(), "Null objects can't fail to initialize");
+  return pState;
+}
+
+void ezGALDeviceNull::DestroyRasterizerStatePlatform(ezGALRasterizerState* pRasterizerState)
+{
+  ezGALRasterizerStateNull* pState = static_cast<ezGALRasterizerStateNull*>(pRasterizerState);
+  pState->DeInitPlatform(this);
+  EZ_DELETE(&m_Allocator, pState);
+}
+
+ezGALSamplerState* ezGALDeviceNull::CreateSamplerStatePlatform(const ezGALSamplerStateCreationDescription& Description)
+{
+  ezGALSamplerStateNull* pState = EZ_NEW(&m_Allocator, ezGALSamplerStateNull, Description);
+  EZ_VERIFY(pState->InitPlatform(this).Succeeded(), "Null objects can't fail to initialize");
+  return pState;
+}
+
+void ezGALDeviceNull::DestroySamplerStatePlatform(ezGALSamplerState* pSamplerState)
+{
+  ezGALSamplerStateNull* pState = static_cast<ezGALSamplerStateNull*>(pSamplerState);
+  pState->DeInitPlatform(this);
+  EZ_DELETE(&m_Allocator, pState);
+}
+
+
+// Resource creation functions
+
+ezGALShader* ezGALDeviceNull::CreateShaderPlatform(const ezGALShaderCreationDescription& Description)
+{
+  ezGALShaderNull* pShader = EZ_NEW(&m_Allocator, ezGALShaderNull, Description);
+  EZ_VERIFY(pShader->InitPlatform(this).Succeeded(), "Null objects can't fail to initialize");
+  return pShader;
+}
+
+void ezGALDeviceNull::DestroyShaderPlatform(ezGALShader* pShader)
+{
+  ezGALShaderNull* pNullShader = static_cast<ezGALShaderNull*>(pShader);
+  pNullShader->DeInitPlatform(this);
+  EZ_DELETE(&m_Allocator, pNullShader);
+}
+
+ezGALBuffer* ezGALDeviceNull::CreateBufferPlatform(const ezGALBufferCreationDescription& Description, ezArrayPtr<const ezUInt8> pInitialData)
+{
+  ezGALBufferNull* pBuffer = EZ_NEW(&m_Allocator, ezGALBufferNull, Description);
+
+  if (!pBuffer->InitPlatform(this, pInitialData).Succeeded())
+  {
+    EZ_DELETE(&m_Allocator, pBuffer);
+    return nullptr;
+  }
+
+  return pBuffer;
+}
+
+void ezGALDeviceNull::DestroyBufferPlatform(ezGALBuffer* pBuffer)
+{
+  ezGALBufferNull* pNullBuffer = static_cast<ezGALBufferNull*>(pBuffer);
+  pNullBuffer->DeInitPlatform(this);
+  EZ_DELETE(&m_Allocator, pNullBuffer);
+}
+
+ezGALTexture* ezGALDeviceNull::CreateTexturePlatform(const ezGALTextureCreationDescription& Description, ezArrayPtr<ezGALSystemMemoryDescription> pInitialData)
+{
+  ezGALTextureNull* pTexture = EZ_NEW(&m_Allocator, ezGALTextureNull, Description);
+  EZ_VERIFY(pTexture->InitPlatform(this, pInitialData).Succeeded(), "Null objects can't fail to initialize");
+  return pTexture;
+}
+
+void ezGALDeviceNull::DestroyTexturePlatform(ezGALTexture* pTexture)
+{
+  ezGALTextureNull* pNullTexture = static_cast<ezGALTextureNull*>(pTexture);
+  pNullTexture->DeInitPlatform(this);
+  EZ_DELETE(&m_Allocator, pNullTexture);
+}
+
+ezGALResourceView* ezGALDeviceNull::CreateResourceViewPlatform(ezGALResourceBase* pResource, const ezGALResourceViewCreationDescription& Description)
+{
+  ezGALResourceViewNull* pResourceView = EZ_NEW(&m_Allocator, ezGALResourceViewNull, pResource, Description);
+  EZ_VERIFY(pResourceView->InitPlatform(this).Succeeded(), "Null objects can't fail to initialize");
+  return pResourceView;
+}
+
+void ezGALDeviceNull::DestroyResourceViewPlatform(ezGALResourceView* pResourceView)
+{
+  ezGALResourceViewNull* pNullResourceView = static_cast<ezGALResourceViewNull*>(pResourceView);
+  pNullResourceView->DeInitPlatform(this);
+  EZ_DELETE(&m_Allocator, pNullResourceView);
+}
+
+ezGALRenderTargetView* ezGALDeviceNull::CreateRenderTargetViewPlatform(ezGALTexture* pTexture, const ezGALRenderTargetViewCreationDescription& Description)
+{
+  ezGALRenderTargetViewNull* pRTView = EZ_NEW(&m_Allocator, ezGALRenderTargetViewNull, pTexture, Description);
+  EZ_VERIFY(pRTView->InitPlatform(this).Succeeded(), "Null objects can't fail to initialize");
+  return pRTView;
+}
+
+void ezGALDeviceNull::DestroyRenderTargetViewPlatform(ezGALRenderTargetView* pRenderTargetView)
+{
+  ezGALRenderTargetViewNull* pNullRenderTargetView = static_cast<ezGALRenderTargetViewNull*>(pRenderTargetView);
+  pNullRenderTargetView->DeInitPlatform(this);
+  EZ_DELETE(&m_Allocator, pNullRenderTargetView);
+}
+
+ezGALUnorderedAccessView* ezGALDeviceNull::CreateUnorderedAccessViewPlatform(ezGALResourceBase* pResource, const ezGALUnorderedAccessViewCreationDescription& Description)
+{
+  ezGALUnorderedAccessViewNull* pUnorderedAccessView = EZ_NEW(&m_Allocator, ezGALUnorderedAccessViewNull, pResource, Description);
+  EZ_VERIFY(pUnorderedAccessView->InitPlatform(this).Succeeded(), "Null objects can't fail to initialize");
+  return pUnorderedAccessView;
+}
+
+void ezGALDeviceNull::DestroyUnorderedAccessViewPlatform(ezGALUnorderedAccessView* pUnorderedAccessView)
+{
+  ezGALUnorderedAccessViewNull* pNullUnorderedAccessView = static_cast<ezGALUnorderedAccessViewNull*>(pUnorderedAccessView);
+  pNullUnorderedAccessView->DeInitPlatform(this);
+  EZ_DELETE(&m_Allocator, pNullUnorderedAccessView);
+}
+
+
+// Other rendering creation functions
+
+ezGALSwapChain* ezGALDeviceNull::CreateSwapChainPlatform(const ezGALSwapChainCreationDescription& Description)
+{
+  ezGALSwapChainNull* pSwapChain = EZ_NEW(&m_Allocator, ezGALSwapChainNull, Description);
+
+  if (!pSwapChain->InitPlatform(this).Succeeded())
+  {
+    EZ_DELETE(&m_Allocator, pSwapChain);
+    return nullptr;
+  }
+
+  return pSwapChain;
+}
+
+void ezGALDeviceNull::DestroySwapChainPlatform(ezGALSwapChain* pSwapChain)
+{
+  ezGALSwapChainNull* pNullSwapChain = static_cast<ezGALSwapChainNull*>(pSwapChain);
+  pNullSwapChain->DeInitPlatform(this);
+  EZ_DELETE(&m_Allocator, pNullSwapChain);
+}
+
+ezGALFence* ezGALDeviceNull::CreateFencePlatform()
+{
+  ezGALFenceNull* pFence = EZ_NEW(&m_Allocator, ezGALFenceNull);
+  EZ_VERIFY(pFence->InitPlatform(this).Succeeded(), "Null objects can't fail to initialize");
+  return pFence;
+}
+
+void ezGALDeviceNull::DestroyFencePlatform(ezGALFence* pFence)
+{
+  ezGALFenceNull* pNullFence = static_cast<ezGALFenceNull*>(pFence);
+  pNullFence->DeInitPlatform(this);
+  EZ_DELETE(&m_Allocator, pNullFence);
+}
+
+ezGALQuery* ezGALDeviceNull::CreateQueryPlatform(const ezGALQueryCreationDescription& Description)
+{
+  ezGALQueryNull* pQuery = EZ_NEW(&m_Allocator, ezGALQueryNull, Description);
+  EZ_VERIFY(pQuery->InitPlatform(this).Succeeded(), "Null objects can't fail to initialize");
+  return pQuery;
+}
+
+void ezGALDeviceNull::DestroyQueryPlatform(ezGALQuery* pQuery)
+{
+  ezGALQueryNull* pNullQuery = static_cast<ezGALQueryNull*>(pQuery);
+  pNullQuery->DeInitPlatform(this);
+  EZ_DELETE(&m_Allocator, pNullQuery);
+}
+
+ezGALVertexDeclaration* ezGALDeviceNull::CreateVertexDeclarationPlatform(const ezGALVertexDeclarationCreationDescription& Description)
+{
+  ezGALVertexDeclarationNull* pVertexDeclaration = EZ_NEW(&m_Allocator, ezGALVertexDeclarationNull, Description);
+  EZ_VERIFY(pVertexDeclaration->InitPlatform(this).Succeeded(), "Null objects can't fail to initialize");
+  return pVertexDeclaration;
+}
+
+void ezGALDeviceNull::DestroyVertexDeclarationPlatform(ezGALVertexDeclaration* pVertexDeclaration)
+{
+  ezGALVertexDeclarationNull* pNullVertexDeclaration = static_cast<ezGALVertexDeclarationNull*>(pVertexDeclaration);
+  pNullVertexDeclaration->DeInitPlatform(this);
+  EZ_DELETE(&m_Allocator, pNullVertexDeclaration);
+}
+
+
+// Timestamp functions
+
+ezGALTimestampHandle ezGALDeviceNull::GetTimestampPlatform()
+{
+  ezUInt32 uiIndex = m_uiNextTimestamp;
+  m_uiNextTimestamp = (m_uiNextTimestamp + 1) % m_Timestamps.GetCount();
+  return {uiIndex, m_uiFrameCounter};
+}
+
+ezResult ezGALDeviceNull::GetTimestampResultPlatform(ezGALTimestampHandle hTimestamp, ezTime& result)
+{
+  if (hTimestamp.m_uiIndex >= m_Timestamps.GetCount())
+    return EZ_FAILURE;
+
+  result = m_Timestamps[static_cast<ezUInt32>(hTimestamp.m_uiIndex)];
+  return EZ_SUCCESS;
+}
+
+
+// Swap chain functions
+
+void ezGALDeviceNull::PresentPlatform(ezGALSwapChain* pSwapChain, bool bVSync)
+{
+}
+
+
+// Misc functions
+
+void ezGALDeviceNull::BeginFramePlatform()
+{
+  GetNullContext()->Reset();
+}
+
+void ezGALDeviceNull::EndFramePlatform()
+{
+  ++m_uiFrameCounter;
+}
+
+void ezGALDeviceNull::SetPrimarySwapChainPlatform(ezGALSwapChain* pSwapChain)
+{
+}
+
+void ezGALDeviceNull::FillCapabilitiesPlatform()
+{
+  m_Capabilities.m_sAdapterName = "Null Device";
+  m_Capabilities.m_bHardwareAccelerated = false;
+
+  m_Capabilities.m_bMultithreadedResourceCreation = true;
+  m_Capabilities.m_bNoOverwriteBufferUpdate = true;
+
+  for (ezUInt32 i = 0; i < ezGALShaderStage::ENUM_COUNT; ++i)
+  {
+    m_Capabilities.m_bShaderStageSupported[i] = true;
+  }
+
+  m_Capabilities.m_bInstancing = true;
+  m_Capabilities.m_b32BitIndices = true;
+  m_Capabilities.m_bIndirectDraw = true;
+  m_Capabilities.m_bStreamOut = true;
+  m_Capabilities.m_bConservativeRasterization = true;
+  m_Capabilities.m_uiMaxConstantBuffers = EZ_GAL_MAX_CONSTANT_BUFFER_COUNT;
+  m_Capabilities.m_bTextureArrays = true;
+  m_Capabilities.m_bCubemapArrays = true;
+  m_Capabilities.m_bB5G6R5Textures = true;
+  m_Capabilities.m_uiMaxTextureDimension = 16384;
+  m_Capabilities.m_uiMaxCubemapDimension = 16384;
+  m_Capabilities.m_uiMax3DTextureDimension = 2048;
+  m_Capabilities.m_uiMaxAnisotropy = 16;
+  m_Capabilities.m_uiMaxRendertargets = EZ_GAL_MAX_RENDERTARGET_COUNT;
+  m_Capabilities.m_uiUAVCount = 64;
+  m_Capabilities.m_bAlphaToCoverage = true;
+}
+
+
+
+EZ_STATICLINK_FILE(RendererNull, RendererNull_Device_Implementation_DeviceNull);
@@ -0,0 +1,11 @@
+#include <RendererNullPCH.h>
+
+EZ_STATICLINK_LIBRARY(RendererNull)
+{
+  if (bReturn)
+    return;
+
+  EZ_STATICLINK_REFERENCE(RendererNull_Context_Implementation_ContextNull);
+  EZ_STATICLINK_REFERENCE(RendererNull_Device_Implementation_DeviceNull);
+  EZ_STATICLINK_REFERENCE(RendererNull_Resources_Implementation_ResourcesNull);
+}
@@ -0,0 +1,290 @@
+#include <RendererNullPCH.h>
+
+#include <RendererNull/Device/DeviceNull.h>
+#include <RendererNull/Resources/ResourcesNull.h>
+
+// Buffer
+
+ezGALBufferNull::ezGALBufferNull(const ezGALBufferCreationDescription& Description)
+  : ezGALBuffer(Description)
+{
+}
+
+ezGALBufferNull::~ezGALBufferNull() = default;
+
+ezResult ezGALBufferNull::InitPlatform(ezGALDevice* pDevice, ezArrayPtr<const ezUInt8> pInitialData)
+{
+  if (pInitialData.GetCount() > m_Description.m_uiTotalSize)
+  {
+    ezLog::Error("The initial data ({0} bytes) does not fit into the buffer ({1} bytes)", pInitialData.GetCount(), m_Description.m_uiTotalSize);
+    return EZ_FAILURE;
+  }
+
+  m_Data.SetCount(m_Description.m_uiTotalSize);
+  ezMemoryUtils::Copy(m_Data.GetData(), pInitialData.GetPtr(), pInitialData.GetCount());
+
+  return EZ_SUCCESS;
+}
+
+ezResult ezGALBufferNull::DeInitPlatform(ezGALDevice* pDevice)
+{
+  m_Data.Clear();
+  m_Data.Compact();
+
+  return EZ_SUCCESS;
+}
+
+// Texture
+
+ezGALTextureNull::ezGALTextureNull(const ezGALTextureCreationDescription& Description)
+  : ezGALTexture(Description)
+{
+}
+
+ezGALTextureNull::~ezGALTextureNull() = default;
+
+ezResult ezGALTextureNull::InitPlatform(ezGALDevice* pDevice, ezArrayPtr<ezGALSystemMemoryDescription> pInitialData)
+{
+  // nothing ever samples the texture, so the texel data is discarded
+  return EZ_SUCCESS;
+}
+
+ezResult ezGALTextureNull::DeInitPlatform(ezGALDevice* pDevice)
+{
+  return EZ_SUCCESS;
+}
+
+ezResult ezGALTextureNull::ReplaceExisitingNativeObject(void* pExisitingNativeObject)
+{
+  // there is no native object that could be replaced
+  return EZ_SUCCESS;
+}
+
+// Views
+
+ezGALResourceViewNull::ezGALResourceViewNull(ezGALResourceBase* pResource, const ezGALResourceViewCreationDescription& Description)
+  : ezGALResourceView(pResource, Description)
+{
+}
+
+ezGALResourceViewNull::~ezGALResourceViewNull() = default;
+
+ezResult ezGALResourceViewNull::InitPlatform(ezGALDevice* pDevice)
+{
+  return EZ_SUCCESS;
+}
+
+ezResult ezGALResourceViewNull::DeInitPlatform(ezGALDevice* pDevice)
+{
+  return EZ_SUCCESS;
+}
+
+ezGALRenderTargetViewNull::ezGALRenderTargetViewNull(ezGALTexture* pTexture, const ezGALRenderTargetViewCreationDescription& Description)
+  : ezGALRenderTargetView(pTexture, Description)
+{
+}
+
+ezGALRenderTargetViewNull::~ezGALRenderTargetViewNull() = default;
+
+ezResult ezGALRenderTargetViewNull::InitPlatform(ezGALDevice* pDevice)
+{
+  return EZ_SUCCESS;
+}
+
+ezResult ezGALRenderTargetViewNull::DeInitPlatform(ezGALDevice* pDevice)
+{
+  return EZ_SUCCESS;
+}
+
+ezGALUnorderedAccessViewNull::ezGALUnorderedAccessViewNull(ezGALResourceBase* pResource, const ezGALUnorderedAccessViewCreationDescription& Description)
+  : ezGALUnorderedAccessView(pResource, Description)
+{
+}
+
+ezGALUnorderedAccessViewNull::~ezGALUnorderedAccessViewNull() = default;
+
+ezResult ezGALUnorderedAccessViewNull::InitPlatform(ezGALDevice* pDevice)
+{
+  return EZ_SUCCESS;
+}
+
+ezResult ezGALUnorderedAccessViewNull::DeInitPlatform(ezGALDevice* pDevice)
+{
+  return EZ_SUCCESS;
+}
+
+// Fence & Query
+
+ezGALFenceNull::ezGALFenceNull() = default;
+
+ezGALFenceNull::~ezGALFenceNull() = default;
+
+ezResult ezGALFenceNull::InitPlatform(ezGALDevice* pDevice)
+{
+  return EZ_SUCCESS;
+}
+
+ezResult ezGALFenceNull::DeInitPlatform(ezGALDevice* pDevice)
+{
+  return EZ_SUCCESS;
+}
+
+ezGALQueryNull::ezGALQueryNull(const ezGALQueryCreationDescription& Description)
+  : ezGALQuery(Description)
+{
+}
+
+ezGALQueryNull::~ezGALQueryNull() = default;
+
+ezResult ezGALQueryNull::InitPlatform(ezGALDevice* pDevice)
+{
+  return EZ_SUCCESS;
+}
+
+ezResult ezGALQueryNull::DeInitPlatform(ezGALDevice* pDevice)
+{
+  return EZ_SUCCESS;
+}
+
+// Shader
+
+ezGALShaderNull::ezGALShaderNull(const ezGALShaderCreationDescription& Description)
+  : ezGALShader(Description)
+{
+}
+
+ezGALShaderNull::~ezGALShaderNull() = default;
+
+ezResult ezGALShaderNull::InitPlatform(ezGALDevice* pDevice)
+{
+  return EZ_SUCCESS;
+}
+
+ezResult ezGALShaderNull::DeInitPlatform(ezGALDevice* pDevice)
+{
+  return EZ_SUCCESS;
+}
+
+ezGALVertexDeclarationNull::ezGALVertexDeclarationNull(const ezGALVertexDeclarationCreationDescription& Description)
+  : ezGALVertexDeclaration(Description)
+{
+}
+
+ezGALVertexDeclarationNull::~ezGALVertexDeclarationNull() = default;
+
+ezResult ezGALVertexDeclarationNull::InitPlatform(ezGALDevice* pDevice)
+{
+  return EZ_SUCCESS;
+}
+
+ezResult ezGALVertexDeclarationNull::DeInitPlatform(ezGALDevice* pDevice)
+{
+  return EZ_SUCCESS;
+}
+
+// States
+
+ezGALBlendStateNull::ezGALBlendStateNull(const ezGALBlendStateCreationDescription& Description)
+  : ezGALBlendState(Description)
+{
+}
+
+ezGALBlendStateNull::~ezGALBlendStateNull() = default;
+
+ezResult ezGALBlendStateNull::InitPlatform(ezGALDevice* pDevice)
+{
+  return EZ_SUCCESS;
+}
+
+ezResult ezGALBlendStateNull::DeInitPlatform(ezGALDevice* pDevice)
+{
+  return EZ_SUCCESS;
+}
+
+ezGALDepthStencilStateNull::ezGALDepthStencilStateNull(const ezGALDepthStencilStateCreationDescription& Description)
+  : ezGALDepthStencilState(Description)
+{
+}
+
+ezGALDepthStencilStateNull::~ezGALDepthStencilStateNull() = default;
+
+ezResult ezGALDepthStencilStateNull::InitPlatform(ezGALDevice* pDevice)
+{
+  return EZ_SUCCESS;
+}
+
+ezResult ezGALDepthStencilStateNull::DeInitPlatform(ezGALDevice* pDevice)
+{
+  return EZ_SUCCESS;
+}
+
+ezGALRasterizerStateNull::ezGALRasterizerStateNull(const ezGALRasterizerStateCreationDescription& Description)
+  : ezGALRasterizerState(Description)
+{
+}
+
+ezGALRasterizerStateNull::~ezGALRasterizerStateNull() = default;
+
+ezResult ezGALRasterizerStateNull::InitPlatform(ezGALDevice* pDevice)
+{
+  return EZ_SUCCESS;
+}
+
+ezResult ezGALRasterizerStateNull::DeInitPlatform(ezGALDevice* pDevice)
+{
+  return EZ_SUCCESS;
+}
+
+ezGALSamplerStateNull::ezGALSamplerStateNull(const ezGALSamplerStateCreationDescription& Description)
+  : ezGALSamplerState(Description)
+{
+}
+
+ezGALSamplerStateNull::~ezGALSamplerStateNull() = default;
+
+ezResult ezGALSamplerStateNull::InitPlatform(ezGALDevice* pDevice)
+{
+  return EZ_SUCCESS;
+}
+
+ezResult ezGALSamplerStateNull::DeInitPlatform(ezGALDevice* pDevice)
+{
+  return EZ_SUCCESS;
+}
+
+// Swap chain
+
+ezGALSwapChainNull::ezGALSwapChainNull(const ezGALSwapChainCreationDescription& Description)
+  : ezGALSwapChain(Description)
+{
+}
+
+ezGALSwapChainNull::~ezGALSwapChainNull() = default;
+
+ezResult ezGALSwapChainNull::InitPlatform(ezGALDevice* pDevice)
+{
+  ezGALDeviceNull* pNullDevice = static_cast<ezGALDeviceNull*>(pDevice);
+
+  ezGALTextureCreationDescription TexDesc;
+  TexDesc.m_uiWidth = pNullDevice->GetBackBufferSize().width;
+  TexDesc.m_uiHeight = pNullDevice->GetBackBufferSize().height;
+  TexDesc.m_SampleCount = m_Description.m_SampleCount;
+  TexDesc.m_Format = m_Description.m_BackBufferFormat;
+  TexDesc.m_bAllowShaderResourceView = false;
+  TexDesc.m_bCreateRenderTarget = true;
+  TexDesc.m_ResourceAccess.m_bImmutable = true;
+  TexDesc.m_ResourceAccess.m_bReadBack = m_Description.m_bAllowScreenshots;
+
+  m_hBackBufferTexture = pDevice->CreateTexture(TexDesc);
+  if (m_hBackBufferTexture.IsInvalidated())
+  {
+    ezLog::Error("Couldn't create back buffer texture of the null swap chain");
+    return EZ_FAILURE;
+  }
+
+  return EZ_SUCCESS;
+}
+
+
+
+EZ_STATICLINK_FILE(RendererNull, RendererNull_Resources_Implementation_ResourcesNull);
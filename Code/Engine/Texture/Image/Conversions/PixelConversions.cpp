@@ -34,6 +34,74 @@ namespace
     } p;
     ezUInt32 v;
   };
+
+  /// \brief Lookup tables for the conversion between RGBA8 sRGB and RGBA32 float.
+  ///
+  /// The tables are filled through ezColor and ezColorGammaUB, so using them gives exactly the same results as converting every pixel
+  /// through those types, just without evaluating the gamma curve for every channel.
+  struct SrgbConversionTables
+  {
+    SrgbConversionTables()
+    {
+      for (ezUInt32 i = 0; i < 256; ++i)
+      {
+        const ezUInt8 value = static_cast<ezUInt8>(i);
+        const ezColor linear = ezColorGammaUB(value, value, value, value);
+
+        m_GammaToLinear[i] = linear.r;
+        m_ByteToFloat[i] = linear.a;
+      }
+
+      // m_LinearToGammaThresholds[i] is the smallest linear value that is converted to i or above.
+      // The gamma curve is monotonic, so the thresholds can be found with a binary search over the bit patterns of all positive floats.
+      m_LinearToGammaThresholds[0] = -ezMath::Infinity<float>();
+
+      for (ezUInt32 i = 1; i < 256; ++i)
+      {
+        ezIntFloatUnion lower(0.0f);
+        ezIntFloatUnion upper(1.0f);
+
+        while (lower.i < upper.i)
+        {
+          const ezIntFloatUnion middle(lower.i + (upper.i - lower.i) / 2);
+
+          if (LinearToGammaByte(middle.f) >= i)
+            upper.i = middle.i;
+          else
+            lower.i = middle.i + 1;
+        }
+
+        m_LinearToGammaThresholds[i] = upper.f;
+      }
+    }
+
+    static ezUInt8 LinearToGammaByte(float linear) { return ezColorGammaUB(ezColor(linear, linear, linear, 1.0f)).r; }
+
+    EZ_ALWAYS_INLINE ezUInt8 LinearToGamma(float linear) const
+    {
+      // NaN fails all comparisons and ends up as zero, just like in ezMath::ColorFloatToByte()
+      ezUInt32 index = 0;
+      index += (linear >= m_LinearToGammaThresholds[index + 128]) ? 128 : 0;
+      index += (linear >= m_LinearToGammaThresholds[index + 64]) ? 64 : 0;
+      index += (linear >= m_LinearToGammaThresholds[index + 32]) ? 32 : 0;
+      index += (linear >= m_LinearToGammaThresholds[index + 16]) ? 16 : 0;
+      index += (linear >= m_LinearToGammaThresholds[index + 8]) ? 8 : 0;
+      index += (linear >= m_LinearToGammaThresholds[index + 4]) ? 4 : 0;
+      index += (linear >= m_LinearToGammaThresholds[index + 2]) ? 2 : 0;
+      index += (linear >= m_LinearToGammaThresholds[index + 1]) ? 1 : 0;
+      return static_cast<ezUInt8>(index);
+    }
+
+    float m_GammaToLinear[256];
+    float m_ByteToFloat[256];
+    float m_LinearToGammaThresholds[256];
+  };
+
+  const SrgbConversionTables& GetSrgbConversionTables()
+  {
+    static SrgbConversionTables s_Tables;
+    return s_Tables;
+  }
 } // namespace
 
 ezColorBaseUB ezDecompressA4B4G4R4(ezUInt16 uiColor)
@@ -523,9 +591,17 @@ public:
     const void* sourcePointer = source.GetPtr();
     void* targetPointer = target.GetPtr();
 
+    const SrgbConversionTables& tables = GetSrgbConversionTables();
+
     while (numElements)
     {
-      *reinterpret_cast<ezColorGammaUB*>(targetPointer) = *reinterpret_cast<const ezColor*>(sourcePointer);
+      const ezColor& sourceColor = *reinterpret_cast<const ezColor*>(sourcePointer);
+      ezColorGammaUB& targetColor = *reinterpret_cast<ezColorGammaUB*>(targetPointer);
+
+      targetColor.r = tables.LinearToGamma(sourceColor.r);
+      targetColor.g = tables.LinearToGamma(sourceColor.g);
+      targetColor.b = tables.LinearToGamma(sourceColor.b);
+      targetColor.a = ezMath::ColorFloatToByte(sourceColor.a);
 
       sourcePointer = ezMemoryUtils::AddByteOffset(sourcePointer, sourceStride);
       targetPointer = ezMemoryUtils::AddByteOffset(targetPointer, targetStride);
@@ -681,6 +757,38 @@ public:
     const void* sourcePointer = source.GetPtr();
     void* targetPointer = target.GetPtr();
 
+#if EZ_SIMD_IMPLEMENTATION == EZ_SIMD_IMPLEMENTATION_SSE && EZ_SSE_LEVEL >= EZ_SSE_20
+    {
+      const ezUInt32 elementsPerBatch = 16;
+
+      __m128i zero = _mm_setzero_si128();
+      __m128 scale = _mm_set1_ps(1.0f / 255.0f);
+
+      while (numElements >= elementsPerBatch)
+      {
+        __m128i bytes = _mm_loadu_si128(static_cast<const __m128i*>(sourcePointer));
+
+        __m128i short0 = _mm_unpacklo_epi8(bytes, zero);
+        __m128i short1 = _mm_unpackhi_epi8(bytes, zero);
+
+        __m128 float0 = _mm_cvtepi32_ps(_mm_unpacklo_epi16(short0, zero));
+        __m128 float1 = _mm_cvtepi32_ps(_mm_unpackhi_epi16(short0, zero));
+        __m128 float2 = _mm_cvtepi32_ps(_mm_unpacklo_epi16(short1, zero));
+        __m128 float3 = _mm_cvtepi32_ps(_mm_unpackhi_epi16(short1, zero));
+
+        // Same as ezMath::ColorByteToFloat
+        _mm_storeu_ps(static_cast<float*>(targetPointer) + 0, _mm_mul_ps(float0, scale));
+        _mm_storeu_ps(static_cast<float*>(targetPointer) + 4, _mm_mul_ps(float1, scale));
+        _mm_storeu_ps(static_cast<float*>(targetPointer) + 8, _mm_mul_ps(float2, scale));
+        _mm_storeu_ps(static_cast<float*>(targetPointer) + 12, _mm_mul_ps(float3, scale));
+
+        sourcePointer = ezMemoryUtils::AddByteOffset(sourcePointer, sourceStride * elementsPerBatch);
+        targetPointer = ezMemoryUtils::AddByteOffset(targetPointer, targetStride * elementsPerBatch);
+        numElements -= elementsPerBatch;
+      }
+    }
+#endif
+
     while (numElements)
     {
       *reinterpret_cast<float*>(targetPointer) = ezMath::ColorByteToFloat(*reinterpret_cast<const ezUInt8*>(sourcePointer));
@@ -714,9 +822,17 @@ public:
     const void* sourcePointer = source.GetPtr();
     void* targetPointer = target.GetPtr();
 
+    const SrgbConversionTables& tables = GetSrgbConversionTables();
+
     while (numElements)
     {
-      *reinterpret_cast<ezColor*>(targetPointer) = *reinterpret_cast<const ezColorGammaUB*>(sourcePointer);
+      const ezColorGammaUB& sourceColor = *reinterpret_cast<const ezColorGammaUB*>(sourcePointer);
+      ezColor& targetColor = *reinterpret_cast<ezColor*>(targetPointer);
+
+      targetColor.r = tables.m_GammaToLinear[sourceColor.r];
+      targetColor.g = tables.m_GammaToLinear[sourceColor.g];
+      targetColor.b = tables.m_GammaToLinear[sourceColor.b];
+      targetColor.a = tables.m_ByteToFloat[sourceColor.a];
 
       sourcePointer = ezMemoryUtils::AddByteOffset(sourcePointer, sourceStride);
       targetPointer = ezMemoryUtils::AddByteOffset(targetPointer, targetStride);
@@ -2,6 +2,8 @@
 
 #include <Foundation/Containers/HashTable.h>
 #include <Foundation/Math/Math.h>
+#include <Foundation/Threading/AtomicInteger.h>
+#include <Foundation/Threading/TaskSystem.h>
 
 #include <Texture/Image/ImageConversion.h>
 
@@ -140,6 +142,87 @@ namespace
       return scratchBuffers.GetCount() - 1;
     }
   }
+
+  // Uncompressed conversions are split into batches of this many pixels, which are distributed over the task system.
+  // A multiple of 8 pixels always starts at a full byte, independent of the format.
+  constexpr ezUInt32 s_uiPixelsPerBatch = 16 * 1024;
+
+  // Images with fewer pixels than this are converted on the calling thread, since the task overhead would outweigh the gain.
+  constexpr ezUInt32 s_uiMinPixelsPerTask = 64 * 1024;
+
+  struct LinearConversion
+  {
+    const ezImageConversionStepLinear* m_pStep;
+    ezConstByteBlobPtr m_Source;
+    ezByteBlobPtr m_Target;
+    ezUInt64 m_uiNumElements;
+    ezImageFormat::Enum m_SourceFormat;
+    ezImageFormat::Enum m_TargetFormat;
+    ezAtomicInteger32 m_iNumFailedBatches;
+
+    void ConvertBatches(ezUInt32 uiFirstBatch, ezUInt32 uiEndBatch)
+    {
+      const ezUInt64 uiFirstElement = ezUInt64(uiFirstBatch) * s_uiPixelsPerBatch;
+      const ezUInt64 uiNumElements = ezMath::Min(ezUInt64(uiEndBatch) * s_uiPixelsPerBatch, m_uiNumElements) - uiFirstElement;
+
+      const ezUInt64 uiSourceBpp = ezImageFormat::GetBitsPerPixel(m_SourceFormat);
+      const ezUInt64 uiTargetBpp = ezImageFormat::GetBitsPerPixel(m_TargetFormat);
+
+      ezConstByteBlobPtr source = m_Source.GetSubArray(uiFirstElement * uiSourceBpp / 8, uiNumElements * uiSourceBpp / 8);
+      ezByteBlobPtr target = m_Target.GetSubArray(uiFirstElement * uiTargetBpp / 8, uiNumElements * uiTargetBpp / 8);
+
+      if (m_pStep->ConvertPixels(source, target, uiNumElements, m_SourceFormat, m_TargetFormat).Failed())
+      {
+        m_iNumFailedBatches.Increment();
+      }
+    }
+  };
+
+  ezResult ConvertPixelsParallel(const ezImageConversionStepLinear* pStep, ezConstByteBlobPtr source, ezByteBlobPtr target,
+    ezUInt64 numElements, ezImageFormat::Enum sourceFormat, ezImageFormat::Enum targetFormat)
+  {
+    const ezUInt64 sourceSize = numElements * ezImageFormat::GetBitsPerPixel(sourceFormat) / 8;
+    const ezUInt64 targetSize = numElements * ezImageFormat::GetBitsPerPixel(targetFormat) / 8;
+
+    const ezUInt8* sourceBegin = source.GetPtr();
+    const ezUInt8* targetBegin = target.GetPtr();
+
+    // An in-place conversion that changes the size of the pixels has to run front to back, splitting it up would overwrite pixels
+    // that weren't converted yet.
+    const bool bOverlapping = sourceBegin < targetBegin + targetSize && targetBegin < sourceBegin + sourceSize;
+
+    if (numElements < s_uiMinPixelsPerTask || (bOverlapping && (sourceBegin != targetBegin || sourceSize != targetSize)))
+    {
+      return pStep->ConvertPixels(source, target, numElements, sourceFormat, targetFormat);
+    }
+
+    LinearConversion conversion;
+    conversion.m_pStep = pStep;
+    conversion.m_Source = source;
+    conversion.m_Target = target;
+    conversion.m_uiNumElements = numElements;
+    conversion.m_SourceFormat = sourceFormat;
+    conversion.m_TargetFormat = targetFormat;
+
+    ezParallelForParams params;
+    params.uiBinSize = s_uiMinPixelsPerTask / s_uiPixelsPerBatch;
+
+    const ezUInt32 uiNumBatches = static_cast<ezUInt32>((numElements + s_uiPixelsPerBatch - 1) / s_uiPixelsPerBatch);
+
+    ezTaskSystem::ParallelForIndexed(
+      0, uiNumBatches, [&conversion](ezUInt32 uiStartIndex, ezUInt32 uiEndIndex) { conversion.ConvertBatches(uiStartIndex, uiEndIndex); },
+      "ConvertPixels", params);
+
+    return conversion.m_iNumFailedBatches == 0 ? EZ_SUCCESS : EZ_FAILURE;
+  }
+
+  // Returns the parallel for parameters to process the block rows of an image with the given number of pixels per block row.
+  ezParallelForParams GetBlockRowParallelForParams(ezUInt32 uiPixelsPerBlockRow)
+  {
+    ezParallelForParams params;
+    params.uiBinSize = ezMath::Max(1u, s_uiMinPixelsPerTask / ezMath::Max(1u, uiPixelsPerBlockRow));
+    return params;
+  }
 } // namespace
 
 ezImageConversionStep::ezImageConversionStep()
@@ -489,9 +572,9 @@ ezResult ezImageConversion::ConvertRaw(ezConstByteBlobPtr source, ezByteBlobPtr
     }
     else
     {
-      if (static_cast<const ezImageConversionStepLinear*>(path[i].m_step)
-              ->ConvertPixels(source, stepTarget, numElements, path[i].m_sourceFormat, path[i].m_targetFormat)
-              .Failed())
+      if (ConvertPixelsParallel(static_cast<const ezImageConversionStepLinear*>(path[i].m_step), source, stepTarget, numElements,
+            path[i].m_sourceFormat, path[i].m_targetFormat)
+            .Failed())
       {
         return EZ_FAILURE;
       }
@@ -525,8 +608,8 @@ ezResult ezImageConversion::ConvertSingleStep(const ezImageConversionStep* pStep
       // we have to do the computation in 64-bit otherwise it might overflow for very large textures (8k x 4k or bigger).
       ezUInt64 numElements =
           ezUInt64(8) * target.GetByteBlobPtr().GetCount() / (ezUInt64)ezImageFormat::GetBitsPerPixel(targetFormat);
-      return static_cast<const ezImageConversionStepLinear*>(pStep)->ConvertPixels(source.GetByteBlobPtr(), target.GetByteBlobPtr(),
-                                                                                   (ezUInt32)numElements, sourceFormat, targetFormat);
+      return ConvertPixelsParallel(static_cast<const ezImageConversionStepLinear*>(pStep), source.GetByteBlobPtr(), target.GetByteBlobPtr(),
+        numElements, sourceFormat, targetFormat);
     }
     else
     {
@@ -560,40 +643,56 @@ ezResult ezImageConversion::ConvertSingleStepDecompress(const ezImageView& sourc
         const ezUInt64 targetRowPitch = target.GetRowPitch(mipLevel);
         const ezUInt32 targetBytesPerPixel = ezImageFormat::GetBitsPerPixel(targetFormat) / 8;
 
-        // Decompress into a temp memory block so we don't have to explicitly handle the case where the image is not a multiple of the block
-        // size
-        ezHybridArray<ezUInt8, 256> tempBuffer;
-        tempBuffer.SetCount(numBlocksX * blockSizeX * blockSizeY * targetBytesPerPixel);
+        const ezImageConversionStepDecompressBlocks* pDecompressStep = static_cast<const ezImageConversionStepDecompressBlocks*>(pStep);
 
         for (ezUInt32 slice = 0; slice < source.GetDepth(mipLevel); slice++)
         {
-          for (ezUInt32 blockY = 0; blockY < numBlocksY; blockY++)
-          {
-            ezImageView sourceRowView = source.GetRowView(mipLevel, face, arrayIndex, blockY, slice);
+          ezAtomicInteger32 numFailedRows;
 
-            if (static_cast<const ezImageConversionStepDecompressBlocks*>(pStep)
-                    ->DecompressBlocks(sourceRowView.GetByteBlobPtr(), ezByteBlobPtr(tempBuffer.GetData(), tempBuffer.GetCount()),
-                                       numBlocksX, sourceFormat, targetFormat)
-                    .Failed())
-            {
-              return EZ_FAILURE;
-            }
+          // every block row is decompressed independently, so they can be distributed over the task system
+          auto decompressRows = [&](ezUInt32 uiFirstBlockY, ezUInt32 uiEndBlockY) {
+            // Decompress into a temp memory block so we don't have to explicitly handle the case where the image is not a multiple of the
+            // block size
+            ezHybridArray<ezUInt8, 256> tempBuffer;
+            tempBuffer.SetCount(numBlocksX * blockSizeX * blockSizeY * targetBytesPerPixel);
 
-            for (ezUInt32 blockX = 0; blockX < numBlocksX; blockX++)
+            for (ezUInt32 blockY = uiFirstBlockY; blockY < uiEndBlockY; blockY++)
             {
-              ezUInt8* targetPointer =
-                  target.GetPixelPointer<ezUInt8>(mipLevel, face, arrayIndex, blockX * blockSizeX, blockY * blockSizeY, slice);
+              ezImageView sourceRowView = source.GetRowView(mipLevel, face, arrayIndex, blockY, slice);
 
-              // Copy into actual target, clamping to image dimensions
-              ezUInt32 copyWidth = ezMath::Min(blockSizeX, width - blockX * blockSizeX);
-              ezUInt32 copyHeight = ezMath::Min(blockSizeY, height - blockY * blockSizeY);
-              for (ezUInt32 row = 0; row < copyHeight; row++)
+              if (pDecompressStep
+                    ->DecompressBlocks(sourceRowView.GetByteBlobPtr(), ezByteBlobPtr(tempBuffer.GetData(), tempBuffer.GetCount()), numBlocksX,
+                      sourceFormat, targetFormat)
+                    .Failed())
               {
-                memcpy(targetPointer, &tempBuffer[(blockX * blockSizeX + row) * blockSizeY * targetBytesPerPixel],
-                       ezMath::SafeMultiply32(copyWidth, targetBytesPerPixel));
-                targetPointer += targetRowPitch;
+                numFailedRows.Increment();
+                return;
+              }
+
+              for (ezUInt32 blockX = 0; blockX < numBlocksX; blockX++)
+              {
+                ezUInt8* targetPointer =
+                  target.GetPixelPointer<ezUInt8>(mipLevel, face, arrayIndex, blockX * blockSizeX, blockY * blockSizeY, slice);
+
+                // Copy into actual target, clamping to image dimensions
+                ezUInt32 copyWidth = ezMath::Min(blockSizeX, width - blockX * blockSizeX);
+                ezUInt32 copyHeight = ezMath::Min(blockSizeY, height - blockY * blockSizeY);
+                for (ezUInt32 row = 0; row < copyHeight; row++)
+                {
+                  memcpy(targetPointer, &tempBuffer[(blockX * blockSizeX + row) * blockSizeY * targetBytesPerPixel],
+                    ezMath::SafeMultiply32(copyWidth, targetBytesPerPixel));
+                  targetPointer += targetRowPitch;
+                }
               }
             }
+          };
+
+          ezTaskSystem::ParallelForIndexed(
+            0, numBlocksY, decompressRows, "DecompressBlocks", GetBlockRowParallelForParams(numBlocksX * blockSizeX * blockSizeY));
+
+          if (numFailedRows > 0)
+          {
+            return EZ_FAILURE;
           }
         }
       }
@@ -649,6 +748,8 @@ ezResult ezImageConversion::ConvertSingleStepCompress(const ezImageView& source,
             }
           }
 
+          // not split into bands like the other conversions, the compressors are already multi-threaded (DirectXTex uses OpenMP
+          // on the CPU and serializes access to the GPU), additional tasks would only oversubscribe the cores
           ezResult result = static_cast<const ezImageConversionStepCompressBlocks*>(pStep)->CompressBlocks(
               paddedSlice.GetByteBlobPtr(), target.GetSliceView(mipLevel, face, arrayIndex, slice).GetByteBlobPtr(), numBlocksX, numBlocksY,
               sourceFormat, targetFormat);
@@ -3,6 +3,7 @@
 #include <Texture/Image/ImageUtils.h>
 
 #include <Foundation/SimdMath/SimdVec4f.h>
+#include <Foundation/Threading/TaskSystem.h>
 #include <Texture/Image/ImageConversion.h>
 #include <Texture/Image/ImageEnums.h>
 #include <Texture/Image/ImageFilter.h>
@@ -648,6 +649,36 @@ inline static void FilterLine(ezUInt32 numSourceElements, const ezSimdVec4f* __r
   }
 }
 
+// Filtering is a lot more expensive per pixel than a format conversion, so smaller images are already worth distributing.
+static constexpr ezUInt32 s_uiMinFilteredPixelsPerTask = 16 * 1024;
+
+using FilterLineFunction = ezDelegate<void(ezUInt32 arrayIndex, ezUInt32 face, ezUInt32 outer, ezUInt32 inner), 48>;
+
+/// \brief Calls \a func for all lines of a filter pass. The lines don't depend on each other, so large images are filtered in parallel.
+static void FilterLines(ezUInt32 numArrayElements, ezUInt32 numFaces, ezUInt32 numOuter, ezUInt32 numInner, ezUInt32 numPixelsPerLine,
+  const FilterLineFunction& func)
+{
+  const ezUInt32 numLines = numArrayElements * numFaces * numOuter * numInner;
+
+  ezParallelForParams params;
+  params.uiBinSize = ezMath::Max(1u, s_uiMinFilteredPixelsPerTask / ezMath::Max(1u, numPixelsPerLine));
+
+  ezTaskSystem::ParallelForIndexed(
+    0, numLines,
+    [&](ezUInt32 uiStartLine, ezUInt32 uiEndLine) {
+      for (ezUInt32 line = uiStartLine; line < uiEndLine; ++line)
+      {
+        const ezUInt32 inner = line % numInner;
+        const ezUInt32 outer = (line / numInner) % numOuter;
+        const ezUInt32 face = (line / (numInner * numOuter)) % numFaces;
+        const ezUInt32 arrayIndex = line / (numInner * numOuter * numFaces);
+
+        func(arrayIndex, face, outer, inner);
+      }
+    },
+    "FilterLines", params);
+}
+
 static void DownScaleFastLine(
   ezUInt32 pixelStride, const ezUInt8* src, ezUInt8* dest, ezUInt32 lengthIn, ezUInt32 strideIn, ezUInt32 lengthOut, ezUInt32 strideOut)
 {
@@ -938,22 +969,13 @@ ezResult ezImageUtils::Scale3D(const ezImageView& source, ezImage& target, ezUIn
     stepHeader.SetWidth(width);
     stepTarget->ResetAndAlloc(stepHeader);
 
-    for (ezUInt32 arrayIndex = 0; arrayIndex < numArrayElements; ++arrayIndex)
-    {
-      for (ezUInt32 face = 0; face < numFaces; ++face)
-      {
-        for (ezUInt32 z = 0; z < originalDepth; ++z)
-        {
-          for (ezUInt32 y = 0; y < originalHeight; ++y)
-          {
-            const ezSimdVec4f* filterSource = stepSource->GetPixelPointer<ezSimdVec4f>(0, face, arrayIndex, 0, y, z);
-            ezSimdVec4f* filterTarget = stepTarget->GetPixelPointer<ezSimdVec4f>(0, face, arrayIndex, 0, y, z);
-            FilterLine(originalWidth, filterSource, filterTarget, 1, weights, firstSampleIndices, addressModeU,
-              ezSimdVec4f(borderColor.r, borderColor.g, borderColor.b, borderColor.a));
-          }
-        }
-      }
-    }
+    FilterLines(numArrayElements, numFaces, originalDepth, originalHeight, originalWidth,
+      [&](ezUInt32 arrayIndex, ezUInt32 face, ezUInt32 z, ezUInt32 y) {
+        const ezSimdVec4f* filterSource = stepSource->GetPixelPointer<ezSimdVec4f>(0, face, arrayIndex, 0, y, z);
+        ezSimdVec4f* filterTarget = stepTarget->GetPixelPointer<ezSimdVec4f>(0, face, arrayIndex, 0, y, z);
+        FilterLine(originalWidth, filterSource, filterTarget, 1, weights, firstSampleIndices, addressModeU,
+          ezSimdVec4f(borderColor.r, borderColor.g, borderColor.b, borderColor.a));
+      });
 
     releaseScratch(*stepSource);
     stepSource = stepTarget;
@@ -982,22 +1004,13 @@ ezResult ezImageUtils::Scale3D(const ezImageView& source, ezImage& target, ezUIn
     stepHeader.SetHeight(height);
     stepTarget->ResetAndAlloc(stepHeader);
 
-    for (ezUInt32 arrayIndex = 0; arrayIndex < numArrayElements; ++arrayIndex)
-    {
-      for (ezUInt32 face = 0; face < numFaces; ++face)
-      {
-        for (ezUInt32 z = 0; z < originalDepth; ++z)
-        {
-          for (ezUInt32 x = 0; x < width; ++x)
-          {
-            const ezSimdVec4f* filterSource = stepSource->GetPixelPointer<ezSimdVec4f>(0, face, arrayIndex, x, 0, z);
-            ezSimdVec4f* filterTarget = stepTarget->GetPixelPointer<ezSimdVec4f>(0, face, arrayIndex, x, 0, z);
-            FilterLine(originalHeight, filterSource, filterTarget, width, weights, firstSampleIndices, addressModeV,
-              ezSimdVec4f(borderColor.r, borderColor.g, borderColor.b, borderColor.a));
-          }
-        }
-      }
-    }
+    FilterLines(numArrayElements, numFaces, originalDepth, width, originalHeight,
+      [&](ezUInt32 arrayIndex, ezUInt32 face, ezUInt32 z, ezUInt32 x) {
+        const ezSimdVec4f* filterSource = stepSource->GetPixelPointer<ezSimdVec4f>(0, face, arrayIndex, x, 0, z);
+        ezSimdVec4f* filterTarget = stepTarget->GetPixelPointer<ezSimdVec4f>(0, face, arrayIndex, x, 0, z);
+        FilterLine(originalHeight, filterSource, filterTarget, width, weights, firstSampleIndices, addressModeV,
+          ezSimdVec4f(borderColor.r, borderColor.g, borderColor.b, borderColor.a));
+      });
 
     releaseScratch(*stepSource);
     stepSource = stepTarget;
@@ -1026,22 +1039,13 @@ ezResult ezImageUtils::Scale3D(const ezImageView& source, ezImage& target, ezUIn
     stepHeader.SetDepth(depth);
     stepTarget->ResetAndAlloc(stepHeader);
 
-    for (ezUInt32 arrayIndex = 0; arrayIndex < numArrayElements; ++arrayIndex)
-    {
-      for (ezUInt32 face = 0; face < numFaces; ++face)
-      {
-        for (ezUInt32 y = 0; y < height; ++y)
-        {
-          for (ezUInt32 x = 0; x < width; ++x)
-          {
-            const ezSimdVec4f* filterSource = stepSource->GetPixelPointer<ezSimdVec4f>(0, face, arrayIndex, x, y, 0);
-            ezSimdVec4f* filterTarget = stepTarget->GetPixelPointer<ezSimdVec4f>(0, face, arrayIndex, x, y, 0);
-            FilterLine(originalHeight, filterSource, filterTarget, width * height, weights, firstSampleIndices, addressModeW,
-              ezSimdVec4f(borderColor.r, borderColor.g, borderColor.b, borderColor.a));
-          }
-        }
-      }
-    }
+    FilterLines(numArrayElements, numFaces, height, width, originalDepth,
+      [&](ezUInt32 arrayIndex, ezUInt32 face, ezUInt32 y, ezUInt32 x) {
+        const ezSimdVec4f* filterSource = stepSource->GetPixelPointer<ezSimdVec4f>(0, face, arrayIndex, x, y, 0);
+        ezSimdVec4f* filterTarget = stepTarget->GetPixelPointer<ezSimdVec4f>(0, face, arrayIndex, x, y, 0);
+        FilterLine(originalDepth, filterSource, filterTarget, width * height, weights, firstSampleIndices, addressModeW,
+          ezSimdVec4f(borderColor.r, borderColor.g, borderColor.b, borderColor.a));
+      });
 
     releaseScratch(*stepSource);
     stepSource = stepTarget;
@@ -1,23 +1,33 @@
 #include <TexturePCH.h>
 
 #include <Foundation/IO/Stream.h>
+#include <Foundation/Logging/Log.h>
+#include <Texture/Image/Image.h>
 #include <Texture/ezTexFormat/ezTexFormat.h>
 
 void ezTexFormat::WriteTextureHeader(ezStreamWriter& stream) const
 {
-  ezUInt8 uiFileFormatVersion = 2;
-  stream << uiFileFormatVersion;
-
-  stream << m_bSRGB;
-  stream << m_AddressModeU;
-  stream << m_AddressModeV;
-  stream << m_AddressModeW;
-  stream << m_TextureFilter;
+  if (!m_bStreamableMipLevels)
+  {
+    ezUInt8 uiFileFormatVersion = 2;
+    stream << uiFileFormatVersion;
+
+    stream << m_bSRGB;
+    stream << m_AddressModeU;
+    stream << m_AddressModeV;
+    stream << m_AddressModeW;
+    stream << m_TextureFilter;
+  }
+  else
+  {
+    // the streamable layout was added in version 6, so all render target values need to be written as well
+    WriteRenderTargetHeader(stream);
+  }
 }
 
 void ezTexFormat::WriteRenderTargetHeader(ezStreamWriter& stream) const
 {
-  ezUInt8 uiFileFormatVersion = 5;
+  ezUInt8 uiFileFormatVersion = 6;
   stream << uiFileFormatVersion;
 
   // version 2
@@ -36,6 +46,9 @@ void ezTexFormat::WriteRenderTargetHeader(ezStreamWriter& stream) const
 
   // version 5
   stream << m_GalRenderTargetFormat;
+
+  // version 6
+  stream << m_bStreamableMipLevels;
 }
 
 void ezTexFormat::ReadHeader(ezStreamReader& stream)
@@ -71,6 +84,152 @@ void ezTexFormat::ReadHeader(ezStreamReader& stream)
   {
     stream >> m_GalRenderTargetFormat;
   }
+
+  // version 6
+  if (uiFileFormatVersion >= 6)
+  {
+    stream >> m_bStreamableMipLevels;
+  }
+}
+
+ezResult ezTexFormat::WriteStreamableImage(ezStreamWriter& stream, const ezImageView& image)
+{
+  const ezUInt8 uiVersion = 1;
+  stream << uiVersion;
+
+  const ezImageHeader& header = image.GetHeader();
+  const ezUInt32 uiNumMipLevels = header.GetNumMipLevels();
+
+  stream << static_cast<ezUInt32>(header.GetImageFormat());
+  stream << header.GetWidth();
+  stream << header.GetHeight();
+  stream << header.GetDepth();
+  stream << uiNumMipLevels;
+  stream << header.GetNumFaces();
+  stream << header.GetNumArrayIndices();
+
+  // the offset of every mip level relative to the start of the data, smallest mip level first, plus the total size
+  {
+    ezUInt64 uiOffset = 0;
+    stream << uiOffset;
+
+    for (ezUInt32 mip = uiNumMipLevels; mip > 0; --mip)
+    {
+      uiOffset += header.GetDepthPitch(mip - 1) * header.GetDepth(mip - 1) * header.GetNumFaces() * header.GetNumArrayIndices();
+      stream << uiOffset;
+    }
+  }
+
+  for (ezUInt32 mip = uiNumMipLevels; mip > 0; --mip)
+  {
+    for (ezUInt32 arrayIndex = 0; arrayIndex < header.GetNumArrayIndices(); ++arrayIndex)
+    {
+      for (ezUInt32 face = 0; face < header.GetNumFaces(); ++face)
+      {
+        const ezConstByteBlobPtr data = image.GetSubImageView(mip - 1, face, arrayIndex).GetByteBlobPtr();
+
+        EZ_SUCCEED_OR_RETURN(stream.WriteBytes(data.GetPtr(), data.GetCount()));
+      }
+    }
+  }
+
+  return EZ_SUCCESS;
+}
+
+ezResult ezTexFormat::ReadStreamableImage(
+  ezStreamReader& stream, ezImage& out_Image, ezUInt32 uiMaxMipLevels /*= ezInvalidIndex*/, ezUInt32* out_pNumMipLevelsTotal /*= nullptr*/)
+{
+  ezUInt8 uiVersion = 0;
+  stream >> uiVersion;
+
+  if (uiVersion != 1)
+  {
+    ezLog::Error("Unknown streamable texture data version {0}", uiVersion);
+    return EZ_FAILURE;
+  }
+
+  ezUInt32 uiFormat = 0, uiWidth = 0, uiHeight = 0, uiDepth = 0, uiNumMipLevels = 0, uiNumFaces = 0, uiNumArrayIndices = 0;
+  stream >> uiFormat;
+  stream >> uiWidth;
+  stream >> uiHeight;
+  stream >> uiDepth;
+  stream >> uiNumMipLevels;
+  stream >> uiNumFaces;
+  stream >> uiNumArrayIndices;
+
+  if (uiFormat >= ezImageFormat::NUM_FORMATS || uiWidth == 0 || uiHeight == 0 || uiDepth == 0 || uiNumFaces == 0 || uiNumArrayIndices == 0 ||
+      uiNumMipLevels == 0 || uiNumMipLevels > ezMath::Log2i(ezMath::Max(uiWidth, ezMath::Max(uiHeight, uiDepth))) + 1)
+  {
+    ezLog::Error("Invalid streamable texture data");
+    return EZ_FAILURE;
+  }
+
+  ezImageHeader fullHeader;
+  fullHeader.SetImageFormat(static_cast<ezImageFormat::Enum>(uiFormat));
+  fullHeader.SetWidth(uiWidth);
+  fullHeader.SetHeight(uiHeight);
+  fullHeader.SetDepth(uiDepth);
+  fullHeader.SetNumMipLevels(uiNumMipLevels);
+  fullHeader.SetNumFaces(uiNumFaces);
+  fullHeader.SetNumArrayIndices(uiNumArrayIndices);
+
+  // validate the entire offset table up front, even if only some mip levels are read now, the rest is read later on
+  {
+    ezUInt64 uiExpectedOffset = 0;
+
+    for (ezUInt32 i = 0; i <= uiNumMipLevels; ++i)
+    {
+      ezUInt64 uiOffset = 0;
+      stream >> uiOffset;
+
+      if (uiOffset != uiExpectedOffset)
+      {
+        ezLog::Error("Streamable texture data has an invalid offset table");
+        return EZ_FAILURE;
+      }
+
+      if (i < uiNumMipLevels)
+      {
+        const ezUInt32 mip = uiNumMipLevels - 1 - i;
+        uiExpectedOffset += fullHeader.GetDepthPitch(mip) * fullHeader.GetDepth(mip) * uiNumFaces * uiNumArrayIndices;
+      }
+    }
+  }
+
+  if (out_pNumMipLevelsTotal)
+  {
+    *out_pNumMipLevelsTotal = uiNumMipLevels;
+  }
+
+  const ezUInt32 uiNumMipLevelsToRead = ezMath::Min(uiMaxMipLevels, uiNumMipLevels);
+  const ezUInt32 uiFirstMipLevel = uiNumMipLevels - uiNumMipLevelsToRead;
+
+  ezImageHeader header = fullHeader;
+  header.SetWidth(fullHeader.GetWidth(uiFirstMipLevel));
+  header.SetHeight(fullHeader.GetHeight(uiFirstMipLevel));
+  header.SetDepth(fullHeader.GetDepth(uiFirstMipLevel));
+  header.SetNumMipLevels(uiNumMipLevelsToRead);
+
+  out_Image.ResetAndAlloc(header);
+
+  for (ezUInt32 mip = uiNumMipLevelsToRead; mip > 0; --mip)
+  {
+    for (ezUInt32 arrayIndex = 0; arrayIndex < uiNumArrayIndices; ++arrayIndex)
+    {
+      for (ezUInt32 face = 0; face < uiNumFaces; ++face)
+      {
+        ezByteBlobPtr data = out_Image.GetSubImageView(mip - 1, face, arrayIndex).GetByteBlobPtr();
+
+        if (stream.ReadBytes(data.GetPtr(), data.GetCount()) != data.GetCount())
+        {
+          ezLog::Error("Streamable texture data is truncated");
+          return EZ_FAILURE;
+        }
+      }
+    }
+  }
+
+  return EZ_SUCCESS;
 }
 
 
@@ -7,6 +7,8 @@
 
 class ezStreamWriter;
 class ezStreamReader;
+class ezImage;
+class ezImageView;
 
 struct EZ_TEXTURE_DLL ezTexFormat
 {
@@ -28,7 +30,24 @@ struct EZ_TEXTURE_DLL ezTexFormat
   // version 5
   int m_GalRenderTargetFormat = 0;
 
+  // version 6
+  /// If set, the image data following the header was written with WriteStreamableImage(), otherwise it is a DDS file.
+  bool m_bStreamableMipLevels = false;
+
   void WriteTextureHeader(ezStreamWriter& stream) const;
   void WriteRenderTargetHeader(ezStreamWriter& stream) const;
   void ReadHeader(ezStreamReader& stream);
+
+  /// \brief Writes all mip levels of the image, starting with the smallest one, preceded by a table with the offset of each mip level.
+  ///
+  /// Since the low mip levels come first, a loader can read only the low resolution version of a texture without seeking,
+  /// and read the rest once the texture is needed in higher quality.
+  static ezResult WriteStreamableImage(ezStreamWriter& stream, const ezImageView& image);
+
+  /// \brief Reads an image that was written with WriteStreamableImage().
+  ///
+  /// Only the \a uiMaxMipLevels smallest mip levels are read, the image then starts at the largest of those.
+  /// The number of mip levels that are stored in the stream is returned in \a out_pNumMipLevelsTotal.
+  static ezResult ReadStreamableImage(
+    ezStreamReader& stream, ezImage& out_Image, ezUInt32 uiMaxMipLevels = ezInvalidIndex, ezUInt32* out_pNumMipLevelsTotal = nullptr);
 };
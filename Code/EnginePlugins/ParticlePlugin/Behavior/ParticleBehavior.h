@@ -37,6 +37,14 @@ protected:
   virtual void InitializeElements(ezUInt64 uiStartIndex, ezUInt64 uiNumElements) override {}
   virtual void StepParticleSystem(const ezTime& tDiff, ezUInt32 uiNumNewParticles) { m_TimeDiff = tDiff; }
 
+  /// \brief For behaviors that only update every n-th particle per step.
+  ///
+  /// Returns the first index at or after \a uiStartIndex for which (index % uiUpdateInterval) == uiFirstToUpdate.
+  static ezUInt64 GetFirstIndexToUpdate(ezUInt64 uiStartIndex, ezUInt32 uiFirstToUpdate, ezUInt32 uiUpdateInterval)
+  {
+    return uiStartIndex + (uiFirstToUpdate + uiUpdateInterval - (uiStartIndex % uiUpdateInterval)) % uiUpdateInterval;
+  }
+
   ezTime m_TimeDiff;
 
 };
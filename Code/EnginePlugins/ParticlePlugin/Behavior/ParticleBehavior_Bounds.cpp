@@ -95,7 +95,7 @@ void ezParticleBehavior_Bounds::QueryOptionalStreams()
   m_pStreamLastPosition = GetOwnerSystem()->QueryStream("LastPosition", ezProcessingStream::DataType::Float3);
 }
 
-void ezParticleBehavior_Bounds::Process(ezUInt64 uiNumElements)
+void ezParticleBehavior_Bounds::ProcessRange(ezUInt64 uiStartIndex, ezUInt64 uiNumElements)
 {
   EZ_PROFILE_SCOPE("PFX: Bounds");
 
@@ -107,7 +107,7 @@ void ezParticleBehavior_Bounds::Process(ezUInt64 uiNumElements)
   const ezSimdVec4f halfExtPos = ezSimdConversion::ToVec3(m_vBoxExtents) * 0.5f;
   const ezSimdVec4f halfExtNeg = -halfExtPos;
 
-  ezProcessingStreamIterator<ezSimdVec4f> itPosition(m_pStreamPosition, uiNumElements, 0);
+  ezProcessingStreamIterator<ezSimdVec4f> itPosition(m_pStreamPosition, uiNumElements, uiStartIndex);
 
   if (m_OutOfBoundsMode == ezParticleOutOfBoundsMode::Teleport)
   {
@@ -115,7 +115,7 @@ void ezParticleBehavior_Bounds::Process(ezUInt64 uiNumElements)
 
     if (m_pStreamLastPosition)
     {
-      pLastPosition = m_pStreamLastPosition->GetWritableData<ezVec3>();
+      pLastPosition = m_pStreamLastPosition->GetWritableData<ezVec3>() + uiStartIndex;
     }
 
     while (!itPosition.HasReachedEnd())
@@ -146,7 +146,7 @@ void ezParticleBehavior_Bounds::Process(ezUInt64 uiNumElements)
   }
   else
   {
-    ezUInt32 idx = 0;
+    ezUInt64 idx = uiStartIndex;
 
     while (!itPosition.HasReachedEnd())
     {
@@ -34,7 +34,9 @@ public:
   ezEnum<ezParticleOutOfBoundsMode> m_OutOfBoundsMode;
 
 protected:
-  virtual void Process(ezUInt64 uiNumElements) override;
+  virtual bool SupportsRangeProcessing() const override { return true; }
+  virtual void Process(ezUInt64 uiNumElements) override { ProcessRange(0, uiNumElements); }
+  virtual void ProcessRange(ezUInt64 uiStartIndex, ezUInt64 uiNumElements) override;
 
   virtual void CreateRequiredStreams() override;
   virtual void QueryOptionalStreams() override;
@@ -152,8 +152,12 @@ void ezParticleBehavior_ColorGradient::InitializeElements(ezUInt64 uiStartIndex,
   }
 }
 
-void ezParticleBehavior_ColorGradient::Process(ezUInt64 uiNumElements)
+void ezParticleBehavior_ColorGradient::StepParticleSystem(const ezTime& tDiff, ezUInt32 uiNumNewParticles)
 {
+  ezParticleBehavior::StepParticleSystem(tDiff, uiNumNewParticles);
+
+  m_uiStepUpdateInterval = 0;
+
   if (!GetOwnerEffect()->IsVisible())
   {
     // set the update interval such that once the effect becomes visible,
@@ -166,82 +170,37 @@ void ezParticleBehavior_ColorGradient::Process(ezUInt64 uiNumElements)
   if (!m_hGradient.IsValid())
     return;
 
-  EZ_PROFILE_SCOPE("PFX: Color Gradient");
-
-  ezResourceLock<ezColorGradientResource> pGradient(m_hGradient, ezResourceAcquireMode::BlockTillLoaded);
-
-  if (pGradient.GetAcquireResult() == ezResourceAcquireResult::MissingFallback)
-    return;
-
-  const ezColorGradient& gradient = pGradient->GetDescriptor().m_Gradient;
-
-  ezProcessingStreamIterator<ezColorLinear16f> itColor(m_pStreamColor, uiNumElements, 0);
-
-  // skip the first n particles
-  itColor.Advance(m_uiFirstToUpdate);
-
-  if (m_GradientMode == ezParticleColorGradientMode::Age)
   {
-    ezProcessingStreamIterator<ezFloat16Vec2> itLifeTime(m_pStreamLifeTime, uiNumElements, 0);
+    ezResourceLock<ezColorGradientResource> pGradient(m_hGradient, ezResourceAcquireMode::BlockTillLoaded);
 
-    // skip the first n particles
-    itLifeTime.Advance(m_uiFirstToUpdate);
+    if (pGradient.GetAcquireResult() == ezResourceAcquireResult::MissingFallback)
+      return;
 
-    while (!itLifeTime.HasReachedEnd())
+    if (m_hSampledGradient != m_hGradient || m_uiSampledGradientChangeCounter != pGradient->GetCurrentResourceChangeCounter() ||
+        m_SampledTintColor != m_TintColor)
     {
-      // if (itLifeTime.Current().y > 0)
-      {
-        const float fLifeTimeFraction = itLifeTime.Current().x * itLifeTime.Current().y;
-        const float posx = 1.0f - fLifeTimeFraction;
-
-        ezColor rgba;
-        ezUInt8 alpha;
-        gradient.EvaluateColor(posx, rgba);
-        gradient.EvaluateAlpha(posx, alpha);
-        rgba.a = ezMath::ColorByteToFloat(alpha);
-
-        itColor.Current() = rgba * m_TintColor;
-      }
-
-      // skip the next n items
-      // this is to reduce the number of particles that need to be fully evaluated,
-      // since sampling the color gradient is pretty expensive
-      itLifeTime.Advance(m_uiCurrentUpdateInterval);
-      itColor.Advance(m_uiCurrentUpdateInterval);
-    }
-  }
-  else if (m_GradientMode == ezParticleColorGradientMode::Speed)
-  {
-    ezProcessingStreamIterator<ezVec3> itVelocity(m_pStreamVelocity, uiNumElements, 0);
-
-    // skip the first n particles
-    itVelocity.Advance(m_uiFirstToUpdate);
+      m_hSampledGradient = m_hGradient;
+      m_uiSampledGradientChangeCounter = pGradient->GetCurrentResourceChangeCounter();
+      m_SampledTintColor = m_TintColor;
 
-    while (!itVelocity.HasReachedEnd())
-    {
-      // if (itLifeTime.Current().y > 0)
-      {
-        const float fSpeed = itVelocity.Current().GetLength();
-        const float posx = fSpeed / m_fMaxSpeed; // no need to clamp the range, the color lookup will already do that
+      const ezColorGradient& gradient = pGradient->GetDescriptor().m_Gradient;
 
+      m_ColorTable.Sample([&](float posx) {
         ezColor rgba;
         ezUInt8 alpha;
         gradient.EvaluateColor(posx, rgba);
         gradient.EvaluateAlpha(posx, alpha);
         rgba.a = ezMath::ColorByteToFloat(alpha);
 
-        itColor.Current() = rgba * m_TintColor;
-      }
-
-      // skip the next n items
-      // this is to reduce the number of particles that need to be fully evaluated,
-      // since sampling the color gradient is pretty expensive
-      itVelocity.Advance(m_uiCurrentUpdateInterval);
-      itColor.Advance(m_uiCurrentUpdateInterval);
+        return rgba * m_TintColor;
+      });
     }
   }
 
-  // adjust which index is the first to update
+  m_uiStepFirstToUpdate = m_uiFirstToUpdate;
+  m_uiStepUpdateInterval = m_uiCurrentUpdateInterval;
+
+  // adjust which index is the first to update in the next step
   {
     ++m_uiFirstToUpdate;
     if (m_uiFirstToUpdate >= m_uiCurrentUpdateInterval)
@@ -255,6 +214,50 @@ void ezParticleBehavior_ColorGradient::Process(ezUInt64 uiNumElements)
   m_uiCurrentUpdateInterval = 2;
 }
 
+void ezParticleBehavior_ColorGradient::ProcessRange(ezUInt64 uiStartIndex, ezUInt64 uiNumElements)
+{
+  if (m_uiStepUpdateInterval == 0)
+    return;
+
+  // skip the particles that are not updated in this step
+  // this is to reduce the number of particles that need to be updated
+  const ezUInt64 uiEndIndex = uiStartIndex + uiNumElements;
+  const ezUInt64 uiFirstIndex = GetFirstIndexToUpdate(uiStartIndex, m_uiStepFirstToUpdate, m_uiStepUpdateInterval);
+
+  if (uiFirstIndex >= uiEndIndex)
+    return;
+
+  // the gradient has been sampled into a table in StepParticleSystem()
+  ezProcessingStreamIterator<ezColorLinear16f> itColor(m_pStreamColor, uiEndIndex - uiFirstIndex, uiFirstIndex);
+
+  if (m_GradientMode == ezParticleColorGradientMode::Age)
+  {
+    ezProcessingStreamIterator<ezFloat16Vec2> itLifeTime(m_pStreamLifeTime, uiEndIndex - uiFirstIndex, uiFirstIndex);
+
+    while (!itLifeTime.HasReachedEnd())
+    {
+      const float fLifeTimeFraction = itLifeTime.Current().x * itLifeTime.Current().y;
+      itColor.Current() = m_ColorTable.Lookup(1.0f - fLifeTimeFraction);
+
+      itLifeTime.Advance(m_uiStepUpdateInterval);
+      itColor.Advance(m_uiStepUpdateInterval);
+    }
+  }
+  else if (m_GradientMode == ezParticleColorGradientMode::Speed)
+  {
+    ezProcessingStreamIterator<ezVec3> itVelocity(m_pStreamVelocity, uiEndIndex - uiFirstIndex, uiFirstIndex);
+
+    while (!itVelocity.HasReachedEnd())
+    {
+      const float fSpeed = itVelocity.Current().GetLength();
+      itColor.Current() = m_ColorTable.Lookup(fSpeed / m_fMaxSpeed); // no need to clamp the range, the lookup will already do that
+
+      itVelocity.Advance(m_uiStepUpdateInterval);
+      itColor.Advance(m_uiStepUpdateInterval);
+    }
+  }
+}
+
 
 
 EZ_STATICLINK_FILE(ParticlePlugin, ParticlePlugin_Behavior_ParticleBehavior_ColorGradient);
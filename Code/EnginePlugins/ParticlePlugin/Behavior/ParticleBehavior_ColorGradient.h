@@ -2,6 +2,7 @@
 
 #include <ParticlePlugin/Behavior/ParticleBehavior.h>
 #include <GameEngine/Curves/ColorGradientResource.h>
+#include <ParticlePlugin/Module/ParticleKernels.h>
 
 class EZ_PARTICLEPLUGIN_DLL ezParticleBehaviorFactory_ColorGradient final : public ezParticleBehaviorFactory
 {
@@ -47,7 +48,10 @@ protected:
   friend class ezParticleBehaviorFactory_ColorGradient;
 
   virtual void InitializeElements(ezUInt64 uiStartIndex, ezUInt64 uiNumElements) override;
-  virtual void Process(ezUInt64 uiNumElements) override;
+  virtual bool SupportsRangeProcessing() const override { return true; }
+  virtual void Process(ezUInt64 uiNumElements) override { ProcessRange(0, uiNumElements); }
+  virtual void ProcessRange(ezUInt64 uiStartIndex, ezUInt64 uiNumElements) override;
+  virtual void StepParticleSystem(const ezTime& tDiff, ezUInt32 uiNumNewParticles) override;
 
   ezProcessingStream* m_pStreamLifeTime = nullptr;
   ezProcessingStream* m_pStreamColor = nullptr;
@@ -55,4 +59,14 @@ protected:
   ezColor m_InitColor;
   ezUInt8 m_uiFirstToUpdate = 0;
   ezUInt8 m_uiCurrentUpdateInterval = 8;
+
+  // which particles to update during the current step, an interval of zero means no update
+  ezUInt8 m_uiStepFirstToUpdate = 0;
+  ezUInt8 m_uiStepUpdateInterval = 0;
+
+  // the tinted gradient, sampled again whenever the gradient or the tint color change
+  ezParticleLookupTable<ezColor> m_ColorTable;
+  ezColorGradientResourceHandle m_hSampledGradient;
+  ezUInt32 m_uiSampledGradientChangeCounter = 0;
+  ezColor m_SampledTintColor;
 };
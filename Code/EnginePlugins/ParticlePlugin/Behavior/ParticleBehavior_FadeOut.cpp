@@ -59,8 +59,12 @@ void ezParticleBehavior_FadeOut::CreateRequiredStreams()
   CreateStream("Color", ezProcessingStream::DataType::Half4, &m_pStreamColor, false);
 }
 
-void ezParticleBehavior_FadeOut::Process(ezUInt64 uiNumElements)
+void ezParticleBehavior_FadeOut::StepParticleSystem(const ezTime& tDiff, ezUInt32 uiNumNewParticles)
 {
+  ezParticleBehavior::StepParticleSystem(tDiff, uiNumNewParticles);
+
+  m_uiStepUpdateInterval = 0;
+
   if (!GetOwnerEffect()->IsVisible())
   {
     // set the update interval such that once the effect becomes visible,
@@ -70,54 +74,33 @@ void ezParticleBehavior_FadeOut::Process(ezUInt64 uiNumElements)
     return;
   }
 
-  EZ_PROFILE_SCOPE("PFX: Fade Out");
-
-  ezProcessingStreamIterator<ezFloat16Vec2> itLifeTime(m_pStreamLifeTime, uiNumElements, 0);
-  ezProcessingStreamIterator<ezColorLinear16f> itColor(m_pStreamColor, uiNumElements, 0);
-
-  // skip the first n particles
+  if (m_fSampledStartAlpha != m_fStartAlpha || m_fSampledExponent != m_fExponent)
   {
-    for (ezUInt32 i = 0; i < m_uiFirstToUpdate; ++i)
-    {
-      itLifeTime.Advance();
-      itColor.Advance();
-    }
+    m_fSampledStartAlpha = m_fStartAlpha;
+    m_fSampledExponent = m_fExponent;
 
-    ++m_uiFirstToUpdate;
-    if (m_uiFirstToUpdate >= m_uiCurrentUpdateInterval)
-      m_uiFirstToUpdate = 0;
-  }
+    const float fStartAlpha = m_fStartAlpha;
+    const float fExponent = m_fExponent;
 
-  if (m_fStartAlpha <= 1.0f)
-  {
-    while (!itLifeTime.HasReachedEnd())
+    if (fStartAlpha <= 1.0f)
     {
-      const float fLifeTimeFraction = itLifeTime.Current().x * itLifeTime.Current().y;
-      itColor.Current().a = m_fStartAlpha * ezMath::Pow(fLifeTimeFraction, m_fExponent);
-
-      for (ezUInt32 i = 0; i < m_uiCurrentUpdateInterval; ++i)
-      {
-        itLifeTime.Advance();
-        itColor.Advance();
-      }
+      m_AlphaTable.Sample([=](float fLifeTimeFraction) { return fStartAlpha * ezMath::Pow(fLifeTimeFraction, fExponent); });
     }
-  }
-  else
-  {
-    // this case has to clamp alpha to 1
-    while (!itLifeTime.HasReachedEnd())
+    else
     {
-      const float fLifeTimeFraction = itLifeTime.Current().x * itLifeTime.Current().y;
-      itColor.Current().a = ezMath::Min(1.0f, m_fStartAlpha * ezMath::Pow(fLifeTimeFraction, m_fExponent));
-
-      for (ezUInt32 i = 0; i < m_uiCurrentUpdateInterval; ++i)
-      {
-        itLifeTime.Advance();
-        itColor.Advance();
-      }
+      // this case has to clamp alpha to 1
+      m_AlphaTable.Sample([=](float fLifeTimeFraction) { return ezMath::Min(1.0f, fStartAlpha * ezMath::Pow(fLifeTimeFraction, fExponent)); });
     }
   }
 
+  m_uiStepFirstToUpdate = m_uiFirstToUpdate;
+  m_uiStepUpdateInterval = m_uiCurrentUpdateInterval;
+
+  // adjust which index is the first to update in the next step
+  ++m_uiFirstToUpdate;
+  if (m_uiFirstToUpdate >= m_uiCurrentUpdateInterval)
+    m_uiFirstToUpdate = 0;
+
   /// \todo Use level of detail to reduce the update interval further
   /// up close, with a high interval, animations appear choppy, especially when fading stuff out at the end
 
@@ -125,6 +108,31 @@ void ezParticleBehavior_FadeOut::Process(ezUInt64 uiNumElements)
   m_uiCurrentUpdateInterval = 2;
 }
 
+void ezParticleBehavior_FadeOut::ProcessRange(ezUInt64 uiStartIndex, ezUInt64 uiNumElements)
+{
+  if (m_uiStepUpdateInterval == 0)
+    return;
+
+  // only update every n-th particle, the others are updated in the next steps
+  const ezUInt64 uiEndIndex = uiStartIndex + uiNumElements;
+  const ezUInt64 uiFirstIndex = GetFirstIndexToUpdate(uiStartIndex, m_uiStepFirstToUpdate, m_uiStepUpdateInterval);
+
+  if (uiFirstIndex >= uiEndIndex)
+    return;
+
+  ezProcessingStreamIterator<ezFloat16Vec2> itLifeTime(m_pStreamLifeTime, uiEndIndex - uiFirstIndex, uiFirstIndex);
+  ezProcessingStreamIterator<ezColorLinear16f> itColor(m_pStreamColor, uiEndIndex - uiFirstIndex, uiFirstIndex);
+
+  while (!itLifeTime.HasReachedEnd())
+  {
+    const float fLifeTimeFraction = itLifeTime.Current().x * itLifeTime.Current().y;
+    itColor.Current().a = m_AlphaTable.Lookup(fLifeTimeFraction);
+
+    itLifeTime.Advance(m_uiStepUpdateInterval);
+    itColor.Advance(m_uiStepUpdateInterval);
+  }
+}
+
 
 
 EZ_STATICLINK_FILE(ParticlePlugin, ParticlePlugin_Behavior_ParticleBehavior_FadeOut);
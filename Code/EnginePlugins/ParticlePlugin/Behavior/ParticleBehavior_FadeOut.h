@@ -1,6 +1,7 @@
 #pragma once
 
 #include <ParticlePlugin/Behavior/ParticleBehavior.h>
+#include <ParticlePlugin/Module/ParticleKernels.h>
 
 class EZ_PARTICLEPLUGIN_DLL ezParticleBehaviorFactory_FadeOut final : public ezParticleBehaviorFactory
 {
@@ -31,10 +32,22 @@ public:
   virtual void CreateRequiredStreams() override;
 
 protected:
-  virtual void Process(ezUInt64 uiNumElements) override;
+  virtual bool SupportsRangeProcessing() const override { return true; }
+  virtual void Process(ezUInt64 uiNumElements) override { ProcessRange(0, uiNumElements); }
+  virtual void ProcessRange(ezUInt64 uiStartIndex, ezUInt64 uiNumElements) override;
+  virtual void StepParticleSystem(const ezTime& tDiff, ezUInt32 uiNumNewParticles) override;
 
   ezProcessingStream* m_pStreamLifeTime = nullptr;
   ezProcessingStream* m_pStreamColor = nullptr;
   ezUInt8 m_uiFirstToUpdate = 0;
   ezUInt8 m_uiCurrentUpdateInterval = 2;
+
+  // which particles to update during the current step, an interval of zero means no update
+  ezUInt8 m_uiStepFirstToUpdate = 0;
+  ezUInt8 m_uiStepUpdateInterval = 0;
+
+  // the alpha over the fraction of remaining life time, sampled again whenever the properties change
+  ezParticleLookupTable<float> m_AlphaTable;
+  float m_fSampledStartAlpha = -1.0f;
+  float m_fSampledExponent = 0.0f;
 };
@@ -8,6 +8,7 @@
 #include <GameEngine/Interfaces/PhysicsWorldModule.h>
 #include <ParticlePlugin/Behavior/ParticleBehavior_Gravity.h>
 #include <ParticlePlugin/Finalizer/ParticleFinalizer_ApplyVelocity.h>
+#include <ParticlePlugin/Module/ParticleKernels.h>
 #include <ParticlePlugin/System/ParticleSystemInstance.h>
 #include <WorldModule/ParticleWorldModule.h>
 
@@ -73,23 +74,20 @@ void ezParticleBehavior_Gravity::CreateRequiredStreams()
   CreateStream("Velocity", ezProcessingStream::DataType::Float3, &m_pStreamVelocity, false);
 }
 
-void ezParticleBehavior_Gravity::Process(ezUInt64 uiNumElements)
+void ezParticleBehavior_Gravity::StepParticleSystem(const ezTime& tDiff, ezUInt32 uiNumNewParticles)
 {
-  EZ_PROFILE_SCOPE("PFX: Gravity");
+  ezParticleBehavior::StepParticleSystem(tDiff, uiNumNewParticles);
 
   const ezVec3 vGravity = m_pPhysicsModule != nullptr ? m_pPhysicsModule->GetGravity() : ezVec3(0.0f, 0.0f, -10.0f);
 
-  const float tDiff = (float)m_TimeDiff.GetSeconds();
-  const ezVec3 addGravity = vGravity * m_fGravityFactor * tDiff;
-
-  ezProcessingStreamIterator<ezVec3> itVelocity(m_pStreamVelocity, uiNumElements, 0);
+  m_vAddGravity = vGravity * m_fGravityFactor * (float)tDiff.GetSeconds();
+}
 
-  while (!itVelocity.HasReachedEnd())
-  {
-    itVelocity.Current() += addGravity;
+void ezParticleBehavior_Gravity::ProcessRange(ezUInt64 uiStartIndex, ezUInt64 uiNumElements)
+{
+  ezVec3* pVelocity = m_pStreamVelocity->GetWritableData<ezVec3>() + uiStartIndex;
 
-    itVelocity.Advance();
-  }
+  ezParticleKernels::AddVec3(pVelocity, static_cast<ezUInt32>(uiNumElements), m_vAddGravity);
 }
 
 void ezParticleBehavior_Gravity::RequestRequiredWorldModulesForCache(ezParticleWorldModule* pParticleModule)
@@ -36,11 +36,16 @@ public:
 protected:
   friend class ezParticleBehaviorFactory_Gravity;
 
-  virtual void Process(ezUInt64 uiNumElements) override;
+  virtual bool SupportsRangeProcessing() const override { return true; }
+  virtual void Process(ezUInt64 uiNumElements) override { ProcessRange(0, uiNumElements); }
+  virtual void ProcessRange(ezUInt64 uiStartIndex, ezUInt64 uiNumElements) override;
+  virtual void StepParticleSystem(const ezTime& tDiff, ezUInt32 uiNumNewParticles) override;
 
   void RequestRequiredWorldModulesForCache(ezParticleWorldModule* pParticleModule) override;
 
   ezPhysicsWorldModuleInterface* m_pPhysicsModule;
 
+  ezVec3 m_vAddGravity = ezVec3::ZeroVector();
+
   ezProcessingStream* m_pStreamVelocity;
 };
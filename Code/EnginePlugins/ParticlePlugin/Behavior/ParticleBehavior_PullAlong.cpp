@@ -73,14 +73,12 @@ void ezParticleBehavior_PullAlong::CreateRequiredStreams()
   CreateStream("Position", ezProcessingStream::DataType::Float4, &m_pStreamPosition, false);
 }
 
-void ezParticleBehavior_PullAlong::Process(ezUInt64 uiNumElements)
+void ezParticleBehavior_PullAlong::ProcessRange(ezUInt64 uiStartIndex, ezUInt64 uiNumElements)
 {
-  EZ_PROFILE_SCOPE("PFX: PullAlong");
-
   if (m_vApplyPull.IsZero())
     return;
 
-  ezProcessingStreamIterator<ezSimdVec4f> itPosition(m_pStreamPosition, uiNumElements, 0);
+  ezProcessingStreamIterator<ezSimdVec4f> itPosition(m_pStreamPosition, uiNumElements, uiStartIndex);
   ezSimdVec4f pull;
   pull.Load<3>(&m_vApplyPull.x);
 
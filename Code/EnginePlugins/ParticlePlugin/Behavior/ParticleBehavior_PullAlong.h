@@ -31,7 +31,9 @@ public:
   float m_fStrength = 0.5;
 
 protected:
-  virtual void Process(ezUInt64 uiNumElements) override;
+  virtual bool SupportsRangeProcessing() const override { return true; }
+  virtual void Process(ezUInt64 uiNumElements) override { ProcessRange(0, uiNumElements); }
+  virtual void ProcessRange(ezUInt64 uiStartIndex, ezUInt64 uiNumElements) override;
   virtual void StepParticleSystem(const ezTime& tDiff, ezUInt32 uiNumNewParticles) override;
 
   bool m_bFirstTime = true;
@@ -96,8 +96,10 @@ void ezParticleBehavior_SizeCurve::InitializeElements(ezUInt64 uiStartIndex, ezU
   }
 }
 
-void ezParticleBehavior_SizeCurve::Process(ezUInt64 uiNumElements)
+void ezParticleBehavior_SizeCurve::StepParticleSystem(const ezTime& tDiff, ezUInt32 uiNumNewParticles)
 {
+  ezParticleBehavior::StepParticleSystem(tDiff, uiNumNewParticles);
+
   if (!GetOwnerEffect()->IsVisible())
   {
     // reduce the update interval when the effect is not visible
@@ -108,64 +110,76 @@ void ezParticleBehavior_SizeCurve::Process(ezUInt64 uiNumElements)
     m_uiCurrentUpdateInterval = 2;
   }
 
+  m_uiStepUpdateInterval = 0;
+
   if (!m_hCurve.IsValid())
     return;
 
-  EZ_PROFILE_SCOPE("PFX: Size Curve");
+  {
+    ezResourceLock<ezCurve1DResource> pCurve(m_hCurve, ezResourceAcquireMode::BlockTillLoaded);
 
-  ezProcessingStreamIterator<ezFloat16Vec2> itLifeTime(m_pStreamLifeTime, uiNumElements, 0);
-  ezProcessingStreamIterator<ezFloat16> itSize(m_pStreamSize, uiNumElements, 0);
+    if (pCurve.GetAcquireResult() == ezResourceAcquireResult::MissingFallback)
+      return;
 
-  ezResourceLock<ezCurve1DResource> pCurve(m_hCurve, ezResourceAcquireMode::BlockTillLoaded);
+    if (pCurve->GetDescriptor().m_Curves.IsEmpty())
+      return;
 
-  if (pCurve.GetAcquireResult() == ezResourceAcquireResult::MissingFallback)
-    return;
-
-  if (pCurve->GetDescriptor().m_Curves.IsEmpty())
-    return;
+    if (m_hSampledCurve != m_hCurve || m_uiSampledCurveChangeCounter != pCurve->GetCurrentResourceChangeCounter() ||
+        m_fSampledBaseSize != m_fBaseSize || m_fSampledCurveScale != m_fCurveScale)
+    {
+      m_hSampledCurve = m_hCurve;
+      m_uiSampledCurveChangeCounter = pCurve->GetCurrentResourceChangeCounter();
+      m_fSampledBaseSize = m_fBaseSize;
+      m_fSampledCurveScale = m_fCurveScale;
 
-  auto& curve = pCurve->GetDescriptor().m_Curves[0];
+      const ezCurve1D& curve = pCurve->GetDescriptor().m_Curves[0];
 
-  double fMinX, fMaxX;
-  curve.QueryExtents(fMinX, fMaxX);
+      m_SizeTable.Sample([&](float fLifeTimeFraction) {
+        const double evalPos = curve.ConvertNormalizedPos(1.0f - fLifeTimeFraction);
+        double val = curve.Evaluate(evalPos);
+        val = curve.NormalizeValue(val);
 
-  // skip the first n particles
-  {
-    for (ezUInt32 i = 0; i < m_uiFirstToUpdate; ++i)
-    {
-      itLifeTime.Advance();
-      itSize.Advance();
+        return m_fBaseSize + (float)val * m_fCurveScale;
+      });
     }
-
-    ++m_uiFirstToUpdate;
-    if (m_uiFirstToUpdate >= m_uiCurrentUpdateInterval)
-      m_uiFirstToUpdate = 0;
   }
 
-  while (!itLifeTime.HasReachedEnd())
-  {
-    // if (itLifeTime.Current().y > 0)
-    {
-      const float fLifeTimeFraction = 1.0f - (itLifeTime.Current().x * itLifeTime.Current().y);
+  m_uiStepFirstToUpdate = ezMath::Min(m_uiFirstToUpdate, static_cast<ezUInt8>(m_uiCurrentUpdateInterval - 1));
+  m_uiStepUpdateInterval = m_uiCurrentUpdateInterval;
 
-      const double evalPos = curve.ConvertNormalizedPos(fLifeTimeFraction);
-      double val = curve.Evaluate(evalPos);
-      val = curve.NormalizeValue(val);
+  ++m_uiFirstToUpdate;
+  if (m_uiFirstToUpdate >= m_uiCurrentUpdateInterval)
+    m_uiFirstToUpdate = 0;
+}
 
-      itSize.Current() = m_fBaseSize + (float)val * m_fCurveScale;
-    }
+void ezParticleBehavior_SizeCurve::ProcessRange(ezUInt64 uiStartIndex, ezUInt64 uiNumElements)
+{
+  if (m_uiStepUpdateInterval == 0)
+    return;
 
-    // skip the next n items
-    // this is to reduce the number of particles that need to be fully evaluated,
-    // since sampling the curve is expensive
-    for (ezUInt32 i = 0; i < m_uiCurrentUpdateInterval; ++i)
-    {
-      itLifeTime.Advance();
-      itSize.Advance();
-    }
+  // skip the particles that are not updated in this step
+  // this is to reduce the number of particles that need to be updated
+  const ezUInt64 uiEndIndex = uiStartIndex + uiNumElements;
+  const ezUInt64 uiFirstIndex = GetFirstIndexToUpdate(uiStartIndex, m_uiStepFirstToUpdate, m_uiStepUpdateInterval);
+
+  if (uiFirstIndex >= uiEndIndex)
+    return;
+
+  ezProcessingStreamIterator<ezFloat16Vec2> itLifeTime(m_pStreamLifeTime, uiEndIndex - uiFirstIndex, uiFirstIndex);
+  ezProcessingStreamIterator<ezFloat16> itSize(m_pStreamSize, uiEndIndex - uiFirstIndex, uiFirstIndex);
+
+  while (!itLifeTime.HasReachedEnd())
+  {
+    // the curve has been sampled into a table in StepParticleSystem()
+    const float fLifeTimeFraction = itLifeTime.Current().x * itLifeTime.Current().y;
+    itSize.Current() = m_SizeTable.Lookup(fLifeTimeFraction);
+
+    itLifeTime.Advance(m_uiStepUpdateInterval);
+    itSize.Advance(m_uiStepUpdateInterval);
   }
 }
 
 
 
+
 EZ_STATICLINK_FILE(ParticlePlugin, ParticlePlugin_Behavior_ParticleBehavior_SizeCurve);
@@ -2,6 +2,7 @@
 
 #include <ParticlePlugin/Behavior/ParticleBehavior.h>
 #include <GameEngine/Curves/Curve1DResource.h>
+#include <ParticlePlugin/Module/ParticleKernels.h>
 
 class EZ_PARTICLEPLUGIN_DLL ezParticleBehaviorFactory_SizeCurve final : public ezParticleBehaviorFactory
 {
@@ -36,10 +37,24 @@ public:
 protected:
 
   virtual void InitializeElements(ezUInt64 uiStartIndex, ezUInt64 uiNumElements) override;
-  virtual void Process(ezUInt64 uiNumElements) override;
+  virtual bool SupportsRangeProcessing() const override { return true; }
+  virtual void Process(ezUInt64 uiNumElements) override { ProcessRange(0, uiNumElements); }
+  virtual void ProcessRange(ezUInt64 uiStartIndex, ezUInt64 uiNumElements) override;
+  virtual void StepParticleSystem(const ezTime& tDiff, ezUInt32 uiNumNewParticles) override;
 
   ezProcessingStream* m_pStreamLifeTime = nullptr;
   ezProcessingStream* m_pStreamSize = nullptr;
   ezUInt8 m_uiFirstToUpdate = 0;
   ezUInt8 m_uiCurrentUpdateInterval = 8;
+
+  // which particles to update during the current step, an interval of zero means no update
+  ezUInt8 m_uiStepFirstToUpdate = 0;
+  ezUInt8 m_uiStepUpdateInterval = 0;
+
+  // the size over the fraction of remaining life time, sampled again whenever the curve or the properties change
+  ezParticleLookupTable<float> m_SizeTable;
+  ezCurve1DResourceHandle m_hSampledCurve;
+  ezUInt32 m_uiSampledCurveChangeCounter = 0;
+  float m_fSampledBaseSize = 0.0f;
+  float m_fSampledCurveScale = 0.0f;
 };
@@ -9,6 +9,7 @@
 #include <GameEngine/Interfaces/WindWorldModule.h>
 #include <ParticlePlugin/Behavior/ParticleBehavior_Velocity.h>
 #include <ParticlePlugin/Finalizer/ParticleFinalizer_ApplyVelocity.h>
+#include <ParticlePlugin/Module/ParticleKernels.h>
 #include <ParticlePlugin/System/ParticleSystemInstance.h>
 #include <ParticlePlugin/WorldModule/ParticleWorldModule.h>
 
@@ -105,11 +106,11 @@ void ezParticleBehavior_Velocity::CreateRequiredStreams()
   CreateStream("Velocity", ezProcessingStream::DataType::Float3, &m_pStreamVelocity, false);
 }
 
-void ezParticleBehavior_Velocity::Process(ezUInt64 uiNumElements)
+void ezParticleBehavior_Velocity::StepParticleSystem(const ezTime& tDiff0, ezUInt32 uiNumNewParticles)
 {
-  EZ_PROFILE_SCOPE("PFX: Velocity");
+  ezParticleBehavior::StepParticleSystem(tDiff0, uiNumNewParticles);
 
-  const float tDiff = (float)m_TimeDiff.GetSeconds();
+  const float tDiff = (float)tDiff0.GetSeconds();
   const ezVec3 vDown = m_pPhysicsModule != nullptr ? m_pPhysicsModule->GetGravity().GetNormalized() : ezVec3(0.0f, 0.0f, -1.0f);
   const ezVec3 vRise = vDown * tDiff * -m_fRiseSpeed;
 
@@ -120,23 +121,24 @@ void ezParticleBehavior_Velocity::Process(ezUInt64 uiNumElements)
   }
 
   const ezVec3 vAddPos0 = vRise + vWind;
-
-  ezSimdVec4f vAddPos;
-  vAddPos.Load<3>(&vAddPos0.x);
+  m_vAddPosition.Load<3>(&vAddPos0.x);
 
   const float fFriction = ezMath::Clamp(m_fFriction, 0.0f, 100.0f);
-  const float fFrictionFactor = ezMath::Pow(0.5f, tDiff * fFriction);
+  m_fFrictionFactor = ezMath::Pow(0.5f, tDiff * fFriction);
+}
+
+void ezParticleBehavior_Velocity::ProcessRange(ezUInt64 uiStartIndex, ezUInt64 uiNumElements)
+{
+  EZ_PROFILE_SCOPE("PFX: Velocity");
 
-  ezProcessingStreamIterator<ezSimdVec4f> itPosition(m_pStreamPosition, uiNumElements, 0);
-  ezProcessingStreamIterator<ezVec3> itVelocity(m_pStreamVelocity, uiNumElements, 0);
+  ezVec4* pPosition = m_pStreamPosition->GetWritableData<ezVec4>() + uiStartIndex;
+  ezVec3* pVelocity = m_pStreamVelocity->GetWritableData<ezVec3>() + uiStartIndex;
 
-  while (!itPosition.HasReachedEnd())
-  {
-    itPosition.Current() += vAddPos;
-    itVelocity.Current() *= fFrictionFactor;
+  ezParticleKernels::AddVec4(pPosition, static_cast<ezUInt32>(uiNumElements), m_vAddPosition);
 
-    itPosition.Advance();
-    itVelocity.Advance();
+  if (m_fFrictionFactor != 1.0f)
+  {
+    ezParticleKernels::ScaleVec3(pVelocity, static_cast<ezUInt32>(uiNumElements), m_fFrictionFactor);
   }
 }
 
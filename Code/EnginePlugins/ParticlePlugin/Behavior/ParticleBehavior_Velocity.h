@@ -41,7 +41,10 @@ public:
 protected:
   friend class ezParticleBehaviorFactory_Velocity;
 
-  virtual void Process(ezUInt64 uiNumElements) override;
+  virtual bool SupportsRangeProcessing() const override { return true; }
+  virtual void Process(ezUInt64 uiNumElements) override { ProcessRange(0, uiNumElements); }
+  virtual void ProcessRange(ezUInt64 uiStartIndex, ezUInt64 uiNumElements) override;
+  virtual void StepParticleSystem(const ezTime& tDiff, ezUInt32 uiNumNewParticles) override;
 
   void RequestRequiredWorldModulesForCache(ezParticleWorldModule* pParticleModule) override;
 
@@ -49,6 +52,10 @@ protected:
   ezPhysicsWorldModuleInterface* m_pPhysicsModule = nullptr;
   ezWindWorldModuleInterface* m_pWindModule = nullptr;
 
+  // computed once per step in StepParticleSystem()
+  ezSimdVec4f m_vAddPosition;
+  float m_fFrictionFactor = 1.0f;
+
   ezProcessingStream* m_pStreamPosition;
   ezProcessingStream* m_pStreamVelocity;
 };
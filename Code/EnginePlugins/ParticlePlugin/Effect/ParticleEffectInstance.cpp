@@ -112,6 +112,20 @@ bool ezParticleEffectInstance::HasActiveParticles() const
   return false;
 }
 
+ezUInt64 ezParticleEffectInstance::GetNumActiveParticles() const
+{
+  ezUInt64 uiNumParticles = 0;
+
+  for (const ezParticleSystemInstance* pSystem : m_ParticleSystems)
+  {
+    if (pSystem)
+    {
+      uiNumParticles += pSystem->GetNumActiveParticles();
+    }
+  }
+
+  return uiNumParticles;
+}
 
 void ezParticleEffectInstance::ClearParticleSystem(ezUInt32 index)
 {
@@ -720,17 +734,39 @@ void ezParticleffectUpdateTask::Execute()
   if (HasBeenCanceled())
     return;
 
-  if (m_UpdateDiff.GetSeconds() != 0.0)
+  m_pEffect->UpdateFromTask(m_UpdateDiff);
+}
+
+ezParticleEffectBatchUpdateTask::ezParticleEffectBatchUpdateTask()
+{
+  ConfigureTask("Particle Effect Batch Update", ezTaskNesting::Maybe);
+  m_UpdateDiff.SetZero();
+}
+
+void ezParticleEffectBatchUpdateTask::Execute()
+{
+  for (ezParticleEffectInstance* pEffect : m_Effects)
   {
-    m_pEffect->PreSimulate();
+    if (HasBeenCanceled())
+      return;
 
-    if (!m_pEffect->Update(m_UpdateDiff))
-    {
-      const ezParticleEffectHandle hEffect = m_pEffect->GetHandle();
-      EZ_ASSERT_DEBUG(!hEffect.IsInvalidated(), "Invalid particle effect handle");
+    pEffect->UpdateFromTask(m_UpdateDiff);
+  }
+}
 
-      m_pEffect->GetOwnerWorldModule()->DestroyEffectInstance(hEffect, true, nullptr);
-    }
+void ezParticleEffectInstance::UpdateFromTask(const ezTime& tDiff)
+{
+  if (tDiff.GetSeconds() == 0.0)
+    return;
+
+  PreSimulate();
+
+  if (!Update(tDiff))
+  {
+    const ezParticleEffectHandle hEffect = GetHandle();
+    EZ_ASSERT_DEBUG(!hEffect.IsInvalidated(), "Invalid particle effect handle");
+
+    GetOwnerWorldModule()->DestroyEffectInstance(hEffect, true, nullptr);
   }
 }
 
@@ -21,10 +21,24 @@ private:
   ezParticleEffectInstance* m_pEffect;
 };
 
+/// \brief Updates multiple small effects one after another, so that effects with only a few particles don't each pay for a task of their own.
+class ezParticleEffectBatchUpdateTask final : public ezTask
+{
+public:
+  ezParticleEffectBatchUpdateTask();
+
+  ezTime m_UpdateDiff;
+  ezDynamicArray<ezParticleEffectInstance*> m_Effects;
+
+private:
+  virtual void Execute() override;
+};
+
 class EZ_PARTICLEPLUGIN_DLL ezParticleEffectInstance
 {
   friend class ezParticleWorldModule;
   friend class ezParticleffectUpdateTask;
+  friend class ezParticleEffectBatchUpdateTask;
 
 public:
   struct SharedInstance
@@ -49,6 +63,9 @@ public:
 
   bool HasActiveParticles() const;
 
+  /// \brief Returns the number of active particles in all particle systems of this effect.
+  ezUInt64 GetNumActiveParticles() const;
+
   void ClearParticleSystems();
   void ClearEventReactions();
 
@@ -109,8 +126,15 @@ private: // friend ezParticleWorldModule
   /// \brief Returns the task that is used to update the effect
   ezParticleffectUpdateTask* GetUpdateTask() { return &m_Task; }
 
+  /// \brief Whether the next update is potentially expensive, such that the effect should not share a task with other effects.
+  bool NeedsDedicatedUpdateTask() const { return m_PreSimulateDuration.GetSeconds() > 0.0; }
+
 private: // friend ezParticleffectUpdateTask
   friend class ezParticleEffectController;
+
+  /// \brief Called by the update tasks. Runs the pre-simulation, if necessary, and the regular update, and destroys the effect once it is finished.
+  void UpdateFromTask(const ezTime& tDiff);
+
   /// \brief If the effect wants to skip all the initial behavior, this simulates it multiple times before it is shown the first time.
   void PreSimulate();
 
@@ -27,7 +27,7 @@ bool ezParticleEmitter::IsContinuous() const
   return false;
 }
 
-void ezParticleEmitter::Process(ezUInt64 uiNumElements) {}
+void ezParticleEmitter::ProcessRange(ezUInt64 uiStartIndex, ezUInt64 uiNumElements) {}
 void ezParticleEmitter::ProcessEventQueue(ezParticleEventQueue queue) {}
 
 
@@ -42,7 +42,9 @@ class EZ_PARTICLEPLUGIN_DLL ezParticleEmitter : public ezParticleModule
 
 protected:
   virtual bool IsContinuous() const;
-  virtual void Process(ezUInt64 uiNumElements) final override;
+  virtual bool SupportsRangeProcessing() const final override { return true; }
+  virtual void Process(ezUInt64 uiNumElements) final override { ProcessRange(0, uiNumElements); }
+  virtual void ProcessRange(ezUInt64 uiStartIndex, ezUInt64 uiNumElements) final override;
 
   /// \brief Called once per update. Must return how many new particles are to be spawned.
   virtual ezUInt32 ComputeSpawnCount(const ezTime& tDiff) = 0;
@@ -103,19 +103,22 @@ void ezParticleFinalizer_Age::InitializeElements(ezUInt64 uiStartIndex, ezUInt64
   }
 }
 
-void ezParticleFinalizer_Age::Process(ezUInt64 uiNumElements)
+void ezParticleFinalizer_Age::ProcessRange(ezUInt64 uiStartIndex, ezUInt64 uiNumElements)
 {
-  EZ_PROFILE_SCOPE("PFX: Age");
-
   ezFloat16Vec2* pLifeTime = m_pStreamLifeTime->GetWritableData<ezFloat16Vec2>();
 
   const float tDiff = (float)m_TimeDiff.GetSeconds();
 
-  for (ezUInt32 i = 0; i < uiNumElements; ++i)
+  // the life time is stored as a half float, convert it only once per particle
+  for (ezUInt64 i = uiStartIndex; i < uiStartIndex + uiNumElements; ++i)
   {
-    pLifeTime[i].x = pLifeTime[i].x - tDiff;
+    const float fLifeTime = pLifeTime[i].x - tDiff;
 
-    if (pLifeTime[i].x <= 0)
+    if (fLifeTime > 0)
+    {
+      pLifeTime[i].x = fLifeTime;
+    }
+    else
     {
       pLifeTime[i].x = 0;
 
@@ -42,12 +42,10 @@ void ezParticleFinalizer_LastPosition::CreateRequiredStreams()
   CreateStream("LastPosition", ezProcessingStream::DataType::Float3, &m_pStreamLastPosition, false);
 }
 
-void ezParticleFinalizer_LastPosition::Process(ezUInt64 uiNumElements)
+void ezParticleFinalizer_LastPosition::ProcessRange(ezUInt64 uiStartIndex, ezUInt64 uiNumElements)
 {
-  EZ_PROFILE_SCOPE("PFX: LastPosition");
-
-  ezProcessingStreamIterator<ezVec4> itPosition(m_pStreamPosition, uiNumElements, 0);
-  ezProcessingStreamIterator<ezVec3> itLastPosition(m_pStreamLastPosition, uiNumElements, 0);
+  ezProcessingStreamIterator<ezVec4> itPosition(m_pStreamPosition, uiNumElements, uiStartIndex);
+  ezProcessingStreamIterator<ezVec3> itLastPosition(m_pStreamLastPosition, uiNumElements, uiStartIndex);
 
   while (!itPosition.HasReachedEnd())
   {
@@ -5,6 +5,7 @@
 #include <Foundation/Math/Declarations.h>
 #include <Foundation/Math/Float16.h>
 #include <Foundation/Profiling/Profiling.h>
+#include <Foundation/Threading/Lock.h>
 #include <ParticlePlugin/Finalizer/ParticleFinalizer_Volume.h>
 #include <ParticlePlugin/Effect/ParticleEffectInstance.h>
 #include <ParticlePlugin/Events/ParticleEvent.h>
@@ -45,14 +46,22 @@ void ezParticleFinalizer_Volume::QueryOptionalStreams()
   m_pStreamSize = GetOwnerSystem()->QueryStream("Size", ezProcessingStream::DataType::Half);
 }
 
-void ezParticleFinalizer_Volume::Process(ezUInt64 uiNumElements)
+void ezParticleFinalizer_Volume::StepParticleSystem(const ezTime& tDiff, ezUInt32 uiNumNewParticles)
+{
+  ezParticleFinalizer::StepParticleSystem(tDiff, uiNumNewParticles);
+
+  m_Volume.SetInvalid();
+  m_fMaxSize = 0.0f;
+}
+
+void ezParticleFinalizer_Volume::ProcessRange(ezUInt64 uiStartIndex, ezUInt64 uiNumElements)
 {
   if (!GetOwnerEffect()->NeedsBoundingVolumeUpdate())
     return;
 
   EZ_PROFILE_SCOPE("PFX: Volume");
 
-  const ezSimdVec4f* pPosition = m_pStreamPosition->GetData<ezSimdVec4f>();
+  const ezSimdVec4f* pPosition = m_pStreamPosition->GetData<ezSimdVec4f>() + uiStartIndex;
 
   ezBoundingBoxSphere volume;
   volume.SetFromPoints(reinterpret_cast<const ezVec3*>(pPosition), static_cast<ezUInt32>(uiNumElements), sizeof(ezVec4));
@@ -61,7 +70,7 @@ void ezParticleFinalizer_Volume::Process(ezUInt64 uiNumElements)
 
   if (m_pStreamSize != nullptr)
   {
-    const ezFloat16* pSize = m_pStreamSize->GetData<ezFloat16>();
+    const ezFloat16* pSize = m_pStreamSize->GetData<ezFloat16>() + uiStartIndex;
 
     ezUInt32 idx = 0;
 
@@ -95,5 +104,21 @@ void ezParticleFinalizer_Volume::Process(ezUInt64 uiNumElements)
 
   const float fms = ezMath::Max(fms0123, fms4567);
 
-  GetOwnerSystem()->SetBoundingVolume(volume, fms);
+  EZ_LOCK(m_VolumeMutex);
+
+  if (m_Volume.IsValid())
+    m_Volume.ExpandToInclude(volume);
+  else
+    m_Volume = volume;
+
+  m_fMaxSize = ezMath::Max(m_fMaxSize, fms);
+}
+
+void ezParticleFinalizer_Volume::FinishProcessing()
+{
+  if (!GetOwnerEffect()->NeedsBoundingVolumeUpdate())
+    return;
+
+  // without any particles the volume stays invalid and is ignored by the effect
+  GetOwnerSystem()->SetBoundingVolume(m_Volume, m_fMaxSize);
 }
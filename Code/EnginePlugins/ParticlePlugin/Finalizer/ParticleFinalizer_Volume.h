@@ -1,6 +1,8 @@
 #pragma once
 
 #include <ParticlePlugin/Finalizer/ParticleFinalizer.h>
+#include <Foundation/Math/BoundingBoxSphere.h>
+#include <Foundation/Threading/Mutex.h>
 #include <Foundation/Types/VarianceTypes.h>
 
 class ezPhysicsWorldModuleInterface;
@@ -29,8 +31,17 @@ public:
   virtual void QueryOptionalStreams() override;
 
 protected:
-  virtual void Process(ezUInt64 uiNumElements) override;
+  virtual bool SupportsRangeProcessing() const override { return true; }
+  virtual void Process(ezUInt64 uiNumElements) override { ProcessRange(0, uiNumElements); }
+  virtual void ProcessRange(ezUInt64 uiStartIndex, ezUInt64 uiNumElements) override;
+  virtual void FinishProcessing() override;
+  virtual void StepParticleSystem(const ezTime& tDiff, ezUInt32 uiNumNewParticles) override;
 
   ezProcessingStream* m_pStreamPosition = nullptr;
   const ezProcessingStream* m_pStreamSize = nullptr;
+
+  // the volumes of all processed ranges are merged into these
+  ezMutex m_VolumeMutex;
+  ezBoundingBoxSphere m_Volume;
+  float m_fMaxSize = 0.0f;
 };
@@ -40,6 +40,8 @@ class EZ_PARTICLEPLUGIN_DLL ezParticleInitializer : public ezParticleModule
 protected:
   ezParticleInitializer();
 
+  virtual bool SupportsRangeProcessing() const final override { return true; }
   virtual void Process(ezUInt64 uiNumElements) final override {}
+  virtual void ProcessRange(ezUInt64 uiStartIndex, ezUInt64 uiNumElements) final override {}
 
 };
@@ -0,0 +1,138 @@
+#include <ParticlePluginPCH.h>
+
+#include <ParticlePlugin/Module/ParticleKernels.h>
+
+// Four ezVec3 occupy exactly three SIMD registers, so the vec3 kernels work on blocks of four particles
+// and handle the remaining ones with scalar code.
+// Without SIMD support the blocks only add overhead, in that case all particles go through the scalar code.
+
+static EZ_ALWAYS_INLINE ezUInt32 GetNumBlocks(ezUInt32 uiNumElements)
+{
+#if EZ_SIMD_IMPLEMENTATION == EZ_SIMD_IMPLEMENTATION_FPU
+  return 0;
+#else
+  return uiNumElements / 4;
+#endif
+}
+
+void ezParticleKernels::AddVec3(ezVec3* pData, ezUInt32 uiNumElements, const ezVec3& vAdd)
+{
+  const ezUInt32 uiNumBlocks = GetNumBlocks(uiNumElements);
+
+  // the addend, repeated over three registers: xyzx yzxy zxyz
+  const ezSimdVec4f add0(vAdd.x, vAdd.y, vAdd.z, vAdd.x);
+  const ezSimdVec4f add1(vAdd.y, vAdd.z, vAdd.x, vAdd.y);
+  const ezSimdVec4f add2(vAdd.z, vAdd.x, vAdd.y, vAdd.z);
+
+  float* pFloats = &pData->x;
+  for (ezUInt32 i = 0; i < uiNumBlocks; ++i, pFloats += 12)
+  {
+    ezSimdVec4f v0, v1, v2;
+    v0.Load<4>(pFloats + 0);
+    v1.Load<4>(pFloats + 4);
+    v2.Load<4>(pFloats + 8);
+
+    (v0 + add0).Store<4>(pFloats + 0);
+    (v1 + add1).Store<4>(pFloats + 4);
+    (v2 + add2).Store<4>(pFloats + 8);
+  }
+
+  for (ezUInt32 i = uiNumBlocks * 4; i < uiNumElements; ++i)
+  {
+    pData[i] += vAdd;
+  }
+}
+
+void ezParticleKernels::ScaleVec3(ezVec3* pData, ezUInt32 uiNumElements, float fScale)
+{
+  const ezUInt32 uiNumBlocks = GetNumBlocks(uiNumElements);
+  const ezSimdFloat scale(fScale);
+
+  float* pFloats = &pData->x;
+  for (ezUInt32 i = 0; i < uiNumBlocks; ++i, pFloats += 12)
+  {
+    ezSimdVec4f v0, v1, v2;
+    v0.Load<4>(pFloats + 0);
+    v1.Load<4>(pFloats + 4);
+    v2.Load<4>(pFloats + 8);
+
+    (v0 * scale).Store<4>(pFloats + 0);
+    (v1 * scale).Store<4>(pFloats + 4);
+    (v2 * scale).Store<4>(pFloats + 8);
+  }
+
+  for (ezUInt32 i = uiNumBlocks * 4; i < uiNumElements; ++i)
+  {
+    pData[i] *= fScale;
+  }
+}
+
+void ezParticleKernels::AddVec4(ezVec4* pData, ezUInt32 uiNumElements, const ezSimdVec4f& vAdd)
+{
+  const ezUInt32 uiNumBlocks = GetNumBlocks(uiNumElements);
+
+  float* pFloats = &pData->x;
+  for (ezUInt32 i = 0; i < uiNumBlocks; ++i, pFloats += 16)
+  {
+    ezSimdVec4f v0, v1, v2, v3;
+    v0.Load<4>(pFloats + 0);
+    v1.Load<4>(pFloats + 4);
+    v2.Load<4>(pFloats + 8);
+    v3.Load<4>(pFloats + 12);
+
+    (v0 + vAdd).Store<4>(pFloats + 0);
+    (v1 + vAdd).Store<4>(pFloats + 4);
+    (v2 + vAdd).Store<4>(pFloats + 8);
+    (v3 + vAdd).Store<4>(pFloats + 12);
+  }
+
+  ezVec4 add;
+  vAdd.Store<4>(&add.x);
+
+  for (ezUInt32 i = uiNumBlocks * 4; i < uiNumElements; ++i)
+  {
+    pData[i] += add;
+  }
+}
+
+void ezParticleKernels::ApplyVelocity(ezVec4* pPosition, const ezVec3* pVelocity, ezUInt32 uiNumElements, float fTimeDiff)
+{
+  const ezUInt32 uiNumBlocks = GetNumBlocks(uiNumElements);
+
+  // zero in w, such that the w component of the positions stays untouched
+  const ezSimdVec4f timeDiff(fTimeDiff, fTimeDiff, fTimeDiff, 0.0f);
+
+  float* pPosFloats = &pPosition->x;
+  const float* pVelFloats = &pVelocity->x;
+  for (ezUInt32 i = 0; i < uiNumBlocks; ++i, pPosFloats += 16, pVelFloats += 12)
+  {
+    ezSimdVec4f vel0, vel1, vel2;
+    vel0.Load<4>(pVelFloats + 0); // x0 y0 z0 x1
+    vel1.Load<4>(pVelFloats + 4); // y1 z1 x2 y2
+    vel2.Load<4>(pVelFloats + 8); // z2 x3 y3 z3
+
+    // deinterleave into one register per particle, the w components are masked out by the time diff
+    const ezSimdVec4f velA = vel0;
+    const ezSimdVec4f velB = vel0.GetCombined<ezSwizzle::ZWXY>(vel1).Get<ezSwizzle::YZWW>();
+    const ezSimdVec4f velC = vel1.GetCombined<ezSwizzle::ZWXY>(vel2);
+    const ezSimdVec4f velD = vel2.Get<ezSwizzle::YZWW>();
+
+    ezSimdVec4f posA, posB, posC, posD;
+    posA.Load<4>(pPosFloats + 0);
+    posB.Load<4>(pPosFloats + 4);
+    posC.Load<4>(pPosFloats + 8);
+    posD.Load<4>(pPosFloats + 12);
+
+    ezSimdVec4f::MulAdd(velA, timeDiff, posA).Store<4>(pPosFloats + 0);
+    ezSimdVec4f::MulAdd(velB, timeDiff, posB).Store<4>(pPosFloats + 4);
+    ezSimdVec4f::MulAdd(velC, timeDiff, posC).Store<4>(pPosFloats + 8);
+    ezSimdVec4f::MulAdd(velD, timeDiff, posD).Store<4>(pPosFloats + 12);
+  }
+
+  for (ezUInt32 i = uiNumBlocks * 4; i < uiNumElements; ++i)
+  {
+    ezVec3& pos = reinterpret_cast<ezVec3&>(pPosition[i]);
+
+    pos += pVelocity[i] * fTimeDiff;
+  }
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <Foundation/Math/Vec3.h>
+#include <Foundation/Math/Vec4.h>
+#include <Foundation/SimdMath/SimdVec4f.h>
+#include <ParticlePlugin/ParticlePluginDLL.h>
+
+/// \brief Vectorized inner loops that are shared by the particle behaviors and finalizers.
+///
+/// All functions work on plain arrays, typically the data of a particle stream, and handle four particles per iteration.
+/// The data does not need to be aligned, so any sub-range of a stream can be passed in.
+namespace ezParticleKernels
+{
+  /// \brief pData[i] += vAdd
+  EZ_PARTICLEPLUGIN_DLL void AddVec3(ezVec3* pData, ezUInt32 uiNumElements, const ezVec3& vAdd);
+
+  /// \brief pData[i] *= fScale
+  EZ_PARTICLEPLUGIN_DLL void ScaleVec3(ezVec3* pData, ezUInt32 uiNumElements, float fScale);
+
+  /// \brief pData[i] += vAdd
+  EZ_PARTICLEPLUGIN_DLL void AddVec4(ezVec4* pData, ezUInt32 uiNumElements, const ezSimdVec4f& vAdd);
+
+  /// \brief pPosition[i].xyz += pVelocity[i] * fTimeDiff, the w component of the positions is not modified.
+  EZ_PARTICLEPLUGIN_DLL void ApplyVelocity(ezVec4* pPosition, const ezVec3* pVelocity, ezUInt32 uiNumElements, float fTimeDiff);
+} // namespace ezParticleKernels
+
+/// \brief Stores a function over [0; 1] as equally spaced samples, such that it can be evaluated with a single lerp.
+///
+/// Curves and gradients are expensive to evaluate, so behaviors sample them once per step into such a table
+/// instead of evaluating them once per particle.
+template <typename Type, ezUInt32 NumSamples = 64>
+class ezParticleLookupTable
+{
+public:
+  /// \brief Fills the table by calling \a func with positions from 0 to 1.
+  template <typename Func>
+  void Sample(Func func)
+  {
+    for (ezUInt32 i = 0; i < NumSamples; ++i)
+    {
+      m_Samples[i] = func(i / static_cast<float>(NumSamples - 1));
+    }
+  }
+
+  /// \brief Returns the interpolated value at \a x. Values outside of [0; 1] (and NaN) are clamped.
+  EZ_FORCE_INLINE Type Lookup(float x) const
+  {
+    // written such that NaN ends up as zero
+    const float fPos = (x > 0.0f) ? ((x < 1.0f) ? x : 1.0f) : 0.0f;
+    const float fIndex = fPos * (NumSamples - 1);
+    const ezUInt32 uiIndex = ezMath::Min(static_cast<ezUInt32>(fIndex), NumSamples - 2);
+
+    return ezMath::Lerp(m_Samples[uiIndex], m_Samples[uiIndex + 1], fIndex - uiIndex);
+  }
+
+private:
+  EZ_CHECK_AT_COMPILETIME_MSG(NumSamples >= 2, "A lookup table needs at least two samples");
+
+  Type m_Samples[NumSamples];
+};
@@ -43,7 +43,9 @@ protected:
   ezParticleStream();
   virtual void Initialize(ezParticleSystemInstance* pOwner) {}
   virtual ezResult UpdateStreamBindings() final override;
+  virtual bool SupportsRangeProcessing() const final override { return true; }
   virtual void Process(ezUInt64 uiNumElements) final override {}
+  virtual void ProcessRange(ezUInt64 uiStartIndex, ezUInt64 uiNumElements) final override {}
 
   /// \brief The default implementation initializes all data with zero.
   virtual void InitializeElements(ezUInt64 uiStartIndex, ezUInt64 uiNumElements) override;
@@ -1,10 +1,12 @@
 #include <ParticlePluginPCH.h>
 
 #include <Core/World/World.h>
+#include <Foundation/Configuration/CVar.h>
 #include <Foundation/DataProcessing/Stream/DefaultImplementations/ZeroInitializer.h>
 #include <Foundation/DataProcessing/Stream/ProcessingStreamIterator.h>
 #include <Foundation/DataProcessing/Stream/ProcessingStreamProcessor.h>
 #include <Foundation/Profiling/Profiling.h>
+#include <Foundation/Threading/TaskSystem.h>
 #include <GameEngine/Interfaces/PhysicsWorldModule.h>
 #include <ParticlePlugin/Behavior/ParticleBehavior.h>
 #include <ParticlePlugin/Effect/ParticleEffectInstance.h>
@@ -18,6 +20,9 @@
 #include <ParticlePlugin/WorldModule/ParticleWorldModule.h>
 #include <RendererCore/RenderWorld/RenderWorld.h>
 
+ezCVarInt CVarParallelUpdateThreshold("pfx_ParallelUpdateThreshold", 8192, ezCVarFlags::Default,
+  "Particle systems with at least this many particles are simulated on multiple threads. Zero disables it.");
+
 bool ezParticleSystemInstance::HasActiveParticles() const
 {
   return m_StreamGroup.GetNumActiveElements() > 0;
@@ -450,7 +455,37 @@ ezParticleSystemState::Enum ezParticleSystemInstance::Update(const ezTime& tDiff
 
   {
     EZ_PROFILE_SCOPE("PFX: System Process");
-    m_StreamGroup.Process();
+
+    // Large systems are split into ranges that are simulated on multiple threads. This is only possible if every module only touches
+    // the particles in its range, small systems are not worth the task overhead.
+    const ezUInt32 uiNumActive = static_cast<ezUInt32>(m_StreamGroup.GetNumActiveElements());
+
+    const ezInt32 iThreshold = CVarParallelUpdateThreshold;
+
+    if (iThreshold > 0 && uiNumActive >= static_cast<ezUInt32>(iThreshold) && m_StreamGroup.SupportsRangeProcessing())
+    {
+      m_StreamGroup.BeginRangeProcessing();
+
+      ezParallelForParams params;
+      params.uiBinSize = s_uiParticlesPerRange;
+      params.uiMaxTasksPerThread = 2;
+
+      ezTaskSystem::ParallelForIndexed(0, uiNumActive,
+        [this](ezUInt32 uiStartIndex, ezUInt32 uiEndIndex) {
+          // process in small chunks, such that all modules run over the same particles while they are in the cache
+          for (ezUInt32 uiChunkStart = uiStartIndex; uiChunkStart < uiEndIndex; uiChunkStart += s_uiParticlesPerChunk)
+          {
+            m_StreamGroup.ProcessRange(uiChunkStart, ezMath::Min(s_uiParticlesPerChunk, uiEndIndex - uiChunkStart));
+          }
+        },
+        "PFX: Particle Range", params);
+
+      m_StreamGroup.EndRangeProcessing();
+    }
+    else
+    {
+      m_StreamGroup.Process();
+    }
   }
 
   if (m_bEmitterEnabled)
@@ -77,6 +77,9 @@ public:
   float GetSpawnCountMultiplier() const { return m_fSpawnCountMultiplier; }
 
 private:
+  static constexpr ezUInt32 s_uiParticlesPerRange = 2048;
+  static constexpr ezUInt32 s_uiParticlesPerChunk = 256;
+
   bool IsEmitterConfigEqual(const ezParticleSystemDescriptor* pTemplate) const;
   bool IsInitializerConfigEqual(const ezParticleSystemDescriptor* pTemplate) const;
   bool IsBehaviorConfigEqual(const ezParticleSystemDescriptor* pTemplate) const;
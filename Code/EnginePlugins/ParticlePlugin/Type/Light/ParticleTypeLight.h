@@ -46,7 +46,9 @@ public:
   virtual void ExtractTypeRenderData(const ezView& view, ezExtractedRenderData& extractedRenderData, const ezTransform& instanceTransform, ezUInt64 uiExtractedFrame) const override;
 
 protected:
+  virtual bool SupportsRangeProcessing() const override { return true; }
   virtual void Process(ezUInt64 uiNumElements) override {}
+  virtual void ProcessRange(ezUInt64 uiStartIndex, ezUInt64 uiNumElements) override {}
 
   ezProcessingStream* m_pStreamPosition;
   ezProcessingStream* m_pStreamSize;
@@ -42,7 +42,9 @@ public:
 
 protected:
   virtual void InitializeElements(ezUInt64 uiStartIndex, ezUInt64 uiNumElements) override;
+  virtual bool SupportsRangeProcessing() const override { return true; }
   virtual void Process(ezUInt64 uiNumElements) override {}
+  virtual void ProcessRange(ezUInt64 uiStartIndex, ezUInt64 uiNumElements) override {}
 
   bool QueryMeshAndMaterialInfo() const;
 
@@ -30,7 +30,9 @@ public:
   virtual float GetMaxParticleRadius(float fParticleSize) const override { return 0.0f; }
 
 protected:
+  virtual bool SupportsRangeProcessing() const override { return true; }
   virtual void Process(ezUInt64 uiNumElements) override {}
+  virtual void ProcessRange(ezUInt64 uiStartIndex, ezUInt64 uiNumElements) override {}
 
   ezProcessingStream* m_pStreamPosition;
   ezProcessingStream* m_pStreamColor;
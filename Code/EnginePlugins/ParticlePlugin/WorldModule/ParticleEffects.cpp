@@ -1,10 +1,14 @@
 #include <ParticlePluginPCH.h>
 
 #include <Core/World/World.h>
+#include <Foundation/Configuration/CVar.h>
 #include <ParticlePlugin/Resources/ParticleEffectResource.h>
 #include <ParticlePlugin/WorldModule/ParticleWorldModule.h>
 #include <RendererCore/RenderWorld/RenderWorld.h>
 
+ezCVarInt CVarMaxParticlesPerBatch("pfx_MaxParticlesPerBatch", 2048, ezCVarFlags::Default,
+  "Particle effects with fewer particles than this are updated together with other small effects in a single task.");
+
 ezParticleEffectHandle ezParticleWorldModule::InternalCreateEffectInstance(const ezParticleEffectResourceHandle& hResource,
                                                                            ezUInt64 uiRandomSeed, bool bIsShared,
                                                                            ezArrayPtr<ezParticleEffectFloatParam> floatParams,
@@ -139,18 +143,55 @@ void ezParticleWorldModule::UpdateEffects(const ezWorldModule::UpdateContext& co
 
   m_EffectUpdateTaskGroup = ezTaskSystem::CreateTaskGroup(ezTaskPriority::LateThisFrame);
 
+  // Effects with many particles get a task of their own (and may split up their systems further),
+  // all others are grouped together, such that the task overhead does not dominate their update.
+  const ezUInt64 uiMaxParticlesPerBatch = static_cast<ezUInt64>(ezMath::Max<ezInt32>(CVarMaxParticlesPerBatch, 0));
+  const ezUInt32 uiMaxEffectsPerBatch = 64;
+
+  ezUInt32 uiNumBatchTasks = 0;
+  ezUInt64 uiNumParticlesInBatch = 0;
+  ezParticleEffectBatchUpdateTask* pBatchTask = nullptr;
+
   const ezTime tDiff = GetWorld()->GetClock().GetTimeDiff();
   for (ezUInt32 i = 0; i < m_ParticleEffects.GetCount(); ++i)
   {
-    if (!m_ParticleEffects[i].ShouldBeUpdated())
+    ezParticleEffectInstance& effect = m_ParticleEffects[i];
+
+    if (!effect.ShouldBeUpdated())
       continue;
 
-    m_ParticleEffects[i].ProcessEventQueues();
+    effect.ProcessEventQueues();
+
+    const ezUInt64 uiNumParticles = effect.GetNumActiveParticles();
 
-    ezParticleffectUpdateTask* pTask = m_ParticleEffects[i].GetUpdateTask();
-    pTask->m_UpdateDiff = tDiff;
+    if (uiNumParticles >= uiMaxParticlesPerBatch || effect.NeedsDedicatedUpdateTask())
+    {
+      ezParticleffectUpdateTask* pTask = effect.GetUpdateTask();
+      pTask->m_UpdateDiff = tDiff;
+
+      ezTaskSystem::AddTaskToGroup(m_EffectUpdateTaskGroup, pTask);
+      continue;
+    }
+
+    if (pBatchTask == nullptr || uiNumParticlesInBatch + uiNumParticles > uiMaxParticlesPerBatch || pBatchTask->m_Effects.GetCount() >= uiMaxEffectsPerBatch)
+    {
+      if (uiNumBatchTasks == m_BatchUpdateTasks.GetCount())
+      {
+        m_BatchUpdateTasks.PushBack(EZ_DEFAULT_NEW(ezParticleEffectBatchUpdateTask));
+      }
+
+      pBatchTask = m_BatchUpdateTasks[uiNumBatchTasks].Borrow();
+      ++uiNumBatchTasks;
+
+      pBatchTask->m_UpdateDiff = tDiff;
+      pBatchTask->m_Effects.Clear();
+      uiNumParticlesInBatch = 0;
+
+      ezTaskSystem::AddTaskToGroup(m_EffectUpdateTaskGroup, pBatchTask);
+    }
 
-    ezTaskSystem::AddTaskToGroup(m_EffectUpdateTaskGroup, pTask);
+    pBatchTask->m_Effects.PushBack(&effect);
+    uiNumParticlesInBatch += uiNumParticles;
   }
 
   ezTaskSystem::StartTaskGroup(m_EffectUpdateTaskGroup);
@@ -274,6 +274,11 @@ void ezParticleWorldModule::WorldClear()
   m_ParticleSystems.Clear();
   m_ParticleEffectsFreeList.Clear();
   m_ParticleSystemFreeList.Clear();
+
+  for (auto& pTask : m_BatchUpdateTasks)
+  {
+    pTask->m_Effects.Clear();
+  }
 }
 
 EZ_STATICLINK_FILE(ParticlePlugin, ParticlePlugin_WorldModule_ParticleWorldModule);
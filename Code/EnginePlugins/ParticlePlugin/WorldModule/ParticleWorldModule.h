@@ -95,6 +95,7 @@ private:
   ezDeque<ezParticleSystemInstance> m_ParticleSystems;
   ezDynamicArray<ezParticleSystemInstance*> m_ParticleSystemFreeList;
   ezTaskGroupID m_EffectUpdateTaskGroup;
+  ezDynamicArray<ezUniquePtr<ezParticleEffectBatchUpdateTask>> m_BatchUpdateTasks;
   ezMap<ezString, ezParticleStreamFactory*> m_StreamFactories;
   ezHashTable<const ezRTTI*, ezWorldModule*> m_WorldModuleCache;
 };
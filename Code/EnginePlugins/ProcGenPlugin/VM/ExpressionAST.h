@@ -42,7 +42,10 @@ public:
       LastBinary,
 
       // Ternary
+      FirstTernary,
       Select,
+      MultiplyAdd,
+      LastTernary,
 
       // Constant
       FloatConstant,
@@ -60,6 +63,8 @@ public:
 
     static bool IsUnary(Enum nodeType);
     static bool IsBinary(Enum nodeType);
+    static bool IsTernary(Enum nodeType);
+    static bool IsCommutative(Enum nodeType);
     static bool IsConstant(Enum nodeType);
     static bool IsInput(Enum nodeType);
     static bool IsOutput(Enum nodeType);
@@ -83,11 +88,13 @@ public:
     Node* m_pRightOperand = nullptr;
   };
 
-  struct Select : public Node
+  /// \brief Select returns the second operand where the first operand is not zero and the third operand otherwise.
+  /// MultiplyAdd returns first * second + third.
+  struct TernaryOperator : public Node
   {
-    Node* m_pCondition = nullptr;
-    Node* m_pTrueOperand = nullptr;
-    Node* m_pFalseOperand = nullptr;
+    Node* m_pFirstOperand = nullptr;
+    Node* m_pSecondOperand = nullptr;
+    Node* m_pThirdOperand = nullptr;
   };
 
   struct Constant : public Node
@@ -118,7 +125,8 @@ public:
 
   UnaryOperator* CreateUnaryOperator(NodeType::Enum type, Node* pOperand);
   BinaryOperator* CreateBinaryOperator(NodeType::Enum type, Node* pLeftOperand, Node* pRightOperand);
-  Select* CreateSelect(Node* pCondition, Node* pTrueOperand, Node* pFalseOperand);
+  TernaryOperator* CreateTernaryOperator(NodeType::Enum type, Node* pFirstOperand, Node* pSecondOperand, Node* pThirdOperand);
+  TernaryOperator* CreateSelect(Node* pCondition, Node* pTrueOperand, Node* pFalseOperand);
   Constant* CreateConstant(const ezVariant& value);
   Input* CreateInput(const ezHashedString& sName);
   Output* CreateOutput(const ezHashedString& sName, Node* pExpression);
@@ -54,6 +54,14 @@ public:
 
       LastBinary,
 
+      // Ternary
+      FirstTernary,
+
+      MulAdd_RRR,
+      Select_RRR,
+
+      LastTernary,
+
       Call,
 
       Count
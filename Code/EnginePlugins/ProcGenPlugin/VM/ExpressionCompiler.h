@@ -10,14 +10,41 @@ public:
   ezExpressionCompiler();
   ~ezExpressionCompiler();
 
-  ezResult Compile(ezExpressionAST& ast, ezExpressionByteCode& out_byteCode);
+  /// \brief Compiles the AST into byte code. The AST is modified in the process.
+  ///
+  /// If bOptimize is false, only the transformations that are necessary to generate byte code are applied,
+  /// which is mainly useful to verify the optimizations.
+  ezResult Compile(ezExpressionAST& ast, ezExpressionByteCode& out_byteCode, bool bOptimize = true);
 
 private:
+  ezResult LowerAST(ezExpressionAST& ast);
+  ezResult OptimizeAST(ezExpressionAST& ast);
   ezResult BuildNodeInstructions(const ezExpressionAST& ast);
   ezResult UpdateRegisterLifetime(const ezExpressionAST& ast);
   ezResult AssignRegisters();
   ezResult GenerateByteCode(const ezExpressionAST& ast, ezExpressionByteCode& out_byteCode);
 
+  /// \brief Calls func for every node reachable from the outputs in post order and replaces the node with the returned one.
+  template <typename Func>
+  void TransformNodes(ezExpressionAST& ast, Func func);
+  ezExpressionAST::Node* ReplaceUnsupportedNode(ezExpressionAST& ast, ezExpressionAST::Node* pNode);
+  ezExpressionAST::Node* FoldAndDeduplicate(ezExpressionAST& ast, ezExpressionAST::Node* pNode);
+  ezExpressionAST::Node* FuseMultiplyAdd(ezExpressionAST& ast, ezExpressionAST::Node* pNode);
+  void CountNodeUses(const ezExpressionAST& ast);
+
+  struct TransformStackEntry
+  {
+    EZ_DECLARE_POD_TYPE();
+
+    ezExpressionAST::Node* m_pNode;
+    bool m_bChildrenDone;
+  };
+
+  ezHybridArray<TransformStackEntry, 64> m_TransformStack;
+  ezHashTable<const ezExpressionAST::Node*, ezExpressionAST::Node*> m_NodeReplacements;
+  ezHashTable<ezUInt64, ezExpressionAST::Node*> m_NodeDeduplication;
+  ezHashTable<const ezExpressionAST::Node*, ezUInt32> m_NodeUseCount;
+
   ezHybridArray<const ezExpressionAST::Node*, 64> m_NodeStack;
   ezHybridArray<const ezExpressionAST::Node*, 64> m_NodeInstructions;
   ezHashTable<const ezExpressionAST::Node*, ezUInt32> m_NodeToRegisterIndex;
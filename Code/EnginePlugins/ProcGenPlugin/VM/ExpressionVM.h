@@ -7,6 +7,11 @@ class ezExpressionByteCode;
 
 namespace ezExpression
 {
+  /// \brief Describes where the VM reads input data from or writes output data to.
+  ///
+  /// Integer streams are converted to float when read and truncated when written.
+  /// A vector stream provides one input or output per component. The name of the component is the name of the stream followed by
+  /// X, Y, Z, W or R, G, B, A, e.g. a Float3 stream called 'Position' provides 'PositionX', 'PositionY' and 'PositionZ'.
   struct Stream
   {
     struct Type
@@ -16,15 +21,14 @@ namespace ezExpression
       enum Enum
       {
         Float,
-        /*Float2, // not supported yet
-        Float3, // not supported yet
-        Float4, // not supported yet
+        Float2,
+        Float3,
+        Float4,
 
-        Int, // not supported yet
-        Int2, // not supported yet
-        Int3, // not supported yet
-        Int4, // not supported yet
-        */
+        Int,
+        Int2,
+        Int3,
+        Int4,
 
         Count
       };
@@ -36,6 +40,8 @@ namespace ezExpression
     ~Stream();
 
     ezUInt32 GetElementSize() const;
+    ezUInt32 GetNumComponents() const;
+    bool IsInteger() const;
     void ValidateDataSize(ezUInt32 uiNumInstances, const char* szDataName) const;
 
     ezHashedString m_sName;
@@ -45,11 +51,11 @@ namespace ezExpression
   };
 
   template <typename T>
-  Stream MakeStream(ezArrayPtr<T> data, ezUInt32 uiOffset, const ezHashedString& sName)
+  Stream MakeStream(ezArrayPtr<T> data, ezUInt32 uiOffset, const ezHashedString& sName, Stream::Type::Enum type = Stream::Type::Float)
   {
     auto byteData = data.ToByteArray().GetSubArray(uiOffset);
 
-    return Stream(sName, Stream::Type::Float, byteData, sizeof(T));
+    return Stream(sName, type, byteData, sizeof(T));
   }
 } // namespace ezExpression
 
@@ -67,13 +73,26 @@ public:
   ezResult Execute(const ezExpressionByteCode& byteCode, ezArrayPtr<const ezExpression::Stream> inputs, ezArrayPtr<ezExpression::Stream> outputs,
     ezUInt32 uiNumInstances, const ezExpression::GlobalData& globalData = ezExpression::GlobalData());
 
+  /// \brief Whether arithmetic instructions are executed on 8 instances at once with AVX. Enabled by default if the CPU supports AVX2.
+  void SetAVXEnabled(bool bEnabled);
+  bool IsAVXEnabled() const { return m_bAVXEnabled; }
+
+  /// \brief Returns whether the CPU supports the AVX code path.
+  static bool IsAVXSupported();
+
 private:
+  ezResult MapStreams(ezArrayPtr<const ezHashedString> names, ezArrayPtr<const ezExpression::Stream> streams, ezUInt32 uiNumInstances,
+    const char* szDataName, ezDynamicArray<ezUInt32>& out_Mapping);
+
   ezDynamicArray<ezSimdVec4f, ezAlignedAllocatorWrapper> m_Registers;
 
+  // stream index in the lower 16 bits, component index in the upper 16 bits
   ezDynamicArray<ezUInt32> m_InputMapping;
   ezDynamicArray<ezUInt32> m_OutputMapping;
   ezDynamicArray<ezUInt32> m_FunctionMapping;
 
+  bool m_bAVXEnabled = false;
+
   struct FunctionInfo
   {
     ezHashedString m_sName;
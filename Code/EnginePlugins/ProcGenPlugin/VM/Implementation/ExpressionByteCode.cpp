@@ -57,6 +57,14 @@ namespace
 
     "",
 
+    // Ternary
+    "",
+
+    "MulAdd_RRR",
+    "Select_RRR",
+
+    "",
+
     "Call",
   };
 
@@ -144,6 +152,15 @@ void ezExpressionByteCode::Disassemble(ezStringBuilder& out_sDisassembly) const
         out_sDisassembly.AppendFormat("{0} r{1} r{2} r{3}\n", szOpCode, r, a, b);
       }
     }
+    else if (opCode > OpCode::FirstTernary && opCode < OpCode::LastTernary)
+    {
+      ezUInt32 r = GetRegisterIndex(pByteCode, 1);
+      ezUInt32 a = GetRegisterIndex(pByteCode, 1);
+      ezUInt32 b = GetRegisterIndex(pByteCode, 1);
+      ezUInt32 c = GetRegisterIndex(pByteCode, 1);
+
+      out_sDisassembly.AppendFormat("{0} r{1} r{2} r{3} r{4}\n", szOpCode, r, a, b, c);
+    }
     else if (opCode == OpCode::Call)
     {
       ezUInt32 uiIndex = GetFunctionIndex(pByteCode);
@@ -198,7 +215,7 @@ void ezExpressionByteCode::Save(ezStreamWriter& stream) const
   }
 
   {
-    chunk.BeginChunk("Code", 2);
+    chunk.BeginChunk("Code", 3);
 
     chunk << m_ByteCode.GetCount();
     chunk.WriteBytes(m_ByteCode.GetData(), m_ByteCode.GetCount() * sizeof(StorageType));
@@ -238,7 +255,7 @@ ezResult ezExpressionByteCode::Load(ezStreamReader& stream)
     }
     else if (chunk.GetCurrentChunk().m_sChunkName == "Code")
     {
-      if (chunk.GetCurrentChunk().m_uiChunkVersion >= 2)
+      if (chunk.GetCurrentChunk().m_uiChunkVersion >= 3)
       {
         ezUInt32 uiByteCodeCount = 0;
         chunk >> uiByteCodeCount;
@@ -248,7 +265,7 @@ ezResult ezExpressionByteCode::Load(ezStreamReader& stream)
       }
       else
       {
-        ezLog::Error("Invalid Code Chunk Version {0}. Expected >= 2", chunk.GetCurrentChunk().m_uiChunkVersion);
+        ezLog::Error("Invalid Code Chunk Version {0}. Expected >= 3", chunk.GetCurrentChunk().m_uiChunkVersion);
 
         chunk.EndStream();
         return EZ_FAILURE;
@@ -1,5 +1,6 @@
 #include <ProcGenPluginPCH.h>
 
+#include <Foundation/Algorithm/HashingUtils.h>
 #include <ProcGenPlugin/VM/ExpressionByteCode.h>
 #include <ProcGenPlugin/VM/ExpressionCompiler.h>
 
@@ -40,18 +41,166 @@ namespace
         return ezExpressionByteCode::OpCode::Min_RR;
       case ezExpressionAST::NodeType::Max:
         return ezExpressionByteCode::OpCode::Max_RR;
+
+      case ezExpressionAST::NodeType::MultiplyAdd:
+        return ezExpressionByteCode::OpCode::MulAdd_RRR;
+      case ezExpressionAST::NodeType::Select:
+        return ezExpressionByteCode::OpCode::Select_RRR;
       default:
         EZ_ASSERT_NOT_IMPLEMENTED;
         return ezExpressionByteCode::OpCode::FirstUnary;
     }
   }
+
+  static bool GetConstantValue(const ezExpressionAST::Node* pNode, float& out_fValue)
+  {
+    if (!ezExpressionAST::NodeType::IsConstant(pNode->m_Type))
+      return false;
+
+    out_fValue = static_cast<const ezExpressionAST::Constant*>(pNode)->m_Value.Get<float>();
+    return true;
+  }
+
+  static bool IsConstantValue(const ezExpressionAST::Node* pNode, float fValue)
+  {
+    float fNodeValue = 0.0f;
+    return GetConstantValue(pNode, fNodeValue) && fNodeValue == fValue;
+  }
+
+  static float EvaluateUnary(ezExpressionAST::NodeType::Enum nodeType, float x)
+  {
+    switch (nodeType)
+    {
+      case ezExpressionAST::NodeType::Negate:
+        return -x;
+      case ezExpressionAST::NodeType::Absolute:
+        return ezMath::Abs(x);
+      case ezExpressionAST::NodeType::Sqrt:
+        return ezMath::Sqrt(x);
+      case ezExpressionAST::NodeType::Sin:
+        return ezMath::Sin(ezAngle::Radian(x));
+      case ezExpressionAST::NodeType::Cos:
+        return ezMath::Cos(ezAngle::Radian(x));
+      case ezExpressionAST::NodeType::Tan:
+        return ezMath::Tan(ezAngle::Radian(x));
+      case ezExpressionAST::NodeType::ASin:
+        return ezMath::ASin(x).GetRadian();
+      case ezExpressionAST::NodeType::ACos:
+        return ezMath::ACos(x).GetRadian();
+      case ezExpressionAST::NodeType::ATan:
+        return ezMath::ATan(x).GetRadian();
+      default:
+        EZ_ASSERT_NOT_IMPLEMENTED;
+        return 0.0f;
+    }
+  }
+
+  static float EvaluateBinary(ezExpressionAST::NodeType::Enum nodeType, float a, float b)
+  {
+    switch (nodeType)
+    {
+      case ezExpressionAST::NodeType::Add:
+        return a + b;
+      case ezExpressionAST::NodeType::Subtract:
+        return a - b;
+      case ezExpressionAST::NodeType::Multiply:
+        return a * b;
+      case ezExpressionAST::NodeType::Divide:
+        return a / b;
+      case ezExpressionAST::NodeType::Min:
+        return ezMath::Min(a, b);
+      case ezExpressionAST::NodeType::Max:
+        return ezMath::Max(a, b);
+      default:
+        EZ_ASSERT_NOT_IMPLEMENTED;
+        return 0.0f;
+    }
+  }
+
+  static float EvaluateTernary(ezExpressionAST::NodeType::Enum nodeType, float a, float b, float c)
+  {
+    switch (nodeType)
+    {
+      case ezExpressionAST::NodeType::Select:
+        return a != 0.0f ? b : c;
+      case ezExpressionAST::NodeType::MultiplyAdd:
+        return a * b + c;
+      default:
+        EZ_ASSERT_NOT_IMPLEMENTED;
+        return 0.0f;
+    }
+  }
+
+  static ezUInt64 ComputeNodeHash(const ezExpressionAST::Node* pNode)
+  {
+    ezHybridArray<ezUInt64, 16> values;
+    values.PushBack(pNode->m_Type.GetValue());
+
+    ezExpressionAST::NodeType::Enum nodeType = pNode->m_Type;
+    if (ezExpressionAST::NodeType::IsConstant(nodeType))
+    {
+      float fValue = static_cast<const ezExpressionAST::Constant*>(pNode)->m_Value.Get<float>();
+      values.PushBack(*reinterpret_cast<const ezUInt32*>(&fValue));
+    }
+    else if (ezExpressionAST::NodeType::IsInput(nodeType))
+    {
+      values.PushBack(static_cast<const ezExpressionAST::Input*>(pNode)->m_sName.GetHash());
+    }
+    else if (nodeType == ezExpressionAST::NodeType::FunctionCall)
+    {
+      values.PushBack(static_cast<const ezExpressionAST::FunctionCall*>(pNode)->m_sName.GetHash());
+    }
+
+    for (auto pChild : ezExpressionAST::GetChildren(pNode))
+    {
+      values.PushBack(reinterpret_cast<ezUInt64>(pChild));
+    }
+
+    return ezHashingUtils::xxHash64(values.GetData(), values.GetCount() * sizeof(ezUInt64));
+  }
+
+  static bool IsEqual(const ezExpressionAST::Node* pNodeA, const ezExpressionAST::Node* pNodeB)
+  {
+    if (pNodeA->m_Type != pNodeB->m_Type)
+      return false;
+
+    ezExpressionAST::NodeType::Enum nodeType = pNodeA->m_Type;
+    if (ezExpressionAST::NodeType::IsConstant(nodeType))
+    {
+      return static_cast<const ezExpressionAST::Constant*>(pNodeA)->m_Value == static_cast<const ezExpressionAST::Constant*>(pNodeB)->m_Value;
+    }
+    else if (ezExpressionAST::NodeType::IsInput(nodeType))
+    {
+      return static_cast<const ezExpressionAST::Input*>(pNodeA)->m_sName == static_cast<const ezExpressionAST::Input*>(pNodeB)->m_sName;
+    }
+    else if (nodeType == ezExpressionAST::NodeType::FunctionCall)
+    {
+      if (static_cast<const ezExpressionAST::FunctionCall*>(pNodeA)->m_sName != static_cast<const ezExpressionAST::FunctionCall*>(pNodeB)->m_sName)
+        return false;
+    }
+
+    auto childrenA = ezExpressionAST::GetChildren(pNodeA);
+    auto childrenB = ezExpressionAST::GetChildren(pNodeB);
+    return childrenA == childrenB;
+  }
 } // namespace
 
 ezExpressionCompiler::ezExpressionCompiler() = default;
 ezExpressionCompiler::~ezExpressionCompiler() = default;
 
-ezResult ezExpressionCompiler::Compile(ezExpressionAST& ast, ezExpressionByteCode& out_byteCode)
+ezResult ezExpressionCompiler::Compile(ezExpressionAST& ast, ezExpressionByteCode& out_byteCode, bool bOptimize /*= true*/)
 {
+  if (bOptimize)
+  {
+    if (OptimizeAST(ast).Failed())
+      return EZ_FAILURE;
+  }
+  else
+  {
+    if (LowerAST(ast).Failed())
+      return EZ_FAILURE;
+  }
+
   if (BuildNodeInstructions(ast).Failed())
     return EZ_FAILURE;
 
@@ -67,6 +216,266 @@ ezResult ezExpressionCompiler::Compile(ezExpressionAST& ast, ezExpressionByteCod
   return EZ_SUCCESS;
 }
 
+ezResult ezExpressionCompiler::LowerAST(ezExpressionAST& ast)
+{
+  TransformNodes(ast, [this](ezExpressionAST& astToTransform, ezExpressionAST::Node* pNode) { return ReplaceUnsupportedNode(astToTransform, pNode); });
+
+  return EZ_SUCCESS;
+}
+
+ezResult ezExpressionCompiler::OptimizeAST(ezExpressionAST& ast)
+{
+  // Fold constants, simplify trivial operations and merge duplicate nodes
+  m_NodeDeduplication.Clear();
+  TransformNodes(ast, [this](ezExpressionAST& astToTransform, ezExpressionAST::Node* pNode) { return FoldAndDeduplicate(astToTransform, pNode); });
+
+  // Merge multiplications into additions. This needs the final use count of every node, since a multiplication that is used
+  // somewhere else still has to be computed separately.
+  CountNodeUses(ast);
+  TransformNodes(ast, [this](ezExpressionAST& astToTransform, ezExpressionAST::Node* pNode) { return FuseMultiplyAdd(astToTransform, pNode); });
+
+  // Nodes that are not reachable from any output anymore are dropped automatically, since instructions and registers
+  // are only generated for reachable nodes.
+  return EZ_SUCCESS;
+}
+
+template <typename Func>
+void ezExpressionCompiler::TransformNodes(ezExpressionAST& ast, Func func)
+{
+  m_TransformStack.Clear();
+  m_NodeReplacements.Clear();
+
+  for (ezExpressionAST::Output* pOutputNode : ast.m_OutputNodes)
+  {
+    if (pOutputNode != nullptr)
+    {
+      m_TransformStack.PushBack({pOutputNode, false});
+    }
+  }
+
+  while (!m_TransformStack.IsEmpty())
+  {
+    TransformStackEntry entry = m_TransformStack.PeekBack();
+    m_TransformStack.PopBack();
+
+    // Nodes can be reached through multiple parents, only transform them once
+    if (m_NodeReplacements.Contains(entry.m_pNode))
+      continue;
+
+    auto children = ezExpressionAST::GetChildren(entry.m_pNode);
+
+    if (!entry.m_bChildrenDone)
+    {
+      m_TransformStack.PushBack({entry.m_pNode, true});
+
+      for (auto pChild : children)
+      {
+        if (pChild != nullptr && !m_NodeReplacements.Contains(pChild))
+        {
+          m_TransformStack.PushBack({pChild, false});
+        }
+      }
+    }
+    else
+    {
+      for (auto& pChild : children)
+      {
+        ezExpressionAST::Node* pReplacement = nullptr;
+        if (pChild != nullptr && m_NodeReplacements.TryGetValue(pChild, pReplacement))
+        {
+          pChild = pReplacement;
+        }
+      }
+
+      m_NodeReplacements.Insert(entry.m_pNode, func(ast, entry.m_pNode));
+    }
+  }
+}
+
+ezExpressionAST::Node* ezExpressionCompiler::ReplaceUnsupportedNode(ezExpressionAST& ast, ezExpressionAST::Node* pNode)
+{
+  // There is no negate instruction, subtract from zero instead
+  if (pNode->m_Type == ezExpressionAST::NodeType::Negate)
+  {
+    auto pUnary = static_cast<ezExpressionAST::UnaryOperator*>(pNode);
+    if (pUnary->m_pOperand != nullptr)
+    {
+      return ast.CreateBinaryOperator(ezExpressionAST::NodeType::Subtract, ast.CreateConstant(0.0f), pUnary->m_pOperand);
+    }
+  }
+
+  return pNode;
+}
+
+ezExpressionAST::Node* ezExpressionCompiler::FoldAndDeduplicate(ezExpressionAST& ast, ezExpressionAST::Node* pNode)
+{
+  ezExpressionAST::NodeType::Enum nodeType = pNode->m_Type;
+  if (ezExpressionAST::NodeType::IsOutput(nodeType))
+    return pNode;
+
+  for (auto pChild : ezExpressionAST::GetChildren(pNode))
+  {
+    if (pChild == nullptr)
+      return pNode;
+  }
+
+  if (ezExpressionAST::NodeType::IsUnary(nodeType))
+  {
+    auto pUnary = static_cast<ezExpressionAST::UnaryOperator*>(pNode);
+
+    float x = 0.0f;
+    if (GetConstantValue(pUnary->m_pOperand, x))
+    {
+      return ast.CreateConstant(EvaluateUnary(nodeType, x));
+    }
+
+    if (nodeType == ezExpressionAST::NodeType::Negate)
+    {
+      return FoldAndDeduplicate(ast, ReplaceUnsupportedNode(ast, pNode));
+    }
+  }
+  else if (ezExpressionAST::NodeType::IsBinary(nodeType))
+  {
+    auto pBinary = static_cast<ezExpressionAST::BinaryOperator*>(pNode);
+
+    float a = 0.0f;
+    float b = 0.0f;
+    const bool bLeftIsConstant = GetConstantValue(pBinary->m_pLeftOperand, a);
+    const bool bRightIsConstant = GetConstantValue(pBinary->m_pRightOperand, b);
+
+    if (bLeftIsConstant && bRightIsConstant)
+    {
+      return ast.CreateConstant(EvaluateBinary(nodeType, a, b));
+    }
+
+    if (bRightIsConstant)
+    {
+      // Binary instructions can only take a constant as left operand, so move constants to the left where possible.
+      if (ezExpressionAST::NodeType::IsCommutative(nodeType))
+      {
+        ezMath::Swap(pBinary->m_pLeftOperand, pBinary->m_pRightOperand);
+      }
+      else if (nodeType == ezExpressionAST::NodeType::Subtract)
+      {
+        pBinary = ast.CreateBinaryOperator(ezExpressionAST::NodeType::Add, ast.CreateConstant(-b), pBinary->m_pLeftOperand);
+        nodeType = ezExpressionAST::NodeType::Add;
+        pNode = pBinary;
+      }
+    }
+
+    // Remove operations that don't change the value
+    if (nodeType == ezExpressionAST::NodeType::Add && IsConstantValue(pBinary->m_pLeftOperand, 0.0f))
+      return pBinary->m_pRightOperand;
+
+    if (nodeType == ezExpressionAST::NodeType::Multiply && IsConstantValue(pBinary->m_pLeftOperand, 1.0f))
+      return pBinary->m_pRightOperand;
+
+    if (nodeType == ezExpressionAST::NodeType::Divide && IsConstantValue(pBinary->m_pRightOperand, 1.0f))
+      return pBinary->m_pLeftOperand;
+  }
+  else if (ezExpressionAST::NodeType::IsTernary(nodeType))
+  {
+    auto pTernary = static_cast<ezExpressionAST::TernaryOperator*>(pNode);
+
+    float a = 0.0f;
+    float b = 0.0f;
+    float c = 0.0f;
+    const bool bFirstIsConstant = GetConstantValue(pTernary->m_pFirstOperand, a);
+
+    if (bFirstIsConstant && GetConstantValue(pTernary->m_pSecondOperand, b) && GetConstantValue(pTernary->m_pThirdOperand, c))
+    {
+      return ast.CreateConstant(EvaluateTernary(nodeType, a, b, c));
+    }
+
+    if (nodeType == ezExpressionAST::NodeType::Select && bFirstIsConstant)
+    {
+      return a != 0.0f ? pTernary->m_pSecondOperand : pTernary->m_pThirdOperand;
+    }
+  }
+
+  // Merge nodes that compute the same value. Children have already been merged at this point, so comparing the child pointers is sufficient.
+  const ezUInt64 uiHash = ComputeNodeHash(pNode);
+
+  ezExpressionAST::Node* pExistingNode = nullptr;
+  if (m_NodeDeduplication.TryGetValue(uiHash, pExistingNode))
+  {
+    if (IsEqual(pExistingNode, pNode))
+      return pExistingNode;
+  }
+  else
+  {
+    m_NodeDeduplication.Insert(uiHash, pNode);
+  }
+
+  return pNode;
+}
+
+ezExpressionAST::Node* ezExpressionCompiler::FuseMultiplyAdd(ezExpressionAST& ast, ezExpressionAST::Node* pNode)
+{
+  if (pNode->m_Type != ezExpressionAST::NodeType::Add)
+    return pNode;
+
+  auto pAdd = static_cast<ezExpressionAST::BinaryOperator*>(pNode);
+  ezExpressionAST::Node* operands[] = {pAdd->m_pLeftOperand, pAdd->m_pRightOperand};
+
+  for (ezUInt32 i = 0; i < 2; ++i)
+  {
+    ezExpressionAST::Node* pMultiply = operands[i];
+    ezExpressionAST::Node* pAddend = operands[1 - i];
+
+    if (pMultiply == nullptr || pAddend == nullptr || pMultiply->m_Type != ezExpressionAST::NodeType::Multiply)
+      continue;
+
+    // Constants would need a separate mov instruction, which is not faster than the multiply with a constant operand
+    auto pMultiplyOperator = static_cast<ezExpressionAST::BinaryOperator*>(pMultiply);
+    if (ezExpressionAST::NodeType::IsConstant(pAddend->m_Type) || ezExpressionAST::NodeType::IsConstant(pMultiplyOperator->m_pLeftOperand->m_Type) ||
+        ezExpressionAST::NodeType::IsConstant(pMultiplyOperator->m_pRightOperand->m_Type))
+      continue;
+
+    ezUInt32 uiUseCount = 0;
+    if (!m_NodeUseCount.TryGetValue(pMultiply, uiUseCount) || uiUseCount > 1)
+      continue;
+
+    return ast.CreateTernaryOperator(
+      ezExpressionAST::NodeType::MultiplyAdd, pMultiplyOperator->m_pLeftOperand, pMultiplyOperator->m_pRightOperand, pAddend);
+  }
+
+  return pNode;
+}
+
+void ezExpressionCompiler::CountNodeUses(const ezExpressionAST& ast)
+{
+  m_NodeUseCount.Clear();
+
+  ezHybridArray<const ezExpressionAST::Node*, 64> nodeStack;
+  for (const ezExpressionAST::Output* pOutputNode : ast.m_OutputNodes)
+  {
+    if (pOutputNode != nullptr)
+    {
+      nodeStack.PushBack(pOutputNode);
+    }
+  }
+
+  while (!nodeStack.IsEmpty())
+  {
+    const ezExpressionAST::Node* pCurrentNode = nodeStack.PeekBack();
+    nodeStack.PopBack();
+
+    for (auto pChild : ezExpressionAST::GetChildren(pCurrentNode))
+    {
+      if (pChild == nullptr)
+        continue;
+
+      // Only visit the children of a node the first time it is encountered
+      ezUInt32& uiUseCount = m_NodeUseCount[pChild];
+      if (uiUseCount++ == 0)
+      {
+        nodeStack.PushBack(pChild);
+      }
+    }
+  }
+}
+
 ezResult ezExpressionCompiler::BuildNodeInstructions(const ezExpressionAST& ast)
 {
   m_NodeStack.Clear();
@@ -274,6 +683,16 @@ ezResult ezExpressionCompiler::GenerateByteCode(const ezExpressionAST& ast, ezEx
       byteCode.PushBack(bLeftIsConstant ? uiConstantValue : m_NodeToRegisterIndex[pBinary->m_pLeftOperand]);
       byteCode.PushBack(m_NodeToRegisterIndex[pBinary->m_pRightOperand]);
     }
+    else if (ezExpressionAST::NodeType::IsTernary(nodeType))
+    {
+      auto pTernary = static_cast<const ezExpressionAST::TernaryOperator*>(pCurrentNode);
+
+      byteCode.PushBack(NodeTypeToOpCode(nodeType));
+      byteCode.PushBack(uiTargetRegister);
+      byteCode.PushBack(m_NodeToRegisterIndex[pTernary->m_pFirstOperand]);
+      byteCode.PushBack(m_NodeToRegisterIndex[pTernary->m_pSecondOperand]);
+      byteCode.PushBack(m_NodeToRegisterIndex[pTernary->m_pThirdOperand]);
+    }
     else if (ezExpressionAST::NodeType::IsConstant(nodeType))
     {
       EZ_ASSERT_DEV(nodeType == ezExpressionAST::NodeType::FloatConstant, "Only floats are supported");
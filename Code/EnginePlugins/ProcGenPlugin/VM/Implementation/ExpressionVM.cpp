@@ -3,6 +3,7 @@
 #include <Foundation/SimdMath/SimdMath.h>
 #include <ProcGenPlugin/VM/ExpressionByteCode.h>
 #include <ProcGenPlugin/VM/ExpressionVM.h>
+#include <ProcGenPlugin/VM/Implementation/ExpressionVM_AVX.h>
 
 namespace
 {
@@ -84,30 +85,45 @@ namespace
     }
   }
 
-  VM_INLINE float ReadInputData(const ezUInt8* pData) { return *reinterpret_cast<const float*>(pData); }
-
-  void VMLoadInput(const ezExpressionByteCode::StorageType*& pByteCode, ezSimdVec4f* pRegisters, ezUInt32 uiNumRegisters,
-    ezArrayPtr<const ezExpression::Stream> inputs, ezArrayPtr<ezUInt32> inputMapping)
+  template <typename Func>
+  VM_INLINE void VMOperation3(const ezExpressionByteCode::StorageType*& pByteCode, ezSimdVec4f* pRegisters, ezUInt32 uiNumRegisters,
+    Func func)
   {
     ezSimdVec4f* r = pRegisters + ezExpressionByteCode::GetRegisterIndex(pByteCode, uiNumRegisters);
     ezSimdVec4f* re = r + uiNumRegisters;
 
-    ezUInt32 uiInputIndex = ezExpressionByteCode::GetRegisterIndex(pByteCode, 1);
-    uiInputIndex = inputMapping[uiInputIndex];
-    auto& input = inputs[uiInputIndex];
-    ezUInt32 uiByteStride = input.m_uiByteStride;
-    const ezUInt8* pInputData = input.m_Data.GetPtr();
-    const ezUInt8* pInputDataEnd = pInputData + input.m_Data.GetCount() - uiByteStride;
+    ezSimdVec4f* a = pRegisters + ezExpressionByteCode::GetRegisterIndex(pByteCode, uiNumRegisters);
+    ezSimdVec4f* b = pRegisters + ezExpressionByteCode::GetRegisterIndex(pByteCode, uiNumRegisters);
+    ezSimdVec4f* c = pRegisters + ezExpressionByteCode::GetRegisterIndex(pByteCode, uiNumRegisters);
+
+    while (r != re)
+    {
+      *r = func(*a, *b, *c);
+      ++r;
+      ++a;
+      ++b;
+      ++c;
+    }
+  }
+
+  template <typename T>
+  VM_INLINE float ReadInputData(const ezUInt8* pData)
+  {
+    return static_cast<float>(*reinterpret_cast<const T*>(pData));
+  }
 
+  template <typename T>
+  void VMLoadInput(ezSimdVec4f* r, ezSimdVec4f* re, const ezUInt8* pInputData, const ezUInt8* pInputDataEnd, ezUInt32 uiByteStride)
+  {
     while (r != re)
     {
-      float x = ReadInputData(pInputData);
+      float x = ReadInputData<T>(pInputData);
       pInputData += pInputData < pInputDataEnd ? uiByteStride : 0;
-      float y = ReadInputData(pInputData);
+      float y = ReadInputData<T>(pInputData);
       pInputData += pInputData < pInputDataEnd ? uiByteStride : 0;
-      float z = ReadInputData(pInputData);
+      float z = ReadInputData<T>(pInputData);
       pInputData += pInputData < pInputDataEnd ? uiByteStride : 0;
-      float w = ReadInputData(pInputData);
+      float w = ReadInputData<T>(pInputData);
       pInputData += pInputData < pInputDataEnd ? uiByteStride : 0;
 
       r->Set(x, y, z, w);
@@ -115,39 +131,100 @@ namespace
     }
   }
 
-  VM_INLINE void StoreOutputData(ezUInt8* pData, float fData) { *reinterpret_cast<float*>(pData) = fData; }
-
-  void VMStoreOutput(const ezExpressionByteCode::StorageType*& pByteCode, ezSimdVec4f* pRegisters, ezUInt32 uiNumRegisters,
-    ezArrayPtr<ezExpression::Stream> outputs, ezArrayPtr<ezUInt32> outputMapping)
+  void VMLoadInput(const ezExpressionByteCode::StorageType*& pByteCode, ezSimdVec4f* pRegisters, ezUInt32 uiNumRegisters,
+    ezArrayPtr<const ezExpression::Stream> inputs, ezArrayPtr<ezUInt32> inputMapping)
   {
-    ezUInt32 uiOutputIndex = ezExpressionByteCode::GetRegisterIndex(pByteCode, 1);
-    uiOutputIndex = outputMapping[uiOutputIndex];
-    auto& output = outputs[uiOutputIndex];
-    ezUInt32 uiByteStride = output.m_uiByteStride;
-    ezUInt8* pOutputData = output.m_Data.GetPtr();
-    ezUInt8* pOutputDataEnd = pOutputData + output.m_Data.GetCount() - uiByteStride;
-
     ezSimdVec4f* r = pRegisters + ezExpressionByteCode::GetRegisterIndex(pByteCode, uiNumRegisters);
     ezSimdVec4f* re = r + uiNumRegisters;
 
+    ezUInt32 uiInputIndex = ezExpressionByteCode::GetRegisterIndex(pByteCode, 1);
+    uiInputIndex = inputMapping[uiInputIndex];
+    auto& input = inputs[uiInputIndex & 0xFFFF];
+    ezUInt32 uiByteStride = input.m_uiByteStride;
+    const ezUInt8* pInputData = input.m_Data.GetPtr() + (uiInputIndex >> 16) * 4;
+    const ezUInt8* pInputDataEnd = input.m_Data.GetPtr() + input.m_Data.GetCount() - uiByteStride;
+
+    if (input.IsInteger())
+    {
+      VMLoadInput<ezInt32>(r, re, pInputData, pInputDataEnd, uiByteStride);
+    }
+    else
+    {
+      VMLoadInput<float>(r, re, pInputData, pInputDataEnd, uiByteStride);
+    }
+  }
+
+  template <typename T>
+  VM_INLINE void StoreOutputData(ezUInt8* pData, float fData)
+  {
+    *reinterpret_cast<T*>(pData) = static_cast<T>(fData);
+  }
+
+  template <typename T>
+  void VMStoreOutput(ezSimdVec4f* r, ezSimdVec4f* re, ezUInt8* pOutputData, ezUInt8* pOutputDataEnd, ezUInt32 uiByteStride)
+  {
     while (r != re)
     {
       float data[4];
       r->Store<4>(data);
 
-      StoreOutputData(pOutputData, data[0]);
+      StoreOutputData<T>(pOutputData, data[0]);
       pOutputData += pOutputData < pOutputDataEnd ? uiByteStride : 0;
-      StoreOutputData(pOutputData, data[1]);
+      StoreOutputData<T>(pOutputData, data[1]);
       pOutputData += pOutputData < pOutputDataEnd ? uiByteStride : 0;
-      StoreOutputData(pOutputData, data[2]);
+      StoreOutputData<T>(pOutputData, data[2]);
       pOutputData += pOutputData < pOutputDataEnd ? uiByteStride : 0;
-      StoreOutputData(pOutputData, data[3]);
+      StoreOutputData<T>(pOutputData, data[3]);
       pOutputData += pOutputData < pOutputDataEnd ? uiByteStride : 0;
 
       ++r;
     }
   }
 
+  void VMStoreOutput(const ezExpressionByteCode::StorageType*& pByteCode, ezSimdVec4f* pRegisters, ezUInt32 uiNumRegisters,
+    ezArrayPtr<ezExpression::Stream> outputs, ezArrayPtr<ezUInt32> outputMapping)
+  {
+    ezUInt32 uiOutputIndex = ezExpressionByteCode::GetRegisterIndex(pByteCode, 1);
+    uiOutputIndex = outputMapping[uiOutputIndex];
+    auto& output = outputs[uiOutputIndex & 0xFFFF];
+    ezUInt32 uiByteStride = output.m_uiByteStride;
+    ezUInt8* pOutputData = output.m_Data.GetPtr() + (uiOutputIndex >> 16) * 4;
+    ezUInt8* pOutputDataEnd = output.m_Data.GetPtr() + output.m_Data.GetCount() - uiByteStride;
+
+    ezSimdVec4f* r = pRegisters + ezExpressionByteCode::GetRegisterIndex(pByteCode, uiNumRegisters);
+    ezSimdVec4f* re = r + uiNumRegisters;
+
+    if (output.IsInteger())
+    {
+      VMStoreOutput<ezInt32>(r, re, pOutputData, pOutputDataEnd, uiByteStride);
+    }
+    else
+    {
+      VMStoreOutput<float>(r, re, pOutputData, pOutputDataEnd, uiByteStride);
+    }
+  }
+
+  static ezUInt32 GetComponentIndex(char c)
+  {
+    switch (c)
+    {
+      case 'X':
+      case 'R':
+        return 0;
+      case 'Y':
+      case 'G':
+        return 1;
+      case 'Z':
+      case 'B':
+        return 2;
+      case 'W':
+      case 'A':
+        return 3;
+    }
+
+    return ezInvalidIndex;
+  }
+
   void VMCall(const ezExpressionByteCode::StorageType*& pByteCode, ezSimdVec4f* pRegisters, ezUInt32 uiNumRegisters,
     const ezExpression::GlobalData& globalData, ezExpressionFunction& func)
   {
@@ -194,21 +271,26 @@ ezExpression::Stream::Stream(const ezHashedString& sName, Type::Enum type, ezArr
 ezExpression::Stream::~Stream() = default;
 
 ezUInt32 ezExpression::Stream::GetElementSize() const
+{
+  return GetNumComponents() * 4;
+}
+
+ezUInt32 ezExpression::Stream::GetNumComponents() const
 {
   switch (m_Type)
   {
     case Type::Float:
-      // case Type::Int:
+    case Type::Int:
+      return 1;
+    case Type::Float2:
+    case Type::Int2:
+      return 2;
+    case Type::Float3:
+    case Type::Int3:
+      return 3;
+    case Type::Float4:
+    case Type::Int4:
       return 4;
-      /*case Type::Float2:
-      case Type::Int2:
-        return 8;
-      case Type::Float3:
-      case Type::Int3:
-        return 12;
-      case Type::Float4:
-      case Type::Int4:
-        return 16;*/
   }
 
   EZ_ASSERT_NOT_IMPLEMENTED;
@@ -216,6 +298,11 @@ ezUInt32 ezExpression::Stream::GetElementSize() const
   return 0;
 }
 
+bool ezExpression::Stream::IsInteger() const
+{
+  return m_Type >= Type::Int;
+}
+
 void ezExpression::Stream::ValidateDataSize(ezUInt32 uiNumInstances, const char* szDataName) const
 {
   ezUInt32 uiElementSize = GetElementSize();
@@ -227,7 +314,11 @@ void ezExpression::Stream::ValidateDataSize(ezUInt32 uiNumInstances, const char*
 
 //////////////////////////////////////////////////////////////////////////
 
-ezExpressionVM::ezExpressionVM() = default;
+ezExpressionVM::ezExpressionVM()
+{
+  m_bAVXEnabled = IsAVXSupported();
+}
+
 ezExpressionVM::~ezExpressionVM() = default;
 
 void ezExpressionVM::RegisterFunction(const char* szName, ezExpressionFunction func,
@@ -249,69 +340,86 @@ void ezExpressionVM::RegisterDefaultFunctions()
   RegisterFunction("PerlinNoise", &ezDefaultExpressionFunctions::PerlinNoise);
 }
 
-ezResult ezExpressionVM::Execute(const ezExpressionByteCode& byteCode, ezArrayPtr<const ezExpression::Stream> inputs,
-  ezArrayPtr<ezExpression::Stream> outputs, ezUInt32 uiNumInstances, const ezExpression::GlobalData& globalData)
+void ezExpressionVM::SetAVXEnabled(bool bEnabled)
 {
-  // Input mapping
-  {
-    auto inputNames = byteCode.GetInputs();
+  m_bAVXEnabled = bEnabled && IsAVXSupported();
+}
 
-    m_InputMapping.Clear();
-    m_InputMapping.Reserve(inputNames.GetCount());
+// static
+bool ezExpressionVM::IsAVXSupported()
+{
+  static bool s_bSupported = ezExpressionVM_AVX::IsSupported();
+  return s_bSupported;
+}
 
-    for (auto& inputName : inputNames)
-    {
-      bool bInputFound = false;
+ezResult ezExpressionVM::MapStreams(ezArrayPtr<const ezHashedString> names, ezArrayPtr<const ezExpression::Stream> streams,
+  ezUInt32 uiNumInstances, const char* szDataName, ezDynamicArray<ezUInt32>& out_Mapping)
+{
+  out_Mapping.Clear();
+  out_Mapping.Reserve(names.GetCount());
 
-      for (ezUInt32 i = 0; i < inputs.GetCount(); ++i)
-      {
-        if (inputs[i].m_sName == inputName)
-        {
-          inputs[i].ValidateDataSize(uiNumInstances, "Input");
+  ezStringBuilder sBaseName;
 
-          m_InputMapping.PushBack(i);
-          bInputFound = true;
-          break;
-        }
-      }
+  for (auto& name : names)
+  {
+    ezUInt32 uiMapping = ezInvalidIndex;
 
-      if (!bInputFound)
+    for (ezUInt32 i = 0; i < streams.GetCount(); ++i)
+    {
+      if (streams[i].m_sName == name)
       {
-        ezLog::Error("Bytecode expects an input '{0}'", inputName);
-        return EZ_FAILURE;
+        uiMapping = i;
+        break;
       }
     }
-  }
 
-  // Output mapping
-  {
-    auto outputNames = byteCode.GetOutputs();
-
-    m_OutputMapping.Clear();
-    m_OutputMapping.Reserve(outputNames.GetCount());
-
-    for (auto& outputName : outputNames)
+    // Look for a vector stream that provides this name as one of its components
+    if (uiMapping == ezInvalidIndex && name.GetString().GetElementCount() > 1)
     {
-      bool bOutputFound = false;
+      sBaseName = name.GetString();
+      const ezUInt32 uiComponentIndex = GetComponentIndex(sBaseName.GetData()[sBaseName.GetElementCount() - 1]);
+      sBaseName.Shrink(0, 1);
+
+      const ezTempHashedString sBaseNameHashed(sBaseName.GetData());
 
-      for (ezUInt32 i = 0; i < outputs.GetCount(); ++i)
+      for (ezUInt32 i = 0; i < streams.GetCount(); ++i)
       {
-        if (outputs[i].m_sName == outputName)
+        if (streams[i].m_sName == sBaseNameHashed && uiComponentIndex < streams[i].GetNumComponents())
         {
-          outputs[i].ValidateDataSize(uiNumInstances, "Output");
-
-          m_OutputMapping.PushBack(i);
-          bOutputFound = true;
+          uiMapping = i | (uiComponentIndex << 16);
           break;
         }
       }
+    }
 
-      if (!bOutputFound)
-      {
-        ezLog::Error("Bytecode expects an output '{0}'", outputName);
-        return EZ_FAILURE;
-      }
+    if (uiMapping == ezInvalidIndex)
+    {
+      ezLog::Error("Bytecode expects an {0} '{1}'", szDataName, name);
+      return EZ_FAILURE;
     }
+
+    EZ_ASSERT_DEV(streams.GetCount() <= 0xFFFF, "Too many streams");
+    streams[uiMapping & 0xFFFF].ValidateDataSize(uiNumInstances, szDataName);
+
+    out_Mapping.PushBack(uiMapping);
+  }
+
+  return EZ_SUCCESS;
+}
+
+ezResult ezExpressionVM::Execute(const ezExpressionByteCode& byteCode, ezArrayPtr<const ezExpression::Stream> inputs,
+  ezArrayPtr<ezExpression::Stream> outputs, ezUInt32 uiNumInstances, const ezExpression::GlobalData& globalData)
+{
+  // Input mapping
+  if (MapStreams(byteCode.GetInputs(), inputs, uiNumInstances, "input", m_InputMapping).Failed())
+  {
+    return EZ_FAILURE;
+  }
+
+  // Output mapping
+  if (MapStreams(byteCode.GetOutputs(), outputs, uiNumInstances, "output", m_OutputMapping).Failed())
+  {
+    return EZ_FAILURE;
   }
 
   // Function mapping and validation
@@ -344,8 +452,10 @@ ezResult ezExpressionVM::Execute(const ezExpressionByteCode& byteCode, ezArrayPt
     }
   }
 
-  const ezUInt32 uiNumRegisters = (uiNumInstances + 3) / 4;
-  const ezUInt32 uiLastInstanceIndex = uiNumInstances - 1;
+  // The AVX code path processes two registers at once, so it needs an even number of registers.
+  // The additional instances are never written to any output.
+  const bool bUseAVX = m_bAVXEnabled;
+  const ezUInt32 uiNumRegisters = bUseAVX ? ((uiNumInstances + 7) / 8) * 2 : (uiNumInstances + 3) / 4;
 
   const ezUInt32 uiTotalNumRegisters = byteCode.GetNumTempRegisters() * uiNumRegisters;
   m_Registers.SetCountUninitialized(uiTotalNumRegisters);
@@ -360,6 +470,9 @@ ezResult ezExpressionVM::Execute(const ezExpressionByteCode& byteCode, ezArrayPt
   {
     ezExpressionByteCode::OpCode::Enum opCode = ezExpressionByteCode::GetOpCode(pByteCode);
 
+    if (bUseAVX && ezExpressionVM_AVX::ExecuteInstruction(opCode, pByteCode, pRegisters, uiNumRegisters))
+      continue;
+
     switch (opCode)
     {
         // unary
@@ -460,6 +573,18 @@ ezResult ezExpressionVM::Execute(const ezExpressionByteCode& byteCode, ezArrayPt
         VMOperation2_C(pByteCode, pRegisters, uiNumRegisters, [](const ezSimdVec4f& a, const ezSimdVec4f& b) { return a.CompMax(b); });
         break;
 
+        // ternary
+      case ezExpressionByteCode::OpCode::MulAdd_RRR:
+        VMOperation3(pByteCode, pRegisters, uiNumRegisters,
+          [](const ezSimdVec4f& a, const ezSimdVec4f& b, const ezSimdVec4f& c) { return a.CompMul(b) + c; });
+        break;
+
+      case ezExpressionByteCode::OpCode::Select_RRR:
+        VMOperation3(pByteCode, pRegisters, uiNumRegisters, [](const ezSimdVec4f& a, const ezSimdVec4f& b, const ezSimdVec4f& c) {
+          return ezSimdVec4f::Select(a != ezSimdVec4f::ZeroVector(), b, c);
+        });
+        break;
+
         // call
       case ezExpressionByteCode::OpCode::Call:
       {
@@ -0,0 +1,333 @@
+#include <ProcGenPluginPCH.h>
+
+#include <ProcGenPlugin/VM/Implementation/ExpressionVM_AVX.h>
+
+#if EZ_SIMD_IMPLEMENTATION == EZ_SIMD_IMPLEMENTATION_SSE && (EZ_ENABLED(EZ_COMPILER_MSVC) || EZ_ENABLED(EZ_COMPILER_GCC) || EZ_ENABLED(EZ_COMPILER_CLANG))
+#  define EZ_EXPRESSIONVM_AVX EZ_ON
+#else
+#  define EZ_EXPRESSIONVM_AVX EZ_OFF
+#endif
+
+#if EZ_ENABLED(EZ_EXPRESSIONVM_AVX)
+
+#  include <immintrin.h>
+
+#  if EZ_ENABLED(EZ_COMPILER_MSVC)
+#    include <intrin.h>
+#  endif
+
+namespace
+{
+  bool DetectSupport()
+  {
+#  if EZ_ENABLED(EZ_COMPILER_MSVC)
+    int cpuInfo[4];
+    __cpuid(cpuInfo, 0);
+    if (cpuInfo[0] < 7)
+      return false;
+
+    __cpuid(cpuInfo, 1);
+    const bool bOSXSave = (cpuInfo[2] & (1 << 27)) != 0;
+    const bool bAVX = (cpuInfo[2] & (1 << 28)) != 0;
+    if (!bOSXSave || !bAVX)
+      return false;
+
+    // the OS needs to save the upper halves of the YMM registers on context switches
+    if ((_xgetbv(0) & 0x6) != 0x6)
+      return false;
+
+    __cpuidex(cpuInfo, 7, 0);
+    return (cpuInfo[1] & (1 << 5)) != 0;
+#  else
+    // also checks whether the OS supports the YMM state
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+#  endif
+  }
+} // namespace
+
+// Everything below is compiled for AVX2. Only raw intrinsics may be used from here on, since inline functions of other headers
+// that get instantiated here could end up being used by code that runs on CPUs without AVX.
+#  if EZ_ENABLED(EZ_COMPILER_CLANG)
+#    pragma clang attribute push(__attribute__((target("avx2"))), apply_to = function)
+#  elif EZ_ENABLED(EZ_COMPILER_GCC)
+#    pragma GCC push_options
+#    pragma GCC target("avx2")
+#  endif
+
+namespace
+{
+  struct AbsOp
+  {
+    EZ_ALWAYS_INLINE __m256 operator()(__m256 x) const { return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), x); }
+  };
+
+  struct SqrtOp
+  {
+    EZ_ALWAYS_INLINE __m256 operator()(__m256 x) const { return _mm256_sqrt_ps(x); }
+  };
+
+  struct MovOp
+  {
+    EZ_ALWAYS_INLINE __m256 operator()(__m256 x) const { return x; }
+  };
+
+  struct AddOp
+  {
+    EZ_ALWAYS_INLINE __m256 operator()(__m256 a, __m256 b) const { return _mm256_add_ps(a, b); }
+  };
+
+  struct SubOp
+  {
+    EZ_ALWAYS_INLINE __m256 operator()(__m256 a, __m256 b) const { return _mm256_sub_ps(a, b); }
+  };
+
+  struct MulOp
+  {
+    EZ_ALWAYS_INLINE __m256 operator()(__m256 a, __m256 b) const { return _mm256_mul_ps(a, b); }
+  };
+
+  struct DivOp
+  {
+    EZ_ALWAYS_INLINE __m256 operator()(__m256 a, __m256 b) const { return _mm256_div_ps(a, b); }
+  };
+
+  struct MinOp
+  {
+    EZ_ALWAYS_INLINE __m256 operator()(__m256 a, __m256 b) const { return _mm256_min_ps(a, b); }
+  };
+
+  struct MaxOp
+  {
+    EZ_ALWAYS_INLINE __m256 operator()(__m256 a, __m256 b) const { return _mm256_max_ps(a, b); }
+  };
+
+  struct MulAddOp
+  {
+    // not fused, so the results are identical to the 4-wide path
+    EZ_ALWAYS_INLINE __m256 operator()(__m256 a, __m256 b, __m256 c) const { return _mm256_add_ps(_mm256_mul_ps(a, b), c); }
+  };
+
+  struct SelectOp
+  {
+    EZ_ALWAYS_INLINE __m256 operator()(__m256 a, __m256 b, __m256 c) const
+    {
+      // same semantic as the 4-wide path, NaN counts as not zero
+      __m256 mask = _mm256_cmp_ps(a, _mm256_setzero_ps(), _CMP_NEQ_UQ);
+      return _mm256_blendv_ps(c, b, mask);
+    }
+  };
+
+  // The registers are stored as ezSimdVec4f, two of them make up one 8-wide register.
+  EZ_ALWAYS_INLINE float* GetRegister(const ezExpressionByteCode::StorageType*& pByteCode, ezSimdVec4f* pRegisters, ezUInt32 uiNumRegisters)
+  {
+    ezUInt32 uiIndex = *pByteCode * uiNumRegisters;
+    ++pByteCode;
+    return reinterpret_cast<float*>(pRegisters + uiIndex);
+  }
+
+  EZ_ALWAYS_INLINE __m256 GetConstant(const ezExpressionByteCode::StorageType*& pByteCode)
+  {
+    float c = *reinterpret_cast<const float*>(pByteCode);
+    ++pByteCode;
+    return _mm256_set1_ps(c);
+  }
+
+  template <typename Func>
+  void Operation1(const ezExpressionByteCode::StorageType*& pByteCode, ezSimdVec4f* pRegisters, ezUInt32 uiNumRegisters, Func func)
+  {
+    float* r = GetRegister(pByteCode, pRegisters, uiNumRegisters);
+    float* re = r + uiNumRegisters * 4;
+
+    const float* x = GetRegister(pByteCode, pRegisters, uiNumRegisters);
+
+    for (; r != re; r += 8, x += 8)
+    {
+      _mm256_storeu_ps(r, func(_mm256_loadu_ps(x)));
+    }
+  }
+
+  template <typename Func>
+  void Operation1_C(const ezExpressionByteCode::StorageType*& pByteCode, ezSimdVec4f* pRegisters, ezUInt32 uiNumRegisters, Func func)
+  {
+    float* r = GetRegister(pByteCode, pRegisters, uiNumRegisters);
+    float* re = r + uiNumRegisters * 4;
+
+    const __m256 x = func(GetConstant(pByteCode));
+
+    for (; r != re; r += 8)
+    {
+      _mm256_storeu_ps(r, x);
+    }
+  }
+
+  template <typename Func>
+  void Operation2(const ezExpressionByteCode::StorageType*& pByteCode, ezSimdVec4f* pRegisters, ezUInt32 uiNumRegisters, Func func)
+  {
+    float* r = GetRegister(pByteCode, pRegisters, uiNumRegisters);
+    float* re = r + uiNumRegisters * 4;
+
+    const float* a = GetRegister(pByteCode, pRegisters, uiNumRegisters);
+    const float* b = GetRegister(pByteCode, pRegisters, uiNumRegisters);
+
+    for (; r != re; r += 8, a += 8, b += 8)
+    {
+      _mm256_storeu_ps(r, func(_mm256_loadu_ps(a), _mm256_loadu_ps(b)));
+    }
+  }
+
+  template <typename Func>
+  void Operation2_C(const ezExpressionByteCode::StorageType*& pByteCode, ezSimdVec4f* pRegisters, ezUInt32 uiNumRegisters, Func func)
+  {
+    float* r = GetRegister(pByteCode, pRegisters, uiNumRegisters);
+    float* re = r + uiNumRegisters * 4;
+
+    const __m256 a = GetConstant(pByteCode);
+    const float* b = GetRegister(pByteCode, pRegisters, uiNumRegisters);
+
+    for (; r != re; r += 8, b += 8)
+    {
+      _mm256_storeu_ps(r, func(a, _mm256_loadu_ps(b)));
+    }
+  }
+
+  template <typename Func>
+  void Operation3(const ezExpressionByteCode::StorageType*& pByteCode, ezSimdVec4f* pRegisters, ezUInt32 uiNumRegisters, Func func)
+  {
+    float* r = GetRegister(pByteCode, pRegisters, uiNumRegisters);
+    float* re = r + uiNumRegisters * 4;
+
+    const float* a = GetRegister(pByteCode, pRegisters, uiNumRegisters);
+    const float* b = GetRegister(pByteCode, pRegisters, uiNumRegisters);
+    const float* c = GetRegister(pByteCode, pRegisters, uiNumRegisters);
+
+    for (; r != re; r += 8, a += 8, b += 8, c += 8)
+    {
+      _mm256_storeu_ps(r, func(_mm256_loadu_ps(a), _mm256_loadu_ps(b), _mm256_loadu_ps(c)));
+    }
+  }
+
+  bool Execute(ezExpressionByteCode::OpCode::Enum opCode, const ezExpressionByteCode::StorageType*& pByteCode, ezSimdVec4f* pRegisters,
+    ezUInt32 uiNumRegisters)
+  {
+    switch (opCode)
+    {
+        // unary
+      case ezExpressionByteCode::OpCode::Abs_R:
+        Operation1(pByteCode, pRegisters, uiNumRegisters, AbsOp());
+        break;
+
+      case ezExpressionByteCode::OpCode::Sqrt_R:
+        Operation1(pByteCode, pRegisters, uiNumRegisters, SqrtOp());
+        break;
+
+      case ezExpressionByteCode::OpCode::Mov_R:
+        Operation1(pByteCode, pRegisters, uiNumRegisters, MovOp());
+        break;
+
+      case ezExpressionByteCode::OpCode::Mov_C:
+        Operation1_C(pByteCode, pRegisters, uiNumRegisters, MovOp());
+        break;
+
+        // binary
+      case ezExpressionByteCode::OpCode::Add_RR:
+        Operation2(pByteCode, pRegisters, uiNumRegisters, AddOp());
+        break;
+
+      case ezExpressionByteCode::OpCode::Add_CR:
+        Operation2_C(pByteCode, pRegisters, uiNumRegisters, AddOp());
+        break;
+
+      case ezExpressionByteCode::OpCode::Sub_RR:
+        Operation2(pByteCode, pRegisters, uiNumRegisters, SubOp());
+        break;
+
+      case ezExpressionByteCode::OpCode::Sub_CR:
+        Operation2_C(pByteCode, pRegisters, uiNumRegisters, SubOp());
+        break;
+
+      case ezExpressionByteCode::OpCode::Mul_RR:
+        Operation2(pByteCode, pRegisters, uiNumRegisters, MulOp());
+        break;
+
+      case ezExpressionByteCode::OpCode::Mul_CR:
+        Operation2_C(pByteCode, pRegisters, uiNumRegisters, MulOp());
+        break;
+
+      case ezExpressionByteCode::OpCode::Div_RR:
+        Operation2(pByteCode, pRegisters, uiNumRegisters, DivOp());
+        break;
+
+      case ezExpressionByteCode::OpCode::Div_CR:
+        Operation2_C(pByteCode, pRegisters, uiNumRegisters, DivOp());
+        break;
+
+      case ezExpressionByteCode::OpCode::Min_RR:
+        Operation2(pByteCode, pRegisters, uiNumRegisters, MinOp());
+        break;
+
+      case ezExpressionByteCode::OpCode::Min_CR:
+        Operation2_C(pByteCode, pRegisters, uiNumRegisters, MinOp());
+        break;
+
+      case ezExpressionByteCode::OpCode::Max_RR:
+        Operation2(pByteCode, pRegisters, uiNumRegisters, MaxOp());
+        break;
+
+      case ezExpressionByteCode::OpCode::Max_CR:
+        Operation2_C(pByteCode, pRegisters, uiNumRegisters, MaxOp());
+        break;
+
+        // ternary
+      case ezExpressionByteCode::OpCode::MulAdd_RRR:
+        Operation3(pByteCode, pRegisters, uiNumRegisters, MulAddOp());
+        break;
+
+      case ezExpressionByteCode::OpCode::Select_RRR:
+        Operation3(pByteCode, pRegisters, uiNumRegisters, SelectOp());
+        break;
+
+      default:
+        // trigonometric functions, inputs, outputs and calls are handled by the 4-wide code path
+        return false;
+    }
+
+    // avoid penalties when switching back to SSE code
+    _mm256_zeroupper();
+    return true;
+  }
+} // namespace
+
+#  if EZ_ENABLED(EZ_COMPILER_CLANG)
+#    pragma clang attribute pop
+#  elif EZ_ENABLED(EZ_COMPILER_GCC)
+#    pragma GCC pop_options
+#  endif
+
+bool ezExpressionVM_AVX::IsSupported()
+{
+  return DetectSupport();
+}
+
+bool ezExpressionVM_AVX::ExecuteInstruction(ezExpressionByteCode::OpCode::Enum opCode, const ezExpressionByteCode::StorageType*& pByteCode,
+  ezSimdVec4f* pRegisters, ezUInt32 uiNumRegisters)
+{
+  EZ_ASSERT_DEBUG((uiNumRegisters & 1) == 0, "The AVX code path needs an even number of registers");
+
+  return Execute(opCode, pByteCode, pRegisters, uiNumRegisters);
+}
+
+#else
+
+bool ezExpressionVM_AVX::IsSupported()
+{
+  return false;
+}
+
+bool ezExpressionVM_AVX::ExecuteInstruction(ezExpressionByteCode::OpCode::Enum opCode, const ezExpressionByteCode::StorageType*& pByteCode,
+  ezSimdVec4f* pRegisters, ezUInt32 uiNumRegisters)
+{
+  return false;
+}
+
+#endif
@@ -0,0 +1,19 @@
+#pragma once
+
+#include <ProcGenPlugin/VM/ExpressionByteCode.h>
+
+/// \brief 8-wide code path of the expression VM.
+///
+/// The functions are compiled for AVX2, independent of the instruction set that the rest of the engine is compiled for.
+/// They must only be called if IsSupported() returned true.
+namespace ezExpressionVM_AVX
+{
+  /// \brief Returns whether the CPU and the OS support AVX2.
+  bool IsSupported();
+
+  /// \brief Executes the instruction 8 instances at a time. uiNumRegisters must be even.
+  ///
+  /// Returns false without reading any further bytecode if the instruction has no 8-wide implementation.
+  bool ExecuteInstruction(ezExpressionByteCode::OpCode::Enum opCode, const ezExpressionByteCode::StorageType*& pByteCode, ezSimdVec4f* pRegisters,
+    ezUInt32 uiNumRegisters);
+} // namespace ezExpressionVM_AVX
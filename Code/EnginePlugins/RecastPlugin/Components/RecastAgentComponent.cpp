@@ -46,22 +46,32 @@ void ezRcAgentComponent::DeserializeComponent(ezWorldReader& stream)
   s >> m_fWalkSpeed;
 }
 
+void ezRcAgentComponent::OnDeactivated()
+{
+  CancelPathQuery();
+
+  SUPER::OnDeactivated();
+}
+
 ezResult ezRcAgentComponent::InitializeRecast()
 {
   if (m_bRecastInitialized)
     return EZ_SUCCESS;
 
-  const dtNavMesh* pNavMesh = GetWorld()->GetOrCreateModule<ezRecastWorldModule>()->GetDetourNavMesh();
+  const ezRecastWorldModule* pWorldModule = GetWorld()->GetOrCreateModule<ezRecastWorldModule>();
+  const dtNavMesh* pNavMesh = pWorldModule->GetDetourNavMesh();
   if (pNavMesh == nullptr)
     return EZ_FAILURE;
 
   m_bRecastInitialized = true;
+  m_uiNavMeshChangeCounter = pWorldModule->GetNavMeshChangeCounter();
 
   m_pQuery = EZ_DEFAULT_NEW(dtNavMeshQuery);
   m_pCorridor = EZ_DEFAULT_NEW(dtPathCorridor);
 
+  // the path search is done by the world module, the agent's own query is only used to follow the path corridor, which needs few nodes
   /// \todo Hard-coded limits
-  m_pQuery->init(pNavMesh, 512);
+  m_pQuery->init(pNavMesh, 64);
   m_pCorridor->init(256);
 
   return EZ_SUCCESS;
@@ -84,6 +94,8 @@ void ezRcAgentComponent::UninitializeRecast()
 
 void ezRcAgentComponent::ClearTargetPosition()
 {
+  CancelPathQuery();
+
   m_iNumNextSteps = 0;
   m_iFirstNextStep = 0;
   m_PathCorridor.Clear();
@@ -122,92 +134,41 @@ ezVec3 ezRcAgentComponent::GetTargetPosition() const
 ezResult ezRcAgentComponent::FindNavMeshPolyAt(const ezVec3& vPosition, dtPolyRef& out_PolyRef, ezVec3* out_vAdjustedPosition /*= nullptr*/,
   float fPlaneEpsilon /*= 0.01f*/, float fHeightEpsilon /*= 1.0f*/) const
 {
-  ezRcPos rcPos = vPosition;
-  ezVec3 vSize(fPlaneEpsilon, fHeightEpsilon, fPlaneEpsilon);
-
-  ezRcPos resultPos;
-  dtQueryFilter filter; /// \todo Hard-coded filter
-  if (dtStatusFailed(m_pQuery->findNearestPoly(rcPos, &vSize.x, &m_QueryFilter, &out_PolyRef, resultPos)))
-    return EZ_FAILURE;
-
-  if (!ezMath::IsEqual(vPosition.x, resultPos.m_Pos[0], fPlaneEpsilon) ||
-      !ezMath::IsEqual(vPosition.y, resultPos.m_Pos[2], fPlaneEpsilon) || !ezMath::IsEqual(vPosition.z, resultPos.m_Pos[1], fHeightEpsilon))
-    return EZ_FAILURE;
-
-  if (out_vAdjustedPosition != nullptr)
-  {
-    *out_vAdjustedPosition = resultPos;
-  }
-
-  return EZ_SUCCESS;
+  return ezRecastWorldModule::FindNavMeshPolyAt(*m_pQuery, m_QueryFilter, vPosition, out_PolyRef, out_vAdjustedPosition, fPlaneEpsilon, fHeightEpsilon);
 }
 
-ezResult ezRcAgentComponent::ComputePathCorridor(dtPolyRef startPoly, dtPolyRef endPoly, bool& bFoundPartialPath)
+void ezRcAgentComponent::CancelPathQuery()
 {
-  bFoundPartialPath = false;
-
-  ezRcPos rcStart = m_vCurrentPositionOnNavmesh;
-  ezRcPos rcEnd = m_vTargetPosition;
-
-  ezInt32 iPathCorridorLength = 0;
-
-  // make enough room
-  m_PathCorridor.SetCountUninitialized(256);
-  if (dtStatusFailed(m_pQuery->findPath(startPoly, endPoly, rcStart, rcEnd, &m_QueryFilter, m_PathCorridor.GetData(), &iPathCorridorLength,
-        (int)m_PathCorridor.GetCount())) ||
-      iPathCorridorLength <= 0)
-  {
-    m_PathCorridor.Clear();
-    return EZ_FAILURE;
-  }
-
-  // reduce to actual length
-  m_PathCorridor.SetCountUninitialized(iPathCorridorLength);
+  if (m_uiPathQueryID == 0)
+    return;
 
-  if (m_PathCorridor[iPathCorridorLength - 1] != endPoly)
+  if (ezRecastWorldModule* pWorldModule = GetWorld()->GetModule<ezRecastWorldModule>())
   {
-    // if this is the case, the target position cannot be reached, but we can walk close to it
-    bFoundPartialPath = true;
+    pWorldModule->CancelPathQuery(m_uiPathQueryID);
   }
 
-  m_pCorridor->reset(startPoly, rcStart);
-  m_pCorridor->setCorridor(rcEnd, m_PathCorridor.GetData(), iPathCorridorLength);
-
-  return EZ_SUCCESS;
+  m_uiPathQueryID = 0;
 }
 
-ezResult ezRcAgentComponent::ComputePathToTarget()
+ezResult ezRcAgentComponent::RetrievePathToTarget()
 {
-  const ezVec3 vStartPos = GetOwner()->GetGlobalPosition();
+  ezRecastWorldModule* pWorldModule = GetWorld()->GetOrCreateModule<ezRecastWorldModule>();
 
-  dtPolyRef startPoly;
-  if (FindNavMeshPolyAt(vStartPos, startPoly, &m_vCurrentPositionOnNavmesh).Failed())
+  if (m_uiPathQueryID == 0)
   {
-    m_PathToTargetState = ezAgentPathFindingState::HasTargetPathFindingFailed;
-
-    ezAgentSteeringEvent e;
-    e.m_pComponent = this;
-    e.m_Type = ezAgentSteeringEvent::ErrorOutsideNavArea;
-    m_SteeringEvents.Broadcast(e);
-    return EZ_FAILURE;
+    m_uiPathQueryID = pWorldModule->RequestPath(GetOwner()->GetGlobalPosition(), m_vTargetPosition);
   }
 
-  dtPolyRef endPoly;
-  if (FindNavMeshPolyAt(m_vTargetPosition, endPoly).Failed())
-  {
-    m_PathToTargetState = ezAgentPathFindingState::HasTargetPathFindingFailed;
+  ezRecastPathQueryResult result;
+  const ezRecastPathQueryState::Enum state = pWorldModule->RetrievePathQueryResult(m_uiPathQueryID, result);
 
-    ezAgentSteeringEvent e;
-    e.m_pComponent = this;
-    e.m_Type = ezAgentSteeringEvent::ErrorInvalidTargetPosition;
-    m_SteeringEvents.Broadcast(e);
+  // the path is not computed yet
+  if (state == ezRecastPathQueryState::Pending)
     return EZ_FAILURE;
-  }
 
-  /// \todo Optimize case when endPoly is same as previously ?
+  m_uiPathQueryID = 0;
 
-  bool bFoundPartialPath = false;
-  if (ComputePathCorridor(startPoly, endPoly, bFoundPartialPath).Failed() || bFoundPartialPath)
+  if (state != ezRecastPathQueryState::FullPath)
   {
     m_PathToTargetState = ezAgentPathFindingState::HasTargetPathFindingFailed;
 
@@ -215,11 +176,36 @@ ezResult ezRcAgentComponent::ComputePathToTarget()
 
     ezAgentSteeringEvent e;
     e.m_pComponent = this;
-    e.m_Type = bFoundPartialPath ? ezAgentSteeringEvent::WarningNoFullPathToTarget : ezAgentSteeringEvent::ErrorNoPathToTarget;
+
+    switch (state)
+    {
+      case ezRecastPathQueryState::StartOutsideNavMesh:
+        e.m_Type = ezAgentSteeringEvent::ErrorOutsideNavArea;
+        break;
+      case ezRecastPathQueryState::InvalidTarget:
+        e.m_Type = ezAgentSteeringEvent::ErrorInvalidTargetPosition;
+        break;
+      case ezRecastPathQueryState::PartialPath:
+        e.m_Type = ezAgentSteeringEvent::WarningNoFullPathToTarget;
+        break;
+      default:
+        e.m_Type = ezAgentSteeringEvent::ErrorNoPathToTarget;
+        break;
+    }
+
     m_SteeringEvents.Broadcast(e);
     return EZ_FAILURE;
   }
 
+  m_vCurrentPositionOnNavmesh = result.m_vStartPositionOnNavMesh;
+  m_PathCorridor = std::move(result.m_PathCorridor);
+
+  const ezRcPos rcStart = m_vCurrentPositionOnNavmesh;
+  const ezRcPos rcEnd = m_vTargetPosition;
+
+  m_pCorridor->reset(result.m_StartPoly, rcStart);
+  m_pCorridor->setCorridor(rcEnd, m_PathCorridor.GetData(), (int)m_PathCorridor.GetCount());
+
   m_PathToTargetState = ezAgentPathFindingState::HasTargetAndValidPath;
 
   ezAgentSteeringEvent e;
@@ -361,6 +347,12 @@ void ezRcAgentComponent::SyncSteeringWithReality()
 
 void ezRcAgentComponent::Update()
 {
+  // when navmesh tiles get replaced, the path corridor may reference polygons that don't exist anymore, so the path is recomputed
+  if (m_bRecastInitialized && m_uiNavMeshChangeCounter != GetWorld()->GetOrCreateModule<ezRecastWorldModule>()->GetNavMeshChangeCounter())
+  {
+    UninitializeRecast();
+  }
+
   // this can happen the first few frames
   if (InitializeRecast().Failed())
     return;
@@ -376,7 +368,7 @@ void ezRcAgentComponent::Update()
   // target is set, but no path is computed yet
   if (GetPathToTargetState() == ezAgentPathFindingState::HasTargetWaitingForPath)
   {
-    if (ComputePathToTarget().Failed())
+    if (RetrievePathToTarget().Failed())
       return;
 
     PlanNextSteps();
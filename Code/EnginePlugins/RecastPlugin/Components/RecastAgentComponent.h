@@ -48,6 +48,7 @@ class EZ_RECASTPLUGIN_DLL ezRcAgentComponent : public ezAgentSteeringComponent
 protected:
   virtual void SerializeComponent(ezWorldWriter& stream) const override;
   virtual void DeserializeComponent(ezWorldReader& stream) override;
+  virtual void OnDeactivated() override;
 
   //////////////////////////////////////////////////////////////////////////
   // ezAgentSteeringComponent
@@ -84,8 +85,8 @@ private:
   // Path Finding and Steering
 
 private:
-  ezResult ComputePathToTarget();
-  ezResult ComputePathCorridor(dtPolyRef startPoly, dtPolyRef endPoly, bool& bFoundPartialPath);
+  ezResult RetrievePathToTarget();
+  void CancelPathQuery();
   void ComputeSteeringDirection(float fMaxDistance);
   void ApplySteering(const ezVec3& vDirection, float fSpeed);
   void SyncSteeringWithReality();
@@ -94,6 +95,8 @@ private:
   ezVec3 m_vTargetPosition;
   ezEnum<ezAgentPathFindingState> m_PathToTargetState;
   ezVec3 m_vCurrentPositionOnNavmesh;      /// \todo ??? keep update ?
+  ezUInt32 m_uiPathQueryID = 0;            // path searches are done by ezRecastWorldModule
+  ezUInt32 m_uiNavMeshChangeCounter = 0;   // see ezRecastWorldModule::GetNavMeshChangeCounter()
   ezUniquePtr<dtNavMeshQuery> m_pQuery;    // careful, dtNavMeshQuery is not moveble
   ezUniquePtr<dtPathCorridor> m_pCorridor; // careful, dtPathCorridor is not moveble
   dtQueryFilter m_QueryFilter;             /// \todo hard-coded filter
@@ -2,6 +2,8 @@
 
 #include <Core/Utils/WorldGeoExtractionUtil.h>
 #include <Core/World/World.h>
+#include <Foundation/Algorithm/HashingUtils.h>
+#include <Foundation/Threading/TaskSystem.h>
 #include <Foundation/Time/Stopwatch.h>
 #include <Foundation/Types/ScopeExit.h>
 #include <Foundation/Utilities/Progress.h>
@@ -12,7 +14,7 @@
 #include <RecastPlugin/Resources/RecastNavMeshResource.h>
 
 // clang-format off
-EZ_BEGIN_STATIC_REFLECTED_TYPE(ezRecastConfig, ezNoBase, 1, ezRTTIDefaultAllocator<ezRecastConfig>)
+EZ_BEGIN_STATIC_REFLECTED_TYPE(ezRecastConfig, ezNoBase, 2, ezRTTIDefaultAllocator<ezRecastConfig>)
 {
   EZ_BEGIN_PROPERTIES
   {
@@ -28,6 +30,7 @@ EZ_BEGIN_STATIC_REFLECTED_TYPE(ezRecastConfig, ezNoBase, 1, ezRTTIDefaultAllocat
     EZ_MEMBER_PROPERTY("SampleErrorFactor", m_fDetailMeshSampleErrorFactor)->AddAttributes(new ezDefaultValueAttribute(1.0f)),
     EZ_MEMBER_PROPERTY("MaxSimplification", m_fMaxSimplificationError)->AddAttributes(new ezDefaultValueAttribute(1.3f)),
     EZ_MEMBER_PROPERTY("MaxEdgeLength", m_fMaxEdgeLength)->AddAttributes(new ezDefaultValueAttribute(4.0f)),
+    EZ_MEMBER_PROPERTY("TileSize", m_fTileSize)->AddAttributes(new ezDefaultValueAttribute(0.0f), new ezClampValueAttribute(0.0f, ezVariant())),
   }
   EZ_END_PROPERTIES;
 }
@@ -69,7 +72,6 @@ void ezRecastNavMeshBuilder::Clear()
   m_BoundingBox.SetInvalid();
   m_Vertices.Clear();
   m_Triangles.Clear();
-  m_TriangleAreaIDs.Clear();
   m_pRecastContext = nullptr;
 }
 
@@ -93,6 +95,8 @@ ezResult ezRecastNavMeshBuilder::Build(const ezRecastConfig& config, const ezWor
 
   Clear();
   out_NavMeshDesc.Clear();
+  m_ChangedTiles.Clear();
+  m_bTileGridChanged = true;
 
   ezUniquePtr<ezRcBuildContext> recastContext = EZ_DEFAULT_NEW(ezRcBuildContext);
   m_pRecastContext = recastContext.Borrow();
@@ -116,9 +120,18 @@ ezResult ezRecastNavMeshBuilder::Build(const ezRecastConfig& config, const ezWor
   if (!pg.BeginNextStep("Build Poly Mesh"))
     return EZ_FAILURE;
 
+  if (config.m_fTileSize > 0.0f)
+  {
+    // the tiles are built in one go, there is no separate Detour step
+    return BuildTiles(config, out_NavMeshDesc, progress);
+  }
+
+  rcConfig cfg;
+  FillOutConfig(cfg, config, m_BoundingBox);
+
   out_NavMeshDesc.m_pNavMeshPolygons = EZ_DEFAULT_NEW(rcPolyMesh);
 
-  if (BuildRecastPolyMesh(config, *out_NavMeshDesc.m_pNavMeshPolygons, progress).Failed())
+  if (BuildRecastPolyMesh(m_pRecastContext, cfg, m_Vertices, m_Triangles, *out_NavMeshDesc.m_pNavMeshPolygons, progress).Failed())
     return EZ_FAILURE;
 
   if (!pg.BeginNextStep("Build NavMesh"))
@@ -140,7 +153,6 @@ void ezRecastNavMeshBuilder::ReserveMemory(const ezWorldGeoExtractionUtil::Geome
   const ezUInt32 uiVertices = uiBoxVertices + desc.m_Vertices.GetCount();
 
   m_Triangles.Reserve(uiTriangles);
-  m_TriangleAreaIDs.Reserve(uiTriangles);
   m_Vertices.Reserve(uiVertices);
 }
 
@@ -149,7 +161,6 @@ void ezRecastNavMeshBuilder::GenerateTriangleMeshFromDescription(const ezWorldGe
   EZ_LOG_BLOCK("ezRecastNavMeshBuilder::GenerateTriangleMesh");
 
   m_Triangles.Clear();
-  m_TriangleAreaIDs.Clear();
   m_Vertices.Clear();
 
   ReserveMemory(desc);
@@ -220,9 +231,6 @@ void ezRecastNavMeshBuilder::GenerateTriangleMeshFromDescription(const ezWorldGe
     }
   }
 
-  // initialize the IDs to zero
-  m_TriangleAreaIDs.SetCount(m_Triangles.GetCount());
-
   ezLog::Debug("Vertices: {0}, Triangles: {1}", m_Vertices.GetCount(), m_Triangles.GetCount());
 }
 
@@ -261,16 +269,17 @@ void ezRecastNavMeshBuilder::FillOutConfig(rcConfig& cfg, const ezRecastConfig&
   rcCalcGridSize(cfg.bmin, cfg.bmax, cfg.cs, &cfg.width, &cfg.height);
 }
 
-ezResult ezRecastNavMeshBuilder::BuildRecastPolyMesh(const ezRecastConfig& config, rcPolyMesh& out_PolyMesh, ezProgress& progress)
+ezResult ezRecastNavMeshBuilder::BuildRecastPolyMesh(ezRcBuildContext* pContext, const rcConfig& cfg, ezArrayPtr<const ezVec3> vertices,
+  ezArrayPtr<const Triangle> triangles, rcPolyMesh& out_PolyMesh, ezProgress& progress)
 {
   ezProgressRange pgRange("Build Poly Mesh", 13, true, &progress);
 
-  rcConfig cfg;
-  FillOutConfig(cfg, config, m_BoundingBox);
+  const float* pVertices = &vertices[0].x;
+  const ezInt32* pTriangles = &triangles[0].m_VertexIdx[0];
 
-  ezRcBuildContext* pContext = m_pRecastContext;
-  const float* pVertices = &m_Vertices[0].x;
-  const ezInt32* pTriangles = &m_Triangles[0].m_VertexIdx[0];
+  // initialize the IDs to zero
+  ezDynamicArray<ezUInt8> triangleAreaIDs;
+  triangleAreaIDs.SetCount(triangles.GetCount());
 
   rcHeightfield* heightfield = rcAllocHeightfield();
   EZ_SCOPE_EXIT(rcFreeHeightField(heightfield));
@@ -289,12 +298,12 @@ ezResult ezRecastNavMeshBuilder::BuildRecastPolyMesh(const ezRecastConfig& confi
 
   // TODO Instead of this, it should use area IDs and then clear the non-walkable triangles
   rcMarkWalkableTriangles(
-    pContext, cfg.walkableSlopeAngle, pVertices, m_Vertices.GetCount(), pTriangles, m_Triangles.GetCount(), m_TriangleAreaIDs.GetData());
+    pContext, cfg.walkableSlopeAngle, pVertices, vertices.GetCount(), pTriangles, triangles.GetCount(), triangleAreaIDs.GetData());
 
   if (!pgRange.BeginNextStep("Rasterize Triangles"))
     return EZ_FAILURE;
 
-  if (!rcRasterizeTriangles(pContext, pVertices, m_Vertices.GetCount(), pTriangles, m_TriangleAreaIDs.GetData(), m_Triangles.GetCount(),
+  if (!rcRasterizeTriangles(pContext, pVertices, vertices.GetCount(), pTriangles, triangleAreaIDs.GetData(), triangles.GetCount(),
         *heightfield, cfg.walkableClimb))
   {
     pContext->log(RC_LOG_ERROR, "Could not rasterize triangles");
@@ -371,7 +380,7 @@ ezResult ezRecastNavMeshBuilder::BuildRecastPolyMesh(const ezRecastConfig& confi
         return EZ_FAILURE;
 
       // Partition the walkable surface into simple regions without holes.
-      if (!rcBuildRegions(pContext, *compactHeightfield, 0, cfg.minRegionArea, cfg.mergeRegionArea))
+      if (!rcBuildRegions(pContext, *compactHeightfield, cfg.borderSize, cfg.minRegionArea, cfg.mergeRegionArea))
       {
         pContext->log(RC_LOG_ERROR, "Could not build watershed regions.");
         return EZ_FAILURE;
@@ -440,7 +449,8 @@ ezResult ezRecastNavMeshBuilder::BuildRecastPolyMesh(const ezRecastConfig& confi
   return EZ_SUCCESS;
 }
 
-ezResult ezRecastNavMeshBuilder::BuildDetourNavMeshData(const ezRecastConfig& config, const rcPolyMesh& polyMesh, ezDataBuffer& NavmeshData)
+ezResult ezRecastNavMeshBuilder::BuildDetourNavMeshData(
+  const ezRecastConfig& config, const rcPolyMesh& polyMesh, ezDataBuffer& NavmeshData, ezInt32 iTileX, ezInt32 iTileY)
 {
   dtNavMeshCreateParams params;
   ezMemoryUtils::ZeroFill(&params, 1);
@@ -460,6 +470,8 @@ ezResult ezRecastNavMeshBuilder::BuildDetourNavMeshData(const ezRecastConfig& co
   params.cs = config.m_fCellSize;
   params.ch = config.m_fCellHeight;
   params.buildBvTree = true;
+  params.tileX = iTileX;
+  params.tileY = iTileY;
 
   ezUInt8* navData = nullptr;
   ezInt32 navDataSize = 0;
@@ -477,9 +489,245 @@ ezResult ezRecastNavMeshBuilder::BuildDetourNavMeshData(const ezRecastConfig& co
   return EZ_SUCCESS;
 }
 
+bool ezRecastNavMeshBuilder::SetupTileGrid(const ezRecastConfig& config)
+{
+  const ezUInt64 uiConfigHash = ezHashingUtils::xxHash64(&config, sizeof(ezRecastConfig));
+
+  // as long as all geometry fits into the previous grid, the tiles keep their coordinates and unchanged ones don't need to be rebuilt
+  if (uiConfigHash == m_uiTileConfigHash && m_TileGridBounds.IsValid() && m_TileGridBounds.Contains(m_BoundingBox))
+    return false;
+
+  const ezInt32 iTileCells = ezMath::Max(1, (ezInt32)(config.m_fTileSize / config.m_fCellSize));
+  const float fTileSize = iTileCells * config.m_fCellSize;
+
+  m_uiTileConfigHash = uiConfigHash;
+  m_TileGridBounds = m_BoundingBox;
+  m_uiNumTilesX = ezMath::Max(1, (ezInt32)ezMath::Ceil((m_BoundingBox.m_vMax.x - m_BoundingBox.m_vMin.x) / fTileSize));
+  m_uiNumTilesY = ezMath::Max(1, (ezInt32)ezMath::Ceil((m_BoundingBox.m_vMax.z - m_BoundingBox.m_vMin.z) / fTileSize));
+  m_TileGridBounds.m_vMax.x = m_TileGridBounds.m_vMin.x + m_uiNumTilesX * fTileSize;
+  m_TileGridBounds.m_vMax.z = m_TileGridBounds.m_vMin.z + m_uiNumTilesY * fTileSize;
+
+  m_Tiles.Clear();
+  m_Tiles.SetCount(m_uiNumTilesX * m_uiNumTilesY);
+  return true;
+}
+
+ezResult ezRecastNavMeshBuilder::BuildTiles(const ezRecastConfig& config, ezRecastNavMeshResourceDescriptor& out_NavMeshDesc, ezProgress& progress)
+{
+  ezProgressRange pgRange("Build Tiles", 3, true, &progress);
+  pgRange.SetStepWeighting(0, 0.05f);
+  pgRange.SetStepWeighting(1, 0.9f);
+  pgRange.SetStepWeighting(2, 0.05f);
+
+  m_ChangedTiles.Clear();
+
+  m_bTileGridChanged = SetupTileGrid(config);
+
+  // Detour polygon references use 22 bits for the tile and the polygon index
+  const ezUInt32 uiTileBits = ezMath::Log2i(ezMath::PowerOfTwo_Ceil(m_uiNumTilesX * m_uiNumTilesY));
+  if (uiTileBits > 14)
+  {
+    ezLog::Error("The navmesh needs too many tiles ({0} x {1}), increase the tile size", m_uiNumTilesX, m_uiNumTilesY);
+    return EZ_FAILURE;
+  }
+
+  const ezUInt32 uiMaxPolysPerTile = 1u << (22 - uiTileBits);
+  const float fTileSize = (m_TileGridBounds.m_vMax.x - m_TileGridBounds.m_vMin.x) / m_uiNumTilesX;
+
+  if (!pgRange.BeginNextStep("Sort Triangles into Tiles"))
+    return EZ_FAILURE;
+
+  {
+    rcConfig cfg;
+    FillOutConfig(cfg, config, m_TileGridBounds);
+
+    // the geometry in the border around a tile affects the tile as well
+    const float fBorder = (cfg.walkableRadius + 3) * cfg.cs;
+    const ezVec3 vGridMin = m_TileGridBounds.m_vMin;
+
+    for (NavMeshTile& tile : m_Tiles)
+    {
+      tile.m_Triangles.Clear();
+    }
+
+    for (const Triangle& tri : m_Triangles)
+    {
+      ezBoundingBox triBox;
+      triBox.SetFromPoints(&m_Vertices[tri.m_VertexIdx[0]], 1);
+      triBox.ExpandToInclude(m_Vertices[tri.m_VertexIdx[1]]);
+      triBox.ExpandToInclude(m_Vertices[tri.m_VertexIdx[2]]);
+
+      const ezInt32 iMinX = ezMath::Max(0, (ezInt32)ezMath::Floor((triBox.m_vMin.x - fBorder - vGridMin.x) / fTileSize));
+      const ezInt32 iMinY = ezMath::Max(0, (ezInt32)ezMath::Floor((triBox.m_vMin.z - fBorder - vGridMin.z) / fTileSize));
+      const ezInt32 iMaxX = ezMath::Min<ezInt32>(m_uiNumTilesX - 1, (ezInt32)ezMath::Floor((triBox.m_vMax.x + fBorder - vGridMin.x) / fTileSize));
+      const ezInt32 iMaxY = ezMath::Min<ezInt32>(m_uiNumTilesY - 1, (ezInt32)ezMath::Floor((triBox.m_vMax.z + fBorder - vGridMin.z) / fTileSize));
+
+      for (ezInt32 y = iMinY; y <= iMaxY; ++y)
+      {
+        for (ezInt32 x = iMinX; x <= iMaxX; ++x)
+        {
+          m_Tiles[y * m_uiNumTilesX + x].m_Triangles.PushBack(tri);
+        }
+      }
+    }
+  }
+
+  if (!pgRange.BeginNextStep("Build Tiles"))
+    return EZ_FAILURE;
+
+  {
+    ezAtomicInteger32 iNumFailedTiles = 0;
+
+    ezParallelForParams params;
+    // tiles with lots of geometry take much longer than empty ones
+    params.uiMaxTasksPerThread = 4;
+
+    ezTaskSystem::ParallelForIndexed(
+      0, m_Tiles.GetCount(),
+      [&](ezUInt32 uiStartIndex, ezUInt32 uiEndIndex) {
+        for (ezUInt32 uiTileIdx = uiStartIndex; uiTileIdx < uiEndIndex; ++uiTileIdx)
+        {
+          if (BuildTile(config, uiTileIdx).Failed())
+            iNumFailedTiles.Increment();
+        }
+      },
+      "NavMesh Tiles", params);
+
+    for (NavMeshTile& tile : m_Tiles)
+    {
+      tile.m_Triangles.Clear();
+      tile.m_Triangles.Compact();
+    }
+
+    if (iNumFailedTiles > 0)
+    {
+      ezLog::Error("{0} navmesh tiles could not be built", iNumFailedTiles);
+      return EZ_FAILURE;
+    }
+  }
+
+  if (!pgRange.BeginNextStep("Merge Tiles"))
+    return EZ_FAILURE;
+
+  out_NavMeshDesc.m_vTileOrigin = m_TileGridBounds.m_vMin;
+  out_NavMeshDesc.m_fTileSize = fTileSize;
+  out_NavMeshDesc.m_uiMaxTiles = 1u << uiTileBits;
+  out_NavMeshDesc.m_uiMaxPolysPerTile = uiMaxPolysPerTile;
+
+  ezDynamicArray<rcPolyMesh*> polyMeshes;
+
+  for (ezUInt32 uiTileIdx = 0; uiTileIdx < m_Tiles.GetCount(); ++uiTileIdx)
+  {
+    const NavMeshTile& tile = m_Tiles[uiTileIdx];
+    const ezInt32 iTileX = uiTileIdx % m_uiNumTilesX;
+    const ezInt32 iTileY = uiTileIdx / m_uiNumTilesX;
+
+    if (tile.m_bChanged)
+    {
+      m_ChangedTiles.PushBack(ezVec2I32(iTileX, iTileY));
+    }
+
+    if (tile.m_pPolyMesh == nullptr)
+      continue;
+
+    if (tile.m_pPolyMesh->npolys > (ezInt32)uiMaxPolysPerTile)
+    {
+      ezLog::Error("Navmesh tile ({0}, {1}) has too many polygons ({2}), decrease the tile size", iTileX, iTileY, tile.m_pPolyMesh->npolys);
+      return EZ_FAILURE;
+    }
+
+    polyMeshes.PushBack(tile.m_pPolyMesh.Borrow());
+
+    auto& descTile = out_NavMeshDesc.m_Tiles.ExpandAndGetRef();
+    descTile.m_iTileX = iTileX;
+    descTile.m_iTileY = iTileY;
+    descTile.m_NavMeshData = tile.m_NavMeshData;
+  }
+
+  if (!polyMeshes.IsEmpty())
+  {
+    // for visualization and the points of interest all tiles are merged into one polygon mesh
+    out_NavMeshDesc.m_pNavMeshPolygons = EZ_DEFAULT_NEW(rcPolyMesh);
+
+    if (!rcMergePolyMeshes(m_pRecastContext, polyMeshes.GetData(), polyMeshes.GetCount(), *out_NavMeshDesc.m_pNavMeshPolygons))
+    {
+      m_pRecastContext->log(RC_LOG_ERROR, "Could not merge the tile polygon meshes");
+      return EZ_FAILURE;
+    }
+  }
+
+  ezLog::Debug("Navmesh tiles: {0} x {1}, rebuilt: {2}", m_uiNumTilesX, m_uiNumTilesY, m_ChangedTiles.GetCount());
+
+  return EZ_SUCCESS;
+}
+
+ezResult ezRecastNavMeshBuilder::BuildTile(const ezRecastConfig& config, ezUInt32 uiTileIdx)
+{
+  NavMeshTile& tile = m_Tiles[uiTileIdx];
+  const ezInt32 iTileX = uiTileIdx % m_uiNumTilesX;
+  const ezInt32 iTileY = uiTileIdx / m_uiNumTilesX;
+
+  // a tile only needs to be rebuilt if the geometry that overlaps it has changed
+  ezUInt64 uiGeometryHash = 0;
+  for (const Triangle& tri : tile.m_Triangles)
+  {
+    const ezVec3 vertices[3] = {m_Vertices[tri.m_VertexIdx[0]], m_Vertices[tri.m_VertexIdx[1]], m_Vertices[tri.m_VertexIdx[2]]};
+    uiGeometryHash = ezHashingUtils::xxHash64(vertices, sizeof(vertices), uiGeometryHash);
+  }
+
+  tile.m_bChanged = uiGeometryHash != tile.m_uiGeometryHash;
+
+  if (!tile.m_bChanged)
+    return EZ_SUCCESS;
+
+  tile.m_uiGeometryHash = 0;
+  tile.m_pPolyMesh.Clear();
+  tile.m_NavMeshData.Clear();
+
+  if (!tile.m_Triangles.IsEmpty())
+  {
+    const float fTileSize = (m_TileGridBounds.m_vMax.x - m_TileGridBounds.m_vMin.x) / m_uiNumTilesX;
+
+    ezBoundingBox tileBounds = m_TileGridBounds;
+    tileBounds.m_vMin.x += iTileX * fTileSize;
+    tileBounds.m_vMin.z += iTileY * fTileSize;
+    tileBounds.m_vMax.x = tileBounds.m_vMin.x + fTileSize;
+    tileBounds.m_vMax.z = tileBounds.m_vMin.z + fTileSize;
+
+    rcConfig cfg;
+    FillOutConfig(cfg, config, tileBounds);
+
+    // the heightfield includes a border, such that the tile edges match up with the neighbors
+    cfg.tileSize = (int)(fTileSize / cfg.cs + 0.5f);
+    cfg.borderSize = cfg.walkableRadius + 3;
+    cfg.width = cfg.tileSize + cfg.borderSize * 2;
+    cfg.height = cfg.tileSize + cfg.borderSize * 2;
+    cfg.bmin[0] -= cfg.borderSize * cfg.cs;
+    cfg.bmin[2] -= cfg.borderSize * cfg.cs;
+    cfg.bmax[0] += cfg.borderSize * cfg.cs;
+    cfg.bmax[2] += cfg.borderSize * cfg.cs;
+
+    // the tiles are built on worker threads, so they must not report to the shared context or progress bar
+    ezRcBuildContext context;
+    ezProgress progress;
+
+    ezUniquePtr<rcPolyMesh> pPolyMesh = EZ_DEFAULT_NEW(rcPolyMesh);
+    EZ_SUCCEED_OR_RETURN(BuildRecastPolyMesh(&context, cfg, m_Vertices, tile.m_Triangles, *pPolyMesh, progress));
+
+    if (pPolyMesh->npolys > 0)
+    {
+      EZ_SUCCEED_OR_RETURN(BuildDetourNavMeshData(config, *pPolyMesh, tile.m_NavMeshData, iTileX, iTileY));
+      tile.m_pPolyMesh = std::move(pPolyMesh);
+    }
+  }
+
+  tile.m_uiGeometryHash = uiGeometryHash;
+  return EZ_SUCCESS;
+}
+
 ezResult ezRecastConfig::Serialize(ezStreamWriter& stream) const
 {
-  stream.WriteVersion(1);
+  stream.WriteVersion(2);
 
   stream << m_fAgentHeight;
   stream << m_fAgentRadius;
@@ -493,13 +741,14 @@ ezResult ezRecastConfig::Serialize(ezStreamWriter& stream) const
   stream << m_fRegionMergeSize;
   stream << m_fDetailMeshSampleDistanceFactor;
   stream << m_fDetailMeshSampleErrorFactor;
+  stream << m_fTileSize;
 
   return EZ_SUCCESS;
 }
 
 ezResult ezRecastConfig::Deserialize(ezStreamReader& stream)
 {
-  stream.ReadVersion(1);
+  const ezTypeVersion version = stream.ReadVersion(2);
 
   stream >> m_fAgentHeight;
   stream >> m_fAgentRadius;
@@ -514,5 +763,10 @@ ezResult ezRecastConfig::Deserialize(ezStreamReader& stream)
   stream >> m_fDetailMeshSampleDistanceFactor;
   stream >> m_fDetailMeshSampleErrorFactor;
 
+  if (version >= 2)
+  {
+    stream >> m_fTileSize;
+  }
+
   return EZ_SUCCESS;
 }
@@ -6,6 +6,7 @@
 #include <RecastPlugin/RecastPluginDLL.h>
 
 class ezRcBuildContext;
+struct rcConfig;
 struct rcPolyMesh;
 struct rcPolyMeshDetail;
 class ezWorld;
@@ -29,6 +30,7 @@ struct EZ_RECASTPLUGIN_DLL ezRecastConfig
   float m_fRegionMergeSize = 20.0f;
   float m_fDetailMeshSampleDistanceFactor = 1.0f;
   float m_fDetailMeshSampleErrorFactor = 1.0f;
+  float m_fTileSize = 0.0f; ///< If larger than zero, the navmesh is built in tiles of this size, which allows to rebuild parts of it.
 
   ezResult Serialize(ezStreamWriter& stream) const;
   ezResult Deserialize(ezStreamReader& stream);
@@ -46,18 +48,42 @@ public:
 
   static ezResult ExtractWorldGeometry(const ezWorld& world, ezWorldGeoExtractionUtil::Geometry& out_worldGeo);
 
+  /// \brief Builds the navmesh for the given geometry.
+  ///
+  /// If ezRecastConfig::m_fTileSize is set, the navmesh is split into tiles which are built in parallel.
+  /// The builder remembers the geometry of every tile. When Build() is called again with the same config and the geometry still fits
+  /// into the previous tile grid, only the tiles whose geometry changed are rebuilt, see GetChangedTiles().
   ezResult Build(const ezRecastConfig& config, const ezWorldGeoExtractionUtil::Geometry& worldGeo,
     ezRecastNavMeshResourceDescriptor& out_NavMeshDesc, ezProgress& progress);
 
+  /// \brief Returns the coordinates of the tiles that were modified by the last tiled Build().
+  ///
+  /// These can be passed to ezRecastNavMeshResource::ReplaceTiles() together with the built descriptor to update a navmesh in place.
+  ezArrayPtr<const ezVec2I32> GetChangedTiles() const { return m_ChangedTiles; }
+
+  /// \brief Whether the last tiled Build() had to set up a new tile grid, e.g. because the config changed or the geometry grew.
+  ///
+  /// In that case all tiles were rebuilt and their coordinates don't match a navmesh that was built before, so it has to be replaced
+  /// completely instead of swapping in the changed tiles.
+  bool HasTileGridChanged() const { return m_bTileGridChanged; }
+
 private:
-  static void FillOutConfig(struct rcConfig& cfg, const ezRecastConfig& config, const ezBoundingBox& bbox);
+  struct Triangle;
+  struct NavMeshTile;
+
+  static void FillOutConfig(rcConfig& cfg, const ezRecastConfig& config, const ezBoundingBox& bbox);
 
   void Clear();
   void ReserveMemory(const ezWorldGeoExtractionUtil::Geometry& desc);
   void GenerateTriangleMeshFromDescription(const ezWorldGeoExtractionUtil::Geometry& desc);
   void ComputeBoundingBox();
-  ezResult BuildRecastPolyMesh(const ezRecastConfig& config, rcPolyMesh& out_PolyMesh, ezProgress& progress);
-  static ezResult BuildDetourNavMeshData(const ezRecastConfig& config, const rcPolyMesh& polyMesh, ezDataBuffer& NavmeshData);
+  ezResult BuildTiles(const ezRecastConfig& config, ezRecastNavMeshResourceDescriptor& out_NavMeshDesc, ezProgress& progress);
+  bool SetupTileGrid(const ezRecastConfig& config);
+  ezResult BuildTile(const ezRecastConfig& config, ezUInt32 uiTileIdx);
+  static ezResult BuildRecastPolyMesh(ezRcBuildContext* pContext, const rcConfig& cfg, ezArrayPtr<const ezVec3> vertices,
+    ezArrayPtr<const Triangle> triangles, rcPolyMesh& out_PolyMesh, ezProgress& progress);
+  static ezResult BuildDetourNavMeshData(
+    const ezRecastConfig& config, const rcPolyMesh& polyMesh, ezDataBuffer& NavmeshData, ezInt32 iTileX = 0, ezInt32 iTileY = 0);
 
   struct Triangle
   {
@@ -72,9 +98,26 @@ private:
     ezInt32 m_VertexIdx[3];
   };
 
+  struct NavMeshTile
+  {
+    ezUInt64 m_uiGeometryHash = 0;
+    ezUniquePtr<rcPolyMesh> m_pPolyMesh; // null if nothing in the tile is walkable
+    ezDataBuffer m_NavMeshData;
+    ezDynamicArray<Triangle> m_Triangles; // the triangles that overlap the tile including its border, only needed during the build
+    bool m_bChanged = false;
+  };
+
   ezBoundingBox m_BoundingBox;
   ezDynamicArray<ezVec3> m_Vertices;
   ezDynamicArray<Triangle> m_Triangles;
-  ezDynamicArray<ezUInt8> m_TriangleAreaIDs;
   ezRcBuildContext* m_pRecastContext = nullptr;
+
+  // the tile grid is kept across builds, such that unchanged tiles don't need to be rebuilt
+  ezBoundingBox m_TileGridBounds;
+  ezUInt32 m_uiNumTilesX = 0;
+  ezUInt32 m_uiNumTilesY = 0;
+  ezUInt64 m_uiTileConfigHash = 0;
+  ezDynamicArray<NavMeshTile> m_Tiles;
+  ezDynamicArray<ezVec2I32> m_ChangedTiles;
+  bool m_bTileGridChanged = true;
 };
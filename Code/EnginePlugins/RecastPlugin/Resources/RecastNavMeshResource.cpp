@@ -2,6 +2,7 @@
 
 #include <Core/Assets/AssetFileHeader.h>
 #include <Foundation/IO/ChunkStream.h>
+#include <Recast/DetourAlloc.h>
 #include <Recast/DetourNavMesh.h>
 #include <Recast/Recast.h>
 #include <Recast/RecastAlloc.h>
@@ -30,7 +31,13 @@ ezRecastNavMeshResourceDescriptor::~ezRecastNavMeshResourceDescriptor()
 void ezRecastNavMeshResourceDescriptor::operator=(ezRecastNavMeshResourceDescriptor&& rhs)
 {
   m_DetourNavmeshData = std::move(rhs.m_DetourNavmeshData);
+  m_Tiles = std::move(rhs.m_Tiles);
+  m_vTileOrigin = rhs.m_vTileOrigin;
+  m_fTileSize = rhs.m_fTileSize;
+  m_uiMaxTiles = rhs.m_uiMaxTiles;
+  m_uiMaxPolysPerTile = rhs.m_uiMaxPolysPerTile;
 
+  EZ_DEFAULT_DELETE(m_pNavMeshPolygons);
   m_pNavMeshPolygons = rhs.m_pNavMeshPolygons;
   rhs.m_pNavMeshPolygons = nullptr;
 }
@@ -38,6 +45,10 @@ void ezRecastNavMeshResourceDescriptor::operator=(ezRecastNavMeshResourceDescrip
 void ezRecastNavMeshResourceDescriptor::Clear()
 {
   m_DetourNavmeshData.Clear();
+  m_Tiles.Clear();
+  m_fTileSize = 0.0f;
+  m_uiMaxTiles = 0;
+  m_uiMaxPolysPerTile = 0;
   EZ_DEFAULT_DELETE(m_pNavMeshPolygons);
 }
 
@@ -45,9 +56,22 @@ void ezRecastNavMeshResourceDescriptor::Clear()
 
 ezResult ezRecastNavMeshResourceDescriptor::Serialize(ezStreamWriter& stream) const
 {
-  stream.WriteVersion(1);
+  stream.WriteVersion(2);
   EZ_SUCCEED_OR_RETURN(stream.WriteArray(m_DetourNavmeshData));
 
+  stream << m_Tiles.GetCount();
+  for (const Tile& tile : m_Tiles)
+  {
+    stream << tile.m_iTileX;
+    stream << tile.m_iTileY;
+    EZ_SUCCEED_OR_RETURN(stream.WriteArray(tile.m_NavMeshData));
+  }
+
+  stream << m_vTileOrigin;
+  stream << m_fTileSize;
+  stream << m_uiMaxTiles;
+  stream << m_uiMaxPolysPerTile;
+
   const bool hasPolygons = m_pNavMeshPolygons != nullptr;
   stream << hasPolygons;
 
@@ -88,9 +112,28 @@ ezResult ezRecastNavMeshResourceDescriptor::Deserialize(ezStreamReader& stream)
 {
   Clear();
 
-  const ezTypeVersion version = stream.ReadVersion(1);
+  const ezTypeVersion version = stream.ReadVersion(2);
   EZ_SUCCEED_OR_RETURN(stream.ReadArray(m_DetourNavmeshData));
 
+  if (version >= 2)
+  {
+    ezUInt32 uiNumTiles = 0;
+    stream >> uiNumTiles;
+    m_Tiles.SetCount(uiNumTiles);
+
+    for (Tile& tile : m_Tiles)
+    {
+      stream >> tile.m_iTileX;
+      stream >> tile.m_iTileY;
+      EZ_SUCCEED_OR_RETURN(stream.ReadArray(tile.m_NavMeshData));
+    }
+
+    stream >> m_vTileOrigin;
+    stream >> m_fTileSize;
+    stream >> m_uiMaxTiles;
+    stream >> m_uiMaxPolysPerTile;
+  }
+
   bool hasPolygons = false;
   stream >> hasPolygons;
 
@@ -122,6 +165,7 @@ ezResult ezRecastNavMeshResourceDescriptor::Deserialize(ezStreamReader& stream)
     mesh.verts = (ezUInt16*)rcAlloc(sizeof(ezUInt16) * mesh.nverts * 3, RC_ALLOC_PERM);
     mesh.polys = (ezUInt16*)rcAlloc(sizeof(ezUInt16) * mesh.maxpolys * mesh.nvp * 2, RC_ALLOC_PERM);
     mesh.regs = (ezUInt16*)rcAlloc(sizeof(ezUInt16) * mesh.maxpolys, RC_ALLOC_PERM);
+    mesh.flags = (ezUInt16*)rcAlloc(sizeof(ezUInt16) * mesh.maxpolys, RC_ALLOC_PERM);
     mesh.areas = (ezUInt8*)rcAlloc(sizeof(ezUInt8) * mesh.maxpolys, RC_ALLOC_PERM);
 
     stream.ReadBytes(mesh.verts, sizeof(ezUInt16) * mesh.nverts * 3);
@@ -136,6 +180,25 @@ ezResult ezRecastNavMeshResourceDescriptor::Deserialize(ezStreamReader& stream)
 
 //////////////////////////////////////////////////////////////////////////
 
+static ezResult AddNavMeshTile(dtNavMesh& navMesh, const ezRecastNavMeshResourceDescriptor::Tile& tile)
+{
+  // the navmesh frees the data of a tile when it gets removed, so it must be allocated by Detour
+  ezUInt8* pData = static_cast<ezUInt8*>(dtAlloc(tile.m_NavMeshData.GetCount(), DT_ALLOC_PERM));
+  ezMemoryUtils::Copy(pData, tile.m_NavMeshData.GetData(), tile.m_NavMeshData.GetCount());
+
+  if (dtStatusFailed(navMesh.addTile(pData, tile.m_NavMeshData.GetCount(), DT_TILE_FREE_DATA, 0, nullptr)))
+  {
+    dtFree(pData);
+
+    ezLog::Error("Could not add navmesh tile ({0}, {1})", tile.m_iTileX, tile.m_iTileY);
+    return EZ_FAILURE;
+  }
+
+  return EZ_SUCCESS;
+}
+
+//////////////////////////////////////////////////////////////////////////
+
 ezRecastNavMeshResource::ezRecastNavMeshResource()
   : ezResource(DoUpdate::OnAnyThread, 1)
 {
@@ -159,6 +222,13 @@ ezResourceLoadDesc ezRecastNavMeshResource::UnloadData(Unload WhatToUnload)
   EZ_DEFAULT_DELETE(m_pNavMesh);
   EZ_DEFAULT_DELETE(m_pNavMeshPolygons);
 
+  {
+    // the queued tiles belong to the old navmesh, the reloaded one is complete anyway
+    EZ_LOCK(m_QueuedTilesMutex);
+    m_QueuedTiles.Clear();
+    m_QueuedChangedTiles.Clear();
+  }
+
   return res;
 }
 
@@ -196,6 +266,17 @@ void ezRecastNavMeshResource::UpdateMemoryUsage(MemoryUsage& out_NewMemoryUsage)
   out_NewMemoryUsage.m_uiMemoryCPU = sizeof(ezRecastNavMeshResource);
   out_NewMemoryUsage.m_uiMemoryCPU += m_DetourNavmeshData.GetHeapMemoryUsage();
   out_NewMemoryUsage.m_uiMemoryCPU += m_pNavMesh != nullptr ? sizeof(dtNavMesh) : 0;
+
+  if (m_pNavMesh != nullptr && m_DetourNavmeshData.IsEmpty())
+  {
+    const dtNavMesh* pNavMesh = m_pNavMesh;
+
+    for (int i = 0; i < pNavMesh->getMaxTiles(); ++i)
+    {
+      out_NewMemoryUsage.m_uiMemoryCPU += pNavMesh->getTile(i)->dataSize;
+    }
+  }
+
   out_NewMemoryUsage.m_uiMemoryCPU += m_pNavMeshPolygons != nullptr ? sizeof(rcPolyMesh) : 0;
   out_NewMemoryUsage.m_uiMemoryGPU = 0;
 }
@@ -210,13 +291,122 @@ ezResourceLoadDesc ezRecastNavMeshResource::CreateResource(ezRecastNavMeshResour
   m_pNavMeshPolygons = descriptor.m_pNavMeshPolygons;
   descriptor.m_pNavMeshPolygons = nullptr;
 
-  m_DetourNavmeshData = std::move(descriptor.m_DetourNavmeshData);
-
   m_pNavMesh = EZ_DEFAULT_NEW(dtNavMesh);
 
+  if (!descriptor.m_Tiles.IsEmpty())
+  {
+    dtNavMeshParams params;
+    params.orig[0] = descriptor.m_vTileOrigin.x;
+    params.orig[1] = descriptor.m_vTileOrigin.y;
+    params.orig[2] = descriptor.m_vTileOrigin.z;
+    params.tileWidth = descriptor.m_fTileSize;
+    params.tileHeight = descriptor.m_fTileSize;
+    params.maxTiles = descriptor.m_uiMaxTiles;
+    params.maxPolys = descriptor.m_uiMaxPolysPerTile;
+
+    if (dtStatusFailed(m_pNavMesh->init(&params)))
+    {
+      ezLog::Error("Could not initialize the tiled navmesh");
+      return res;
+    }
+
+    for (const auto& tile : descriptor.m_Tiles)
+    {
+      AddNavMeshTile(*m_pNavMesh, tile).IgnoreResult();
+    }
+
+    return res;
+  }
+
+  m_DetourNavmeshData = std::move(descriptor.m_DetourNavmeshData);
+
   // the dtNavMesh does not need to free the data, the resource owns it
   const int dtMeshFlags = 0;
   m_pNavMesh->init(m_DetourNavmeshData.GetData(), m_DetourNavmeshData.GetCount(), dtMeshFlags);
 
   return res;
 }
+
+ezResult ezRecastNavMeshResource::ReplaceTiles(ezRecastNavMeshResourceDescriptor&& descriptor, ezArrayPtr<const ezVec2I32> changedTiles)
+{
+  if (m_pNavMesh == nullptr || !m_DetourNavmeshData.IsEmpty())
+  {
+    ezLog::Error("Tiles can only be replaced in a tiled navmesh");
+    return EZ_FAILURE;
+  }
+
+  const dtNavMeshParams* pParams = m_pNavMesh->getParams();
+  if (pParams->tileWidth != descriptor.m_fTileSize || pParams->maxTiles != (int)descriptor.m_uiMaxTiles ||
+      pParams->maxPolys != (int)descriptor.m_uiMaxPolysPerTile || ezVec3(pParams->orig[0], pParams->orig[1], pParams->orig[2]) != descriptor.m_vTileOrigin)
+  {
+    ezLog::Error("The navmesh tiles were built with a different tile grid");
+    return EZ_FAILURE;
+  }
+
+  for (const ezVec2I32& coord : changedTiles)
+  {
+    const dtTileRef tileRef = m_pNavMesh->getTileRefAt(coord.x, coord.y, 0);
+
+    // the tile data is freed by the navmesh
+    if (tileRef != 0)
+    {
+      m_pNavMesh->removeTile(tileRef, nullptr, nullptr);
+    }
+  }
+
+  ezResult result = EZ_SUCCESS;
+
+  for (const auto& tile : descriptor.m_Tiles)
+  {
+    for (const ezVec2I32& coord : changedTiles)
+    {
+      if (coord.x == tile.m_iTileX && coord.y == tile.m_iTileY)
+      {
+        if (AddNavMeshTile(*m_pNavMesh, tile).Failed())
+          result = EZ_FAILURE;
+
+        break;
+      }
+    }
+  }
+
+  EZ_DEFAULT_DELETE(m_pNavMeshPolygons);
+  m_pNavMeshPolygons = descriptor.m_pNavMeshPolygons;
+  descriptor.m_pNavMeshPolygons = nullptr;
+
+  UpdateMemoryUsage(ModifyMemoryUsage());
+  IncResourceChangeCounter();
+
+  return result;
+}
+
+void ezRecastNavMeshResource::QueueTileReplacement(ezRecastNavMeshResourceDescriptor&& descriptor, ezArrayPtr<const ezVec2I32> changedTiles)
+{
+  EZ_LOCK(m_QueuedTilesMutex);
+
+  // the descriptor always contains all tiles, so the newer one is complete
+  m_QueuedTiles = std::move(descriptor);
+
+  for (const ezVec2I32& coord : changedTiles)
+  {
+    if (!m_QueuedChangedTiles.Contains(coord))
+    {
+      m_QueuedChangedTiles.PushBack(coord);
+    }
+  }
+}
+
+bool ezRecastNavMeshResource::TakeQueuedTileReplacement(ezRecastNavMeshResourceDescriptor& out_Descriptor, ezDynamicArray<ezVec2I32>& out_ChangedTiles)
+{
+  EZ_LOCK(m_QueuedTilesMutex);
+
+  if (m_QueuedChangedTiles.IsEmpty())
+    return false;
+
+  out_Descriptor = std::move(m_QueuedTiles);
+  out_ChangedTiles = std::move(m_QueuedChangedTiles);
+
+  m_QueuedTiles.Clear();
+  m_QueuedChangedTiles.Clear();
+  return true;
+}
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <Core/ResourceManager/Resource.h>
+#include <Foundation/Threading/Mutex.h>
 #include <RecastPlugin/RecastPluginDLL.h>
 
 struct rcPolyMesh;
@@ -17,9 +18,25 @@ struct EZ_RECASTPLUGIN_DLL ezRecastNavMeshResourceDescriptor
   void operator=(ezRecastNavMeshResourceDescriptor&& rhs);
   void operator=(const ezRecastNavMeshResourceDescriptor& rhs) = delete;
 
+  struct Tile
+  {
+    ezInt32 m_iTileX = 0;
+    ezInt32 m_iTileY = 0;
+
+    /// \brief Data that was created by dtCreateNavMeshData() for this tile and will be used for dtNavMesh::addTile()
+    ezDataBuffer m_NavMeshData;
+  };
+
   /// \brief Data that was created by dtCreateNavMeshData() and will be used for dtNavMesh::init()
   ezDataBuffer m_DetourNavmeshData;
 
+  /// \brief If the navmesh was built in tiles, m_DetourNavmeshData is unused and the tile grid is described by the values below.
+  ezDynamicArray<Tile> m_Tiles;
+  ezVec3 m_vTileOrigin = ezVec3::ZeroVector(); ///< In Recast convention (Y up)
+  float m_fTileSize = 0.0f;
+  ezUInt32 m_uiMaxTiles = 0;
+  ezUInt32 m_uiMaxPolysPerTile = 0;
+
   /// \brief Optional, if available the navmesh can be visualized at runtime
   rcPolyMesh* m_pNavMeshPolygons = nullptr;
 
@@ -42,6 +59,25 @@ public:
   const dtNavMesh* GetNavMesh() const { return m_pNavMesh; }
   const rcPolyMesh* GetNavMeshPolygons() const { return m_pNavMeshPolygons; }
 
+  /// \brief Replaces the tiles of a tiled navmesh at the given coordinates with the ones from \a descriptor.
+  ///
+  /// The descriptor must be built with the same tile grid, as ezRecastNavMeshBuilder does when the geometry changed, see
+  /// ezRecastNavMeshBuilder::GetChangedTiles(). Tiles that are not in the descriptor are removed. The polygons for visualization are
+  /// replaced as well.
+  ///
+  /// This increases the resource change counter, because polygon references into the removed tiles become invalid.
+  /// Nothing must access the navmesh concurrently, e.g. path searches during the async phase of a world update.
+  ezResult ReplaceTiles(ezRecastNavMeshResourceDescriptor&& descriptor, ezArrayPtr<const ezVec2I32> changedTiles);
+
+  /// \brief Thread-safe variant of ReplaceTiles() for navmeshes that are built in the background.
+  ///
+  /// The tiles are swapped in by ezRecastWorldModule during its next synchronous update, see TakeQueuedTileReplacement().
+  /// If a replacement is already queued, the newer descriptor is used and the changed tiles of both are combined.
+  void QueueTileReplacement(ezRecastNavMeshResourceDescriptor&& descriptor, ezArrayPtr<const ezVec2I32> changedTiles);
+
+  /// \brief Moves the replacement that was queued by QueueTileReplacement() into the given variables. Returns false if there is none.
+  bool TakeQueuedTileReplacement(ezRecastNavMeshResourceDescriptor& out_Descriptor, ezDynamicArray<ezVec2I32>& out_ChangedTiles);
+
 private:
   virtual ezResourceLoadDesc UnloadData(Unload WhatToUnload) override;
   virtual ezResourceLoadDesc UpdateContent(ezStreamReader* Stream) override;
@@ -50,4 +86,8 @@ private:
   ezDataBuffer m_DetourNavmeshData;
   dtNavMesh* m_pNavMesh = nullptr;
   rcPolyMesh* m_pNavMeshPolygons = nullptr;
+
+  ezMutex m_QueuedTilesMutex;
+  ezRecastNavMeshResourceDescriptor m_QueuedTiles;
+  ezDynamicArray<ezVec2I32> m_QueuedChangedTiles;
 };
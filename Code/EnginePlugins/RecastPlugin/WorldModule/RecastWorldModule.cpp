@@ -1,10 +1,22 @@
 #include <RecastPluginPCH.h>
 
 #include <Core/World/World.h>
+#include <Foundation/Configuration/CVar.h>
+#include <Foundation/Threading/TaskSystem.h>
 #include <Recast/DetourCrowd.h>
 #include <RecastPlugin/Resources/RecastNavMeshResource.h>
+#include <RecastPlugin/Utils/RcMath.h>
 #include <RecastPlugin/WorldModule/RecastWorldModule.h>
 
+ezCVarInt CVarPathQueryIterationsPerFrame("ai_PathQueryIterationsPerFrame", 4096, ezCVarFlags::Default,
+  "How many path search iterations are done per frame for all agents together");
+ezCVarInt CVarMaxPathQueriesInFlight("ai_MaxPathQueriesInFlight", 16, ezCVarFlags::Default,
+  "How many path searches are processed in parallel. Changes take effect when the navmesh is loaded.");
+ezCVarInt CVarPathQueryMaxSearchNodes("ai_PathQueryMaxSearchNodes", 2048, ezCVarFlags::Default,
+  "How many navmesh polygons a single path search can visit. Changes take effect when the navmesh is loaded.");
+ezCVarInt CVarMaxPathCorridorLength("ai_MaxPathCorridorLength", 256, ezCVarFlags::Default,
+  "How many navmesh polygons a path corridor contains at most, longer paths end early as partial paths");
+
 // clang-format off
 EZ_IMPLEMENT_WORLD_MODULE(ezRecastWorldModule);
 EZ_BEGIN_DYNAMIC_REFLECTED_TYPE(ezRecastWorldModule, 1, ezRTTINoAllocator)
@@ -31,6 +43,14 @@ void ezRecastWorldModule::Initialize()
     RegisterUpdateFunction(updateDesc);
   }
 
+  {
+    auto updateDesc = EZ_CREATE_MODULE_UPDATE_FUNCTION_DESC(ezRecastWorldModule::UpdatePathQueries, this);
+    updateDesc.m_Phase = ezWorldModule::UpdateFunctionDesc::Phase::Async;
+    updateDesc.m_bOnlyUpdateWhenSimulating = true;
+
+    RegisterUpdateFunction(updateDesc);
+  }
+
   ezResourceManager::GetResourceEvents().AddEventHandler(ezMakeDelegate(&ezRecastWorldModule::ResourceEventHandler, this));
 }
 
@@ -46,21 +66,72 @@ void ezRecastWorldModule::SetNavMeshResource(const ezRecastNavMeshResourceHandle
   m_hNavMesh = hNavMesh;
   m_pDetourNavMesh = nullptr;
   m_pNavMeshPointsOfInterest.Clear();
+
+  ResetPathQuerySlots();
+}
+
+ezResult ezRecastWorldModule::ReplaceNavMeshTiles(ezRecastNavMeshResourceDescriptor&& descriptor, ezArrayPtr<const ezVec2I32> changedTiles)
+{
+  if (!m_hNavMesh.IsValid())
+    return EZ_FAILURE;
+
+  ezResourceLock<ezRecastNavMeshResource> pNavMesh(m_hNavMesh, ezResourceAcquireMode::BlockTillLoaded_NeverFail);
+
+  if (pNavMesh.GetAcquireResult() != ezResourceAcquireResult::Final)
+    return EZ_FAILURE;
+
+  // the path searches may already reference polygons of the removed tiles
+  ResetPathQuerySlots();
+
+  // everything else is updated once the change counter of the resource is noticed
+  return pNavMesh.GetPointerNonConst()->ReplaceTiles(std::move(descriptor), changedTiles);
 }
 
 void ezRecastWorldModule::UpdateNavMesh(const UpdateContext& ctxt)
 {
-  if (m_pDetourNavMesh == nullptr && m_hNavMesh.IsValid())
+  // the path query slots may have been invalidated while the async phase was using them
+  if (m_bResetPathQuerySlots.Set(false))
+  {
+    ResetPathQuerySlots();
+  }
+
+  if (m_hNavMesh.IsValid())
   {
     ezResourceLock<ezRecastNavMeshResource> pNavMesh(m_hNavMesh, ezResourceAcquireMode::BlockTillLoaded_NeverFail);
 
     if (pNavMesh.GetAcquireResult() != ezResourceAcquireResult::Final)
       return;
 
-    m_pDetourNavMesh = pNavMesh->GetNavMesh();
+    // tiles that were rebuilt in the background are swapped in here, where no path search is running
+    {
+      ezRecastNavMeshResourceDescriptor queuedTiles;
+      ezDynamicArray<ezVec2I32> changedTiles;
+
+      if (pNavMesh.GetPointerNonConst()->TakeQueuedTileReplacement(queuedTiles, changedTiles))
+      {
+        ReplaceNavMeshTiles(std::move(queuedTiles), changedTiles).IgnoreResult();
+      }
+    }
+
+    // tiles of the navmesh may have been replaced, also by another world that uses the same resource
+    if (m_pDetourNavMesh == nullptr || m_uiNavMeshResourceChangeCounter != pNavMesh->GetCurrentResourceChangeCounter())
+    {
+      if (m_pDetourNavMesh != nullptr)
+      {
+        ResetPathQuerySlots();
+      }
 
-    m_pNavMeshPointsOfInterest = EZ_DEFAULT_NEW(ezNavMeshPointOfInterestGraph);
-    m_pNavMeshPointsOfInterest->ExtractInterestPointsFromMesh(*pNavMesh->GetNavMeshPolygons());
+      m_uiNavMeshResourceChangeCounter = pNavMesh->GetCurrentResourceChangeCounter();
+      ++m_uiNavMeshChangeCounter;
+
+      m_pDetourNavMesh = pNavMesh->GetNavMesh();
+      m_pNavMeshPointsOfInterest = EZ_DEFAULT_NEW(ezNavMeshPointOfInterestGraph);
+
+      if (pNavMesh->GetNavMeshPolygons() != nullptr)
+      {
+        m_pNavMeshPointsOfInterest->ExtractInterestPointsFromMesh(*pNavMesh->GetNavMeshPolygons());
+      }
+    }
   }
 
   if (m_pNavMeshPointsOfInterest)
@@ -76,5 +147,260 @@ void ezRecastWorldModule::ResourceEventHandler(const ezResourceEvent& e)
   {
     // triggers a recreation in the next update
     m_pDetourNavMesh = nullptr;
+
+    // the event may arrive while the path queries are processed, the slots are reset in the next synchronous update
+    m_bResetPathQuerySlots = true;
+  }
+}
+
+ezResult ezRecastWorldModule::FindNavMeshPolyAt(const dtNavMeshQuery& query, const dtQueryFilter& filter, const ezVec3& vPosition,
+  dtPolyRef& out_PolyRef, ezVec3* out_vAdjustedPosition /*= nullptr*/, float fPlaneEpsilon /*= 0.01f*/, float fHeightEpsilon /*= 1.0f*/)
+{
+  ezRcPos rcPos = vPosition;
+  ezVec3 vSize(fPlaneEpsilon, fHeightEpsilon, fPlaneEpsilon);
+
+  ezRcPos resultPos;
+  if (dtStatusFailed(query.findNearestPoly(rcPos, &vSize.x, &filter, &out_PolyRef, resultPos)))
+    return EZ_FAILURE;
+
+  if (!ezMath::IsEqual(vPosition.x, resultPos.m_Pos[0], fPlaneEpsilon) ||
+      !ezMath::IsEqual(vPosition.y, resultPos.m_Pos[2], fPlaneEpsilon) || !ezMath::IsEqual(vPosition.z, resultPos.m_Pos[1], fHeightEpsilon))
+    return EZ_FAILURE;
+
+  if (out_vAdjustedPosition != nullptr)
+  {
+    *out_vAdjustedPosition = resultPos;
+  }
+
+  return EZ_SUCCESS;
+}
+
+ezUInt32 ezRecastWorldModule::RequestPath(const ezVec3& vStart, const ezVec3& vTarget)
+{
+  EZ_LOCK(m_PathQueryMutex);
+
+  PathQuery& query = m_PendingPathQueries.ExpandAndGetRef();
+  query.m_uiQueryID = m_uiNextPathQueryID;
+  query.m_vStart = vStart;
+  query.m_vTarget = vTarget;
+
+  ++m_uiNumUnfinishedPathQueries;
+
+  // 0 is reserved for free query slots
+  m_uiNextPathQueryID = ezMath::Max(m_uiNextPathQueryID + 1, 1u);
+
+  return query.m_uiQueryID;
+}
+
+void ezRecastWorldModule::CancelPathQuery(ezUInt32 uiQueryID)
+{
+  EZ_LOCK(m_PathQueryMutex);
+
+  if (m_FinishedPathQueries.Remove(uiQueryID))
+    return;
+
+  for (ezUInt32 i = 0; i < m_PendingPathQueries.GetCount(); ++i)
+  {
+    if (m_PendingPathQueries[i].m_uiQueryID == uiQueryID)
+    {
+      m_PendingPathQueries.RemoveAtAndCopy(i);
+      --m_uiNumUnfinishedPathQueries;
+      return;
+    }
+  }
+
+  // the query is currently being processed, it is discarded the next time its slot is updated
+  for (const PathQuerySlot& slot : m_PathQuerySlots)
+  {
+    if (slot.m_Query.m_uiQueryID == uiQueryID)
+    {
+      m_CancelledPathQueries.Insert(uiQueryID);
+      return;
+    }
+  }
+}
+
+ezRecastPathQueryState::Enum ezRecastWorldModule::RetrievePathQueryResult(ezUInt32 uiQueryID, ezRecastPathQueryResult& out_Result)
+{
+  EZ_LOCK(m_PathQueryMutex);
+
+  if (!m_FinishedPathQueries.Remove(uiQueryID, &out_Result))
+    return ezRecastPathQueryState::Pending;
+
+  return out_Result.m_State;
+}
+
+void ezRecastWorldModule::UpdatePathQueries(const UpdateContext& ctxt)
+{
+  if (m_pDetourNavMesh == nullptr)
+    return;
+
+  ezUInt32 uiNumUnfinishedPathQueries = 0;
+  {
+    EZ_LOCK(m_PathQueryMutex);
+    uiNumUnfinishedPathQueries = m_uiNumUnfinishedPathQueries;
+  }
+
+  if (uiNumUnfinishedPathQueries == 0)
+    return;
+
+  if (m_PathQuerySlots.IsEmpty())
+  {
+    m_PathQuerySlots.SetCount(ezMath::Max<ezInt32>(CVarMaxPathQueriesInFlight, 1));
+
+    for (PathQuerySlot& slot : m_PathQuerySlots)
+    {
+      slot.m_pQuery = EZ_DEFAULT_NEW(dtNavMeshQuery);
+
+      // Detour stores the node indices in 16 bits
+      slot.m_pQuery->init(m_pDetourNavMesh, ezMath::Clamp<ezInt32>(CVarPathQueryMaxSearchNodes, 1, 0xFFFF));
+    }
+  }
+
+  // the budget is shared by all queries that are processed this frame, a slot that finishes early takes the next pending query
+  const ezUInt32 uiNumBusySlots = ezMath::Min(uiNumUnfinishedPathQueries, m_PathQuerySlots.GetCount());
+  const ezInt32 iMaxIterationsPerSlot = ezMath::Max<ezInt32>(CVarPathQueryIterationsPerFrame / uiNumBusySlots, 1);
+
+  ezParallelForParams params;
+  params.uiBinSize = 1;
+  params.uiMaxTasksPerThread = 2;
+
+  ezTaskSystem::ParallelForIndexed(0, m_PathQuerySlots.GetCount(),
+    [this, iMaxIterationsPerSlot](ezUInt32 uiStartIndex, ezUInt32 uiEndIndex) {
+      for (ezUInt32 i = uiStartIndex; i < uiEndIndex; ++i)
+      {
+        ProcessPathQuerySlot(m_PathQuerySlots[i], iMaxIterationsPerSlot);
+      }
+    },
+    "Recast Path Queries", params);
+}
+
+void ezRecastWorldModule::ProcessPathQuerySlot(PathQuerySlot& slot, ezInt32 iMaxIterations)
+{
+  while (iMaxIterations > 0)
+  {
+    {
+      EZ_LOCK(m_PathQueryMutex);
+
+      if (slot.m_Query.m_uiQueryID != 0 && m_CancelledPathQueries.Remove(slot.m_Query.m_uiQueryID))
+      {
+        slot.m_Query.m_uiQueryID = 0;
+        --m_uiNumUnfinishedPathQueries;
+      }
+
+      if (slot.m_Query.m_uiQueryID == 0)
+      {
+        if (m_PendingPathQueries.IsEmpty())
+          return;
+
+        slot.m_Query = m_PendingPathQueries.PeekFront();
+        slot.m_bSearchStarted = false;
+        m_PendingPathQueries.PopFront();
+      }
+    }
+
+    if (!slot.m_bSearchStarted)
+    {
+      StartPathSearch(slot);
+
+      // even queries that fail immediately count against the budget
+      --iMaxIterations;
+    }
+
+    if (slot.m_Result.m_State == ezRecastPathQueryState::Pending)
+    {
+      int iDoneIterations = 0;
+      const dtStatus status = slot.m_pQuery->updateSlicedFindPath(iMaxIterations, &iDoneIterations);
+      iMaxIterations -= ezMath::Max(iDoneIterations, 1);
+
+      if (dtStatusInProgress(status))
+        continue;
+
+      if (dtStatusFailed(status))
+        slot.m_Result.m_State = ezRecastPathQueryState::NoPath;
+      else
+        FinalizePathSearch(slot);
+    }
+
+    EZ_LOCK(m_PathQueryMutex);
+
+    if (!m_CancelledPathQueries.Remove(slot.m_Query.m_uiQueryID))
+    {
+      m_FinishedPathQueries.Insert(slot.m_Query.m_uiQueryID, std::move(slot.m_Result));
+    }
+
+    slot.m_Query.m_uiQueryID = 0;
+    --m_uiNumUnfinishedPathQueries;
   }
 }
+
+void ezRecastWorldModule::StartPathSearch(PathQuerySlot& slot) const
+{
+  ezRecastPathQueryResult& result = slot.m_Result;
+  result.m_State = ezRecastPathQueryState::Pending;
+  result.m_PathCorridor.Clear();
+
+  slot.m_bSearchStarted = true;
+
+  if (FindNavMeshPolyAt(*slot.m_pQuery, m_PathQueryFilter, slot.m_Query.m_vStart, result.m_StartPoly, &result.m_vStartPositionOnNavMesh).Failed())
+  {
+    result.m_State = ezRecastPathQueryState::StartOutsideNavMesh;
+    return;
+  }
+
+  if (FindNavMeshPolyAt(*slot.m_pQuery, m_PathQueryFilter, slot.m_Query.m_vTarget, result.m_EndPoly).Failed())
+  {
+    result.m_State = ezRecastPathQueryState::InvalidTarget;
+    return;
+  }
+
+  const ezRcPos rcStart = result.m_vStartPositionOnNavMesh;
+  const ezRcPos rcEnd = slot.m_Query.m_vTarget;
+
+  if (dtStatusFailed(slot.m_pQuery->initSlicedFindPath(result.m_StartPoly, result.m_EndPoly, rcStart, rcEnd, &m_PathQueryFilter)))
+  {
+    result.m_State = ezRecastPathQueryState::NoPath;
+  }
+}
+
+void ezRecastWorldModule::FinalizePathSearch(PathQuerySlot& slot) const
+{
+  ezRecastPathQueryResult& result = slot.m_Result;
+
+  result.m_PathCorridor.SetCountUninitialized(ezMath::Max<ezInt32>(CVarMaxPathCorridorLength, 1));
+
+  int iPathCorridorLength = 0;
+  if (dtStatusFailed(slot.m_pQuery->finalizeSlicedFindPath(result.m_PathCorridor.GetData(), &iPathCorridorLength, (int)result.m_PathCorridor.GetCount())) ||
+      iPathCorridorLength <= 0)
+  {
+    result.m_PathCorridor.Clear();
+    result.m_State = ezRecastPathQueryState::NoPath;
+    return;
+  }
+
+  result.m_PathCorridor.SetCountUninitialized(iPathCorridorLength);
+
+  // if the path doesn't end at the target polygon, the target cannot be reached, but one can get close to it
+  result.m_State = result.m_PathCorridor.PeekBack() == result.m_EndPoly ? ezRecastPathQueryState::FullPath : ezRecastPathQueryState::PartialPath;
+}
+
+void ezRecastWorldModule::ResetPathQuerySlots()
+{
+  EZ_LOCK(m_PathQueryMutex);
+
+  // the navmesh queries reference the old navmesh, the searches are restarted once the new one is available
+  for (ezUInt32 i = m_PathQuerySlots.GetCount(); i > 0; --i)
+  {
+    const PathQuery& query = m_PathQuerySlots[i - 1].m_Query;
+
+    if (query.m_uiQueryID == 0)
+      continue;
+
+    if (m_CancelledPathQueries.Remove(query.m_uiQueryID))
+      --m_uiNumUnfinishedPathQueries;
+    else
+      m_PendingPathQueries.PushFront(query);
+  }
+
+  m_PathQuerySlots.Clear();
+}
@@ -4,14 +4,48 @@
 
 #include <Core/ResourceManager/ResourceHandle.h>
 #include <Core/World/WorldModule.h>
+#include <Foundation/Containers/Deque.h>
+#include <Foundation/Containers/HashSet.h>
+#include <Foundation/Containers/HashTable.h>
+#include <Foundation/Threading/AtomicInteger.h>
+#include <Foundation/Threading/Mutex.h>
 #include <NavMeshBuilder/NavMeshPointsOfInterest.h>
+#include <Recast/DetourNavMeshQuery.h>
 
 class dtCrowd;
 class dtNavMesh;
 struct ezResourceEvent;
+struct ezRecastNavMeshResourceDescriptor;
 
 typedef ezTypedResourceHandle<class ezRecastNavMeshResource> ezRecastNavMeshResourceHandle;
 
+/// \brief The state of a path query, see ezRecastWorldModule::RequestPath().
+struct EZ_RECASTPLUGIN_DLL ezRecastPathQueryState
+{
+  typedef ezUInt8 StorageType;
+
+  enum Enum
+  {
+    Pending,             ///< The query is queued or still being processed.
+    StartOutsideNavMesh, ///< The start position is not on the navmesh.
+    InvalidTarget,       ///< The target position is not on the navmesh.
+    NoPath,              ///< There is no path from the start to the target.
+    PartialPath,         ///< The path only leads close to the target.
+    FullPath,            ///< The path leads to the target.
+
+    Default = Pending
+  };
+};
+
+struct EZ_RECASTPLUGIN_DLL ezRecastPathQueryResult
+{
+  ezEnum<ezRecastPathQueryState> m_State;
+  dtPolyRef m_StartPoly = 0;
+  dtPolyRef m_EndPoly = 0;
+  ezVec3 m_vStartPositionOnNavMesh;
+  ezDynamicArray<dtPolyRef> m_PathCorridor;
+};
+
 class EZ_RECASTPLUGIN_DLL ezRecastWorldModule : public ezWorldModule
 {
   EZ_DECLARE_WORLD_MODULE();
@@ -28,14 +62,75 @@ public:
   const ezRecastNavMeshResourceHandle& GetNavMeshResource() { return m_hNavMesh; }
 
   const dtNavMesh* GetDetourNavMesh() const { return m_pDetourNavMesh; }
+
+  /// \brief Increases whenever the navmesh gets replaced or modified.
+  ///
+  /// Polygon references that were retrieved before, e.g. path corridors, may point to polygons that don't exist anymore.
+  ezUInt32 GetNavMeshChangeCounter() const { return m_uiNavMeshChangeCounter; }
+
+  /// \brief Hot-swaps tiles of the current navmesh, see ezRecastNavMeshResource::ReplaceTiles().
+  ///
+  /// Running path searches are restarted right away. Must not be called during the async phase of the world update.
+  ezResult ReplaceNavMeshTiles(ezRecastNavMeshResourceDescriptor&& descriptor, ezArrayPtr<const ezVec2I32> changedTiles);
   const ezNavMeshPointOfInterestGraph* GetNavMeshPointsOfInterestGraph() const { return m_pNavMeshPointsOfInterest.Borrow(); }
   ezNavMeshPointOfInterestGraph* AccessNavMeshPointsOfInterestGraph() const { return m_pNavMeshPointsOfInterest.Borrow(); }
 
+  /// \brief Finds the navmesh polygon at \a vPosition. Fails if there is none within the given distances.
+  static ezResult FindNavMeshPolyAt(const dtNavMeshQuery& query, const dtQueryFilter& filter, const ezVec3& vPosition, dtPolyRef& out_PolyRef,
+    ezVec3* out_vAdjustedPosition = nullptr, float fPlaneEpsilon = 0.01f, float fHeightEpsilon = 1.0f);
+
+  /// \brief Queues a path search from \a vStart to \a vTarget. Returns an ID with which to retrieve the result.
+  ///
+  /// The queries are processed in the async phase of the world update by a pool of navmesh queries. Long searches are spread over
+  /// several frames, such that many agents that need a new path at the same time don't cause a hitch.
+  /// See the CVars 'ai_PathQueryIterationsPerFrame' and 'ai_MaxPathQueriesInFlight'. The size of the searches is limited by
+  /// 'ai_PathQueryMaxSearchNodes' and 'ai_MaxPathCorridorLength'.
+  ezUInt32 RequestPath(const ezVec3& vStart, const ezVec3& vTarget);
+
+  /// \brief Discards a query, whether it is finished or not.
+  void CancelPathQuery(ezUInt32 uiQueryID);
+
+  /// \brief Returns the state of a query. Once it is not pending anymore, the result is moved into \a out_Result and the ID becomes invalid.
+  ezRecastPathQueryState::Enum RetrievePathQueryResult(ezUInt32 uiQueryID, ezRecastPathQueryResult& out_Result);
+
 private:
+  struct PathQuery
+  {
+    ezUInt32 m_uiQueryID = 0;
+    ezVec3 m_vStart;
+    ezVec3 m_vTarget;
+  };
+
+  struct PathQuerySlot
+  {
+    ezUniquePtr<dtNavMeshQuery> m_pQuery; // careful, dtNavMeshQuery is not moveble
+    PathQuery m_Query;                     // a query ID of 0 means the slot is free
+    bool m_bSearchStarted = false;
+    ezRecastPathQueryResult m_Result;
+  };
+
   void UpdateNavMesh(const UpdateContext& ctxt);
+  void UpdatePathQueries(const UpdateContext& ctxt);
+  void ProcessPathQuerySlot(PathQuerySlot& slot, ezInt32 iMaxIterations);
+  void StartPathSearch(PathQuerySlot& slot) const;
+  void FinalizePathSearch(PathQuerySlot& slot) const;
+  void ResetPathQuerySlots();
   void ResourceEventHandler(const ezResourceEvent& e);
 
   const dtNavMesh* m_pDetourNavMesh = nullptr;
+  ezUInt32 m_uiNavMeshChangeCounter = 0;
+  ezUInt32 m_uiNavMeshResourceChangeCounter = 0;
   ezRecastNavMeshResourceHandle m_hNavMesh;
   ezUniquePtr<ezNavMeshPointOfInterestGraph> m_pNavMeshPointsOfInterest;
+
+  // the queues are accessed from the path query tasks, everything else only in the update
+  ezMutex m_PathQueryMutex;
+  ezUInt32 m_uiNextPathQueryID = 1;
+  ezUInt32 m_uiNumUnfinishedPathQueries = 0;
+  ezDeque<PathQuery> m_PendingPathQueries;
+  ezHashSet<ezUInt32> m_CancelledPathQueries;
+  ezHashTable<ezUInt32, ezRecastPathQueryResult> m_FinishedPathQueries;
+  ezDynamicArray<PathQuerySlot> m_PathQuerySlots;
+  ezAtomicBool m_bResetPathQuerySlots;
+  dtQueryFilter m_PathQueryFilter; /// \todo hard-coded filter
 };
@@ -3,7 +3,6 @@
 #include <Core/Assets/AssetFileHeader.h>
 #include <Foundation/IO/FileSystem/DeferredFileWriter.h>
 #include <TexConv/TexConv.h>
-#include <Texture/Image/Formats/DdsFileFormat.h>
 #include <Texture/ezTexFormat/ezTexFormat.h>
 
 ezTexConv::ezTexConv()
@@ -207,13 +206,13 @@ ezResult ezTexConv::WriteTexFile(ezStreamWriter& stream, const ezImage& image)
   texFormat.m_AddressModeV = m_Processor.m_Descriptor.m_AddressModeV;
   texFormat.m_AddressModeW = m_Processor.m_Descriptor.m_AddressModeW;
   texFormat.m_TextureFilter = m_Processor.m_Descriptor.m_FilterMode;
+  texFormat.m_bStreamableMipLevels = true;
 
   texFormat.WriteTextureHeader(stream);
 
-  ezDdsFileFormat ddsWriter;
-  if (ddsWriter.WriteImage(stream, image, ezLog::GetThreadLocalLogSystem(), "dds").Failed())
+  if (ezTexFormat::WriteStreamableImage(stream, image).Failed())
   {
-    ezLog::Error("Failed to write DDS image chunk to ezTex file.");
+    ezLog::Error("Failed to write image data to ezTex file.");
     return EZ_FAILURE;
   }
 
@@ -1,7 +1,11 @@
 #include <CoreTestPCH.h>
 
 #include <Core/ResourceManager/ResourceManager.h>
+#include <Foundation/Threading/Thread.h>
+#include <Foundation/Threading/ThreadSignal.h>
+#include <Foundation/Time/Stopwatch.h>
 #include <Foundation/Types/ScopeExit.h>
+#include <Foundation/Types/UniquePtr.h>
 
 EZ_CREATE_SIMPLE_TEST_GROUP(ResourceManager);
 
@@ -125,10 +129,103 @@ namespace
     }
   };
 
+  /// Blocks loading of the 'Gate' resource until the signal is raised and records in which order all other resources are loaded.
+  class OrderRecordingTypeLoader : public TestResourceTypeLoader
+  {
+  public:
+    virtual ezResourceLoadData OpenDataStream(const ezResource* pResource) override
+    {
+      if (pResource->GetResourceID() == "Gate")
+      {
+        m_GateStarted.RaiseSignal();
+        m_OpenGate.WaitForSignal();
+      }
+      else
+      {
+        EZ_LOCK(m_Mutex);
+        m_LoadOrder.PushBack(pResource->GetResourceID());
+      }
+
+      return TestResourceTypeLoader::OpenDataStream(pResource);
+    }
+
+    ezThreadSignal m_GateStarted;
+    ezThreadSignal m_OpenGate;
+    ezMutex m_Mutex;
+    ezDynamicArray<ezString> m_LoadOrder;
+  };
+
   EZ_RESOURCE_IMPLEMENT_COMMON_CODE(TestResource);
   EZ_BEGIN_DYNAMIC_REFLECTED_TYPE(TestResource, 1, ezRTTIDefaultAllocator<TestResource>)
   EZ_END_DYNAMIC_REFLECTED_TYPE;
 
+  class DerivedTestResource : public TestResource
+  {
+    EZ_ADD_DYNAMIC_REFLECTION(DerivedTestResource, TestResource);
+    EZ_RESOURCE_DECLARE_COMMON_CODE(DerivedTestResource);
+  };
+
+  EZ_RESOURCE_IMPLEMENT_COMMON_CODE(DerivedTestResource);
+  EZ_BEGIN_DYNAMIC_REFLECTED_TYPE(DerivedTestResource, 1, ezRTTIDefaultAllocator<DerivedTestResource>)
+  EZ_END_DYNAMIC_REFLECTED_TYPE;
+
+  class AcquireTestThread : public ezThread
+  {
+  public:
+    AcquireTestThread(const ezDynamicArray<ezString>& resourceIDs, const ezDynamicArray<TestResourceHandle>& hResources, ezUInt32 uiIterations, ezUInt32 uiSeed)
+      : ezThread("Acquire Test Thread")
+      , m_ResourceIDs(resourceIDs)
+      , m_hResources(hResources)
+      , m_uiIterations(uiIterations)
+      , m_uiSeed(uiSeed)
+    {
+    }
+
+    virtual ezUInt32 Run() override
+    {
+      for (ezUInt32 i = 0; i < m_uiIterations; ++i)
+      {
+        const ezUInt32 uiResource = (i * 7 + m_uiSeed) % m_ResourceIDs.GetCount();
+        const ezString& sResourceID = m_ResourceIDs[uiResource];
+
+        // every iteration looks up the resource by name and acquires it, like most components do when they are initialized
+        TestResourceHandle hResource = (i % 4 == 0) ? ezResourceManager::GetExistingResource<TestResource>(sResourceID)
+                                                    : ezResourceManager::LoadResource<TestResource>(sResourceID);
+
+        if (!hResource.IsValid())
+        {
+          m_uiNumFailed.Increment();
+          continue;
+        }
+
+        // the lookup must return the already existing resource, not create a new one
+        if (hResource != m_hResources[uiResource])
+          m_uiNumWrongResources.Increment();
+
+        ezResourceLock<TestResource> pTestResource(hResource, ezResourceAcquireMode::BlockTillLoaded);
+
+        if (pTestResource.GetAcquireResult() != ezResourceAcquireResult::Final)
+        {
+          m_uiNumFailed.Increment();
+          continue;
+        }
+
+        if (sResourceID != pTestResource->GetResourceID() || pTestResource->GetLoadingState() != ezResourceState::Loaded)
+          m_uiNumWrongResources.Increment();
+      }
+
+      return 0;
+    }
+
+    ezAtomicInteger32 m_uiNumFailed;
+    ezAtomicInteger32 m_uiNumWrongResources;
+
+  private:
+    const ezDynamicArray<ezString>& m_ResourceIDs;
+    const ezDynamicArray<TestResourceHandle>& m_hResources;
+    ezUInt32 m_uiIterations;
+    ezUInt32 m_uiSeed;
+  };
 } // namespace
 
 EZ_CREATE_SIMPLE_TEST(ResourceManager, Basics)
@@ -289,3 +386,251 @@ EZ_CREATE_SIMPLE_TEST(ResourceManager, NestedLoading)
     EZ_TEST_INT(ezResourceManager::GetAllResourcesOfType<TestResource>()->GetCount(), 0);
   }
 }
+
+EZ_CREATE_SIMPLE_TEST(ResourceManager, ConcurrentAcquire)
+{
+  TestResourceTypeLoader TypeLoader;
+  ezResourceManager::SetResourceTypeLoader<TestResource>(&TypeLoader);
+  EZ_SCOPE_EXIT(ezResourceManager::SetResourceTypeLoader<TestResource>(nullptr));
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Contention")
+  {
+    EZ_TEST_INT(ezResourceManager::GetAllResourcesOfType<TestResource>()->GetCount(), 0);
+
+    const ezUInt32 uiNumResources = 64;
+    const ezUInt32 uiNumThreads = 8;
+#if EZ_ENABLED(EZ_COMPILE_FOR_DEBUG)
+    const ezUInt32 uiIterations = 5000;
+#else
+    const ezUInt32 uiIterations = 100000;
+#endif
+
+    ezDynamicArray<ezString> resourceIDs;
+    ezDynamicArray<TestResourceHandle> hResources;
+
+    ezStringBuilder sResourceID;
+    for (ezUInt32 i = 0; i < uiNumResources; ++i)
+    {
+      sResourceID.Format("Shared-{}", i);
+      resourceIDs.PushBack(sResourceID);
+      hResources.PushBack(ezResourceManager::LoadResource<TestResource>(sResourceID));
+    }
+
+    for (ezUInt32 i = 0; i < uiNumResources; ++i)
+    {
+      ezResourceManager::ForceLoadResourceNow(hResources[i]);
+      EZ_TEST_BOOL(ezResourceManager::GetLoadingState(hResources[i]) == ezResourceState::Loaded);
+    }
+
+    ezHybridArray<ezUniquePtr<AcquireTestThread>, uiNumThreads> threads;
+    for (ezUInt32 i = 0; i < uiNumThreads; ++i)
+    {
+      threads.PushBack(EZ_DEFAULT_NEW(AcquireTestThread, resourceIDs, hResources, uiIterations, i * 13));
+    }
+
+    ezStopwatch sw;
+
+    for (auto& pThread : threads)
+    {
+      pThread->Start();
+    }
+
+    ezUInt32 uiNumFailed = 0;
+    ezUInt32 uiNumWrongResources = 0;
+    for (auto& pThread : threads)
+    {
+      pThread->Join();
+      uiNumFailed += pThread->m_uiNumFailed;
+      uiNumWrongResources += pThread->m_uiNumWrongResources;
+    }
+
+    ezTestFramework::Output(ezTestOutput::Duration, "%u threads, %u resource lookups and acquisitions each: %.2fms", uiNumThreads, uiIterations,
+      sw.GetRunningTotal().GetMilliseconds());
+
+    EZ_TEST_INT(uiNumFailed, 0);
+    EZ_TEST_INT(uiNumWrongResources, 0);
+
+    // no additional resources may have been created by the concurrent lookups
+    EZ_TEST_INT(ezResourceManager::GetAllResourcesOfType<TestResource>()->GetCount(), uiNumResources);
+
+    threads.Clear();
+    hResources.Clear();
+
+    while (ezResourceManager::IsAnyLoadingInProgress())
+    {
+      ezThreadUtils::Sleep(ezTime::Milliseconds(10));
+    }
+
+    ezResourceManager::FreeAllUnusedResources();
+    EZ_TEST_INT(ezResourceManager::GetAllResourcesOfType<TestResource>()->GetCount(), 0);
+  }
+}
+
+EZ_CREATE_SIMPLE_TEST(ResourceManager, LoadingQueueOrder)
+{
+  OrderRecordingTypeLoader TypeLoader;
+  ezResourceManager::SetResourceTypeLoader<TestResource>(&TypeLoader);
+  EZ_SCOPE_EXIT(ezResourceManager::SetResourceTypeLoader<TestResource>(nullptr));
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Priorities")
+  {
+    EZ_TEST_INT(ezResourceManager::GetAllResourcesOfType<TestResource>()->GetCount(), 0);
+
+    // occupy the data loading task, so that all following resources end up in the queue at the same time
+    TestResourceHandle hGate = ezResourceManager::LoadResource<TestResource>("Gate");
+    ezResourceManager::PreloadResource(hGate);
+    TypeLoader.m_GateStarted.WaitForSignal();
+
+    const char* szResourceIDs[] = {"VeryLow", "High", "Low", "VeryHigh", "Medium"};
+    const ezResourcePriority priorities[] = {ezResourcePriority::VeryLow, ezResourcePriority::High, ezResourcePriority::Low,
+      ezResourcePriority::VeryHigh, ezResourcePriority::Medium};
+
+    ezDynamicArray<TestResourceHandle> hResources;
+    for (ezUInt32 i = 0; i < EZ_ARRAY_SIZE(szResourceIDs); ++i)
+    {
+      TestResourceHandle hResource = ezResourceManager::LoadResource<TestResource>(szResourceIDs[i]);
+
+      {
+        ezResourceLock<TestResource> pResource(hResource, ezResourceAcquireMode::PointerOnly);
+        pResource->SetPriority(priorities[i]);
+      }
+
+      ezResourceManager::PreloadResource(hResource);
+      hResources.PushBack(hResource);
+    }
+
+    TypeLoader.m_OpenGate.RaiseSignal();
+
+    // don't block on the resources, that would move them to the front of the queue
+    while (ezResourceManager::IsAnyLoadingInProgress())
+    {
+      ezThreadUtils::Sleep(ezTime::Milliseconds(10));
+    }
+
+    const char* szExpectedOrder[] = {"VeryHigh", "High", "Medium", "Low", "VeryLow"};
+
+    EZ_TEST_INT(TypeLoader.m_LoadOrder.GetCount(), EZ_ARRAY_SIZE(szExpectedOrder));
+    for (ezUInt32 i = 0; i < ezMath::Min<ezUInt32>(TypeLoader.m_LoadOrder.GetCount(), EZ_ARRAY_SIZE(szExpectedOrder)); ++i)
+    {
+      EZ_TEST_STRING(TypeLoader.m_LoadOrder[i], szExpectedOrder[i]);
+    }
+
+    hGate.Invalidate();
+    hResources.Clear();
+
+    ezResourceManager::FreeAllUnusedResources();
+    EZ_TEST_INT(ezResourceManager::GetAllResourcesOfType<TestResource>()->GetCount(), 0);
+  }
+}
+
+EZ_CREATE_SIMPLE_TEST(ResourceManager, MemoryBudget)
+{
+  TestResourceTypeLoader TypeLoader;
+  ezResourceManager::SetResourceTypeLoader<TestResource>(&TypeLoader);
+  EZ_SCOPE_EXIT(ezResourceManager::SetResourceTypeLoader<TestResource>(nullptr));
+  EZ_SCOPE_EXIT(ezResourceManager::SetResourceTypeMemoryBudget<TestResource>(0, 0));
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Evict Unused")
+  {
+    EZ_TEST_INT(ezResourceManager::GetAllResourcesOfType<TestResource>()->GetCount(), 0);
+
+    const ezUInt32 uiNumResources = 20;
+    const ezUInt32 uiNumReferenced = 5;
+    const ezUInt32 uiNumInBudget = 10;
+
+    ezDynamicArray<TestResourceHandle> hResources;
+
+    ezStringBuilder sResourceID;
+    for (ezUInt32 i = 0; i < uiNumResources; ++i)
+    {
+      sResourceID.Format("Budget-{}", i);
+      TestResourceHandle hResource = ezResourceManager::LoadResource<TestResource>(sResourceID);
+
+      ezResourceLock<TestResource> pTestResource(hResource, ezResourceAcquireMode::BlockTillLoaded_NeverFail);
+      EZ_TEST_BOOL(pTestResource.GetAcquireResult() == ezResourceAcquireResult::Final);
+
+      if (i < uiNumReferenced)
+      {
+        hResources.PushBack(hResource);
+      }
+    }
+
+    ezUInt64 uiMemoryCPU = 0;
+    ezUInt64 uiMemoryGPU = 0;
+    ezResourceManager::GetResourceTypeMemoryUsage(ezGetStaticRTTI<TestResource>(), uiMemoryCPU, uiMemoryGPU);
+    EZ_TEST_INT(uiMemoryCPU, uiNumResources * sizeof(TestResource));
+    EZ_TEST_INT(uiMemoryGPU, 0);
+
+    // without a budget nothing happens
+    EZ_TEST_INT(ezResourceManager::EnforceMemoryBudgets(), 0);
+    EZ_TEST_INT(ezResourceManager::GetAllResourcesOfType<TestResource>()->GetCount(), uiNumResources);
+
+    ezResourceManager::SetResourceTypeMemoryBudget<TestResource>(uiNumInBudget * sizeof(TestResource), 0);
+
+    EZ_TEST_INT(ezResourceManager::EnforceMemoryBudgets(), uiNumResources - uiNumInBudget);
+    EZ_TEST_INT(ezResourceManager::GetAllResourcesOfType<TestResource>()->GetCount(), uiNumInBudget);
+
+    ezResourceManager::GetResourceTypeMemoryUsage(ezGetStaticRTTI<TestResource>(), uiMemoryCPU, uiMemoryGPU);
+    EZ_TEST_INT(uiMemoryCPU, uiNumInBudget * sizeof(TestResource));
+
+    // referenced resources are never evicted
+    for (const TestResourceHandle& hResource : hResources)
+    {
+      EZ_TEST_BOOL(ezResourceManager::GetLoadingState(hResource) == ezResourceState::Loaded);
+    }
+
+    // within budget, nothing else gets evicted
+    EZ_TEST_INT(ezResourceManager::EnforceMemoryBudgets(), 0);
+
+    hResources.Clear();
+
+    ezResourceManager::FreeAllUnusedResources();
+    EZ_TEST_INT(ezResourceManager::GetAllResourcesOfType<TestResource>()->GetCount(), 0);
+
+    // the usage is tracked incrementally, deallocated resources must not leave anything behind
+    ezResourceManager::GetResourceTypeMemoryUsage(ezGetStaticRTTI<TestResource>(), uiMemoryCPU, uiMemoryGPU);
+    EZ_TEST_INT(uiMemoryCPU, 0);
+    EZ_TEST_INT(uiMemoryGPU, 0);
+  }
+}
+
+EZ_CREATE_SIMPLE_TEST(ResourceManager, TypeOverride)
+{
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Register / Unregister")
+  {
+    ezUInt32 uiNumDeciderCalls = 0;
+
+    ezResourceManager::RegisterResourceOverrideType(ezGetStaticRTTI<DerivedTestResource>(), [&](const ezStringBuilder& sResourceID) {
+      ++uiNumDeciderCalls;
+
+      // the decider runs without any resource manager lock held, so it may look up other resources
+      ezResourceManager::GetExistingResource<DerivedTestResource>("Override-Other");
+
+      return sResourceID.EndsWith(".derived");
+    });
+
+    TestResourceHandle hDerived = ezResourceManager::LoadResource<TestResource>("Override-0.derived");
+    TestResourceHandle hBase = ezResourceManager::LoadResource<TestResource>("Override-0.base");
+
+    EZ_TEST_BOOL(uiNumDeciderCalls > 0);
+    EZ_TEST_BOOL(ezResourceManager::GetExistingResource<DerivedTestResource>("Override-0.derived").IsValid());
+    EZ_TEST_BOOL(!ezResourceManager::GetExistingResource<DerivedTestResource>("Override-0.base").IsValid());
+    EZ_TEST_BOOL(hBase == ezResourceManager::GetExistingResource<TestResource>("Override-0.base"));
+
+    ezResourceManager::UnregisterResourceOverrideType(ezGetStaticRTTI<DerivedTestResource>());
+
+    uiNumDeciderCalls = 0;
+    TestResourceHandle hNotDerived = ezResourceManager::LoadResource<TestResource>("Override-1.derived");
+
+    EZ_TEST_INT(uiNumDeciderCalls, 0);
+    EZ_TEST_BOOL(!ezResourceManager::GetExistingResource<DerivedTestResource>("Override-1.derived").IsValid());
+
+    hDerived.Invalidate();
+    hBase.Invalidate();
+    hNotDerived.Invalidate();
+
+    ezResourceManager::FreeAllUnusedResources();
+    EZ_TEST_INT(ezResourceManager::GetAllResourcesOfType<TestResource>()->GetCount(), 0);
+    EZ_TEST_INT(ezResourceManager::GetAllResourcesOfType<DerivedTestResource>()->GetCount(), 0);
+  }
+}
@@ -2,6 +2,7 @@
 
 #include <Core/World/World.h>
 #include <Foundation/Time/Clock.h>
+#include <Foundation/Utilities/Stats.h>
 
 namespace
 {
@@ -152,8 +153,69 @@ namespace
       TestComponent2::CreateComponent(pChild, pChildComponent);
     }
   }
+
+  class AutoGranularityTestComponent;
+  class AutoGranularityTestComponentManager : public ezComponentManager<AutoGranularityTestComponent, ezBlockStorageType::Compact>
+  {
+  public:
+    AutoGranularityTestComponentManager(ezWorld* pWorld)
+      : ezComponentManager<AutoGranularityTestComponent, ezBlockStorageType::Compact>(pWorld)
+    {
+    }
+
+    virtual void Initialize() override
+    {
+      auto desc = EZ_CREATE_MODULE_UPDATE_FUNCTION_DESC(AutoGranularityTestComponentManager::UpdateAsync, this);
+      desc.m_Phase = ezComponentManagerBase::UpdateFunctionDesc::Phase::Async;
+      desc.m_bAutoGranularity = true;
+
+      this->RegisterUpdateFunction(desc);
+    }
+
+    void UpdateAsync(const ezWorldModule::UpdateContext& context);
+
+    ezAtomicInteger32 m_iNumBatches;
+  };
+
+  class AutoGranularityTestComponent : public ezComponent
+  {
+    EZ_DECLARE_COMPONENT_TYPE(AutoGranularityTestComponent, ezComponent, AutoGranularityTestComponentManager);
+
+  public:
+    ezUInt32 m_uiNumUpdates = 0;
+  };
+
+  EZ_BEGIN_COMPONENT_TYPE(AutoGranularityTestComponent, 1, ezComponentMode::Static)
+  EZ_END_COMPONENT_TYPE
+
+  void AutoGranularityTestComponentManager::UpdateAsync(const ezWorldModule::UpdateContext& context)
+  {
+    m_iNumBatches.Increment();
+
+    for (auto it = this->m_ComponentStorage.GetIterator(context.m_uiFirstComponentIndex, context.m_uiComponentCount); it.IsValid(); ++it)
+    {
+      ++it->m_uiNumUpdates;
+
+      // a bit of busy work, so that the measured cost is not zero
+      ezTime::Now();
+    }
+  }
 } // namespace
 
+class ezWorldDataTest
+{
+public:
+  static ezUInt32 ComputeGranularity(ezUInt32 uiTotalCount, ezUInt32 uiNumWorkers, bool bAutoGranularity, ezUInt16 uiGranularity, ezTime avgTimePerComponent)
+  {
+    ezInternal::WorldData::RegisteredUpdateFunction updateFunction;
+    updateFunction.m_bAutoGranularity = bAutoGranularity;
+    updateFunction.m_uiGranularity = uiGranularity;
+    updateFunction.m_AvgTimePerComponent = avgTimePerComponent;
+
+    return updateFunction.ComputeGranularity(uiTotalCount, uiNumWorkers);
+  }
+};
+
 
 EZ_CREATE_SIMPLE_TEST(World, Components)
 {
@@ -522,3 +584,118 @@ EZ_CREATE_SIMPLE_TEST(World, Components)
     EZ_TEST_INT(TestComponent::s_iSimulationStartedCounter, 1);
   }
 }
+
+EZ_CREATE_SIMPLE_TEST(World, ComputeGranularity)
+{
+  // the measured costs are chosen such that the total time is never an exact multiple of the minimum batch duration of 100us
+  const ezTime noMeasurement;
+  const ezTime cheap = ezTime::Nanoseconds(1250);
+  const ezTime expensive = ezTime::Nanoseconds(12500);
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Fixed Granularity")
+  {
+    EZ_TEST_INT(ezWorldDataTest::ComputeGranularity(1000, 4, false, 0, cheap), 1000);
+    EZ_TEST_INT(ezWorldDataTest::ComputeGranularity(1000, 4, false, 64, cheap), 64);
+    EZ_TEST_INT(ezWorldDataTest::ComputeGranularity(10, 4, false, 64, noMeasurement), 64);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Without Measurements")
+  {
+    // one batch per worker
+    EZ_TEST_INT(ezWorldDataTest::ComputeGranularity(1000, 4, true, 0, noMeasurement), 250);
+    EZ_TEST_INT(ezWorldDataTest::ComputeGranularity(1001, 4, true, 0, noMeasurement), 251);
+    EZ_TEST_INT(ezWorldDataTest::ComputeGranularity(1000, 1, true, 0, noMeasurement), 1000);
+    EZ_TEST_INT(ezWorldDataTest::ComputeGranularity(0, 4, true, 0, noMeasurement), 1);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "With Measurements")
+  {
+    // 1.25ms in total, 13 batches of at least 100us
+    EZ_TEST_INT(ezWorldDataTest::ComputeGranularity(1000, 4, true, 0, cheap), 77);
+
+    // 62.5us in total is not worth splitting up
+    EZ_TEST_INT(ezWorldDataTest::ComputeGranularity(50, 4, true, 0, cheap), 50);
+
+    // not more than 4 batches per worker
+    EZ_TEST_INT(ezWorldDataTest::ComputeGranularity(1000, 2, true, 0, cheap), 125);
+    EZ_TEST_INT(ezWorldDataTest::ComputeGranularity(100000, 4, true, 0, cheap), 6250);
+    EZ_TEST_INT(ezWorldDataTest::ComputeGranularity(1000, 1, true, 0, expensive), 250);
+    EZ_TEST_INT(ezWorldDataTest::ComputeGranularity(1000, 8, true, 0, expensive), 32);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Minimum Granularity")
+  {
+    // the granularity is then a multiple of the minimum
+    EZ_TEST_INT(ezWorldDataTest::ComputeGranularity(1000, 4, true, 64, cheap), 128);
+    EZ_TEST_INT(ezWorldDataTest::ComputeGranularity(1000, 4, true, 64, noMeasurement), 256);
+    EZ_TEST_INT(ezWorldDataTest::ComputeGranularity(10, 4, true, 64, cheap), 64);
+    EZ_TEST_INT(ezWorldDataTest::ComputeGranularity(100000, 4, true, 100, cheap), 6300);
+  }
+}
+
+EZ_CREATE_SIMPLE_TEST(World, AutoGranularity)
+{
+  // a fixed number of workers, such that the number of batches is known
+  const ezUInt32 uiPrevShortWorkers = ezTaskSystem::GetWorkerThreadCount(ezWorkerThreadType::ShortTasks);
+  const ezUInt32 uiPrevLongWorkers = ezTaskSystem::GetWorkerThreadCount(ezWorkerThreadType::LongTasks);
+  ezTaskSystem::SetWorkerThreadCount(2, 2);
+
+  ezWorldDesc worldDesc("AutoGranularity");
+  worldDesc.m_bAutoCreateSpatialSystem = false; // allows multi-threaded update
+  ezWorld world(worldDesc);
+  EZ_LOCK(world.GetWriteMarker());
+
+  AutoGranularityTestComponentManager* pManager = world.GetOrCreateComponentManager<AutoGranularityTestComponentManager>();
+
+  for (ezUInt32 i = 0; i < 10000; ++i)
+  {
+    ezGameObjectDesc desc;
+    ezGameObject* pObject = nullptr;
+    world.CreateObject(desc, pObject);
+
+    AutoGranularityTestComponent* pComponent = nullptr;
+    pManager->CreateComponent(pObject, pComponent);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Every component is updated exactly once per frame")
+  {
+    const ezUInt32 uiNumFrames = 10;
+
+    for (ezUInt32 frame = 0; frame < uiNumFrames; ++frame)
+    {
+      pManager->m_iNumBatches = 0;
+
+      world.Update();
+
+      if (frame == 0)
+      {
+        // nothing is measured yet, every worker gets one batch
+        EZ_TEST_INT(pManager->m_iNumBatches, 2);
+      }
+      else
+      {
+        // automatic granularity never creates more than 4 batches per worker thread
+        EZ_TEST_BOOL(pManager->m_iNumBatches >= 1);
+        EZ_TEST_BOOL(pManager->m_iNumBatches <= 8);
+      }
+    }
+
+    ezUInt32 uiNumComponents = 0;
+    for (auto it = pManager->GetComponents(); it.IsValid(); ++it)
+    {
+      EZ_TEST_INT(it->m_uiNumUpdates, uiNumFrames);
+      ++uiNumComponents;
+    }
+
+    EZ_TEST_INT(uiNumComponents, 10000);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Statistics")
+  {
+    const ezVariant& stat = ezStats::GetStat("World Update/AutoGranularity/Async/AutoGranularityTestComponentManager::UpdateAsync");
+    EZ_TEST_BOOL(stat.IsValid());
+    EZ_TEST_BOOL(stat.ConvertTo<ezString>().FindSubString("10000 components") != nullptr);
+  }
+
+  ezTaskSystem::SetWorkerThreadCount(static_cast<ezInt8>(uiPrevShortWorkers), static_cast<ezInt8>(uiPrevLongWorkers));
+}
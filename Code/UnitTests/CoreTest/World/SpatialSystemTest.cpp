@@ -1,6 +1,8 @@
 #include <CoreTestPCH.h>
 
 #include <Core/Messages/UpdateLocalBoundsMessage.h>
+#include <Core/World/SpatialSystem_LooseOctree.h>
+#include <Core/World/SpatialSystem_RegularGrid.h>
 #include <Core/World/World.h>
 #include <Foundation/Containers/HashSet.h>
 #include <Foundation/IO/FileSystem/DataDirTypeFolder.h>
@@ -55,6 +57,199 @@ namespace
   }
   EZ_END_COMPONENT_TYPE;
   // clang-format on
+
+  struct TestSpatialObject
+  {
+    ezSimdBBoxSphere m_Bounds;
+    ezUInt32 m_uiCategoryBitmask = 0;
+    ezSpatialDataHandle m_hData;
+  };
+
+  // The spatial systems never dereference the object pointers, so the test objects themselves are used to identify the results.
+  EZ_ALWAYS_INLINE ezGameObject* GetFakeObject(TestSpatialObject& object) { return reinterpret_cast<ezGameObject*>(&object); }
+
+  void RandomizeSpatialObject(ezRandom& rng, TestSpatialObject& object, ezUInt32 uiIndex)
+  {
+    // mix many small objects with a few huge ones, some of them lie outside of the octree's bounds
+    const bool bHuge = (uiIndex % 50) == 0;
+    const double fRange = bHuge ? 12000.0 : 5000.0;
+    const double fMaxSize = bHuge ? 4000.0 : 10.0;
+
+    ezSimdVec4f center((float)rng.DoubleMinMax(-fRange, fRange), (float)rng.DoubleMinMax(-fRange, fRange), (float)rng.DoubleMinMax(-fRange, fRange));
+    ezSimdVec4f halfExtents((float)rng.DoubleMinMax(0.1, fMaxSize), (float)rng.DoubleMinMax(0.1, fMaxSize), (float)rng.DoubleMinMax(0.1, fMaxSize));
+
+    ezSimdBBox box;
+    box.SetCenterAndHalfExtents(center, halfExtents);
+
+    object.m_Bounds = ezSimdBBoxSphere(box);
+    object.m_uiCategoryBitmask = ((uiIndex & 1) ? ezDefaultSpatialDataCategories::RenderStatic : ezDefaultSpatialDataCategories::RenderDynamic).GetBitmask();
+  }
+
+  template <typename Filter>
+  void CheckQueryResult(const ezDynamicArray<TestSpatialObject>& objects, const ezDynamicArray<ezGameObject*>& result, ezUInt32 uiCategoryBitmask,
+    Filter filter)
+  {
+    ezHashSet<ezGameObject*> uniqueObjects;
+    for (auto pObject : result)
+    {
+      EZ_TEST_BOOL(!uniqueObjects.Insert(pObject));
+    }
+
+    ezUInt32 uiNumExpected = 0;
+    for (const TestSpatialObject& object : objects)
+    {
+      if (object.m_hData.IsInvalidated() || (object.m_uiCategoryBitmask & uiCategoryBitmask) == 0 || !filter(object))
+        continue;
+
+      ++uiNumExpected;
+      EZ_TEST_BOOL(uniqueObjects.Contains(reinterpret_cast<ezGameObject*>(const_cast<TestSpatialObject*>(&object))));
+    }
+
+    EZ_TEST_INT(result.GetCount(), uiNumExpected);
+  }
+
+  void CheckSpatialQueries(const ezSpatialSystem& spatialSystem, const ezDynamicArray<TestSpatialObject>& objects)
+  {
+    const ezUInt32 uiCategoryBitmask = ezDefaultSpatialDataCategories::RenderStatic.GetBitmask();
+
+    ezDynamicArray<ezGameObject*> result;
+
+    {
+      const ezBoundingSphere testSphere(ezVec3(100.0f, 60.0f, 400.0f), 3000.0f);
+      const ezSimdBSphere simdSphere(ezSimdConversion::ToVec3(testSphere.m_vCenter), testSphere.m_fRadius);
+
+      spatialSystem.FindObjectsInSphere(testSphere, uiCategoryBitmask, result);
+      CheckQueryResult(objects, result, uiCategoryBitmask, [&](const TestSpatialObject& object) { return simdSphere.Overlaps(object.m_Bounds.GetSphere()); });
+    }
+
+    {
+      ezBoundingBox testBox;
+      testBox.SetCenterAndHalfExtents(ezVec3(-2000.0f, 500.0f, 1000.0f), ezVec3(2500.0f, 1000.0f, 4000.0f));
+      const ezSimdBBox simdBox(ezSimdConversion::ToVec3(testBox.m_vMin), ezSimdConversion::ToVec3(testBox.m_vMax));
+
+      result.Clear();
+      spatialSystem.FindObjectsInBox(testBox, uiCategoryBitmask, result);
+      CheckQueryResult(objects, result, uiCategoryBitmask, [&](const TestSpatialObject& object) {
+        return simdBox.Overlaps(object.m_Bounds.GetSphere()) && simdBox.Overlaps(object.m_Bounds.GetBox());
+      });
+    }
+
+    {
+      ezFrustum frustum;
+      frustum.SetFrustum(ezVec3(-100.0f, 200.0f, 0.0f), ezVec3(1.0f, 0.2f, 0.1f).GetNormalized(), ezVec3(0.0f, 0.0f, 1.0f), ezAngle::Degree(90.0f),
+        ezAngle::Degree(60.0f), 1.0f, 6000.0f);
+
+      ezDynamicArray<const ezGameObject*> visibleObjects;
+      spatialSystem.FindVisibleObjects(frustum, uiCategoryBitmask, visibleObjects);
+
+      result.Clear();
+      for (auto pObject : visibleObjects)
+      {
+        result.PushBack(const_cast<ezGameObject*>(pObject));
+      }
+
+      CheckQueryResult(objects, result, uiCategoryBitmask, [&](const TestSpatialObject& object) { return frustum.Overlaps(object.m_Bounds.GetSphere()); });
+    }
+  }
+
+  void CheckBatchedVisibilityQuery(const ezSpatialSystem& spatialSystem, const ezDynamicArray<TestSpatialObject>& objects)
+  {
+    const ezUInt32 uiCategoryBitmask = ezDefaultSpatialDataCategories::RenderStatic.GetBitmask();
+
+    // more frustums than fit into a single batch, spread over the whole world like shadow casting lights
+    const ezUInt32 uiNumFrustums = 40;
+
+    ezDynamicArray<ezFrustum> frustums;
+    ezDynamicArray<ezDynamicArray<const ezGameObject*>> visibleObjects;
+    ezDynamicArray<ezDynamicArray<const ezGameObject*>*> visibleObjectsPtrs;
+    frustums.SetCount(uiNumFrustums);
+    visibleObjects.SetCount(uiNumFrustums);
+
+    for (ezUInt32 i = 0; i < uiNumFrustums; ++i)
+    {
+      const ezAngle rotation = ezAngle::Degree(i * 47.0f);
+      const ezVec3 vPosition((i % 5) * 2500.0f - 5000.0f, (i / 5) * 1500.0f - 5000.0f, (i % 3) * 1000.0f - 1000.0f);
+      const ezVec3 vForward = ezVec3(ezMath::Cos(rotation), ezMath::Sin(rotation), (i % 2) ? 0.3f : -0.2f).GetNormalized();
+      const float fFarPlane = (i % 4 == 0) ? 8000.0f : 1500.0f;
+
+      frustums[i].SetFrustum(vPosition, vForward, ezVec3(0.0f, 0.0f, 1.0f), ezAngle::Degree(90.0f), ezAngle::Degree(60.0f), 1.0f, fFarPlane);
+      visibleObjectsPtrs.PushBack(&visibleObjects[i]);
+    }
+
+    spatialSystem.FindVisibleObjects(frustums, uiCategoryBitmask, visibleObjectsPtrs);
+
+    ezDynamicArray<ezGameObject*> result;
+    for (ezUInt32 i = 0; i < uiNumFrustums; ++i)
+    {
+      result.Clear();
+      for (auto pObject : visibleObjects[i])
+      {
+        result.PushBack(const_cast<ezGameObject*>(pObject));
+      }
+
+      const ezFrustum& frustum = frustums[i];
+      CheckQueryResult(objects, result, uiCategoryBitmask, [&](const TestSpatialObject& object) { return frustum.Overlaps(object.m_Bounds.GetSphere()); });
+    }
+  }
+
+  void TestSpatialSystemImplementation(ezSpatialSystem& spatialSystem)
+  {
+    ezRandom rng;
+    rng.Initialize(42);
+
+    ezDynamicArray<TestSpatialObject> objects;
+    objects.SetCount(2000);
+
+    for (ezUInt32 i = 0; i < objects.GetCount(); ++i)
+    {
+      TestSpatialObject& object = objects[i];
+      RandomizeSpatialObject(rng, object, i);
+      object.m_hData = spatialSystem.CreateSpatialData(object.m_Bounds, GetFakeObject(object), object.m_uiCategoryBitmask);
+    }
+
+    CheckSpatialQueries(spatialSystem, objects);
+    CheckBatchedVisibilityQuery(spatialSystem, objects);
+
+    // move some objects by a small amount, so they mostly stay in their node, and others to a completely new location
+    for (ezUInt32 i = 0; i < objects.GetCount(); i += 2)
+    {
+      TestSpatialObject& object = objects[i];
+      if ((i % 4) == 0)
+      {
+        object.m_Bounds.m_CenterAndRadius += ezSimdVec4f(0.5f, -0.5f, 0.25f, 0.0f);
+      }
+      else
+      {
+        RandomizeSpatialObject(rng, object, i + 1);
+      }
+
+      spatialSystem.UpdateSpatialData(object.m_hData, object.m_Bounds, GetFakeObject(object), object.m_uiCategoryBitmask);
+    }
+
+    CheckSpatialQueries(spatialSystem, objects);
+    CheckBatchedVisibilityQuery(spatialSystem, objects);
+
+    for (ezUInt32 i = 0; i < objects.GetCount(); i += 3)
+    {
+      spatialSystem.DeleteSpatialData(objects[i].m_hData);
+      objects[i].m_hData.Invalidate();
+    }
+
+    CheckSpatialQueries(spatialSystem, objects);
+    CheckBatchedVisibilityQuery(spatialSystem, objects);
+
+    for (ezUInt32 i = 0; i < objects.GetCount(); ++i)
+    {
+      if (!objects[i].m_hData.IsInvalidated())
+      {
+        spatialSystem.DeleteSpatialData(objects[i].m_hData);
+        objects[i].m_hData.Invalidate();
+      }
+    }
+
+    CheckSpatialQueries(spatialSystem, objects);
+    CheckBatchedVisibilityQuery(spatialSystem, objects);
+  }
 } // namespace
 
 EZ_CREATE_SIMPLE_TEST(World, SpatialSystem)
@@ -248,3 +443,22 @@ EZ_CREATE_SIMPLE_TEST(World, SpatialSystem)
 
   world.Update();
 }
+
+EZ_CREATE_SIMPLE_TEST(World, SpatialSystemImplementations)
+{
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "RegularGrid")
+  {
+    // large cells keep the number of cells that are touched by the huge query volumes low, otherwise this takes ages in debug builds
+    ezSpatialSystem_RegularGrid spatialSystem(1024);
+    TestSpatialSystemImplementation(spatialSystem);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "LooseOctree")
+  {
+    ezSpatialSystem_LooseOctree spatialSystem(16384.0f, 16.0f);
+    TestSpatialSystemImplementation(spatialSystem);
+
+    // all nodes except the root are deleted once they become empty
+    EZ_TEST_INT(spatialSystem.GetNodeCount(), 1);
+  }
+}
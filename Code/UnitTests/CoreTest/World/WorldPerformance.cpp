@@ -1,5 +1,7 @@
 #include <CoreTestPCH.h>
 
+#include <Core/World/SpatialSystem_LooseOctree.h>
+#include <Core/World/SpatialSystem_RegularGrid.h>
 #include <Core/World/World.h>
 #include <Foundation/Time/Clock.h>
 #include <Foundation/Time/Stopwatch.h>
@@ -114,6 +116,144 @@ namespace
     }
   }
 
+  void MeasureSpatialQueries(ezSpatialSystem& spatialSystem, const char* szName)
+  {
+    ezRandom rng;
+    rng.Initialize(17);
+
+    // the spatial systems never dereference the objects, so any unique pointer will do
+    ezDynamicArray<ezUInt32> fakeObjects;
+    fakeObjects.SetCount(100000);
+
+    ezStopwatch sw;
+
+    for (ezUInt32 i = 0; i < fakeObjects.GetCount(); ++i)
+    {
+      // lots of small props and a few huge objects like terrain chunks
+      const bool bHuge = (i % 1000) == 0;
+      const float fMaxSize = bHuge ? 2000.0f : 5.0f;
+
+      ezSimdVec4f center((float)rng.DoubleMinMax(-8000.0, 8000.0), (float)rng.DoubleMinMax(-8000.0, 8000.0), (float)rng.DoubleMinMax(-200.0, 200.0));
+      ezSimdVec4f halfExtents((float)rng.DoubleMinMax(0.5, fMaxSize), (float)rng.DoubleMinMax(0.5, fMaxSize), (float)rng.DoubleMinMax(0.5, fMaxSize));
+
+      ezSimdBBox box;
+      box.SetCenterAndHalfExtents(center, halfExtents);
+
+      spatialSystem.CreateSpatialData(ezSimdBBoxSphere(box), reinterpret_cast<ezGameObject*>(&fakeObjects[i]),
+        ezDefaultSpatialDataCategories::RenderStatic.GetBitmask());
+    }
+
+    ezTestFramework::Output(ezTestOutput::Duration, "%s: Inserting %u objects: %.2fms", szName, fakeObjects.GetCount(), sw.Checkpoint().GetMilliseconds());
+
+    const ezUInt32 uiCategoryBitmask = ezDefaultSpatialDataCategories::RenderStatic.GetBitmask();
+    const ezUInt32 uiNumQueries = 100;
+
+    ezDynamicArray<const ezGameObject*> visibleObjects;
+    ezDynamicArray<ezGameObject*> objects;
+    ezSpatialSystem::QueryStats stats;
+
+    sw.Checkpoint();
+
+    for (ezUInt32 i = 0; i < uiNumQueries; ++i)
+    {
+      const ezAngle rotation = ezAngle::Degree(i * 360.0f / uiNumQueries);
+
+      ezFrustum frustum;
+      frustum.SetFrustum(ezVec3(0.0f, 0.0f, 10.0f), ezVec3(ezMath::Cos(rotation), ezMath::Sin(rotation), 0.0f), ezVec3(0.0f, 0.0f, 1.0f),
+        ezAngle::Degree(90.0f), ezAngle::Degree(60.0f), 0.1f, 5000.0f);
+
+      visibleObjects.Clear();
+      spatialSystem.FindVisibleObjects(frustum, uiCategoryBitmask, visibleObjects, &stats);
+    }
+
+    ezTestFramework::Output(ezTestOutput::Duration, "%s: %u frustum queries: %.2fms (nodes visited: %u, objects tested: %u, objects passed: %u)",
+      szName, uiNumQueries, sw.Checkpoint().GetMilliseconds(), stats.m_uiNumNodesVisited, stats.m_uiNumObjectsTested, stats.m_uiNumObjectsPassed);
+
+    // 4 shadow cascades and 20 spot lights, queried one by one and batched
+    {
+      const ezUInt32 uiNumFrustums = 24;
+
+      ezHybridArray<ezFrustum, 24> frustums;
+      ezHybridArray<ezDynamicArray<const ezGameObject*>, 24> visibleObjectsPerFrustum;
+      ezHybridArray<ezDynamicArray<const ezGameObject*>*, 24> visibleObjectsPtrs;
+      frustums.SetCount(uiNumFrustums);
+      visibleObjectsPerFrustum.SetCount(uiNumFrustums);
+
+      for (ezUInt32 i = 0; i < uiNumFrustums; ++i)
+      {
+        const bool bCascade = i < 4;
+        const ezAngle rotation = ezAngle::Degree(i * 53.0f);
+
+        const ezVec3 vPosition = bCascade ? ezVec3(0.0f, 0.0f, 1000.0f) : ezVec3((float)rng.DoubleMinMax(-3000.0, 3000.0), (float)rng.DoubleMinMax(-3000.0, 3000.0), 50.0f);
+        const ezVec3 vForward = bCascade ? ezVec3(0.3f, 0.2f, -1.0f).GetNormalized() : ezVec3(ezMath::Cos(rotation), ezMath::Sin(rotation), -0.5f).GetNormalized();
+        const float fFarPlane = bCascade ? 500.0f * (1 << i) : 300.0f;
+
+        frustums[i].SetFrustum(vPosition, vForward, ezVec3(0.0f, 0.0f, 1.0f), ezAngle::Degree(60.0f), ezAngle::Degree(60.0f), 0.1f, fFarPlane);
+        visibleObjectsPtrs.PushBack(&visibleObjectsPerFrustum[i]);
+      }
+
+      stats = ezSpatialSystem::QueryStats();
+      sw.Checkpoint();
+
+      for (ezUInt32 i = 0; i < uiNumQueries; ++i)
+      {
+        for (ezUInt32 f = 0; f < uiNumFrustums; ++f)
+        {
+          visibleObjectsPerFrustum[f].Clear();
+          spatialSystem.FindVisibleObjects(frustums[f], uiCategoryBitmask, visibleObjectsPerFrustum[f], &stats);
+        }
+      }
+
+      ezTestFramework::Output(ezTestOutput::Duration, "%s: %u x %u single frustum queries: %.2fms (nodes visited: %u, objects tested: %u)", szName,
+        uiNumQueries, uiNumFrustums, sw.Checkpoint().GetMilliseconds(), stats.m_uiNumNodesVisited, stats.m_uiNumObjectsTested);
+
+      stats = ezSpatialSystem::QueryStats();
+
+      for (ezUInt32 i = 0; i < uiNumQueries; ++i)
+      {
+        for (auto& visibleObjects : visibleObjectsPerFrustum)
+        {
+          visibleObjects.Clear();
+        }
+
+        spatialSystem.FindVisibleObjects(frustums, uiCategoryBitmask, visibleObjectsPtrs, &stats);
+      }
+
+      ezTestFramework::Output(ezTestOutput::Duration, "%s: %u batched queries with %u frustums: %.2fms (nodes visited: %u, objects tested: %u)", szName,
+        uiNumQueries, uiNumFrustums, sw.Checkpoint().GetMilliseconds(), stats.m_uiNumNodesVisited, stats.m_uiNumObjectsTested);
+    }
+
+    stats = ezSpatialSystem::QueryStats();
+    sw.Checkpoint();
+
+    for (ezUInt32 i = 0; i < uiNumQueries; ++i)
+    {
+      const ezVec3 center((float)rng.DoubleMinMax(-8000.0, 8000.0), (float)rng.DoubleMinMax(-8000.0, 8000.0), 0.0f);
+
+      objects.Clear();
+      spatialSystem.FindObjectsInSphere(ezBoundingSphere(center, 500.0f), uiCategoryBitmask, objects, &stats);
+    }
+
+    ezTestFramework::Output(ezTestOutput::Duration, "%s: %u sphere queries: %.2fms (nodes visited: %u, objects tested: %u, objects passed: %u)",
+      szName, uiNumQueries, sw.Checkpoint().GetMilliseconds(), stats.m_uiNumNodesVisited, stats.m_uiNumObjectsTested, stats.m_uiNumObjectsPassed);
+
+    stats = ezSpatialSystem::QueryStats();
+
+    for (ezUInt32 i = 0; i < uiNumQueries; ++i)
+    {
+      const ezVec3 center((float)rng.DoubleMinMax(-8000.0, 8000.0), (float)rng.DoubleMinMax(-8000.0, 8000.0), 0.0f);
+
+      ezBoundingBox box;
+      box.SetCenterAndHalfExtents(center, ezVec3(500.0f, 500.0f, 100.0f));
+
+      objects.Clear();
+      spatialSystem.FindObjectsInBox(box, uiCategoryBitmask, objects, &stats);
+    }
+
+    ezTestFramework::Output(ezTestOutput::Duration, "%s: %u box queries: %.2fms (nodes visited: %u, objects tested: %u, objects passed: %u)",
+      szName, uiNumQueries, sw.Checkpoint().GetMilliseconds(), stats.m_uiNumNodesVisited, stats.m_uiNumObjectsTested, stats.m_uiNumObjectsPassed);
+  }
+
 } // namespace
 
 
@@ -288,3 +428,18 @@ EZ_CREATE_SIMPLE_TEST(World, Profile_Update)
     }
   }
 }
+
+EZ_CREATE_SIMPLE_TEST(World, Profile_SpatialQueries)
+{
+  EZ_TEST_BLOCK(EnableInRelease, "RegularGrid")
+  {
+    ezSpatialSystem_RegularGrid spatialSystem;
+    MeasureSpatialQueries(spatialSystem, "RegularGrid");
+  }
+
+  EZ_TEST_BLOCK(EnableInRelease, "LooseOctree")
+  {
+    ezSpatialSystem_LooseOctree spatialSystem;
+    MeasureSpatialQueries(spatialSystem, "LooseOctree");
+  }
+}
@@ -187,6 +187,67 @@ EZ_CREATE_SIMPLE_TEST(World, World)
     TestTransforms(o, offset);
   }
 
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Transforms large hierarchy")
+  {
+    // enough objects per hierarchy level to be updated by multiple tasks, and a count that doesn't fill the last data block
+    const ezUInt32 uiNumChains = 2001;
+    const ezUInt32 uiChainLength = 4;
+
+    for (ezUInt32 uiSpatialSystem = 0; uiSpatialSystem < 2; ++uiSpatialSystem)
+    {
+      ezWorldDesc worldDesc("Test");
+      worldDesc.m_bAutoCreateSpatialSystem = (uiSpatialSystem != 0);
+
+      ezWorld world(worldDesc);
+      EZ_LOCK(world.GetWriteMarker());
+
+      ezDynamicArray<ezGameObject*> objects;
+      objects.Reserve(uiNumChains * uiChainLength);
+
+      for (ezUInt32 c = 0; c < uiNumChains; ++c)
+      {
+        ezGameObjectDesc desc;
+        desc.m_bDynamic = true;
+
+        for (ezUInt32 l = 0; l < uiChainLength; ++l)
+        {
+          desc.m_LocalPosition = ezVec3((float)c, (float)l, 1.0f);
+          desc.m_LocalRotation.SetFromAxisAndAngle(ezVec3(0.0f, 0.0f, 1.0f), ezAngle::Degree((float)((c + l) % 360)));
+          desc.m_LocalScaling = ezVec3(1.0f + l * 0.1f);
+
+          ezGameObject* pObject = nullptr;
+          desc.m_hParent = world.CreateObject(desc, pObject);
+          objects.PushBack(pObject);
+        }
+      }
+
+      // modify the roots after creation, such that only the world update computes the correct global transforms
+      for (ezUInt32 c = 0; c < uiNumChains; ++c)
+      {
+        objects[c * uiChainLength]->SetLocalPosition(ezVec3((float)c, 0.0f, 10.0f));
+      }
+
+      world.Update();
+
+      for (ezUInt32 c = 0; c < uiNumChains; ++c)
+      {
+        ezTransform expected;
+        expected.SetIdentity();
+
+        for (ezUInt32 l = 0; l < uiChainLength; ++l)
+        {
+          const ezGameObject* pObject = objects[c * uiChainLength + l];
+          const ezTransform parent = expected;
+          expected.SetGlobalTransform(parent, pObject->GetLocalTransform());
+
+          EZ_TEST_VEC3(pObject->GetGlobalPosition(), expected.m_vPosition, 0.001f);
+          EZ_TEST_BOOL(pObject->GetGlobalRotation().IsEqualRotation(expected.m_qRotation, 0.001f));
+          EZ_TEST_VEC3(pObject->GetGlobalScaling(), expected.m_vScale, 0.001f);
+        }
+      }
+    }
+  }
+
   EZ_TEST_BLOCK(ezTestBlock::Enabled, "GameObject parenting")
   {
     ezWorldDesc worldDesc("Test");
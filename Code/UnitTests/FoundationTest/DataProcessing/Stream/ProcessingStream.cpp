@@ -1,11 +1,13 @@
 
 #include <FoundationTestPCH.h>
 
+#include <Foundation/Containers/HashSet.h>
 #include <Foundation/DataProcessing/Stream/DefaultImplementations/ZeroInitializer.h>
 #include <Foundation/DataProcessing/Stream/ProcessingStreamGroup.h>
 #include <Foundation/DataProcessing/Stream/ProcessingStreamIterator.h>
 #include <Foundation/DataProcessing/Stream/ProcessingStreamProcessor.h>
 #include <Foundation/Reflection/Reflection.h>
+#include <Foundation/Threading/TaskSystem.h>
 
 EZ_CREATE_SIMPLE_TEST_GROUP(DataProcessing);
 
@@ -157,3 +159,320 @@ EZ_CREATE_SIMPLE_TEST(DataProcessing, ProcessingStream)
     }
   }
 }
+
+// Add processor that supports range processing
+
+class AddOneRangeStreamProcessor : public AddOneStreamProcessor
+{
+  EZ_ADD_DYNAMIC_REFLECTION(AddOneRangeStreamProcessor, AddOneStreamProcessor);
+
+public:
+  virtual bool SupportsRangeProcessing() const override { return true; }
+
+protected:
+  virtual void ProcessRange(ezUInt64 uiStartIndex, ezUInt64 uiNumElements) override
+  {
+    ezProcessingStreamIterator<float> streamIterator(m_pStream, uiNumElements, uiStartIndex);
+
+    while (!streamIterator.HasReachedEnd())
+    {
+      streamIterator.Current() += 1.0f;
+
+      streamIterator.Advance();
+    }
+  }
+};
+
+EZ_BEGIN_DYNAMIC_REFLECTED_TYPE(AddOneRangeStreamProcessor, 1, ezRTTIDefaultAllocator<AddOneRangeStreamProcessor>)
+EZ_END_DYNAMIC_REFLECTED_TYPE;
+
+EZ_CREATE_SIMPLE_TEST(DataProcessing, ProcessingStreamRanges)
+{
+  ezProcessingStreamGroup Group;
+  ezProcessingStream* pStream1 = Group.AddStream("Stream1", ezProcessingStream::DataType::Float);
+
+  ezProcessingStreamSpawnerZeroInitialized* pSpawner = EZ_DEFAULT_NEW(ezProcessingStreamSpawnerZeroInitialized);
+  pSpawner->SetStreamName(pStream1->GetName());
+  Group.AddProcessor(pSpawner);
+
+  AddOneRangeStreamProcessor* pProcessor = EZ_DEFAULT_NEW(AddOneRangeStreamProcessor);
+  pProcessor->SetStreamName(pStream1->GetName());
+  Group.AddProcessor(pProcessor);
+
+  Group.SetSize(1000);
+  Group.InitializeElements(1000);
+  Group.Process();
+
+  EZ_TEST_BOOL(Group.SupportsRangeProcessing());
+  EZ_TEST_INT(Group.GetNumActiveElements(), 1000);
+
+  auto CheckValues = [&](float fExpected) {
+    ezProcessingStreamIterator<float> stream1Iterator(pStream1, Group.GetNumActiveElements(), 0);
+
+    ezUInt32 uiNumWrong = 0;
+    while (!stream1Iterator.HasReachedEnd())
+    {
+      if (stream1Iterator.Current() != fExpected)
+        ++uiNumWrong;
+
+      stream1Iterator.Advance();
+    }
+
+    EZ_TEST_INT(uiNumWrong, 0);
+  };
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Process")
+  {
+    // the spawned elements are only processed in the next step
+    Group.Process();
+    CheckValues(1.0f);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "ProcessRange")
+  {
+    Group.BeginRangeProcessing();
+    Group.ProcessRange(0, 300);
+    Group.ProcessRange(300, 700);
+    Group.EndRangeProcessing();
+
+    CheckValues(2.0f);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "RemoveElement")
+  {
+    Group.BeginRangeProcessing();
+    Group.RemoveElement(10);
+    Group.RemoveElement(999);
+    Group.RemoveElement(10);
+    Group.RemoveElement(500);
+    Group.EndRangeProcessing();
+
+    EZ_TEST_INT(Group.GetNumActiveElements(), 997);
+    CheckValues(2.0f);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Serial Fallback")
+  {
+    AddOneStreamProcessor* pSerialProcessor = EZ_DEFAULT_NEW(AddOneStreamProcessor);
+    pSerialProcessor->SetStreamName(pStream1->GetName());
+    Group.AddProcessor(pSerialProcessor);
+
+    EZ_TEST_BOOL(!Group.SupportsRangeProcessing());
+
+    Group.Process();
+    CheckValues(4.0f);
+
+    Group.RemoveProcessor(pSerialProcessor);
+
+    EZ_TEST_BOOL(Group.SupportsRangeProcessing());
+  }
+}
+
+// Processor that removes marked elements while processing ranges
+
+class RemoveMarkedRangeStreamProcessor : public ezProcessingStreamProcessor
+{
+  EZ_ADD_DYNAMIC_REFLECTION(RemoveMarkedRangeStreamProcessor, ezProcessingStreamProcessor);
+
+public:
+  void SetStreamName(ezHashedString StreamName) { m_StreamName = StreamName; }
+
+  virtual bool SupportsRangeProcessing() const override { return true; }
+
+  ezHashSet<ezUInt32> m_RemoveIDs;
+  ezDynamicArray<ezUInt32> m_NumProcessed; // indexed by element ID
+  ezUInt32 m_uiNumFinishCalls = 0;
+
+protected:
+  virtual ezResult UpdateStreamBindings() override
+  {
+    m_pStream = m_pStreamGroup->GetStreamByName(m_StreamName);
+
+    return m_pStream ? EZ_SUCCESS : EZ_FAILURE;
+  }
+
+  virtual void InitializeElements(ezUInt64 uiStartIndex, ezUInt64 uiNumElements) override
+  {
+    ezProcessingStreamIterator<float> streamIterator(m_pStream, uiNumElements, uiStartIndex);
+
+    ezUInt32 uiID = static_cast<ezUInt32>(uiStartIndex);
+    while (!streamIterator.HasReachedEnd())
+    {
+      streamIterator.Current() = static_cast<float>(uiID++);
+
+      streamIterator.Advance();
+    }
+  }
+
+  virtual void Process(ezUInt64 uiNumElements) override { ProcessRange(0, uiNumElements); }
+
+  virtual void ProcessRange(ezUInt64 uiStartIndex, ezUInt64 uiNumElements) override
+  {
+    const float* pIDs = m_pStream->GetData<float>();
+
+    for (ezUInt64 i = uiStartIndex; i < uiStartIndex + uiNumElements; ++i)
+    {
+      const ezUInt32 uiID = static_cast<ezUInt32>(pIDs[i]);
+      ++m_NumProcessed[uiID];
+
+      if (m_RemoveIDs.Contains(uiID))
+      {
+        // removing an element twice must only remove it once
+        m_pStreamGroup->RemoveElement(i);
+        m_pStreamGroup->RemoveElement(i);
+      }
+    }
+  }
+
+  virtual void FinishProcessing() override { ++m_uiNumFinishCalls; }
+
+  ezHashedString m_StreamName;
+  ezProcessingStream* m_pStream = nullptr;
+};
+
+EZ_BEGIN_DYNAMIC_REFLECTED_TYPE(RemoveMarkedRangeStreamProcessor, 1, ezRTTIDefaultAllocator<RemoveMarkedRangeStreamProcessor>)
+EZ_END_DYNAMIC_REFLECTED_TYPE;
+
+EZ_CREATE_SIMPLE_TEST(DataProcessing, ProcessingStreamRangeRemoval)
+{
+  const ezUInt32 uiNumElements = 1000;
+
+  ezProcessingStreamGroup Group;
+  ezProcessingStream* pStreamID = Group.AddStream("ID", ezProcessingStream::DataType::Float);
+
+  RemoveMarkedRangeStreamProcessor* pProcessor = EZ_DEFAULT_NEW(RemoveMarkedRangeStreamProcessor);
+  pProcessor->SetStreamName(pStreamID->GetName());
+  pProcessor->m_NumProcessed.SetCount(uiNumElements);
+  Group.AddProcessor(pProcessor);
+
+  ezUInt32 uiNumRemovedEvents = 0;
+  Group.m_ElementRemovedEvent.AddEventHandler([&](const ezStreamGroupElementRemovedEvent& e) { ++uiNumRemovedEvents; });
+
+  Group.SetSize(uiNumElements);
+  Group.InitializeElements(uiNumElements);
+  Group.Process();
+
+  EZ_TEST_INT(Group.GetNumActiveElements(), uiNumElements);
+  EZ_TEST_INT(pProcessor->m_uiNumFinishCalls, 1);
+
+  auto CheckRemainingIDs = [&](const ezHashSet<ezUInt32>& removedIDs) {
+    ezDynamicArray<ezUInt32> numOccurrences;
+    numOccurrences.SetCount(uiNumElements);
+
+    const float* pIDs = pStreamID->GetData<float>();
+    for (ezUInt64 i = 0; i < Group.GetNumActiveElements(); ++i)
+    {
+      ++numOccurrences[static_cast<ezUInt32>(pIDs[i])];
+    }
+
+    ezUInt32 uiNumWrong = 0;
+    for (ezUInt32 uiID = 0; uiID < uiNumElements; ++uiID)
+    {
+      if (numOccurrences[uiID] != (removedIDs.Contains(uiID) ? 0u : 1u))
+        ++uiNumWrong;
+    }
+
+    EZ_TEST_INT(uiNumWrong, 0);
+  };
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Out of order ranges")
+  {
+    pProcessor->m_NumProcessed.Clear();
+    pProcessor->m_NumProcessed.SetCount(uiNumElements);
+
+    Group.BeginRangeProcessing();
+    Group.ProcessRange(700, 300);
+    Group.ProcessRange(0, 300);
+    Group.ProcessRange(300, 400);
+    Group.EndRangeProcessing();
+
+    ezUInt32 uiNumWrong = 0;
+    for (ezUInt32 uiNum : pProcessor->m_NumProcessed)
+    {
+      if (uiNum != 1)
+        ++uiNumWrong;
+    }
+
+    EZ_TEST_INT(uiNumWrong, 0);
+    EZ_TEST_INT(pProcessor->m_uiNumFinishCalls, 2);
+    EZ_TEST_INT(Group.GetNumActiveElements(), uiNumElements);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Duplicate and boundary removals")
+  {
+    // the first and last element and the elements on both sides of the range boundaries
+    ezHashSet<ezUInt32> removedIDs;
+    removedIDs.Insert(0);
+    removedIDs.Insert(299);
+    removedIDs.Insert(300);
+    removedIDs.Insert(699);
+    removedIDs.Insert(700);
+    removedIDs.Insert(999);
+    removedIDs.Insert(500);
+
+    pProcessor->m_RemoveIDs = removedIDs;
+    uiNumRemovedEvents = 0;
+
+    Group.BeginRangeProcessing();
+    Group.ProcessRange(700, 300);
+    Group.ProcessRange(300, 400);
+    Group.ProcessRange(0, 300);
+
+    // removals outside of a range are merged with the ones of the ranges
+    Group.RemoveElement(999);
+    Group.RemoveElement(500);
+    Group.EndRangeProcessing();
+
+    EZ_TEST_INT(uiNumRemovedEvents, removedIDs.GetCount());
+    EZ_TEST_INT(Group.GetNumActiveElements(), uiNumElements - removedIDs.GetCount());
+    CheckRemainingIDs(removedIDs);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Parallel ranges")
+  {
+    pProcessor->m_RemoveIDs.Clear();
+    for (ezUInt32 uiID = 1; uiID < uiNumElements; uiID += 3)
+    {
+      pProcessor->m_RemoveIDs.Insert(uiID);
+    }
+
+    ezHashSet<ezUInt32> removedIDs = pProcessor->m_RemoveIDs;
+    removedIDs.Insert(0);
+    removedIDs.Insert(299);
+    removedIDs.Insert(300);
+    removedIDs.Insert(699);
+    removedIDs.Insert(700);
+    removedIDs.Insert(999);
+    removedIDs.Insert(500);
+
+    const ezUInt32 uiNumActive = static_cast<ezUInt32>(Group.GetNumActiveElements());
+
+    ezParallelForParams params;
+    params.uiBinSize = 32;
+
+    Group.BeginRangeProcessing();
+    ezTaskSystem::ParallelForIndexed(0, uiNumActive,
+      [&](ezUInt32 uiStartIndex, ezUInt32 uiEndIndex) { Group.ProcessRange(uiStartIndex, uiEndIndex - uiStartIndex); },
+      "ProcessingStreamRangeRemoval", params);
+    Group.EndRangeProcessing();
+
+    EZ_TEST_INT(Group.GetNumActiveElements(), uiNumElements - removedIDs.GetCount());
+    CheckRemainingIDs(removedIDs);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "FinishProcessing without elements")
+  {
+    for (ezUInt32 uiID = 0; uiID < uiNumElements; ++uiID)
+    {
+      pProcessor->m_RemoveIDs.Insert(uiID);
+    }
+
+    Group.Process();
+    EZ_TEST_INT(Group.GetNumActiveElements(), 0);
+
+    const ezUInt32 uiNumFinishCalls = pProcessor->m_uiNumFinishCalls;
+
+    Group.Process();
+    EZ_TEST_INT(pProcessor->m_uiNumFinishCalls, uiNumFinishCalls + 1);
+  }
+}
@@ -4,12 +4,15 @@
 #include <Foundation/IO/FileSystem/DataDirTypeFolder.h>
 #include <Foundation/IO/FileSystem/FileReader.h>
 #include <Foundation/IO/FileSystem/FileSystem.h>
+#include <Foundation/IO/MemoryStream.h>
+#include <TestFramework/Utilities/TestLogInterface.h>
 #include <Texture/Image/Formats/BmpFileFormat.h>
 #include <Texture/Image/Formats/DdsFileFormat.h>
 #include <Texture/Image/Formats/ImageFileFormat.h>
 #include <Texture/Image/Image.h>
 #include <Texture/Image/ImageConversion.h>
 #include <Texture/Image/ImageUtils.h>
+#include <Texture/ezTexFormat/ezTexFormat.h>
 
 EZ_CREATE_SIMPLE_TEST_GROUP(Image);
 
@@ -189,6 +192,81 @@ EZ_CREATE_SIMPLE_TEST(Image, Image)
     }
   }
 
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "ezTexFormat - Streamable Mip Levels")
+  {
+    ezImageHeader header;
+    header.SetImageFormat(ezImageFormat::R8G8B8A8_UNORM);
+    header.SetWidth(64);
+    header.SetHeight(32);
+    header.SetNumMipLevels(7);
+    header.SetNumArrayIndices(2);
+
+    ezImage image;
+    image.ResetAndAlloc(header);
+
+    ezBlobPtr<ezUInt8> pixels = image.GetBlobPtr<ezUInt8>();
+    for (ezUInt32 i = 0; i < pixels.GetCount(); ++i)
+    {
+      pixels[i] = static_cast<ezUInt8>(i * 7);
+    }
+
+    ezMemoryStreamStorage storage;
+    ezMemoryStreamWriter writer(&storage);
+    EZ_TEST_BOOL(ezTexFormat::WriteStreamableImage(writer, image).Succeeded());
+
+    for (ezUInt32 uiMaxMipLevels : {1u, 3u, 7u, 10u})
+    {
+      ezMemoryStreamReader reader(&storage);
+
+      ezImage image2;
+      ezUInt32 uiNumMipLevelsTotal = 0;
+      EZ_TEST_BOOL(ezTexFormat::ReadStreamableImage(reader, image2, uiMaxMipLevels, &uiNumMipLevelsTotal).Succeeded());
+
+      const ezUInt32 uiNumMipLevels = ezMath::Min(uiMaxMipLevels, 7u);
+      const ezUInt32 uiFirstMipLevel = 7 - uiNumMipLevels;
+
+      EZ_TEST_INT(uiNumMipLevelsTotal, 7);
+      EZ_TEST_INT(image2.GetNumMipLevels(), uiNumMipLevels);
+      EZ_TEST_INT(image2.GetWidth(), image.GetWidth(uiFirstMipLevel));
+      EZ_TEST_INT(image2.GetHeight(), image.GetHeight(uiFirstMipLevel));
+      EZ_TEST_INT(image2.GetNumArrayIndices(), 2);
+
+      for (ezUInt32 mip = 0; mip < uiNumMipLevels; ++mip)
+      {
+        for (ezUInt32 arrayIndex = 0; arrayIndex < 2; ++arrayIndex)
+        {
+          ezConstByteBlobPtr expected = image.GetSubImageView(uiFirstMipLevel + mip, 0, arrayIndex).GetByteBlobPtr();
+          ezConstByteBlobPtr actual = image2.GetSubImageView(mip, 0, arrayIndex).GetByteBlobPtr();
+
+          EZ_TEST_INT(actual.GetCount(), expected.GetCount());
+          EZ_TEST_BOOL(ezMemoryUtils::IsEqual(actual.GetPtr(), expected.GetPtr(), expected.GetCount()));
+        }
+      }
+
+      // the low resolution mip levels come first, the rest of the data isn't touched
+      EZ_TEST_BOOL((reader.SkipBytes(storage.GetStorageSize()) > 0) == (uiMaxMipLevels < 7));
+    }
+
+    // the offset table is validated entirely, even if only the smallest mip level is read
+    {
+      ezDynamicArray<ezUInt8> corrupted;
+      corrupted.PushBackRange(ezArrayPtr<const ezUInt8>(storage.GetData(), storage.GetStorageSize()));
+
+      // version, 7 header values, 7 + 1 offsets, the last one is the total size
+      const ezUInt32 uiTotalSizeOffset = sizeof(ezUInt8) + 7 * sizeof(ezUInt32) + 7 * sizeof(ezUInt64);
+      corrupted[uiTotalSizeOffset] ^= 0xFF;
+
+      ezRawMemoryStreamReader reader(corrupted);
+
+      ezTestLogInterface log;
+      ezTestLogSystemScope logSystemScope(&log);
+      log.ExpectMessage("Streamable texture data has an invalid offset table", ezLogMsgType::ErrorMsg);
+
+      ezImage image2;
+      EZ_TEST_BOOL(ezTexFormat::ReadStreamableImage(reader, image2, 1).Failed());
+    }
+  }
+
   ezFileSystem::RemoveDataDirectoryGroup("ImageTest");
 }
 
@@ -3,6 +3,7 @@
 #include <Foundation/IO/FileSystem/DataDirTypeFolder.h>
 #include <Foundation/IO/FileSystem/FileReader.h>
 #include <Foundation/IO/FileSystem/FileSystem.h>
+#include <Texture/Image/ImageConversion.h>
 #include <Texture/Image/ImageUtils.h>
 
 
@@ -116,5 +117,47 @@ EZ_CREATE_SIMPLE_TEST(Image, ImageUtils)
     EZ_TEST_INT(uiError, 1433);
   }
 
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Convert sRGB large")
+  {
+    // large enough to be split up over multiple tasks
+    ezImageHeader header;
+    header.SetWidth(1024);
+    header.SetHeight(512);
+    header.SetImageFormat(ezImageFormat::R8G8B8A8_UNORM_SRGB);
+
+    ezImage ImageSrgb;
+    ImageSrgb.ResetAndAlloc(header);
+
+    for (ezUInt32 y = 0; y < header.GetHeight(); ++y)
+    {
+      for (ezUInt32 x = 0; x < header.GetWidth(); ++x)
+      {
+        *ImageSrgb.GetPixelPointer<ezColorGammaUB>(0, 0, 0, x, y) = ezColorGammaUB(x % 256, y % 256, (x + y) % 256, (x * y) % 256);
+      }
+    }
+
+    ezImage ImageLinear, ImageBack;
+    EZ_TEST_BOOL(ezImageConversion::Convert(ImageSrgb, ImageLinear, ezImageFormat::R32G32B32A32_FLOAT).Succeeded());
+    EZ_TEST_BOOL(ezImageConversion::Convert(ImageLinear, ImageBack, ezImageFormat::R8G8B8A8_UNORM_SRGB).Succeeded());
+
+    ezUInt32 uiNumMismatches = 0;
+
+    for (ezUInt32 y = 0; y < header.GetHeight(); ++y)
+    {
+      for (ezUInt32 x = 0; x < header.GetWidth(); ++x)
+      {
+        const ezColorGammaUB srgb = *ImageSrgb.GetPixelPointer<ezColorGammaUB>(0, 0, 0, x, y);
+        const ezColor linear = *ImageLinear.GetPixelPointer<ezColor>(0, 0, 0, x, y);
+
+        if (linear != ezColor(srgb) || *ImageBack.GetPixelPointer<ezColorGammaUB>(0, 0, 0, x, y) != srgb)
+        {
+          ++uiNumMismatches;
+        }
+      }
+    }
+
+    EZ_TEST_INT(uiNumMismatches, 0);
+  }
+
   ezFileSystem::RemoveDataDirectoryGroup("ImageTest");
 }
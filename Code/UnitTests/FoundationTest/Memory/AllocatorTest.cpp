@@ -1,5 +1,6 @@
 #include <FoundationTestPCH.h>
 
+#include <Foundation/IO/OSFile.h>
 #include <Foundation/Memory/CommonAllocators.h>
 #include <Foundation/Memory/LargeBlockAllocator.h>
 #include <Foundation/Memory/StackAllocator.h>
@@ -235,4 +236,46 @@ EZ_CREATE_SIMPLE_TEST(Memory, Allocator)
 
     EZ_TEST_BOOL(ezConstructionCounter::HasDestructed(50));
   }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Allocation Sampling")
+  {
+    const ezUInt32 uiPrevInterval = ezMemoryTracker::GetSamplingInterval();
+    ezMemoryTracker::SetSamplingInterval(4096);
+
+    ezAllocator<ezMemoryPolicies::ezHeapAllocation, ezMemoryTrackingFlags::RegisterAllocator | ezMemoryTrackingFlags::EnableAllocationSampling> allocator(
+      "TestSamplingAllocator", ezFoundation::GetDefaultAllocator());
+
+    ezDynamicArray<void*> allocs;
+    allocs.SetCount(2000);
+
+    for (ezUInt32 i = 0; i < allocs.GetCount(); ++i)
+    {
+      allocs[i] = allocator.Allocate(256, sizeof(void*));
+    }
+
+    ezAllocatorBase::Stats stats = allocator.GetStats();
+    EZ_TEST_INT(stats.m_uiNumAllocations, 2000);
+    EZ_TEST_INT(stats.m_uiNumDeallocations, 0);
+    EZ_TEST_INT(stats.m_uiPerFrameAllocationSize, 2000 * 256);
+
+    // about 125 samples, the estimate is well within these bounds
+    EZ_TEST_BOOL(stats.m_uiAllocationSize > 2000 * 256 / 2);
+    EZ_TEST_BOOL(stats.m_uiAllocationSize < 2000 * 256 * 2);
+
+    ezStringBuilder sFile = ezTestFramework::GetInstance()->GetAbsOutputPath();
+    sFile.AppendPath("AllocationSites.txt");
+    EZ_TEST_BOOL(ezMemoryTracker::DumpAllocationSites(sFile).Succeeded());
+    EZ_TEST_BOOL(ezOSFile::ExistsFile(sFile));
+
+    for (ezUInt32 i = 0; i < allocs.GetCount(); ++i)
+    {
+      allocator.Deallocate(allocs[i]);
+    }
+
+    stats = allocator.GetStats();
+    EZ_TEST_INT(stats.m_uiNumDeallocations, 2000);
+    EZ_TEST_INT(stats.m_uiAllocationSize, 0);
+
+    ezMemoryTracker::SetSamplingInterval(uiPrevInterval);
+  }
 }
@@ -0,0 +1,185 @@
+#include <FoundationTestPCH.h>
+
+#include <Foundation/Logging/Log.h>
+#include <Foundation/Strings/HashedString.h>
+#include <Foundation/Strings/StringBuilder.h>
+#include <Foundation/Threading/TaskSystem.h>
+#include <Foundation/Threading/Thread.h>
+#include <Foundation/Time/Time.h>
+
+namespace HashedStringPerformanceTestDetail
+{
+  enum Constants
+  {
+#if EZ_ENABLED(EZ_COMPILE_FOR_DEBUG)
+    NUM_STRINGS = 2000,
+    NUM_LOOKUPS = 20,
+#else
+    NUM_STRINGS = 20000,
+    NUM_LOOKUPS = 100,
+#endif
+  };
+
+  /// Interns the same set of strings on all worker threads at once and returns the time it took.
+  ezTime InternStrings(const ezDynamicArray<ezString>& strings, ezDynamicArray<ezHashedString>& out_Hashed, ezUInt32 uiRepetitions)
+  {
+    out_Hashed.Clear();
+    out_Hashed.SetCount(strings.GetCount() * uiRepetitions);
+
+    ezParallelForParams params;
+    params.uiBinSize = 64;
+
+    const ezTime t0 = ezTime::Now();
+
+    // every repetition interns every string, so different threads look up the same strings concurrently
+    ezTaskSystem::ParallelForIndexed(0, out_Hashed.GetCount(),
+      [&](ezUInt32 uiStartIndex, ezUInt32 uiEndIndex) {
+        for (ezUInt32 i = uiStartIndex; i < uiEndIndex; ++i)
+        {
+          out_Hashed[i].Assign(strings[i % strings.GetCount()].GetData());
+        }
+      },
+      "InternStrings", params);
+
+    return ezTime::Now() - t0;
+  }
+
+#if EZ_ENABLED(EZ_HASHED_STRING_REF_COUNTING)
+  /// Clears the unused strings over and over again, until it is told to stop.
+  class ClearUnusedStringsThread : public ezThread
+  {
+  public:
+    ClearUnusedStringsThread()
+      : ezThread("ClearUnusedStrings")
+    {
+    }
+
+    virtual ezUInt32 Run() override
+    {
+      while (!m_bStop)
+      {
+        m_uiNumCleared += ezHashedString::ClearUnusedStrings();
+      }
+
+      return 0;
+    }
+
+    ezAtomicBool m_bStop;
+    ezUInt32 m_uiNumCleared = 0;
+  };
+#endif
+} // namespace HashedStringPerformanceTestDetail
+
+EZ_CREATE_SIMPLE_TEST(Performance, HashedString)
+{
+  using namespace HashedStringPerformanceTestDetail;
+
+  const ezUInt32 uiPrevShortWorkers = ezTaskSystem::GetWorkerThreadCount(ezWorkerThreadType::ShortTasks);
+  const ezUInt32 uiPrevLongWorkers = ezTaskSystem::GetWorkerThreadCount(ezWorkerThreadType::LongTasks);
+  ezTaskSystem::SetWorkerThreadCount(-1, -1);
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Concurrent Interning")
+  {
+    // a different prefix on every run, such that the first pass really inserts new strings
+    static ezUInt32 s_uiRun = 0;
+    ++s_uiRun;
+
+    ezDynamicArray<ezString> strings;
+    strings.SetCount(NUM_STRINGS);
+
+    ezStringBuilder tmp;
+    for (ezUInt32 i = 0; i < NUM_STRINGS; ++i)
+    {
+      tmp.Format("HashedStringPerf_{0}_{1}", s_uiRun, i);
+      strings[i] = tmp;
+    }
+
+    ezDynamicArray<ezHashedString> hashed;
+
+    const ezTime tInsert = InternStrings(strings, hashed, 2);
+
+    // the same string must end up as the same entry, no matter which thread interned it first
+    for (ezUInt32 i = 0; i < NUM_STRINGS; ++i)
+    {
+      EZ_TEST_BOOL(hashed[i] == hashed[NUM_STRINGS + i]);
+      EZ_TEST_STRING(hashed[i].GetData(), strings[i].GetData());
+      EZ_TEST_BOOL(hashed[i].GetData() == hashed[NUM_STRINGS + i].GetData());
+    }
+
+    ezDynamicArray<ezHashedString> lookedUp;
+    const ezTime tLookup = InternStrings(strings, lookedUp, NUM_LOOKUPS);
+
+    ezUInt32 uiMismatches = 0;
+    for (ezUInt32 i = 0; i < lookedUp.GetCount(); ++i)
+    {
+      if (lookedUp[i].GetData() != hashed[i % NUM_STRINGS].GetData())
+        ++uiMismatches;
+    }
+
+    EZ_TEST_INT(uiMismatches, 0);
+
+    const ezUInt32 uiNumInsert = NUM_STRINGS * 2;
+    const ezUInt32 uiNumLookup = NUM_STRINGS * NUM_LOOKUPS;
+
+    ezLog::Info("[test]Insert: {0} strings/sec ({1}ms)", ezArgF(uiNumInsert / tInsert.GetSeconds(), 0), ezArgF(tInsert.GetMilliseconds(), 2));
+    ezLog::Info("[test]Lookup: {0} strings/sec ({1}ms)", ezArgF(uiNumLookup / tLookup.GetSeconds(), 0), ezArgF(tLookup.GetMilliseconds(), 2));
+  }
+
+#if EZ_ENABLED(EZ_HASHED_STRING_REF_COUNTING)
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Concurrent Interning And Clearing")
+  {
+    // short strings and ones that don't fit into the inline storage of ezString
+    ezDynamicArray<ezString> strings;
+    strings.SetCount(NUM_STRINGS);
+
+    ezStringBuilder tmp;
+    for (ezUInt32 i = 0; i < NUM_STRINGS; ++i)
+    {
+      if (i % 2 == 0)
+        tmp.Format("HashedStringClear_{0}", i);
+      else
+        tmp.Format("HashedStringClear_{0}_with_a_suffix_that_makes_it_longer", i);
+
+      strings[i] = tmp;
+    }
+
+    ClearUnusedStringsThread clearThread;
+    clearThread.Start();
+
+    // the strings are released after every round, so entries get cleared and reused for other strings while they are looked up
+    ezDynamicArray<ezHashedString> hashed;
+    ezUInt32 uiMismatches = 0;
+
+    for (ezUInt32 uiRound = 0; uiRound < 10; ++uiRound)
+    {
+      InternStrings(strings, hashed, 2);
+
+      for (ezUInt32 i = 0; i < NUM_STRINGS; ++i)
+      {
+        if (hashed[i] != hashed[NUM_STRINGS + i] || hashed[i].GetString() != strings[i])
+          ++uiMismatches;
+      }
+
+      hashed.Clear();
+    }
+
+    clearThread.m_bStop = true;
+    clearThread.Join();
+
+    EZ_TEST_INT(uiMismatches, 0);
+    EZ_TEST_BOOL(clearThread.m_uiNumCleared > 0);
+
+    // the cleared entries are reused for the next strings
+    ezHashedString::ClearUnusedStrings();
+
+    InternStrings(strings, hashed, 1);
+
+    for (ezUInt32 i = 0; i < NUM_STRINGS; ++i)
+    {
+      EZ_TEST_STRING(hashed[i].GetData(), strings[i].GetData());
+    }
+  }
+#endif
+
+  ezTaskSystem::SetWorkerThreadCount(static_cast<ezInt8>(uiPrevShortWorkers), static_cast<ezInt8>(uiPrevLongWorkers));
+}
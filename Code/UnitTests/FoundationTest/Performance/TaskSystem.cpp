@@ -0,0 +1,180 @@
+#include <FoundationTestPCH.h>
+
+#include <Foundation/Logging/Log.h>
+#include <Foundation/Threading/TaskSystem.h>
+#include <Foundation/Time/Time.h>
+#include <Foundation/Types/UniquePtr.h>
+
+namespace TaskSystemPerformanceTestDetail
+{
+  enum Constants
+  {
+#if EZ_ENABLED(EZ_COMPILE_FOR_DEBUG)
+    NUM_FRAMES = 16,
+    NUM_SPAWNERS = 8,
+    NUM_WORK_ITERATIONS = 200,
+#else
+    NUM_FRAMES = 64,
+    NUM_SPAWNERS = 16,
+    NUM_WORK_ITERATIONS = 2000,
+#endif
+    NUM_CHILDREN = 64,
+  };
+
+  class ezBenchmarkChildTask final : public ezTask
+  {
+  public:
+    ezBenchmarkChildTask() { ConfigureTask("Benchmark Child", ezTaskNesting::Never); }
+
+    const ezTime* m_pStartTime = nullptr;
+    ezTime m_Latency;
+    ezUInt32 m_uiResult = 0;
+    bool m_bExecuted = false;
+
+  private:
+    virtual void Execute() override
+    {
+      m_Latency = ezTime::Now() - *m_pStartTime;
+
+      // a bit of busy work, that the compiler cannot optimize away
+      ezUInt32 uiValue = m_uiResult;
+      for (ezUInt32 i = 0; i < NUM_WORK_ITERATIONS; ++i)
+      {
+        uiValue = uiValue * 1664525u + 1013904223u;
+      }
+
+      m_uiResult = uiValue;
+      m_bExecuted = true;
+    }
+  };
+
+  /// Runs on a worker thread and spawns a group of small tasks, which is the pattern that work stealing is meant for.
+  class ezBenchmarkSpawnerTask final : public ezTask
+  {
+  public:
+    ezBenchmarkSpawnerTask() { ConfigureTask("Benchmark Spawner", ezTaskNesting::Maybe); }
+
+    ezTime m_StartTime;
+    ezBenchmarkChildTask m_Children[NUM_CHILDREN];
+
+  private:
+    virtual void Execute() override
+    {
+      ezTaskGroupID group = ezTaskSystem::CreateTaskGroup(ezTaskPriority::ThisFrame);
+
+      for (ezBenchmarkChildTask& child : m_Children)
+      {
+        child.m_pStartTime = &m_StartTime;
+        child.m_bExecuted = false;
+        ezTaskSystem::AddTaskToGroup(group, &child);
+      }
+
+      m_StartTime = ezTime::Now();
+      ezTaskSystem::StartTaskGroup(group);
+      ezTaskSystem::WaitForGroup(group);
+    }
+  };
+
+  struct BenchmarkResult
+  {
+    ezUInt32 m_uiTasksExecuted = 0;
+    double m_fTasksPerSecond = 0;
+    ezTime m_MedianLatency;
+    ezTime m_P99Latency;
+    ezTime m_MaxLatency;
+  };
+
+  BenchmarkResult RunSchedulerBenchmark(bool bWorkStealing)
+  {
+    ezTaskSystem::SetWorkStealingEnabled(bWorkStealing);
+
+    struct Spawners
+    {
+      ezBenchmarkSpawnerTask m_Tasks[NUM_SPAWNERS];
+    };
+
+    // tasks cannot be copied or moved, and are too large to put them all onto the stack
+    ezUniquePtr<Spawners> spawners = EZ_DEFAULT_NEW(Spawners);
+
+    ezDynamicArray<ezTime> latencies;
+    latencies.Reserve(NUM_FRAMES * NUM_SPAWNERS * NUM_CHILDREN);
+
+    BenchmarkResult res;
+    ezTime tTotal;
+
+    for (ezUInt32 frame = 0; frame < NUM_FRAMES; ++frame)
+    {
+      ezHybridArray<ezTaskGroupID, NUM_SPAWNERS> groups;
+
+      const ezTime t0 = ezTime::Now();
+
+      for (ezBenchmarkSpawnerTask& spawner : spawners->m_Tasks)
+      {
+        groups.PushBack(ezTaskSystem::StartSingleTask(&spawner, ezTaskPriority::ThisFrame));
+      }
+
+      for (const ezTaskGroupID& group : groups)
+      {
+        ezTaskSystem::WaitForGroup(group);
+      }
+
+      tTotal += ezTime::Now() - t0;
+
+      for (const ezBenchmarkSpawnerTask& spawner : spawners->m_Tasks)
+      {
+        for (const ezBenchmarkChildTask& child : spawner.m_Children)
+        {
+          if (child.m_bExecuted)
+          {
+            ++res.m_uiTasksExecuted;
+          }
+
+          latencies.PushBack(child.m_Latency);
+        }
+      }
+
+      ezTaskSystem::FinishFrameTasks();
+    }
+
+    latencies.Sort();
+
+    res.m_fTasksPerSecond = res.m_uiTasksExecuted / tTotal.GetSeconds();
+    res.m_MedianLatency = latencies[latencies.GetCount() / 2];
+    res.m_P99Latency = latencies[(latencies.GetCount() * 99) / 100];
+    res.m_MaxLatency = latencies.PeekBack();
+
+    ezTaskSystem::SetWorkStealingEnabled(true);
+    return res;
+  }
+} // namespace TaskSystemPerformanceTestDetail
+
+EZ_CREATE_SIMPLE_TEST(Performance, TaskSystem)
+{
+  using namespace TaskSystemPerformanceTestDetail;
+
+  const ezUInt32 uiPrevShortWorkers = ezTaskSystem::GetWorkerThreadCount(ezWorkerThreadType::ShortTasks);
+  const ezUInt32 uiPrevLongWorkers = ezTaskSystem::GetWorkerThreadCount(ezWorkerThreadType::LongTasks);
+  ezTaskSystem::SetWorkerThreadCount(-1, -1);
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Shared Queues vs. Work Stealing")
+  {
+    const ezUInt32 uiExpectedTasks = NUM_FRAMES * NUM_SPAWNERS * NUM_CHILDREN;
+
+    // warm up
+    RunSchedulerBenchmark(false);
+    RunSchedulerBenchmark(true);
+
+    const BenchmarkResult shared = RunSchedulerBenchmark(false);
+    const BenchmarkResult stealing = RunSchedulerBenchmark(true);
+
+    EZ_TEST_INT(shared.m_uiTasksExecuted, uiExpectedTasks);
+    EZ_TEST_INT(stealing.m_uiTasksExecuted, uiExpectedTasks);
+
+    ezLog::Info("[test]Shared Queues:  {0} tasks/sec, latency median {1}us, p99 {2}us, max {3}us", ezArgF(shared.m_fTasksPerSecond, 0),
+      ezArgF(shared.m_MedianLatency.GetMicroseconds(), 1), ezArgF(shared.m_P99Latency.GetMicroseconds(), 1), ezArgF(shared.m_MaxLatency.GetMicroseconds(), 1));
+    ezLog::Info("[test]Work Stealing:  {0} tasks/sec, latency median {1}us, p99 {2}us, max {3}us", ezArgF(stealing.m_fTasksPerSecond, 0),
+      ezArgF(stealing.m_MedianLatency.GetMicroseconds(), 1), ezArgF(stealing.m_P99Latency.GetMicroseconds(), 1), ezArgF(stealing.m_MaxLatency.GetMicroseconds(), 1));
+  }
+
+  ezTaskSystem::SetWorkerThreadCount(static_cast<ezInt8>(uiPrevShortWorkers), static_cast<ezInt8>(uiPrevLongWorkers));
+}
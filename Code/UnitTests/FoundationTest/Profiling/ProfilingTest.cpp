@@ -2,7 +2,10 @@
 
 #include <Foundation/IO/FileSystem/FileSystem.h>
 #include <Foundation/IO/FileSystem/FileWriter.h>
+#include <Foundation/IO/MemoryStream.h>
+#include <Foundation/IO/OSFile.h>
 #include <Foundation/Profiling/Profiling.h>
+#include <Foundation/Threading/Thread.h>
 #include <Foundation/Threading/ThreadUtils.h>
 
 namespace
@@ -20,6 +23,48 @@ namespace
       ezLog::Info("Profiling capture saved to '{0}'.", fileWriter.GetFilePathAbsolute().GetData());
     }
   }
+
+  void BusyWait(ezTime duration)
+  {
+    const ezTime endTime = ezTime::Now() + duration;
+    while (ezTime::Now() < endTime)
+    {
+    }
+  }
+
+  class ProfilingTestThread : public ezThread
+  {
+  public:
+    ProfilingTestThread()
+      : ezThread("Profiling Test Thread")
+    {
+    }
+
+  private:
+    virtual ezUInt32 Run() override
+    {
+      for (ezUInt32 i = 0; i < 10; ++i)
+      {
+        EZ_PROFILE_SCOPE("Thread scope");
+        BusyWait(ezTime::Milliseconds(1));
+      }
+
+      return 0;
+    }
+  };
+
+  ezString ConvertToJSON(ezMemoryStreamStorage& binaryCapture)
+  {
+    ezMemoryStreamReader reader(&binaryCapture);
+
+    ezMemoryStreamStorage jsonStorage;
+    ezMemoryStreamWriter writer(&jsonStorage);
+    EZ_TEST_BOOL(ezProfilingSystem::ConvertBinaryCaptureToJSON(reader, writer).Succeeded());
+
+    ezStringBuilder sJSON;
+    sJSON.SetSubString_ElementCount(reinterpret_cast<const char*>(jsonStorage.GetData()), jsonStorage.GetStorageSize());
+    return sJSON;
+  }
 }
 
 EZ_CREATE_SIMPLE_TEST_GROUP(Profiling);
@@ -51,4 +96,103 @@ EZ_CREATE_SIMPLE_TEST(Profiling, Profiling)
 
     WriteOutProfilingCapture(":output/profilingScopes.json");
   }
+
+#if EZ_ENABLED(EZ_USE_PROFILING)
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Binary capture")
+  {
+    ezProfilingSystem::Clear();
+
+    {
+      EZ_PROFILE_SCOPE("Binary outer scope");
+      EZ_PROFILE_SCOPE("Binary inner scope");
+      BusyWait(ezTime::Milliseconds(1));
+    }
+
+    ezMemoryStreamStorage binaryStorage;
+    ezMemoryStreamWriter binaryWriter(&binaryStorage);
+    EZ_TEST_BOOL(ezProfilingSystem::Capture().WriteBinary(binaryWriter).Succeeded());
+
+    const ezString sJSON = ConvertToJSON(binaryStorage);
+    EZ_TEST_BOOL(sJSON.FindSubString("\"Binary outer scope\"") != nullptr);
+    EZ_TEST_BOOL(sJSON.FindSubString("\"Binary inner scope\"") != nullptr);
+    EZ_TEST_BOOL(sJSON.FindSubString("\"Main Thread\"") != nullptr);
+
+    // the function name is shared by both scopes and stored only once
+    {
+      const char* szFunction = EZ_SOURCE_FUNCTION;
+      const ezUInt32 uiFunctionLength = ezStringUtils::GetStringElementCount(szFunction);
+
+      ezUInt32 uiNumOccurrences = 0;
+      for (ezUInt32 i = 0; i + uiFunctionLength <= binaryStorage.GetStorageSize(); ++i)
+      {
+        if (ezMemoryUtils::Compare(binaryStorage.GetData() + i, reinterpret_cast<const ezUInt8*>(szFunction), uiFunctionLength) == 0)
+          ++uiNumOccurrences;
+      }
+
+      EZ_TEST_INT(uiNumOccurrences, 1);
+    }
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Recording")
+  {
+    ezStringBuilder sFile = ezTestFramework::GetInstance()->GetAbsOutputPath();
+    EZ_TEST_BOOL(ezOSFile::CreateDirectoryStructure(sFile).Succeeded());
+    sFile.AppendPath("profilingRecording.ezProfiling");
+
+    EZ_TEST_BOOL(ezProfilingSystem::StartRecording(sFile).Succeeded());
+    EZ_TEST_BOOL(ezProfilingSystem::IsRecording());
+
+    ProfilingTestThread thread;
+    thread.Start();
+
+    for (ezUInt32 i = 0; i < 5; ++i)
+    {
+      ezProfilingSystem::StartNewFrame();
+
+      EZ_PROFILE_SCOPE("Recorded scope");
+      BusyWait(ezTime::Milliseconds(1));
+    }
+
+    // give the recording thread the chance to flush in between
+    ezThreadUtils::Sleep(ezTime::Milliseconds(150));
+
+    ezProfilingSystem::StartNewFrame();
+
+    thread.Join();
+
+    ezProfilingSystem::StopRecording();
+    EZ_TEST_BOOL(!ezProfilingSystem::IsRecording());
+
+    ezMemoryStreamStorage binaryStorage;
+    {
+      ezOSFile file;
+      EZ_TEST_BOOL(file.Open(sFile, ezFileOpenMode::Read).Succeeded());
+
+      ezDynamicArray<ezUInt8> content;
+      file.ReadAll(content);
+
+      ezMemoryStreamWriter writer(&binaryStorage);
+      writer.WriteBytes(content.GetData(), content.GetCount());
+    }
+
+    const ezString sJSON = ConvertToJSON(binaryStorage);
+    EZ_TEST_BOOL(sJSON.FindSubString("\"Recorded scope\"") != nullptr);
+    EZ_TEST_BOOL(sJSON.FindSubString("\"Thread scope\"") != nullptr);
+    EZ_TEST_BOOL(sJSON.FindSubString("\"Profiling Test Thread\"") != nullptr);
+    EZ_TEST_BOOL(sJSON.FindSubString("\"Frame ") != nullptr);
+
+    // scopes from before the recording started are not part of it
+    EZ_TEST_BOOL(sJSON.FindSubString("\"Binary outer scope\"") == nullptr);
+
+    // a truncated recording is still converted up to the last complete chunk
+    {
+      ezMemoryStreamStorage truncatedStorage;
+      ezMemoryStreamWriter writer(&truncatedStorage);
+      writer.WriteBytes(binaryStorage.GetData(), binaryStorage.GetStorageSize() - 3);
+
+      const ezString sTruncatedJSON = ConvertToJSON(truncatedStorage);
+      EZ_TEST_BOOL(sTruncatedJSON.EndsWith("]}"));
+    }
+  }
+#endif
 }
@@ -56,6 +56,49 @@ EZ_CREATE_SIMPLE_TEST(SimdMath, SimdVec4i)
     ezSimdVec4i vSetZero;
     vSetZero.SetZero();
     EZ_TEST_BOOL(vSetZero.x() == 0 && vSetZero.y() == 0 && vSetZero.z() == 0 && vSetZero.w() == 0);
+
+    {
+      ezInt32 testBlock[4] = {1, 2, 3, 4};
+
+      ezSimdVec4i x;
+      x.Load<1>(testBlock);
+      EZ_TEST_BOOL(x.x() == 1 && x.y() == 0 && x.z() == 0 && x.w() == 0);
+
+      ezSimdVec4i xy;
+      xy.Load<2>(testBlock);
+      EZ_TEST_BOOL(xy.x() == 1 && xy.y() == 2 && xy.z() == 0 && xy.w() == 0);
+
+      ezSimdVec4i xyz;
+      xyz.Load<3>(testBlock);
+      EZ_TEST_BOOL(xyz.x() == 1 && xyz.y() == 2 && xyz.z() == 3 && xyz.w() == 0);
+
+      ezSimdVec4i xyzw;
+      xyzw.Load<4>(testBlock);
+      EZ_TEST_BOOL(xyzw.x() == 1 && xyzw.y() == 2 && xyzw.z() == 3 && xyzw.w() == 4);
+    }
+
+    {
+      ezInt32 testBlock[4] = {7, 7, 7, 7};
+      ezInt32 mem[4] = {};
+
+      ezSimdVec4i b(1, 2, 3, 4);
+
+      memcpy(mem, testBlock, 16);
+      b.Store<1>(mem);
+      EZ_TEST_BOOL(mem[0] == 1 && mem[1] == 7 && mem[2] == 7 && mem[3] == 7);
+
+      memcpy(mem, testBlock, 16);
+      b.Store<2>(mem);
+      EZ_TEST_BOOL(mem[0] == 1 && mem[1] == 2 && mem[2] == 7 && mem[3] == 7);
+
+      memcpy(mem, testBlock, 16);
+      b.Store<3>(mem);
+      EZ_TEST_BOOL(mem[0] == 1 && mem[1] == 2 && mem[2] == 3 && mem[3] == 7);
+
+      memcpy(mem, testBlock, 16);
+      b.Store<4>(mem);
+      EZ_TEST_BOOL(mem[0] == 1 && mem[1] == 2 && mem[2] == 3 && mem[3] == 4);
+    }
   }
 
   EZ_TEST_BLOCK(ezTestBlock::Enabled, "Conversion")
@@ -0,0 +1,364 @@
+#include <FoundationTestPCH.h>
+
+#include <Foundation/Threading/TaskGraph.h>
+#include <Foundation/Threading/TaskSystem.h>
+#include <Foundation/Types/UniquePtr.h>
+#include <TestFramework/Utilities/TestLogInterface.h>
+
+namespace TaskGraphTestDetail
+{
+  class ezGraphTestTask final : public ezTask
+  {
+  public:
+    ezGraphTestTask() { ConfigureTask("ezGraphTestTask", ezTaskNesting::Never); }
+
+    ezAtomicInteger32* m_pExecutionCounter = nullptr;
+    ezHybridArray<const ezGraphTestTask*, 4> m_Dependencies;
+    ezUInt32 m_uiSleepMS = 0;
+
+    ezAtomicInteger32 m_iExecutionOrder = -1;
+    mutable ezAtomicInteger32 m_iNumInvocations;
+    mutable ezAtomicInteger32 m_iDependencyViolations;
+
+    void ResetResults()
+    {
+      m_iExecutionOrder = -1;
+      m_iNumInvocations = 0;
+      m_iDependencyViolations = 0;
+    }
+
+  private:
+    void CheckDependencies() const
+    {
+      for (const ezGraphTestTask* pDependency : m_Dependencies)
+      {
+        if (!pDependency->IsTaskFinished())
+        {
+          m_iDependencyViolations.Increment();
+        }
+      }
+    }
+
+    virtual void Execute() override
+    {
+      CheckDependencies();
+
+      if (m_uiSleepMS > 0)
+      {
+        ezThreadUtils::Sleep(ezTime::Milliseconds(m_uiSleepMS));
+      }
+
+      m_iNumInvocations.Increment();
+      m_iExecutionOrder = m_pExecutionCounter->Increment();
+    }
+
+    virtual void ExecuteWithMultiplicity(ezUInt32 uiInvocation) const override
+    {
+      CheckDependencies();
+      m_iNumInvocations.Increment();
+    }
+  };
+
+  struct ezGraphTestSetup
+  {
+    ezAtomicInteger32 m_iExecutionCounter;
+    ezGraphTestTask m_Tasks[64];
+    ezTaskGraph m_Graph;
+
+    ezUInt32 AddNode(ezUInt32 uiTask)
+    {
+      m_Tasks[uiTask].m_pExecutionCounter = &m_iExecutionCounter;
+      return m_Graph.AddNode(&m_Tasks[uiTask]);
+    }
+
+    void AddDependency(ezUInt32 uiNode, ezUInt32 uiDependsOnNode)
+    {
+      m_Graph.AddDependency(uiNode, uiDependsOnNode);
+      m_Tasks[uiNode].m_Dependencies.PushBack(&m_Tasks[uiDependsOnNode]);
+    }
+
+    void ResetResults(ezUInt32 uiNumTasks)
+    {
+      m_iExecutionCounter = 0;
+
+      for (ezUInt32 i = 0; i < uiNumTasks; ++i)
+      {
+        m_Tasks[i].ResetResults();
+      }
+    }
+
+    void CheckResults(ezUInt32 uiNumTasks)
+    {
+      for (ezUInt32 i = 0; i < uiNumTasks; ++i)
+      {
+        const ezGraphTestTask& task = m_Tasks[i];
+
+        EZ_TEST_BOOL(task.IsTaskFinished());
+        EZ_TEST_INT(task.m_iNumInvocations, ezMath::Max(1u, task.GetMultiplicity()));
+        EZ_TEST_INT(task.m_iDependencyViolations, 0);
+      }
+    }
+  };
+
+  /// Builds a graph with 8 layers of 8 nodes, where every node depends on two nodes of the previous layer.
+  void BuildLayeredGraph(ezGraphTestSetup& setup)
+  {
+    for (ezUInt32 i = 0; i < 64; ++i)
+    {
+      setup.AddNode(i);
+    }
+
+    for (ezUInt32 layer = 1; layer < 8; ++layer)
+    {
+      for (ezUInt32 i = 0; i < 8; ++i)
+      {
+        const ezUInt32 uiNode = layer * 8 + i;
+        setup.AddDependency(uiNode, (layer - 1) * 8 + i);
+        setup.AddDependency(uiNode, (layer - 1) * 8 + (i + 3) % 8);
+      }
+    }
+  }
+
+  class ezGraphStarterTask final : public ezTask
+  {
+  public:
+    ezGraphStarterTask() { ConfigureTask("ezGraphStarterTask", ezTaskNesting::Maybe); }
+
+    ezTaskGraph* m_pGraph = nullptr;
+
+  private:
+    virtual void Execute() override
+    {
+      ezTaskGroupID group = ezTaskSystem::StartTaskGraph(m_pGraph, ezTaskPriority::ThisFrame);
+      ezTaskSystem::WaitForGroup(group);
+    }
+  };
+} // namespace TaskGraphTestDetail
+
+EZ_CREATE_SIMPLE_TEST(Threading, TaskGraph)
+{
+  using namespace TaskGraphTestDetail;
+
+  ezTaskSystem::SetWorkerThreadCount(4, 4);
+
+  // tasks cannot be copied or moved, and are too large to put them all onto the stack
+  ezUniquePtr<ezGraphTestSetup> pSetup = EZ_DEFAULT_NEW(ezGraphTestSetup);
+  ezGraphTestSetup& setup = *pSetup;
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Finalize")
+  {
+    EZ_TEST_INT(setup.m_Graph.GetNodeCount(), 0);
+    EZ_TEST_BOOL(!setup.m_Graph.IsFinalized());
+    EZ_TEST_BOOL(setup.m_Graph.Finalize().Succeeded());
+    EZ_TEST_BOOL(setup.m_Graph.GetTopologicalOrder().IsEmpty());
+
+    for (ezUInt32 i = 0; i < 4; ++i)
+    {
+      EZ_TEST_INT(setup.AddNode(i), i);
+    }
+
+    setup.AddDependency(3, 1);
+    setup.AddDependency(3, 2);
+    setup.AddDependency(1, 0);
+    setup.AddDependency(2, 0);
+    setup.AddDependency(2, 0); // duplicates are ignored
+    EZ_TEST_BOOL(!setup.m_Graph.IsFinalized());
+
+    EZ_TEST_BOOL(setup.m_Graph.Finalize().Succeeded());
+    EZ_TEST_BOOL(setup.m_Graph.IsFinalized());
+    EZ_TEST_INT(setup.m_Graph.GetNodeCount(), 4);
+
+    ezArrayPtr<const ezUInt32> order = setup.m_Graph.GetTopologicalOrder();
+    EZ_TEST_INT(order.GetCount(), 4);
+    EZ_TEST_INT(order[0], 0);
+    EZ_TEST_INT(order[3], 3);
+
+    // introduce a cycle
+    setup.m_Graph.AddDependency(0, 3);
+    EZ_TEST_BOOL(!setup.m_Graph.IsFinalized());
+
+    {
+      ezTestLogInterface log;
+      ezTestLogSystemScope logSystemScope(&log);
+      log.ExpectMessage("is part of a dependency cycle", ezLogMsgType::ErrorMsg, 4);
+
+      EZ_TEST_BOOL(setup.m_Graph.Finalize().Failed());
+    }
+
+    EZ_TEST_BOOL(!setup.m_Graph.IsFinalized());
+
+    setup.m_Graph.Clear();
+    EZ_TEST_INT(setup.m_Graph.GetNodeCount(), 0);
+    EZ_TEST_BOOL(!setup.m_Graph.IsFinalized());
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Diamond")
+  {
+    setup.m_Graph.Clear();
+    for (ezUInt32 i = 0; i < 4; ++i)
+    {
+      setup.m_Tasks[i].m_Dependencies.Clear();
+      setup.m_Tasks[i].m_uiSleepMS = 5;
+      setup.AddNode(i);
+    }
+
+    setup.AddDependency(1, 0);
+    setup.AddDependency(2, 0);
+    setup.AddDependency(3, 1);
+    setup.AddDependency(3, 2);
+    EZ_TEST_BOOL(setup.m_Graph.Finalize().Succeeded());
+
+    setup.ResetResults(4);
+
+    ezTaskGroupID group = ezTaskSystem::StartTaskGraph(&setup.m_Graph, ezTaskPriority::ThisFrame);
+    ezTaskSystem::WaitForGroup(group);
+
+    EZ_TEST_BOOL(ezTaskSystem::IsTaskGroupFinished(group));
+    EZ_TEST_BOOL(!setup.m_Graph.IsRunning());
+    setup.CheckResults(4);
+
+    EZ_TEST_INT(setup.m_Tasks[0].m_iExecutionOrder, 1);
+    EZ_TEST_INT(setup.m_Tasks[3].m_iExecutionOrder, 4);
+
+    for (ezUInt32 i = 0; i < 4; ++i)
+    {
+      setup.m_Tasks[i].m_uiSleepMS = 0;
+    }
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Repeated Execution")
+  {
+    setup.m_Graph.Clear();
+    for (ezGraphTestTask& task : setup.m_Tasks)
+    {
+      task.m_Dependencies.Clear();
+    }
+
+    BuildLayeredGraph(setup);
+    EZ_TEST_BOOL(setup.m_Graph.Finalize().Succeeded());
+    EZ_TEST_INT(setup.m_Graph.GetTopologicalOrder().GetCount(), 64);
+
+    for (ezUInt32 frame = 0; frame < 20; ++frame)
+    {
+      setup.ResetResults(64);
+
+      ezTaskGroupID group = ezTaskSystem::StartTaskGraph(&setup.m_Graph, ezTaskPriority::ThisFrame);
+      ezTaskSystem::WaitForGroup(group);
+      EZ_TEST_BOOL(!setup.m_Graph.IsRunning());
+
+      setup.CheckResults(64);
+      EZ_TEST_INT(setup.m_iExecutionCounter, 64);
+
+      ezTaskSystem::FinishFrameTasks();
+    }
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Multiplicity")
+  {
+    setup.m_Tasks[8].SetMultiplicity(17);
+    setup.m_Tasks[40].SetMultiplicity(5);
+
+    setup.ResetResults(64);
+
+    ezTaskGroupID group = ezTaskSystem::StartTaskGraph(&setup.m_Graph, ezTaskPriority::LateThisFrame);
+    ezTaskSystem::WaitForGroup(group);
+
+    setup.CheckResults(64);
+    EZ_TEST_INT(setup.m_Tasks[8].m_iNumInvocations, 17);
+    EZ_TEST_INT(setup.m_Tasks[40].m_iNumInvocations, 5);
+
+    setup.m_Tasks[8].SetMultiplicity(0);
+    setup.m_Tasks[40].SetMultiplicity(0);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Group Dependencies")
+  {
+    setup.ResetResults(64);
+
+    ezGraphTestTask before;
+    ezGraphTestTask after;
+    ezAtomicInteger32 iCounter;
+    before.m_pExecutionCounter = &iCounter;
+    before.m_uiSleepMS = 10;
+    after.m_pExecutionCounter = &iCounter;
+
+    for (ezUInt32 i = 0; i < 64; ++i)
+    {
+      after.m_Dependencies.PushBack(&setup.m_Tasks[i]);
+
+      if (i < 8)
+      {
+        setup.m_Tasks[i].m_Dependencies.PushBack(&before);
+      }
+    }
+
+    ezTaskGroupID beforeGroup = ezTaskSystem::CreateTaskGroup(ezTaskPriority::ThisFrame);
+    ezTaskSystem::AddTaskToGroup(beforeGroup, &before);
+
+    ezTaskGroupID graphGroup = ezTaskSystem::CreateTaskGraphGroup(&setup.m_Graph, ezTaskPriority::ThisFrame);
+    ezTaskSystem::AddTaskGroupDependency(graphGroup, beforeGroup);
+
+    ezTaskGroupID afterGroup = ezTaskSystem::StartSingleTask(&after, ezTaskPriority::ThisFrame, graphGroup);
+
+    EZ_TEST_BOOL(setup.m_Graph.IsRunning());
+
+    ezTaskSystem::StartTaskGroup(graphGroup);
+    ezTaskSystem::StartTaskGroup(beforeGroup);
+
+    ezTaskSystem::WaitForGroup(afterGroup);
+
+    EZ_TEST_BOOL(ezTaskSystem::IsTaskGroupFinished(beforeGroup));
+    EZ_TEST_BOOL(ezTaskSystem::IsTaskGroupFinished(graphGroup));
+    EZ_TEST_INT(after.m_iDependencyViolations, 0);
+    setup.CheckResults(64);
+
+    for (ezUInt32 i = 0; i < 8; ++i)
+    {
+      setup.m_Tasks[i].m_Dependencies.PopBack();
+    }
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Started From Task")
+  {
+    ezGraphStarterTask starter;
+    starter.m_pGraph = &setup.m_Graph;
+
+    for (ezUInt32 frame = 0; frame < 5; ++frame)
+    {
+      setup.ResetResults(64);
+
+      ezTaskGroupID group = ezTaskSystem::StartSingleTask(&starter, ezTaskPriority::ThisFrame);
+      ezTaskSystem::WaitForGroup(group);
+
+      setup.CheckResults(64);
+    }
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Cancel")
+  {
+    setup.ResetResults(64);
+
+    for (ezUInt32 i = 0; i < 8; ++i)
+    {
+      setup.m_Tasks[i].m_uiSleepMS = 50;
+    }
+
+    ezTaskGroupID group = ezTaskSystem::StartTaskGraph(&setup.m_Graph, ezTaskPriority::ThisFrame);
+    ezTaskSystem::CancelGroup(group, ezOnTaskRunning::WaitTillFinished);
+
+    EZ_TEST_BOOL(ezTaskSystem::IsTaskGroupFinished(group));
+    EZ_TEST_BOOL(!setup.m_Graph.IsRunning());
+
+    // the last layer cannot have started before the first one was done, so it must have been skipped
+    for (ezUInt32 i = 56; i < 64; ++i)
+    {
+      EZ_TEST_BOOL(setup.m_Tasks[i].IsTaskFinished());
+      EZ_TEST_INT(setup.m_Tasks[i].m_iNumInvocations, 0);
+    }
+
+    for (ezUInt32 i = 0; i < 8; ++i)
+    {
+      setup.m_Tasks[i].m_uiSleepMS = 0;
+    }
+  }
+}
@@ -0,0 +1,279 @@
+#include <GameEngineTestPCH.h>
+
+#include <Foundation/Math/Random.h>
+#include <Foundation/Time/Time.h>
+#include <Foundation/Tracks/ColorGradient.h>
+#include <Foundation/Tracks/Curve1D.h>
+#include <ParticlePlugin/Module/ParticleKernels.h>
+
+EZ_CREATE_SIMPLE_TEST_GROUP(Particles);
+
+namespace
+{
+  enum constants
+  {
+#if EZ_ENABLED(EZ_COMPILE_FOR_DEBUG)
+    NUM_PARTICLES = 1024 * 16 + 3,
+    NUM_ITERATIONS = 8,
+#else
+    NUM_PARTICLES = 1024 * 64 + 3,
+    NUM_ITERATIONS = 64,
+#endif
+  };
+
+  template <typename Func>
+  void MeasureParticlesPerSecond(const char* szName, Func func)
+  {
+    const ezTime t0 = ezTime::Now();
+
+    for (ezUInt32 i = 0; i < NUM_ITERATIONS; ++i)
+    {
+      func();
+    }
+
+    const ezTime t1 = ezTime::Now();
+    const double fParticlesPerSecond = (double)NUM_PARTICLES * NUM_ITERATIONS / ezMath::Max((t1 - t0).GetSeconds(), 0.000001);
+
+    ezLog::Info("[test]{0}: {1} million particles per second", szName, ezArgF(fParticlesPerSecond / 1000000.0, 2));
+  }
+
+  void FillRandom(ezRandom& rng, ezDynamicArray<ezVec3>& out_Data)
+  {
+    out_Data.SetCountUninitialized(NUM_PARTICLES);
+    for (ezVec3& v : out_Data)
+    {
+      v.Set(rng.FloatMinMax(-10, 10), rng.FloatMinMax(-10, 10), rng.FloatMinMax(-10, 10));
+    }
+  }
+
+  void FillRandom(ezRandom& rng, ezDynamicArray<ezVec4>& out_Data)
+  {
+    out_Data.SetCountUninitialized(NUM_PARTICLES);
+    for (ezVec4& v : out_Data)
+    {
+      v.Set(rng.FloatMinMax(-10, 10), rng.FloatMinMax(-10, 10), rng.FloatMinMax(-10, 10), rng.FloatMinMax(0, 1));
+    }
+  }
+} // namespace
+
+EZ_CREATE_SIMPLE_TEST(Particles, Kernels)
+{
+  ezRandom rng;
+  rng.Initialize(42);
+
+  ezDynamicArray<ezVec3> velocity, velocityRef;
+  ezDynamicArray<ezVec4> position, positionRef;
+  FillRandom(rng, velocity);
+  FillRandom(rng, position);
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "AddVec3 (Gravity)")
+  {
+    const ezVec3 vAdd(0.1f, -0.2f, -9.81f * 0.016f);
+
+    velocityRef = velocity;
+    for (ezVec3& v : velocityRef)
+      v += vAdd;
+
+    ezParticleKernels::AddVec3(velocity.GetData(), velocity.GetCount(), vAdd);
+
+    for (ezUInt32 i = 0; i < velocity.GetCount(); ++i)
+    {
+      EZ_TEST_VEC3(velocity[i], velocityRef[i], 0.0001f);
+    }
+
+    MeasureParticlesPerSecond("Gravity (scalar)", [&]() {
+      for (ezVec3& v : velocityRef)
+        v += vAdd;
+    });
+
+    MeasureParticlesPerSecond("Gravity", [&]() { ezParticleKernels::AddVec3(velocity.GetData(), velocity.GetCount(), vAdd); });
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "AddVec4 / ScaleVec3 (Velocity)")
+  {
+    const ezSimdVec4f vAdd(0.01f, 0.02f, 0.03f, 0.0f);
+    const float fFriction = 0.99f;
+
+    positionRef = position;
+    velocityRef = velocity;
+    for (ezUInt32 i = 0; i < positionRef.GetCount(); ++i)
+    {
+      positionRef[i] += ezVec4(0.01f, 0.02f, 0.03f, 0.0f);
+      velocityRef[i] *= fFriction;
+    }
+
+    ezParticleKernels::AddVec4(position.GetData(), position.GetCount(), vAdd);
+    ezParticleKernels::ScaleVec3(velocity.GetData(), velocity.GetCount(), fFriction);
+
+    for (ezUInt32 i = 0; i < position.GetCount(); ++i)
+    {
+      EZ_TEST_VEC4(position[i], positionRef[i], 0.0001f);
+      EZ_TEST_VEC3(velocity[i], velocityRef[i], 0.0001f);
+    }
+
+    MeasureParticlesPerSecond("Velocity (scalar)", [&]() {
+      for (ezUInt32 i = 0; i < positionRef.GetCount(); ++i)
+      {
+        positionRef[i] += ezVec4(0.01f, 0.02f, 0.03f, 0.0f);
+        velocityRef[i] *= fFriction;
+      }
+    });
+
+    MeasureParticlesPerSecond("Velocity", [&]() {
+      ezParticleKernels::AddVec4(position.GetData(), position.GetCount(), vAdd);
+      ezParticleKernels::ScaleVec3(velocity.GetData(), velocity.GetCount(), fFriction);
+    });
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "ApplyVelocity")
+  {
+    const float fTimeDiff = 0.016f;
+
+    positionRef = position;
+    for (ezUInt32 i = 0; i < positionRef.GetCount(); ++i)
+    {
+      positionRef[i] += (velocity[i] * fTimeDiff).GetAsVec4(0.0f);
+    }
+
+    ezParticleKernels::ApplyVelocity(position.GetData(), velocity.GetData(), position.GetCount(), fTimeDiff);
+
+    for (ezUInt32 i = 0; i < position.GetCount(); ++i)
+    {
+      EZ_TEST_VEC4(position[i], positionRef[i], 0.0001f);
+    }
+
+    // sub-ranges that do not start at a multiple of four
+    ezParticleKernels::ApplyVelocity(position.GetData() + 1, velocity.GetData() + 1, 6, fTimeDiff);
+    for (ezUInt32 i = 1; i < 7; ++i)
+    {
+      positionRef[i] += (velocity[i] * fTimeDiff).GetAsVec4(0.0f);
+    }
+
+    for (ezUInt32 i = 0; i < 8; ++i)
+    {
+      EZ_TEST_VEC4(position[i], positionRef[i], 0.0001f);
+    }
+
+    MeasureParticlesPerSecond("ApplyVelocity (scalar)", [&]() {
+      for (ezUInt32 i = 0; i < positionRef.GetCount(); ++i)
+      {
+        reinterpret_cast<ezVec3&>(positionRef[i]) += velocity[i] * fTimeDiff;
+      }
+    });
+
+    MeasureParticlesPerSecond("ApplyVelocity", [&]() {
+      ezParticleKernels::ApplyVelocity(position.GetData(), velocity.GetData(), position.GetCount(), fTimeDiff);
+    });
+  }
+
+  ezDynamicArray<float> lifeTimeFraction;
+  lifeTimeFraction.SetCountUninitialized(NUM_PARTICLES);
+  for (float& f : lifeTimeFraction)
+  {
+    f = rng.FloatZeroToOneInclusive();
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Lookup Table (FadeOut)")
+  {
+    const float fExponent = 2.0f;
+
+    ezParticleLookupTable<float> table;
+    table.Sample([=](float x) { return ezMath::Pow(x, fExponent); });
+
+    EZ_TEST_FLOAT(table.Lookup(0.0f), 0.0f, 0.0001f);
+    EZ_TEST_FLOAT(table.Lookup(1.0f), 1.0f, 0.0001f);
+    EZ_TEST_FLOAT(table.Lookup(-1.0f), 0.0f, 0.0001f);
+    EZ_TEST_FLOAT(table.Lookup(2.0f), 1.0f, 0.0001f);
+    EZ_TEST_FLOAT(table.Lookup(ezMath::NaN<float>()), 0.0f, 0.0001f);
+
+    for (float f : lifeTimeFraction)
+    {
+      EZ_TEST_FLOAT(table.Lookup(f), ezMath::Pow(f, fExponent), 0.001f);
+    }
+
+    float fSum = 0.0f;
+
+    MeasureParticlesPerSecond("FadeOut (pow)", [&]() {
+      for (float f : lifeTimeFraction)
+        fSum += ezMath::Pow(f, fExponent);
+    });
+
+    MeasureParticlesPerSecond("FadeOut", [&]() {
+      for (float f : lifeTimeFraction)
+        fSum += table.Lookup(f);
+    });
+
+    EZ_TEST_BOOL(fSum > 0.0f);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Lookup Table (SizeCurve)")
+  {
+    ezCurve1D curve;
+    curve.AddControlPoint(0.0).m_Position.y = 0.0;
+    curve.AddControlPoint(0.3).m_Position.y = 1.0;
+    curve.AddControlPoint(0.7).m_Position.y = 0.5;
+    curve.AddControlPoint(1.0).m_Position.y = 2.0;
+    curve.SortControlPoints();
+    curve.CreateLinearApproximation();
+
+    ezParticleLookupTable<float> table;
+    table.Sample([&](float x) { return (float)curve.Evaluate(curve.ConvertNormalizedPos(x)); });
+
+    EZ_TEST_FLOAT(table.Lookup(0.0f), (float)curve.Evaluate(curve.ConvertNormalizedPos(0.0)), 0.001f);
+    EZ_TEST_FLOAT(table.Lookup(1.0f), (float)curve.Evaluate(curve.ConvertNormalizedPos(1.0)), 0.001f);
+
+    float fSum = 0.0f;
+
+    MeasureParticlesPerSecond("SizeCurve (curve)", [&]() {
+      for (float f : lifeTimeFraction)
+        fSum += (float)curve.Evaluate(curve.ConvertNormalizedPos(f));
+    });
+
+    MeasureParticlesPerSecond("SizeCurve", [&]() {
+      for (float f : lifeTimeFraction)
+        fSum += table.Lookup(f);
+    });
+
+    EZ_TEST_BOOL(fSum > 0.0f);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Lookup Table (ColorGradient)")
+  {
+    ezColorGradient gradient;
+    gradient.AddColorControlPoint(0.0, ezColorGammaUB(255, 0, 0));
+    gradient.AddColorControlPoint(0.5, ezColorGammaUB(0, 255, 0));
+    gradient.AddColorControlPoint(1.0, ezColorGammaUB(0, 0, 255));
+    gradient.AddAlphaControlPoint(0.0, 255);
+    gradient.AddAlphaControlPoint(1.0, 0);
+    gradient.SortControlPoints();
+
+    auto Evaluate = [&](float x) {
+      ezColor rgba;
+      ezUInt8 alpha;
+      gradient.EvaluateColor(x, rgba);
+      gradient.EvaluateAlpha(x, alpha);
+      rgba.a = ezMath::ColorByteToFloat(alpha);
+      return rgba;
+    };
+
+    ezParticleLookupTable<ezColor> table;
+    table.Sample(Evaluate);
+
+    EZ_TEST_BOOL(table.Lookup(0.0f).IsEqualRGBA(Evaluate(0.0f), 0.001f));
+    EZ_TEST_BOOL(table.Lookup(1.0f).IsEqualRGBA(Evaluate(1.0f), 0.001f));
+
+    ezColor sum = ezColor::Black;
+
+    MeasureParticlesPerSecond("ColorGradient (gradient)", [&]() {
+      for (float f : lifeTimeFraction)
+        sum += Evaluate(f);
+    });
+
+    MeasureParticlesPerSecond("ColorGradient", [&]() {
+      for (float f : lifeTimeFraction)
+        sum += table.Lookup(f);
+    });
+
+    EZ_TEST_BOOL(sum.r > 0.0f);
+  }
+}
@@ -0,0 +1,443 @@
+#include <GameEngineTestPCH.h>
+
+#include <Foundation/Math/Random.h>
+#include <ProcGenPlugin/VM/ExpressionByteCode.h>
+#include <ProcGenPlugin/VM/ExpressionCompiler.h>
+#include <ProcGenPlugin/VM/ExpressionVM.h>
+#include <TestFramework/Utilities/TestLogInterface.h>
+
+EZ_CREATE_SIMPLE_TEST_GROUP(ProcGen);
+
+namespace
+{
+  typedef ezExpressionAST::NodeType NT;
+
+  static ezUInt32 CountOpCodes(const ezExpressionByteCode& byteCode, const char* szOpCode)
+  {
+    ezStringBuilder sDisassembly;
+    byteCode.Disassemble(sDisassembly);
+
+    ezHybridArray<ezStringView, 32> lines;
+    sDisassembly.Split(false, lines, "\n");
+
+    ezStringBuilder sPrefix(szOpCode, " ");
+
+    ezUInt32 uiCount = 0;
+    for (const ezStringView& line : lines)
+    {
+      if (line.StartsWith(sPrefix))
+        ++uiCount;
+    }
+
+    return uiCount;
+  }
+
+  static ezResult Compile(ezExpressionAST& ast, ezExpressionByteCode& out_byteCode, bool bOptimize = true)
+  {
+    ezExpressionCompiler compiler;
+    return compiler.Compile(ast, out_byteCode, bOptimize);
+  }
+
+  /// Uses every operation that has an 8-wide implementation, as well as a few expressions that the optimizer can simplify.
+  static void BuildArithmeticAST(ezExpressionAST& ast)
+  {
+    auto a = ast.CreateInput(ezMakeHashedString("a"));
+    auto b = ast.CreateInput(ezMakeHashedString("b"));
+    auto c = ast.CreateInput(ezMakeHashedString("c"));
+
+    // a * b + c
+    auto pMulAdd = ast.CreateTernaryOperator(NT::MultiplyAdd, a, b, c);
+    ast.m_OutputNodes.PushBack(ast.CreateOutput(ezMakeHashedString("out0"), pMulAdd));
+
+    // (a - b) != 0 ? sqrt(abs(c)) : min(a, c) / max(b, 1.5)
+    auto pCondition = ast.CreateBinaryOperator(NT::Subtract, a, b);
+    auto pTrue = ast.CreateUnaryOperator(NT::Sqrt, ast.CreateUnaryOperator(NT::Absolute, c));
+    auto pFalse = ast.CreateBinaryOperator(NT::Divide, ast.CreateBinaryOperator(NT::Min, a, c),
+      ast.CreateBinaryOperator(NT::Max, b, ast.CreateConstant(1.5f)));
+    ast.m_OutputNodes.PushBack(ast.CreateOutput(ezMakeHashedString("out1"), ast.CreateSelect(pCondition, pTrue, pFalse)));
+
+    // -a * (2 * 1.5) + b * c - 4, the multiplications are fused into the additions
+    auto pNegA = ast.CreateUnaryOperator(NT::Negate, a);
+    auto pFolded = ast.CreateBinaryOperator(NT::Multiply, ast.CreateConstant(2.0f), ast.CreateConstant(1.5f));
+    auto pSum = ast.CreateBinaryOperator(NT::Add, ast.CreateBinaryOperator(NT::Multiply, pNegA, pFolded), ast.CreateBinaryOperator(NT::Multiply, b, c));
+    ast.m_OutputNodes.PushBack(ast.CreateOutput(ezMakeHashedString("out2"), ast.CreateBinaryOperator(NT::Subtract, pSum, ast.CreateConstant(4.0f))));
+
+    // (a + b) * (a + b) + (c * 1 + 0) / 1, with two separate nodes for a + b
+    auto pAddA = ast.CreateBinaryOperator(NT::Add, a, b);
+    auto pAddB = ast.CreateBinaryOperator(NT::Add, a, b);
+    auto pIdentity = ast.CreateBinaryOperator(NT::Divide,
+      ast.CreateBinaryOperator(NT::Add, ast.CreateBinaryOperator(NT::Multiply, c, ast.CreateConstant(1.0f)), ast.CreateConstant(0.0f)),
+      ast.CreateConstant(1.0f));
+    auto pSquare = ast.CreateBinaryOperator(NT::Add, ast.CreateBinaryOperator(NT::Multiply, pAddA, pAddB), pIdentity);
+    ast.m_OutputNodes.PushBack(ast.CreateOutput(ezMakeHashedString("out3"), pSquare));
+
+    // constants as left operand of every binary operation
+    auto pConstOps = ast.CreateBinaryOperator(NT::Subtract, ast.CreateConstant(2.0f), a);
+    pConstOps = ast.CreateBinaryOperator(NT::Multiply, ast.CreateConstant(0.5f), pConstOps);
+    pConstOps = ast.CreateBinaryOperator(NT::Divide, ast.CreateConstant(3.0f), ast.CreateBinaryOperator(NT::Max, ast.CreateConstant(0.25f), pConstOps));
+    pConstOps = ast.CreateBinaryOperator(NT::Min, ast.CreateConstant(100.0f), pConstOps);
+    ast.m_OutputNodes.PushBack(ast.CreateOutput(ezMakeHashedString("out4"), pConstOps));
+  }
+
+  struct ArithmeticData
+  {
+    static constexpr ezUInt32 NumOutputs = 5;
+
+    // not a multiple of 8, so the remainder of the 8-wide path is covered as well
+    static constexpr ezUInt32 NumInstances = 1003;
+
+    ArithmeticData()
+    {
+      ezRandom rnd;
+      rnd.Initialize(42);
+
+      for (ezUInt32 i = 0; i < 3; ++i)
+      {
+        m_Inputs[i].SetCountUninitialized(NumInstances);
+        for (float& f : m_Inputs[i])
+        {
+          f = rnd.FloatMinMax(-10.0f, 10.0f);
+        }
+      }
+
+      // some instances where a == b, so both sides of the select are used
+      for (ezUInt32 i = 0; i < NumInstances; i += 3)
+      {
+        m_Inputs[1][i] = m_Inputs[0][i];
+      }
+    }
+
+    void Execute(ezExpressionVM& vm, const ezExpressionByteCode& byteCode, ezDynamicArray<float> (&out_Outputs)[NumOutputs])
+    {
+      ezHashedString inputNames[] = {ezMakeHashedString("a"), ezMakeHashedString("b"), ezMakeHashedString("c")};
+      ezHybridArray<ezExpression::Stream, 3> inputs;
+      for (ezUInt32 i = 0; i < 3; ++i)
+      {
+        inputs.PushBack(ezExpression::MakeStream(m_Inputs[i].GetArrayPtr(), 0, inputNames[i]));
+      }
+
+      ezHybridArray<ezExpression::Stream, NumOutputs> outputs;
+      for (ezUInt32 i = 0; i < NumOutputs; ++i)
+      {
+        out_Outputs[i].Clear();
+        out_Outputs[i].SetCount(NumInstances);
+
+        ezStringBuilder sName;
+        sName.Format("out{}", i);
+
+        ezHashedString sHashedName;
+        sHashedName.Assign(sName.GetData());
+        outputs.PushBack(ezExpression::MakeStream(out_Outputs[i].GetArrayPtr(), 0, sHashedName));
+      }
+
+      EZ_TEST_BOOL(vm.Execute(byteCode, inputs, outputs, NumInstances).Succeeded());
+    }
+
+    ezDynamicArray<float> m_Inputs[3];
+  };
+} // namespace
+
+EZ_CREATE_SIMPLE_TEST(ProcGen, ExpressionVM)
+{
+  ezExpressionVM vm;
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Vector and Int Streams")
+  {
+    ezExpressionAST ast;
+
+    // ResultX = PositionX + Offset, ResultY = PositionY * 2, ResultZ = PositionZ, CountR = Offset * 3, CountG = PositionX
+    auto pOffset = ast.CreateInput(ezMakeHashedString("Offset"));
+    auto pPosX = ast.CreateInput(ezMakeHashedString("PositionX"));
+    auto pPosY = ast.CreateInput(ezMakeHashedString("PositionY"));
+    auto pPosZ = ast.CreateInput(ezMakeHashedString("PositionZ"));
+
+    ast.m_OutputNodes.PushBack(ast.CreateOutput(ezMakeHashedString("ResultX"), ast.CreateBinaryOperator(NT::Add, pPosX, pOffset)));
+    ast.m_OutputNodes.PushBack(ast.CreateOutput(ezMakeHashedString("ResultY"), ast.CreateBinaryOperator(NT::Multiply, pPosY, ast.CreateConstant(2.0f))));
+    ast.m_OutputNodes.PushBack(ast.CreateOutput(ezMakeHashedString("ResultZ"), pPosZ));
+    ast.m_OutputNodes.PushBack(ast.CreateOutput(ezMakeHashedString("CountR"), ast.CreateBinaryOperator(NT::Multiply, pOffset, ast.CreateConstant(3.0f))));
+    ast.m_OutputNodes.PushBack(ast.CreateOutput(ezMakeHashedString("CountG"), pPosX));
+
+    ezExpressionByteCode byteCode;
+    EZ_TEST_BOOL(Compile(ast, byteCode).Succeeded());
+
+    const ezUInt32 uiNumInstances = 13;
+
+    ezDynamicArray<ezVec3> positions;
+    ezDynamicArray<ezInt32> offsets;
+    for (ezUInt32 i = 0; i < uiNumInstances; ++i)
+    {
+      positions.PushBack(ezVec3(i + 0.5f, i * -2.0f, 100.0f + i));
+      offsets.PushBack(static_cast<ezInt32>(i) - 5);
+    }
+
+    ezDynamicArray<ezVec3> results;
+    results.SetCount(uiNumInstances);
+    ezDynamicArray<ezVec2I32> counts;
+    counts.SetCount(uiNumInstances);
+
+    ezHybridArray<ezExpression::Stream, 2> inputs;
+    inputs.PushBack(ezExpression::MakeStream(positions.GetArrayPtr(), 0, ezMakeHashedString("Position"), ezExpression::Stream::Type::Float3));
+    inputs.PushBack(ezExpression::MakeStream(offsets.GetArrayPtr(), 0, ezMakeHashedString("Offset"), ezExpression::Stream::Type::Int));
+
+    ezHybridArray<ezExpression::Stream, 2> outputs;
+    outputs.PushBack(ezExpression::MakeStream(results.GetArrayPtr(), 0, ezMakeHashedString("Result"), ezExpression::Stream::Type::Float3));
+    outputs.PushBack(ezExpression::MakeStream(counts.GetArrayPtr(), 0, ezMakeHashedString("Count"), ezExpression::Stream::Type::Int2));
+
+    EZ_TEST_BOOL(vm.Execute(byteCode, inputs, outputs, uiNumInstances).Succeeded());
+
+    for (ezUInt32 i = 0; i < uiNumInstances; ++i)
+    {
+      EZ_TEST_FLOAT(results[i].x, positions[i].x + offsets[i], 0.0f);
+      EZ_TEST_FLOAT(results[i].y, positions[i].y * 2.0f, 0.0f);
+      EZ_TEST_FLOAT(results[i].z, positions[i].z, 0.0f);
+
+      EZ_TEST_INT(counts[i].x, offsets[i] * 3);
+      // truncated towards zero
+      EZ_TEST_INT(counts[i].y, static_cast<ezInt32>(positions[i].x));
+    }
+
+    // a component that the stream doesn't have can't be mapped
+    ezExpressionAST ast2;
+    ast2.m_OutputNodes.PushBack(ast2.CreateOutput(ezMakeHashedString("ResultW"), ast2.CreateInput(ezMakeHashedString("PositionW"))));
+
+    ezExpressionByteCode byteCode2;
+    EZ_TEST_BOOL(Compile(ast2, byteCode2).Succeeded());
+
+    ezTestLogInterface log;
+    ezTestLogSystemScope logSystemScope(&log);
+    log.ExpectMessage("Bytecode expects an input 'PositionW'", ezLogMsgType::ErrorMsg);
+
+    EZ_TEST_BOOL(vm.Execute(byteCode2, inputs, outputs, uiNumInstances).Failed());
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "MulAdd / Select")
+  {
+    ezExpressionAST ast;
+
+    auto a = ast.CreateInput(ezMakeHashedString("a"));
+    auto b = ast.CreateInput(ezMakeHashedString("b"));
+    auto c = ast.CreateInput(ezMakeHashedString("c"));
+
+    ast.m_OutputNodes.PushBack(ast.CreateOutput(ezMakeHashedString("MulAdd"), ast.CreateTernaryOperator(NT::MultiplyAdd, a, b, c)));
+    ast.m_OutputNodes.PushBack(ast.CreateOutput(ezMakeHashedString("Select"), ast.CreateSelect(a, b, c)));
+
+    ezExpressionByteCode byteCode;
+    EZ_TEST_BOOL(Compile(ast, byteCode).Succeeded());
+    EZ_TEST_INT(CountOpCodes(byteCode, "MulAdd_RRR"), 1);
+    EZ_TEST_INT(CountOpCodes(byteCode, "Select_RRR"), 1);
+
+    float valuesA[] = {0.0f, 1.0f, -2.0f, -0.0f, ezMath::NaN<float>(), 3.0f, 0.0f, 0.5f, 4.0f};
+    float valuesB[] = {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f, 8.0f, 9.0f};
+    float valuesC[] = {-1.0f, -2.0f, -3.0f, -4.0f, -5.0f, -6.0f, -7.0f, -8.0f, -9.0f};
+    float mulAdd[EZ_ARRAY_SIZE(valuesA)] = {};
+    float select[EZ_ARRAY_SIZE(valuesA)] = {};
+
+    ezExpression::Stream inputs[] = {
+      ezExpression::MakeStream(ezMakeArrayPtr(valuesA), 0, ezMakeHashedString("a")),
+      ezExpression::MakeStream(ezMakeArrayPtr(valuesB), 0, ezMakeHashedString("b")),
+      ezExpression::MakeStream(ezMakeArrayPtr(valuesC), 0, ezMakeHashedString("c")),
+    };
+    ezExpression::Stream outputs[] = {
+      ezExpression::MakeStream(ezMakeArrayPtr(mulAdd), 0, ezMakeHashedString("MulAdd")),
+      ezExpression::MakeStream(ezMakeArrayPtr(select), 0, ezMakeHashedString("Select")),
+    };
+
+    for (bool bAVX : {false, true})
+    {
+      vm.SetAVXEnabled(bAVX);
+
+      EZ_TEST_BOOL(vm.Execute(byteCode, ezMakeArrayPtr(inputs), ezMakeArrayPtr(outputs), EZ_ARRAY_SIZE(valuesA)).Succeeded());
+
+      for (ezUInt32 i = 0; i < EZ_ARRAY_SIZE(valuesA); ++i)
+      {
+        if (ezMath::IsNaN(valuesA[i]))
+        {
+          EZ_TEST_BOOL(ezMath::IsNaN(mulAdd[i]));
+        }
+        else
+        {
+          EZ_TEST_FLOAT(mulAdd[i], valuesA[i] * valuesB[i] + valuesC[i], 0.0f);
+        }
+
+        // NaN counts as not zero, -0 as zero
+        const float fExpected = (valuesA[i] != 0.0f) ? valuesB[i] : valuesC[i];
+        EZ_TEST_FLOAT(select[i], fExpected, 0.0f);
+      }
+    }
+
+    vm.SetAVXEnabled(true);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Optimizer")
+  {
+    // constant folding
+    {
+      ezExpressionAST ast;
+      auto pConst = ast.CreateBinaryOperator(NT::Multiply, ast.CreateConstant(2.0f), ast.CreateUnaryOperator(NT::Negate, ast.CreateConstant(3.0f)));
+      auto pSelect = ast.CreateSelect(ast.CreateConstant(0.0f), ast.CreateInput(ezMakeHashedString("a")), pConst);
+      ast.m_OutputNodes.PushBack(ast.CreateOutput(ezMakeHashedString("out"), ast.CreateBinaryOperator(NT::Add, pSelect, ast.CreateConstant(1.0f))));
+
+      ezExpressionByteCode byteCode;
+      EZ_TEST_BOOL(Compile(ast, byteCode).Succeeded());
+
+      // everything is folded into one constant, the unused input is dropped
+      EZ_TEST_INT(byteCode.GetNumInstructions(), 2);
+      EZ_TEST_INT(CountOpCodes(byteCode, "Mov_C"), 1);
+      EZ_TEST_INT(byteCode.GetInputs().GetCount(), 0);
+
+      ezStringBuilder sDisassembly;
+      byteCode.Disassemble(sDisassembly);
+      EZ_TEST_BOOL(sDisassembly.FindSubString("-5.000000") != nullptr);
+    }
+
+    // identities
+    {
+      ezExpressionAST ast;
+      auto a = ast.CreateInput(ezMakeHashedString("a"));
+      auto pExpr = ast.CreateBinaryOperator(NT::Multiply, a, ast.CreateConstant(1.0f));
+      pExpr = ast.CreateBinaryOperator(NT::Add, ast.CreateConstant(0.0f), pExpr);
+      pExpr = ast.CreateBinaryOperator(NT::Divide, pExpr, ast.CreateConstant(1.0f));
+      pExpr = ast.CreateBinaryOperator(NT::Subtract, pExpr, ast.CreateConstant(0.0f));
+      ast.m_OutputNodes.PushBack(ast.CreateOutput(ezMakeHashedString("out"), pExpr));
+
+      ezExpressionByteCode byteCode;
+      EZ_TEST_BOOL(Compile(ast, byteCode).Succeeded());
+
+      EZ_TEST_INT(byteCode.GetNumInstructions(), 2);
+      EZ_TEST_INT(CountOpCodes(byteCode, "Mov_I"), 1);
+      EZ_TEST_INT(CountOpCodes(byteCode, "Mov_O"), 1);
+    }
+
+    // common subexpressions
+    {
+      ezExpressionAST ast;
+      auto a = ast.CreateInput(ezMakeHashedString("a"));
+      auto b = ast.CreateInput(ezMakeHashedString("b"));
+      auto pSinA = ast.CreateUnaryOperator(NT::Sin, ast.CreateBinaryOperator(NT::Add, a, b));
+      auto pSinB = ast.CreateUnaryOperator(NT::Sin, ast.CreateBinaryOperator(NT::Add, ast.CreateInput(ezMakeHashedString("a")), b));
+      ast.m_OutputNodes.PushBack(ast.CreateOutput(ezMakeHashedString("out0"), ast.CreateBinaryOperator(NT::Max, pSinA, pSinB)));
+      ast.m_OutputNodes.PushBack(ast.CreateOutput(ezMakeHashedString("out1"), ast.CreateUnaryOperator(NT::Sin, ast.CreateBinaryOperator(NT::Add, a, b))));
+
+      ezExpressionByteCode byteCode;
+      EZ_TEST_BOOL(Compile(ast, byteCode, false).Succeeded());
+      EZ_TEST_INT(CountOpCodes(byteCode, "Add_RR"), 3);
+      EZ_TEST_INT(CountOpCodes(byteCode, "Sin_R"), 3);
+
+      ezExpressionAST ast2;
+      a = ast2.CreateInput(ezMakeHashedString("a"));
+      b = ast2.CreateInput(ezMakeHashedString("b"));
+      pSinA = ast2.CreateUnaryOperator(NT::Sin, ast2.CreateBinaryOperator(NT::Add, a, b));
+      pSinB = ast2.CreateUnaryOperator(NT::Sin, ast2.CreateBinaryOperator(NT::Add, ast2.CreateInput(ezMakeHashedString("a")), b));
+      ast2.m_OutputNodes.PushBack(ast2.CreateOutput(ezMakeHashedString("out0"), ast2.CreateBinaryOperator(NT::Max, pSinA, pSinB)));
+      ast2.m_OutputNodes.PushBack(ast2.CreateOutput(ezMakeHashedString("out1"), ast2.CreateUnaryOperator(NT::Sin, ast2.CreateBinaryOperator(NT::Add, a, b))));
+
+      ezExpressionByteCode byteCode2;
+      EZ_TEST_BOOL(Compile(ast2, byteCode2).Succeeded());
+
+      // the duplicate input is merged first, which makes all three additions and sines identical
+      EZ_TEST_INT(CountOpCodes(byteCode2, "Add_RR"), 1);
+      EZ_TEST_INT(CountOpCodes(byteCode2, "Sin_R"), 1);
+      EZ_TEST_INT(CountOpCodes(byteCode2, "Mov_I"), 2);
+    }
+
+    // multiply-add fusion
+    {
+      ezExpressionAST ast;
+      auto a = ast.CreateInput(ezMakeHashedString("a"));
+      auto b = ast.CreateInput(ezMakeHashedString("b"));
+      auto c = ast.CreateInput(ezMakeHashedString("c"));
+
+      // fused
+      auto pMul = ast.CreateBinaryOperator(NT::Multiply, a, b);
+      ast.m_OutputNodes.PushBack(ast.CreateOutput(ezMakeHashedString("out0"), ast.CreateBinaryOperator(NT::Add, c, pMul)));
+
+      // not fused, since the multiplication with a constant operand is as fast
+      auto pMulConst = ast.CreateBinaryOperator(NT::Multiply, c, ast.CreateConstant(3.0f));
+      ast.m_OutputNodes.PushBack(ast.CreateOutput(ezMakeHashedString("out1"), ast.CreateBinaryOperator(NT::Add, pMulConst, a)));
+
+      // not fused, since the multiplication is used twice
+      auto pMulShared = ast.CreateBinaryOperator(NT::Multiply, b, c);
+      ast.m_OutputNodes.PushBack(ast.CreateOutput(ezMakeHashedString("out2"), ast.CreateBinaryOperator(NT::Add, pMulShared, a)));
+      ast.m_OutputNodes.PushBack(ast.CreateOutput(ezMakeHashedString("out3"), pMulShared));
+
+      ezExpressionByteCode byteCode;
+      EZ_TEST_BOOL(Compile(ast, byteCode).Succeeded());
+
+      EZ_TEST_INT(CountOpCodes(byteCode, "MulAdd_RRR"), 1);
+      EZ_TEST_INT(CountOpCodes(byteCode, "Mul_CR"), 1);
+      EZ_TEST_INT(CountOpCodes(byteCode, "Mul_RR"), 1);
+      EZ_TEST_INT(CountOpCodes(byteCode, "Add_RR"), 2);
+    }
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Optimized vs. Unoptimized")
+  {
+    ezExpressionAST ast;
+    BuildArithmeticAST(ast);
+    ezExpressionByteCode byteCode;
+    EZ_TEST_BOOL(Compile(ast, byteCode, true).Succeeded());
+
+    ezExpressionAST astUnoptimized;
+    BuildArithmeticAST(astUnoptimized);
+    ezExpressionByteCode byteCodeUnoptimized;
+    EZ_TEST_BOOL(Compile(astUnoptimized, byteCodeUnoptimized, false).Succeeded());
+
+    EZ_TEST_BOOL(byteCode.GetNumInstructions() < byteCodeUnoptimized.GetNumInstructions());
+    EZ_TEST_INT(CountOpCodes(byteCodeUnoptimized, "MulAdd_RRR"), 1);
+    EZ_TEST_BOOL(CountOpCodes(byteCode, "MulAdd_RRR") > 1);
+
+    ArithmeticData data;
+    ezDynamicArray<float> results[ArithmeticData::NumOutputs];
+    ezDynamicArray<float> resultsUnoptimized[ArithmeticData::NumOutputs];
+
+    data.Execute(vm, byteCode, results);
+    data.Execute(vm, byteCodeUnoptimized, resultsUnoptimized);
+
+    for (ezUInt32 i = 0; i < ArithmeticData::NumOutputs; ++i)
+    {
+      for (ezUInt32 j = 0; j < ArithmeticData::NumInstances; ++j)
+      {
+        // the optimizations may change the order of operations slightly
+        const float fEpsilon = ezMath::Max(1.0f, ezMath::Abs(resultsUnoptimized[i][j])) * 1e-5f;
+        EZ_TEST_FLOAT_MSG(results[i][j], resultsUnoptimized[i][j], fEpsilon, "out%u instance %u", i, j);
+      }
+    }
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "AVX vs. 4-wide")
+  {
+    if (!ezExpressionVM::IsAVXSupported())
+    {
+      ezTestFramework::Output(ezTestOutput::Message, "The CPU does not support AVX2, only the 4-wide path is tested.");
+      return;
+    }
+
+    for (bool bOptimize : {false, true})
+    {
+      ezExpressionAST ast;
+      BuildArithmeticAST(ast);
+      ezExpressionByteCode byteCode;
+      EZ_TEST_BOOL(Compile(ast, byteCode, bOptimize).Succeeded());
+
+      ArithmeticData data;
+      ezDynamicArray<float> results4[ArithmeticData::NumOutputs];
+      ezDynamicArray<float> results8[ArithmeticData::NumOutputs];
+
+      vm.SetAVXEnabled(false);
+      data.Execute(vm, byteCode, results4);
+
+      vm.SetAVXEnabled(true);
+      EZ_TEST_BOOL(vm.IsAVXEnabled());
+      data.Execute(vm, byteCode, results8);
+
+      // both paths use the same IEEE operations and neither fuses the multiply-add, so the results have to be identical
+      for (ezUInt32 i = 0; i < ArithmeticData::NumOutputs; ++i)
+      {
+        for (ezUInt32 j = 0; j < ArithmeticData::NumInstances; ++j)
+        {
+          EZ_TEST_FLOAT_MSG(results8[i][j], results4[i][j], 0.0f, "out%u instance %u", i, j);
+        }
+      }
+    }
+  }
+}
@@ -0,0 +1,129 @@
+#include <GameEngineTestPCH.h>
+
+#include <Core/ResourceManager/ResourceManager.h>
+#include <Foundation/Utilities/Progress.h>
+#include <Recast/DetourNavMesh.h>
+#include <RecastPlugin/NavMeshBuilder/NavMeshBuilder.h>
+#include <RecastPlugin/Resources/RecastNavMeshResource.h>
+#include <RecastPlugin/WorldModule/RecastWorldModule.h>
+
+EZ_CREATE_SIMPLE_TEST_GROUP(Recast);
+
+namespace
+{
+  void CreateGeometry(ezWorldGeoExtractionUtil::Geometry& geo, const ezVec3& vObstaclePos)
+  {
+    geo.m_BoxShapes.Clear();
+
+    // a 16 x 16 floor, which is split into 4 x 4 tiles
+    auto& floor = geo.m_BoxShapes.ExpandAndGetRef();
+    floor.m_vPosition.Set(8, 8, -0.5f);
+    floor.m_qRotation.SetIdentity();
+    floor.m_vHalfExtents.Set(8, 8, 0.5f);
+
+    // a small obstacle that only affects tile (0, 0), including the border around the tile
+    auto& obstacle = geo.m_BoxShapes.ExpandAndGetRef();
+    obstacle.m_vPosition = vObstaclePos;
+    obstacle.m_qRotation.SetIdentity();
+    obstacle.m_vHalfExtents.Set(0.25f, 0.25f, 0.5f);
+  }
+} // namespace
+
+EZ_CREATE_SIMPLE_TEST(Recast, NavMeshTiles)
+{
+  ezRecastConfig config;
+  config.m_fTileSize = 4.0f;
+
+  ezRecastNavMeshBuilder builder;
+  ezWorldGeoExtractionUtil::Geometry geo;
+  ezProgress progress;
+
+  ezRecastNavMeshResourceHandle hNavMesh;
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Initial Build")
+  {
+    CreateGeometry(geo, ezVec3(1.5f, 1.5f, 0.5f));
+
+    ezRecastNavMeshResourceDescriptor desc;
+    EZ_TEST_BOOL(builder.Build(config, geo, desc, progress).Succeeded());
+
+    EZ_TEST_BOOL(builder.HasTileGridChanged());
+    EZ_TEST_INT(builder.GetChangedTiles().GetCount(), 16);
+    EZ_TEST_INT(desc.m_Tiles.GetCount(), 16);
+
+    hNavMesh = ezResourceManager::CreateResource<ezRecastNavMeshResource>("RecastTest_NavMeshTiles", std::move(desc));
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Unchanged Geometry")
+  {
+    ezRecastNavMeshResourceDescriptor desc;
+    EZ_TEST_BOOL(builder.Build(config, geo, desc, progress).Succeeded());
+
+    EZ_TEST_BOOL(!builder.HasTileGridChanged());
+    EZ_TEST_INT(builder.GetChangedTiles().GetCount(), 0);
+    EZ_TEST_INT(desc.m_Tiles.GetCount(), 16);
+  }
+
+  ezWorldDesc worldDesc("RecastTest");
+  ezWorld world(worldDesc);
+  EZ_LOCK(world.GetWriteMarker());
+
+  ezRecastWorldModule* pModule = world.GetOrCreateModule<ezRecastWorldModule>();
+  pModule->SetNavMeshResource(hNavMesh);
+  world.Update();
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Swap Changed Tile")
+  {
+    const dtNavMesh* pNavMesh = pModule->GetDetourNavMesh();
+    if (EZ_TEST_BOOL(pNavMesh != nullptr).Failed())
+      return;
+
+    dtTileRef tileRefs[4][4];
+    for (int y = 0; y < 4; ++y)
+    {
+      for (int x = 0; x < 4; ++x)
+      {
+        tileRefs[y][x] = pNavMesh->getTileRefAt(x, y, 0);
+        EZ_TEST_BOOL(tileRefs[y][x] != 0);
+      }
+    }
+
+    const ezUInt32 uiChangeCounter = pModule->GetNavMeshChangeCounter();
+
+    // move the obstacle within tile (0, 0)
+    CreateGeometry(geo, ezVec3(2.0f, 2.0f, 0.5f));
+
+    ezRecastNavMeshResourceDescriptor desc;
+    EZ_TEST_BOOL(builder.Build(config, geo, desc, progress).Succeeded());
+
+    EZ_TEST_BOOL(!builder.HasTileGridChanged());
+    EZ_TEST_INT(builder.GetChangedTiles().GetCount(), 1);
+    EZ_TEST_BOOL(builder.GetChangedTiles()[0] == ezVec2I32(0, 0));
+
+    {
+      ezResourceLock<ezRecastNavMeshResource> pResource(hNavMesh, ezResourceAcquireMode::PointerOnly);
+      pResource.GetPointerNonConst()->QueueTileReplacement(std::move(desc), builder.GetChangedTiles());
+    }
+
+    // the tiles are swapped in by the synchronous update of the world module
+    EZ_TEST_BOOL(pModule->GetDetourNavMesh()->getTileRefAt(0, 0, 0) == tileRefs[0][0]);
+
+    world.Update();
+
+    EZ_TEST_BOOL(pModule->GetDetourNavMesh() == pNavMesh);
+    EZ_TEST_INT(pModule->GetNavMeshChangeCounter(), uiChangeCounter + 1);
+
+    for (int y = 0; y < 4; ++y)
+    {
+      for (int x = 0; x < 4; ++x)
+      {
+        const dtTileRef tileRef = pNavMesh->getTileRefAt(x, y, 0);
+        EZ_TEST_BOOL(tileRef != 0);
+
+        // a replaced tile gets a new salt, so its reference changes
+        const bool bReplaced = (x == 0 && y == 0);
+        EZ_TEST_BOOL((tileRef != tileRefs[y][x]) == bReplaced);
+      }
+    }
+  }
+}
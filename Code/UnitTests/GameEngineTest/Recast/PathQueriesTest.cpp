@@ -0,0 +1,216 @@
+#include <GameEngineTestPCH.h>
+
+#include <Core/ResourceManager/ResourceManager.h>
+#include <Foundation/Configuration/CVar.h>
+#include <Foundation/Utilities/Progress.h>
+#include <Recast/DetourNavMesh.h>
+#include <RecastPlugin/NavMeshBuilder/NavMeshBuilder.h>
+#include <RecastPlugin/Resources/RecastNavMeshResource.h>
+#include <RecastPlugin/WorldModule/RecastWorldModule.h>
+
+namespace
+{
+  void CreateGeometry(ezWorldGeoExtractionUtil::Geometry& geo, const ezVec3& vObstaclePos)
+  {
+    geo.m_BoxShapes.Clear();
+
+    // a 16 x 16 floor, which is split into 4 x 4 tiles
+    auto& floor = geo.m_BoxShapes.ExpandAndGetRef();
+    floor.m_vPosition.Set(8, 8, -0.5f);
+    floor.m_qRotation.SetIdentity();
+    floor.m_vHalfExtents.Set(8, 8, 0.5f);
+
+    // a wall through the middle, paths from one side to the other have to go around it
+    auto& wall = geo.m_BoxShapes.ExpandAndGetRef();
+    wall.m_vPosition = vObstaclePos;
+    wall.m_qRotation.SetIdentity();
+    wall.m_vHalfExtents.Set(0.25f, 6.0f, 1.0f);
+  }
+
+  ezRecastPathQueryState::Enum WaitForPath(ezWorld& world, ezRecastWorldModule* pModule, ezUInt32 uiQueryID, ezRecastPathQueryResult& out_Result, ezUInt32& out_uiNumFrames)
+  {
+    for (out_uiNumFrames = 1; out_uiNumFrames <= 1000; ++out_uiNumFrames)
+    {
+      world.Update();
+
+      const ezRecastPathQueryState::Enum state = pModule->RetrievePathQueryResult(uiQueryID, out_Result);
+      if (state != ezRecastPathQueryState::Pending)
+        return state;
+    }
+
+    return ezRecastPathQueryState::Pending;
+  }
+} // namespace
+
+EZ_CREATE_SIMPLE_TEST(Recast, PathQueries)
+{
+  ezCVarInt* pIterationsPerFrame = static_cast<ezCVarInt*>(ezCVar::FindCVarByName("ai_PathQueryIterationsPerFrame"));
+  ezCVarInt* pMaxCorridorLength = static_cast<ezCVarInt*>(ezCVar::FindCVarByName("ai_MaxPathCorridorLength"));
+  if (EZ_TEST_BOOL(pIterationsPerFrame != nullptr && pMaxCorridorLength != nullptr).Failed())
+    return;
+
+  const ezInt32 iPrevIterationsPerFrame = *pIterationsPerFrame;
+  const ezInt32 iPrevMaxCorridorLength = *pMaxCorridorLength;
+
+  ezRecastConfig config;
+  config.m_fTileSize = 4.0f;
+
+  ezRecastNavMeshBuilder builder;
+  ezWorldGeoExtractionUtil::Geometry geo;
+  ezProgress progress;
+
+  CreateGeometry(geo, ezVec3(8.0f, 6.0f, 1.0f));
+
+  ezRecastNavMeshResourceDescriptor desc;
+  if (EZ_TEST_BOOL(builder.Build(config, geo, desc, progress).Succeeded()).Failed())
+    return;
+
+  ezRecastNavMeshResourceHandle hNavMesh = ezResourceManager::CreateResource<ezRecastNavMeshResource>("RecastTest_PathQueries", std::move(desc));
+
+  ezWorldDesc worldDesc("RecastPathQueryTest");
+  ezWorld world(worldDesc);
+  EZ_LOCK(world.GetWriteMarker());
+
+  ezRecastWorldModule* pModule = world.GetOrCreateModule<ezRecastWorldModule>();
+  pModule->SetNavMeshResource(hNavMesh);
+  world.Update();
+
+  if (EZ_TEST_BOOL(pModule->GetDetourNavMesh() != nullptr).Failed())
+    return;
+
+  const ezVec3 vStart(2.0f, 2.0f, 0.0f);
+  const ezVec3 vTarget(14.0f, 2.0f, 0.0f);
+
+  ezRecastPathQueryResult result;
+  ezUInt32 uiNumFrames = 0;
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Full Path")
+  {
+    const ezUInt32 uiQueryID = pModule->RequestPath(vStart, vTarget);
+    EZ_TEST_INT(WaitForPath(world, pModule, uiQueryID, result, uiNumFrames), ezRecastPathQueryState::FullPath);
+
+    // with the default budget the search finishes in the first frame
+    EZ_TEST_INT(uiNumFrames, 1);
+    EZ_TEST_BOOL(result.m_PathCorridor.GetCount() > 1);
+    EZ_TEST_BOOL(result.m_PathCorridor[0] == result.m_StartPoly);
+    EZ_TEST_BOOL(result.m_PathCorridor.PeekBack() == result.m_EndPoly);
+
+    // the result is retrieved only once
+    EZ_TEST_INT(pModule->RetrievePathQueryResult(uiQueryID, result), ezRecastPathQueryState::Pending);
+  }
+
+  const ezUInt32 uiFullCorridorLength = result.m_PathCorridor.GetCount();
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Invalid Positions")
+  {
+    const ezUInt32 uiStartOutside = pModule->RequestPath(ezVec3(-10.0f, 2.0f, 0.0f), vTarget);
+    const ezUInt32 uiTargetOutside = pModule->RequestPath(vStart, ezVec3(30.0f, 2.0f, 0.0f));
+
+    EZ_TEST_INT(WaitForPath(world, pModule, uiStartOutside, result, uiNumFrames), ezRecastPathQueryState::StartOutsideNavMesh);
+    EZ_TEST_INT(WaitForPath(world, pModule, uiTargetOutside, result, uiNumFrames), ezRecastPathQueryState::InvalidTarget);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Sliced Search")
+  {
+    // a single iteration per frame, the search is spread over many frames
+    *pIterationsPerFrame = 1;
+
+    const ezUInt32 uiQueryID = pModule->RequestPath(vStart, vTarget);
+    EZ_TEST_INT(WaitForPath(world, pModule, uiQueryID, result, uiNumFrames), ezRecastPathQueryState::FullPath);
+
+    EZ_TEST_BOOL(uiNumFrames >= uiFullCorridorLength);
+    EZ_TEST_INT(result.m_PathCorridor.GetCount(), uiFullCorridorLength);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Shared Budget")
+  {
+    // more queries than slots, they all finish with the budget split between them
+    *pIterationsPerFrame = 64;
+
+    ezHybridArray<ezUInt32, 32> queryIDs;
+    for (ezUInt32 i = 0; i < 32; ++i)
+    {
+      queryIDs.PushBack(pModule->RequestPath(vStart, vTarget));
+    }
+
+    for (ezUInt32 uiQueryID : queryIDs)
+    {
+      EZ_TEST_INT(WaitForPath(world, pModule, uiQueryID, result, uiNumFrames), ezRecastPathQueryState::FullPath);
+    }
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Cancel")
+  {
+    *pIterationsPerFrame = 1;
+
+    // one query is cancelled while it is processed, the other one while it is still queued
+    const ezUInt32 uiRunningQueryID = pModule->RequestPath(vStart, vTarget);
+    world.Update();
+
+    const ezUInt32 uiQueuedQueryID = pModule->RequestPath(vStart, vTarget);
+    pModule->CancelPathQuery(uiRunningQueryID);
+    pModule->CancelPathQuery(uiQueuedQueryID);
+
+    // the searches would have finished by now, but there are no results
+    for (ezUInt32 i = 0; i < uiFullCorridorLength * 2; ++i)
+    {
+      world.Update();
+    }
+
+    EZ_TEST_INT(pModule->RetrievePathQueryResult(uiRunningQueryID, result), ezRecastPathQueryState::Pending);
+    EZ_TEST_INT(pModule->RetrievePathQueryResult(uiQueuedQueryID, result), ezRecastPathQueryState::Pending);
+
+    // the slots are free again
+    *pIterationsPerFrame = iPrevIterationsPerFrame;
+
+    const ezUInt32 uiQueryID = pModule->RequestPath(vStart, vTarget);
+    EZ_TEST_INT(WaitForPath(world, pModule, uiQueryID, result, uiNumFrames), ezRecastPathQueryState::FullPath);
+    EZ_TEST_INT(uiNumFrames, 1);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Corridor Length")
+  {
+    // the corridor is cut off, the path ends before the target
+    EZ_TEST_BOOL(uiFullCorridorLength > 2);
+    *pMaxCorridorLength = 2;
+
+    const ezUInt32 uiQueryID = pModule->RequestPath(vStart, vTarget);
+    EZ_TEST_INT(WaitForPath(world, pModule, uiQueryID, result, uiNumFrames), ezRecastPathQueryState::PartialPath);
+    EZ_TEST_INT(result.m_PathCorridor.GetCount(), 2);
+
+    *pMaxCorridorLength = iPrevMaxCorridorLength;
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Tile Replacement")
+  {
+    *pIterationsPerFrame = 1;
+
+    const ezUInt32 uiQueryID = pModule->RequestPath(vStart, vTarget);
+    world.Update();
+
+    // move the wall, the running search is restarted on the new tiles
+    CreateGeometry(geo, ezVec3(9.0f, 6.0f, 1.0f));
+
+    ezRecastNavMeshResourceDescriptor newDesc;
+    EZ_TEST_BOOL(builder.Build(config, geo, newDesc, progress).Succeeded());
+
+    {
+      ezResourceLock<ezRecastNavMeshResource> pResource(hNavMesh, ezResourceAcquireMode::PointerOnly);
+      pResource.GetPointerNonConst()->QueueTileReplacement(std::move(newDesc), builder.GetChangedTiles());
+    }
+
+    const ezUInt32 uiChangeCounter = pModule->GetNavMeshChangeCounter();
+
+    EZ_TEST_INT(WaitForPath(world, pModule, uiQueryID, result, uiNumFrames), ezRecastPathQueryState::FullPath);
+    EZ_TEST_INT(pModule->GetNavMeshChangeCounter(), uiChangeCounter + 1);
+
+    // the corridor only contains polygons of the current navmesh
+    for (dtPolyRef polyRef : result.m_PathCorridor)
+    {
+      EZ_TEST_BOOL(pModule->GetDetourNavMesh()->isValidPolyRef(polyRef));
+    }
+  }
+
+  *pIterationsPerFrame = iPrevIterationsPerFrame;
+  *pMaxCorridorLength = iPrevMaxCorridorLength;
+}
@@ -0,0 +1,256 @@
+#include <RendererNullTestPCH.h>
+
+#include <Foundation/Math/Random.h>
+#include <RendererCore/Meshes/MeshComponentBase.h>
+#include <RendererCore/Pipeline/ExtractedRenderData.h>
+
+namespace
+{
+  // Spreads the 32 bit sorting key over all 64 bits, such that the radix sort has to look at every byte.
+  // Multiplying with an odd constant is a bijection, so equal keys stay equal.
+  ezUInt64 SortByScrambledKey(const ezRenderData* pRenderData, ezUInt32 uiRenderDataSortingKey, const ezCamera& camera)
+  {
+    return ezUInt64(uiRenderDataSortingKey) * 0x9E3779B97F4A7C15ull;
+  }
+
+  struct TestData
+  {
+    TestData(ezUInt32 uiCount)
+    {
+      // the arrays are never resized, the extracted render data points into them
+      m_RenderData.SetCount(uiCount);
+      m_MeshRenderData.SetCount(uiCount);
+      m_Order.SetCount(uiCount);
+    }
+
+    ezRenderData* Get(ezUInt32 uiIndex, bool bMeshRenderData)
+    {
+      ezRenderData* pRenderData = bMeshRenderData ? &m_MeshRenderData[uiIndex] : &m_RenderData[uiIndex];
+      m_Order[uiIndex] = pRenderData;
+      return pRenderData;
+    }
+
+    ezDynamicArray<ezRenderData> m_RenderData;
+    ezDynamicArray<ezMeshRenderData> m_MeshRenderData;
+
+    // the render data in the order in which it was added
+    ezDynamicArray<const ezRenderData*> m_Order;
+  };
+
+  struct ReferenceEntry
+  {
+    EZ_DECLARE_POD_TYPE();
+
+    ezUInt64 m_uiSortingKey;
+    ezUInt32 m_uiBatchId;
+    ezUInt32 m_uiIndex;
+    const ezRenderData* m_pRenderData;
+  };
+
+  // The order that both sorts have to produce, ties are broken by the order in which the render data was added.
+  struct ReferenceComparer
+  {
+    EZ_ALWAYS_INLINE bool Less(const ReferenceEntry& a, const ReferenceEntry& b) const
+    {
+      if (a.m_uiSortingKey != b.m_uiSortingKey)
+        return a.m_uiSortingKey < b.m_uiSortingKey;
+
+      if (a.m_uiBatchId != b.m_uiBatchId)
+        return a.m_uiBatchId < b.m_uiBatchId;
+
+      return a.m_uiIndex < b.m_uiIndex;
+    }
+  };
+
+  // below this count ezExtractedRenderData uses a comparison sort
+  constexpr ezUInt32 s_uiMinRadixSortCount = 256;
+
+  void CheckSortAndBatch(ezExtractedRenderData& extractedData, ezRenderData::Category category, const TestData& testData)
+  {
+    const ezUInt32 uiCount = testData.m_Order.GetCount();
+
+    ezDynamicArray<ReferenceEntry> reference;
+    reference.SetCountUninitialized(uiCount);
+    for (ezUInt32 i = 0; i < uiCount; ++i)
+    {
+      const ezRenderData* pRenderData = testData.m_Order[i];
+      reference[i] = {pRenderData->GetCategorySortingKey(category, extractedData.GetCamera()), pRenderData->m_uiBatchId, i, pRenderData};
+    }
+    reference.Sort(ReferenceComparer());
+
+    ezRenderDataBatchList batchList = extractedData.GetRenderDataBatchesWithCategory(category);
+
+    ezDynamicArray<const ezRenderData*> sorted;
+    for (ezUInt32 uiBatch = 0; uiBatch < batchList.GetBatchCount(); ++uiBatch)
+    {
+      ezRenderDataBatch batch = batchList.GetBatch(uiBatch);
+      EZ_TEST_BOOL(batch.GetCount() > 0);
+
+      // all render data in a batch has the same batch id and type ...
+      const ezRenderData* pFirst = batch.GetFirstData<ezRenderData>();
+      for (auto it = batch.GetIterator<ezRenderData>(); it.IsValid(); ++it)
+      {
+        EZ_TEST_INT(it->m_uiBatchId, pFirst->m_uiBatchId);
+        EZ_TEST_BOOL(it->GetDynamicRTTI() == pFirst->GetDynamicRTTI());
+        sorted.PushBack(it);
+      }
+
+      // ... and a new batch is only started if one of them changes
+      if (uiBatch > 0)
+      {
+        const ezRenderData* pPrevLast = sorted[sorted.GetCount() - batch.GetCount() - 1];
+        EZ_TEST_BOOL(pPrevLast->m_uiBatchId != pFirst->m_uiBatchId || pPrevLast->GetDynamicRTTI() != pFirst->GetDynamicRTTI());
+      }
+    }
+
+    if (EZ_TEST_INT(sorted.GetCount(), uiCount).Failed())
+      return;
+
+    for (ezUInt32 i = 0; i < uiCount; ++i)
+    {
+      if (uiCount < s_uiMinRadixSortCount)
+      {
+        // the comparison sort is not stable, only the keys have to match
+        EZ_TEST_BOOL(sorted[i]->GetCategorySortingKey(category, extractedData.GetCamera()) == reference[i].m_uiSortingKey);
+        EZ_TEST_INT(sorted[i]->m_uiBatchId, reference[i].m_uiBatchId);
+      }
+      else
+      {
+        // the radix sort is stable
+        EZ_TEST_BOOL(sorted[i] == reference[i].m_pRenderData);
+      }
+    }
+  }
+} // namespace
+
+EZ_CREATE_SIMPLE_TEST_GROUP(ExtractedRenderData);
+
+EZ_CREATE_SIMPLE_TEST(ExtractedRenderData, SortAndBatch)
+{
+  const ezRenderData::Category category = ezRenderData::RegisterCategory("SortAndBatchTest", &SortByScrambledKey);
+  const ezRenderData::Category otherCategory = ezRenderData::RegisterCategory("SortAndBatchTestOther", &SortByScrambledKey);
+
+  // a few random batch ids that differ in all bytes
+  ezRandom rnd;
+  rnd.Initialize(42);
+
+  ezUInt32 batchIds[4];
+  for (ezUInt32& uiBatchId : batchIds)
+  {
+    uiBatchId = rnd.UInt();
+  }
+
+  // the same instance is used for all sizes, so the scratch arrays of the previous size are re-used
+  ezExtractedRenderData extractedData;
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Random Keys")
+  {
+    // sizes below and above the threshold for the radix sort
+    const ezUInt32 sizes[] = {0, 1, 2, 7, 100, 255, 256, 257, 1000, 5000};
+
+    for (ezUInt32 uiCount : sizes)
+    {
+      // few distinct keys, so there are a lot of equal keys and batches in between
+      for (ezUInt32 uiNumKeys : {16u, 0xFFFFFFFFu})
+      {
+        TestData testData(uiCount);
+        for (ezUInt32 i = 0; i < uiCount; ++i)
+        {
+          ezRenderData* pRenderData = testData.Get(i, rnd.Bool());
+          pRenderData->m_uiBatchId = batchIds[rnd.UIntInRange(EZ_ARRAY_SIZE(batchIds))];
+          pRenderData->m_uiSortingKey = uiNumKeys == 0xFFFFFFFFu ? rnd.UInt() : rnd.UIntInRange(uiNumKeys);
+
+          extractedData.AddRenderData(pRenderData, category);
+        }
+
+        extractedData.SortAndBatch();
+        CheckSortAndBatch(extractedData, category, testData);
+        extractedData.Clear();
+      }
+    }
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Equal Keys")
+  {
+    // everything is equal, the radix sort has to skip all passes and keep the order
+    for (ezUInt32 uiCount : {10u, 300u})
+    {
+      TestData testData(uiCount);
+      for (ezUInt32 i = 0; i < uiCount; ++i)
+      {
+        ezRenderData* pRenderData = testData.Get(i, false);
+        pRenderData->m_uiBatchId = batchIds[0];
+        pRenderData->m_uiSortingKey = 5;
+
+        extractedData.AddRenderData(pRenderData, category);
+      }
+
+      extractedData.SortAndBatch();
+      CheckSortAndBatch(extractedData, category, testData);
+      EZ_TEST_INT(extractedData.GetRenderDataBatchesWithCategory(category).GetBatchCount(), 1);
+      extractedData.Clear();
+    }
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Batch Boundaries")
+  {
+    // a single batch boundary at every position, the batches are searched four neighbors at a time
+    for (ezUInt32 uiCount : {13u, 261u})
+    {
+      for (ezUInt32 uiBoundary = 1; uiBoundary < uiCount; ++uiBoundary)
+      {
+        for (bool bTypeChange : {false, true})
+        {
+          TestData testData(uiCount);
+          for (ezUInt32 i = 0; i < uiCount; ++i)
+          {
+            // either the batch id or the type changes at the boundary, the type is not part of the sorting so the key keeps the order
+            const bool bSecondBatch = i >= uiBoundary;
+            ezRenderData* pRenderData = testData.Get(i, bTypeChange && bSecondBatch);
+            pRenderData->m_uiBatchId = (!bTypeChange && bSecondBatch) ? 2 : 1;
+            pRenderData->m_uiSortingKey = (bTypeChange && bSecondBatch) ? 8 : 7;
+
+            extractedData.AddRenderData(pRenderData, category);
+          }
+
+          extractedData.SortAndBatch();
+
+          ezRenderDataBatchList batchList = extractedData.GetRenderDataBatchesWithCategory(category);
+          if (EZ_TEST_INT(batchList.GetBatchCount(), 2).Succeeded())
+          {
+            EZ_TEST_INT(batchList.GetBatch(0).GetCount(), uiBoundary);
+            EZ_TEST_INT(batchList.GetBatch(1).GetCount(), uiCount - uiBoundary);
+          }
+
+          extractedData.Clear();
+        }
+      }
+    }
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Parallel Categories")
+  {
+    // enough data in total to sort the categories in parallel
+    const ezUInt32 uiCount = 3000;
+
+    TestData testData(uiCount);
+    TestData otherTestData(uiCount);
+    for (ezUInt32 i = 0; i < uiCount; ++i)
+    {
+      ezRenderData* pRenderData = testData.Get(i, rnd.Bool());
+      pRenderData->m_uiBatchId = batchIds[rnd.UIntInRange(EZ_ARRAY_SIZE(batchIds))];
+      pRenderData->m_uiSortingKey = rnd.UIntInRange(64);
+      extractedData.AddRenderData(pRenderData, category);
+
+      ezRenderData* pOtherRenderData = otherTestData.Get(i, rnd.Bool());
+      pOtherRenderData->m_uiBatchId = batchIds[rnd.UIntInRange(EZ_ARRAY_SIZE(batchIds))];
+      pOtherRenderData->m_uiSortingKey = rnd.UInt();
+      extractedData.AddRenderData(pOtherRenderData, otherCategory);
+    }
+
+    extractedData.SortAndBatch();
+    CheckSortAndBatch(extractedData, category, testData);
+    CheckSortAndBatch(extractedData, otherCategory, otherTestData);
+    extractedData.Clear();
+  }
+}
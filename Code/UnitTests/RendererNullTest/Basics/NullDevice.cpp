@@ -0,0 +1,147 @@
+#include <RendererNullTestPCH.h>
+
+#include <Core/World/World.h>
+#include <Foundation/Configuration/Startup.h>
+#include <Foundation/IO/FileSystem/FileSystem.h>
+#include <RendererCore/Debug/DebugRenderer.h>
+#include <RendererCore/Pipeline/RenderPipelineResource.h>
+#include <RendererCore/Pipeline/View.h>
+#include <RendererCore/RenderContext/RenderContext.h>
+#include <RendererCore/RenderWorld/RenderWorld.h>
+#include <RendererCore/ShaderCompiler/ShaderManager.h>
+#include <RendererNull/Context/ContextNull.h>
+#include <RendererNull/Device/DeviceNull.h>
+
+EZ_CREATE_SIMPLE_TEST_GROUP(NullDevice);
+
+EZ_CREATE_SIMPLE_TEST(NullDevice, RenderWorld)
+{
+  const ezSizeU32 resolution(320, 240);
+
+  ezFileSystem::AddDataDirectory(">appdir/", "ShaderCache", "shadercache", ezFileSystem::AllowWrites);
+  EZ_TEST_BOOL(ezFileSystem::AddDataDirectory(">sdk/Data/Base/", "Base").Succeeded());
+
+  // no window and swap chain, the world is rendered into an offscreen render target
+  ezGALDeviceCreationDescription deviceInit;
+  deviceInit.m_bCreatePrimarySwapChain = false;
+
+  ezGALDeviceNull* pDevice = EZ_DEFAULT_NEW(ezGALDeviceNull, deviceInit, resolution);
+  if (EZ_TEST_BOOL(pDevice->Init().Succeeded()).Failed())
+  {
+    EZ_DEFAULT_DELETE(pDevice);
+    return;
+  }
+
+  ezGALDevice::SetDefaultDevice(pDevice);
+
+  // the null shader compiler is part of RendererCore, no native shader compiler is needed
+  ezShaderManager::Configure("NULL_HLSL", true);
+
+  ezStartup::StartupHighLevelSystems();
+
+  ezGALTextureCreationDescription texDesc;
+  texDesc.m_uiWidth = resolution.width;
+  texDesc.m_uiHeight = resolution.height;
+  texDesc.m_Format = ezGALResourceFormat::RGBAUByteNormalizedsRGB;
+  texDesc.m_bCreateRenderTarget = true;
+  texDesc.m_bAllowShaderResourceView = true;
+  texDesc.m_ResourceAccess.m_bReadBack = true;
+
+  const ezGALTextureHandle hRenderTarget = pDevice->CreateTexture(texDesc);
+  EZ_TEST_BOOL(!hRenderTarget.IsInvalidated());
+
+  {
+    ezWorldDesc worldDesc("NullDeviceWorld");
+    ezWorld world(worldDesc);
+
+    ezCamera camera;
+    camera.SetCameraMode(ezCameraMode::PerspectiveFixedFovX, 90.0f, 0.1f, 100.0f);
+    camera.LookAt(ezVec3(-5, 0, 2), ezVec3::ZeroVector(), ezVec3(0, 0, 1));
+
+    ezView* pView = nullptr;
+    ezViewHandle hView = ezRenderWorld::CreateView("NullDeviceView", pView);
+    pView->SetCameraUsageHint(ezCameraUsageHint::MainView);
+    pView->SetRenderPipelineResource(ezRenderPipelineResource::CreateMissingPipeline());
+    pView->SetWorld(&world);
+    pView->SetCamera(&camera);
+
+    ezGALRenderTargetSetup renderTargetSetup;
+    renderTargetSetup.SetRenderTarget(0, pDevice->GetDefaultRenderTargetView(hRenderTarget));
+    pView->SetRenderTargetSetup(renderTargetSetup);
+    pView->SetViewport(ezRectFloat(0.0f, 0.0f, (float)resolution.width, (float)resolution.height));
+
+    ezRenderWorld::AddMainView(hView);
+
+    EZ_TEST_BLOCK(ezTestBlock::Enabled, "Render Frames")
+    {
+      ezUInt32 uiNumClears = 0;
+      ezUInt32 uiNumDrawCalls = 0;
+
+      for (ezUInt32 uiFrame = 0; uiFrame < 5; ++uiFrame)
+      {
+        ezRenderWorld::BeginFrame();
+        pDevice->BeginFrame();
+
+        {
+          EZ_LOCK(world.GetWriteMarker());
+
+          ezDebugRenderer::DrawSolidBox(&world, ezBoundingBox(ezVec3(-1.0f), ezVec3(1.0f)), ezColor::CornflowerBlue);
+
+          world.Update();
+        }
+
+        ezRenderWorld::ExtractMainViews();
+        ezRenderWorld::Render(ezRenderContext::GetDefaultInstance());
+
+        // the statistics are reset by the next BeginFrame
+        const ezGALNullStatistics& stats = pDevice->GetNullContext()->GetStatistics();
+        uiNumClears += stats.m_uiNumCommands[ezGALNullCommandType::Clear];
+        uiNumDrawCalls += stats.GetNumDrawCalls();
+
+        pDevice->EndFrame();
+        ezRenderWorld::EndFrame();
+      }
+
+      EZ_TEST_BOOL(uiNumClears > 0);
+      EZ_TEST_BOOL(uiNumDrawCalls > 0);
+    }
+
+    EZ_TEST_BLOCK(ezTestBlock::Enabled, "Readback")
+    {
+      ezDynamicArray<ezUInt8> data;
+      data.SetCount(resolution.width * resolution.height * 4, 0xCD);
+
+      ezGALSystemMemoryDescription memDesc;
+      memDesc.m_pData = data.GetData();
+      memDesc.m_uiRowPitch = 4 * resolution.width;
+      memDesc.m_uiSlicePitch = 4 * resolution.width * resolution.height;
+
+      ezArrayPtr<ezGALSystemMemoryDescription> sysMemDescs(&memDesc, 1);
+
+      ezGALContext* pContext = pDevice->GetPrimaryContext();
+      pContext->ReadbackTexture(hRenderTarget);
+      pContext->CopyTextureReadbackResult(hRenderTarget, &sysMemDescs);
+
+      // the null device has no texel data, the result must not contain any uninitialized memory
+      ezUInt32 uiNumNonZero = 0;
+      for (ezUInt8 uiValue : data)
+      {
+        if (uiValue != 0)
+          ++uiNumNonZero;
+      }
+
+      EZ_TEST_INT(uiNumNonZero, 0);
+    }
+
+    ezRenderWorld::RemoveMainView(hView);
+    ezRenderWorld::DeleteView(hView);
+  }
+
+  pDevice->DestroyTexture(hRenderTarget);
+
+  ezStartup::ShutdownHighLevelSystems();
+  ezResourceManager::FreeAllUnusedResources();
+
+  pDevice->Shutdown();
+  EZ_DEFAULT_DELETE(pDevice);
+}
@@ -0,0 +1,175 @@
+#include <RendererNullTestPCH.h>
+
+#include <Foundation/Configuration/Startup.h>
+#include <Foundation/IO/FileSystem/FileSystem.h>
+#include <RendererCore/RenderContext/RenderContext.h>
+#include <RendererCore/Shader/ShaderResource.h>
+#include <RendererCore/ShaderCompiler/ShaderManager.h>
+#include <RendererNull/Device/DeviceNull.h>
+
+EZ_CREATE_SIMPLE_TEST_GROUP(RenderContext);
+
+EZ_CREATE_SIMPLE_TEST(RenderContext, Bindings)
+{
+  ezFileSystem::AddDataDirectory(">appdir/", "ShaderCache", "shadercache", ezFileSystem::AllowWrites);
+  EZ_TEST_BOOL(ezFileSystem::AddDataDirectory(">sdk/Data/Base/", "Base").Succeeded());
+
+  const ezStringBuilder sTestDataDir(">sdk/", ezTestFramework::GetInstance()->GetRelTestDataPath());
+  EZ_TEST_BOOL(ezFileSystem::AddDataDirectory(sTestDataDir, "UnitTestData").Succeeded());
+
+  ezGALDeviceCreationDescription deviceInit;
+  deviceInit.m_bCreatePrimarySwapChain = false;
+
+  ezGALDeviceNull* pDevice = EZ_DEFAULT_NEW(ezGALDeviceNull, deviceInit, ezSizeU32(64, 64));
+  if (EZ_TEST_BOOL(pDevice->Init().Succeeded()).Failed())
+  {
+    EZ_DEFAULT_DELETE(pDevice);
+    return;
+  }
+
+  ezGALDevice::SetDefaultDevice(pDevice);
+  ezShaderManager::Configure("NULL_HLSL", true);
+
+  ezStartup::StartupHighLevelSystems();
+
+  pDevice->BeginFrame();
+
+  // the first texture can also be used as a render target, which implicitly unbinds its resource view
+  ezGALTextureCreationDescription texDesc;
+  texDesc.m_uiWidth = 4;
+  texDesc.m_uiHeight = 4;
+  texDesc.m_Format = ezGALResourceFormat::RGBAUByteNormalized;
+  texDesc.m_bAllowShaderResourceView = true;
+  texDesc.m_bCreateRenderTarget = true;
+
+  const ezGALTextureHandle hTextures[2] = {pDevice->CreateTexture(texDesc), pDevice->CreateTexture(texDesc)};
+  const ezGALResourceViewHandle hViews[2] = {pDevice->GetDefaultResourceView(hTextures[0]), pDevice->GetDefaultResourceView(hTextures[1])};
+
+  const ezConstantBufferStorageHandle hPerObject = ezRenderContext::CreateConstantBufferStorage(sizeof(ezMat4));
+
+  ezShaderResourceHandle hShader = ezResourceManager::LoadResource<ezShaderResource>("Shaders/Bindings.ezShader");
+  {
+    // only permutations of fully loaded shaders are cached
+    ezResourceLock<ezShaderResource> pShader(hShader, ezResourceAcquireMode::BlockTillLoaded);
+    EZ_TEST_BOOL(pShader->IsShaderValid());
+  }
+
+  ezRenderContext* pContext = ezRenderContext::CreateInstance();
+  pContext->SetGALContext(pDevice->GetPrimaryContext());
+
+  auto BindAll = [&]() {
+    pContext->BindShader(hShader);
+    pContext->BindMeshBuffer(ezGALBufferHandle(), ezGALBufferHandle(), nullptr, ezGALPrimitiveTopology::Triangles, 1);
+    pContext->BindConstantBuffer("PerObject", hPerObject);
+    pContext->BindTexture2D("BaseTexture", hViews[0]);
+    pContext->BindTexture2D("DetailTexture", hViews[1]);
+  };
+
+  // the shader uses 3 bindings without TWO_SIDED (PerObject, BaseTexture and its sampler) and 4 with it (DetailTexture)
+  auto ApplyContextStates = [&](ezUInt32 uiExpectedApplied, ezUInt32 uiExpectedSkipped, ezUInt32 uiExpectedCachedLookups) {
+    EZ_TEST_BOOL(pContext->ApplyContextStates().Succeeded());
+
+    const ezRenderContext::Statistics stats = pContext->GetAndResetStatistics();
+    EZ_TEST_INT(stats.m_uiAppliedBindings, uiExpectedApplied);
+    EZ_TEST_INT(stats.m_uiSkippedBindings, uiExpectedSkipped);
+    EZ_TEST_INT(stats.m_uiCachedPermutationLookups, uiExpectedCachedLookups);
+    EZ_TEST_INT(stats.m_uiFailedDrawcalls, 0);
+  };
+
+  // this also sets the MSAA permutation variable, which has to stay the same for the permutation cache checks below
+  const ezRectFloat viewport(0.0f, 0.0f, 4.0f, 4.0f);
+  pContext->SetViewportAndRenderTargetSetup(viewport, ezGALRenderTargetSetup());
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Redundant Bindings")
+  {
+    pContext->SetShaderPermutationVariable("TWO_SIDED", "FALSE");
+    BindAll();
+    pContext->GetAndResetStatistics();
+
+    ApplyContextStates(3, 0, 0);
+
+    // nothing changed, nothing is applied
+    ApplyContextStates(0, 0, 0);
+
+    pContext->BindTexture2D("BaseTexture", hViews[0]);
+    pContext->BindConstantBuffer("PerObject", hPerObject);
+    EZ_TEST_INT(pContext->GetAndResetStatistics().m_uiRedundantBindings, 2);
+
+    ApplyContextStates(0, 0, 0);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Changed Bindings")
+  {
+    // a new permutation, all bindings are applied
+    pContext->SetShaderPermutationVariable("TWO_SIDED", "TRUE");
+    ApplyContextStates(4, 0, 0);
+
+    // only the changed texture slot is applied, the other texture is skipped and the sampler and constant buffer are not looked at
+    pContext->BindTexture2D("DetailTexture", hViews[0]);
+    ApplyContextStates(1, 1, 0);
+
+    // binding a texture that is not used by the shader doesn't apply anything
+    pContext->BindTexture2D("UnusedTexture", hViews[1]);
+    ApplyContextStates(0, 2, 0);
+
+    // making the bound texture a render target implicitly unbinds its view, so everything has to be re-applied
+    ezGALRenderTargetSetup renderTargetSetup;
+    renderTargetSetup.SetRenderTarget(0, pDevice->GetDefaultRenderTargetView(hTextures[0]));
+    pContext->SetViewportAndRenderTargetSetup(viewport, renderTargetSetup);
+    ApplyContextStates(4, 0, 0);
+
+    pContext->SetViewportAndRenderTargetSetup(viewport, ezGALRenderTargetSetup());
+    pContext->BindTexture2D("DetailTexture", hViews[1]);
+    ApplyContextStates(1, 1, 0);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Permutation Cache")
+  {
+    // both permutations are known now
+    pContext->SetShaderPermutationVariable("TWO_SIDED", "FALSE");
+    ApplyContextStates(3, 0, 1);
+
+    pContext->SetShaderPermutationVariable("TWO_SIDED", "TRUE");
+    ApplyContextStates(4, 0, 1);
+
+    // a variable that the shader doesn't use is a cache miss, but it resolves to the same permutation, so no binding changes
+    pContext->SetShaderPermutationVariable("FLIP_WINDING", "TRUE");
+    ApplyContextStates(0, 4, 0);
+
+    pContext->SetShaderPermutationVariable("FLIP_WINDING", "FALSE");
+    ApplyContextStates(0, 4, 0);
+
+    pContext->SetShaderPermutationVariable("FLIP_WINDING", "TRUE");
+    ApplyContextStates(0, 4, 1);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Reset Context State")
+  {
+    // the permutation cache is cleared together with all bindings
+    pContext->ResetContextState();
+    BindAll();
+    ApplyContextStates(4, 0, 0);
+
+    pContext->SetShaderPermutationVariable("TWO_SIDED", "FALSE");
+    ApplyContextStates(3, 0, 0);
+
+    pContext->SetShaderPermutationVariable("TWO_SIDED", "TRUE");
+    ApplyContextStates(4, 0, 1);
+  }
+
+  ezRenderContext::DestroyInstance(pContext);
+  ezRenderContext::DeleteConstantBufferStorage(hPerObject);
+
+  pDevice->DestroyTexture(hTextures[0]);
+  pDevice->DestroyTexture(hTextures[1]);
+
+  pDevice->EndFrame();
+
+  hShader.Invalidate();
+
+  ezStartup::ShutdownHighLevelSystems();
+  ezResourceManager::FreeAllUnusedResources();
+
+  pDevice->Shutdown();
+  EZ_DEFAULT_DELETE(pDevice);
+}
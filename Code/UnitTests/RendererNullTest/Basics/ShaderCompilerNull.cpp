@@ -0,0 +1,166 @@
+#include <RendererNullTestPCH.h>
+
+#include <RendererCore/ShaderCompiler/ShaderCompilerNull.h>
+
+namespace
+{
+  static const char* s_szPixelShader = R"(
+struct Transform
+{
+  float4 r0;
+  float4 r1;
+  float4 r2;
+};
+
+struct PS_IN
+{
+  nointerpolation float4 Position : SV_Position;
+};
+
+cbuffer PerObject : register(b2)
+#line 20 "Shaders/Test.h"
+{
+  float A;
+  float3 B;
+  float2 C;
+  float3 D;
+  float4x4 M;
+  float3x3 R;
+  float E;
+  Transform T;
+  float F[2];
+  bool G;
+};
+
+cbuffer Other
+{
+  uint X;
+};
+
+Texture2D<float4> Diffuse : register(t3);
+Texture2D Normal;
+TextureCube Environment;
+StructuredBuffer<Transform> Transforms;
+SamplerState Diffuse_AutoSampler;
+RWTexture2D<float4> Output : register(u1);
+
+float4 Sample(Texture2D tex, SamplerState smp, float2 uv)
+{
+  return tex.Sample(smp, uv);
+}
+
+float4 main(PS_IN input) : SV_Target
+{
+  Texture2D notAGlobal;
+  return Sample(Normal, Diffuse_AutoSampler, input.Position.xy) * A;
+}
+)";
+} // namespace
+
+EZ_CREATE_SIMPLE_TEST_GROUP(ShaderCompilerNull);
+
+EZ_CREATE_SIMPLE_TEST(ShaderCompilerNull, Reflection)
+{
+  ezShaderProgramCompiler::ezShaderProgramData data;
+  data.m_szPlatform = "NULL_HLSL";
+  data.m_szSourceFile = "Test.ezShader";
+  data.m_szShaderSource[ezGALShaderStage::PixelShader] = s_szPixelShader;
+
+  ezShaderCompilerNull compiler;
+  if (EZ_TEST_BOOL(compiler.Compile(data, ezLog::GetThreadLocalLogSystem()).Succeeded()).Failed())
+    return;
+
+  const ezShaderStageBinary& binary = data.m_StageBinary[ezGALShaderStage::PixelShader];
+  EZ_TEST_INT(binary.GetShaderResourceBindings().GetCount(), 8);
+  EZ_TEST_BOOL(data.m_StageBinary[ezGALShaderStage::VertexShader].GetShaderResourceBindings().IsEmpty());
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Constant Buffer Layout")
+  {
+    const ezShaderResourceBinding* pBinding = binary.GetShaderResourceBinding(ezTempHashedString("PerObject"));
+    if (EZ_TEST_BOOL(pBinding != nullptr && pBinding->m_pLayout != nullptr).Failed())
+      return;
+
+    EZ_TEST_INT(pBinding->m_Type, ezShaderResourceBinding::ConstantBuffer);
+    EZ_TEST_INT(pBinding->m_iSlot, 2);
+
+    // offsets as computed by the D3D compiler, the struct member is not reflected
+    struct ExpectedConstant
+    {
+      const char* m_szName;
+      ezShaderConstantBufferLayout::Constant::Type::Enum m_Type;
+      ezUInt32 m_uiOffset;
+      ezUInt32 m_uiArrayElements;
+    };
+
+    const ExpectedConstant expected[] = {
+      {"A", ezShaderConstantBufferLayout::Constant::Type::Float1, 0, 1},
+      {"B", ezShaderConstantBufferLayout::Constant::Type::Float3, 4, 1},
+      {"C", ezShaderConstantBufferLayout::Constant::Type::Float2, 16, 1},
+      {"D", ezShaderConstantBufferLayout::Constant::Type::Float3, 32, 1},
+      {"M", ezShaderConstantBufferLayout::Constant::Type::Mat4x4, 48, 1},
+      {"R", ezShaderConstantBufferLayout::Constant::Type::Mat3x3, 112, 1},
+      {"E", ezShaderConstantBufferLayout::Constant::Type::Float1, 156, 1},
+      {"F", ezShaderConstantBufferLayout::Constant::Type::Float1, 208, 2},
+      {"G", ezShaderConstantBufferLayout::Constant::Type::Bool, 228, 1},
+    };
+
+    const ezShaderConstantBufferLayout* pLayout = pBinding->m_pLayout;
+    EZ_TEST_INT(pLayout->m_uiTotalSize, 240);
+
+    if (EZ_TEST_INT(pLayout->m_Constants.GetCount(), EZ_ARRAY_SIZE(expected)).Failed())
+      return;
+
+    for (ezUInt32 i = 0; i < EZ_ARRAY_SIZE(expected); ++i)
+    {
+      const ezShaderConstantBufferLayout::Constant& constant = pLayout->m_Constants[i];
+      EZ_TEST_STRING(constant.m_sName.GetData(), expected[i].m_szName);
+      EZ_TEST_INT(constant.m_Type, expected[i].m_Type);
+      EZ_TEST_INT(constant.m_uiOffset, expected[i].m_uiOffset);
+      EZ_TEST_INT(constant.m_uiArrayElements, expected[i].m_uiArrayElements);
+    }
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Resource Slots")
+  {
+    struct ExpectedBinding
+    {
+      const char* m_szName;
+      ezShaderResourceBinding::ResourceType m_Type;
+      ezInt32 m_iSlot;
+    };
+
+    // implicit slots are the lowest ones that are not taken explicitly
+    const ExpectedBinding expected[] = {
+      {"Other", ezShaderResourceBinding::ConstantBuffer, 0},
+      {"Diffuse", ezShaderResourceBinding::Texture2D, 3},
+      {"Normal", ezShaderResourceBinding::Texture2D, 0},
+      {"Environment", ezShaderResourceBinding::TextureCube, 1},
+      {"Transforms", ezShaderResourceBinding::GenericBuffer, 2},
+      {"Output", ezShaderResourceBinding::RWTexture2D, 1},
+    };
+
+    for (const ExpectedBinding& e : expected)
+    {
+      const ezShaderResourceBinding* pBinding = binary.GetShaderResourceBinding(ezTempHashedString(e.m_szName));
+      if (EZ_TEST_BOOL_MSG(pBinding != nullptr, "Binding '%s' is missing", e.m_szName).Failed())
+        continue;
+
+      EZ_TEST_INT(pBinding->m_Type, e.m_Type);
+      EZ_TEST_INT(pBinding->m_iSlot, e.m_iSlot);
+    }
+
+    // the sampler shares the name with the texture, the auto sampler suffix is removed
+    ezUInt32 uiNumSamplers = 0;
+    for (const ezShaderResourceBinding& binding : binary.GetShaderResourceBindings())
+    {
+      if (binding.m_Type == ezShaderResourceBinding::Sampler)
+      {
+        EZ_TEST_BOOL(binding.m_sName == ezTempHashedString("Diffuse"));
+        EZ_TEST_INT(binding.m_iSlot, 0);
+        ++uiNumSamplers;
+      }
+    }
+
+    EZ_TEST_INT(uiNumSamplers, 1);
+  }
+}
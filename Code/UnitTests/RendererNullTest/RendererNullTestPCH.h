@@ -0,0 +1,11 @@
+#pragma once
+
+#include <TestFramework/Framework/TestFramework.h>
+
+#include <Foundation/Basics.h>
+#include <Foundation/Containers/DynamicArray.h>
+#include <Foundation/Strings/String.h>
+#include <Foundation/Strings/StringBuilder.h>
+
+#include <RendererFoundation/Context/Context.h>
+#include <RendererFoundation/Device/Device.h>
@@ -0,0 +1,134 @@
+#include <RendererTestPCH.h>
+
+#include <Foundation/IO/MemoryStream.h>
+#include <RendererCore/AnimationSystem/AnimationClipResource.h>
+
+namespace
+{
+  enum TestJoint
+  {
+    LongTranslation,
+    Constant,
+    RotationWrap,
+    Animated,
+    NumJoints
+  };
+
+  ezTransform GetReferenceTransform(ezUInt32 uiJoint, ezUInt32 uiFrame)
+  {
+    const float f = (float)uiFrame;
+
+    ezTransform t;
+    t.SetIdentity();
+
+    switch (uiJoint)
+    {
+      case LongTranslation:
+        // covers 2 km, far more than 16 bit quantization can represent within the tolerance
+        t.m_vPosition.Set(f * 10.0f, ezMath::Sin(ezAngle::Degree(f * 7.0f)) * 50.0f, -f * 0.5f);
+        break;
+
+      case Constant:
+        // jitters within the tolerance, so all tracks should be stored as a single value
+        t.m_vPosition.Set(1.0f, 2.0f, 3.0f + ((uiFrame % 2) ? 0.0002f : -0.0002f));
+        t.m_qRotation.SetFromAxisAndAngle(ezVec3(0, 0, 1), ezAngle::Degree(45.0f + ((uiFrame % 3) * 0.02f)));
+        t.m_vScale.Set(2.0f + ((uiFrame % 5) * 0.0001f));
+        break;
+
+      case RotationWrap:
+        // several full turns, the quaternion flips its sign every 360 degrees, and every other frame is stored negated
+        t.m_qRotation.SetFromAxisAndAngle(ezVec3(0, 0, 1), ezAngle::Degree(f * 11.0f));
+        if (uiFrame % 2)
+        {
+          t.m_qRotation.v = -t.m_qRotation.v;
+          t.m_qRotation.w = -t.m_qRotation.w;
+        }
+        break;
+
+      case Animated:
+        t.m_vPosition.Set(ezMath::Sin(ezAngle::Degree(f * 3.0f)), ezMath::Cos(ezAngle::Degree(f * 5.0f)), 0.1f);
+        t.m_qRotation.SetFromAxisAndAngle(ezVec3(1, 1, 0).GetNormalized(), ezAngle::Degree(ezMath::Sin(ezAngle::Degree(f * 4.0f)) * 90.0f));
+        t.m_vScale.Set(1.0f + f * 0.01f);
+        break;
+    }
+
+    return t;
+  }
+
+  void CheckClip(const ezAnimationClipResourceDescriptor& clip, const ezAnimationClipCompressionSettings& settings)
+  {
+    float fMaxPositionError = 0.0f;
+    float fMaxScaleError = 0.0f;
+    ezAngle maxRotationError;
+
+    for (ezUInt16 uiJoint = 0; uiJoint < NumJoints; ++uiJoint)
+    {
+      for (ezUInt16 uiFrame = 0; uiFrame < clip.GetNumFrames(); ++uiFrame)
+      {
+        const ezTransform ref = GetReferenceTransform(uiJoint, uiFrame);
+        const ezTransform res = clip.GetJointTransform(uiJoint, uiFrame);
+
+        const float fDot = ezMath::Abs(res.m_qRotation.v.Dot(ref.m_qRotation.v) + res.m_qRotation.w * ref.m_qRotation.w);
+
+        fMaxPositionError = ezMath::Max(fMaxPositionError, (res.m_vPosition - ref.m_vPosition).GetLength());
+        fMaxScaleError = ezMath::Max(fMaxScaleError, (res.m_vScale - ref.m_vScale).GetLength());
+        maxRotationError = ezMath::Max(maxRotationError, 2.0f * ezMath::ACos(ezMath::Min(fDot, 1.0f)));
+      }
+    }
+
+    EZ_TEST_BOOL(fMaxPositionError <= settings.m_fPositionTolerance);
+    EZ_TEST_BOOL(fMaxScaleError <= settings.m_fScaleTolerance);
+    EZ_TEST_BOOL(maxRotationError <= settings.m_RotationTolerance);
+  }
+} // namespace
+
+EZ_CREATE_SIMPLE_TEST_GROUP(Animation);
+
+EZ_CREATE_SIMPLE_TEST(Animation, ClipCompression)
+{
+  const ezUInt16 uiNumFrames = 200;
+
+  ezAnimationClipCompressionSettings settings;
+
+  ezAnimationClipResourceDescriptor clip;
+  clip.Configure(NumJoints, uiNumFrames, 30, false);
+
+  for (ezUInt16 uiJoint = 0; uiJoint < NumJoints; ++uiJoint)
+  {
+    ezArrayPtr<ezTransform> keyframes = clip.GetJointKeyframes(uiJoint);
+
+    for (ezUInt16 uiFrame = 0; uiFrame < uiNumFrames; ++uiFrame)
+    {
+      keyframes[uiFrame] = GetReferenceTransform(uiJoint, uiFrame);
+    }
+  }
+
+  const ezUInt64 uiUncompressedSize = clip.GetHeapMemoryUsage();
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Compress")
+  {
+    clip.Compress(settings);
+
+    EZ_TEST_BOOL(clip.IsCompressed());
+    EZ_TEST_BOOL(clip.GetHeapMemoryUsage() < uiUncompressedSize);
+
+    CheckClip(clip, settings);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Save / Load")
+  {
+    ezMemoryStreamStorage storage;
+    ezMemoryStreamWriter writer(&storage);
+    ezMemoryStreamReader reader(&storage);
+
+    clip.Save(writer);
+
+    ezAnimationClipResourceDescriptor loaded;
+    loaded.Load(reader);
+
+    EZ_TEST_BOOL(loaded.IsCompressed());
+    EZ_TEST_INT(loaded.GetNumFrames(), uiNumFrames);
+
+    CheckClip(loaded, settings);
+  }
+}
@@ -5,7 +5,8 @@
 #define PLATFORM_DX11 EZ_OFF
 #define PLATFORM_OPENGL EZ_OFF
 
-#if defined(DX11_SM40_93) || defined(DX11_SM40) || defined(DX11_SM41) || defined(DX11_SM50)
+// the null renderer uses the HLSL code path, its shader compiler only reflects the source
+#if defined(DX11_SM40_93) || defined(DX11_SM40) || defined(DX11_SM41) || defined(DX11_SM50) || defined(NULL_HLSL)
 
   #undef PLATFORM_DX11
   #define PLATFORM_DX11 EZ_ON